@@ -5,6 +5,7 @@
 #include <map>
 #include "../core/Types.h"
 #include "../market/MarketData.h"
+#include "TreeEnsemble.h"
 
 namespace hft {
 namespace ai {
@@ -65,7 +66,7 @@ private:
     // LSTM specific members
 };
 
-// XGBoost模型
+// XGBoost模型：加载离线训练导出的JSON（XGBoost或LightGBM），由TreeEnsemble本地打分
 class XGBoostModel : public MLModel {
 public:
     struct XGBoostConfig {
@@ -74,18 +75,33 @@ public:
         int numRounds;
         double gamma;
         double minChildWeight;
+        // dump_model(dump_format="json")导出的文件不含以下训练参数，需与训练时一致；
+        // save_model导出的JSON和LightGBM模型以文件内的值为准
+        int numClass = 1;
+        double baseScore = 0.5;
+        std::string objective = "reg:squarederror";
     };
     
     void initialize(const XGBoostConfig& config);
+    // 训练在离线环境完成，这里只报错
     void train(const std::vector<std::vector<double>>& features,
                const std::vector<double>& labels) override;
+    // 每行一个值：单输出为模型输出，多分类为概率最大的类别
     std::vector<double> predict(const std::vector<std::vector<double>>& features) override;
+    // 保存加载时的JSON原文
     void save(const std::string& path) override;
     void load(const std::string& path) override;
+
+    // 零分配批量打分，见TreeEnsemble::predict
+    void predictBatch(const float* features, size_t rows, float* outputs) { ensemble_.predict(features, rows, outputs); }
+    const TreeEnsemble& ensemble() const { return ensemble_; }
     
 private:
     XGBoostConfig config_;
-    // XGBoost specific members
+    TreeEnsemble ensemble_;
+    std::string source_;
+    std::vector<float> inputBuffer_;
+    std::vector<float> outputBuffer_;
 };
 
 // 集成学习模型
@@ -3,7 +3,7 @@
 #include <string>
 #include <vector>
 #include <memory>
-#include <tensorflow/c/c_api.h>
+#include <cstdint>
 
 namespace hft {
 namespace ai {
@@ -22,7 +22,7 @@ struct ModelOutput {
 // 模型接口
 class Model {
 public:
-    Model();
+    Model() = default;
     virtual ~Model() = default;
 
     // 加载模型
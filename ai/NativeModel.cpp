@@ -0,0 +1,82 @@
+#include "NativeModel.h"
+#include <algorithm>
+#include <iostream>
+
+namespace hft {
+namespace ai {
+
+bool NativeModel::load(const std::string& model_path) {
+    m_runtime.unload();
+    m_ensemble.clear();
+    m_image.clear();
+    m_gbdt = false;
+
+    utils::MappedFile file;
+    pattern::ModelKind kind;
+    if (!file.open(model_path) || !pattern::readModelKind(file.data(), file.size(), kind)) {
+        std::cerr << "Invalid model file: " << model_path << std::endl;
+        return false;
+    }
+    if (kind == pattern::ModelKind::GBDT) {
+        pattern::GbdtModelSpec model;
+        if (!pattern::unpackGbdtModel(file.data(), file.size(), model) || !m_ensemble.compile(model)) {
+            std::cerr << "Invalid GBDT model file: " << model_path << std::endl;
+            return false;
+        }
+        m_image.assign(file.data(), file.data() + file.size());
+        m_gbdt = true;
+    } else if (!m_runtime.load(model_path)) {
+        return false;
+    }
+    m_input.resize(inputCount());
+    m_output.resize(outputCount());
+    return true;
+}
+
+bool NativeModel::save(const std::string& model_path) {
+    if (!isLoaded()) {
+        std::cerr << "No model loaded" << std::endl;
+        return false;
+    }
+    if (m_gbdt) {
+        return pattern::writeModelFile(model_path, m_image);
+    }
+    std::vector<uint8_t> image(m_runtime.image(), m_runtime.image() + m_runtime.imageSize());
+    return pattern::writeModelFile(model_path, image);
+}
+
+ModelOutput NativeModel::predict(const std::vector<double>& features) {
+    ModelOutput output;
+    output.confidence = 0.0;
+    if (!isLoaded() || features.size() != m_input.size()) {
+        std::cerr << "Invalid input for native model" << std::endl;
+        return output;
+    }
+
+    std::copy(features.begin(), features.end(), m_input.begin());
+    predictBatch(m_input.data(), 1, m_output.data());
+    output.predictions.assign(m_output.begin(), m_output.end());
+    output.confidence = *std::max_element(m_output.begin(), m_output.end());
+    return output;
+}
+
+bool NativeModel::train(const std::vector<std::vector<double>>& /*features*/,
+                        const std::vector<double>& /*labels*/) {
+    std::cerr << "NativeModel does not support online training; export a .hftm model instead" << std::endl;
+    return false;
+}
+
+bool NativeModel::isLoaded() const {
+    return m_gbdt ? m_ensemble.isLoaded() : m_runtime.isLoaded();
+}
+
+void NativeModel::predictBatch(const float* features, size_t batch, float* outputs) {
+    if (m_gbdt) {
+        m_ensemble.predict(features, batch, outputs);
+    } else {
+        m_runtime.predict(features, batch, outputs);
+    }
+}
+
+} // namespace ai
+} // namespace hft
@@ -0,0 +1,41 @@
+#pragma once
+#include "Model.h"
+#include "TreeEnsemble.h"
+#include "../pattern/InferenceRuntime.h"
+#include <string>
+#include <vector>
+
+namespace hft {
+namespace ai {
+
+// 基于本地推理运行时的模型（.hftm），不依赖TensorFlow：MLP由InferenceModel执行，GBDT编译到TreeEnsemble
+class NativeModel : public Model {
+public:
+    NativeModel() = default;
+    ~NativeModel() override = default;
+
+    bool load(const std::string& model_path) override;
+    bool save(const std::string& model_path) override;
+    ModelOutput predict(const std::vector<double>& features) override;
+    // 训练在离线环境完成，这里总是返回false
+    bool train(const std::vector<std::vector<double>>& features,
+               const std::vector<double>& labels) override;
+    bool isLoaded() const override;
+
+    // 零分配批量推理：features为batch×输入数，outputs为batch×输出数
+    void predictBatch(const float* features, size_t batch, float* outputs);
+
+    size_t inputCount() const { return m_gbdt ? m_ensemble.featureCount() : m_runtime.inputCount(); }
+    size_t outputCount() const { return m_gbdt ? m_ensemble.outputCount() : m_runtime.outputCount(); }
+
+private:
+    pattern::InferenceModel m_runtime;
+    TreeEnsemble m_ensemble;
+    bool m_gbdt = false;
+    std::vector<uint8_t> m_image;           // GBDT模型的原始映像，用于save()
+    std::vector<float> m_input;
+    std::vector<float> m_output;
+};
+
+} // namespace ai
+} // namespace hft
@@ -0,0 +1,768 @@
+#include "TreeEnsemble.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <nlohmann/json.hpp>
+#if HFT_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace hft {
+namespace ai {
+
+using json = nlohmann::json;
+using pattern::OutputTransform;
+
+namespace {
+
+using FlatNode = TreeEnsemble::FlatNode;
+using FlatTree = TreeEnsemble::FlatTree;
+
+static_assert(sizeof(FlatNode) == 8, "FlatNode must be 8 bytes");
+
+constexpr size_t kMaxFeatures = TreeEnsemble::kFeatureMask;
+constexpr size_t kMaxThresholds = TreeEnsemble::kMissingBin - 1;
+constexpr size_t kMaxNodes = size_t{1} << 28;
+
+// ---------------- JSON解析 ----------------
+
+// JSON中的数字可能写成字符串（XGBoost的learner_model_param），也可能是"[5E-1]"
+double jsonNumber(const json& value) {
+    if (value.is_number()) {
+        return value.get<double>();
+    }
+    if (value.is_string()) {
+        std::string text = value.get<std::string>();
+        text.erase(std::remove(text.begin(), text.end(), '['), text.end());
+        text.erase(std::remove(text.begin(), text.end(), ']'), text.end());
+        return std::stod(text);
+    }
+    if (value.is_boolean()) {
+        return value.get<bool>() ? 1.0 : 0.0;
+    }
+    throw std::runtime_error("expected a number");
+}
+
+// XGBoost dump中的特征名为"f12"，没有特征名时也可能直接是下标
+int32_t xgboostFeature(const json& split) {
+    if (split.is_number_integer()) {
+        return split.get<int32_t>();
+    }
+    const std::string name = split.get<std::string>();
+    size_t start = (!name.empty() && name[0] == 'f') ? 1 : 0;
+    if (start >= name.size() || name.find_first_not_of("0123456789", start) != std::string::npos) {
+        throw std::runtime_error("unsupported feature name: " + name);
+    }
+    return std::stoi(name.substr(start));
+}
+
+int32_t parseXgboostDumpNode(const json& node, TreeEnsembleTree& tree) {
+    const int32_t index = static_cast<int32_t>(tree.nodes.size());
+    tree.nodes.emplace_back();
+    if (node.contains("leaf")) {
+        tree.nodes[index].leafValue = jsonNumber(node.at("leaf"));
+        return index;
+    }
+
+    const int64_t yes = node.at("yes").get<int64_t>();
+    const int64_t no = node.at("no").get<int64_t>();
+    const int64_t missing = node.contains("missing") ? node.at("missing").get<int64_t>() : yes;
+    const json* left = nullptr;
+    const json* right = nullptr;
+    for (const json& child : node.at("children")) {
+        const int64_t id = child.at("nodeid").get<int64_t>();
+        if (id == yes) {
+            left = &child;
+        } else if (id == no) {
+            right = &child;
+        }
+    }
+    if (!left || !right) {
+        throw std::runtime_error("missing child node");
+    }
+
+    TreeEnsembleNode split;
+    split.feature = xgboostFeature(node.at("split"));
+    split.threshold = jsonNumber(node.at("split_condition"));
+    split.defaultLeft = missing == yes;
+    // 递归会让tree.nodes重新分配，子节点下标先记下再写回
+    split.left = parseXgboostDumpNode(*left, tree);
+    split.right = parseXgboostDumpNode(*right, tree);
+    tree.nodes[index] = split;
+    return index;
+}
+
+void parseXgboostDump(const json& root, TreeEnsembleSpec& spec) {
+    spec.compare = SplitCompare::LESS;
+    spec.trees.clear();
+    for (size_t i = 0; i < root.size(); ++i) {
+        TreeEnsembleTree tree;
+        tree.output = static_cast<uint32_t>(i % std::max<uint32_t>(spec.outputCount, 1));
+        tree.root = parseXgboostDumpNode(root[i], tree);
+        spec.trees.push_back(std::move(tree));
+    }
+}
+
+void parseXgboostModel(const json& root, TreeEnsembleSpec& spec) {
+    const json& learner = root.at("learner");
+    const json& booster = learner.at("gradient_booster");
+    if (booster.at("name").get<std::string>() != "gbtree") {
+        throw std::runtime_error("unsupported booster: " + booster.at("name").get<std::string>());
+    }
+    const json& params = learner.at("learner_model_param");
+    const json& model = booster.at("model");
+
+    spec.compare = SplitCompare::LESS;
+    spec.featureCount = static_cast<uint32_t>(jsonNumber(params.at("num_feature")));
+    spec.outputCount = std::max<uint32_t>(static_cast<uint32_t>(jsonNumber(params.at("num_class"))), 1);
+    applyXgboostObjective(spec, learner.at("objective").at("name").get<std::string>(),
+                          jsonNumber(params.at("base_score")));
+
+    const json& trees = model.at("trees");
+    const json& treeInfo = model.at("tree_info");
+    spec.trees.clear();
+    for (size_t t = 0; t < trees.size(); ++t) {
+        const json& source = trees[t];
+        const json& lefts = source.at("left_children");
+        const json& rights = source.at("right_children");
+        const json& features = source.at("split_indices");
+        const json& conditions = source.at("split_conditions");
+        const json& defaultLeft = source.at("default_left");
+
+        TreeEnsembleTree tree;
+        tree.output = treeInfo.at(t).get<uint32_t>();
+        tree.root = 0;
+        tree.nodes.resize(lefts.size());
+        for (size_t i = 0; i < lefts.size(); ++i) {
+            TreeEnsembleNode& node = tree.nodes[i];
+            const int32_t left = lefts[i].get<int32_t>();
+            // 叶子的split_conditions保存叶子值
+            if (left < 0) {
+                node.leafValue = jsonNumber(conditions.at(i));
+                continue;
+            }
+            node.feature = features.at(i).get<int32_t>();
+            node.threshold = jsonNumber(conditions.at(i));
+            node.left = left;
+            node.right = rights.at(i).get<int32_t>();
+            node.defaultLeft = jsonNumber(defaultLeft.at(i)) != 0.0;
+        }
+        spec.trees.push_back(std::move(tree));
+    }
+}
+
+int32_t parseLightgbmNode(const json& node, TreeEnsembleTree& tree, double leafScale) {
+    const int32_t index = static_cast<int32_t>(tree.nodes.size());
+    tree.nodes.emplace_back();
+    if (node.contains("leaf_value")) {
+        tree.nodes[index].leafValue = jsonNumber(node.at("leaf_value")) * leafScale;
+        return index;
+    }
+
+    if (node.at("decision_type").get<std::string>() != "<=") {
+        throw std::runtime_error("unsupported decision type: " + node.at("decision_type").get<std::string>());
+    }
+    TreeEnsembleNode split;
+    split.feature = node.at("split_feature").get<int32_t>();
+    split.threshold = jsonNumber(node.at("threshold"));
+    const std::string missingType = node.value("missing_type", std::string("None"));
+    if (missingType == "NaN") {
+        split.defaultLeft = node.at("default_left").get<bool>();
+    } else if (missingType == "None") {
+        // LightGBM把NaN当作0参与比较
+        split.defaultLeft = 0.0 <= split.threshold;
+    } else {
+        throw std::runtime_error("unsupported missing type: " + missingType);
+    }
+    split.left = parseLightgbmNode(node.at("left_child"), tree, leafScale);
+    split.right = parseLightgbmNode(node.at("right_child"), tree, leafScale);
+    tree.nodes[index] = split;
+    return index;
+}
+
+void parseLightgbm(const json& root, TreeEnsembleSpec& spec) {
+    spec.compare = SplitCompare::LESS_EQUAL;
+    spec.baseScore = 0.0;
+    spec.featureCount = root.at("max_feature_idx").get<uint32_t>() + 1;
+    spec.outputCount = std::max<uint32_t>(root.value("num_class", 1u), 1);
+    const uint32_t treesPerIteration = std::max<uint32_t>(root.value("num_tree_per_iteration", spec.outputCount), 1);
+
+    // "binary sigmoid:2"：概率为1/(1+exp(-2·score))，把系数乘进叶子值
+    const std::string objective = root.value("objective", std::string());
+    double leafScale = 1.0;
+    if (objective.compare(0, 6, "binary") == 0 || objective.compare(0, 13, "multiclassova") == 0 ||
+        objective.compare(0, 13, "cross_entropy") == 0) {
+        spec.transform = OutputTransform::SIGMOID;
+        const size_t pos = objective.find("sigmoid:");
+        if (pos != std::string::npos) {
+            leafScale = std::stod(objective.substr(pos + 8));
+        }
+    } else if (objective.compare(0, 10, "multiclass") == 0) {
+        spec.transform = OutputTransform::SOFTMAX;
+    } else {
+        spec.transform = OutputTransform::NONE;
+    }
+
+    spec.trees.clear();
+    for (const json& info : root.at("tree_info")) {
+        TreeEnsembleTree tree;
+        tree.output = info.at("tree_index").get<uint32_t>() % treesPerIteration;
+        tree.root = parseLightgbmNode(info.at("tree_structure"), tree, leafScale);
+        spec.trees.push_back(std::move(tree));
+    }
+}
+
+// ---------------- 编译 ----------------
+
+// 换成与原比较等价的float阈值：x < t ⇔ x < 不小于t的最小float；x <= t ⇔ x <= 不大于t的最大float
+float exactThreshold(double threshold, SplitCompare compare) {
+    float value = static_cast<float>(threshold);
+    if (compare == SplitCompare::LESS && static_cast<double>(value) < threshold) {
+        value = std::nextafter(value, std::numeric_limits<float>::infinity());
+    } else if (compare == SplitCompare::LESS_EQUAL && static_cast<double>(value) > threshold) {
+        value = std::nextafter(value, -std::numeric_limits<float>::infinity());
+    }
+    return value;
+}
+
+// 分箱下标：LESS时为不大于x的阈值个数，LESS_EQUAL时为小于x的阈值个数；
+// 于是 x (<|<=) thresholds[j] ⇔ bin(x) <= j
+inline uint16_t binOf(float x, const float* begin, const float* end, SplitCompare compare) {
+    if (std::isnan(x)) {
+        return TreeEnsemble::kMissingBin;
+    }
+    const float* it = compare == SplitCompare::LESS ? std::upper_bound(begin, end, x) : std::lower_bound(begin, end, x);
+    return static_cast<uint16_t>(it - begin);
+}
+
+// 从根出发检查树的结构：下标有效、无环、每个节点只被引用一次
+bool validateTree(const TreeEnsembleTree& tree, uint32_t featureCount, size_t treeIndex) {
+    const int32_t size = static_cast<int32_t>(tree.nodes.size());
+    if (tree.root < 0 || tree.root >= size) {
+        std::cerr << "Tree " << treeIndex << ": invalid root" << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> visited(tree.nodes.size(), 0);
+    std::vector<int32_t> pending(1, tree.root);
+    visited[tree.root] = 1;
+    while (!pending.empty()) {
+        const TreeEnsembleNode& node = tree.nodes[pending.back()];
+        pending.pop_back();
+        if (node.feature < 0) {
+            continue;
+        }
+        if (static_cast<uint32_t>(node.feature) >= featureCount || std::isnan(node.threshold)) {
+            std::cerr << "Tree " << treeIndex << ": invalid split feature " << node.feature << std::endl;
+            return false;
+        }
+        for (int32_t child : {node.left, node.right}) {
+            if (child < 0 || child >= size || visited[child]) {
+                std::cerr << "Tree " << treeIndex << ": invalid child " << child << std::endl;
+                return false;
+            }
+            visited[child] = 1;
+            pending.push_back(child);
+        }
+    }
+    return true;
+}
+
+// ---------------- 遍历内核 ----------------
+
+// 标量实现：8行交错推进，各行互不依赖的取数可以同时在途
+void traverseScalar(const FlatNode* nodes, const FlatTree& tree, const uint16_t* bins, size_t binStride,
+                    size_t rows, uint32_t* leaves) {
+    constexpr size_t kBlock = 8;
+    for (size_t r0 = 0; r0 < rows; r0 += kBlock) {
+        const size_t count = std::min(kBlock, rows - r0);
+        uint32_t index[kBlock];
+        for (size_t i = 0; i < kBlock; ++i) {
+            index[i] = tree.root;
+        }
+        for (uint32_t d = 0; d < tree.depth; ++d) {
+            for (size_t i = 0; i < count; ++i) {
+                const FlatNode node = nodes[index[i]];
+                const uint16_t bin = bins[(r0 + i) * binStride + (node.feature & TreeEnsemble::kFeatureMask)];
+                const bool missingLeft = bin == TreeEnsemble::kMissingBin && (node.feature & TreeEnsemble::kDefaultLeft);
+                index[i] = node.leftChild + static_cast<uint32_t>(bin > node.bin && !missingLeft);
+            }
+        }
+        std::copy(index, index + count, leaves + r0);
+    }
+}
+
+#if HFT_SIMD_DISPATCH
+
+// AVX2：一次推进8行，节点和分箱下标都用gather读取
+HFT_TARGET_AVX2 void traverseAvx2(const FlatNode* nodes, const FlatTree& tree, const uint16_t* bins,
+                                  size_t binStride, size_t rows, uint32_t* leaves) {
+    const int* nodeWords = reinterpret_cast<const int*>(nodes);
+    const int* binBase = reinterpret_cast<const int*>(bins);
+    const __m256i featureMask = _mm256_set1_epi32(TreeEnsemble::kFeatureMask);
+    const __m256i defaultLeft = _mm256_set1_epi32(TreeEnsemble::kDefaultLeft);
+    const __m256i lowHalf = _mm256_set1_epi32(0xffff);
+    const __m256i laneBytes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                 _mm256_set1_epi32(static_cast<int>(binStride * 2)));
+
+    size_t r0 = 0;
+    for (; r0 + 8 <= rows; r0 += 8) {
+        const __m256i rowBytes = _mm256_add_epi32(laneBytes, _mm256_set1_epi32(static_cast<int>(r0 * binStride * 2)));
+        __m256i index = _mm256_set1_epi32(static_cast<int>(tree.root));
+        for (uint32_t d = 0; d < tree.depth; ++d) {
+            const __m256i head = _mm256_i32gather_epi32(nodeWords, index, 8);
+            const __m256i left = _mm256_i32gather_epi32(nodeWords + 1, index, 8);
+            const __m256i feature = _mm256_and_si256(head, featureMask);
+            const __m256i threshold = _mm256_srli_epi32(head, 16);
+            // 按字节偏移读取32位再取低16位；m_bins末尾留有余量
+            const __m256i offset = _mm256_add_epi32(rowBytes, _mm256_slli_epi32(feature, 1));
+            const __m256i bin = _mm256_and_si256(_mm256_i32gather_epi32(binBase, offset, 1), lowHalf);
+            const __m256i greater = _mm256_cmpgt_epi32(bin, threshold);
+            const __m256i missingLeft = _mm256_and_si256(_mm256_cmpeq_epi32(bin, lowHalf),
+                                                         _mm256_cmpeq_epi32(_mm256_and_si256(head, defaultLeft), defaultLeft));
+            // 走右时掩码为-1，下标为leftChild + 1
+            index = _mm256_sub_epi32(left, _mm256_andnot_si256(missingLeft, greater));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(leaves + r0), index);
+    }
+    if (r0 < rows) {
+        traverseScalar(nodes, tree, bins + r0 * binStride, binStride, rows - r0, leaves + r0);
+    }
+}
+
+// GCC 12的avx512fintrin.h中gather的未定义初值会误报未初始化
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// AVX-512：一次推进16行
+HFT_TARGET_AVX512 void traverseAvx512(const FlatNode* nodes, const FlatTree& tree, const uint16_t* bins,
+                                      size_t binStride, size_t rows, uint32_t* leaves) {
+    const int* nodeWords = reinterpret_cast<const int*>(nodes);
+    const int* binBase = reinterpret_cast<const int*>(bins);
+    const __m512i featureMask = _mm512_set1_epi32(TreeEnsemble::kFeatureMask);
+    const __m512i defaultLeft = _mm512_set1_epi32(TreeEnsemble::kDefaultLeft);
+    const __m512i lowHalf = _mm512_set1_epi32(0xffff);
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i laneBytes = _mm512_mullo_epi32(
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+        _mm512_set1_epi32(static_cast<int>(binStride * 2)));
+
+    size_t r0 = 0;
+    for (; r0 + 16 <= rows; r0 += 16) {
+        const __m512i rowBytes = _mm512_add_epi32(laneBytes, _mm512_set1_epi32(static_cast<int>(r0 * binStride * 2)));
+        __m512i index = _mm512_set1_epi32(static_cast<int>(tree.root));
+        for (uint32_t d = 0; d < tree.depth; ++d) {
+            const __m512i head = _mm512_i32gather_epi32(index, nodeWords, 8);
+            const __m512i left = _mm512_i32gather_epi32(index, nodeWords + 1, 8);
+            const __m512i feature = _mm512_and_si512(head, featureMask);
+            const __m512i threshold = _mm512_srli_epi32(head, 16);
+            const __m512i offset = _mm512_add_epi32(rowBytes, _mm512_slli_epi32(feature, 1));
+            const __m512i bin = _mm512_and_si512(_mm512_i32gather_epi32(offset, binBase, 1), lowHalf);
+            const __mmask16 missingLeft = _mm512_cmpeq_epi32_mask(bin, lowHalf) &
+                                          _mm512_test_epi32_mask(head, defaultLeft);
+            const __mmask16 goRight = _mm512_cmpgt_epi32_mask(bin, threshold) & static_cast<__mmask16>(~missingLeft);
+            index = _mm512_mask_add_epi32(left, goRight, left, one);
+        }
+        _mm512_storeu_si512(leaves + r0, index);
+    }
+    if (r0 < rows) {
+        traverseAvx2(nodes, tree, bins + r0 * binStride, binStride, rows - r0, leaves + r0);
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+TreeEnsemble::TraverseKernel selectTraverseKernel(utils::SimdLevel level) {
+#if HFT_SIMD_DISPATCH
+    switch (level) {
+        case utils::SimdLevel::AVX512: return &traverseAvx512;
+        case utils::SimdLevel::AVX2: return &traverseAvx2;
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    return &traverseScalar;
+}
+
+// ---------------- 代码生成 ----------------
+
+std::string floatLiteral(float value) {
+    if (std::isinf(value)) {
+        return value > 0 ? "HUGE_VALF" : "-HUGE_VALF";
+    }
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%af", static_cast<double>(value));
+    return buffer;
+}
+
+} // namespace
+
+void applyXgboostObjective(TreeEnsembleSpec& spec, const std::string& objective, double baseScore) {
+    if (objective == "binary:logistic" || objective == "reg:logistic") {
+        spec.transform = OutputTransform::SIGMOID;
+        spec.baseScore = -std::log(1.0 / baseScore - 1.0);
+    } else if (objective == "multi:softprob" || objective == "multi:softmax") {
+        spec.transform = OutputTransform::SOFTMAX;
+        spec.baseScore = baseScore;
+    } else {
+        spec.transform = OutputTransform::NONE;
+        spec.baseScore = baseScore;
+    }
+}
+
+bool parseTreeEnsembleJson(const std::string& text, TreeEnsembleSpec& spec) {
+    try {
+        const json root = json::parse(text);
+        if (root.is_array()) {
+            parseXgboostDump(root, spec);
+        } else if (root.contains("learner")) {
+            parseXgboostModel(root, spec);
+        } else if (root.contains("tree_info")) {
+            parseLightgbm(root, spec);
+        } else {
+            std::cerr << "Unrecognized tree ensemble JSON" << std::endl;
+            return false;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to parse tree ensemble JSON: " << e.what() << std::endl;
+        return false;
+    }
+
+    if (spec.featureCount == 0) {
+        for (const TreeEnsembleTree& tree : spec.trees) {
+            for (const TreeEnsembleNode& node : tree.nodes) {
+                spec.featureCount = std::max(spec.featureCount, static_cast<uint32_t>(node.feature + 1));
+            }
+        }
+        spec.featureCount = std::max<uint32_t>(spec.featureCount, 1);
+    }
+    return true;
+}
+
+bool loadTreeEnsembleJson(const std::string& path, TreeEnsembleSpec& spec) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open tree ensemble file: " << path << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return parseTreeEnsembleJson(buffer.str(), spec);
+}
+
+TreeEnsemble::TreeEnsemble() : TreeEnsemble(utils::detectSimdLevel()) {
+}
+
+TreeEnsemble::TreeEnsemble(utils::SimdLevel level)
+    : m_level(level > utils::detectSimdLevel() ? utils::detectSimdLevel() : level),
+      m_traverse(selectTraverseKernel(m_level)),
+      m_featureCount(0),
+      m_outputCount(0),
+      m_compare(SplitCompare::LESS),
+      m_baseScore(0.0f),
+      m_transform(OutputTransform::NONE) {
+#if !HFT_SIMD_DISPATCH
+    m_level = utils::SimdLevel::SCALAR;
+#endif
+}
+
+void TreeEnsemble::clear() {
+    m_nodes.clear();
+    m_leafValues.clear();
+    m_trees.clear();
+    m_thresholds.clear();
+    m_thresholdStart.clear();
+    m_featureCount = 0;
+    m_outputCount = 0;
+}
+
+bool TreeEnsemble::loadJson(const std::string& path) {
+    TreeEnsembleSpec spec;
+    return loadTreeEnsembleJson(path, spec) && compile(spec);
+}
+
+bool TreeEnsemble::loadModel(const std::string& path) {
+    utils::MappedFile file;
+    pattern::GbdtModelSpec model;
+    if (!file.open(path) || !pattern::unpackGbdtModel(file.data(), file.size(), model)) {
+        std::cerr << "Invalid GBDT model file: " << path << std::endl;
+        return false;
+    }
+    return compile(model);
+}
+
+bool TreeEnsemble::compile(const pattern::GbdtModelSpec& model) {
+    TreeEnsembleSpec spec;
+    spec.featureCount = model.inputs;
+    spec.outputCount = model.outputs;
+    spec.compare = SplitCompare::LESS;
+    spec.baseScore = model.baseScore;
+    spec.transform = model.transform;
+    spec.trees.resize(model.trees.size());
+    for (size_t t = 0; t < model.trees.size(); ++t) {
+        const pattern::TreeSpec& source = model.trees[t];
+        TreeEnsembleTree& tree = spec.trees[t];
+        tree.output = source.output;
+        tree.root = 0;
+        tree.nodes.resize(source.nodes.size());
+        for (size_t i = 0; i < source.nodes.size(); ++i) {
+            const pattern::TreeNodeSpec& node = source.nodes[i];
+            TreeEnsembleNode& out = tree.nodes[i];
+            out.feature = node.feature < 0 ? -1 : node.feature;
+            out.defaultLeft = node.defaultLeft;
+            if (out.feature < 0) {
+                out.leafValue = node.value;
+            } else {
+                out.threshold = node.value;
+                out.left = static_cast<int32_t>(node.left);
+                out.right = static_cast<int32_t>(node.right);
+            }
+        }
+    }
+    return compile(spec);
+}
+
+bool TreeEnsemble::compile(const TreeEnsembleSpec& spec) {
+    clear();
+    if (spec.trees.empty() || spec.featureCount == 0 || spec.featureCount > kMaxFeatures || spec.outputCount == 0 ||
+        spec.transform > OutputTransform::SOFTMAX) {
+        std::cerr << "Invalid tree ensemble" << std::endl;
+        return false;
+    }
+    size_t totalNodes = 0;
+    for (size_t t = 0; t < spec.trees.size(); ++t) {
+        if (spec.trees[t].output >= spec.outputCount || !validateTree(spec.trees[t], spec.featureCount, t)) {
+            return false;
+        }
+        totalNodes += spec.trees[t].nodes.size();
+    }
+    if (totalNodes > kMaxNodes) {
+        std::cerr << "Tree ensemble too large: " << totalNodes << " nodes" << std::endl;
+        return false;
+    }
+
+    // 每个特征的阈值表（不可达的节点也可能计入，只多占几个分箱）
+    std::vector<std::vector<float>> thresholds(spec.featureCount);
+    for (const TreeEnsembleTree& tree : spec.trees) {
+        for (const TreeEnsembleNode& node : tree.nodes) {
+            if (node.feature >= 0 && static_cast<uint32_t>(node.feature) < spec.featureCount &&
+                !std::isnan(node.threshold)) {
+                thresholds[node.feature].push_back(exactThreshold(node.threshold, spec.compare));
+            }
+        }
+    }
+    m_thresholdStart.push_back(0);
+    for (std::vector<float>& values : thresholds) {
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        if (values.size() > kMaxThresholds) {
+            std::cerr << "Too many distinct thresholds for one feature: " << values.size() << std::endl;
+            clear();
+            return false;
+        }
+        m_thresholds.insert(m_thresholds.end(), values.begin(), values.end());
+        m_thresholdStart.push_back(static_cast<uint32_t>(m_thresholds.size()));
+    }
+
+    // 按广度优先展开每棵树，子节点成对追加
+    m_nodes.reserve(totalNodes);
+    m_leafValues.reserve(totalNodes);
+    std::vector<std::pair<int32_t, uint32_t>> queue;     // (原节点, 深度)
+    for (const TreeEnsembleTree& tree : spec.trees) {
+        FlatTree flat;
+        flat.root = static_cast<uint32_t>(m_nodes.size());
+        flat.depth = 0;
+        flat.output = tree.output;
+
+        queue.assign(1, {tree.root, 0});
+        m_nodes.emplace_back();
+        m_leafValues.push_back(0.0f);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const TreeEnsembleNode& source = tree.nodes[queue[head].first];
+            const uint32_t depth = queue[head].second;
+            const uint32_t position = flat.root + static_cast<uint32_t>(head);
+            FlatNode& node = m_nodes[position];
+            if (source.feature < 0) {
+                node.feature = kDefaultLeft;
+                node.bin = kLeafBin;
+                node.leftChild = position;
+                m_leafValues[position] = static_cast<float>(source.leafValue);
+                continue;
+            }
+
+            const float threshold = exactThreshold(source.threshold, spec.compare);
+            const std::vector<float>& values = thresholds[source.feature];
+            node.feature = static_cast<uint16_t>(source.feature | (source.defaultLeft ? kDefaultLeft : 0));
+            node.bin = static_cast<uint16_t>(std::lower_bound(values.begin(), values.end(), threshold) - values.begin());
+            node.leftChild = static_cast<uint32_t>(m_nodes.size());
+            queue.push_back({source.left, depth + 1});
+            queue.push_back({source.right, depth + 1});
+            m_nodes.emplace_back();
+            m_nodes.emplace_back();
+            m_leafValues.push_back(0.0f);
+            m_leafValues.push_back(0.0f);
+            flat.depth = std::max(flat.depth, depth + 1);
+        }
+        m_trees.push_back(flat);
+    }
+
+    m_featureCount = spec.featureCount;
+    m_outputCount = spec.outputCount;
+    m_compare = spec.compare;
+    m_baseScore = static_cast<float>(spec.baseScore);
+    m_transform = spec.transform;
+    // gather按32位读取最后一个特征时会多读2字节
+    m_bins.assign(kMaxBatch * m_featureCount + 2, 0);
+    m_leaves.assign(kMaxBatch, 0);
+    return true;
+}
+
+void TreeEnsemble::binRows(const float* features, size_t rows) {
+    for (size_t r = 0; r < rows; ++r) {
+        const float* x = features + r * m_featureCount;
+        uint16_t* bins = m_bins.data() + r * m_featureCount;
+        for (size_t f = 0; f < m_featureCount; ++f) {
+            bins[f] = binOf(x[f], m_thresholds.data() + m_thresholdStart[f],
+                            m_thresholds.data() + m_thresholdStart[f + 1], m_compare);
+        }
+    }
+}
+
+void TreeEnsemble::predict(const float* features, size_t rows, float* outputs) {
+    if (!isLoaded()) {
+        return;
+    }
+    for (size_t offset = 0; offset < rows; offset += kMaxBatch) {
+        const size_t count = std::min(kMaxBatch, rows - offset);
+        float* out = outputs + offset * m_outputCount;
+        binRows(features + offset * m_featureCount, count);
+        std::fill(out, out + count * m_outputCount, m_baseScore);
+
+        // 外层按树：一棵树的节点在整批遍历期间留在缓存中
+        for (const FlatTree& tree : m_trees) {
+            m_traverse(m_nodes.data(), tree, m_bins.data(), m_featureCount, count, m_leaves.data());
+            for (size_t r = 0; r < count; ++r) {
+                out[r * m_outputCount + tree.output] += m_leafValues[m_leaves[r]];
+            }
+        }
+        applyTransform(out, count);
+    }
+}
+
+void TreeEnsemble::applyTransform(float* outputs, size_t rows) const {
+    if (m_transform == OutputTransform::SIGMOID) {
+        for (size_t i = 0; i < rows * m_outputCount; ++i) {
+            outputs[i] = 1.0f / (1.0f + std::exp(-outputs[i]));
+        }
+    } else if (m_transform == OutputTransform::SOFTMAX) {
+        for (size_t r = 0; r < rows; ++r) {
+            float* row = outputs + r * m_outputCount;
+            const float maxValue = *std::max_element(row, row + m_outputCount);
+            float sum = 0.0f;
+            for (size_t i = 0; i < m_outputCount; ++i) {
+                row[i] = std::exp(row[i] - maxValue);
+                sum += row[i];
+            }
+            for (size_t i = 0; i < m_outputCount; ++i) {
+                row[i] /= sum;
+            }
+        }
+    }
+}
+
+std::string TreeEnsemble::generateCpp(const std::string& functionName) const {
+    if (!isLoaded()) {
+        return std::string();
+    }
+    std::ostringstream code;
+    code << "// Generated by hft::ai::TreeEnsemble::generateCpp: " << m_trees.size() << " trees, "
+         << m_featureCount << " features, " << m_outputCount << " outputs\n"
+         << "#include <algorithm>\n#include <cmath>\n\n"
+         << "void " << functionName << "(const float* features, float* outputs) {\n"
+         << "    float sum[" << m_outputCount << "];\n"
+         << "    for (int i = 0; i < " << m_outputCount << "; ++i) {\n"
+         << "        sum[i] = " << floatLiteral(m_baseScore) << ";\n"
+         << "    }\n";
+
+    // 缺失值走左时用取反的比较，NaN使其成立
+    const char* compareOp = m_compare == SplitCompare::LESS ? " < " : " <= ";
+    const char* inverseOp = m_compare == SplitCompare::LESS ? " >= " : " > ";
+    for (size_t t = 0; t < m_trees.size(); ++t) {
+        const FlatTree& tree = m_trees[t];
+        code << "    // tree " << t << "\n";
+        // 显式栈代替递归；状态0输出if，1输出else，2闭合
+        std::vector<uint32_t> nodes(1, tree.root);
+        std::vector<int> states(1, 0);
+        while (!nodes.empty()) {
+            const uint32_t index = nodes.back();
+            const FlatNode& node = m_nodes[index];
+            const std::string indent(4 * (nodes.size()), ' ');
+            if (node.bin == kLeafBin && node.leftChild == index) {
+                code << indent << "sum[" << tree.output << "] += " << floatLiteral(m_leafValues[index]) << ";\n";
+                nodes.pop_back();
+                states.pop_back();
+                continue;
+            }
+            const size_t feature = node.feature & kFeatureMask;
+            int& state = states.back();
+            if (state == 0) {
+                const std::string threshold = floatLiteral(m_thresholds[m_thresholdStart[feature] + node.bin]);
+                code << indent << "if (";
+                if (node.feature & kDefaultLeft) {
+                    code << "!(features[" << feature << "]" << inverseOp << threshold << ")";
+                } else {
+                    code << "features[" << feature << "]" << compareOp << threshold;
+                }
+                code << ") {\n";
+                state = 1;
+                nodes.push_back(node.leftChild);
+                states.push_back(0);
+            } else if (state == 1) {
+                code << indent << "} else {\n";
+                state = 2;
+                nodes.push_back(node.leftChild + 1);
+                states.push_back(0);
+            } else {
+                code << indent << "}\n";
+                nodes.pop_back();
+                states.pop_back();
+            }
+        }
+    }
+
+    if (m_transform == OutputTransform::SIGMOID) {
+        code << "    for (int i = 0; i < " << m_outputCount << "; ++i) {\n"
+             << "        outputs[i] = 1.0f / (1.0f + std::exp(-sum[i]));\n"
+             << "    }\n";
+    } else if (m_transform == OutputTransform::SOFTMAX) {
+        code << "    const float maxValue = *std::max_element(sum, sum + " << m_outputCount << ");\n"
+             << "    float total = 0.0f;\n"
+             << "    for (int i = 0; i < " << m_outputCount << "; ++i) {\n"
+             << "        sum[i] = std::exp(sum[i] - maxValue);\n"
+             << "        total += sum[i];\n"
+             << "    }\n"
+             << "    for (int i = 0; i < " << m_outputCount << "; ++i) {\n"
+             << "        outputs[i] = sum[i] / total;\n"
+             << "    }\n";
+    } else {
+        code << "    for (int i = 0; i < " << m_outputCount << "; ++i) {\n"
+             << "        outputs[i] = sum[i];\n"
+             << "    }\n";
+    }
+    code << "}\n";
+    return code.str();
+}
+
+} // namespace ai
+} // namespace hft
@@ -0,0 +1,145 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../pattern/InferenceRuntime.h"
+#include "../utils/SimdSupport.h"
+
+namespace hft {
+namespace ai {
+
+// 梯度提升树集成的本地打分引擎（XGBoost / LightGBM / .hftm GBDT），进程内唯一的GBDT实现
+//
+// compile()把树编译成紧凑的扁平结构：
+//   - 阈值量化：每个特征在全部树中用到的阈值排序去重，节点只保存阈值的下标（uint16）；
+//     每行特征先查一次表换成分箱下标，之后所有树的比较都是整数比较，结果与原始浮点比较完全一致
+//   - 每棵树按广度优先排列，左右子节点相邻，节点8字节；叶子指向自身，遍历固定走depth步，无分支
+//   - 一批行交错遍历同一棵树（标量8行一组，AVX2/AVX-512用gather一次推进8/16行），
+//     多行的访存互相重叠，树的节点在整批期间留在缓存中
+// 固定模型还可以用generateCpp()生成展开成if/else的C++源码，直接编译进程序。
+
+// 分裂比较方式：XGBoost为 x < t，LightGBM为 x <= t
+enum class SplitCompare : uint8_t {
+    LESS = 0,
+    LESS_EQUAL = 1
+};
+
+// 解析得到的树节点（节点顺序任意）：feature < 0为叶子
+struct TreeEnsembleNode {
+    int32_t feature = -1;
+    double threshold = 0.0;
+    int32_t left = -1;
+    int32_t right = -1;
+    bool defaultLeft = true;    // 特征缺失（NaN）时走左子树
+    double leafValue = 0.0;
+};
+
+struct TreeEnsembleTree {
+    uint32_t output = 0;        // 叶子值累加到第output个输出（多分类的类别）
+    int32_t root = 0;
+    std::vector<TreeEnsembleNode> nodes;
+};
+
+struct TreeEnsembleSpec {
+    uint32_t featureCount = 0;
+    uint32_t outputCount = 1;
+    SplitCompare compare = SplitCompare::LESS;
+    double baseScore = 0.0;     // 加到每个输出上的初始margin
+    pattern::OutputTransform transform = pattern::OutputTransform::NONE;
+    std::vector<TreeEnsembleTree> trees;
+};
+
+// 解析JSON，自动识别三种格式：
+//   - XGBoost dump_model(dump_format="json")：树数组；不含base_score、类别数和目标函数，
+//     这些沿用调用方预先填在spec中的值，多分类时第i棵树属于第 i % outputCount 类
+//   - XGBoost save_model(*.json)：learner.gradient_booster.model
+//   - LightGBM dump_model()：tree_info
+// featureCount为0时取用到的最大特征下标+1
+bool parseTreeEnsembleJson(const std::string& text, TreeEnsembleSpec& spec);
+bool loadTreeEnsembleJson(const std::string& path, TreeEnsembleSpec& spec);
+// 按XGBoost目标函数设置输出变换与baseScore（logistic目标的base_score是概率，换成margin）；
+// dump格式不含这些信息，解析前由调用方用训练时的参数填入spec
+void applyXgboostObjective(TreeEnsembleSpec& spec, const std::string& objective, double baseScore);
+
+class TreeEnsemble {
+public:
+    // 每次分箱、打分的最大行数，更大的批自动分块
+    static constexpr size_t kMaxBatch = 64;
+
+    TreeEnsemble();
+    explicit TreeEnsemble(utils::SimdLevel level);
+
+    bool compile(const TreeEnsembleSpec& spec);
+    // 编译.hftm中的GBDT模型（比较为 x < t）
+    bool compile(const pattern::GbdtModelSpec& model);
+    // 解析并编译，spec中未给出的参数取默认值
+    bool loadJson(const std::string& path);
+    // 读取.hftm GBDT模型文件并编译
+    bool loadModel(const std::string& path);
+    void clear();
+
+    bool isLoaded() const { return !m_trees.empty(); }
+    size_t featureCount() const { return m_featureCount; }
+    size_t outputCount() const { return m_outputCount; }
+    size_t treeCount() const { return m_trees.size(); }
+    size_t nodeCount() const { return m_nodes.size(); }
+    utils::SimdLevel simdLevel() const { return m_level; }
+
+    // 零分配打分：features为rows×featureCount()行优先，outputs为rows×outputCount()。
+    // 使用内部的分箱缓冲区，同一对象不能并发调用
+    void predict(const float* features, size_t rows, float* outputs);
+
+    // 生成等价的C++源码：void functionName(const float* features, float* outputs)，
+    // 阈值以十六进制浮点字面量输出，结果与predict()一致
+    std::string generateCpp(const std::string& functionName) const;
+
+    // 扁平节点：leftChild为左子节点下标，右子节点为leftChild + 1；
+    // 叶子的bin为kLeafBin、leftChild指向自身，因此继续遍历停在原地
+    struct FlatNode {
+        uint16_t feature;       // 最高位kDefaultLeft：缺失值走左
+        uint16_t bin;           // bin(x) <= bin走左
+        uint32_t leftChild;
+    };
+
+    struct FlatTree {
+        uint32_t root;
+        uint32_t depth;
+        uint32_t output;
+    };
+
+    static constexpr uint16_t kDefaultLeft = 0x8000;
+    static constexpr uint16_t kFeatureMask = 0x7fff;
+    static constexpr uint16_t kLeafBin = 0xffff;
+    static constexpr uint16_t kMissingBin = 0xffff;
+
+    // 一组行遍历一棵树的内核：bins为rows × binStride的分箱下标，leaves[r]写出第r行到达的叶子下标
+    using TraverseKernel = void (*)(const FlatNode* nodes, const FlatTree& tree, const uint16_t* bins,
+                                    size_t binStride, size_t rows, uint32_t* leaves);
+
+private:
+    // 把一批行换成分箱下标
+    void binRows(const float* features, size_t rows);
+    void applyTransform(float* outputs, size_t rows) const;
+
+    utils::SimdLevel m_level;
+    TraverseKernel m_traverse;
+    size_t m_featureCount;
+    size_t m_outputCount;
+    SplitCompare m_compare;
+    float m_baseScore;
+    pattern::OutputTransform m_transform;
+
+    std::vector<FlatNode> m_nodes;
+    std::vector<float> m_leafValues;            // 与m_nodes下标对应，仅叶子有效
+    std::vector<FlatTree> m_trees;
+    // 每个特征排序去重后的阈值，m_thresholds[m_thresholdStart[f] ..)
+    std::vector<float> m_thresholds;
+    std::vector<uint32_t> m_thresholdStart;
+
+    std::vector<uint16_t> m_bins;               // kMaxBatch × featureCount，末尾留出gather越界读取的余量
+    std::vector<uint32_t> m_leaves;             // kMaxBatch
+};
+
+} // namespace ai
+} // namespace hft
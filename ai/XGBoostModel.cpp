@@ -0,0 +1,83 @@
+#include "MLModels.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace hft {
+namespace ai {
+
+void XGBoostModel::initialize(const XGBoostConfig& config) {
+    config_ = config;
+}
+
+void XGBoostModel::train(const std::vector<std::vector<double>>& /*features*/,
+                         const std::vector<double>& /*labels*/) {
+    std::cerr << "XGBoostModel does not train online; load a model exported by XGBoost or LightGBM" << std::endl;
+}
+
+std::vector<double> XGBoostModel::predict(const std::vector<std::vector<double>>& features) {
+    std::vector<double> result;
+    if (!ensemble_.isLoaded()) {
+        std::cerr << "XGBoostModel: no model loaded" << std::endl;
+        return result;
+    }
+
+    const size_t featureCount = ensemble_.featureCount();
+    const size_t outputCount = ensemble_.outputCount();
+    inputBuffer_.resize(features.size() * featureCount);
+    for (size_t r = 0; r < features.size(); ++r) {
+        if (features[r].size() != featureCount) {
+            std::cerr << "XGBoostModel: expected " << featureCount << " features, got " << features[r].size() << std::endl;
+            return result;
+        }
+        std::copy(features[r].begin(), features[r].end(), inputBuffer_.begin() + r * featureCount);
+    }
+    outputBuffer_.resize(features.size() * outputCount);
+    ensemble_.predict(inputBuffer_.data(), features.size(), outputBuffer_.data());
+
+    result.resize(features.size());
+    for (size_t r = 0; r < features.size(); ++r) {
+        const float* row = outputBuffer_.data() + r * outputCount;
+        result[r] = outputCount == 1 ? row[0] : static_cast<double>(std::max_element(row, row + outputCount) - row);
+    }
+    return result;
+}
+
+void XGBoostModel::save(const std::string& path) {
+    if (source_.empty()) {
+        std::cerr << "XGBoostModel: no model loaded" << std::endl;
+        return;
+    }
+    std::ofstream file(path, std::ios::trunc);
+    file << source_;
+    if (!file) {
+        std::cerr << "XGBoostModel: failed to save model to " << path << std::endl;
+    }
+}
+
+void XGBoostModel::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "XGBoostModel: failed to open " << path << std::endl;
+        return;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    // dump格式只有树结构，类别数、base_score和目标函数取自配置
+    TreeEnsembleSpec spec;
+    spec.outputCount = static_cast<uint32_t>(std::max(config_.numClass, 1));
+    applyXgboostObjective(spec, config_.objective, config_.baseScore);
+    if (!parseTreeEnsembleJson(buffer.str(), spec) || !ensemble_.compile(spec)) {
+        std::cerr << "XGBoostModel: failed to load " << path << std::endl;
+        source_.clear();
+        return;
+    }
+    source_ = buffer.str();
+    std::cout << "XGBoostModel loaded: " << ensemble_.treeCount() << " trees, " << ensemble_.nodeCount()
+              << " nodes, SIMD: " << utils::simdLevelName(ensemble_.simdLevel()) << std::endl;
+}
+
+} // namespace ai
+} // namespace hft
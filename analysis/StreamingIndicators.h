@@ -0,0 +1,589 @@
+#pragma once
+#include "../core/SymbolRegistry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace hft {
+namespace analysis {
+
+// 流式技术指标
+//
+// 每个指标是一个小的状态对象，update()为O(1)，适合逐笔行情下对大量品种维护指标；
+// TechnicalIndicators中的批量函数适合一次性处理历史序列。
+// 滚动窗口类指标在环形缓冲区每转一圈时从窗口数据重算一次累加量，
+// 消除增减更新积累的舍入误差（均摊O(1)），单精度下也能长期运行。
+//
+// 模板参数T为float或double。
+
+// K线/逐笔输入，逐笔行情时high = low = close
+template <typename T>
+struct Bar {
+    T high = 0;
+    T low = 0;
+    T close = 0;
+    T volume = 0;
+};
+
+namespace detail {
+
+// 定长环形窗口
+template <typename T>
+class RingWindow {
+public:
+    explicit RingWindow(size_t capacity) : m_values(std::max<size_t>(capacity, 1)), m_pos(0), m_count(0) {}
+
+    // 写入新值，窗口已满时返回被淘汰的值
+    bool push(T value, T& evicted) {
+        const bool full = m_count == m_values.size();
+        evicted = m_values[m_pos];
+        m_values[m_pos] = value;
+        m_pos = m_pos + 1 == m_values.size() ? 0 : m_pos + 1;
+        if (!full) {
+            ++m_count;
+        }
+        return full;
+    }
+
+    // 刚好转完一圈且窗口已满（此时按下标0..n-1即为时间顺序）
+    bool wrapped() const { return m_pos == 0 && m_count == m_values.size(); }
+
+    void clear() {
+        std::fill(m_values.begin(), m_values.end(), T(0));
+        m_pos = 0;
+        m_count = 0;
+    }
+
+    const T* data() const { return m_values.data(); }
+    size_t size() const { return m_count; }
+    size_t capacity() const { return m_values.size(); }
+
+private:
+    std::vector<T> m_values;
+    size_t m_pos;
+    size_t m_count;
+};
+
+// 以下步进函数由单品种指标与多品种批量计算共用，保证两条路径逐位一致
+
+template <typename T>
+inline T emaStep(T value, T x, T alpha) {
+    return (x - value) * alpha + value;
+}
+
+// Welford：窗口未满时加入一个样本
+template <typename T>
+inline void welfordAdd(T& mean, T& m2, T x, T n) {
+    const T delta = x - mean;
+    mean += delta / n;
+    m2 += delta * (x - mean);
+}
+
+// Welford：窗口已满时用x替换最早的样本old
+template <typename T>
+inline void welfordReplace(T& mean, T& m2, T x, T old, T n) {
+    const T oldMean = mean;
+    mean += (x - old) / n;
+    m2 += (x - old) * (x - mean + old - oldMean);
+}
+
+template <typename T>
+inline T varianceOf(T m2, T n) {
+    return n > 0 && m2 > 0 ? m2 / n : T(0);
+}
+
+template <typename T>
+inline T zscoreOf(T x, T mean, T variance) {
+    const T sd = std::sqrt(variance);
+    return sd > 0 ? (x - mean) / sd : T(0);
+}
+
+// Wilder平滑：前period个样本取算术平均，之后 avg = (avg×(period-1) + x) / period
+template <typename T>
+inline T wilderStep(T average, T x, size_t count, size_t period) {
+    if (count <= period) {
+        return average + (x - average) / static_cast<T>(count);
+    }
+    return (average * static_cast<T>(period - 1) + x) / static_cast<T>(period);
+}
+
+} // namespace detail
+
+// 简单移动平均
+template <typename T>
+class StreamingSMA {
+public:
+    using value_type = T;
+
+    explicit StreamingSMA(size_t period) : m_window(period), m_sum(0) {}
+
+    T update(T x) {
+        T evicted;
+        m_sum += x;
+        if (m_window.push(x, evicted)) {
+            m_sum -= evicted;
+        }
+        if (m_window.wrapped()) {
+            m_sum = 0;
+            for (size_t i = 0; i < m_window.size(); ++i) {
+                m_sum += m_window.data()[i];
+            }
+        }
+        return value();
+    }
+    T update(const Bar<T>& bar) { return update(bar.close); }
+
+    // 窗口未满时为已有样本的平均
+    T value() const { return m_window.size() ? m_sum / static_cast<T>(m_window.size()) : T(0); }
+    bool ready() const { return m_window.size() == m_window.capacity(); }
+    void reset() { m_window.clear(); m_sum = 0; }
+
+private:
+    detail::RingWindow<T> m_window;
+    T m_sum;
+};
+
+// 指数移动平均，alpha = 2/(period+1)，以第一个样本为初值
+template <typename T>
+class StreamingEMA {
+public:
+    using value_type = T;
+
+    explicit StreamingEMA(size_t period)
+        : m_alpha(T(2) / static_cast<T>(period + 1)), m_value(0), m_count(0), m_period(period) {}
+
+    T update(T x) {
+        m_value = m_count++ ? detail::emaStep(m_value, x, m_alpha) : x;
+        return m_value;
+    }
+    T update(const Bar<T>& bar) { return update(bar.close); }
+
+    T value() const { return m_value; }
+    bool ready() const { return m_count >= m_period; }
+    T alpha() const { return m_alpha; }
+    void reset() { m_value = 0; m_count = 0; }
+
+private:
+    T m_alpha;
+    T m_value;
+    size_t m_count;
+    size_t m_period;
+};
+
+// 相对强弱指标（Wilder平滑）
+template <typename T>
+class StreamingRSI {
+public:
+    using value_type = T;
+
+    explicit StreamingRSI(size_t period)
+        : m_period(std::max<size_t>(period, 1)), m_prev(0), m_avgGain(0), m_avgLoss(0), m_changes(0), m_started(false) {}
+
+    T update(T x) {
+        if (!m_started) {
+            m_prev = x;
+            m_started = true;
+            return value();
+        }
+        const T diff = x - m_prev;
+        m_prev = x;
+        ++m_changes;
+        m_avgGain = detail::wilderStep(m_avgGain, diff > 0 ? diff : T(0), m_changes, m_period);
+        m_avgLoss = detail::wilderStep(m_avgLoss, diff < 0 ? -diff : T(0), m_changes, m_period);
+        return value();
+    }
+    T update(const Bar<T>& bar) { return update(bar.close); }
+
+    // 无价格变化时为50
+    T value() const {
+        if (m_avgLoss == 0) {
+            return m_avgGain == 0 ? T(50) : T(100);
+        }
+        return T(100) - T(100) / (T(1) + m_avgGain / m_avgLoss);
+    }
+    bool ready() const { return m_changes >= m_period; }
+    void reset() { m_avgGain = m_avgLoss = m_prev = 0; m_changes = 0; m_started = false; }
+
+private:
+    size_t m_period;
+    T m_prev;
+    T m_avgGain;
+    T m_avgLoss;
+    size_t m_changes;
+    bool m_started;
+};
+
+// 滚动均值/方差/Z分数（窗口Welford）
+template <typename T>
+class RollingStats {
+public:
+    using value_type = T;
+
+    explicit RollingStats(size_t window) : m_window(window), m_mean(0), m_m2(0) {}
+
+    // 返回新样本的Z分数
+    T update(T x) {
+        T evicted;
+        if (m_window.push(x, evicted)) {
+            detail::welfordReplace(m_mean, m_m2, x, evicted, static_cast<T>(m_window.size()));
+        } else {
+            detail::welfordAdd(m_mean, m_m2, x, static_cast<T>(m_window.size()));
+        }
+        if (m_window.wrapped()) {
+            resync();
+        }
+        return zscore(x);
+    }
+    T update(const Bar<T>& bar) { return update(bar.close); }
+
+    T mean() const { return m_mean; }
+    // 总体方差（除以n）
+    T variance() const { return detail::varianceOf(m_m2, static_cast<T>(m_window.size())); }
+    T sampleVariance() const {
+        return m_window.size() > 1 && m_m2 > 0 ? m_m2 / static_cast<T>(m_window.size() - 1) : T(0);
+    }
+    T stddev() const { return std::sqrt(variance()); }
+    // 标准差为0时返回0
+    T zscore(T x) const { return detail::zscoreOf(x, m_mean, variance()); }
+
+    size_t count() const { return m_window.size(); }
+    size_t window() const { return m_window.capacity(); }
+    bool ready() const { return m_window.size() == m_window.capacity(); }
+    void reset() { m_window.clear(); m_mean = m_m2 = 0; }
+
+private:
+    void resync() {
+        const T n = static_cast<T>(m_window.size());
+        T sum = 0;
+        for (size_t i = 0; i < m_window.size(); ++i) {
+            sum += m_window.data()[i];
+        }
+        m_mean = sum / n;
+        m_m2 = 0;
+        for (size_t i = 0; i < m_window.size(); ++i) {
+            const T d = m_window.data()[i] - m_mean;
+            m_m2 += d * d;
+        }
+    }
+
+    detail::RingWindow<T> m_window;
+    T m_mean;
+    T m_m2;
+};
+
+// 布林带
+template <typename T>
+class StreamingBollinger {
+public:
+    using value_type = T;
+
+    StreamingBollinger(size_t period, T width = T(2)) : m_stats(period), m_width(width) {}
+
+    T update(T x) { return m_stats.update(x); }
+    T update(const Bar<T>& bar) { return update(bar.close); }
+
+    T middle() const { return m_stats.mean(); }
+    T upper() const { return m_stats.mean() + m_width * m_stats.stddev(); }
+    T lower() const { return m_stats.mean() - m_width * m_stats.stddev(); }
+    // %B：价格在带内的位置，0为下轨，1为上轨
+    T percentB(T x) const {
+        const T band = upper() - lower();
+        return band > 0 ? (x - lower()) / band : T(0.5);
+    }
+    bool ready() const { return m_stats.ready(); }
+    void reset() { m_stats.reset(); }
+
+private:
+    RollingStats<T> m_stats;
+    T m_width;
+};
+
+// MACD
+template <typename T>
+class StreamingMACD {
+public:
+    using value_type = T;
+
+    StreamingMACD(size_t fastPeriod = 12, size_t slowPeriod = 26, size_t signalPeriod = 9)
+        : m_fast(fastPeriod), m_slow(slowPeriod), m_signal(signalPeriod) {}
+
+    T update(T x) {
+        m_signal.update(m_fast.update(x) - m_slow.update(x));
+        return histogram();
+    }
+    T update(const Bar<T>& bar) { return update(bar.close); }
+
+    T macd() const { return m_fast.value() - m_slow.value(); }
+    T signal() const { return m_signal.value(); }
+    T histogram() const { return macd() - signal(); }
+    bool ready() const { return m_slow.ready() && m_signal.ready(); }
+    void reset() { m_fast.reset(); m_slow.reset(); m_signal.reset(); }
+
+private:
+    StreamingEMA<T> m_fast;
+    StreamingEMA<T> m_slow;
+    StreamingEMA<T> m_signal;
+};
+
+// 平均真实波幅（Wilder平滑）
+template <typename T>
+class StreamingATR {
+public:
+    using value_type = T;
+
+    explicit StreamingATR(size_t period)
+        : m_period(std::max<size_t>(period, 1)), m_prevClose(0), m_value(0), m_count(0) {}
+
+    T update(T high, T low, T close) {
+        T range = high - low;
+        if (m_count > 0) {
+            range = std::max(range, std::max(std::abs(high - m_prevClose), std::abs(low - m_prevClose)));
+        }
+        m_prevClose = close;
+        ++m_count;
+        m_value = detail::wilderStep(m_value, range, m_count, m_period);
+        return m_value;
+    }
+    T update(const Bar<T>& bar) { return update(bar.high, bar.low, bar.close); }
+
+    T value() const { return m_value; }
+    bool ready() const { return m_count >= m_period; }
+    void reset() { m_prevClose = m_value = 0; m_count = 0; }
+
+private:
+    size_t m_period;
+    T m_prevClose;
+    T m_value;
+    size_t m_count;
+};
+
+// 成交量加权均价，reset()开始新的交易时段
+template <typename T>
+class StreamingVWAP {
+public:
+    using value_type = T;
+
+    StreamingVWAP() : m_notional(0), m_volume(0), m_last(0) {}
+
+    T update(T price, T volume) {
+        m_notional += price * volume;
+        m_volume += volume;
+        m_last = price;
+        return value();
+    }
+    T update(const Bar<T>& bar) { return update(bar.close, bar.volume); }
+
+    // 尚无成交量时为最新价
+    T value() const { return m_volume > 0 ? m_notional / m_volume : m_last; }
+    T volume() const { return m_volume; }
+    bool ready() const { return m_volume > 0; }
+    void reset() { m_notional = m_volume = m_last = 0; }
+
+private:
+    T m_notional;
+    T m_volume;
+    T m_last;
+};
+
+// 指标流水线：一次update()驱动一组指标
+//   auto pipeline = makePipeline(StreamingEMA<double>(20), RollingStats<double>(50), StreamingATR<double>(14));
+//   pipeline.update(bar);
+//   double z = pipeline.get<1>().zscore(bar.close);
+template <typename T, typename... Indicators>
+class IndicatorPipeline {
+public:
+    using value_type = T;
+
+    explicit IndicatorPipeline(Indicators... indicators) : m_indicators(std::move(indicators)...) {}
+
+    void update(const Bar<T>& bar) {
+        std::apply([&bar](auto&... indicator) { (indicator.update(bar), ...); }, m_indicators);
+    }
+    void update(T price, T volume = T(0)) {
+        Bar<T> bar;
+        bar.high = bar.low = bar.close = price;
+        bar.volume = volume;
+        update(bar);
+    }
+
+    template <size_t I>
+    auto& get() { return std::get<I>(m_indicators); }
+    template <size_t I>
+    const auto& get() const { return std::get<I>(m_indicators); }
+
+    bool ready() const {
+        return std::apply([](const auto&... indicator) { return (indicator.ready() && ...); }, m_indicators);
+    }
+    void reset() {
+        std::apply([](auto&... indicator) { (indicator.reset(), ...); }, m_indicators);
+    }
+
+private:
+    std::tuple<Indicators...> m_indicators;
+};
+
+template <typename First, typename... Rest>
+IndicatorPipeline<typename First::value_type, First, Rest...> makePipeline(First first, Rest... rest) {
+    return IndicatorPipeline<typename First::value_type, First, Rest...>(std::move(first), std::move(rest)...);
+}
+
+// 按品种ID索引的指标表，新品种首次访问时从原型复制
+template <typename Pipeline>
+class SymbolIndicators {
+public:
+    explicit SymbolIndicators(Pipeline prototype) : m_prototype(std::move(prototype)) {}
+
+    Pipeline& operator[](core::SymbolId symbol) {
+        if (symbol >= m_pipelines.size()) {
+            m_pipelines.resize(symbol + 1, m_prototype);
+        }
+        return m_pipelines[symbol];
+    }
+
+    // 不存在时返回nullptr
+    const Pipeline* find(core::SymbolId symbol) const {
+        return symbol < m_pipelines.size() ? &m_pipelines[symbol] : nullptr;
+    }
+
+    size_t size() const { return m_pipelines.size(); }
+
+private:
+    Pipeline m_prototype;
+    std::vector<Pipeline> m_pipelines;
+};
+
+// 批量路径（回测）
+//
+// 横截面批量：所有品种同一时刻一起更新，状态按SoA存放，内层循环跨品种，可被编译器向量化。
+// 每个通道与单品种指标使用相同的步进函数和运算顺序，结果逐位一致。
+
+// 对序列逐个调用update，输出每一步的返回值
+template <typename Indicator, typename T>
+void runSeries(Indicator& indicator, const T* input, size_t size, T* output) {
+    for (size_t i = 0; i < size; ++i) {
+        output[i] = indicator.update(input[i]);
+    }
+}
+
+// 多品种EMA
+template <typename T>
+class EmaBank {
+public:
+    EmaBank(size_t symbols, size_t period)
+        : m_alpha(T(2) / static_cast<T>(period + 1)), m_values(symbols, T(0)), m_seeded(false) {}
+
+    // prices长度为symbols()
+    void update(const T* prices) {
+        T* values = m_values.data();
+        const size_t n = m_values.size();
+        if (!m_seeded) {
+            std::copy(prices, prices + n, values);
+            m_seeded = true;
+            return;
+        }
+        const T alpha = m_alpha;
+        for (size_t i = 0; i < n; ++i) {
+            values[i] = detail::emaStep(values[i], prices[i], alpha);
+        }
+    }
+
+    const T* values() const { return m_values.data(); }
+    size_t symbols() const { return m_values.size(); }
+
+private:
+    T m_alpha;
+    std::vector<T> m_values;
+    bool m_seeded;
+};
+
+// 多品种滚动均值/方差/Z分数
+template <typename T>
+class RollingStatsBank {
+public:
+    RollingStatsBank(size_t symbols, size_t window)
+        : m_symbols(symbols), m_window(std::max<size_t>(window, 1)),
+          m_ring(m_symbols * m_window, T(0)), m_mean(symbols, T(0)), m_m2(symbols, T(0)),
+          m_pos(0), m_count(0) {}
+
+    // values长度为symbols()；zscores非空时输出每个新样本的Z分数
+    void update(const T* values, T* zscores = nullptr) {
+        T* slot = m_ring.data() + m_pos * m_symbols;
+        T* mean = m_mean.data();
+        T* m2 = m_m2.data();
+        const size_t n = m_symbols;
+
+        if (m_count == m_window) {
+            const T count = static_cast<T>(m_count);
+            for (size_t i = 0; i < n; ++i) {
+                const T old = slot[i];
+                slot[i] = values[i];
+                detail::welfordReplace(mean[i], m2[i], values[i], old, count);
+            }
+        } else {
+            const T count = static_cast<T>(++m_count);
+            for (size_t i = 0; i < n; ++i) {
+                slot[i] = values[i];
+                detail::welfordAdd(mean[i], m2[i], values[i], count);
+            }
+        }
+        m_pos = m_pos + 1 == m_window ? 0 : m_pos + 1;
+        if (m_pos == 0 && m_count == m_window) {
+            resync();
+        }
+
+        if (zscores) {
+            const T count = static_cast<T>(m_count);
+            for (size_t i = 0; i < n; ++i) {
+                zscores[i] = detail::zscoreOf(values[i], mean[i], detail::varianceOf(m2[i], count));
+            }
+        }
+    }
+
+    T mean(size_t symbol) const { return m_mean[symbol]; }
+    T variance(size_t symbol) const { return detail::varianceOf(m_m2[symbol], static_cast<T>(m_count)); }
+    T stddev(size_t symbol) const { return std::sqrt(variance(symbol)); }
+    size_t symbols() const { return m_symbols; }
+    size_t count() const { return m_count; }
+
+private:
+    // 与RollingStats::resync相同的累加顺序（按时间顺序逐个样本）
+    void resync() {
+        T* mean = m_mean.data();
+        T* m2 = m_m2.data();
+        const size_t n = m_symbols;
+        const T count = static_cast<T>(m_count);
+
+        std::fill(m_mean.begin(), m_mean.end(), T(0));
+        std::fill(m_m2.begin(), m_m2.end(), T(0));
+        for (size_t k = 0; k < m_window; ++k) {
+            const T* slot = m_ring.data() + k * n;
+            for (size_t i = 0; i < n; ++i) {
+                mean[i] += slot[i];
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            mean[i] /= count;
+        }
+        for (size_t k = 0; k < m_window; ++k) {
+            const T* slot = m_ring.data() + k * n;
+            for (size_t i = 0; i < n; ++i) {
+                const T d = slot[i] - mean[i];
+                m2[i] += d * d;
+            }
+        }
+    }
+
+    size_t m_symbols;
+    size_t m_window;
+    std::vector<T> m_ring;      // m_ring[slot × symbols + i]
+    std::vector<T> m_mean;
+    std::vector<T> m_m2;
+    size_t m_pos;
+    size_t m_count;
+};
+
+} // namespace analysis
+} // namespace hft
@@ -1,5 +1,6 @@
 #pragma once
 #include "../core/Types.h"
+#include "StreamingIndicators.h"
 #include <vector>
 #include <deque>
 #include <cmath>
@@ -78,13 +79,14 @@ public:
         bb.upper.resize(prices.size());
         bb.lower.resize(prices.size());
         
-        for (size_t i = period-1; i < prices.size(); ++i) {
-            double sum = 0;
-            for (int j = 0; j < period; ++j) {
-                double diff = prices[i-j] - bb.middle[i];
-                sum += diff * diff;
+        // 滚动方差，O(n)
+        RollingStats<double> stats(period);
+        for (size_t i = 0; i < prices.size(); ++i) {
+            stats.update(prices[i]);
+            if (i + 1 < static_cast<size_t>(period)) {
+                continue;
             }
-            double std = std::sqrt(sum / period);
+            double std = stats.stddev();
             bb.upper[i] = bb.middle[i] + stdDev * std;
             bb.lower[i] = bb.middle[i] - stdDev * std;
         }
@@ -27,6 +27,16 @@ bool BacktestEngine::initialize() {
     m_initial_capital = m_config.get<double>("backtest.initial_capital", 1000000.0);
     m_current_capital = m_initial_capital;
     m_commission_rate = m_config.get<double>("backtest.commission_rate", 0.001);
+
+    // 回放参数
+    m_replay_config.worker_threads = static_cast<size_t>(m_config.getInt("backtest.replay_threads", 4));
+    m_replay_config.order_latency_ns = static_cast<uint64_t>(m_config.getInt("backtest.order_latency_us", 50)) * 1000;
+    m_replay_config.ack_latency_ns = static_cast<uint64_t>(m_config.getInt("backtest.ack_latency_us", 50)) * 1000;
+    m_replay_config.commission_rate = m_commission_rate;
+    {
+        std::lock_guard<std::mutex> lock(m_replay_mutex);
+        m_replay = std::make_shared<ReplayEngine>(m_replay_config);
+    }
     
     return true;
 }
@@ -118,17 +128,79 @@ void BacktestEngine::run() {
     m_running = false;
 }
 
+std::shared_ptr<ReplayEngine> BacktestEngine::currentReplay() {
+    std::lock_guard<std::mutex> lock(m_replay_mutex);
+    return m_replay;
+}
+
+std::shared_ptr<ReplayEngine> BacktestEngine::ensureReplay() {
+    std::lock_guard<std::mutex> lock(m_replay_mutex);
+    if (!m_replay) {
+        m_replay = std::make_shared<ReplayEngine>(m_replay_config);
+    }
+    return m_replay;
+}
+
+bool BacktestEngine::addReplayData(const std::string& data_path) {
+    return ensureReplay()->addCsvSource(data_path);
+}
+
+void BacktestEngine::addReplayData(const std::string& symbol, std::unique_ptr<persistence::TickQuery> query) {
+    ensureReplay()->addTickQuery(symbol, std::move(query));
+}
+
+ReplayResult BacktestEngine::runReplay(const ReplayStrategyFactory& factory) {
+    // 持有副本运行，其他线程的stop()/pause()始终作用于存活的引擎
+    std::shared_ptr<ReplayEngine> replay = currentReplay();
+    if (!replay) {
+        std::cerr << "No replay data added" << std::endl;
+        return ReplayResult();
+    }
+
+    m_running = true;
+    m_paused = false;
+    m_performance_metrics.reset();
+
+    std::cout << "Starting replay with initial capital: " << m_initial_capital << std::endl;
+    ReplayResult result = replay->run(factory);
+
+    m_current_capital = m_initial_capital + result.pnl;
+    updatePerformanceMetrics();
+
+    std::cout << "Replay completed: " << result.events << " events in " << result.elapsed_seconds << " s" << std::endl;
+    std::cout << "Final capital: " << m_current_capital << std::endl;
+
+    // 数据源已读完，下次回放需重新添加；期间若已添加了新的引擎则保留
+    {
+        std::lock_guard<std::mutex> lock(m_replay_mutex);
+        if (m_replay == replay) {
+            m_replay.reset();
+        }
+    }
+    m_running = false;
+    return result;
+}
+
 void BacktestEngine::pause() {
     m_paused = true;
+    if (auto replay = currentReplay()) {
+        replay->pause();
+    }
 }
 
 void BacktestEngine::resume() {
     m_paused = false;
+    if (auto replay = currentReplay()) {
+        replay->resume();
+    }
 }
 
 void BacktestEngine::stop() {
     m_running = false;
     m_paused = false;
+    if (auto replay = currentReplay()) {
+        replay->stop();
+    }
 }
 
 PerformanceMetrics BacktestEngine::getResults() const {
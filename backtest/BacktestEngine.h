@@ -3,11 +3,13 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 #include "core/Configuration.h"
 #include "market/MarketData.h"
 #include "strategy/Strategy.h"
 #include "execution/Order.h"
 #include "utils/PerformanceMetrics.h"
+#include "ReplayEngine.h"
 
 namespace hft {
 namespace backtest {
@@ -28,7 +30,16 @@ public:
     
     // 运行回测
     void run();
+
+    // 添加回放数据（mmap流式读取，不整体载入内存）
+    bool addReplayData(const std::string& data_path);
+    void addReplayData(const std::string& symbol, std::unique_ptr<persistence::TickQuery> query);
+
+    // 事件驱动回放：多数据源按时间归并，按标的分片到工作线程，
+    // 成交由重建的订单簿按延迟与排队位置撮合
+    ReplayResult runReplay(const ReplayStrategyFactory& factory);
     
+    // 暂停/恢复/停止可在其他线程调用；回放引擎在runReplay返回前保持存活
     // 暂停回测
     void pause();
     
@@ -54,6 +65,16 @@ private:
     double m_initial_capital;
     double m_current_capital;
     double m_commission_rate;
+    ReplayConfig m_replay_config;
+    // m_replay的替换与读取受m_replay_mutex保护；调用方持有shared_ptr副本后在锁外使用，
+    // 回放线程清空m_replay不会让正在调用stop()/pause()的线程访问已释放的对象
+    std::mutex m_replay_mutex;
+    std::shared_ptr<ReplayEngine> m_replay;
+
+    // 取当前回放引擎（可能为空）
+    std::shared_ptr<ReplayEngine> currentReplay();
+    // 取当前回放引擎，不存在时创建
+    std::shared_ptr<ReplayEngine> ensureReplay();
 
     // 处理市场数据
     void processMarketData(const market::MarketData& data);
@@ -0,0 +1,562 @@
+#include "ReplayEngine.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <queue>
+
+namespace hft {
+namespace backtest {
+
+namespace {
+
+constexpr double kFixedPointScale = 10000.0;   // 与types::Price/Volume一致
+constexpr uint32_t kEndOfStream = UINT32_MAX;
+constexpr size_t kWorkerBatchSize = 256;
+
+inline double toDouble(int64_t fixed) {
+    return static_cast<double>(fixed) / kFixedPointScale;
+}
+
+inline double notional(types::Price price, types::Volume quantity) {
+    return toDouble(price) * toDouble(quantity);
+}
+
+// 解析一个逗号分隔字段
+inline bool nextField(const char*& p, const char* end, std::string_view& field) {
+    if (p > end) {
+        return false;
+    }
+    const char* comma = static_cast<const char*>(std::memchr(p, ',', static_cast<size_t>(end - p)));
+    const char* stop = comma ? comma : end;
+    field = std::string_view(p, static_cast<size_t>(stop - p));
+    p = stop + 1;
+    return true;
+}
+
+inline bool parseFixed(std::string_view field, int64_t& out) {
+    double value = 0.0;
+    const auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    out = static_cast<int64_t>(std::llround(value * kFixedPointScale));
+    return true;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// SimulatedExchange
+
+SimulatedExchange::SimulatedExchange(const ReplayConfig& config)
+    : m_config(config), m_book(config.tick_size), m_nextOrderId(1) {
+}
+
+uint64_t SimulatedExchange::submit(uint64_t now, types::Side side, types::Price price, types::Volume quantity) {
+    if (quantity <= 0) {
+        return 0;
+    }
+    SimulatedOrder order{};
+    order.id = m_nextOrderId++;
+    order.side = side;
+    order.price = price;
+    order.quantity = quantity;
+    order.active_at = now + m_config.order_latency_ns;
+    m_orders.push_back(order);
+    return order.id;
+}
+
+bool SimulatedExchange::cancel(uint64_t now, uint64_t order_id) {
+    for (auto& order : m_orders) {
+        if (order.id == order_id && order.cancel_at == 0) {
+            order.cancel_at = now + m_config.order_latency_ns;
+            return true;
+        }
+    }
+    return false;
+}
+
+void SimulatedExchange::fill(SimulatedOrder& order, uint64_t now, types::Price price, types::Volume quantity,
+                             bool passive, std::vector<SimulatedFill>& fills) {
+    quantity = std::min(quantity, order.quantity - order.filled);
+    if (quantity <= 0) {
+        return;
+    }
+    order.filled += quantity;
+    fills.push_back(SimulatedFill{order.id, now, order.side, price, quantity, passive});
+}
+
+void SimulatedExchange::takeLiquidity(SimulatedOrder& order, uint64_t now, std::vector<SimulatedFill>& fills) {
+    // 吃对手方最优档；市价单剩余部分在后续行情中继续成交
+    const bool buy = order.side == types::Side::BUY;
+    const types::Price touch = buy ? m_book.bestAsk() : m_book.bestBid();
+    if (touch == 0) {
+        return;
+    }
+    const bool marketable = order.price == 0 || (buy ? order.price >= touch : order.price <= touch);
+    if (!marketable) {
+        return;
+    }
+    const types::Volume available = buy ? m_book.bestAskVolume() : m_book.bestBidVolume();
+    const types::Volume before = order.filled;
+    fill(order, now, touch, available, false, fills);
+    // 被吃掉的量从重建盘口中扣除，避免同一档被重复成交
+    m_book.updateLevel(buy ? types::Side::SELL : types::Side::BUY, touch, available - (order.filled - before));
+}
+
+void SimulatedExchange::activate(SimulatedOrder& order, uint64_t now, std::vector<SimulatedFill>& fills) {
+    order.active = true;
+    takeLiquidity(order, now, fills);
+    if (order.price != 0 && order.filled < order.quantity) {
+        // 剩余部分挂单，排在同价位已有挂单之后
+        order.queue_ahead = m_book.volumeAt(order.side, order.price);
+    }
+}
+
+void SimulatedExchange::updateBook(const persistence::Tick& tick) {
+    // 只知道买一/卖一：删除比新盘口更优的残留档位，再写入新盘口
+    if (tick.bid_price > 0) {
+        while (m_book.bestBid() > tick.bid_price) {
+            m_book.deleteLevel(types::Side::BUY, m_book.bestBid());
+        }
+        m_book.updateLevel(types::Side::BUY, tick.bid_price, tick.bid_volume);
+    }
+    if (tick.ask_price > 0) {
+        while (m_book.bestAsk() != 0 && m_book.bestAsk() < tick.ask_price) {
+            m_book.deleteLevel(types::Side::SELL, m_book.bestAsk());
+        }
+        m_book.updateLevel(types::Side::SELL, tick.ask_price, tick.ask_volume);
+    }
+}
+
+void SimulatedExchange::onTick(const persistence::Tick& tick, std::vector<SimulatedFill>& fills) {
+    const uint64_t now = tick.timestamp;
+
+    // 1. 到达交易所的新订单与撤单（按当前盘口处理）
+    for (auto& order : m_orders) {
+        if (order.cancel_at != 0 && order.cancel_at <= now) {
+            order.quantity = order.filled;
+            continue;
+        }
+        if (!order.active && order.active_at <= now) {
+            activate(order, now, fills);
+        } else if (order.active && order.price == 0) {
+            takeLiquidity(order, now, fills);
+        }
+    }
+
+    // 2. 成交打到挂单价位：tick.volume为本tick的成交预算，按价格、时间优先分配。
+    //    成交价位上先消耗前方队列（行情挂单只扣一次），穿价的挂单前方队列已被扫光
+    if (tick.volume > 0 && tick.last_price > 0) {
+        types::Volume budget = tick.volume;
+        types::Volume queueConsumed = 0;    // 成交价位上已被消耗的行情挂单量
+        rankRestingOrders();
+        for (size_t index : m_ranked) {
+            SimulatedOrder& order = m_orders[index];
+            const bool buy = order.side == types::Side::BUY;
+            const bool through = buy ? tick.last_price < order.price : tick.last_price > order.price;
+            if (through) {
+                order.queue_ahead = 0;
+            } else if (tick.last_price == order.price) {
+                // 前方队列中尚未被更早的本方订单计入的部分
+                if (order.queue_ahead > queueConsumed) {
+                    const types::Volume consumed = std::min(budget, order.queue_ahead - queueConsumed);
+                    budget -= consumed;
+                    queueConsumed += consumed;
+                }
+                order.queue_ahead -= std::min(order.queue_ahead, queueConsumed);
+                if (order.queue_ahead > 0) {
+                    continue;
+                }
+            } else {
+                continue;
+            }
+            if (budget > 0) {
+                const types::Volume before = order.filled;
+                fill(order, now, order.price, budget, true, fills);
+                budget -= order.filled - before;
+            }
+        }
+    }
+
+    // 3. 更新盘口；同价位挂单减少视为前方撤单。对手价穿过挂单价时按对手最优档的量成交，
+    //    成交量从重建盘口中扣除，同一档不会被多笔挂单重复成交
+    updateBook(tick);
+    rankRestingOrders();
+    for (size_t index : m_ranked) {
+        SimulatedOrder& order = m_orders[index];
+        const bool buy = order.side == types::Side::BUY;
+        order.queue_ahead = std::min(order.queue_ahead, m_book.volumeAt(order.side, order.price));
+        const types::Side oppositeSide = buy ? types::Side::SELL : types::Side::BUY;
+        const types::Price opposite = buy ? m_book.bestAsk() : m_book.bestBid();
+        if (opposite != 0 && (buy ? opposite <= order.price : opposite >= order.price)) {
+            const types::Volume available = m_book.volumeAt(oppositeSide, opposite);
+            const types::Volume before = order.filled;
+            fill(order, now, order.price, available, true, fills);
+            m_book.updateLevel(oppositeSide, opposite, available - (order.filled - before));
+        }
+    }
+
+    compact();
+}
+
+void SimulatedExchange::rankRestingOrders() {
+    // 买单价高者优先、卖单价低者优先，同价位按下单顺序（m_orders按订单号递增）
+    m_ranked.clear();
+    for (size_t i = 0; i < m_orders.size(); ++i) {
+        const SimulatedOrder& order = m_orders[i];
+        if (order.active && order.price != 0 && order.filled < order.quantity) {
+            m_ranked.push_back(i);
+        }
+    }
+    std::stable_sort(m_ranked.begin(), m_ranked.end(), [this](size_t a, size_t b) {
+        const SimulatedOrder& x = m_orders[a];
+        const SimulatedOrder& y = m_orders[b];
+        if (x.side != y.side) {
+            return x.side == types::Side::BUY;
+        }
+        return x.side == types::Side::BUY ? x.price > y.price : x.price < y.price;
+    });
+}
+
+void SimulatedExchange::compact() {
+    m_orders.erase(std::remove_if(m_orders.begin(), m_orders.end(), [](const SimulatedOrder& order) {
+        return order.filled >= order.quantity;
+    }), m_orders.end());
+}
+
+// ---------------------------------------------------------------------------
+// ReplayContext
+
+ReplayContext::ReplayContext(const std::string& symbol, const ReplayConfig& config)
+    : m_symbol(symbol), m_config(config), m_exchange(config), m_now(0) {
+    m_result.symbol = symbol;
+}
+
+uint64_t ReplayContext::submitOrder(types::Side side, types::Price price, types::Volume quantity) {
+    const uint64_t id = m_exchange.submit(m_now, side, price, quantity);
+    if (id != 0) {
+        ++m_result.orders;
+    }
+    return id;
+}
+
+bool ReplayContext::cancelOrder(uint64_t order_id) {
+    return m_exchange.cancel(m_now, order_id);
+}
+
+void ReplayContext::applyFill(const SimulatedFill& fill) {
+    const double value = notional(fill.price, fill.quantity);
+    const double commission = value * m_config.commission_rate;
+    if (fill.side == types::Side::BUY) {
+        m_result.position += fill.quantity;
+        m_result.cash -= value;
+    } else {
+        m_result.position -= fill.quantity;
+        m_result.cash += value;
+    }
+    m_result.cash -= commission;
+    m_result.commission += commission;
+    m_result.traded_volume += fill.quantity;
+    ++m_result.fills;
+}
+
+void ReplayContext::deliverFills(ReplayStrategy& strategy, uint64_t until) {
+    // 按送达时间顺序回报给策略
+    size_t delivered = 0;
+    while (delivered < m_pendingFills.size() && m_pendingFills[delivered].first <= until) {
+        strategy.onFill(*this, m_pendingFills[delivered].second);
+        ++delivered;
+    }
+    m_pendingFills.erase(m_pendingFills.begin(), m_pendingFills.begin() + static_cast<std::ptrdiff_t>(delivered));
+}
+
+void ReplayContext::process(const persistence::Tick& tick, ReplayStrategy& strategy) {
+    m_now = tick.timestamp;
+    ++m_result.events;
+
+    m_newFills.clear();
+    m_exchange.onTick(tick, m_newFills);
+    for (const auto& fill : m_newFills) {
+        // 持仓按撮合时刻记账，回报延迟只影响策略何时看到成交
+        applyFill(fill);
+        m_pendingFills.emplace_back(fill.timestamp + m_config.ack_latency_ns, fill);
+    }
+
+    deliverFills(strategy, m_now);
+    strategy.onTick(*this, tick);
+
+    const double mid = m_exchange.book().midPrice();
+    if (mid > 0.0) {
+        m_result.last_mid = mid / kFixedPointScale;
+    }
+}
+
+void ReplayContext::finish() {
+    m_result.pnl = m_result.cash + toDouble(m_result.position) * m_result.last_mid;
+}
+
+// ---------------------------------------------------------------------------
+// CsvReplaySource
+
+CsvReplaySource::CsvReplaySource(uint32_t source, SymbolResolver resolver)
+    : m_source(source), m_resolver(std::move(resolver)), m_pos(nullptr), m_end(nullptr),
+      m_lastSymbolIndex(0) {
+}
+
+bool CsvReplaySource::open(const std::string& path) {
+    if (!m_file.open(path)) {
+        std::cerr << "Failed to open historical data file: " << path << std::endl;
+        return false;
+    }
+    m_pos = reinterpret_cast<const char*>(m_file.data());
+    m_end = m_pos + m_file.size();
+
+    // 跳过表头
+    const char* eol = m_pos ? static_cast<const char*>(std::memchr(m_pos, '\n', m_file.size())) : nullptr;
+    m_pos = eol ? eol + 1 : m_end;
+    return true;
+}
+
+bool CsvReplaySource::parseLine(const char* begin, const char* end, ReplayEvent& event) {
+    if (end > begin && end[-1] == '\r') {
+        --end;
+    }
+    std::string_view field;
+    const char* p = begin;
+    int64_t open = 0, high = 0, low = 0;
+
+    if (!nextField(p, end, field)) {
+        return false;
+    }
+    uint64_t timestamp = 0;
+    if (std::from_chars(field.data(), field.data() + field.size(), timestamp).ec != std::errc()) {
+        return false;
+    }
+
+    if (!nextField(p, end, field) || field.empty()) {
+        return false;
+    }
+    if (field != m_lastSymbol) {
+        m_lastSymbolIndex = m_resolver(field);
+        m_lastSymbol = field;
+    }
+
+    persistence::Tick& tick = event.tick;
+    tick = persistence::Tick{};
+    tick.timestamp = timestamp;
+    if (!nextField(p, end, field) || !parseFixed(field, open) ||
+        !nextField(p, end, field) || !parseFixed(field, high) ||
+        !nextField(p, end, field) || !parseFixed(field, low) ||
+        !nextField(p, end, field) || !parseFixed(field, tick.last_price) ||
+        !nextField(p, end, field) || !parseFixed(field, tick.volume)) {
+        return false;
+    }
+    // 可选的盘口列
+    if (nextField(p, end, field) && parseFixed(field, tick.bid_price) &&
+        nextField(p, end, field) && parseFixed(field, tick.ask_price)) {
+        if (nextField(p, end, field)) {
+            parseFixed(field, tick.bid_volume);
+        }
+        if (nextField(p, end, field)) {
+            parseFixed(field, tick.ask_volume);
+        }
+    }
+
+    event.symbol = m_lastSymbolIndex;
+    event.source = m_source;
+    return true;
+}
+
+bool CsvReplaySource::next(ReplayEvent& event) {
+    while (m_pos < m_end) {
+        const char* eol = static_cast<const char*>(std::memchr(m_pos, '\n', static_cast<size_t>(m_end - m_pos)));
+        const char* lineEnd = eol ? eol : m_end;
+        const char* lineBegin = m_pos;
+        m_pos = eol ? eol + 1 : m_end;
+        if (lineEnd > lineBegin && parseLine(lineBegin, lineEnd, event)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// TickStoreReplaySource
+
+TickStoreReplaySource::TickStoreReplaySource(uint32_t source, uint32_t symbol,
+                                             std::unique_ptr<persistence::TickQuery> query)
+    : m_source(source), m_symbol(symbol), m_query(std::move(query)) {
+}
+
+bool TickStoreReplaySource::next(ReplayEvent& event) {
+    if (!m_query || !m_query->next(event.tick)) {
+        return false;
+    }
+    event.symbol = m_symbol;
+    event.source = m_source;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// ReplayEngine
+
+struct ReplayEngine::Worker {
+    explicit Worker(size_t capacity) : queue(capacity) {}
+
+    utils::SPSCRingBuffer<ReplayEvent, utils::YieldWait> queue;
+    std::thread thread;
+    std::vector<SymbolReplayResult> results;
+};
+
+ReplayEngine::ReplayEngine(const ReplayConfig& config)
+    : m_config(config), m_running(false), m_paused(false) {
+    if (m_config.worker_threads == 0) {
+        m_config.worker_threads = 1;
+    }
+}
+
+ReplayEngine::~ReplayEngine() {
+    stop();
+}
+
+uint32_t ReplayEngine::symbolIndex(std::string_view symbol) {
+    auto it = m_symbolIndex.find(std::string(symbol));
+    if (it != m_symbolIndex.end()) {
+        return it->second;
+    }
+    const uint32_t index = static_cast<uint32_t>(m_symbols.size());
+    m_symbols.emplace_back(symbol);
+    m_symbolIndex.emplace(m_symbols.back(), index);
+    return index;
+}
+
+bool ReplayEngine::addCsvSource(const std::string& path) {
+    auto source = std::make_unique<CsvReplaySource>(
+        static_cast<uint32_t>(m_sources.size()),
+        [this](std::string_view symbol) { return symbolIndex(symbol); });
+    if (!source->open(path)) {
+        return false;
+    }
+    m_sources.push_back(std::move(source));
+    return true;
+}
+
+void ReplayEngine::addTickQuery(const std::string& symbol, std::unique_ptr<persistence::TickQuery> query) {
+    m_sources.push_back(std::make_unique<TickStoreReplaySource>(
+        static_cast<uint32_t>(m_sources.size()), symbolIndex(symbol), std::move(query)));
+}
+
+void ReplayEngine::addSource(std::unique_ptr<ReplaySource> source) {
+    m_sources.push_back(std::move(source));
+}
+
+void ReplayEngine::workerLoop(Worker& worker, const ReplayStrategyFactory& factory) {
+    // 本线程负责的标的：symbol % worker_threads == 本线程序号，按需创建
+    std::unordered_map<uint32_t, std::pair<std::unique_ptr<ReplayContext>, std::unique_ptr<ReplayStrategy>>> states;
+    ReplayEvent batch[kWorkerBatchSize];
+    bool done = false;
+
+    while (!done) {
+        const size_t n = worker.queue.pop_n(batch, kWorkerBatchSize);
+        if (n == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const ReplayEvent& event = batch[i];
+            if (event.symbol == kEndOfStream) {
+                done = true;
+                break;
+            }
+            auto& state = states[event.symbol];
+            if (!state.first) {
+                // 归并线程可能仍在注册新标的，这里只通过事件携带的名称指针访问
+                state.first = std::make_unique<ReplayContext>(*event.name, m_config);
+                state.second = factory(*event.name);
+            }
+            if (state.second) {
+                state.first->process(event.tick, *state.second);
+            }
+        }
+    }
+
+    for (auto& entry : states) {
+        entry.second.first->finish();
+        worker.results.push_back(entry.second.first->m_result);
+    }
+}
+
+ReplayResult ReplayEngine::run(const ReplayStrategyFactory& factory) {
+    ReplayResult result;
+    const auto startTime = std::chrono::steady_clock::now();
+    m_running = true;
+    m_paused = false;
+
+    // k路归并：堆中保存各数据源的当前首条事件，按(时间戳, 数据源序号)出堆
+    std::vector<ReplayEvent> heads(m_sources.size());
+    auto later = [&heads](size_t a, size_t b) {
+        if (heads[a].tick.timestamp != heads[b].tick.timestamp) {
+            return heads[a].tick.timestamp > heads[b].tick.timestamp;
+        }
+        return a > b;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+    for (size_t i = 0; i < m_sources.size(); ++i) {
+        if (m_sources[i]->next(heads[i])) {
+            heap.push(i);
+        }
+    }
+
+    // 启动工作线程
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (size_t i = 0; i < m_config.worker_threads; ++i) {
+        workers.push_back(std::make_unique<Worker>(m_config.queue_capacity));
+    }
+    for (auto& worker : workers) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w, &factory]() { workerLoop(*w, factory); });
+    }
+
+    while (!heap.empty() && m_running.load(std::memory_order_relaxed)) {
+        while (m_paused.load(std::memory_order_relaxed) && m_running.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        const size_t source = heap.top();
+        heap.pop();
+        ReplayEvent& event = heads[source];
+        event.name = &m_symbols[event.symbol];
+        workers[event.symbol % workers.size()]->queue.push(event);
+        ++result.events;
+        if (m_sources[source]->next(heads[source])) {
+            heap.push(source);
+        }
+    }
+
+    // 结束标记，等待工作线程处理完队列
+    ReplayEvent endOfStream{};
+    endOfStream.symbol = kEndOfStream;
+    for (auto& worker : workers) {
+        worker->queue.push(endOfStream);
+    }
+    for (auto& worker : workers) {
+        worker->thread.join();
+        for (auto& symbol : worker->results) {
+            result.pnl += symbol.pnl;
+            result.commission += symbol.commission;
+            result.symbols.push_back(std::move(symbol));
+        }
+    }
+    std::sort(result.symbols.begin(), result.symbols.end(),
+              [](const SymbolReplayResult& a, const SymbolReplayResult& b) { return a.symbol < b.symbol; });
+
+    m_running = false;
+    result.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+} // namespace backtest
+} // namespace hft
@@ -0,0 +1,251 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "core/Types.h"
+#include "market/PriceLevelBook.h"
+#include "persistence/TickStore.h"
+#include "utils/RingBuffer.h"
+
+namespace hft {
+namespace backtest {
+
+// 事件驱动回放引擎
+//
+//  数据源（mmap流式读取）──k路归并──按标的分片──> 工作线程 ──> 模拟撮合 + 策略
+//
+//  - 每个数据源内部按时间有序，归并时按(时间戳, 数据源序号)排序，结果确定
+//  - 标的固定分配到某个工作线程，同一标的的事件严格按归并顺序处理，
+//    因此每个标的的成交与盈亏与线程数无关、可复现
+//  - 成交由根据行情重建的订单簿产生：考虑下单/回报延迟与排队位置，
+//    而不是按最新价直接成交
+
+// 回放事件
+struct ReplayEvent {
+    uint32_t symbol;              // 本次回放内的标的序号
+    uint32_t source;              // 数据源序号（归并时打破时间戳相同的平局）
+    const std::string* name;      // 标的名称（由引擎在分发时填写）
+    persistence::Tick tick;
+};
+
+// 数据源接口
+class ReplaySource {
+public:
+    virtual ~ReplaySource() = default;
+    // 取下一条事件，数据结束时返回false
+    virtual bool next(ReplayEvent& event) = 0;
+};
+
+// 模拟成交
+struct SimulatedFill {
+    uint64_t order_id;
+    uint64_t timestamp;           // 撮合时间
+    types::Side side;
+    types::Price price;
+    types::Volume quantity;
+    bool passive;                 // 是否为挂单被动成交
+};
+
+// 模拟订单状态
+struct SimulatedOrder {
+    uint64_t id;
+    types::Side side;
+    types::Price price;           // 0表示市价单
+    types::Volume quantity;
+    types::Volume filled;
+    types::Volume queue_ahead;    // 排在本单之前的挂单量
+    uint64_t active_at;           // 到达交易所的时间
+    uint64_t cancel_at;           // 撤单到达时间，0表示未撤
+    bool active;
+};
+
+// 回放配置
+struct ReplayConfig {
+    size_t worker_threads = 4;
+    size_t queue_capacity = 1 << 16;         // 每个工作线程的事件队列
+    uint64_t order_latency_ns = 50000;       // 下单/撤单到达交易所的延迟
+    uint64_t ack_latency_ns = 50000;         // 成交回报到达策略的延迟
+    double commission_rate = 0.0;
+    types::Price tick_size = 100;
+};
+
+// 单标的模拟交易所
+// 盘口由逐笔中的买一/卖一重建；限价单到达时排在同价位已有挂单之后。
+// 每条行情的成交量是本tick唯一的成交预算：挂单按价格优先、时间优先依次分配，
+// 同价位先消耗前方队列，价格穿越时前方队列视为已清空，成交量都不超过剩余预算。
+class SimulatedExchange {
+public:
+    SimulatedExchange(const ReplayConfig& config);
+
+    uint64_t submit(uint64_t now, types::Side side, types::Price price, types::Volume quantity);
+    bool cancel(uint64_t now, uint64_t order_id);
+
+    // 处理一条行情，产生的成交追加到fills
+    void onTick(const persistence::Tick& tick, std::vector<SimulatedFill>& fills);
+
+    const market::PriceLevelBook& book() const { return m_book; }
+    const std::vector<SimulatedOrder>& orders() const { return m_orders; }
+
+private:
+    void activate(SimulatedOrder& order, uint64_t now, std::vector<SimulatedFill>& fills);
+    void takeLiquidity(SimulatedOrder& order, uint64_t now, std::vector<SimulatedFill>& fills);
+    void fill(SimulatedOrder& order, uint64_t now, types::Price price, types::Volume quantity,
+              bool passive, std::vector<SimulatedFill>& fills);
+    void updateBook(const persistence::Tick& tick);
+    void rankRestingOrders();
+    void compact();
+
+    const ReplayConfig& m_config;
+    market::PriceLevelBook m_book;
+    std::vector<SimulatedOrder> m_orders;
+    std::vector<size_t> m_ranked;            // 按价格、时间优先排序的挂单下标（复用，避免每tick分配）
+    uint64_t m_nextOrderId;
+};
+
+class ReplayContext;
+
+// 回放策略接口（每个标的一个实例，只在所属工作线程上调用）
+class ReplayStrategy {
+public:
+    virtual ~ReplayStrategy() = default;
+    virtual void onTick(ReplayContext& context, const persistence::Tick& tick) = 0;
+    virtual void onFill(ReplayContext& context, const SimulatedFill& fill) { (void)context; (void)fill; }
+};
+
+using ReplayStrategyFactory = std::function<std::unique_ptr<ReplayStrategy>(const std::string& symbol)>;
+
+// 单标的回放结果
+struct SymbolReplayResult {
+    std::string symbol;
+    uint64_t events = 0;
+    uint64_t orders = 0;
+    uint64_t fills = 0;
+    types::Volume position = 0;
+    types::Volume traded_volume = 0;
+    double cash = 0.0;
+    double commission = 0.0;
+    double last_mid = 0.0;
+    double pnl = 0.0;             // 按最后中间价盯市
+};
+
+struct ReplayResult {
+    std::vector<SymbolReplayResult> symbols;
+    uint64_t events = 0;
+    double pnl = 0.0;
+    double commission = 0.0;
+    double elapsed_seconds = 0.0;
+};
+
+// 策略看到的交易接口
+class ReplayContext {
+public:
+    ReplayContext(const std::string& symbol, const ReplayConfig& config);
+
+    const std::string& symbol() const { return m_symbol; }
+    uint64_t now() const { return m_now; }
+    const market::PriceLevelBook& book() const { return m_exchange.book(); }
+    types::Volume position() const { return m_result.position; }
+
+    // 下单，price为0表示市价；返回订单ID
+    uint64_t submitOrder(types::Side side, types::Price price, types::Volume quantity);
+    bool cancelOrder(uint64_t order_id);
+
+private:
+    friend class ReplayEngine;
+
+    void process(const persistence::Tick& tick, ReplayStrategy& strategy);
+    void deliverFills(ReplayStrategy& strategy, uint64_t until);
+    void applyFill(const SimulatedFill& fill);
+    void finish();
+
+    std::string m_symbol;
+    const ReplayConfig& m_config;
+    SimulatedExchange m_exchange;
+    uint64_t m_now;
+    std::vector<SimulatedFill> m_newFills;
+    std::vector<std::pair<uint64_t, SimulatedFill>> m_pendingFills;   // (送达时间, 成交)
+    SymbolReplayResult m_result;
+};
+
+// mmap的CSV数据源
+// 格式：timestamp,symbol,open,high,low,close,volume[,bid,ask,bid_volume,ask_volume]
+// 首行为表头；价格与数量为浮点，读入时转换为放大10000倍的定点数
+class CsvReplaySource : public ReplaySource {
+public:
+    using SymbolResolver = std::function<uint32_t(std::string_view)>;
+
+    CsvReplaySource(uint32_t source, SymbolResolver resolver);
+    bool open(const std::string& path);
+    bool next(ReplayEvent& event) override;
+
+private:
+    bool parseLine(const char* begin, const char* end, ReplayEvent& event);
+
+    uint32_t m_source;
+    SymbolResolver m_resolver;
+    utils::MappedFile m_file;
+    const char* m_pos;
+    const char* m_end;
+    std::string_view m_lastSymbol;
+    uint32_t m_lastSymbolIndex;
+};
+
+// 逐笔存储数据源
+class TickStoreReplaySource : public ReplaySource {
+public:
+    TickStoreReplaySource(uint32_t source, uint32_t symbol, std::unique_ptr<persistence::TickQuery> query);
+    bool next(ReplayEvent& event) override;
+
+private:
+    uint32_t m_source;
+    uint32_t m_symbol;
+    std::unique_ptr<persistence::TickQuery> m_query;
+};
+
+// 回放引擎
+class ReplayEngine {
+public:
+    explicit ReplayEngine(const ReplayConfig& config = ReplayConfig());
+    ~ReplayEngine();
+
+    ReplayEngine(const ReplayEngine&) = delete;
+    ReplayEngine& operator=(const ReplayEngine&) = delete;
+
+    // 添加数据源（运行前调用）
+    bool addCsvSource(const std::string& path);
+    void addTickQuery(const std::string& symbol, std::unique_ptr<persistence::TickQuery> query);
+    void addSource(std::unique_ptr<ReplaySource> source);
+
+    // 标的名称与回放内序号互转
+    uint32_t symbolIndex(std::string_view symbol);
+    const std::string& symbolName(uint32_t index) const { return m_symbols[index]; }
+
+    // 运行回放直至数据结束或stop()；在调用线程上执行归并
+    ReplayResult run(const ReplayStrategyFactory& factory);
+
+    void pause() { m_paused = true; }
+    void resume() { m_paused = false; }
+    void stop() { m_running = false; m_paused = false; }
+
+private:
+    struct Worker;
+
+    void workerLoop(Worker& worker, const ReplayStrategyFactory& factory);
+
+    ReplayConfig m_config;
+    std::vector<std::unique_ptr<ReplaySource>> m_sources;
+    std::deque<std::string> m_symbols;           // 只追加，元素地址稳定
+    std::unordered_map<std::string, uint32_t> m_symbolIndex;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_paused;
+};
+
+} // namespace backtest
+} // namespace hft
@@ -13,6 +13,7 @@
 namespace hft {
 namespace core {
 
+// 通用事件循环（条件变量唤醒）；交易线程请使用LowLatencyEventLoop
 class EventLoop {
 public:
     using EventCallback = std::function<void()>;
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace hft {
+namespace core {
+
+template<typename Signature, size_t Capacity = 64>
+class InplaceFunction;
+
+// 小缓冲区可调用对象：闭包直接存放在对象内部，从不分配堆内存
+// 闭包超过Capacity时编译失败；仅支持移动
+template<typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+    InplaceFunction() = default;
+
+    template<typename F,
+             typename = typename std::enable_if<
+                 !std::is_same<typename std::decay<F>::type, InplaceFunction>::value>::type>
+    InplaceFunction(F&& f) {
+        using Fn = typename std::decay<F>::type;
+        static_assert(sizeof(Fn) <= Capacity, "callable too large for InplaceFunction buffer");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "callable over-aligned");
+        static_assert(std::is_nothrow_move_constructible<Fn>::value,
+                      "callable must be nothrow move constructible");
+
+        new (&storage_) Fn(std::forward<F>(f));
+        invoke_ = [](void* obj, Args&&... args) -> R {
+            return (*static_cast<Fn*>(obj))(std::forward<Args>(args)...);
+        };
+        manage_ = [](void* dst, void* src) noexcept {
+            if (dst) {
+                new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            }
+            static_cast<Fn*>(src)->~Fn();
+        };
+    }
+
+    InplaceFunction(InplaceFunction&& other) noexcept {
+        moveFrom(other);
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction(const InplaceFunction&) = delete;
+    InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+    ~InplaceFunction() {
+        reset();
+    }
+
+    R operator()(Args... args) {
+        return invoke_(&storage_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return invoke_ != nullptr; }
+
+    void reset() {
+        if (manage_) {
+            manage_(nullptr, &storage_);
+            invoke_ = nullptr;
+            manage_ = nullptr;
+        }
+    }
+
+private:
+    using Invoker = R (*)(void*, Args&&...);
+    using Manager = void (*)(void*, void*) noexcept;
+
+    void moveFrom(InplaceFunction& other) noexcept {
+        if (other.manage_) {
+            // 移动闭包到本对象，同时析构源对象中的闭包
+            other.manage_(&storage_, &other.storage_);
+            invoke_ = other.invoke_;
+            manage_ = other.manage_;
+            other.invoke_ = nullptr;
+            other.manage_ = nullptr;
+        }
+    }
+
+    typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type storage_;
+    Invoker invoke_ = nullptr;
+    Manager manage_ = nullptr;
+};
+
+} // namespace core
+} // namespace hft
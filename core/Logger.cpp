@@ -1,44 +1,114 @@
 #include "Logger.h"
-#include <iomanip>
+#include "../utils/LowLatencyLogger.h"
 
 namespace hft {
 namespace core {
 
+namespace {
+
+constexpr size_t kBackendRingBytes = 256 << 10;   // 每个生产线程的环大小
+
+// 未单独设置级别的模块使用的默认级别（受Logger::m_mutex保护）
+LogLevel g_defaultLevel = LogLevel::INFO;
+
+::LogLevel toBackendLevel(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return ::LogLevel::DEBUG;
+        case LogLevel::INFO: return ::LogLevel::INFO;
+        case LogLevel::WARNING: return ::LogLevel::WARNING;
+        case LogLevel::ERROR: return ::LogLevel::ERROR;
+        case LogLevel::FATAL: return ::LogLevel::CRITICAL;
+        default: return ::LogLevel::INFO;
+    }
+}
+
+} // namespace
+
 // 静态成员初始化
-LogLevel Logger::m_logLevel = LogLevel::INFO;
-std::ofstream Logger::m_logFile;
-bool Logger::m_consoleOutput = true;
 std::mutex Logger::m_mutex;
 
-Logger::Logger(const std::string& moduleName) : m_moduleName(moduleName) {
+LowLatencyLogger& Logger::backend() {
+    // 级别过滤在模块侧完成，后端接收所有级别；默认只输出到控制台
+    static LowLatencyLogger instance("", ::LogLevel::DEBUG, LogOutputMode::TEXT, kBackendRingBytes);
+    static const bool configured = [] {
+        instance.setConsoleOutput(true);
+        return true;
+    }();
+    (void)configured;
+    return instance;
 }
 
-Logger::~Logger() {
-    if (m_logFile.is_open()) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_logFile.flush();
+std::map<std::string, std::unique_ptr<Logger::ModuleState>>& Logger::modules() {
+    static std::map<std::string, std::unique_ptr<ModuleState>> registry;
+    return registry;
+}
+
+Logger::ModuleState* Logger::registerModule(const std::string& moduleName) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& state = modules()[moduleName];
+    if (!state) {
+        state = std::make_unique<ModuleState>();
+        state->name = moduleName;
+        state->format = "[" + moduleName + "]: {}";
+        state->level.store(g_defaultLevel, std::memory_order_relaxed);
+        state->overridden = false;
+        // 每个模块每个级别注册一个格式串，消息体作为唯一参数
+        for (int i = 0; i < 5; ++i) {
+            state->formatIds[i] = LowLatencyLogger::registerFormat(
+                {state->format.c_str(), "", 0, toBackendLevel(static_cast<LogLevel>(i))});
+        }
     }
+    return state.get();
+}
+
+Logger::Logger(const std::string& moduleName)
+    : m_moduleName(moduleName), m_module(registerModule(moduleName)) {
+    backend();
+}
+
+Logger::~Logger() {
+    // 日志由后台线程写出，这里无需刷新
 }
 
 void Logger::setLogLevel(LogLevel level) {
     std::lock_guard<std::mutex> lock(m_mutex);
-    m_logLevel = level;
+    g_defaultLevel = level;
+    for (auto& entry : modules()) {
+        if (!entry.second->overridden) {
+            entry.second->level.store(level, std::memory_order_relaxed);
+        }
+    }
 }
 
-void Logger::setLogFile(const std::string& filename) {
+void Logger::setModuleLogLevel(const std::string& moduleName, LogLevel level) {
+    ModuleState* state = registerModule(moduleName);
     std::lock_guard<std::mutex> lock(m_mutex);
-    if (m_logFile.is_open()) {
-        m_logFile.close();
-    }
-    m_logFile.open(filename, std::ios::out | std::ios::app);
-    if (!m_logFile.is_open()) {
-        std::cerr << "Failed to open log file: " << filename << std::endl;
-    }
+    state->overridden = true;
+    state->level.store(level, std::memory_order_relaxed);
+}
+
+void Logger::setLogFile(const std::string& filename) {
+    backend().setOutputFile(filename);
 }
 
 void Logger::enableConsoleOutput(bool enable) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_consoleOutput = enable;
+    backend().setConsoleOutput(enable);
+}
+
+void Logger::setOverflowPolicy(OverflowPolicy policy) {
+    backend().setOverflowPolicy(policy == OverflowPolicy::BLOCK ? LogOverflowPolicy::BLOCK : LogOverflowPolicy::DROP);
+}
+
+void Logger::setRotation(uint64_t maxFileBytes, std::chrono::seconds interval) {
+    backend().setRotation(maxFileBytes, interval);
+}
+
+void Logger::flush() {
+    backend().flush();
+}
+
+uint64_t Logger::getDroppedCount() {
+    return backend().getDroppedCount();
 }
 
 void Logger::debug(const std::string& message) {
@@ -61,64 +131,14 @@ void Logger::fatal(const std::string& message) {
     log(LogLevel::FATAL, message);
 }
 
-std::string Logger::getCurrentTime() const {
-    auto now = std::chrono::system_clock::now();
-    auto time_t_now = std::chrono::system_clock::to_time_t(now);
-    std::tm local_tm = *std::localtime(&time_t_now);
-
-    std::stringstream ss;
-    ss << std::put_time(&local_tm, "%Y-%m-%d %H:%M:%S.");
-
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now - std::chrono::system_clock::from_time_t(time_t_now));
-    ss << std::setw(3) << std::setfill('0') << ms.count();
-
-    return ss.str();
-}
-
 void Logger::log(LogLevel level, const std::string& message) {
-    if (level < m_logLevel) {
+    if (!isEnabled(level)) {
         return;
     }
 
-    std::string timeStr = getCurrentTime();
-    std::string levelStr = logLevelToString(level);
-    std::string logMessage = timeStr + " [" + levelStr + "] [" + m_moduleName + "]: " + message + "\n";
-
-    std::lock_guard<std::mutex> lock(m_mutex);
-
-    if (m_consoleOutput) {
-        // 根据日志级别设置控制台颜色
-        switch (level) {
-            case LogLevel::DEBUG: std::cout << "\033[37m" << logMessage << "\033[0m";
-                break;
-            case LogLevel::INFO: std::cout << "\033[32m" << logMessage << "\033[0m";
-                break;
-            case LogLevel::WARNING: std::cout << "\033[33m" << logMessage << "\033[0m";
-                break;
-            case LogLevel::ERROR: std::cout << "\033[31m" << logMessage << "\033[0m";
-                break;
-            case LogLevel::FATAL: std::cout << "\033[41;37m" << logMessage << "\033[0m";
-                break;
-        }
-    }
-
-    if (m_logFile.is_open()) {
-        m_logFile << logMessage;
-        m_logFile.flush();
-    }
-}
-
-std::string Logger::logLevelToString(LogLevel level) const {
-    switch (level) {
-        case LogLevel::DEBUG: return "DEBUG";
-        case LogLevel::INFO: return "INFO";
-        case LogLevel::WARNING: return "WARNING";
-        case LogLevel::ERROR: return "ERROR";
-        case LogLevel::FATAL: return "FATAL";
-        default: return "UNKNOWN";
-    }
+    // 只把消息拷贝进本线程的环，时间戳、格式化与写出由后台线程完成
+    backend().logFormat(m_module->formatIds[static_cast<int>(level)], toBackendLevel(level), message);
 }
 
 } // namespace core
-} // namespace hft
\ No newline at end of file
+} // namespace hft
@@ -4,6 +4,14 @@
 #include <mutex>
 #include <iostream>
 #include <ctime>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+
+// 异步后端（utils/LowLatencyLogger.h）；此处不包含其头文件，避免全局LogLevel与core::LogLevel冲突
+class LowLatencyLogger;
 
 namespace hft {
 namespace core {
@@ -16,17 +24,45 @@ enum class LogLevel {
     FATAL
 };
 
+// 模块日志器
+//
+// 所有模块共用一个LowLatencyLogger后端：调用线程只做级别判断并把消息拷贝进
+// 本线程的有界环，格式化、控制台输出、落盘与文件滚动都在后台线程完成。
+// 级别可按模块单独设置，判断发生在构造任何字符串之前：
+//     HFT_LOG(logger, LogLevel::DEBUG, "order " + std::to_string(id) + " filled");
 class Logger {
 public:
+    // 线程环写满时的处理策略，只作用于ERROR以下级别；
+    // ERROR/FATAL总是等待后台线程腾出空间，后台不可用时在调用线程同步写出，从不丢弃
+    enum class OverflowPolicy {
+        DROP,    // 丢弃并计数（默认）
+        BLOCK    // 等待后台线程腾出空间
+    };
+
     Logger(const std::string& moduleName);
     ~Logger();
 
-    // 设置日志级别
+    // 设置日志级别（未单独设置级别的模块）
     static void setLogLevel(LogLevel level);
+    // 设置指定模块的日志级别
+    static void setModuleLogLevel(const std::string& moduleName, LogLevel level);
     // 设置日志文件
     static void setLogFile(const std::string& filename);
     // 启用控制台输出
     static void enableConsoleOutput(bool enable);
+    // 环满时的处理策略（默认丢弃并计数）
+    static void setOverflowPolicy(OverflowPolicy policy);
+    // 按大小/时间滚动日志文件，0表示不限制
+    static void setRotation(uint64_t maxFileBytes, std::chrono::seconds interval);
+    // 等待已提交的日志全部写出
+    static void flush();
+    // 因环满而丢弃的日志条数（只会是ERROR以下级别）
+    static uint64_t getDroppedCount();
+
+    // 当前模块是否输出该级别
+    bool isEnabled(LogLevel level) const {
+        return level >= m_module->level.load(std::memory_order_relaxed);
+    }
 
     // 日志输出方法
     void debug(const std::string& message);
@@ -35,20 +71,39 @@ public:
     void error(const std::string& message);
     void fatal(const std::string& message);
 
+    // 日志输出实现
+    void log(LogLevel level, const std::string& message);
+
+    const std::string& getModuleName() const { return m_moduleName; }
+
+    // 所有模块共享的异步后端
+    static LowLatencyLogger& backend();
+
 private:
+    // 模块状态，按模块名共享，生命周期到进程结束
+    struct ModuleState {
+        std::string name;
+        std::string format;                 // "[模块名]: {}"
+        std::atomic<LogLevel> level;
+        bool overridden;
+        uint32_t formatIds[5];
+    };
+
     std::string m_moduleName;
-    static LogLevel m_logLevel;
-    static std::ofstream m_logFile;
-    static bool m_consoleOutput;
+    ModuleState* m_module;
     static std::mutex m_mutex;
 
-    // 获取当前时间字符串
-    std::string getCurrentTime() const;
-    // 日志输出实现
-    void log(LogLevel level, const std::string& message);
-    // 获取日志级别字符串
-    std::string logLevelToString(LogLevel level) const;
+    static std::map<std::string, std::unique_ptr<ModuleState>>& modules();
+    static ModuleState* registerModule(const std::string& moduleName);
 };
 
 } // namespace core
-} // namespace hft
\ No newline at end of file
+} // namespace hft
+
+// 仅在级别开启时才求值message表达式
+#define HFT_LOG(logger, level, message)        \
+    do {                                       \
+        if ((logger).isEnabled(level)) {       \
+            (logger).log((level), (message));  \
+        }                                      \
+    } while (0)
@@ -0,0 +1,165 @@
+#include "LowLatencyEventLoop.h"
+#include <iostream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace hft {
+namespace core {
+
+namespace {
+
+bool pinCurrentThread(int cpu_core) {
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu_core, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+    (void)cpu_core;
+    return false;
+#endif
+}
+
+} // namespace
+
+LowLatencyEventLoop::LowLatencyEventLoop()
+    : LowLatencyEventLoop(Config()) {
+}
+
+LowLatencyEventLoop::LowLatencyEventLoop(const Config& config)
+    : m_config(config),
+      m_running(false),
+      m_loopThreadId(std::thread::id()),
+      m_inbox(config.inbox_capacity),
+      m_timers(config.max_timers),
+      m_epoch(std::chrono::steady_clock::now()),
+      m_iterations(0) {
+    if (m_config.tick.count() <= 0) {
+        m_config.tick = std::chrono::microseconds(1);
+    }
+}
+
+LowLatencyEventLoop::~LowLatencyEventLoop() {
+    if (m_running) {
+        stop();
+    }
+}
+
+void LowLatencyEventLoop::start() {
+    if (m_running) {
+        return;
+    }
+
+    m_running = true;
+    m_loopThread = std::thread([this]() {
+        m_loopThreadId.store(std::this_thread::get_id());
+        if (m_config.cpu_core >= 0 && !pinCurrentThread(m_config.cpu_core)) {
+            std::cerr << "LowLatencyEventLoop: failed to pin to core " << m_config.cpu_core << std::endl;
+        }
+        loop();
+    });
+}
+
+void LowLatencyEventLoop::stop() {
+    if (!m_running) {
+        return;
+    }
+
+    m_running = false;
+    if (m_loopThread.joinable()) {
+        m_loopThread.join();
+    }
+    m_loopThreadId.store(std::thread::id());
+}
+
+bool LowLatencyEventLoop::isInLoopThread() const {
+    return std::this_thread::get_id() == m_loopThreadId.load();
+}
+
+void LowLatencyEventLoop::postTask(Task task) {
+    m_inbox.push(std::move(task));
+}
+
+bool LowLatencyEventLoop::tryPostTask(Task task) {
+    return m_inbox.try_push(std::move(task));
+}
+
+LowLatencyEventLoop::TimerId LowLatencyEventLoop::addTimer(TimerCallback callback, std::chrono::milliseconds delay) {
+    if (!timerCallAllowed()) {
+        return TimerWheel::kInvalidTimer;
+    }
+    return m_timers.schedule(std::move(callback), nowTick() + toTicks(delay));
+}
+
+LowLatencyEventLoop::TimerId LowLatencyEventLoop::addPeriodicTimer(TimerCallback callback, std::chrono::milliseconds interval) {
+    if (!timerCallAllowed()) {
+        return TimerWheel::kInvalidTimer;
+    }
+    const uint64_t ticks = toTicks(interval) > 0 ? toTicks(interval) : 1;
+    return m_timers.schedule(std::move(callback), nowTick() + ticks, ticks);
+}
+
+bool LowLatencyEventLoop::cancelTimer(TimerId timerId) {
+    if (!timerCallAllowed()) {
+        return false;
+    }
+    return m_timers.cancel(timerId);
+}
+
+size_t LowLatencyEventLoop::runTasks(size_t limit) {
+    size_t processed = 0;
+    Task task;
+    while (processed < limit && m_inbox.try_pop(task)) {
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "Exception in task: " << e.what() << std::endl;
+        }
+        task.reset();
+        ++processed;
+    }
+    return processed;
+}
+
+size_t LowLatencyEventLoop::pollOnce() {
+    size_t processed = runTasks(m_config.max_tasks_per_poll);
+    processed += m_timers.advance(nowTick());
+    m_iterations.fetch_add(1, std::memory_order_relaxed);
+    return processed;
+}
+
+void LowLatencyEventLoop::loop() {
+    // 忙轮询：不休眠、不让出CPU
+    while (m_running.load(std::memory_order_relaxed)) {
+        if (pollOnce() == 0) {
+            utils::cpuRelax();
+        }
+    }
+    // 退出前执行全部已投递的任务：单轮最多max_tasks_per_poll个，循环到收件箱为空
+    while (runTasks(m_config.max_tasks_per_poll) > 0) {
+    }
+    m_timers.advance(nowTick());
+}
+
+uint64_t LowLatencyEventLoop::nowTick() const {
+    const auto elapsed = std::chrono::steady_clock::now() - m_epoch;
+    return static_cast<uint64_t>(elapsed / m_config.tick);
+}
+
+uint64_t LowLatencyEventLoop::toTicks(std::chrono::milliseconds duration) const {
+    if (duration.count() <= 0) {
+        return 0;
+    }
+    const auto ticks = std::chrono::duration_cast<std::chrono::microseconds>(duration) / m_config.tick;
+    return ticks > 0 ? static_cast<uint64_t>(ticks) : 1;
+}
+
+bool LowLatencyEventLoop::timerCallAllowed() const {
+    // 时间轮非线程安全：运行中只允许循环线程操作
+    return !m_running.load(std::memory_order_acquire) || isInLoopThread();
+}
+
+} // namespace core
+} // namespace hft
@@ -0,0 +1,84 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "InplaceFunction.h"
+#include "TimerWheel.h"
+#include "../utils/RingBuffer.h"
+
+namespace hft {
+namespace core {
+
+// 低延迟事件循环（交易线程专用）
+// 与EventLoop接口一致，但：
+//  - 循环线程绑定到指定CPU核心并忙轮询，不使用条件变量
+//  - 跨线程任务通过有界无锁MPSC队列投递
+//  - 定时器使用分层时间轮，插入与取消为O(1)
+//  - 任务与定时器回调存放在固定大小缓冲区内，不分配堆内存
+// 定时器接口只能在循环线程内（或start()之前）调用，其他线程请通过postTask转发
+class LowLatencyEventLoop {
+public:
+    using Task = InplaceFunction<void(), 64>;
+    using TimerCallback = TimerWheel::Callback;
+    using TimerId = TimerWheel::TimerId;
+
+    struct Config {
+        int cpu_core = -1;                                   // -1 表示不绑核
+        size_t inbox_capacity = 4096;                        // 任务队列容量
+        size_t max_timers = 4096;                            // 定时器池大小
+        std::chrono::microseconds tick{100};                 // 时间轮精度
+        size_t max_tasks_per_poll = 256;                     // 每轮最多执行的任务数
+    };
+
+    LowLatencyEventLoop();
+    explicit LowLatencyEventLoop(const Config& config);
+    ~LowLatencyEventLoop();
+
+    LowLatencyEventLoop(const LowLatencyEventLoop&) = delete;
+    LowLatencyEventLoop& operator=(const LowLatencyEventLoop&) = delete;
+
+    // 启动事件循环（新建线程并绑核）
+    void start();
+    // 停止事件循环
+    void stop();
+    // 运行在事件循环线程
+    bool isInLoopThread() const;
+
+    // 向事件循环中添加任务，任意线程可调用；队列满时自旋等待
+    void postTask(Task task);
+    // 非阻塞投递，队列满时返回false
+    bool tryPostTask(Task task);
+
+    // 添加定时任务 (一次性)
+    TimerId addTimer(TimerCallback callback, std::chrono::milliseconds delay);
+    // 添加周期性任务
+    TimerId addPeriodicTimer(TimerCallback callback, std::chrono::milliseconds interval);
+    // 取消定时任务
+    bool cancelTimer(TimerId timerId);
+
+    // 执行一轮轮询（处理任务与到期定时器），供调用方在自己的线程内驱动
+    size_t pollOnce();
+
+    uint64_t getLoopIterations() const { return m_iterations.load(std::memory_order_relaxed); }
+
+private:
+    void loop();
+    // 执行收件箱中最多limit个任务
+    size_t runTasks(size_t limit);
+    uint64_t nowTick() const;
+    uint64_t toTicks(std::chrono::milliseconds duration) const;
+    bool timerCallAllowed() const;
+
+    Config m_config;
+    std::atomic<bool> m_running;
+    std::thread m_loopThread;
+    std::atomic<std::thread::id> m_loopThreadId;
+    utils::MPSCRingBuffer<Task> m_inbox;
+    TimerWheel m_timers;
+    std::chrono::steady_clock::time_point m_epoch;
+    std::atomic<uint64_t> m_iterations;
+};
+
+} // namespace core
+} // namespace hft
@@ -1,228 +1,503 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <array>
 #include <mutex>
 #include <atomic>
-#include "../core/Logger.h"
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "Logger.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
 
 namespace hft {
 namespace core {
 
+// 对象内存池
+// - 每个线程拥有本地缓存，分配/释放在本地空闲链表上完成，不使用原子操作
+// - 本地缓存为空时从中心空闲表整批获取，本地缓存过多时整批归还，
+//   因此跨线程释放（A线程分配、B线程释放）以批为单位流回中心表
+// - 扩展时追加新的内存块（chunk），已分配对象的地址永不移动
+// - 优先使用大页并mlock，失败时回退到普通页
+// - 可设置映射总量上限，达到上限后allocate()抛出std::bad_alloc
 template<typename T, size_t BlockSize = 4096>
 class MemoryPool {
+    static_assert(sizeof(T) <= BlockSize, "BlockSize must hold T");
+
 public:
-    // 初始化内存池
-    bool initialize(size_t initial_size = 1024 * 1024) {
-        try {
-            // 分配大页内存
-            void* huge_page = allocateHugePages(initial_size);
-            if (!huge_page) {
-                Logger::error("Failed to allocate huge pages");
-                return false;
-            }
-            
-            base_address_ = reinterpret_cast<char*>(huge_page);
-            pool_size_ = initial_size;
-            
-            // 初始化空闲块链表
-            initializeFreeList();
-            
-            // 锁定内存防止页面交换
-            if (!lockMemory()) {
-                Logger::warn("Failed to lock memory pages");
+    // 获取统计信息
+    struct Stats {
+        size_t total_size;            // 已映射的总字节数
+        size_t allocated_blocks;      // 已分配块数
+        size_t free_blocks;           // 空闲块数（中心表 + 各线程缓存）
+        double fragmentation_ratio;   // 空闲块占比
+        size_t chunk_count;           // 内存块（chunk）数量
+        size_t thread_caches;         // 活跃线程缓存数量
+        uint64_t batches_fetched;     // 从中心表获取的批次数
+        uint64_t batches_returned;    // 归还到中心表的批次数
+        bool huge_pages;              // 所有chunk均为大页
+        bool memory_locked;           // 所有chunk均已锁定
+    };
+
+    static constexpr size_t kBatchSize = 64;            // 线程缓存与中心表之间的批大小
+    static constexpr size_t kMaxThreadCaches = 64;      // 每个池支持的线程缓存数量
+    static constexpr size_t kMaxChunks = 48;            // 最多扩展次数
+
+    MemoryPool() : uid_(nextUid()) {}
+
+    ~MemoryPool() {
+        {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.pools.erase(uid_);
+        }
+        for (size_t i = 0; i < chunk_count_; ++i) {
+            releaseChunk(chunks_[i]);
+        }
+    }
+
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    // 初始化内存池，max_size为映射总字节数上限（0表示不限制）
+    bool initialize(size_t initial_size = 1024 * 1024, size_t max_size = 0) {
+        size_t unlocked_bytes = 0;
+        bool grown = false;
+        {
+            std::lock_guard<std::mutex> lock(central_mutex_);
+            if (is_initialized_) {
+                return true;
             }
-            
-            is_initialized_ = true;
-            return true;
-            
-        } catch (const std::exception& e) {
-            Logger::error("Memory pool initialization failed: {}", e.what());
+            next_chunk_size_ = initial_size < kSlotSize * kBatchSize ? kSlotSize * kBatchSize : initial_size;
+            max_bytes_ = max_size;
+            grown = growLocked(unlocked_bytes);
+            is_initialized_ = grown;
+        }
+        // 日志在释放中心表锁之后输出
+        reportUnlocked(unlocked_bytes);
+        if (!grown) {
+            logger().error("initial allocation of " + std::to_string(initial_size) + " bytes failed");
             return false;
         }
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.pools[uid_] = this;
+        return true;
     }
 
-    // 分配对象
+    // 分配对象（仅分配内存，不构造）
     T* allocate() {
         if (!is_initialized_) {
             throw std::runtime_error("Memory pool not initialized");
         }
 
-        // 从空闲链表获取块
-        Block* block = getFreeBlock();
-        if (!block) {
-            // 需要扩展内存池
-            if (!expandPool()) {
+        ThreadCache* cache = localCache();
+        if (!cache) {
+            // 线程缓存已用尽：直接走中心表
+            FreeBlock* block = popCentralSingle();
+            if (!block) {
+                throw std::bad_alloc();
+            }
+            uncached_allocs_.fetch_add(1, std::memory_order_relaxed);
+            return reinterpret_cast<T*>(block);
+        }
+
+        if (!cache->head) {
+            if (!refill(*cache)) {
                 throw std::bad_alloc();
             }
-            block = getFreeBlock();
         }
 
-        // 更新统计信息
-        ++allocated_blocks_;
-        
-        return reinterpret_cast<T*>(block->data);
+        FreeBlock* block = cache->head;
+        cache->head = block->next;
+        --cache->count;
+        cache->allocs.store(cache->allocs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return reinterpret_cast<T*>(block);
     }
 
-    // 释放对象
+    // 释放对象（仅归还内存，不析构），可在任意线程调用
     void deallocate(T* ptr) {
         if (!ptr) return;
 
-        // 获取块头
-        Block* block = reinterpret_cast<Block*>(
-            reinterpret_cast<char*>(ptr) - offsetof(Block, data)
-        );
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(ptr);
+        ThreadCache* cache = localCache();
+        if (!cache) {
+            pushCentralSingle(block);
+            uncached_frees_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        block->next = cache->head;
+        cache->head = block;
+        ++cache->count;
+        cache->frees.store(cache->frees.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 
-        // 将块放回空闲链表
-        returnBlockToFreeList(block);
-        
-        // 更新统计信息
-        --allocated_blocks_;
+        if (cache->count >= 2 * kBatchSize) {
+            flushBatch(*cache);
+        }
+    }
+
+    // 分配并构造
+    template<typename... Args>
+    T* create(Args&&... args) {
+        T* ptr = allocate();
+        try {
+            return new (ptr) T(std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(ptr);
+            throw;
+        }
+    }
+
+    // 析构并释放
+    void destroy(T* ptr) {
+        if (!ptr) return;
+        ptr->~T();
+        deallocate(ptr);
     }
 
-    // 获取统计信息
-    struct Stats {
-        size_t total_size;
-        size_t allocated_blocks;
-        size_t free_blocks;
-        double fragmentation_ratio;
-    };
-    
     Stats getStats() const {
-        Stats stats;
-        stats.total_size = pool_size_;
-        stats.allocated_blocks = allocated_blocks_.load();
-        stats.free_blocks = free_blocks_.load();
-        stats.fragmentation_ratio = calculateFragmentation();
+        Stats stats{};
+        uint64_t allocs = uncached_allocs_.load(std::memory_order_relaxed);
+        uint64_t frees = uncached_frees_.load(std::memory_order_relaxed);
+        for (const auto& cache : caches_) {
+            if (cache.in_use.load(std::memory_order_acquire)) {
+                ++stats.thread_caches;
+            }
+            allocs += cache.allocs.load(std::memory_order_relaxed);
+            frees += cache.frees.load(std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lock(central_mutex_);
+        const size_t total_blocks = total_blocks_;
+        stats.total_size = total_bytes_;
+        stats.allocated_blocks = allocs > frees ? static_cast<size_t>(allocs - frees) : 0;
+        stats.free_blocks = total_blocks > stats.allocated_blocks ? total_blocks - stats.allocated_blocks : 0;
+        stats.fragmentation_ratio = total_blocks == 0 ? 0.0
+            : static_cast<double>(stats.free_blocks) / static_cast<double>(total_blocks);
+        stats.chunk_count = chunk_count_;
+        stats.batches_fetched = batches_fetched_;
+        stats.batches_returned = batches_returned_;
+        stats.huge_pages = chunk_count_ > 0 && huge_chunks_ == chunk_count_;
+        stats.memory_locked = chunk_count_ > 0 && locked_chunks_ == chunk_count_;
         return stats;
     }
 
 private:
-    // 内存块结构
-    struct alignas(64) Block {  // 缓存行对齐
-        Block* next;
-        char data[BlockSize];
+    // 空闲块在自身负载内存放链表指针；批次首块额外记录下一批次与批大小
+    struct FreeBlock {
+        FreeBlock* next;
+        FreeBlock* next_batch;
+        size_t batch_count;
     };
 
-    // 分配大页内存
-    void* allocateHugePages(size_t size) {
-        // 使用2MB大页
-        constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
-        size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
-        
-        #ifdef _WIN32
-            return VirtualAlloc(nullptr, size, 
-                MEM_LARGE_PAGES | MEM_COMMIT | MEM_RESERVE,
-                PAGE_READWRITE);
-        #else
-            return mmap(nullptr, size, 
-                PROT_READ | PROT_WRITE,
-                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
-                -1, 0);
-        #endif
-    }
-
-    // 锁定内存
-    bool lockMemory() {
-        #ifdef _WIN32
-            return VirtualLock(base_address_, pool_size_) != 0;
-        #else
-            return mlock(base_address_, pool_size_) == 0;
-        #endif
-    }
-
-    // 初始化空闲块链表
-    void initializeFreeList() {
-        size_t num_blocks = pool_size_ / sizeof(Block);
-        Block* current = reinterpret_cast<Block*>(base_address_);
-        
-        for (size_t i = 0; i < num_blocks - 1; ++i) {
-            current->next = reinterpret_cast<Block*>(
-                reinterpret_cast<char*>(current) + sizeof(Block)
-            );
-            current = current->next;
-        }
-        
-        current->next = nullptr;
-        free_list_ = reinterpret_cast<Block*>(base_address_);
-        free_blocks_ = num_blocks;
-    }
-
-    // 获取空闲块
-    Block* getFreeBlock() {
-        Block* block = nullptr;
-        
-        // 无锁快速路径
-        block = free_list_.load(std::memory_order_relaxed);
-        if (!block) return nullptr;
-        
-        // CAS循环
-        while (block && !free_list_.compare_exchange_weak(
-            block, block->next,
-            std::memory_order_release,
-            std::memory_order_relaxed)) {
-            // 重试
-        }
-        
-        if (block) {
-            --free_blocks_;
-        }
-        
+    static_assert(BlockSize >= sizeof(FreeBlock), "BlockSize too small for free-list header");
+
+    // 按缓存行对齐的槽位大小
+    static constexpr size_t kSlotAlign = alignof(T) > 64 ? alignof(T) : 64;
+    static constexpr size_t kSlotSize = (BlockSize + kSlotAlign - 1) / kSlotAlign * kSlotAlign;
+
+    struct alignas(64) ThreadCache {
+        FreeBlock* head{nullptr};
+        size_t count{0};
+        std::atomic<bool> in_use{false};
+        // 仅所属线程写入，统计时其他线程读取
+        std::atomic<uint64_t> allocs{0};
+        std::atomic<uint64_t> frees{0};
+    };
+
+    struct Chunk {
+        void* base{nullptr};
+        size_t size{0};
+        bool huge{false};
+        bool locked{false};
+    };
+
+    // 所有存活的池，线程退出时据此把缓存归还给仍然存在的池
+    struct Registry {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, MemoryPool*> pools;
+    };
+
+    static Registry& registry() {
+        static Registry reg;
+        return reg;
+    }
+
+    static uint64_t nextUid() {
+        static std::atomic<uint64_t> uid{1};
+        return uid.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 线程本地的 池uid -> 缓存槽位 映射，线程退出时归还缓存
+    struct ThreadBindings {
+        static constexpr size_t kMaxBindings = 16;
+        std::array<std::pair<uint64_t, uint32_t>, kMaxBindings> entries{};
+        size_t size{0};
+
+        ~ThreadBindings() {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            for (size_t i = 0; i < size; ++i) {
+                auto it = reg.pools.find(entries[i].first);
+                if (it != reg.pools.end()) {
+                    it->second->releaseCache(entries[i].second);
+                }
+            }
+        }
+
+        // 绑定表已满时移除已销毁池的条目（uid不复用，不会误删），返回是否腾出空位。
+        // 长期存活的线程反复创建/销毁池时，靠这里回收条目
+        bool pruneDead() {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            size_t kept = 0;
+            for (size_t i = 0; i < size; ++i) {
+                if (reg.pools.count(entries[i].first)) {
+                    entries[kept++] = entries[i];
+                }
+            }
+            size = kept;
+            return size < kMaxBindings;
+        }
+    };
+
+    ThreadCache* localCache() {
+        thread_local ThreadBindings bindings;
+        for (size_t i = 0; i < bindings.size; ++i) {
+            if (bindings.entries[i].first == uid_) {
+                return &caches_[bindings.entries[i].second];
+            }
+        }
+        if (bindings.size == ThreadBindings::kMaxBindings && !bindings.pruneDead()) {
+            return nullptr;
+        }
+        for (uint32_t slot = 0; slot < kMaxThreadCaches; ++slot) {
+            bool expected = false;
+            if (caches_[slot].in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                bindings.entries[bindings.size++] = {uid_, slot};
+                return &caches_[slot];
+            }
+        }
+        return nullptr;
+    }
+
+    // 线程退出：缓存中的块全部归还中心表（调用方持有registry锁）
+    void releaseCache(uint32_t slot) {
+        ThreadCache& cache = caches_[slot];
+        if (cache.head) {
+            std::lock_guard<std::mutex> lock(central_mutex_);
+            pushBatchLocked(cache.head, cache.count);
+        }
+        cache.head = nullptr;
+        cache.count = 0;
+        cache.in_use.store(false, std::memory_order_release);
+    }
+
+    bool refill(ThreadCache& cache) {
+        size_t unlocked_bytes = 0;
+        {
+            std::lock_guard<std::mutex> lock(central_mutex_);
+            if (central_batches_ || growLocked(unlocked_bytes)) {
+                FreeBlock* batch = central_batches_;
+                central_batches_ = batch->next_batch;
+                cache.head = batch;
+                cache.count = batch->batch_count;
+                ++batches_fetched_;
+            }
+        }
+        reportUnlocked(unlocked_bytes);
+        return cache.head != nullptr;
+    }
+
+    // 从本地链表头部摘下kBatchSize个块作为一批归还
+    void flushBatch(ThreadCache& cache) {
+        FreeBlock* first = cache.head;
+        FreeBlock* last = first;
+        for (size_t i = 1; i < kBatchSize; ++i) {
+            last = last->next;
+        }
+        cache.head = last->next;
+        cache.count -= kBatchSize;
+        last->next = nullptr;
+
+        std::lock_guard<std::mutex> lock(central_mutex_);
+        pushBatchLocked(first, kBatchSize);
+        ++batches_returned_;
+    }
+
+    void pushBatchLocked(FreeBlock* first, size_t count) {
+        first->batch_count = count;
+        first->next_batch = central_batches_;
+        central_batches_ = first;
+    }
+
+    FreeBlock* popCentralSingle() {
+        size_t unlocked_bytes = 0;
+        FreeBlock* block = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(central_mutex_);
+            if (central_batches_ || growLocked(unlocked_bytes)) {
+                block = central_batches_;
+                if (block->next) {
+                    // 批次首块出列，剩余部分仍作为一批
+                    FreeBlock* rest = block->next;
+                    rest->batch_count = block->batch_count - 1;
+                    rest->next_batch = block->next_batch;
+                    central_batches_ = rest;
+                } else {
+                    central_batches_ = block->next_batch;
+                }
+            }
+        }
+        reportUnlocked(unlocked_bytes);
         return block;
     }
 
-    // 扩展内存池
-    bool expandPool() {
-        std::lock_guard<std::mutex> lock(expand_mutex_);
-        
-        // 双倍扩展
-        size_t new_size = pool_size_ * 2;
-        void* new_memory = allocateHugePages(new_size);
-        
-        if (!new_memory) {
+    void pushCentralSingle(FreeBlock* block) {
+        std::lock_guard<std::mutex> lock(central_mutex_);
+        block->next = nullptr;
+        pushBatchLocked(block, 1);
+    }
+
+    // 追加一个chunk并切分为若干批挂入中心表，已有chunk保持不动；
+    // 未能锁定的字节数累加到unlocked_bytes，由调用方在释放锁之后记录日志
+    bool growLocked(size_t& unlocked_bytes) {
+        if (chunk_count_ == kMaxChunks) {
             return false;
         }
-        
-        // 更新基地址和大小
-        char* old_base = base_address_;
-        base_address_ = reinterpret_cast<char*>(new_memory);
-        pool_size_ = new_size;
-        
-        // 重新初始化空闲链表
-        initializeFreeList();
-        
-        // 复制旧数据
-        std::memcpy(base_address_, old_base, pool_size_ / 2);
-        
-        // 释放旧内存
-        #ifdef _WIN32
-            VirtualFree(old_base, 0, MEM_RELEASE);
-        #else
-            munmap(old_base, pool_size_ / 2);
-        #endif
-        
+        if (max_bytes_ != 0 && total_bytes_ + next_chunk_size_ > max_bytes_) {
+            // 按剩余额度收缩最后一个chunk，不足一批时视为耗尽
+            const size_t remaining = max_bytes_ > total_bytes_ ? max_bytes_ - total_bytes_ : 0;
+            if (remaining < kSlotSize * kBatchSize) {
+                return false;
+            }
+            next_chunk_size_ = remaining;
+        }
+        Chunk chunk = mapChunk(next_chunk_size_);
+        if (!chunk.base) {
+            return false;
+        }
+        if (!chunk.locked) {
+            unlocked_bytes += chunk.size;
+        }
+
+        const size_t num_blocks = chunk.size / kSlotSize;
+        char* base = static_cast<char*>(chunk.base);
+        for (size_t start = 0; start < num_blocks; start += kBatchSize) {
+            const size_t end = start + kBatchSize < num_blocks ? start + kBatchSize : num_blocks;
+            for (size_t i = start; i < end; ++i) {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(base + i * kSlotSize);
+                block->next = (i + 1 < end) ? reinterpret_cast<FreeBlock*>(base + (i + 1) * kSlotSize) : nullptr;
+            }
+            pushBatchLocked(reinterpret_cast<FreeBlock*>(base + start * kSlotSize), end - start);
+        }
+
+        chunks_[chunk_count_++] = chunk;
+        total_blocks_ += num_blocks;
+        total_bytes_ += chunk.size;
+        huge_chunks_ += chunk.huge ? 1 : 0;
+        locked_chunks_ += chunk.locked ? 1 : 0;
+        // 几何增长，控制chunk数量
+        next_chunk_size_ *= 2;
         return true;
     }
 
-    // 计算内存碎片率
-    double calculateFragmentation() const {
-        if (allocated_blocks_ == 0) return 0.0;
-        
-        size_t total_blocks = pool_size_ / sizeof(Block);
-        size_t used_blocks = allocated_blocks_;
-        
-        return 1.0 - (static_cast<double>(used_blocks) / total_blocks);
+    // 分配大页内存，失败时回退到普通页；随后尝试锁定防止换页
+    static Chunk mapChunk(size_t size) {
+        constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+        Chunk chunk;
+        const size_t huge_size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+
+#ifdef _WIN32
+        const SIZE_T large_min = GetLargePageMinimum();
+        if (large_min > 0) {
+            const size_t large_size = (size + large_min - 1) / large_min * large_min;
+            chunk.base = VirtualAlloc(nullptr, large_size,
+                                      MEM_LARGE_PAGES | MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+            chunk.size = large_size;
+            chunk.huge = chunk.base != nullptr;
+        }
+        if (!chunk.base) {
+            chunk.base = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+            chunk.size = size;
+        }
+        if (chunk.base) {
+            chunk.locked = VirtualLock(chunk.base, chunk.size) != 0;
+        }
+#else
+        void* mem = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mem != MAP_FAILED) {
+            chunk.base = mem;
+            chunk.size = huge_size;
+            chunk.huge = true;
+        } else {
+            mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mem == MAP_FAILED) {
+                return Chunk{};
+            }
+            chunk.base = mem;
+            chunk.size = size;
+#ifdef MADV_HUGEPAGE
+            // 透明大页作为次优选择
+            madvise(mem, size, MADV_HUGEPAGE);
+#endif
+        }
+        chunk.locked = mlock(chunk.base, chunk.size) == 0;
+#endif
+        return chunk;
+    }
+
+    static Logger& logger() {
+        static Logger instance("MemoryPool");
+        return instance;
+    }
+
+    static void reportUnlocked(size_t unlocked_bytes) {
+        if (unlocked_bytes != 0) {
+            logger().warning("failed to lock " + std::to_string(unlocked_bytes) + " bytes, pages may be swapped");
+        }
+    }
+
+    static void releaseChunk(const Chunk& chunk) {
+#ifdef _WIN32
+        VirtualFree(chunk.base, 0, MEM_RELEASE);
+#else
+        if (chunk.locked) {
+            munlock(chunk.base, chunk.size);
+        }
+        munmap(chunk.base, chunk.size);
+#endif
     }
 
 private:
-    char* base_address_{nullptr};              // 内存池基地址
-    size_t pool_size_{0};                      // 内存池大小
-    std::atomic<Block*> free_list_{nullptr};   // 空闲块链表
-    std::atomic<size_t> allocated_blocks_{0};  // 已分配块数
-    std::atomic<size_t> free_blocks_{0};       // 空闲块数
-    std::mutex expand_mutex_;                  // 扩展锁
-    bool is_initialized_{false};               // 初始化标志
+    const uint64_t uid_;                                 // 池标识（线程缓存绑定用）
+    std::array<ThreadCache, kMaxThreadCaches> caches_;   // 线程本地缓存
+    std::atomic<uint64_t> uncached_allocs_{0};           // 无缓存线程的分配次数
+    std::atomic<uint64_t> uncached_frees_{0};            // 无缓存线程的释放次数
+
+    mutable std::mutex central_mutex_;                   // 中心表锁（按批获取，均摊开销）
+    FreeBlock* central_batches_{nullptr};                // 中心空闲批次栈
+    std::array<Chunk, kMaxChunks> chunks_{};             // 已映射的chunk
+    size_t chunk_count_{0};
+    size_t next_chunk_size_{0};
+    size_t max_bytes_{0};                                // 映射总量上限，0表示不限制
+    size_t total_blocks_{0};
+    size_t total_bytes_{0};
+    size_t huge_chunks_{0};
+    size_t locked_chunks_{0};
+    uint64_t batches_fetched_{0};
+    uint64_t batches_returned_{0};
+    std::atomic<bool> is_initialized_{false};            // 初始化标志
 };
 
 } // namespace core
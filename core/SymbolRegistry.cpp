@@ -0,0 +1,133 @@
+#include "SymbolRegistry.h"
+#include <cstring>
+#include "Logger.h"
+
+namespace hft {
+namespace core {
+
+namespace {
+
+Logger& registryLogger() {
+    static Logger logger("SymbolRegistry");
+    return logger;
+}
+
+} // namespace
+
+SymbolRegistry::SymbolRegistry(size_t capacity, const std::string& kind)
+    : m_kind(kind),
+      m_capacity(capacity > 0 ? capacity : 1),
+      m_tableMask(0),
+      m_count(0) {
+    // 哈希表大小取容量两倍以上的2的幂，保证装载因子不超过0.5
+    size_t tableSize = 1;
+    while (tableSize < m_capacity * 2) {
+        tableSize <<= 1;
+    }
+    m_tableMask = tableSize - 1;
+    m_entries.reset(new Entry[m_capacity]);
+    m_table.reset(new std::atomic<uint32_t>[tableSize]);
+    for (size_t i = 0; i < tableSize; ++i) {
+        m_table[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t SymbolRegistry::hashName(std::string_view name) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint32_t SymbolRegistry::lookup(std::string_view name, uint64_t hash, size_t& slot) const {
+    slot = static_cast<size_t>(hash) & m_tableMask;
+    while (true) {
+        const uint32_t id = m_table[slot].load(std::memory_order_acquire);
+        if (id == 0) {
+            return 0;
+        }
+        const Entry& entry = m_entries[id - 1];
+        if (entry.hash == hash && entry.length == name.size() &&
+            std::memcmp(entry.name, name.data(), name.size()) == 0) {
+            return id;
+        }
+        slot = (slot + 1) & m_tableMask;
+    }
+}
+
+uint32_t SymbolRegistry::find(std::string_view name) const {
+    if (name.empty() || name.size() > kMaxNameLength) {
+        return 0;
+    }
+    size_t slot;
+    return lookup(name, hashName(name), slot);
+}
+
+uint32_t SymbolRegistry::intern(std::string_view name) {
+    if (name.empty()) {
+        return 0;
+    }
+    if (name.size() > kMaxNameLength) {
+        registryLogger().error("Cannot intern " + m_kind + " '" + std::string(name) + "': longer than " +
+                               std::to_string(kMaxNameLength) + " characters");
+        return 0;
+    }
+
+    const uint64_t hash = hashName(name);
+    size_t slot;
+    uint32_t id = lookup(name, hash, slot);
+    if (id != 0) {
+        return id;
+    }
+
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    // 加锁后重新查找，可能已被其他线程注册
+    id = lookup(name, hash, slot);
+    if (id != 0) {
+        return id;
+    }
+
+    const size_t index = m_count.load(std::memory_order_relaxed);
+    if (index >= m_capacity) {
+        registryLogger().error("Cannot intern " + m_kind + " '" + std::string(name) + "': registry full (" +
+                               std::to_string(m_capacity) + " entries)");
+        return 0;
+    }
+
+    // 先写条目，再发布到哈希表，读者看到ID时条目已完整
+    Entry& entry = m_entries[index];
+    std::memcpy(entry.name, name.data(), name.size());
+    entry.name[name.size()] = '\0';
+    entry.length = static_cast<uint8_t>(name.size());
+    entry.hash = hash;
+
+    id = static_cast<uint32_t>(index + 1);
+    m_count.store(index + 1, std::memory_order_release);
+    m_table[slot].store(id, std::memory_order_release);
+    return id;
+}
+
+std::string_view SymbolRegistry::name(uint32_t id) const {
+    if (id == 0 || id > m_count.load(std::memory_order_acquire)) {
+        return std::string_view();
+    }
+    const Entry& entry = m_entries[id - 1];
+    return std::string_view(entry.name, entry.length);
+}
+
+SymbolRegistry& SymbolRegistry::symbols() {
+    static SymbolRegistry registry(1 << 16, "symbol");
+    return registry;
+}
+
+SymbolRegistry& SymbolRegistry::venues() {
+    // VenueId为16位
+    static SymbolRegistry registry(1 << 10, "venue");
+    return registry;
+}
+
+} // namespace core
+} // namespace hft
@@ -0,0 +1,84 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace hft {
+namespace core {
+
+// 驻留后的标识符（标的、交易所），0表示无效
+using SymbolId = uint32_t;
+using VenueId = uint16_t;
+constexpr SymbolId kInvalidSymbol = 0;
+constexpr VenueId kInvalidVenue = 0;
+
+// 符号注册表
+// 把标的代码/交易所名称驻留为小整数，订单与行情记录只携带整数ID。
+//  - intern()在API边界调用，新名称写入时加锁，已存在的名称无锁命中
+//  - find()/name()完全无锁，可在热路径调用
+//  - 只增不删，ID在进程生命周期内稳定
+//  - 名称过长或表满时intern()记录错误日志并返回0，调用方必须在边界处拒绝该请求
+class SymbolRegistry {
+public:
+    static constexpr size_t kMaxNameLength = 31;
+
+    explicit SymbolRegistry(size_t capacity = 1 << 16, const std::string& kind = "symbol");
+
+    SymbolRegistry(const SymbolRegistry&) = delete;
+    SymbolRegistry& operator=(const SymbolRegistry&) = delete;
+
+    // 查找或注册名称；名称为空、过长或表满时返回0（后两者记录错误日志）
+    uint32_t intern(std::string_view name);
+    // 仅查找，不存在时返回0
+    uint32_t find(std::string_view name) const;
+    // ID对应的名称，无效ID返回空串
+    std::string_view name(uint32_t id) const;
+
+    size_t size() const { return m_count.load(std::memory_order_acquire); }
+    size_t capacity() const { return m_capacity; }
+
+    // 全局标的表与交易所表
+    static SymbolRegistry& symbols();
+    static SymbolRegistry& venues();
+
+private:
+    struct Entry {
+        char name[kMaxNameLength + 1];
+        uint8_t length;
+        uint64_t hash;
+    };
+
+    static uint64_t hashName(std::string_view name);
+    uint32_t lookup(std::string_view name, uint64_t hash, size_t& slot) const;
+
+    std::string m_kind;                                  // 日志中的名称类别（symbol/venue）
+    size_t m_capacity;
+    size_t m_tableMask;
+    std::unique_ptr<Entry[]> m_entries;                  // 按ID存放，下标为ID-1
+    std::unique_ptr<std::atomic<uint32_t>[]> m_table;    // 开放寻址哈希表，存放ID
+    std::atomic<size_t> m_count;
+    std::mutex m_writeMutex;
+};
+
+// 便捷函数：标的/交易所名称与ID互转
+inline SymbolId internSymbol(std::string_view symbol) {
+    return SymbolRegistry::symbols().intern(symbol);
+}
+
+inline std::string_view symbolName(SymbolId id) {
+    return SymbolRegistry::symbols().name(id);
+}
+
+inline VenueId internVenue(std::string_view venue) {
+    return static_cast<VenueId>(SymbolRegistry::venues().intern(venue));
+}
+
+inline std::string_view venueName(VenueId id) {
+    return SymbolRegistry::venues().name(id);
+}
+
+} // namespace core
+} // namespace hft
@@ -0,0 +1,196 @@
+#include "TimerWheel.h"
+#include <iostream>
+
+namespace hft {
+namespace core {
+
+TimerWheel::TimerWheel(size_t max_timers, uint64_t start_tick)
+    : nodes_(max_timers),
+      buckets_(kLevels * kSlots, kNil),
+      current_tick_(start_tick) {
+    // 构建空闲链表
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        nodes_[i].next = (i + 1 < nodes_.size()) ? static_cast<uint32_t>(i + 1) : kNil;
+    }
+    free_head_ = nodes_.empty() ? kNil : 0;
+}
+
+TimerWheel::TimerId TimerWheel::schedule(Callback callback, uint64_t expire_tick, uint64_t interval_ticks) {
+    if (free_head_ == kNil || !callback) {
+        return kInvalidTimer;
+    }
+
+    const uint32_t index = free_head_;
+    Node& node = nodes_[index];
+    free_head_ = node.next;
+
+    node.callback = std::move(callback);
+    node.expire_tick = expire_tick;
+    node.interval_ticks = interval_ticks;
+    node.state = State::ARMED;
+    link(index, false);
+    ++active_count_;
+    return makeId(index, node.generation);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    uint32_t index;
+    Node* node = lookup(id, index);
+    if (!node) {
+        return false;
+    }
+
+    switch (node->state) {
+    case State::ARMED:
+        unlink(index);
+        release(index);
+        return true;
+    case State::FIRING:
+        // 回调执行期间取消：回调返回后再释放节点
+        if (node->interval_ticks == 0) {
+            return false;
+        }
+        node->state = State::CANCELLED_WHILE_FIRING;
+        return true;
+    default:
+        return false;
+    }
+}
+
+size_t TimerWheel::advance(uint64_t now_tick) {
+    size_t fired = 0;
+    while (current_tick_ < now_tick) {
+        if (active_count_ == 0) {
+            // 没有定时器时直接跳到目标tick
+            current_tick_ = now_tick;
+            break;
+        }
+        ++current_tick_;
+
+        const uint32_t slot = static_cast<uint32_t>(current_tick_ & kSlotMask);
+        if (slot == 0) {
+            // 低层转满一圈，从上层逐级下沉
+            for (int level = 1; level < kLevels; ++level) {
+                cascade(level);
+                if (((current_tick_ >> (level * kSlotBits)) & kSlotMask) != 0) {
+                    break;
+                }
+            }
+        }
+        fired += fireSlot(slot);
+    }
+    return fired;
+}
+
+TimerWheel::Node* TimerWheel::lookup(TimerId id, uint32_t& index) {
+    const uint64_t low = id & 0xFFFFFFFFull;
+    if (low == 0 || low > nodes_.size()) {
+        return nullptr;
+    }
+    index = static_cast<uint32_t>(low - 1);
+    Node& node = nodes_[index];
+    if (node.generation != static_cast<uint32_t>(id >> 32) || node.state == State::FREE) {
+        return nullptr;
+    }
+    return &node;
+}
+
+void TimerWheel::link(uint32_t index, bool due_this_tick) {
+    Node& node = nodes_[index];
+    // 当前tick已处理完毕的新定时器推迟到下一tick；下沉时当前tick尚未触发，可直接挂入
+    const uint64_t earliest = due_this_tick ? current_tick_ : current_tick_ + 1;
+    if (node.expire_tick < earliest) {
+        node.expire_tick = earliest;
+    }
+
+    uint64_t delta = node.expire_tick - current_tick_;
+    const uint64_t max_delta = (uint64_t{1} << (kLevels * kSlotBits)) - 1;
+    if (delta > max_delta) {
+        // 超出时间轮范围：先挂在最高层最远槽位，下沉时重新计算
+        delta = max_delta;
+    }
+    const uint64_t target = current_tick_ + delta;
+
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (uint64_t{1} << ((level + 1) * kSlotBits))) {
+        ++level;
+    }
+    const uint32_t slot = static_cast<uint32_t>((target >> (level * kSlotBits)) & kSlotMask);
+    const uint32_t bucket = static_cast<uint32_t>(level) * kSlots + slot;
+
+    node.bucket = static_cast<uint16_t>(bucket);
+    node.prev = kNil;
+    node.next = buckets_[bucket];
+    if (node.next != kNil) {
+        nodes_[node.next].prev = index;
+    }
+    buckets_[bucket] = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        buckets_[node.bucket] = node.next;
+    }
+    if (node.next != kNil) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = kNil;
+    node.next = kNil;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node& node = nodes_[index];
+    node.callback.reset();
+    node.state = State::FREE;
+    ++node.generation;
+    node.next = free_head_;
+    free_head_ = index;
+    --active_count_;
+}
+
+void TimerWheel::cascade(int level) {
+    const uint32_t slot = static_cast<uint32_t>((current_tick_ >> (level * kSlotBits)) & kSlotMask);
+    const uint32_t bucket = static_cast<uint32_t>(level) * kSlots + slot;
+
+    uint32_t index = buckets_[bucket];
+    buckets_[bucket] = kNil;
+    while (index != kNil) {
+        const uint32_t next = nodes_[index].next;
+        link(index, true);
+        index = next;
+    }
+}
+
+size_t TimerWheel::fireSlot(uint32_t slot) {
+    size_t fired = 0;
+    // 逐个摘下链表头：回调中取消同槽位的其他定时器也是安全的，
+    // 而新插入的定时器delta至少为1，不会落回当前槽位
+    while (buckets_[slot] != kNil) {
+        const uint32_t index = buckets_[slot];
+        unlink(index);
+
+        Node& node = nodes_[index];
+        node.state = State::FIRING;
+        try {
+            node.callback();
+        } catch (const std::exception& e) {
+            std::cerr << "Exception in timer callback: " << e.what() << std::endl;
+        }
+        ++fired;
+
+        if (node.state == State::FIRING && node.interval_ticks != 0) {
+            node.state = State::ARMED;
+            node.expire_tick = current_tick_ + node.interval_ticks;
+            link(index, false);
+        } else {
+            release(index);
+        }
+    }
+    return fired;
+}
+
+} // namespace core
+} // namespace hft
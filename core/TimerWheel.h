@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "InplaceFunction.h"
+
+namespace hft {
+namespace core {
+
+// 分层时间轮
+// 4层 × 256槽，覆盖2^32个tick；定时器节点预分配在池中并以双向链表挂在槽位上，
+// 插入与取消均为O(1)，到期时由高层向低层逐级下沉
+// 非线程安全：仅由所属事件循环线程调用
+class TimerWheel {
+public:
+    using Callback = InplaceFunction<void(), 64>;
+    using TimerId = uint64_t;
+
+    static constexpr TimerId kInvalidTimer = 0;
+
+    explicit TimerWheel(size_t max_timers = 4096, uint64_t start_tick = 0);
+
+    // 在expire_tick触发；interval_ticks非0时为周期定时器
+    // 池已满时返回kInvalidTimer
+    TimerId schedule(Callback callback, uint64_t expire_tick, uint64_t interval_ticks = 0);
+
+    // 取消定时器，已触发的一次性定时器或过期ID返回false
+    bool cancel(TimerId id);
+
+    // 推进到now_tick并触发所有到期定时器，返回触发数量
+    size_t advance(uint64_t now_tick);
+
+    uint64_t currentTick() const { return current_tick_; }
+    size_t activeTimers() const { return active_count_; }
+    size_t capacity() const { return nodes_.size(); }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr uint32_t kSlots = 1u << kSlotBits;
+    static constexpr uint32_t kSlotMask = kSlots - 1;
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    enum class State : uint8_t {
+        FREE,
+        ARMED,
+        FIRING,
+        CANCELLED_WHILE_FIRING
+    };
+
+    struct Node {
+        Callback callback;
+        uint64_t expire_tick = 0;
+        uint64_t interval_ticks = 0;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t generation = 0;
+        uint16_t bucket = 0;     // level * kSlots + slot
+        State state = State::FREE;
+    };
+
+    static TimerId makeId(uint32_t index, uint32_t generation) {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(index) + 1);
+    }
+
+    Node* lookup(TimerId id, uint32_t& index);
+    void link(uint32_t index, bool due_this_tick);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(int level);
+    size_t fireSlot(uint32_t slot);
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> buckets_;   // kLevels * kSlots 个链表头
+    uint32_t free_head_ = kNil;
+    size_t active_count_ = 0;
+    uint64_t current_tick_;
+};
+
+} // namespace core
+} // namespace hft
@@ -487,7 +487,9 @@ void VwapOrderExecutor::updateMarketDataHistory(const market::MarketData& data)
 
 // AdvancedOrderExecutionEngine 实现
 AdvancedOrderExecutionEngine::AdvancedOrderExecutionEngine(core::TimeManager* time_manager)
-    : m_time_manager(time_manager) {
+    : m_time_manager(time_manager),
+      m_scheduler(new ExecutionScheduler(ExecutionSchedulerConfig(), time_manager->getCurrentTimestampNs())) {
+    m_scheduler->setParentDoneHandler([this](const ParentOrderView& view) { onParentDone(view); });
 }
 
 AdvancedOrderExecutionEngine::~AdvancedOrderExecutionEngine() {
@@ -495,11 +497,8 @@ AdvancedOrderExecutionEngine::~AdvancedOrderExecutionEngine() {
 }
 
 bool AdvancedOrderExecutionEngine::initialize() {
-    // 创建各种订单执行器
-    m_executors[AdvancedOrderType::ICEBERG] = std::make_shared<IcebergOrderExecutor>(m_time_manager);
-    m_executors[AdvancedOrderType::TWAP] = std::make_shared<TwapOrderExecutor>(m_time_manager);
-    m_executors[AdvancedOrderType::VWAP] = std::make_shared<VwapOrderExecutor>(m_time_manager);
-    // 可以添加更多执行器...
+    // 冰山/TWAP/VWAP由共用调度器执行，不再各自创建执行器和线程
+    // 其他类型的执行器在此添加...
 
     // 初始化所有执行器
     for (auto& [type, executor] : m_executors) {
@@ -520,6 +519,9 @@ uint64_t AdvancedOrderExecutionEngine::executeOrder(std::shared_ptr<Order> order
     }
 
     AdvancedOrderType type = order->advanced_params->type;
+    if (isScheduled(type)) {
+        return submitToScheduler(order);
+    }
     auto it = m_executors.find(type);
     if (it == m_executors.end()) {
         std::cerr << "No executor found for order type: " << static_cast<int>(type) << std::endl;
@@ -542,12 +544,120 @@ uint64_t AdvancedOrderExecutionEngine::executeOrder(std::shared_ptr<Order> order
 }
 
 void AdvancedOrderExecutionEngine::onMarketDataUpdate(const market::MarketData& data) {
-    // 将市场数据更新传递给所有执行器
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_paused) {
+            m_scheduler->advance(m_time_manager->getCurrentTimestampNs());
+        }
+        // 未驻留的品种上不可能有母单或成交量曲线
+        core::SymbolId symbol = core::SymbolRegistry::symbols().find(data.symbol);
+        if (symbol != core::kInvalidSymbol) {
+            // 成交量无论有无母单都要累计，VWAP曲线和参与率依赖母单开始前的成交
+            if (data.volume > 0) {
+                m_scheduler->onTrade(symbol, data.last_price, data.volume, data.timestamp);
+            }
+            // 报价只驱动该品种上的母单
+            if (!m_paused && m_scheduler->activeParents(symbol) > 0) {
+                m_scheduler->onQuote(symbol, data.bid_price, data.bid_volume, data.ask_price, data.ask_volume);
+            }
+        }
+    }
+
+    // 其他执行器
     for (auto& [type, executor] : m_executors) {
         executor->onMarketDataUpdate(data);
     }
 }
 
+size_t AdvancedOrderExecutionEngine::poll() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_paused ? 0 : m_scheduler->advance(m_time_manager->getCurrentTimestampNs());
+}
+
+void AdvancedOrderExecutionEngine::onChildFill(uint64_t parent_id, uint64_t quantity, double price) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scheduler->onChildFill(parent_id, quantity, price);
+}
+
+void AdvancedOrderExecutionEngine::onChildClosed(uint64_t parent_id, uint64_t unfilled_quantity) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scheduler->onChildClosed(parent_id, unfilled_quantity);
+}
+
+void AdvancedOrderExecutionEngine::setParentDoneHandler(ExecutionScheduler::ParentDoneHandler handler) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_parent_done_handler = std::move(handler);
+}
+
+void AdvancedOrderExecutionEngine::onParentDone(const ParentOrderView& view) {
+    // 调度器只在持有m_mutex的调用中回调；撤单的映射由cancelOrder删除
+    if (view.status == ParentStatus::COMPLETED || view.status == ParentStatus::EXPIRED) {
+        m_order_type_map.erase(view.parentId);
+    }
+    if (m_parent_done_handler) {
+        m_parent_done_handler(view);
+    }
+}
+
+bool AdvancedOrderExecutionEngine::isScheduled(AdvancedOrderType type) const {
+    return type == AdvancedOrderType::ICEBERG || type == AdvancedOrderType::TWAP || type == AdvancedOrderType::VWAP;
+}
+
+uint64_t AdvancedOrderExecutionEngine::submitToScheduler(const std::shared_ptr<Order>& order) {
+    const uint64_t now = m_time_manager->getCurrentTimestampNs();
+    const auto& params = order->advanced_params;
+
+    ParentOrderSpec spec;
+    spec.symbolId = core::internSymbol(order->symbol);
+    if (spec.symbolId == core::kInvalidSymbol) {
+        std::cerr << "Advanced order rejected, invalid symbol: " << order->symbol << std::endl;
+        return 0;
+    }
+    spec.side = order->side;
+    spec.quantity = order->quantity;
+    spec.limitPrice = order->price;
+    // 过期时间为微秒
+    spec.endNs = params->expiration_time > 0 ? params->expiration_time * 1000 : 0;
+
+    switch (params->type) {
+        case AdvancedOrderType::TWAP: {
+            auto twap = std::static_pointer_cast<TwapOrderParams>(params);
+            spec.algo = ExecAlgo::TWAP;
+            spec.sliceIntervalMs = twap->time_interval_ms;
+            spec.endNs = now + static_cast<uint64_t>(twap->total_duration_ms) * 1000000;
+            break;
+        }
+        case AdvancedOrderType::VWAP: {
+            auto vwap = std::static_pointer_cast<VwapOrderParams>(params);
+            spec.algo = ExecAlgo::VWAP;
+            // lookback_period是历史成交量的回溯窗口，不是执行时长；VWAP必须给出过期时间
+            if (spec.endNs <= now) {
+                std::cerr << "VWAP order rejected, expiration_time is required and must be in the future: "
+                          << order->symbol << std::endl;
+                return 0;
+            }
+            break;
+        }
+        default: {
+            auto iceberg = std::static_pointer_cast<IcebergOrderParams>(params);
+            spec.algo = ExecAlgo::ICEBERG;
+            // minimum_size是最小显示数量，与IcebergOrderExecutor一致作为显示数量的下限
+            spec.displayQuantity = static_cast<uint64_t>(std::max(iceberg->visible_size, iceberg->minimum_size));
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scheduler->advance(now);
+    uint64_t parent_id = m_scheduler->submit(spec);
+    if (parent_id == 0) {
+        return 0;
+    }
+    order->orderId = parent_id;
+    m_order_type_map[parent_id] = params->type;
+    return parent_id;
+}
+
 bool AdvancedOrderExecutionEngine::cancelOrder(uint64_t order_id) {
     std::lock_guard<std::mutex> lock(m_mutex);
     auto it = m_order_type_map.find(order_id);
@@ -556,6 +666,12 @@ bool AdvancedOrderExecutionEngine::cancelOrder(uint64_t order_id) {
     }
 
     AdvancedOrderType type = it->second;
+    if (isScheduled(type)) {
+        // 调度器管理的订单ID即母单ID
+        bool canceled = m_scheduler->cancel(order_id);
+        m_order_type_map.erase(it);
+        return canceled;
+    }
     auto executor_it = m_executors.find(type);
     if (executor_it == m_executors.end()) {
         return false;
@@ -569,6 +685,10 @@ bool AdvancedOrderExecutionEngine::cancelOrder(uint64_t order_id) {
 }
 
 void AdvancedOrderExecutionEngine::pauseAll() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused = true;
+    }
     for (auto& [type, executor] : m_executors) {
         executor->pause();
     }
@@ -576,6 +696,10 @@ void AdvancedOrderExecutionEngine::pauseAll() {
 }
 
 void AdvancedOrderExecutionEngine::resumeAll() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_paused = false;
+    }
     for (auto& [type, executor] : m_executors) {
         executor->resume();
     }
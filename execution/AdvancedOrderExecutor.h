@@ -5,6 +5,7 @@
 #include <memory>
 #include "execution/Order.h"
 #include "execution/OrderTypes.h"
+#include "execution/ExecutionScheduler.h"
 #include "market/MarketData.h"
 #include "core/TimeManager.h"
 #include "utils/LockFreeQueue.h"
@@ -126,6 +127,8 @@ private:
 };
 
 // 高级订单执行引擎
+// TWAP/VWAP/冰山单交给共用的ExecutionScheduler（单一时间轮、按品种订阅行情），
+// 其他高级订单类型仍由各自的执行器处理。
 class AdvancedOrderExecutionEngine {
 public:
     AdvancedOrderExecutionEngine(core::TimeManager* time_manager);
@@ -143,11 +146,27 @@ public:
     void pauseAll();
     // 恢复所有执行
     void resumeAll();
+    // 无行情时推进调度器时钟，由执行事件循环周期调用
+    size_t poll();
+    // 调度器子单回报，经引擎转发以与行情、撤单串行
+    void onChildFill(uint64_t parent_id, uint64_t quantity, double price);
+    void onChildClosed(uint64_t parent_id, uint64_t unfilled_quantity);
+    // 母单结束回调；不要直接设置调度器的完成回调，引擎要借此清理订单类型映射
+    void setParentDoneHandler(ExecutionScheduler::ParentDoneHandler handler);
+    // 母单调度器（设置子单回调、配置成交量曲线；回报走引擎的onChildFill/onChildClosed）
+    ExecutionScheduler& scheduler() { return *m_scheduler; }
 
 private:
+    bool isScheduled(AdvancedOrderType type) const;
+    uint64_t submitToScheduler(const std::shared_ptr<Order>& order);
+    void onParentDone(const ParentOrderView& view);
+
     core::TimeManager* m_time_manager;
     std::unordered_map<AdvancedOrderType, std::shared_ptr<AdvancedOrderExecutor>> m_executors;
     std::unordered_map<uint64_t, AdvancedOrderType> m_order_type_map;
+    std::unique_ptr<ExecutionScheduler> m_scheduler;
+    ExecutionScheduler::ParentDoneHandler m_parent_done_handler;
+    bool m_paused = false;
     std::mutex m_mutex;
 };
 
@@ -0,0 +1,549 @@
+#include "ExecutionScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace hft {
+namespace execution {
+
+namespace {
+
+constexpr uint64_t kNsPerTick = 1000000;    // 时间轮精度：1毫秒
+
+} // namespace
+
+// --- VolumeCurve ---
+
+VolumeCurve::VolumeCurve()
+    : m_sessionStart(0), m_sessionEnd(0), m_bucketNs(0), m_todayTotal(0.0) {
+}
+
+void VolumeCurve::configure(uint64_t sessionStartNs, uint64_t sessionEndNs, size_t buckets) {
+    if (sessionEndNs <= sessionStartNs || buckets == 0) {
+        std::cerr << "Invalid volume curve session" << std::endl;
+        return;
+    }
+    m_sessionStart = sessionStartNs;
+    m_sessionEnd = sessionEndNs;
+    m_bucketNs = std::max<uint64_t>(1, (sessionEndNs - sessionStartNs) / buckets);
+    m_profile.assign(buckets, 1.0 / static_cast<double>(buckets));
+    m_today.assign(buckets, 0.0);
+    m_todayTotal = 0.0;
+    rebuildPrefix();
+}
+
+void VolumeCurve::setProfile(const std::vector<double>& volumes) {
+    if (volumes.size() != m_profile.size()) {
+        std::cerr << "Volume profile size mismatch: " << volumes.size() << " != " << m_profile.size() << std::endl;
+        return;
+    }
+    double total = 0.0;
+    for (double v : volumes) {
+        total += std::max(0.0, v);
+    }
+    if (total <= 0.0) {
+        return;
+    }
+    for (size_t i = 0; i < volumes.size(); ++i) {
+        m_profile[i] = std::max(0.0, volumes[i]) / total;
+    }
+    rebuildPrefix();
+}
+
+void VolumeCurve::addVolume(uint64_t timestampNs, double volume) {
+    if (m_today.empty() || timestampNs < m_sessionStart || timestampNs >= m_sessionEnd || volume <= 0.0) {
+        return;
+    }
+    const size_t bucket = std::min<size_t>((timestampNs - m_sessionStart) / m_bucketNs, m_today.size() - 1);
+    m_today[bucket] += volume;
+    m_todayTotal += volume;
+}
+
+void VolumeCurve::rollover(double alpha) {
+    if (m_todayTotal > 0.0) {
+        double total = 0.0;
+        for (size_t i = 0; i < m_profile.size(); ++i) {
+            m_profile[i] = (1.0 - alpha) * m_profile[i] + alpha * m_today[i] / m_todayTotal;
+            total += m_profile[i];
+        }
+        for (double& share : m_profile) {
+            share /= total;
+        }
+        rebuildPrefix();
+    }
+    std::fill(m_today.begin(), m_today.end(), 0.0);
+    m_todayTotal = 0.0;
+}
+
+double VolumeCurve::cumulative(uint64_t timestampNs) const {
+    if (m_prefix.empty() || timestampNs <= m_sessionStart) {
+        return 0.0;
+    }
+    if (timestampNs >= m_sessionEnd) {
+        return 1.0;
+    }
+    const uint64_t offset = timestampNs - m_sessionStart;
+    const size_t bucket = std::min<size_t>(offset / m_bucketNs, m_profile.size() - 1);
+    const double within = std::min(1.0, static_cast<double>(offset - bucket * m_bucketNs) / static_cast<double>(m_bucketNs));
+    return m_prefix[bucket] + m_profile[bucket] * within;
+}
+
+void VolumeCurve::rebuildPrefix() {
+    m_prefix.assign(m_profile.size() + 1, 0.0);
+    for (size_t i = 0; i < m_profile.size(); ++i) {
+        m_prefix[i + 1] = m_prefix[i] + m_profile[i];
+    }
+}
+
+// --- ExecutionScheduler ---
+
+ExecutionScheduler::ExecutionScheduler(const ExecutionSchedulerConfig& config, uint64_t nowNs)
+    // 每个母单同时只占用一个定时器；延迟开始的母单在启动回调中换挂周期定时器，需多留一个节点
+    : m_wheel(config.maxParents + 1, 0),
+      m_epochNs(nowNs),
+      m_nowNs(nowNs),
+      m_slots(config.maxParents),
+      m_freeHead(config.maxParents > 0 ? 0 : kNil),
+      m_activeCount(0),
+      m_symbols(config.maxSymbols),
+      m_nextChildId(1) {
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        m_slots[i].next = (i + 1 < m_slots.size()) ? static_cast<uint32_t>(i + 1) : kNil;
+    }
+}
+
+uint64_t ExecutionScheduler::tickOf(uint64_t timestampNs) const {
+    return timestampNs > m_epochNs ? (timestampNs - m_epochNs) / kNsPerTick : 0;
+}
+
+ExecutionScheduler::ParentSlot* ExecutionScheduler::lookup(uint64_t parentId, uint32_t& index) {
+    const uint64_t low = parentId & 0xFFFFFFFFull;
+    if (low == 0 || low > m_slots.size()) {
+        return nullptr;
+    }
+    index = static_cast<uint32_t>(low - 1);
+    ParentSlot& slot = m_slots[index];
+    if (slot.generation != static_cast<uint32_t>(parentId >> 32) || slot.status != ParentStatus::ACTIVE) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+const ExecutionScheduler::ParentSlot* ExecutionScheduler::lookup(uint64_t parentId) const {
+    uint32_t index;
+    return const_cast<ExecutionScheduler*>(this)->lookup(parentId, index);
+}
+
+uint64_t ExecutionScheduler::submit(const ParentOrderSpec& spec) {
+    if (spec.symbolId == core::kInvalidSymbol || spec.symbolId >= m_symbols.size() || spec.quantity == 0) {
+        std::cerr << "Invalid parent order: symbol " << spec.symbolId << " quantity " << spec.quantity << std::endl;
+        return 0;
+    }
+    if (spec.algo == ExecAlgo::ICEBERG) {
+        if (spec.displayQuantity == 0) {
+            std::cerr << "Iceberg parent order requires displayQuantity" << std::endl;
+            return 0;
+        }
+    } else if (spec.sliceIntervalMs == 0 || spec.endNs <= std::max(spec.startNs, m_nowNs)) {
+        std::cerr << "TWAP/VWAP parent order requires endNs in the future and a slice interval" << std::endl;
+        return 0;
+    }
+    if (m_freeHead == kNil) {
+        std::cerr << "Execution scheduler parent pool exhausted" << std::endl;
+        return 0;
+    }
+
+    const uint32_t index = m_freeHead;
+    ParentSlot& slot = m_slots[index];
+    m_freeHead = slot.next;
+
+    const uint32_t generation = slot.generation;
+    slot = ParentSlot();
+    slot.generation = generation;
+    slot.spec = spec;
+    slot.status = ParentStatus::ACTIVE;
+    linkSymbol(index);
+    ++m_activeCount;
+
+    if (spec.startNs > m_nowNs) {
+        slot.timer = m_wheel.schedule([this, index, generation] {
+            if (m_slots[index].generation == generation && m_slots[index].status == ParentStatus::ACTIVE) {
+                start(index);
+            }
+        }, tickOf(spec.startNs));
+    } else {
+        start(index);
+    }
+    return makeId(index, generation);
+}
+
+bool ExecutionScheduler::cancel(uint64_t parentId) {
+    uint32_t index;
+    if (!lookup(parentId, index)) {
+        return false;
+    }
+    finish(index, ParentStatus::CANCELLED);
+    return true;
+}
+
+size_t ExecutionScheduler::advance(uint64_t nowNs) {
+    if (nowNs > m_nowNs) {
+        m_nowNs = nowNs;
+    }
+    return m_wheel.advance(tickOf(m_nowNs));
+}
+
+void ExecutionScheduler::start(uint32_t index) {
+    ParentSlot& slot = m_slots[index];
+    const uint32_t generation = slot.generation;
+    SymbolState& symbol = m_symbols[slot.spec.symbolId];
+    slot.started = true;
+    slot.timer = core::TimerWheel::kInvalidTimer;
+    if (slot.spec.startNs == 0 || slot.spec.startNs < m_nowNs) {
+        slot.spec.startNs = m_nowNs;
+    }
+    slot.volumeAtStart = symbol.cumulativeVolume;
+
+    // 先挂定时器再发首个子单：子单回调里同步成交完毕时finish()能一并取消定时器
+    bool needsTimer = true;
+    if (slot.spec.algo == ExecAlgo::ICEBERG) {
+        needsTimer = slot.spec.endNs > 0;
+        if (needsTimer) {
+            slot.timer = m_wheel.schedule([this, index, generation] { onTimer(index, generation); },
+                                          tickOf(slot.spec.endNs));
+        }
+    } else {
+        const uint64_t interval = slot.spec.sliceIntervalMs;   // 1 tick = 1ms
+        slot.timer = m_wheel.schedule([this, index, generation] { onTimer(index, generation); },
+                                      tickOf(m_nowNs) + interval, interval);
+    }
+    if (needsTimer && slot.timer == core::TimerWheel::kInvalidTimer) {
+        std::cerr << "Execution scheduler timer pool exhausted" << std::endl;
+        finish(index, ParentStatus::CANCELLED);
+        return;
+    }
+    evaluate(index, false);
+}
+
+void ExecutionScheduler::onTimer(uint32_t index, uint32_t generation) {
+    ParentSlot& slot = m_slots[index];
+    if (slot.generation != generation || slot.status != ParentStatus::ACTIVE) {
+        return;
+    }
+
+    if (slot.spec.algo == ExecAlgo::ICEBERG) {
+        // 冰山单只在过期时触发
+        finish(index, ParentStatus::EXPIRED);
+        return;
+    }
+
+    if (m_nowNs + kNsPerTick / 2 < slot.spec.endNs) {
+        evaluate(index, false);
+        return;
+    }
+    // 到达结束时间：发出全部剩余数量一次，之后在途子单结束即到期
+    if (!slot.finalSent) {
+        slot.finalSent = true;
+        evaluate(index, true);
+        if (slot.generation == generation && slot.status == ParentStatus::ACTIVE && slot.working > 0) {
+            return;
+        }
+    }
+    if (slot.generation == generation && slot.status == ParentStatus::ACTIVE && slot.working == 0) {
+        finish(index, ParentStatus::EXPIRED);
+    }
+}
+
+uint64_t ExecutionScheduler::targetQuantity(const ParentSlot& slot, const SymbolState& symbol, bool final) const {
+    const ParentOrderSpec& spec = slot.spec;
+    if (final) {
+        return spec.quantity;
+    }
+    // 目标进度取到下一个切片时刻，使最后一片落在结束时间之前
+    const uint64_t horizon = m_nowNs + static_cast<uint64_t>(spec.sliceIntervalMs) * kNsPerTick;
+    double fraction = 0.0;
+    const VolumeCurve* curve = symbol.curve.get();
+    if (spec.algo == ExecAlgo::VWAP && curve && curve->configured()) {
+        const double begin = curve->cumulative(spec.startNs);
+        const double span = curve->cumulative(spec.endNs) - begin;
+        if (span > 0.0) {
+            fraction = (curve->cumulative(horizon) - begin) / span;
+        }
+    }
+    if (fraction <= 0.0 && (spec.algo == ExecAlgo::TWAP || !curve || !curve->configured())) {
+        fraction = static_cast<double>(std::min(horizon, spec.endNs) - spec.startNs) /
+                   static_cast<double>(spec.endNs - spec.startNs);
+    }
+    fraction = std::min(1.0, std::max(0.0, fraction));
+    // 向下取整，容忍累计比例的舍入误差
+    return static_cast<uint64_t>(std::floor(static_cast<double>(spec.quantity) * fraction + 1e-9));
+}
+
+void ExecutionScheduler::evaluate(uint32_t index, bool final) {
+    ParentSlot& slot = m_slots[index];
+    const ParentOrderSpec& spec = slot.spec;
+    SymbolState& symbol = m_symbols[spec.symbolId];
+    const bool buy = spec.side == OrderSide::BUY;
+    const uint64_t committed = slot.filled + slot.working;
+    if (committed >= spec.quantity) {
+        slot.waiting = false;
+        return;
+    }
+    const uint64_t remaining = spec.quantity - committed;
+
+    if (spec.algo == ExecAlgo::ICEBERG) {
+        // 当前显示部分成交完后才补单，挂在限价或本方一档
+        if (slot.working > 0) {
+            return;
+        }
+        const double price = spec.limitPrice > 0.0 ? spec.limitPrice : (buy ? symbol.bidPrice : symbol.askPrice);
+        slot.waiting = price <= 0.0;
+        if (!slot.waiting) {
+            sendChild(index, std::min(spec.displayQuantity, remaining), price);
+        }
+        return;
+    }
+
+    const uint64_t target = targetQuantity(slot, symbol, final);
+    uint64_t quantity = target > committed ? target - committed : 0;
+    if (quantity == 0) {
+        slot.waiting = false;
+        return;
+    }
+    const uint64_t desired = quantity;
+
+    // 参与率：不超过开始以来市场成交量的一定比例
+    if (spec.participationRate > 0.0 && !final) {
+        const double allowed = spec.participationRate * (symbol.cumulativeVolume - slot.volumeAtStart);
+        const uint64_t cap = allowed > static_cast<double>(committed) ?
+                             static_cast<uint64_t>(allowed) - committed : 0;
+        quantity = std::min(quantity, cap);
+    }
+
+    // 价格：对手方一档（可立即成交），越过限价时退回限价挂单
+    double touch = buy ? symbol.askPrice : symbol.bidPrice;
+    const double touchSize = buy ? symbol.askSize : symbol.bidSize;
+    double price = touch;
+    bool atTouch = touch > 0.0;
+    if (spec.limitPrice > 0.0 && (!atTouch || (buy ? touch > spec.limitPrice : touch < spec.limitPrice))) {
+        price = spec.limitPrice;
+        atTouch = false;
+    }
+    if (price <= 0.0) {
+        slot.waiting = true;
+        return;
+    }
+    // 盘口深度：吃单不超过对手方一档挂单量的一定比例，已在同一价位上的在途子单占用其中一部分
+    const uint64_t touchWorking = atTouch && price == slot.touchPrice ? std::min(slot.touchWorking, slot.working) : 0;
+    if (atTouch && spec.depthFraction > 0.0 && !final) {
+        const uint64_t depth = static_cast<uint64_t>(spec.depthFraction * touchSize);
+        quantity = std::min(quantity, depth > touchWorking ? depth - touchWorking : 0);
+    }
+
+    if (quantity == 0 || (quantity < spec.minSliceQuantity && quantity < remaining && !final)) {
+        slot.waiting = true;
+        return;
+    }
+    slot.waiting = quantity < desired;
+    if (atTouch) {
+        slot.touchPrice = price;
+        slot.touchWorking = touchWorking + quantity;
+    }
+    sendChild(index, quantity, price);
+}
+
+void ExecutionScheduler::sendChild(uint32_t index, uint64_t quantity, double price) {
+    ParentSlot& slot = m_slots[index];
+    OrderRecord child;
+    std::memset(&child, 0, sizeof(child));
+    child.orderId = m_nextChildId++;
+    child.symbolId = slot.spec.symbolId;
+    child.type = OrderType::LIMIT;
+    child.side = slot.spec.side;
+    child.status = OrderStatus::PENDING_NEW;
+    child.strategyId = slot.spec.strategyId;
+    child.quantity = quantity;
+    child.price = price;
+    child.parentOrderId = makeId(index, slot.generation);
+    child.timestamp = m_nowNs;
+
+    slot.working += quantity;
+    ++slot.childOrders;
+    if (m_childHandler) {
+        m_childHandler(child);
+    }
+}
+
+void ExecutionScheduler::onChildFill(uint64_t parentId, uint64_t quantity, double price) {
+    uint32_t index;
+    ParentSlot* slot = lookup(parentId, index);
+    if (!slot || quantity == 0) {
+        return;
+    }
+    slot->filled += quantity;
+    slot->working -= std::min(slot->working, quantity);
+    slot->fillNotional += static_cast<double>(quantity) * price;
+    if (slot->filled >= slot->spec.quantity) {
+        finish(index, ParentStatus::COMPLETED);
+    } else if (slot->spec.algo == ExecAlgo::ICEBERG && slot->working == 0) {
+        evaluate(index, false);
+    }
+}
+
+void ExecutionScheduler::onChildClosed(uint64_t parentId, uint64_t unfilledQuantity) {
+    uint32_t index;
+    ParentSlot* slot = lookup(parentId, index);
+    if (!slot) {
+        return;
+    }
+    slot->working -= std::min(slot->working, unfilledQuantity);
+    if (slot->working == 0) {
+        if (slot->finalSent) {
+            finish(index, ParentStatus::EXPIRED);
+        } else if (slot->spec.algo == ExecAlgo::ICEBERG) {
+            evaluate(index, false);
+        }
+    }
+}
+
+void ExecutionScheduler::onQuote(core::SymbolId symbolId, double bidPrice, double bidSize,
+                                 double askPrice, double askSize) {
+    if (symbolId >= m_symbols.size()) {
+        return;
+    }
+    SymbolState& symbol = m_symbols[symbolId];
+    symbol.bidPrice = bidPrice;
+    symbol.bidSize = bidSize;
+    symbol.askPrice = askPrice;
+    symbol.askSize = askSize;
+    if (symbol.count > 0) {
+        wakeWaiting(symbol);
+    }
+}
+
+void ExecutionScheduler::onTrade(core::SymbolId symbolId, double price, double volume, uint64_t timestampNs) {
+    (void)price;
+    if (symbolId >= m_symbols.size()) {
+        return;
+    }
+    SymbolState& symbol = m_symbols[symbolId];
+    symbol.cumulativeVolume += volume;
+    if (symbol.curve) {
+        symbol.curve->addVolume(timestampNs, volume);
+    }
+    if (symbol.count > 0) {
+        wakeWaiting(symbol);
+    }
+}
+
+void ExecutionScheduler::wakeWaiting(SymbolState& symbol) {
+    uint32_t index = symbol.head;
+    while (index != kNil) {
+        ParentSlot& slot = m_slots[index];
+        const uint32_t following = slot.next;
+        const uint32_t followingGeneration = following != kNil ? m_slots[following].generation : 0;
+        if (slot.waiting && slot.started) {
+            evaluate(index, m_nowNs >= slot.spec.endNs && slot.spec.algo != ExecAlgo::ICEBERG);
+        }
+        // 回调中链表被修改（其他母单结束）时从头重来；evaluate可重入，只发缺口部分
+        if (following != kNil && (m_slots[following].generation != followingGeneration ||
+                                  m_slots[following].status != ParentStatus::ACTIVE)) {
+            index = symbol.head;
+            continue;
+        }
+        index = following;
+    }
+}
+
+void ExecutionScheduler::finish(uint32_t index, ParentStatus status) {
+    ParentSlot& slot = m_slots[index];
+    if (slot.timer != core::TimerWheel::kInvalidTimer) {
+        m_wheel.cancel(slot.timer);
+        slot.timer = core::TimerWheel::kInvalidTimer;
+    }
+    ParentOrderView done = makeView(index);
+    done.status = status;
+
+    unlinkSymbol(index);
+    slot.status = ParentStatus::FREE;
+    slot.waiting = false;
+    ++slot.generation;
+    slot.next = m_freeHead;
+    m_freeHead = index;
+    --m_activeCount;
+
+    if (m_doneHandler) {
+        m_doneHandler(done);
+    }
+}
+
+void ExecutionScheduler::linkSymbol(uint32_t index) {
+    ParentSlot& slot = m_slots[index];
+    SymbolState& symbol = m_symbols[slot.spec.symbolId];
+    slot.prev = kNil;
+    slot.next = symbol.head;
+    if (symbol.head != kNil) {
+        m_slots[symbol.head].prev = index;
+    }
+    symbol.head = index;
+    ++symbol.count;
+}
+
+void ExecutionScheduler::unlinkSymbol(uint32_t index) {
+    ParentSlot& slot = m_slots[index];
+    SymbolState& symbol = m_symbols[slot.spec.symbolId];
+    if (slot.prev != kNil) {
+        m_slots[slot.prev].next = slot.next;
+    } else {
+        symbol.head = slot.next;
+    }
+    if (slot.next != kNil) {
+        m_slots[slot.next].prev = slot.prev;
+    }
+    slot.prev = kNil;
+    slot.next = kNil;
+    --symbol.count;
+}
+
+VolumeCurve* ExecutionScheduler::volumeCurve(core::SymbolId symbolId) {
+    if (symbolId == core::kInvalidSymbol || symbolId >= m_symbols.size()) {
+        return nullptr;
+    }
+    SymbolState& symbol = m_symbols[symbolId];
+    if (!symbol.curve) {
+        symbol.curve.reset(new VolumeCurve());
+    }
+    return symbol.curve.get();
+}
+
+ParentOrderView ExecutionScheduler::makeView(uint32_t index) const {
+    const ParentSlot& slot = m_slots[index];
+    ParentOrderView view;
+    view.parentId = makeId(index, slot.generation);
+    view.status = slot.status;
+    view.algo = slot.spec.algo;
+    view.symbolId = slot.spec.symbolId;
+    view.quantity = slot.spec.quantity;
+    view.filled = slot.filled;
+    view.working = slot.working;
+    view.childOrders = slot.childOrders;
+    view.avgFillPrice = slot.filled > 0 ? slot.fillNotional / static_cast<double>(slot.filled) : 0.0;
+    return view;
+}
+
+bool ExecutionScheduler::view(uint64_t parentId, ParentOrderView& out) const {
+    const ParentSlot* slot = lookup(parentId);
+    if (!slot) {
+        return false;
+    }
+    out = makeView(static_cast<uint32_t>((parentId & 0xFFFFFFFFull) - 1));
+    return true;
+}
+
+size_t ExecutionScheduler::activeParents(core::SymbolId symbolId) const {
+    return symbolId < m_symbols.size() ? m_symbols[symbolId].count : 0;
+}
+
+} // namespace execution
+} // namespace hft
@@ -0,0 +1,211 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "execution/Order.h"
+#include "core/SymbolRegistry.h"
+#include "core/TimerWheel.h"
+
+namespace hft {
+namespace execution {
+
+// 母单执行算法
+enum class ExecAlgo : uint8_t {
+    TWAP,
+    VWAP,
+    ICEBERG
+};
+
+enum class ParentStatus : uint8_t {
+    FREE,           // 槽位空闲
+    ACTIVE,
+    COMPLETED,      // 全部成交
+    CANCELLED,
+    EXPIRED         // 到期仍未全部成交
+};
+
+// 日内成交量分布曲线
+// 交易时段均分为若干桶，保存各桶的历史成交量占比及其前缀和，cumulative()为O(1)；
+// 当日实际成交量按桶累加，收盘后rollover()以指数平滑并入历史分布，只重算一次前缀和。
+class VolumeCurve {
+public:
+    VolumeCurve();
+
+    // 设置交易时段（纳秒时间戳）与分桶数，历史分布重置为均匀
+    void configure(uint64_t sessionStartNs, uint64_t sessionEndNs, size_t buckets);
+    // 设置历史分布（各桶成交量，会归一化）
+    void setProfile(const std::vector<double>& volumes);
+    // 累加当日成交量
+    void addVolume(uint64_t timestampNs, double volume);
+    // 当日结束：按权重alpha把当日分布并入历史分布
+    void rollover(double alpha);
+
+    // 截至timestampNs的预期累计成交比例（0-1，桶内线性插值）
+    double cumulative(uint64_t timestampNs) const;
+    double todayVolume() const { return m_todayTotal; }
+    bool configured() const { return !m_prefix.empty(); }
+
+private:
+    void rebuildPrefix();
+
+    uint64_t m_sessionStart;
+    uint64_t m_sessionEnd;
+    uint64_t m_bucketNs;
+    std::vector<double> m_profile;  // 各桶占比
+    std::vector<double> m_prefix;   // m_prefix[i] = 前i个桶占比之和，长度为桶数+1
+    std::vector<double> m_today;    // 当日各桶成交量
+    double m_todayTotal;
+};
+
+// 母单参数
+struct ParentOrderSpec {
+    core::SymbolId symbolId = core::kInvalidSymbol;
+    OrderSide side = OrderSide::BUY;
+    ExecAlgo algo = ExecAlgo::TWAP;
+    uint64_t quantity = 0;
+    double limitPrice = 0.0;            // 0表示不限价
+    uint64_t startNs = 0;               // 0表示立即开始
+    uint64_t endNs = 0;                 // TWAP/VWAP必填；冰山单为0表示不过期
+    uint32_t sliceIntervalMs = 1000;    // TWAP/VWAP子单间隔
+    double participationRate = 0.0;     // 不超过开始后市场成交量的比例，0表示不限制
+    double depthFraction = 1.0;         // 子单不超过对手方一档挂单量的比例，0表示不限制
+    uint64_t minSliceQuantity = 1;      // 小于此数量的子单推迟发送（最后一笔除外）
+    uint64_t displayQuantity = 0;       // 冰山单每次显示数量
+    uint32_t strategyId = 0;
+};
+
+// 母单执行情况
+struct ParentOrderView {
+    uint64_t parentId = 0;
+    ParentStatus status = ParentStatus::FREE;
+    ExecAlgo algo = ExecAlgo::TWAP;
+    core::SymbolId symbolId = core::kInvalidSymbol;
+    uint64_t quantity = 0;
+    uint64_t filled = 0;
+    uint64_t working = 0;               // 已发出未结束的子单数量
+    uint32_t childOrders = 0;
+    double avgFillPrice = 0.0;
+};
+
+struct ExecutionSchedulerConfig {
+    size_t maxParents = 4096;
+    size_t maxSymbols = 1 << 16;        // SymbolId上限
+};
+
+// 执行调度器
+//
+//  - 所有母单共用一个毫秒级时间轮，TWAP/VWAP各注册一个周期定时器，没有独立线程
+//  - 母单状态放在预分配的槽位池中，母单ID含代数，槽位复用后旧ID自动失效
+//  - 每个品种维护一条母单链表，行情只驱动该品种上的母单
+//  - 子单数量 = 目标进度（时间或成交量曲线）- 已成交 - 在途，
+//    再受市场成交量参与率与对手方一档挂单量约束；冰山单在当前子单成交完后补单
+//
+// 非线程安全：advance、行情、回报通知需在同一线程调用（通常是执行事件循环）。
+class ExecutionScheduler {
+public:
+    // 子单回调：record.parentOrderId为母单ID，record.orderId为子单ID
+    using ChildOrderHandler = std::function<void(const OrderRecord&)>;
+    // 母单结束回调
+    using ParentDoneHandler = std::function<void(const ParentOrderView&)>;
+
+    ExecutionScheduler(const ExecutionSchedulerConfig& config, uint64_t nowNs);
+
+    ExecutionScheduler(const ExecutionScheduler&) = delete;
+    ExecutionScheduler& operator=(const ExecutionScheduler&) = delete;
+
+    void setChildOrderHandler(ChildOrderHandler handler) { m_childHandler = std::move(handler); }
+    void setParentDoneHandler(ParentDoneHandler handler) { m_doneHandler = std::move(handler); }
+
+    // 提交母单，失败（参数无效或槽位用尽）返回0
+    uint64_t submit(const ParentOrderSpec& spec);
+    // 撤销母单，在途子单由调用方撤销并通过onChildClosed回报
+    bool cancel(uint64_t parentId);
+
+    // 推进时钟并触发到期的切片
+    size_t advance(uint64_t nowNs);
+
+    // 行情：一档报价与成交
+    void onQuote(core::SymbolId symbol, double bidPrice, double bidSize, double askPrice, double askSize);
+    void onTrade(core::SymbolId symbol, double price, double volume, uint64_t timestampNs);
+
+    // 子单回报
+    void onChildFill(uint64_t parentId, uint64_t quantity, double price);
+    void onChildClosed(uint64_t parentId, uint64_t unfilledQuantity);
+
+    // 品种成交量曲线，用于VWAP；首次访问时创建，品种ID无效返回nullptr
+    VolumeCurve* volumeCurve(core::SymbolId symbol);
+
+    bool view(uint64_t parentId, ParentOrderView& out) const;
+    size_t activeParents() const { return m_activeCount; }
+    size_t activeParents(core::SymbolId symbol) const;
+    uint64_t nowNs() const { return m_nowNs; }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct ParentSlot {
+        ParentOrderSpec spec;
+        ParentStatus status = ParentStatus::FREE;
+        uint32_t generation = 0;
+        uint32_t prev = kNil;           // 品种链表
+        uint32_t next = kNil;           // 品种链表，空闲时为空闲链表
+        core::TimerWheel::TimerId timer = core::TimerWheel::kInvalidTimer;
+        uint64_t filled = 0;
+        uint64_t working = 0;
+        double touchPrice = 0.0;        // 最近一次按对手价发出子单的价格
+        uint64_t touchWorking = 0;      // 在touchPrice上发出且可能仍在途的数量（不超过working）
+        double fillNotional = 0.0;
+        double volumeAtStart = 0.0;     // 开始时品种累计成交量
+        uint32_t childOrders = 0;
+        bool waiting = false;           // 上次切片受行情约束未发足，行情变化时重试
+        bool started = false;
+        bool finalSent = false;         // 已在结束时间发出剩余数量
+    };
+
+    struct SymbolState {
+        uint32_t head = kNil;
+        uint32_t count = 0;
+        double bidPrice = 0.0;
+        double bidSize = 0.0;
+        double askPrice = 0.0;
+        double askSize = 0.0;
+        double cumulativeVolume = 0.0;
+        std::unique_ptr<VolumeCurve> curve;     // 只有VWAP用到的品种才分配
+    };
+
+    static uint64_t makeId(uint32_t index, uint32_t generation) {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(index) + 1);
+    }
+    ParentSlot* lookup(uint64_t parentId, uint32_t& index);
+    const ParentSlot* lookup(uint64_t parentId) const;
+    uint64_t tickOf(uint64_t timestampNs) const;
+
+    void start(uint32_t index);
+    void onTimer(uint32_t index, uint32_t generation);
+    void evaluate(uint32_t index, bool final);
+    uint64_t targetQuantity(const ParentSlot& slot, const SymbolState& symbol, bool final) const;
+    void sendChild(uint32_t index, uint64_t quantity, double price);
+    void finish(uint32_t index, ParentStatus status);
+    void wakeWaiting(SymbolState& symbol);
+
+    void linkSymbol(uint32_t index);
+    void unlinkSymbol(uint32_t index);
+    ParentOrderView makeView(uint32_t index) const;
+
+    core::TimerWheel m_wheel;
+    uint64_t m_epochNs;                 // 时间轮tick 0对应的时间
+    uint64_t m_nowNs;
+    std::vector<ParentSlot> m_slots;
+    uint32_t m_freeHead;
+    size_t m_activeCount;
+    std::vector<SymbolState> m_symbols;
+    uint64_t m_nextChildId;
+
+    ChildOrderHandler m_childHandler;
+    ParentDoneHandler m_doneHandler;
+};
+
+} // namespace execution
+} // namespace hft
@@ -2,10 +2,12 @@
 #include <cstdint>
 #include <string>
 #include <memory>
+#include <type_traits>
+#include "core/SymbolRegistry.h"
 
 namespace hft {
 
-enum class OrderType {
+enum class OrderType : uint8_t {
     MARKET,
     LIMIT,
     STOP,
@@ -13,12 +15,12 @@ enum class OrderType {
     ICEBERG
 };
 
-enum class OrderSide {
+enum class OrderSide : uint8_t {
     BUY,
     SELL
 };
 
-enum class OrderStatus {
+enum class OrderStatus : uint8_t {
     PENDING_NEW,
     NEW,
     FILLED,
@@ -49,4 +51,88 @@ struct Order {
 
 typedef std::shared_ptr<Order> OrderPtr;
 
+// 定长订单记录
+// 可平凡拷贝、按缓存行对齐，标的与交易所为驻留后的整数ID。
+// 热路径（队列、风控、线路编码）按值传递OrderRecord，不分配内存、无引用计数；
+// 只在API边界与Order/OrderPtr互相转换。
+// 第一个缓存行存放下单与风控需要的字段，第二个缓存行存放成交回报相关字段。
+struct alignas(64) OrderRecord {
+    // --- 缓存行0：下单字段 ---
+    uint64_t orderId;
+    core::SymbolId symbolId;
+    core::VenueId venueId;
+    OrderType type;
+    OrderSide side;
+    OrderStatus status;
+    uint8_t flags;
+    uint16_t reserved0;
+    uint32_t strategyId;
+    uint64_t quantity;
+    double price;
+    double stopPrice;
+    uint64_t displayQuantity;  // For iceberg orders
+    uint64_t timestamp;
+
+    // --- 缓存行1：执行状态 ---
+    uint64_t filledQuantity;
+    double avgFillPrice;
+    uint64_t parentOrderId;    // 拆单时的母单ID
+    uint64_t lastUpdateTime;
+    uint64_t reserved1[4];
+
+    uint64_t remainingQuantity() const {
+        return quantity > filledQuantity ? quantity - filledQuantity : 0;
+    }
+};
+
+static_assert(std::is_trivially_copyable<OrderRecord>::value, "OrderRecord must be trivially copyable");
+static_assert(sizeof(OrderRecord) == 128, "OrderRecord must span exactly two cache lines");
+
+// 订单与定长记录互转（API边界使用）。
+// 标的无法驻留（为空、超长或注册表已满）或交易所名称无法驻留时返回false，
+// 调用方应拒绝该订单，而不是发出一个没有标的的记录
+inline bool toOrderRecord(const Order& order, OrderRecord& record) {
+    record = OrderRecord{};
+    record.symbolId = core::internSymbol(order.symbol);
+    record.venueId = order.exchange.empty() ? core::kInvalidVenue : core::internVenue(order.exchange);
+    if (record.symbolId == core::kInvalidSymbol ||
+        (!order.exchange.empty() && record.venueId == core::kInvalidVenue)) {
+        return false;
+    }
+    record.orderId = order.orderId;
+    record.type = order.type;
+    record.side = order.side;
+    record.status = order.status;
+    record.quantity = order.quantity;
+    record.price = order.price;
+    record.stopPrice = order.stopPrice;
+    record.displayQuantity = order.displayQuantity;
+    record.timestamp = order.timestamp;
+    record.filledQuantity = order.filledQuantity;
+    record.avgFillPrice = order.avgFillPrice;
+    return true;
+}
+
+inline Order toOrder(const OrderRecord& record) {
+    Order order;
+    order.orderId = record.orderId;
+    order.symbol = std::string(core::symbolName(record.symbolId));
+    order.exchange = std::string(core::venueName(record.venueId));
+    order.type = record.type;
+    order.side = record.side;
+    order.status = record.status;
+    order.quantity = record.quantity;
+    order.price = record.price;
+    order.stopPrice = record.stopPrice;
+    order.displayQuantity = record.displayQuantity;
+    order.timestamp = record.timestamp;
+    order.filledQuantity = record.filledQuantity;
+    order.avgFillPrice = record.avgFillPrice;
+    return order;
+}
+
+inline OrderPtr toOrderPtr(const OrderRecord& record) {
+    return std::make_shared<Order>(toOrder(record));
+}
+
 } // namespace hft
\ No newline at end of file
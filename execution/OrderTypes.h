@@ -51,7 +51,7 @@ struct TwapOrderParams : public AdvancedOrderParams {
     double random_factor;       // 随机因子(0-1)
 };
 
-// VWAP订单参数
+// VWAP订单参数（执行时长由expiration_time决定，必须设置）
 struct VwapOrderParams : public AdvancedOrderParams {
     uint32_t lookback_period;   // 回溯周期(秒)
     bool use_historical_volume; // 是否使用历史成交量
@@ -74,9 +74,9 @@ bool PhotonicEngine::sendOrder(const Order& order) {
 
     if (success) {
         pulseCount++;
-        logger->log(LogLevel::DEBUG, "Order sent successfully, latency: " + std::to_string(lastSendTimestamp) + " ns");
+        LLOG(*logger, LogLevel::DEBUG, "Order sent successfully, latency: {} ns", lastSendTimestamp);
     } else {
-        logger->log(LogLevel::ERROR, "Failed to send order");
+        LLOG(*logger, LogLevel::ERROR, "Failed to send order");
     }
 
     return success;
@@ -0,0 +1,526 @@
+#include "VectorKernels.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#if HFT_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace hft {
+namespace hardware {
+
+namespace {
+
+// Cephes expf/logf常数
+constexpr float kExpHi = 88.37f;                // 保证 round(x·log2e) <= 127
+constexpr float kExpLo = -87.3365478515625f;
+constexpr float kLog2e = 1.44269504088896341f;
+constexpr float kLn2Hi = 0.693359375f;
+constexpr float kLn2Lo = -2.12194440e-4f;
+constexpr float kSqrtHalf = 0.707106781186547524f;
+constexpr float kMinNormal = 1.17549435e-38f;
+
+constexpr float kExpP0 = 1.9875691500e-4f;
+constexpr float kExpP1 = 1.3981999507e-3f;
+constexpr float kExpP2 = 8.3334519073e-3f;
+constexpr float kExpP3 = 4.1665795894e-2f;
+constexpr float kExpP4 = 1.6666665459e-1f;
+constexpr float kExpP5 = 5.0000001201e-1f;
+
+constexpr float kLogP0 = 7.0376836292e-2f;
+constexpr float kLogP1 = -1.1514610310e-1f;
+constexpr float kLogP2 = 1.1676998740e-1f;
+constexpr float kLogP3 = -1.2420140846e-1f;
+constexpr float kLogP4 = 1.4249322787e-1f;
+constexpr float kLogP5 = -1.6668057665e-1f;
+constexpr float kLogP6 = 2.0000714765e-1f;
+constexpr float kLogP7 = -2.4999993993e-1f;
+constexpr float kLogP8 = 3.3333331174e-1f;
+
+// ---------------- 标量 ----------------
+
+void expScalar(const float* input, float* output, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        output[i] = std::exp(input[i]);
+    }
+}
+
+void logScalar(const float* input, float* output, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        output[i] = std::log(input[i]);
+    }
+}
+
+void featuresScalar(const float* input, float* output, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        const float x = input[i];
+        output[i] = 0.5f * x * x + 0.3f * std::log(x);
+    }
+}
+
+float vwapScalar(const float* prices, const float* volumes, size_t size) {
+    double notional = 0.0;
+    double volume = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        notional += static_cast<double>(prices[i]) * volumes[i];
+        volume += volumes[i];
+    }
+    return volume > 0.0 ? static_cast<float>(notional / volume) : 0.0f;
+}
+
+float volatilityScalar(const float* returns, size_t size) {
+    if (size == 0) {
+        return 0.0f;
+    }
+    double sum = 0.0;
+    double sumSq = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        sum += returns[i];
+        sumSq += static_cast<double>(returns[i]) * returns[i];
+    }
+    const double mean = sum / size;
+    const double variance = sumSq / size - mean * mean;
+    return variance > 0.0 ? static_cast<float>(std::sqrt(variance)) : 0.0f;
+}
+
+float momentumScalar(const float* prices, size_t size, size_t lag) {
+    if (lag == 0 || size <= lag) {
+        return 0.0f;
+    }
+    double sum = 0.0;
+    for (size_t i = lag; i < size; ++i) {
+        sum += prices[i] / prices[i - lag] - 1.0f;
+    }
+    return static_cast<float>(sum / (size - lag));
+}
+
+float orderImbalanceScalar(const float* bidSizes, const float* askSizes, size_t size) {
+    double bid = 0.0;
+    double ask = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        bid += bidSizes[i];
+        ask += askSizes[i];
+    }
+    return bid + ask > 0.0 ? static_cast<float>((bid - ask) / (bid + ask)) : 0.0f;
+}
+
+#if HFT_SIMD_DISPATCH
+
+// ---------------- AVX2 ----------------
+
+HFT_TARGET_AVX2 inline __m256 exp256(__m256 x) {
+    x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(kExpLo)), _mm256_set1_ps(kExpHi));
+    const __m256 fx = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(kLog2e)),
+                                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(kLn2Hi), x);
+    x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(kLn2Lo), x);
+
+    const __m256 z = _mm256_mul_ps(x, x);
+    __m256 y = _mm256_set1_ps(kExpP0);
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP1));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP2));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP3));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP4));
+    y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kExpP5));
+    y = _mm256_add_ps(_mm256_fmadd_ps(y, z, x), _mm256_set1_ps(1.0f));
+
+    // 2^fx 直接构造指数位
+    const __m256i exponent = _mm256_slli_epi32(
+        _mm256_add_epi32(_mm256_cvtps_epi32(fx), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(y, _mm256_castsi256_ps(exponent));
+}
+
+HFT_TARGET_AVX2 inline __m256 log256(__m256 x) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 invalid = _mm256_cmp_ps(x, zero, _CMP_NGE_UQ);     // 负数或NaN
+    const __m256 isZero = _mm256_cmp_ps(x, zero, _CMP_EQ_OQ);
+    const __m256 isInf = _mm256_cmp_ps(x, _mm256_set1_ps(std::numeric_limits<float>::infinity()), _CMP_EQ_OQ);
+
+    x = _mm256_max_ps(x, _mm256_set1_ps(kMinNormal));
+    // 拆成 m·2^e，m∈[0.5, 1)
+    const __m256i bits = _mm256_castps_si256(x);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+    __m256 m = _mm256_or_ps(_mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(~0x7f800000))),
+                            _mm256_set1_ps(0.5f));
+
+    // m < sqrt(0.5) 时改用 2m-1，e减1，使多项式自变量落在[-0.29, 0.41]
+    const __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(kSqrtHalf), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(one, small));
+    m = _mm256_sub_ps(_mm256_add_ps(m, _mm256_and_ps(m, small)), one);
+
+    const __m256 z = _mm256_mul_ps(m, m);
+    __m256 y = _mm256_set1_ps(kLogP0);
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogP1));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogP2));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogP3));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogP4));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogP5));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogP6));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogP7));
+    y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(kLogP8));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(kLn2Lo), y);
+    y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+    __m256 result = _mm256_fmadd_ps(e, _mm256_set1_ps(kLn2Hi), _mm256_add_ps(m, y));
+
+    result = _mm256_blendv_ps(result, _mm256_set1_ps(-std::numeric_limits<float>::infinity()), isZero);
+    result = _mm256_blendv_ps(result, _mm256_set1_ps(std::numeric_limits<float>::infinity()), isInf);
+    return _mm256_or_ps(result, invalid);   // 全1即NaN
+}
+
+HFT_TARGET_AVX2 inline float hsum256(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+    return _mm_cvtss_f32(sum);
+}
+
+// 逐元素内核：整块直接算，尾部补齐到一个向量再算，保证所有元素使用同一近似
+template <typename Op>
+HFT_TARGET_AVX2 inline void map256(const float* input, float* output, size_t size, float pad) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(output + i, Op::apply(_mm256_loadu_ps(input + i)));
+    }
+    if (i < size) {
+        alignas(32) float tail[8];
+        for (size_t k = 0; k < 8; ++k) {
+            tail[k] = i + k < size ? input[i + k] : pad;
+        }
+        _mm256_store_ps(tail, Op::apply(_mm256_load_ps(tail)));
+        std::memcpy(output + i, tail, (size - i) * sizeof(float));
+    }
+}
+
+struct Exp256 {
+    HFT_TARGET_AVX2 static __m256 apply(__m256 x) { return exp256(x); }
+};
+
+struct Log256 {
+    HFT_TARGET_AVX2 static __m256 apply(__m256 x) { return log256(x); }
+};
+
+struct Features256 {
+    HFT_TARGET_AVX2 static __m256 apply(__m256 x) {
+        return _mm256_fmadd_ps(_mm256_mul_ps(x, x), _mm256_set1_ps(0.5f),
+                               _mm256_mul_ps(log256(x), _mm256_set1_ps(0.3f)));
+    }
+};
+
+HFT_TARGET_AVX2 void expAvx2(const float* input, float* output, size_t size) {
+    map256<Exp256>(input, output, size, 0.0f);
+}
+
+HFT_TARGET_AVX2 void logAvx2(const float* input, float* output, size_t size) {
+    map256<Log256>(input, output, size, 1.0f);
+}
+
+HFT_TARGET_AVX2 void featuresAvx2(const float* input, float* output, size_t size) {
+    map256<Features256>(input, output, size, 1.0f);
+}
+
+HFT_TARGET_AVX2 float vwapAvx2(const float* prices, const float* volumes, size_t size) {
+    // 两组累加器掩盖FMA延迟
+    __m256 notional0 = _mm256_setzero_ps(), notional1 = _mm256_setzero_ps();
+    __m256 volume0 = _mm256_setzero_ps(), volume1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const __m256 v0 = _mm256_loadu_ps(volumes + i);
+        const __m256 v1 = _mm256_loadu_ps(volumes + i + 8);
+        notional0 = _mm256_fmadd_ps(_mm256_loadu_ps(prices + i), v0, notional0);
+        notional1 = _mm256_fmadd_ps(_mm256_loadu_ps(prices + i + 8), v1, notional1);
+        volume0 = _mm256_add_ps(volume0, v0);
+        volume1 = _mm256_add_ps(volume1, v1);
+    }
+    float notional = hsum256(_mm256_add_ps(notional0, notional1));
+    float volume = hsum256(_mm256_add_ps(volume0, volume1));
+    for (; i < size; ++i) {
+        notional += prices[i] * volumes[i];
+        volume += volumes[i];
+    }
+    return volume > 0.0f ? notional / volume : 0.0f;
+}
+
+HFT_TARGET_AVX2 float volatilityAvx2(const float* returns, size_t size) {
+    if (size == 0) {
+        return 0.0f;
+    }
+    __m256 sum = _mm256_setzero_ps();
+    __m256 sumSq = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        const __m256 r = _mm256_loadu_ps(returns + i);
+        sum = _mm256_add_ps(sum, r);
+        sumSq = _mm256_fmadd_ps(r, r, sumSq);
+    }
+    float s = hsum256(sum);
+    float sq = hsum256(sumSq);
+    for (; i < size; ++i) {
+        s += returns[i];
+        sq += returns[i] * returns[i];
+    }
+    const float mean = s / size;
+    const float variance = sq / size - mean * mean;
+    return variance > 0.0f ? std::sqrt(variance) : 0.0f;
+}
+
+HFT_TARGET_AVX2 float momentumAvx2(const float* prices, size_t size, size_t lag) {
+    if (lag == 0 || size <= lag) {
+        return 0.0f;
+    }
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 sum = _mm256_setzero_ps();
+    size_t i = lag;
+    for (; i + 8 <= size; i += 8) {
+        sum = _mm256_add_ps(sum, _mm256_sub_ps(
+            _mm256_div_ps(_mm256_loadu_ps(prices + i), _mm256_loadu_ps(prices + i - lag)), one));
+    }
+    float total = hsum256(sum);
+    for (; i < size; ++i) {
+        total += prices[i] / prices[i - lag] - 1.0f;
+    }
+    return total / (size - lag);
+}
+
+HFT_TARGET_AVX2 float orderImbalanceAvx2(const float* bidSizes, const float* askSizes, size_t size) {
+    __m256 bid = _mm256_setzero_ps();
+    __m256 ask = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        bid = _mm256_add_ps(bid, _mm256_loadu_ps(bidSizes + i));
+        ask = _mm256_add_ps(ask, _mm256_loadu_ps(askSizes + i));
+    }
+    float b = hsum256(bid);
+    float a = hsum256(ask);
+    for (; i < size; ++i) {
+        b += bidSizes[i];
+        a += askSizes[i];
+    }
+    return b + a > 0.0f ? (b - a) / (b + a) : 0.0f;
+}
+
+// ---------------- AVX-512 ----------------
+
+// GCC 12的avx512fintrin.h中_mm512_undefined_ps会误报未初始化
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+HFT_TARGET_AVX512 inline __m512 exp512(__m512 x) {
+    x = _mm512_min_ps(_mm512_max_ps(x, _mm512_set1_ps(kExpLo)), _mm512_set1_ps(kExpHi));
+    const __m512 fx = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(kLog2e)),
+                                           _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    x = _mm512_fnmadd_ps(fx, _mm512_set1_ps(kLn2Hi), x);
+    x = _mm512_fnmadd_ps(fx, _mm512_set1_ps(kLn2Lo), x);
+
+    const __m512 z = _mm512_mul_ps(x, x);
+    __m512 y = _mm512_set1_ps(kExpP0);
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(kExpP1));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(kExpP2));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(kExpP3));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(kExpP4));
+    y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(kExpP5));
+    y = _mm512_add_ps(_mm512_fmadd_ps(y, z, x), _mm512_set1_ps(1.0f));
+    return _mm512_scalef_ps(y, fx);
+}
+
+HFT_TARGET_AVX512 inline __m512 log512(__m512 x) {
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 zero = _mm512_setzero_ps();
+    const __mmask16 invalid = _mm512_cmp_ps_mask(x, zero, _CMP_NGE_UQ);
+    const __mmask16 isZero = _mm512_cmp_ps_mask(x, zero, _CMP_EQ_OQ);
+    const __mmask16 isInf = _mm512_cmp_ps_mask(x, _mm512_set1_ps(std::numeric_limits<float>::infinity()),
+                                               _CMP_EQ_OQ);
+
+    // getexp/getmant直接拆出指数与[0.5, 1)尾数，非正规数也能正确处理
+    __m512 m = _mm512_getmant_ps(x, _MM_MANT_NORM_p5_1, _MM_MANT_SIGN_zero);
+    __m512 e = _mm512_add_ps(_mm512_getexp_ps(x), one);
+
+    const __mmask16 small = _mm512_cmp_ps_mask(m, _mm512_set1_ps(kSqrtHalf), _CMP_LT_OQ);
+    e = _mm512_mask_sub_ps(e, small, e, one);
+    m = _mm512_sub_ps(_mm512_mask_add_ps(m, small, m, m), one);
+
+    const __m512 z = _mm512_mul_ps(m, m);
+    __m512 y = _mm512_set1_ps(kLogP0);
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogP1));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogP2));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogP3));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogP4));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogP5));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogP6));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogP7));
+    y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(kLogP8));
+    y = _mm512_mul_ps(_mm512_mul_ps(y, m), z);
+    y = _mm512_fmadd_ps(e, _mm512_set1_ps(kLn2Lo), y);
+    y = _mm512_fnmadd_ps(z, _mm512_set1_ps(0.5f), y);
+    __m512 result = _mm512_fmadd_ps(e, _mm512_set1_ps(kLn2Hi), _mm512_add_ps(m, y));
+
+    result = _mm512_mask_mov_ps(result, isZero, _mm512_set1_ps(-std::numeric_limits<float>::infinity()));
+    result = _mm512_mask_mov_ps(result, isInf, _mm512_set1_ps(std::numeric_limits<float>::infinity()));
+    return _mm512_mask_mov_ps(result, invalid, _mm512_set1_ps(std::numeric_limits<float>::quiet_NaN()));
+}
+
+// 逐元素内核：尾部用掩码加载/存储
+template <typename Op>
+HFT_TARGET_AVX512 inline void map512(const float* input, float* output, size_t size, float pad) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        _mm512_storeu_ps(output + i, Op::apply(_mm512_loadu_ps(input + i)));
+    }
+    if (i < size) {
+        const __mmask16 mask = static_cast<__mmask16>((1u << (size - i)) - 1);
+        const __m512 x = _mm512_mask_loadu_ps(_mm512_set1_ps(pad), mask, input + i);
+        _mm512_mask_storeu_ps(output + i, mask, Op::apply(x));
+    }
+}
+
+HFT_TARGET_AVX512 inline __mmask16 tailMask(size_t remaining) {
+    return remaining >= 16 ? static_cast<__mmask16>(0xffff) : static_cast<__mmask16>((1u << remaining) - 1);
+}
+
+struct Exp512 {
+    HFT_TARGET_AVX512 static __m512 apply(__m512 x) { return exp512(x); }
+};
+
+struct Log512 {
+    HFT_TARGET_AVX512 static __m512 apply(__m512 x) { return log512(x); }
+};
+
+struct Features512 {
+    HFT_TARGET_AVX512 static __m512 apply(__m512 x) {
+        return _mm512_fmadd_ps(_mm512_mul_ps(x, x), _mm512_set1_ps(0.5f),
+                               _mm512_mul_ps(log512(x), _mm512_set1_ps(0.3f)));
+    }
+};
+
+HFT_TARGET_AVX512 void expAvx512(const float* input, float* output, size_t size) {
+    map512<Exp512>(input, output, size, 0.0f);
+}
+
+HFT_TARGET_AVX512 void logAvx512(const float* input, float* output, size_t size) {
+    map512<Log512>(input, output, size, 1.0f);
+}
+
+HFT_TARGET_AVX512 void featuresAvx512(const float* input, float* output, size_t size) {
+    map512<Features512>(input, output, size, 1.0f);
+}
+
+HFT_TARGET_AVX512 float vwapAvx512(const float* prices, const float* volumes, size_t size) {
+    __m512 notional0 = _mm512_setzero_ps(), notional1 = _mm512_setzero_ps();
+    __m512 volume0 = _mm512_setzero_ps(), volume1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const __m512 v0 = _mm512_loadu_ps(volumes + i);
+        const __m512 v1 = _mm512_loadu_ps(volumes + i + 16);
+        notional0 = _mm512_fmadd_ps(_mm512_loadu_ps(prices + i), v0, notional0);
+        notional1 = _mm512_fmadd_ps(_mm512_loadu_ps(prices + i + 16), v1, notional1);
+        volume0 = _mm512_add_ps(volume0, v0);
+        volume1 = _mm512_add_ps(volume1, v1);
+    }
+    for (; i < size; i += 16) {
+        const __mmask16 mask = tailMask(size - i);
+        const __m512 v = _mm512_maskz_loadu_ps(mask, volumes + i);
+        notional0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, prices + i), v, notional0);
+        volume0 = _mm512_add_ps(volume0, v);
+    }
+    const float notional = _mm512_reduce_add_ps(_mm512_add_ps(notional0, notional1));
+    const float volume = _mm512_reduce_add_ps(_mm512_add_ps(volume0, volume1));
+    return volume > 0.0f ? notional / volume : 0.0f;
+}
+
+HFT_TARGET_AVX512 float volatilityAvx512(const float* returns, size_t size) {
+    if (size == 0) {
+        return 0.0f;
+    }
+    __m512 sum = _mm512_setzero_ps();
+    __m512 sumSq = _mm512_setzero_ps();
+    for (size_t i = 0; i < size; i += 16) {
+        const __m512 r = _mm512_maskz_loadu_ps(tailMask(size - i), returns + i);
+        sum = _mm512_add_ps(sum, r);
+        sumSq = _mm512_fmadd_ps(r, r, sumSq);
+    }
+    const float mean = _mm512_reduce_add_ps(sum) / size;
+    const float variance = _mm512_reduce_add_ps(sumSq) / size - mean * mean;
+    return variance > 0.0f ? std::sqrt(variance) : 0.0f;
+}
+
+HFT_TARGET_AVX512 float momentumAvx512(const float* prices, size_t size, size_t lag) {
+    if (lag == 0 || size <= lag) {
+        return 0.0f;
+    }
+    const __m512 one = _mm512_set1_ps(1.0f);
+    __m512 sum = _mm512_setzero_ps();
+    for (size_t i = lag; i < size; i += 16) {
+        const __mmask16 mask = tailMask(size - i);
+        const __m512 current = _mm512_mask_loadu_ps(one, mask, prices + i);
+        const __m512 previous = _mm512_mask_loadu_ps(one, mask, prices + i - lag);
+        sum = _mm512_add_ps(sum, _mm512_sub_ps(_mm512_div_ps(current, previous), one));
+    }
+    return _mm512_reduce_add_ps(sum) / (size - lag);
+}
+
+HFT_TARGET_AVX512 float orderImbalanceAvx512(const float* bidSizes, const float* askSizes, size_t size) {
+    __m512 bid = _mm512_setzero_ps();
+    __m512 ask = _mm512_setzero_ps();
+    for (size_t i = 0; i < size; i += 16) {
+        const __mmask16 mask = tailMask(size - i);
+        bid = _mm512_add_ps(bid, _mm512_maskz_loadu_ps(mask, bidSizes + i));
+        ask = _mm512_add_ps(ask, _mm512_maskz_loadu_ps(mask, askSizes + i));
+    }
+    const float b = _mm512_reduce_add_ps(bid);
+    const float a = _mm512_reduce_add_ps(ask);
+    return b + a > 0.0f ? (b - a) / (b + a) : 0.0f;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // HFT_SIMD_DISPATCH
+
+const VectorKernels kScalarKernels = {
+    utils::SimdLevel::SCALAR,
+    &expScalar, &logScalar, &featuresScalar,
+    &vwapScalar, &volatilityScalar, &momentumScalar, &orderImbalanceScalar
+};
+
+#if HFT_SIMD_DISPATCH
+const VectorKernels kAvx2Kernels = {
+    utils::SimdLevel::AVX2,
+    &expAvx2, &logAvx2, &featuresAvx2,
+    &vwapAvx2, &volatilityAvx2, &momentumAvx2, &orderImbalanceAvx2
+};
+
+const VectorKernels kAvx512Kernels = {
+    utils::SimdLevel::AVX512,
+    &expAvx512, &logAvx512, &featuresAvx512,
+    &vwapAvx512, &volatilityAvx512, &momentumAvx512, &orderImbalanceAvx512
+};
+#endif
+
+} // namespace
+
+const VectorKernels& vectorKernels(utils::SimdLevel level) {
+    if (level > utils::detectSimdLevel()) {
+        level = utils::detectSimdLevel();
+    }
+#if HFT_SIMD_DISPATCH
+    switch (level) {
+        case utils::SimdLevel::AVX512: return kAvx512Kernels;
+        case utils::SimdLevel::AVX2: return kAvx2Kernels;
+        default: break;
+    }
+#endif
+    return kScalarKernels;
+}
+
+const VectorKernels& vectorKernels() {
+    static const VectorKernels& kernels = vectorKernels(utils::detectSimdLevel());
+    return kernels;
+}
+
+} // namespace hardware
+} // namespace hft
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include "../utils/SimdSupport.h"
+
+namespace hft {
+namespace hardware {
+
+// 向量化内核表
+//
+// 同一组操作分别有AVX-512、AVX2和标量实现，启动时按CPU特性绑定到函数指针，
+// 同一个二进制可部署在只有AVX2的机器上。输入不要求对齐，长度任意（尾部由掩码或补齐处理）。
+//
+// 精度：exp/log的SIMD实现为Cephes多项式，正规数范围内相对误差约2ulp；
+// exp的输入截断到[-87.33, 88.37]，log把非正规数按最小正规数处理（仅AVX2）。
+// 标量实现调用libm、以double累加，作为精度基准。
+struct VectorKernels {
+    utils::SimdLevel level;
+
+    // output[i] = exp(input[i])
+    void (*exp)(const float* input, float* output, size_t size);
+    // output[i] = ln(input[i])，负数为NaN，0为-inf
+    void (*log)(const float* input, float* output, size_t size);
+    // 价格特征 output[i] = 0.5·x² + 0.3·ln(x)
+    void (*features)(const float* input, float* output, size_t size);
+
+    // Σ(价格×成交量) / Σ成交量
+    float (*vwap)(const float* prices, const float* volumes, size_t size);
+    // 收益率的总体标准差
+    float (*volatility)(const float* returns, size_t size);
+    // lag期收益率 p[i]/p[i-lag] - 1 的平均值
+    float (*momentum)(const float* prices, size_t size, size_t lag);
+    // 挂单失衡 (Σ买量 - Σ卖量) / (Σ买量 + Σ卖量)
+    float (*orderImbalance)(const float* bidSizes, const float* askSizes, size_t size);
+};
+
+// 按本机CPU检测结果绑定的内核表
+const VectorKernels& vectorKernels();
+
+// 指定指令集的内核表（用于对比测试）；CPU不支持该指令集时降级到可用的最高级别
+const VectorKernels& vectorKernels(utils::SimdLevel level);
+
+} // namespace hardware
+} // namespace hft
@@ -0,0 +1,134 @@
+#include "MarketData.h"
+
+namespace hft {
+namespace market {
+
+OrderBook::OrderBook(types::Price tick_size, ConcurrencyMode mode)
+    : mode_(mode),
+      book_(tick_size) {
+}
+
+void OrderBook::update(const L2Data& data) {
+    if (mode_ == ConcurrencyMode::SINGLE_WRITER) {
+        if (symbol_ != data.symbol) {
+            symbol_ = data.symbol;
+        }
+        book_.applySnapshot(data.bids, data.asks);
+        publishSnapshot();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (symbol_ != data.symbol) {
+        symbol_ = data.symbol;
+    }
+    book_.applySnapshot(data.bids, data.asks);
+    ++update_count_;
+}
+
+void OrderBook::updateLevel(types::Side side, types::Price price, types::Volume volume) {
+    if (mode_ == ConcurrencyMode::SINGLE_WRITER) {
+        book_.updateLevel(side, price, volume);
+        publishSnapshot();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    book_.updateLevel(side, price, volume);
+    ++update_count_;
+}
+
+void OrderBook::deleteLevel(types::Side side, types::Price price) {
+    updateLevel(side, price, 0);
+}
+
+types::Price OrderBook::getBestBid() const {
+    if (mode_ == ConcurrencyMode::SINGLE_WRITER) {
+        return published_.load().bestBid();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return book_.bestBid();
+}
+
+types::Price OrderBook::getBestAsk() const {
+    if (mode_ == ConcurrencyMode::SINGLE_WRITER) {
+        return published_.load().bestAsk();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return book_.bestAsk();
+}
+
+types::Volume OrderBook::getVolumeAtPrice(types::Price price) const {
+    if (mode_ == ConcurrencyMode::SINGLE_WRITER) {
+        const BookSnapshot snapshot = published_.load();
+        for (uint32_t i = 0; i < snapshot.bid_levels; ++i) {
+            if (snapshot.bids[i].price == price) {
+                return snapshot.bids[i].volume;
+            }
+        }
+        for (uint32_t i = 0; i < snapshot.ask_levels; ++i) {
+            if (snapshot.asks[i].price == price) {
+                return snapshot.asks[i].volume;
+            }
+        }
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return book_.volumeAtPrice(price);
+}
+
+double OrderBook::getMidPrice() const {
+    if (mode_ == ConcurrencyMode::SINGLE_WRITER) {
+        return published_.load().midPrice();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return book_.midPrice();
+}
+
+double OrderBook::getVWAP() const {
+    if (mode_ == ConcurrencyMode::SINGLE_WRITER) {
+        return published_.load().vwap;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return book_.vwap();
+}
+
+BookSnapshot OrderBook::getSnapshot() const {
+    if (mode_ == ConcurrencyMode::SINGLE_WRITER) {
+        return published_.load();
+    }
+    BookSnapshot snapshot;
+    std::lock_guard<std::mutex> lock(mutex_);
+    fillSnapshot(snapshot);
+    return snapshot;
+}
+
+void OrderBook::publishSnapshot() {
+    ++update_count_;
+    BookSnapshot snapshot;
+    fillSnapshot(snapshot);
+    published_.store(snapshot);
+}
+
+void OrderBook::fillSnapshot(BookSnapshot& snapshot) const {
+    snapshot = BookSnapshot{};
+    snapshot.update_count = update_count_;
+    snapshot.vwap = book_.vwap();
+
+    uint32_t n = 0;
+    book_.forEachLevel(types::Side::BUY, BookSnapshot::kMaxLevels,
+                       [&](types::Price price, types::Volume volume) {
+        snapshot.bids[n++] = {price, volume};
+    });
+    snapshot.bid_levels = n;
+
+    n = 0;
+    book_.forEachLevel(types::Side::SELL, BookSnapshot::kMaxLevels,
+                       [&](types::Price price, types::Volume volume) {
+        snapshot.asks[n++] = {price, volume};
+    });
+    snapshot.ask_levels = n;
+}
+
+} // namespace market
+} // namespace hft
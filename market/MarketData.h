@@ -1,9 +1,12 @@
 #pragma once
 #include "Types.h"
+#include "PriceLevelBook.h"
+#include "SeqLock.h"
 #include <string>
 #include <map>
 #include <queue>
 #include <mutex>
+#include <vector>
 
 namespace hft {
 namespace market {
@@ -29,21 +32,95 @@ struct Trade {
     types::Side side;
 };
 
+// 行情记录（回测、持久化与分发使用的统一格式）
+// 价格与数量为浮点，时间戳为Unix纪元起的纳秒数
+struct MarketData {
+    std::string symbol;
+    uint64_t timestamp = 0;
+    double open_price = 0.0;
+    double high_price = 0.0;
+    double low_price = 0.0;
+    double close_price = 0.0;
+    double last_price = 0.0;
+    double volume = 0.0;
+    double bid_price = 0.0;
+    double ask_price = 0.0;
+    double bid_volume = 0.0;
+    double ask_volume = 0.0;
+};
+
+// 订单簿顶部N档快照（可平凡复制，用于无锁发布）
+struct BookSnapshot {
+    static constexpr size_t kMaxLevels = 10;
+
+    struct Level {
+        types::Price price;
+        types::Volume volume;
+    };
+
+    uint64_t update_count;      // 写者已应用的更新次数
+    uint32_t bid_levels;
+    uint32_t ask_levels;
+    double vwap;
+    Level bids[kMaxLevels];
+    Level asks[kMaxLevels];
+
+    types::Price bestBid() const { return bid_levels > 0 ? bids[0].price : 0; }
+    types::Price bestAsk() const { return ask_levels > 0 ? asks[0].price : 0; }
+    double midPrice() const {
+        if (bid_levels == 0 || ask_levels == 0) {
+            return 0.0;
+        }
+        return (static_cast<double>(bids[0].price) + static_cast<double>(asks[0].price)) / 2.0;
+    }
+};
+
 // 订单簿
+// 底层为按tick索引的扁平档位数组（PriceLevelBook），更新与查询均不分配内存
+//
+// 并发模式：
+//  - MUTEX：读写共享互斥锁，任意线程均可更新
+//  - SINGLE_WRITER：仅行情线程调用更新接口，每次更新后通过顺序锁发布
+//    顶部N档快照；读接口读取快照，不获取锁也不阻塞写者
 class OrderBook {
 public:
+    enum class ConcurrencyMode {
+        MUTEX,
+        SINGLE_WRITER
+    };
+
+    explicit OrderBook(types::Price tick_size = 100,
+                       ConcurrencyMode mode = ConcurrencyMode::MUTEX);
+
+    // 应用完整L2快照
     void update(const L2Data& data);
+    // 增量更新单个档位，volume为0表示删除
+    void updateLevel(types::Side side, types::Price price, types::Volume volume);
+    void deleteLevel(types::Side side, types::Price price);
+
     types::Price getBestBid() const;
     types::Price getBestAsk() const;
+    // SINGLE_WRITER模式下只在已发布的顶部N档中查找
     types::Volume getVolumeAtPrice(types::Price price) const;
     double getMidPrice() const;
     double getVWAP() const;
+
+    // 获取一致的顶部N档快照，SINGLE_WRITER模式下无锁
+    BookSnapshot getSnapshot() const;
+
+    ConcurrencyMode getConcurrencyMode() const { return mode_; }
+    types::Price getTickSize() const { return book_.tickSize(); }
     
 private:
+    void publishSnapshot();
+    void fillSnapshot(BookSnapshot& snapshot) const;
+
     std::string symbol_;
-    std::map<types::Price, types::Volume> bids_;
-    std::map<types::Price, types::Volume> asks_;
-    std::mutex mutex_;
+    ConcurrencyMode mode_;
+    PriceLevelBook book_;
+    uint64_t update_count_{0};
+    mutable std::mutex mutex_;
+    utils::SeqLock<BookSnapshot> published_;
 };
 
 // 市场数据管理器
@@ -2,13 +2,117 @@
 #include <iostream>
 #include <algorithm>
 #include <chrono>
-#include "core/TimeManager.h"
+#include "utils/RingBuffer.h"
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace hft {
 namespace market {
 
+namespace {
+
+bool pinCurrentThread(int cpu_core) {
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu_core, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+    (void)cpu_core;
+    return false;
+#endif
+}
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 当前线程所服务的分发器，用于识别在INLINE回调中发起的注销/移除
+thread_local const MarketDataDistributor* t_dispatching = nullptr;
+
+constexpr uint64_t kNoDispatcher = ~uint64_t{0};
+
+// 空转退避：先让出CPU，长时间无数据后短暂休眠
+void idleBackoff(uint32_t& idle) {
+    if (++idle < 128) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+} // namespace
+
+struct MarketDataDistributor::Consumer {
+    // 合并表：每个品种只保留最新一条，dirty记录待投递的品种
+    struct Conflation {
+        std::mutex mutex;
+        std::unordered_map<core::SymbolId, QueuedItem> latest;
+        std::vector<core::SymbolId> dirty;
+    };
+
+    ConsumerId id = 0;
+    ConsumerConfig config;
+    MarketDataCallback callback;
+    bool all_symbols = true;
+    std::vector<uint8_t> filter;                   // 以SymbolId为下标
+    std::atomic<bool> active{true};
+    std::atomic<bool> running{false};              // 投递线程仍在循环中
+    uint64_t retired_version = 0;                  // 注销时的消费者版本，受m_mutex保护
+
+    // QUEUED：每个分片一条SPSC队列，生产者为分片分发线程，消费者为投递线程
+    std::vector<std::unique_ptr<utils::SPSCRingBuffer<QueuedItem>>> queues;
+    // CONFLATED：每个分片一张合并表
+    std::vector<std::unique_ptr<Conflation>> conflation;
+    std::thread thread;
+
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> conflated{0};
+    std::atomic<uint64_t> max_lag{0};
+    std::atomic<uint64_t> total_lag{0};
+
+    bool wants(core::SymbolId symbol) const {
+        return all_symbols || (symbol < filter.size() && filter[symbol] != 0);
+    }
+};
+
+struct MarketDataDistributor::Shard {
+    struct Entry {
+        core::SymbolId symbol;
+        std::string name;
+        MarketDataQueue* queue;
+    };
+
+    size_t index = 0;
+    std::thread thread;
+    std::vector<Entry> entries;                    // 受m_mutex保护
+    // 没有分发线程运行时为kNoDispatcher，表示不引用任何队列与消费者
+    std::atomic<uint64_t> version{0};              // 品种列表版本
+    std::atomic<uint64_t> acked{kNoDispatcher};    // 分发线程已切换到的品种版本
+    std::atomic<uint64_t> acked_consumers{kNoDispatcher}; // 分发线程已切换到的消费者版本
+};
+
 MarketDataDistributor::MarketDataDistributor()
-    : m_running(false) {
+    : MarketDataDistributor(DistributorConfig()) {
+}
+
+MarketDataDistributor::MarketDataDistributor(const DistributorConfig& config)
+    : m_config(config), m_running(false), m_consumerVersion(0) {
+    if (m_config.dispatcher_threads == 0) {
+        m_config.dispatcher_threads = 1;
+    }
+    if (m_config.dispatch_batch_size == 0) {
+        m_config.dispatch_batch_size = 1;
+    }
+    for (size_t i = 0; i < m_config.dispatcher_threads; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->index = i;
+        m_shards.push_back(std::move(shard));
+    }
 }
 
 MarketDataDistributor::~MarketDataDistributor() {
@@ -16,58 +120,250 @@ MarketDataDistributor::~MarketDataDistributor() {
 }
 
 bool MarketDataDistributor::initialize() {
-    std::cout << "MarketDataDistributor initialized" << std::endl;
+    std::cout << "MarketDataDistributor initialized with " << m_shards.size() << " dispatcher threads" << std::endl;
+    return true;
+}
+
+size_t MarketDataDistributor::shardOf(core::SymbolId symbol) const {
+    // 驻留ID连续分配，乘法散列后再取模，避免相邻品种集中在同一分片
+    return static_cast<size_t>((static_cast<uint64_t>(symbol) * 0x9E3779B97F4A7C15ULL) >> 32) % m_shards.size();
+}
+
+bool MarketDataDistributor::onDispatcherThread() const {
+    return t_dispatching == this;
+}
+
+bool MarketDataDistributor::consumersAcked(uint64_t version) const {
+    for (const auto& shard : m_shards) {
+        if (shard->acked_consumers.load(std::memory_order_acquire) < version) {
+            return false;
+        }
+    }
     return true;
 }
 
+bool MarketDataDistributor::reclaimable(const Consumer& consumer) const {
+    return !consumer.active.load(std::memory_order_relaxed) &&
+           !consumer.running.load(std::memory_order_acquire) &&
+           consumersAcked(consumer.retired_version);
+}
+
+MarketDataDistributor::ConsumerId MarketDataDistributor::registerConsumer(const ConsumerConfig& config,
+                                                                          MarketDataCallback callback) {
+    auto consumer = std::make_unique<Consumer>();
+    consumer->config = config;
+    consumer->callback = std::move(callback);
+    consumer->all_symbols = config.symbols.empty();
+    if (!consumer->all_symbols) {
+        consumer->filter.assign(core::SymbolRegistry::symbols().capacity() + 1, 0);
+        for (const auto& symbol : config.symbols) {
+            const core::SymbolId id = core::internSymbol(symbol);
+            if (id != core::kInvalidSymbol) {
+                consumer->filter[id] = 1;
+            }
+        }
+    }
+    for (size_t i = 0; i < m_shards.size(); ++i) {
+        if (config.mode == DeliveryMode::QUEUED) {
+            consumer->queues.push_back(std::make_unique<utils::SPSCRingBuffer<QueuedItem>>(config.queue_capacity));
+        } else if (config.mode == DeliveryMode::CONFLATED) {
+            consumer->conflation.push_back(std::make_unique<Consumer::Conflation>());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // 复用已注销且不再被引用的槽位，长时间运行时反复注册/注销不会累积过滤表
+    size_t slot = m_consumers.size();
+    for (size_t i = 0; i < m_consumers.size(); ++i) {
+        if (reclaimable(*m_consumers[i])) {
+            slot = i;
+            break;
+        }
+    }
+    consumer->id = static_cast<ConsumerId>(slot);
+    Consumer& ref = *consumer;
+    if (slot < m_consumers.size()) {
+        if (m_consumers[slot]->thread.joinable()) {
+            m_consumers[slot]->thread.join();     // 投递线程已退出循环，立即返回
+        }
+        m_consumers[slot] = std::move(consumer);
+    } else {
+        m_consumers.push_back(std::move(consumer));
+    }
+    if (m_running) {
+        startConsumerThread(ref);
+    }
+    m_consumerVersion.fetch_add(1, std::memory_order_release);
+
+    std::cout << "Consumer registered: " << config.name << " (id " << ref.id << ")" << std::endl;
+    return ref.id;
+}
+
+bool MarketDataDistributor::unregisterConsumer(ConsumerId id) {
+    uint64_t version = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (id >= m_consumers.size() || !m_consumers[id]->active) {
+            return false;
+        }
+        m_consumers[id]->active = false;
+        version = m_consumerVersion.fetch_add(1, std::memory_order_acq_rel) + 1;
+        m_consumers[id]->retired_version = version;
+    }
+
+    // 在分发线程上等待其他分片会互相等待而死锁：本分片投递前检查active立即生效，
+    // 其他分片刷新后生效，槽位与过滤表留到注册新消费者时回收
+    if (onDispatcherThread()) {
+        return true;
+    }
+
+    // 等待所有分发线程切换到新的消费者列表，返回后不会再有INLINE回调
+    for (auto& shard : m_shards) {
+        while (m_running && shard->acked_consumers.load(std::memory_order_acquire) < version) {
+            std::this_thread::yield();
+        }
+    }
+
+    // 分发线程都已放手，过滤表（按注册表容量分配）可以释放
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Consumer& consumer = *m_consumers[id];
+    if (consumer.retired_version == version && consumersAcked(version)) {
+        std::vector<uint8_t>().swap(consumer.filter);
+    }
+    return true;
+}
+
+ConsumerStats MarketDataDistributor::getConsumerStats(ConsumerId id) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ConsumerStats stats;
+    if (id >= m_consumers.size()) {
+        return stats;
+    }
+    const Consumer& consumer = *m_consumers[id];
+    stats.name = consumer.config.name;
+    stats.mode = consumer.config.mode;
+    stats.delivered = consumer.delivered.load(std::memory_order_relaxed);
+    stats.dropped = consumer.dropped.load(std::memory_order_relaxed);
+    stats.conflated = consumer.conflated.load(std::memory_order_relaxed);
+    stats.max_lag_ns = consumer.max_lag.load(std::memory_order_relaxed);
+    stats.avg_lag_ns = stats.delivered > 0
+        ? static_cast<double>(consumer.total_lag.load(std::memory_order_relaxed)) / static_cast<double>(stats.delivered)
+        : 0.0;
+    for (const auto& queue : consumer.queues) {
+        stats.pending += queue->size();
+    }
+    for (const auto& table : consumer.conflation) {
+        std::lock_guard<std::mutex> tableLock(table->mutex);
+        stats.pending += table->dirty.size();
+    }
+    return stats;
+}
+
+std::vector<ConsumerStats> MarketDataDistributor::getAllConsumerStats() const {
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        count = m_consumers.size();
+    }
+    std::vector<ConsumerStats> all;
+    for (ConsumerId id = 0; id < count; ++id) {
+        all.push_back(getConsumerStats(id));
+    }
+    return all;
+}
+
 bool MarketDataDistributor::registerCallback(const std::string& symbol, MarketDataCallback callback) {
+    ConsumerConfig config;
+    config.name = "callback:" + symbol;
+    config.mode = DeliveryMode::INLINE;
+    config.symbols = {symbol};
+    const ConsumerId id = registerConsumer(config, std::move(callback));
+
     std::lock_guard<std::mutex> lock(m_mutex);
-    m_callbacks[symbol].push_back(callback);
-    std::cout << "Callback registered for symbol: " << symbol << std::endl;
+    m_symbolCallbacks[symbol].push_back(id);
     return true;
 }
 
 bool MarketDataDistributor::unregisterCallback(const std::string& symbol) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    auto it = m_callbacks.find(symbol);
-    if (it == m_callbacks.end()) {
-        return false;
+    std::vector<ConsumerId> ids;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_symbolCallbacks.find(symbol);
+        if (it == m_symbolCallbacks.end()) {
+            return false;
+        }
+        ids = std::move(it->second);
+        m_symbolCallbacks.erase(it);
     }
 
-    m_callbacks.erase(it);
+    for (ConsumerId id : ids) {
+        unregisterConsumer(id);
+    }
     std::cout << "Callbacks unregistered for symbol: " << symbol << std::endl;
     return true;
 }
 
-bool MarketDataDistributor::addDataQueue(const std::string& symbol, utils::LockFreeQueue<std::shared_ptr<MarketData>>* queue) {
+bool MarketDataDistributor::addDataQueue(const std::string& symbol, MarketDataQueue* queue) {
     if (!queue) {
         return false;
     }
+    const core::SymbolId id = core::internSymbol(symbol);
+    if (id == core::kInvalidSymbol) {
+        std::cerr << "Cannot intern symbol: " << symbol << std::endl;
+        return false;
+    }
 
     std::lock_guard<std::mutex> lock(m_mutex);
-    m_data_queues[symbol] = queue;
-
-    // 如果分发器已经在运行，启动新的工作线程
-    if (m_running) {
-        m_worker_threads.emplace_back(&MarketDataDistributor::workerLoop, this, symbol);
+    Shard& shard = *m_shards[shardOf(id)];
+    auto it = std::find_if(shard.entries.begin(), shard.entries.end(),
+                           [id](const Shard::Entry& entry) { return entry.symbol == id; });
+    if (it != shard.entries.end()) {
+        it->queue = queue;
+    } else {
+        shard.entries.push_back({id, symbol, queue});
     }
+    shard.version.fetch_add(1, std::memory_order_release);
 
-    std::cout << "Data queue added for symbol: " << symbol << std::endl;
+    std::cout << "Data queue added for symbol: " << symbol << " (shard " << shard.index << ")" << std::endl;
     return true;
 }
 
 bool MarketDataDistributor::removeDataQueue(const std::string& symbol) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    auto it = m_data_queues.find(symbol);
-    if (it == m_data_queues.end()) {
+    const core::SymbolId id = core::SymbolRegistry::symbols().find(symbol);
+    if (id == core::kInvalidSymbol) {
         return false;
     }
 
-    m_data_queues.erase(it);
+    Shard* shard = m_shards[shardOf(id)].get();
+    uint64_t version = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::find_if(shard->entries.begin(), shard->entries.end(),
+                               [id](const Shard::Entry& entry) { return entry.symbol == id; });
+        if (it == shard->entries.end()) {
+            return false;
+        }
+        shard->entries.erase(it);
+        version = shard->version.fetch_add(1, std::memory_order_acq_rel) + 1;
+    }
+
+    // 等待分发线程放弃对该队列的引用，之后调用方可以安全释放队列。
+    // 在分发线程上不等待：本分片在当前品种处理完后即刷新，其他分片不能在这里等
+    while (!onDispatcherThread() && m_running && shard->acked.load(std::memory_order_acquire) < version) {
+        std::this_thread::yield();
+    }
+
     std::cout << "Data queue removed for symbol: " << symbol << std::endl;
     return true;
 }
 
+void MarketDataDistributor::startConsumerThread(Consumer& consumer) {
+    if (consumer.config.mode != DeliveryMode::INLINE && !consumer.thread.joinable()) {
+        consumer.running.store(true, std::memory_order_relaxed);
+        consumer.thread = std::thread(&MarketDataDistributor::consumerLoop, this, std::ref(consumer));
+    }
+}
+
 void MarketDataDistributor::start() {
     if (m_running) {
         return;
@@ -75,13 +371,20 @@ void MarketDataDistributor::start() {
 
     m_running = true;
 
-    // 为每个符号启动工作线程
-    std::vector<std::string> symbols = getAllSymbols();
-    for (const auto& symbol : symbols) {
-        m_worker_threads.emplace_back(&MarketDataDistributor::workerLoop, this, symbol);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& shard : m_shards) {
+        // 分发线程首次刷新前不能认为它已放手
+        shard->acked.store(0, std::memory_order_relaxed);
+        shard->acked_consumers.store(0, std::memory_order_relaxed);
+        shard->thread = std::thread(&MarketDataDistributor::dispatcherLoop, this, std::ref(*shard));
+    }
+    for (auto& consumer : m_consumers) {
+        if (consumer->active) {
+            startConsumerThread(*consumer);
+        }
     }
 
-    std::cout << "MarketDataDistributor started with " << m_worker_threads.size() << " worker threads" << std::endl;
+    std::cout << "MarketDataDistributor started with " << m_shards.size() << " dispatcher threads" << std::endl;
 }
 
 void MarketDataDistributor::stop() {
@@ -91,63 +394,181 @@ void MarketDataDistributor::stop() {
 
     m_running = false;
 
-    // 等待所有工作线程结束
-    for (auto& thread : m_worker_threads) {
-        if (thread.joinable()) {
-            thread.join();
+    // 等待所有分发与投递线程结束
+    for (auto& shard : m_shards) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& consumer : m_consumers) {
+        if (consumer->thread.joinable()) {
+            consumer->thread.join();
         }
     }
 
-    m_worker_threads.clear();
     std::cout << "MarketDataDistributor stopped" << std::endl;
 }
 
-void MarketDataDistributor::workerLoop(const std::string& symbol) {
-    while (m_running) {
-        utils::LockFreeQueue<std::shared_ptr<MarketData>>* queue = nullptr;
-        std::vector<MarketDataCallback> callbacks;
+void MarketDataDistributor::deliver(Consumer& consumer, const std::shared_ptr<MarketData>& data, uint64_t receivedNs) {
+    const uint64_t now = nowNs();
+    const uint64_t lag = now > receivedNs ? now - receivedNs : 0;
+    consumer.total_lag.fetch_add(lag, std::memory_order_relaxed);
+    if (lag > consumer.max_lag.load(std::memory_order_relaxed)) {
+        consumer.max_lag.store(lag, std::memory_order_relaxed);
+    }
+    try {
+        consumer.callback(data);
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in market data callback (" << consumer.config.name << "): " << e.what() << std::endl;
+    }
+    consumer.delivered.fetch_add(1, std::memory_order_relaxed);
+}
 
-        // 获取队列和回调
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            auto it_queue = m_data_queues.find(symbol);
-            auto it_callback = m_callbacks.find(symbol);
+void MarketDataDistributor::dispatcherLoop(Shard& shard) {
+    if (!m_config.cpu_cores.empty()) {
+        const int core = m_config.cpu_cores[shard.index % m_config.cpu_cores.size()];
+        if (!pinCurrentThread(core)) {
+            std::cerr << "Failed to pin dispatcher " << shard.index << " to core " << core << std::endl;
+        }
+    }
 
-            if (it_queue == m_data_queues.end() || it_callback == m_callbacks.end()) {
-                // 没有队列或回调，短暂休眠
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                continue;
-            }
+    t_dispatching = this;
+    std::vector<Shard::Entry> entries;
+    std::vector<Consumer*> consumers;
+    uint64_t entriesVersion = ~uint64_t{0};
+    uint64_t consumersVersion = ~uint64_t{0};
+    std::vector<std::shared_ptr<MarketData>> batch(m_config.dispatch_batch_size);
+    uint32_t idle = 0;
 
-            queue = it_queue->second;
-            callbacks = it_callback->second;
+    while (m_running.load(std::memory_order_relaxed)) {
+        // 品种或消费者变化时刷新本地副本
+        const uint64_t ev = shard.version.load(std::memory_order_acquire);
+        const uint64_t cv = m_consumerVersion.load(std::memory_order_acquire);
+        if (ev != entriesVersion || cv != consumersVersion) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            entries = shard.entries;
+            consumers.clear();
+            for (auto& consumer : m_consumers) {
+                if (consumer->active) {
+                    consumers.push_back(consumer.get());
+                }
+            }
+            entriesVersion = shard.version.load(std::memory_order_relaxed);
+            consumersVersion = m_consumerVersion.load(std::memory_order_relaxed);
+            shard.acked.store(entriesVersion, std::memory_order_release);
+            shard.acked_consumers.store(consumersVersion, std::memory_order_release);
         }
 
-        // 处理队列中的数据
-        std::shared_ptr<MarketData> data;
-        while (queue->pop(data)) {
-            // 调用所有回调
-            for (const auto& callback : callbacks) {
-                try {
-                    callback(data);
-                } catch (const std::exception& e) {
-                    std::cerr << "Exception in market data callback: " << e.what() << std::endl;
+        size_t processed = 0;
+        for (const auto& entry : entries) {
+            const size_t count = entry.queue->pop_n(batch.data(), batch.size());
+            if (count == 0) {
+                continue;
+            }
+            const uint64_t received = nowNs();
+            for (size_t i = 0; i < count; ++i) {
+                for (Consumer* consumer : consumers) {
+                    if (!consumer->wants(entry.symbol)) {
+                        continue;
+                    }
+                    switch (consumer->config.mode) {
+                        case DeliveryMode::INLINE:
+                            // 可能在本批的前一个回调中被注销
+                            if (consumer->active.load(std::memory_order_relaxed)) {
+                                deliver(*consumer, batch[i], received);
+                            }
+                            break;
+                        case DeliveryMode::QUEUED:
+                            if (!consumer->queues[shard.index]->try_push(QueuedItem{batch[i], received})) {
+                                consumer->dropped.fetch_add(1, std::memory_order_relaxed);
+                            }
+                            break;
+                        case DeliveryMode::CONFLATED: {
+                            auto& table = *consumer->conflation[shard.index];
+                            std::lock_guard<std::mutex> lock(table.mutex);
+                            QueuedItem& slot = table.latest[entry.symbol];
+                            if (slot.data) {
+                                consumer->conflated.fetch_add(1, std::memory_order_relaxed);
+                            } else {
+                                table.dirty.push_back(entry.symbol);
+                            }
+                            slot.data = batch[i];
+                            slot.received_ns = received;
+                            break;
+                        }
+                    }
                 }
+                batch[i].reset();
+            }
+            processed += count;
+            // 回调中移除了队列时立即刷新，不再访问已移除的队列
+            if (shard.version.load(std::memory_order_relaxed) != entriesVersion) {
+                break;
             }
         }
 
-        // 短暂休眠以避免CPU占用过高
-        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        if (processed == 0) {
+            idleBackoff(idle);
+        } else {
+            idle = 0;
+        }
     }
+
+    // 退出后不再引用任何队列与消费者
+    shard.acked.store(kNoDispatcher, std::memory_order_release);
+    shard.acked_consumers.store(kNoDispatcher, std::memory_order_release);
+    t_dispatching = nullptr;
 }
 
-std::vector<std::string> MarketDataDistributor::getAllSymbols() {
-    std::vector<std::string> symbols;
-    for (const auto& [symbol, _] : m_data_queues) {
-        symbols.push_back(symbol);
+void MarketDataDistributor::consumerLoop(Consumer& consumer) {
+    std::vector<QueuedItem> items(m_config.dispatch_batch_size);
+    std::vector<QueuedItem> latest;
+    std::vector<core::SymbolId> dirty;
+    uint32_t idle = 0;
+
+    while (m_running.load(std::memory_order_relaxed) && consumer.active.load(std::memory_order_relaxed)) {
+        size_t processed = 0;
+        if (consumer.config.mode == DeliveryMode::QUEUED) {
+            for (auto& queue : consumer.queues) {
+                size_t count;
+                while ((count = queue->pop_n(items.data(), items.size())) > 0) {
+                    for (size_t i = 0; i < count; ++i) {
+                        deliver(consumer, items[i].data, items[i].received_ns);
+                        items[i].data.reset();
+                    }
+                    processed += count;
+                }
+            }
+        } else {
+            for (auto& table : consumer.conflation) {
+                // 持锁只做交换，回调在锁外执行
+                {
+                    std::lock_guard<std::mutex> lock(table->mutex);
+                    dirty.swap(table->dirty);
+                    for (core::SymbolId symbol : dirty) {
+                        QueuedItem& slot = table->latest[symbol];
+                        latest.push_back(QueuedItem{std::move(slot.data), slot.received_ns});
+                        slot.data.reset();
+                    }
+                }
+                for (auto& item : latest) {
+                    deliver(consumer, item.data, item.received_ns);
+                }
+                processed += latest.size();
+                latest.clear();
+                dirty.clear();
+            }
+        }
+
+        if (processed == 0) {
+            idleBackoff(idle);
+        } else {
+            idle = 0;
+        }
     }
-    return symbols;
+    consumer.running.store(false, std::memory_order_release);
 }
 
 } // namespace market
-} // namespace hft
\ No newline at end of file
+} // namespace hft
@@ -7,29 +7,84 @@
 #include <memory>
 #include <atomic>
 #include <thread>
+#include "core/SymbolRegistry.h"
 #include "market/MarketData.h"
-#include "utils/LockFreeQueue.h"
+#include "market/MarketDataSubscriber.h"
 
 namespace hft {
 namespace market {
 
+// 消费者投递方式
+enum class DeliveryMode {
+    INLINE,         // 在分发线程上直接回调，延迟最低，回调过慢会拖累同分片的其他品种
+    QUEUED,         // 逐笔投递到消费者自己的线程，有界队列，满时丢弃并计数
+    CONFLATED       // 只保留每个品种的最新数据，消费者线程取到的总是最新状态
+};
+
+// 消费者配置
+struct ConsumerConfig {
+    std::string name;
+    DeliveryMode mode = DeliveryMode::QUEUED;
+    std::vector<std::string> symbols;     // 为空表示订阅全部品种
+    size_t queue_capacity = 4096;         // QUEUED模式下每个分片的队列容量
+};
+
+// 消费者延迟指标
+struct ConsumerStats {
+    std::string name;
+    DeliveryMode mode = DeliveryMode::QUEUED;
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;                 // QUEUED队列满丢弃
+    uint64_t conflated = 0;               // CONFLATED被新数据覆盖
+    uint64_t pending = 0;                 // 当前积压
+    uint64_t max_lag_ns = 0;              // 分发线程收到到回调开始的最大间隔
+    double avg_lag_ns = 0.0;
+};
+
+// 分发器配置
+struct DistributorConfig {
+    size_t dispatcher_threads = 4;
+    std::vector<int> cpu_cores;           // 分发线程绑定的CPU，按分片依次使用，为空不绑定
+    size_t dispatch_batch_size = 64;
+};
+
 // 市场数据分发器
+//
+//  品种队列 ──按品种哈希分片──> 固定数量的分发线程 ──> 消费者
+//
+//  - 每个品种的SPSC队列只由所属分片的分发线程消费，线程数与品种数无关
+//  - INLINE消费者在分发线程上回调；QUEUED/CONFLATED消费者各有一个投递线程，
+//    慢消费者只会让自己的队列积压/丢弃或被合并，不影响分发线程与其他消费者
+//  - 品种与消费者列表按版本号发布，分发线程在版本变化时才加锁刷新本地副本
+//  - 注销消费者、移除队列会等待所有分发线程切换到新版本；在分发线程上（INLINE回调内）
+//    调用时不等待，以免分片之间互相等待而死锁，此时本分片立即生效，其他分片在下一次刷新时生效
 class MarketDataDistributor {
 public:
     using MarketDataCallback = std::function<void(const std::shared_ptr<MarketData>&)>;
+    using ConsumerId = uint32_t;
 
     MarketDataDistributor();
+    explicit MarketDataDistributor(const DistributorConfig& config);
     ~MarketDataDistributor();
 
     // 初始化分发器
     bool initialize();
-    // 注册数据回调
+    // 注册消费者，返回消费者ID（已注销且不再被任何线程引用的ID会被复用）
+    ConsumerId registerConsumer(const ConsumerConfig& config, MarketDataCallback callback);
+    // 注销消费者：停止投递并释放品种过滤表，槽位留给之后注册的消费者复用。
+    // 返回后不会再有INLINE回调；在分发线程上调用时其他分片可能还会投递最后一批
+    bool unregisterConsumer(ConsumerId id);
+    ConsumerStats getConsumerStats(ConsumerId id) const;
+    std::vector<ConsumerStats> getAllConsumerStats() const;
+
+    // 注册数据回调（单品种、在分发线程上回调）
     bool registerCallback(const std::string& symbol, MarketDataCallback callback);
     // 移除数据回调
     bool unregisterCallback(const std::string& symbol);
-    // 添加数据队列
-    bool addDataQueue(const std::string& symbol, utils::LockFreeQueue<std::shared_ptr<MarketData>>* queue);
-    // 移除数据队列
+    // 添加数据队列（每个品种一个SPSC队列，由所属分片的分发线程独占消费）
+    bool addDataQueue(const std::string& symbol, MarketDataQueue* queue);
+    // 移除数据队列，返回后调用方可以释放队列；
+    // 在分发线程上调用时不等待，队列须保持有效直到所属分片刷新
     bool removeDataQueue(const std::string& symbol);
     // 启动分发
     void start();
@@ -37,20 +92,35 @@ public:
     void stop();
 
 private:
+    struct Consumer;
+    struct Shard;
+    struct QueuedItem {
+        std::shared_ptr<MarketData> data;
+        uint64_t received_ns;
+    };
+
+    DistributorConfig m_config;
     std::atomic<bool> m_running;
-    std::mutex m_mutex;
-    std::vector<std::thread> m_worker_threads;
-
-    // 回调映射
-    std::unordered_map<std::string, std::vector<MarketDataCallback>> m_callbacks;
-    // 数据队列映射
-    std::unordered_map<std::string, utils::LockFreeQueue<std::shared_ptr<MarketData>>*> m_data_queues;
-
-    // 工作线程函数
-    void workerLoop(const std::string& symbol);
-    // 获取所有符号
-    std::vector<std::string> getAllSymbols();
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    std::vector<std::unique_ptr<Consumer>> m_consumers;     // 以ConsumerId为下标，注销后的槽位在注册时复用
+    std::atomic<uint64_t> m_consumerVersion;
+    std::unordered_map<std::string, std::vector<ConsumerId>> m_symbolCallbacks;
+
+    size_t shardOf(core::SymbolId symbol) const;
+    // 当前线程是否为本分发器的分发线程
+    bool onDispatcherThread() const;
+    // 所有分发线程都已切换到不低于version的消费者列表（调用方持有m_mutex或不要求精确）
+    bool consumersAcked(uint64_t version) const;
+    // 已注销的消费者不再被分发线程与投递线程引用，槽位可以复用（调用方持有m_mutex）
+    bool reclaimable(const Consumer& consumer) const;
+    // 分发线程函数
+    void dispatcherLoop(Shard& shard);
+    // 消费者投递线程函数
+    void consumerLoop(Consumer& consumer);
+    void deliver(Consumer& consumer, const std::shared_ptr<MarketData>& data, uint64_t receivedNs);
+    void startConsumerThread(Consumer& consumer);
 };
 
 } // namespace market
-} // namespace hft
\ No newline at end of file
+} // namespace hft
@@ -87,7 +87,7 @@ bool MarketDataSubscriber::unsubscribe(const std::string& symbol, SubscriptionTy
     return true;
 }
 
-utils::LockFreeQueue<std::shared_ptr<MarketData>>* MarketDataSubscriber::getMarketDataQueue(const std::string& symbol) {
+MarketDataQueue* MarketDataSubscriber::getMarketDataQueue(const std::string& symbol) {
     std::lock_guard<std::mutex> lock(m_mutex);
     auto it = m_data_queues.find(symbol);
     if (it == m_data_queues.end()) {
@@ -145,13 +145,16 @@ void MarketDataSubscriber::processData(const std::vector<char>& data) {
     std::lock_guard<std::mutex> lock(m_mutex);
     auto it = m_data_queues.find(market_data->symbol);
     if (it != m_data_queues.end()) {
-        it->second->push(market_data);
+        // 有界队列：消费者跟不上时丢弃并计数，不阻塞接收线程
+        if (!it->second->try_push(std::move(market_data))) {
+            m_dropped_messages.fetch_add(1, std::memory_order_relaxed);
+        }
     }
 }
 
 void MarketDataSubscriber::createDataQueue(const std::string& symbol) {
     if (m_data_queues.find(symbol) == m_data_queues.end()) {
-        m_data_queues[symbol] = std::make_unique<utils::LockFreeQueue<std::shared_ptr<MarketData>>>();
+        m_data_queues[symbol] = std::make_unique<MarketDataQueue>(kDefaultQueueCapacity);
     }
 }
 
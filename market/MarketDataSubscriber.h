@@ -9,7 +9,7 @@
 #include <memory>
 #include "market/MarketData.h"
 #include "network/LowLatencyNetwork.h"
-#include "utils/LockFreeQueue.h"
+#include "utils/RingBuffer.h"
 
 namespace hft {
 namespace market {
@@ -31,9 +31,14 @@ struct SubscriptionConfig {
     bool snapshot_required;       // 是否需要快照
 };
 
+// 每个品种的行情队列：接收线程单生产、分发线程单消费
+using MarketDataQueue = utils::SPSCRingBuffer<std::shared_ptr<MarketData>>;
+
 // 市场数据订阅器
 class MarketDataSubscriber {
 public:
+    static constexpr size_t kDefaultQueueCapacity = 8192;
+
     MarketDataSubscriber(network::LowLatencyNetwork* network);
     ~MarketDataSubscriber();
 
@@ -44,7 +49,9 @@ public:
     // 取消订阅
     bool unsubscribe(const std::string& symbol, SubscriptionType type);
     // 获取订阅的数据队列
-    utils::LockFreeQueue<std::shared_ptr<MarketData>>* getMarketDataQueue(const std::string& symbol);
+    MarketDataQueue* getMarketDataQueue(const std::string& symbol);
+    // 队列满而丢弃的消息数
+    uint64_t getDroppedMessageCount() const { return m_dropped_messages.load(std::memory_order_relaxed); }
     // 启动订阅
     void start();
     // 停止订阅
@@ -56,11 +63,12 @@ private:
     std::thread m_receive_thread;
     std::mutex m_mutex;
     std::condition_variable m_cv;
+    std::atomic<uint64_t> m_dropped_messages{0};
 
     // 订阅配置映射
     std::unordered_map<std::string, std::vector<SubscriptionConfig>> m_subscriptions;
     // 数据队列映射
-    std::unordered_map<std::string, std::unique_ptr<utils::LockFreeQueue<std::shared_ptr<MarketData>>>> m_data_queues;
+    std::unordered_map<std::string, std::unique_ptr<MarketDataQueue>> m_data_queues;
 
     // 接收线程函数
     void receiveLoop();
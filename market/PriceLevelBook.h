@@ -0,0 +1,400 @@
+#pragma once
+#include "Types.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace hft {
+namespace market {
+
+// 以整数tick为索引的单边价格档位环形数组
+// 窗口覆盖[base_tick, base_tick + Capacity)，tick映射到 tick & (Capacity - 1)
+// 档位更新/删除O(1)，最优价通过非空位图按64档一组扫描，窗口固定时为常数时间
+template<size_t Capacity>
+class PriceLadder {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(Capacity >= 64, "Capacity must be at least 64");
+
+public:
+    static constexpr int64_t kNoTick = INT64_MIN;
+
+    explicit PriceLadder(bool is_bid) : is_bid_(is_bid) {
+        clear();
+    }
+
+    // 设置档位数量，volume为0表示删除该档位
+    // 返回false表示价格位于远离盘口的窗口外侧，已被丢弃
+    bool set(int64_t tick, types::Volume volume) {
+        if (volume < 0) {
+            volume = 0;
+        }
+        if (best_tick_ == kNoTick) {
+            // 空边：围绕该价格重新定位窗口
+            if (volume <= 0) {
+                return true;
+            }
+            base_tick_ = anchorBase(tick);
+        } else if (!inWindow(tick)) {
+            if (volume <= 0) {
+                return true;
+            }
+            if (!recenter(tick)) {
+                ++dropped_levels_;
+                return false;
+            }
+        }
+
+        const size_t slot = slotOf(tick);
+        const types::Volume old_volume = volumes_[slot];
+        if (old_volume == volume) {
+            return true;
+        }
+
+        total_volume_ += volume - old_volume;
+        total_notional_ += static_cast<double>(tick) * static_cast<double>(volume - old_volume);
+
+        volumes_[slot] = volume;
+        if (volume > 0) {
+            if (old_volume <= 0) {
+                setBit(slot);
+                ++level_count_;
+                if (best_tick_ == kNoTick || better(tick, best_tick_)) {
+                    best_tick_ = tick;
+                }
+            }
+        } else {
+            clearBit(slot);
+            --level_count_;
+            if (tick == best_tick_) {
+                best_tick_ = level_count_ > 0 ? nextDeeper(tick) : kNoTick;
+            }
+        }
+        return true;
+    }
+
+    types::Volume get(int64_t tick) const {
+        if (best_tick_ == kNoTick || !inWindow(tick)) {
+            return 0;
+        }
+        return volumes_[slotOf(tick)];
+    }
+
+    // 清空所有档位，只访问非空位图字，代价与档位数成正比
+    void clear() {
+        if (level_count_ > 0) {
+            for (size_t w = 0; w < kWords; ++w) {
+                uint64_t bits = occupied_[w];
+                while (bits != 0) {
+                    const size_t slot = w * 64 + static_cast<size_t>(ctz(bits));
+                    volumes_[slot] = 0;
+                    bits &= bits - 1;
+                }
+                occupied_[w] = 0;
+            }
+        } else {
+            volumes_.fill(0);
+            occupied_.fill(0);
+        }
+        best_tick_ = kNoTick;
+        level_count_ = 0;
+        total_volume_ = 0;
+        total_notional_ = 0.0;
+    }
+
+    bool empty() const { return best_tick_ == kNoTick; }
+    int64_t bestTick() const { return best_tick_; }
+    size_t levelCount() const { return level_count_; }
+    types::Volume totalVolume() const { return total_volume_; }
+    double totalNotionalTicks() const { return total_notional_; }
+    uint64_t droppedLevels() const { return dropped_levels_; }
+
+    // 从最优价向深处依次访问至多max_levels个非空档位
+    template<typename Fn>
+    size_t forEachLevel(size_t max_levels, Fn&& fn) const {
+        size_t visited = 0;
+        int64_t tick = best_tick_;
+        while (tick != kNoTick && visited < max_levels) {
+            fn(tick, volumes_[slotOf(tick)]);
+            ++visited;
+            tick = nextDeeper(tick);
+        }
+        return visited;
+    }
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+    static constexpr size_t kWords = Capacity / 64;
+
+    static int ctz(uint64_t v) {
+#if defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanForward64(&idx, v);
+        return static_cast<int>(idx);
+#else
+        return __builtin_ctzll(v);
+#endif
+    }
+
+    static int clz(uint64_t v) {
+#if defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanReverse64(&idx, v);
+        return 63 - static_cast<int>(idx);
+#else
+        return __builtin_clzll(v);
+#endif
+    }
+
+    size_t slotOf(int64_t tick) const {
+        return static_cast<size_t>(static_cast<uint64_t>(tick) & kMask);
+    }
+
+    bool inWindow(int64_t tick) const {
+        return tick >= base_tick_ && tick < base_tick_ + static_cast<int64_t>(Capacity);
+    }
+
+    bool better(int64_t a, int64_t b) const {
+        return is_bid_ ? a > b : a < b;
+    }
+
+    void setBit(size_t slot) { occupied_[slot >> 6] |= (uint64_t{1} << (slot & 63)); }
+    void clearBit(size_t slot) { occupied_[slot >> 6] &= ~(uint64_t{1} << (slot & 63)); }
+
+    // 盘口在窗口中的位置：朝对手方留1/8余量，其余7/8留给深度
+    int64_t anchorBase(int64_t touch) const {
+        const int64_t cap = static_cast<int64_t>(Capacity);
+        return is_bid_ ? touch - (cap - cap / 8) : touch - cap / 8;
+    }
+
+    // 价格越过盘口方向时平移窗口，丢弃远端最深的档位
+    // 价格位于深处窗口外时不平移，返回false
+    bool recenter(int64_t tick) {
+        const int64_t cap = static_cast<int64_t>(Capacity);
+        if (is_bid_ ? tick < base_tick_ : tick >= base_tick_ + cap) {
+            return false;
+        }
+        const int64_t new_base = anchorBase(tick);
+
+        const int64_t shift = new_base - base_tick_;
+        if (shift >= cap || -shift >= cap) {
+            const uint64_t lost = level_count_;
+            clear();
+            dropped_levels_ += lost;
+        } else if (shift > 0) {
+            evictRange(base_tick_, new_base);
+        } else {
+            evictRange(new_base + cap, base_tick_ + cap);
+        }
+        base_tick_ = new_base;
+        return true;
+    }
+
+    // 清除[from, to)区间内的档位（平移窗口时使用）
+    void evictRange(int64_t from, int64_t to) {
+        for (int64_t t = from; t < to; ++t) {
+            const size_t slot = slotOf(t);
+            const types::Volume v = volumes_[slot];
+            if (v > 0) {
+                total_volume_ -= v;
+                total_notional_ -= static_cast<double>(t) * static_cast<double>(v);
+                volumes_[slot] = 0;
+                clearBit(slot);
+                --level_count_;
+                ++dropped_levels_;
+            }
+        }
+        if (level_count_ == 0) {
+            best_tick_ = kNoTick;
+        }
+    }
+
+    // 从tick（不含）开始向深处查找下一个非空档位
+    int64_t nextDeeper(int64_t tick) const {
+        if (is_bid_) {
+            return tick - 1 >= base_tick_ ? scanDown(tick - 1) : kNoTick;
+        }
+        return tick + 1 < base_tick_ + static_cast<int64_t>(Capacity) ? scanUp(tick + 1) : kNoTick;
+    }
+
+    // 自tick（含）向下扫描到窗口底部
+    int64_t scanDown(int64_t tick) const {
+        int64_t remaining = tick - base_tick_ + 1;
+        while (remaining > 0) {
+            const size_t slot = slotOf(tick);
+            const size_t bit = slot & 63;
+            uint64_t bits = occupied_[slot >> 6];
+            bits &= (bit == 63) ? ~uint64_t{0} : ((uint64_t{1} << (bit + 1)) - 1);
+            const int64_t span = static_cast<int64_t>(bit) + 1;
+            if (bits != 0) {
+                const int64_t found = tick - (static_cast<int64_t>(bit) - (63 - clz(bits)));
+                return found >= base_tick_ ? found : kNoTick;
+            }
+            tick -= span;
+            remaining -= span;
+        }
+        return kNoTick;
+    }
+
+    // 自tick（含）向上扫描到窗口顶部
+    int64_t scanUp(int64_t tick) const {
+        const int64_t top = base_tick_ + static_cast<int64_t>(Capacity);
+        int64_t remaining = top - tick;
+        while (remaining > 0) {
+            const size_t slot = slotOf(tick);
+            const size_t bit = slot & 63;
+            uint64_t bits = occupied_[slot >> 6] >> bit;
+            const int64_t span = 64 - static_cast<int64_t>(bit);
+            if (bits != 0) {
+                const int64_t found = tick + ctz(bits);
+                return found < top ? found : kNoTick;
+            }
+            tick += span;
+            remaining -= span;
+        }
+        return kNoTick;
+    }
+
+    bool is_bid_;
+    int64_t base_tick_{0};
+    int64_t best_tick_{kNoTick};
+    size_t level_count_{0};
+    types::Volume total_volume_{0};
+    double total_notional_{0.0};
+    uint64_t dropped_levels_{0};
+    std::array<uint64_t, kWords> occupied_{};
+    std::array<types::Volume, Capacity> volumes_{};
+};
+
+// 扁平价格档位订单簿引擎
+// 价格按tick_size离散化为整数tick，买卖两侧各为一个围绕盘口的环形档位数组
+// 所有操作不分配内存，VWAP与总量增量维护，查询为O(1)
+class PriceLevelBook {
+public:
+    static constexpr size_t kLadderCapacity = 4096;
+
+    explicit PriceLevelBook(types::Price tick_size = 100)
+        : tick_size_(tick_size > 0 ? tick_size : 1),
+          bids_(true),
+          asks_(false) {}
+
+    // 单档更新，volume为0表示删除
+    bool updateLevel(types::Side side, types::Price price, types::Volume volume) {
+        return ladder(side).set(toTick(price), volume);
+    }
+
+    bool deleteLevel(types::Side side, types::Price price) {
+        return ladder(side).set(toTick(price), 0);
+    }
+
+    // 应用完整快照，只复用已有数组
+    template<typename LevelContainer>
+    void applySnapshot(const LevelContainer& bids, const LevelContainer& asks) {
+        bids_.clear();
+        asks_.clear();
+        for (const auto& level : bids) {
+            bids_.set(toTick(level.price), level.volume);
+        }
+        for (const auto& level : asks) {
+            asks_.set(toTick(level.price), level.volume);
+        }
+    }
+
+    void clear() {
+        bids_.clear();
+        asks_.clear();
+    }
+
+    types::Price bestBid() const {
+        return bids_.empty() ? 0 : toPrice(bids_.bestTick());
+    }
+
+    types::Price bestAsk() const {
+        return asks_.empty() ? 0 : toPrice(asks_.bestTick());
+    }
+
+    types::Volume bestBidVolume() const {
+        return bids_.empty() ? 0 : bids_.get(bids_.bestTick());
+    }
+
+    types::Volume bestAskVolume() const {
+        return asks_.empty() ? 0 : asks_.get(asks_.bestTick());
+    }
+
+    types::Volume volumeAt(types::Side side, types::Price price) const {
+        return ladder(side).get(toTick(price));
+    }
+
+    // 某价格在任一侧的挂单量（正常盘口下两侧不会同时非零）
+    types::Volume volumeAtPrice(types::Price price) const {
+        const int64_t tick = toTick(price);
+        return bids_.get(tick) + asks_.get(tick);
+    }
+
+    double midPrice() const {
+        if (bids_.empty() || asks_.empty()) {
+            return 0.0;
+        }
+        return (static_cast<double>(bestBid()) + static_cast<double>(bestAsk())) / 2.0;
+    }
+
+    // 全簿成交量加权价格
+    double vwap() const {
+        const types::Volume volume = bids_.totalVolume() + asks_.totalVolume();
+        if (volume <= 0) {
+            return 0.0;
+        }
+        const double notional = bids_.totalNotionalTicks() + asks_.totalNotionalTicks();
+        return notional * static_cast<double>(tick_size_) / static_cast<double>(volume);
+    }
+
+    double sideVwap(types::Side side) const {
+        const auto& l = ladder(side);
+        if (l.totalVolume() <= 0) {
+            return 0.0;
+        }
+        return l.totalNotionalTicks() * static_cast<double>(tick_size_) /
+               static_cast<double>(l.totalVolume());
+    }
+
+    types::Volume totalVolume(types::Side side) const { return ladder(side).totalVolume(); }
+    size_t levelCount(types::Side side) const { return ladder(side).levelCount(); }
+    uint64_t droppedLevels() const { return bids_.droppedLevels() + asks_.droppedLevels(); }
+    types::Price tickSize() const { return tick_size_; }
+
+    // 由最优价向深处访问前max_levels档，fn(price, volume)
+    template<typename Fn>
+    size_t forEachLevel(types::Side side, size_t max_levels, Fn&& fn) const {
+        return ladder(side).forEachLevel(max_levels, [&](int64_t tick, types::Volume volume) {
+            fn(toPrice(tick), volume);
+        });
+    }
+
+    int64_t toTick(types::Price price) const {
+        // 向下取整，保证负价格（如价差合约）也映射到正确档位
+        int64_t q = price / tick_size_;
+        if ((price % tick_size_) != 0 && price < 0) {
+            --q;
+        }
+        return q;
+    }
+
+    types::Price toPrice(int64_t tick) const {
+        return tick * tick_size_;
+    }
+
+private:
+    using Ladder = PriceLadder<kLadderCapacity>;
+
+    Ladder& ladder(types::Side side) { return side == types::Side::BUY ? bids_ : asks_; }
+    const Ladder& ladder(types::Side side) const { return side == types::Side::BUY ? bids_ : asks_; }
+
+    types::Price tick_size_;
+    Ladder bids_;
+    Ladder asks_;
+};
+
+} // namespace market
+} // namespace hft
@@ -0,0 +1,308 @@
+#include "BookBuilder.h"
+
+namespace hft {
+namespace network {
+
+namespace {
+
+size_t roundUpPow2(size_t v) {
+    size_t p = 1;
+    while (p < v) {
+        p <<= 1;
+    }
+    return p;
+}
+
+} // namespace
+
+BookBuilder::BookBuilder(size_t maxOrders, types::Price tickSize)
+    : m_tickSize(tickSize), m_listener(nullptr), m_orderCount(0), m_maxOrders(maxOrders),
+      m_locates(65536), m_unknownOrders(0), m_droppedOrders(0), m_duplicateOrders(0) {
+    // 装载因子不超过1/2，线性探测的探测长度保持在常数级
+    const size_t capacity = roundUpPow2(maxOrders * 2);
+    m_slots.resize(capacity);
+    m_nodes.resize(maxOrders);
+    m_orderMask = capacity - 1;
+    resetOrders();
+}
+
+void BookBuilder::resetOrders() {
+    for (OrderSlot& slot : m_slots) {
+        slot = OrderSlot{0, kNil};
+    }
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        m_nodes[i].ref = 0;
+        m_nodes[i].next = i + 1 < m_nodes.size() ? static_cast<uint32_t>(i + 1) : kNil;
+    }
+    m_freeNodes = m_nodes.empty() ? kNil : 0;
+    for (LocateState& state : m_locates) {
+        state.orders = kNil;
+    }
+    m_orderCount = 0;
+}
+
+size_t BookBuilder::hashRef(uint64_t ref) {
+    // 订单号通常连续递增，乘法散列打散低位
+    return static_cast<size_t>((ref * 0x9E3779B97F4A7C15ULL) >> 17);
+}
+
+BookBuilder::OrderEntry* BookBuilder::findOrder(uint64_t ref) {
+    size_t slot = hashRef(ref) & m_orderMask;
+    while (m_slots[slot].ref != 0) {
+        if (m_slots[slot].ref == ref) {
+            return &m_nodes[m_slots[slot].node];
+        }
+        slot = (slot + 1) & m_orderMask;
+    }
+    return nullptr;
+}
+
+void BookBuilder::linkOrder(uint32_t node) {
+    OrderEntry& entry = m_nodes[node];
+    LocateState& state = m_locates[entry.locate];
+    entry.prev = kNil;
+    entry.next = state.orders;
+    if (state.orders != kNil) {
+        m_nodes[state.orders].prev = node;
+    }
+    state.orders = node;
+}
+
+void BookBuilder::unlinkOrder(uint32_t node) {
+    OrderEntry& entry = m_nodes[node];
+    if (entry.prev != kNil) {
+        m_nodes[entry.prev].next = entry.next;
+    } else {
+        m_locates[entry.locate].orders = entry.next;
+    }
+    if (entry.next != kNil) {
+        m_nodes[entry.next].prev = entry.prev;
+    }
+}
+
+bool BookBuilder::insertOrder(const OrderEntry& entry) {
+    if (entry.ref == 0 || m_orderCount >= m_maxOrders) {
+        ++m_droppedOrders;
+        return false;
+    }
+    size_t slot = hashRef(entry.ref) & m_orderMask;
+    while (m_slots[slot].ref != 0) {
+        if (m_slots[slot].ref == entry.ref) {
+            // 重复的订单号，以新消息为准：先从档位中扣除旧订单的剩余量
+            const uint32_t node = m_slots[slot].node;
+            const OrderEntry& old = m_nodes[node];
+            applyDelta(old.locate, old.side, old.price, -static_cast<int64_t>(old.shares));
+            ++m_duplicateOrders;
+            unlinkOrder(node);
+            m_nodes[node] = entry;
+            linkOrder(node);
+            return true;
+        }
+        slot = (slot + 1) & m_orderMask;
+    }
+    const uint32_t node = m_freeNodes;
+    m_freeNodes = m_nodes[node].next;
+    m_nodes[node] = entry;
+    linkOrder(node);
+    m_slots[slot] = OrderSlot{entry.ref, node};
+    ++m_orderCount;
+    return true;
+}
+
+void BookBuilder::eraseOrder(OrderEntry* entry) {
+    const uint32_t node = static_cast<uint32_t>(entry - m_nodes.data());
+    size_t hole = hashRef(entry->ref) & m_orderMask;
+    while (m_slots[hole].ref != entry->ref) {
+        hole = (hole + 1) & m_orderMask;
+    }
+    unlinkOrder(node);
+    entry->ref = 0;
+    entry->next = m_freeNodes;
+    m_freeNodes = node;
+
+    // 后移删除：把探测链上后续元素前移填补空洞，不留墓碑
+    size_t slot = (hole + 1) & m_orderMask;
+    while (m_slots[slot].ref != 0) {
+        const size_t home = hashRef(m_slots[slot].ref) & m_orderMask;
+        // home不在(hole, slot]循环区间内时，该元素可以前移到hole
+        if (((slot - home) & m_orderMask) >= ((slot - hole) & m_orderMask)) {
+            m_slots[hole] = m_slots[slot];
+            hole = slot;
+        }
+        slot = (slot + 1) & m_orderMask;
+    }
+    m_slots[hole].ref = 0;
+    --m_orderCount;
+}
+
+market::PriceLevelBook& BookBuilder::bookFor(uint16_t locate, std::string_view stock) {
+    LocateState& state = m_locates[locate];
+    if (!state.book) {
+        state.book = std::make_unique<market::PriceLevelBook>(m_tickSize);
+    }
+    if (state.symbol == core::kInvalidSymbol && !stock.empty()) {
+        state.symbol = core::internSymbol(stock);
+    }
+    return *state.book;
+}
+
+void BookBuilder::applyDelta(uint16_t locate, uint8_t side, uint32_t price, int64_t deltaShares) {
+    LocateState& state = m_locates[locate];
+    if (!state.book) {
+        return;
+    }
+    const types::Side bookSide = toSide(side);
+    const types::Price levelPrice = static_cast<types::Price>(price);
+    types::Volume volume = state.book->volumeAt(bookSide, levelPrice) + toVolume(deltaShares);
+    if (volume < 0) {
+        volume = 0;
+    }
+    state.book->updateLevel(bookSide, levelPrice, volume);
+    if (m_listener) {
+        m_listener->onBookUpdate(state.symbol, bookSide, levelPrice, volume, *state.book);
+    }
+}
+
+void BookBuilder::reduceOrder(OrderEntry* order, uint32_t shares) {
+    const uint32_t removed = shares < order->shares ? shares : order->shares;
+    const uint16_t locate = order->locate;
+    const uint8_t side = order->side;
+    const uint32_t price = order->price;
+    order->shares -= removed;
+    if (order->shares == 0) {
+        eraseOrder(order);
+    }
+    applyDelta(locate, side, price, -static_cast<int64_t>(removed));
+}
+
+void BookBuilder::notifyTrade(uint16_t locate, uint8_t side, uint32_t price, uint32_t shares, uint64_t timestamp) {
+    if (m_listener) {
+        m_listener->onTrade(m_locates[locate].symbol, toSide(side), static_cast<types::Price>(price),
+                            toVolume(shares), timestamp);
+    }
+}
+
+void BookBuilder::onStockDirectory(const itch::StockDirectoryView& msg) {
+    LocateState& state = m_locates[msg.locate()];
+    state.symbol = core::internSymbol(msg.stock());
+    bookFor(msg.locate(), msg.stock());
+}
+
+void BookBuilder::onAddOrder(const itch::AddOrderView& msg) {
+    const uint16_t locate = msg.locate();
+    bookFor(locate, msg.stock());
+    const OrderEntry entry{msg.orderRef(), msg.shares(), msg.price(), locate,
+                           static_cast<uint8_t>(msg.isBuy() ? 0 : 1), kNil, kNil};
+    if (insertOrder(entry)) {
+        applyDelta(locate, entry.side, entry.price, entry.shares);
+    }
+}
+
+void BookBuilder::onOrderExecuted(const itch::OrderExecutedView& msg) {
+    OrderEntry* order = findOrder(msg.orderRef());
+    if (!order) {
+        ++m_unknownOrders;
+        return;
+    }
+    const uint16_t locate = order->locate;
+    const uint8_t side = order->side;
+    const uint32_t price = order->price;
+    const uint32_t shares = msg.executedShares();
+    reduceOrder(order, shares);
+    notifyTrade(locate, side, price, shares, msg.timestamp());
+}
+
+void BookBuilder::onOrderExecutedWithPrice(const itch::OrderExecutedWithPriceView& msg) {
+    OrderEntry* order = findOrder(msg.orderRef());
+    if (!order) {
+        ++m_unknownOrders;
+        return;
+    }
+    const uint16_t locate = order->locate;
+    const uint8_t side = order->side;
+    const uint32_t shares = msg.executedShares();
+    reduceOrder(order, shares);
+    if (msg.printable()) {
+        notifyTrade(locate, side, msg.executionPrice(), shares, msg.timestamp());
+    }
+}
+
+void BookBuilder::onOrderCancel(const itch::OrderCancelView& msg) {
+    OrderEntry* order = findOrder(msg.orderRef());
+    if (!order) {
+        ++m_unknownOrders;
+        return;
+    }
+    reduceOrder(order, msg.cancelledShares());
+}
+
+void BookBuilder::onOrderDelete(const itch::OrderDeleteView& msg) {
+    OrderEntry* order = findOrder(msg.orderRef());
+    if (!order) {
+        ++m_unknownOrders;
+        return;
+    }
+    reduceOrder(order, order->shares);
+}
+
+void BookBuilder::onOrderReplace(const itch::OrderReplaceView& msg) {
+    OrderEntry* order = findOrder(msg.originalOrderRef());
+    if (!order) {
+        ++m_unknownOrders;
+        return;
+    }
+    // 改单：原单整体删除，新单以新订单号继承方向与标的
+    const uint16_t locate = order->locate;
+    const uint8_t side = order->side;
+    reduceOrder(order, order->shares);
+    const OrderEntry entry{msg.newOrderRef(), msg.shares(), msg.price(), locate, side, kNil, kNil};
+    if (insertOrder(entry)) {
+        applyDelta(locate, side, entry.price, entry.shares);
+    }
+}
+
+void BookBuilder::onTrade(const itch::TradeView& msg) {
+    // 非显示订单成交，不影响可见订单簿
+    bookFor(msg.locate(), msg.stock());
+    notifyTrade(msg.locate(), static_cast<uint8_t>(msg.isBuy() ? 0 : 1), msg.price(), msg.shares(),
+                msg.timestamp());
+}
+
+void BookBuilder::onBookSnapshot(const itch::BookSnapshotView& msg) {
+    const uint16_t locate = msg.locate();
+    market::PriceLevelBook& book = bookFor(locate, std::string_view());
+
+    // 快照覆盖该标的的全部状态，此前的逐笔订单作废；只遍历该标的自己的订单链表
+    LocateState& state = m_locates[locate];
+    while (state.orders != kNil) {
+        eraseOrder(&m_nodes[state.orders]);
+    }
+
+    book.clear();
+    for (size_t i = 0; i < msg.bidCount(); ++i) {
+        book.updateLevel(types::Side::BUY, msg.bidPrice(i), toVolume(msg.bidShares(i)));
+    }
+    for (size_t i = 0; i < msg.askCount(); ++i) {
+        book.updateLevel(types::Side::SELL, msg.askPrice(i), toVolume(msg.askShares(i)));
+    }
+    if (m_listener) {
+        const core::SymbolId symbol = m_locates[locate].symbol;
+        m_listener->onBookUpdate(symbol, types::Side::BUY, book.bestBid(), book.bestBidVolume(), book);
+        m_listener->onBookUpdate(symbol, types::Side::SELL, book.bestAsk(), book.bestAskVolume(), book);
+    }
+}
+
+void BookBuilder::clear() {
+    resetOrders();
+    for (LocateState& state : m_locates) {
+        if (state.book) {
+            state.book->clear();
+        }
+    }
+    m_unknownOrders = 0;
+    m_droppedOrders = 0;
+    m_duplicateOrders = 0;
+}
+
+} // namespace network
+} // namespace hft
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ItchDecoder.h"
+#include "../core/SymbolRegistry.h"
+#include "../core/Types.h"
+#include "../market/PriceLevelBook.h"
+
+namespace hft {
+namespace network {
+
+// 订单簿变化通知（在解码线程上同步调用）
+class BookListener {
+public:
+    virtual ~BookListener() = default;
+
+    // 某档位变化，volume为变化后的该档总量（0表示该档被删除）
+    virtual void onBookUpdate(core::SymbolId symbol, types::Side side, types::Price price,
+                              types::Volume volume, const market::PriceLevelBook& book) = 0;
+    // 逐笔成交，side为被动方（挂单）方向
+    virtual void onTrade(core::SymbolId symbol, types::Side side, types::Price price,
+                         types::Volume volume, uint64_t timestamp) {
+        (void)symbol; (void)side; (void)price; (void)volume; (void)timestamp;
+    }
+};
+
+// 逐笔委托重建订单簿
+// 作为ItchDecoder的Handler使用：订单存放在预分配的节点池中，由开放寻址表按订单号索引，
+// 同一locate的订单串成侵入式双向链表，快照只遍历该标的自己的订单；
+// 每个locate对应一本PriceLevelBook，稳态下不分配内存。
+// 数量以股为单位，写入订单簿时按types::Volume放大10000倍。
+class BookBuilder {
+public:
+    explicit BookBuilder(size_t maxOrders = 1 << 20, types::Price tickSize = 100);
+
+    BookBuilder(const BookBuilder&) = delete;
+    BookBuilder& operator=(const BookBuilder&) = delete;
+
+    void setListener(BookListener* listener) { m_listener = listener; }
+
+    // 解码回调
+    void onStockDirectory(const itch::StockDirectoryView& msg);
+    void onAddOrder(const itch::AddOrderView& msg);
+    void onOrderExecuted(const itch::OrderExecutedView& msg);
+    void onOrderExecutedWithPrice(const itch::OrderExecutedWithPriceView& msg);
+    void onOrderCancel(const itch::OrderCancelView& msg);
+    void onOrderDelete(const itch::OrderDeleteView& msg);
+    void onOrderReplace(const itch::OrderReplaceView& msg);
+    void onTrade(const itch::TradeView& msg);
+    void onBookSnapshot(const itch::BookSnapshotView& msg);
+
+    // 查询（与解码在同一线程调用）
+    const market::PriceLevelBook* book(uint16_t locate) const { return m_locates[locate].book.get(); }
+    core::SymbolId symbolOf(uint16_t locate) const { return m_locates[locate].symbol; }
+    size_t liveOrders() const { return m_orderCount; }
+    uint64_t unknownOrders() const { return m_unknownOrders; }
+    uint64_t droppedOrders() const { return m_droppedOrders; }
+    uint64_t duplicateOrders() const { return m_duplicateOrders; }
+
+    void clear();
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    // 订单节点，在节点池中的位置固定不动
+    struct OrderEntry {
+        uint64_t ref;
+        uint32_t shares;
+        uint32_t price;
+        uint16_t locate;
+        uint8_t side;            // 0买 1卖
+        uint32_t prev;           // 同一locate的订单链表（节点下标），空闲节点用next串成空闲链
+        uint32_t next;
+    };
+
+    // 哈希槽：订单号 -> 节点下标，ref为0表示空槽
+    struct OrderSlot {
+        uint64_t ref;
+        uint32_t node;
+    };
+
+    struct LocateState {
+        core::SymbolId symbol = core::kInvalidSymbol;
+        uint32_t orders = kNil;  // 该标的订单链表头
+        std::unique_ptr<market::PriceLevelBook> book;
+    };
+
+    static size_t hashRef(uint64_t ref);
+
+    OrderEntry* findOrder(uint64_t ref);
+    bool insertOrder(const OrderEntry& entry);
+    void eraseOrder(OrderEntry* entry);
+    void linkOrder(uint32_t node);
+    void unlinkOrder(uint32_t node);
+    void resetOrders();
+
+    market::PriceLevelBook& bookFor(uint16_t locate, std::string_view stock);
+    void applyDelta(uint16_t locate, uint8_t side, uint32_t price, int64_t deltaShares);
+    // 订单减少shares股，减到0时删除
+    void reduceOrder(OrderEntry* order, uint32_t shares);
+    void notifyTrade(uint16_t locate, uint8_t side, uint32_t price, uint32_t shares, uint64_t timestamp);
+
+    static types::Side toSide(uint8_t side) { return side == 0 ? types::Side::BUY : types::Side::SELL; }
+    static types::Volume toVolume(int64_t shares) { return shares * 10000; }
+
+    types::Price m_tickSize;
+    BookListener* m_listener;
+    std::vector<OrderEntry> m_nodes;         // maxOrders个节点
+    uint32_t m_freeNodes;
+    std::vector<OrderSlot> m_slots;
+    size_t m_orderMask;
+    size_t m_orderCount;
+    size_t m_maxOrders;
+    std::vector<LocateState> m_locates;      // 以locate为下标，共65536项
+    uint64_t m_unknownOrders;
+    uint64_t m_droppedOrders;
+    uint64_t m_duplicateOrders;              // 订单号重复的新增/改单（以新消息为准）
+};
+
+} // namespace network
+} // namespace hft
@@ -3,6 +3,7 @@
 #include <infiniband/verbs.h>
 #include <sys/mman.h>
 #include <atomic>
+#include <algorithm>
 
 namespace hft {
 namespace network {
@@ -45,25 +46,68 @@ bool DistributedCommunicator::initializeRDMA(const char* device_name) {
 }
 
 bool DistributedCommunicator::setupSharedMemory(size_t size) {
-    // 分配共享内存
-    void* shm = mmap(nullptr, size, 
-                     PROT_READ | PROT_WRITE,
-                     MAP_SHARED | MAP_ANONYMOUS,
-                     -1, 0);
-                     
-    if (shm == MAP_FAILED) {
+    // 按默认槽位大小换算槽位数
+    ShmBusConfig config;
+    config.slot_count = std::max<size_t>(2, size / shm::slotStride(config.slot_size));
+    return setupSharedMemory(std::string(), config);
+}
+
+bool DistributedCommunicator::setupSharedMemory(const std::string& name, const ShmBusConfig& config) {
+    auto publisher = std::make_unique<ShmBusPublisher>();
+    if (!publisher->create(name, config)) {
         Logger::error("Failed to allocate shared memory");
         return false;
     }
 
-    shared_memory_ = shm;
-    
-    // 注册内存区域
-    registerMemoryRegion();
-    
+    shm_publisher_ = std::move(publisher);
+    return true;
+}
+
+bool DistributedCommunicator::attachSharedMemory(const std::string& name, ShmBusStart start) {
+    auto subscriber = std::make_unique<ShmBusSubscriber>();
+    if (!subscriber->open(name, start)) {
+        return false;
+    }
+    shm_subscriber_ = std::move(subscriber);
+    return true;
+}
+
+bool DistributedCommunicator::attachSharedMemory(int fd, ShmBusStart start) {
+    auto subscriber = std::make_unique<ShmBusSubscriber>();
+    if (!subscriber->attach(fd, start)) {
+        return false;
+    }
+    shm_subscriber_ = std::move(subscriber);
     return true;
 }
 
+bool DistributedCommunicator::publishShared(const void* data, size_t size) {
+    return shm_publisher_ && shm_publisher_->publish(data, size);
+}
+
+size_t DistributedCommunicator::pollSharedMemory(size_t max_messages) {
+    if (!shm_subscriber_) {
+        return 0;
+    }
+    return shm_subscriber_->poll([this](const uint8_t* data, size_t size) {
+        if (receive_callback_) {
+            receive_callback_(data, size);
+        }
+    }, max_messages);
+}
+
+int DistributedCommunicator::sharedMemoryFd() const {
+    return shm_publisher_ ? shm_publisher_->fd() : -1;
+}
+
+ShmBusStats DistributedCommunicator::getSharedMemoryStats() const {
+    return shm_subscriber_ ? shm_subscriber_->stats() : ShmBusStats();
+}
+
+void DistributedCommunicator::registerReceiveCallback(std::function<void(const void*, size_t)> callback) {
+    receive_callback_ = std::move(callback);
+}
+
 bool DistributedCommunicator::connectPeer(const std::string& remote_address) {
     try {
         // 解析远程地址
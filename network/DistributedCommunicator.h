@@ -4,7 +4,9 @@
 #include <string>
 #include <vector>
 #include <atomic>
+#include <functional>
 #include "../core/Types.h"
+#include "SharedMemoryBus.h"
 
 namespace hft {
 namespace network {
@@ -14,8 +16,20 @@ public:
     // 初始化RDMA
     bool initializeRDMA(const char* device_name);
     
-    // 配置共享内存
+    // 配置共享内存：创建容量约为size字节的匿名共享内存总线（发布方）
     bool setupSharedMemory(size_t size);
+    // 创建具名共享内存总线（发布方），同机其他进程可按名称订阅
+    bool setupSharedMemory(const std::string& name, const ShmBusConfig& config = ShmBusConfig());
+    // 订阅其他进程发布的共享内存总线
+    bool attachSharedMemory(const std::string& name, ShmBusStart start = ShmBusStart::LATEST);
+    bool attachSharedMemory(int fd, ShmBusStart start = ShmBusStart::LATEST);
+    // 向共享内存总线广播一条消息
+    bool publishShared(const void* data, size_t size);
+    // 读取已订阅总线上的新消息并交给接收回调，返回处理条数
+    size_t pollSharedMemory(size_t max_messages = 64);
+    // 匿名总线的文件描述符，供子进程继承
+    int sharedMemoryFd() const;
+    ShmBusStats getSharedMemoryStats() const;
     
     // 建立RDMA连接
     bool connectPeer(const std::string& remote_address);
@@ -51,7 +65,9 @@ private:
 
 private:
     void* rdma_context_{nullptr};     // RDMA上下文
-    void* shared_memory_{nullptr};     // 共享内存区域
+    std::unique_ptr<ShmBusPublisher> shm_publisher_;     // 本进程发布的共享内存总线
+    std::unique_ptr<ShmBusSubscriber> shm_subscriber_;   // 本进程订阅的共享内存总线
+    std::function<void(const void*, size_t)> receive_callback_;
     std::atomic<bool> running_{false}; // 运行标志
     
     // RDMA参数
@@ -0,0 +1,145 @@
+#include "FeedReplay.h"
+#include <iostream>
+#include "../utils/MappedFile.h"
+
+namespace hft {
+namespace network {
+
+namespace {
+
+// pcap全局头与记录头
+constexpr size_t kPcapGlobalHeaderSize = 24;
+constexpr size_t kPcapRecordHeaderSize = 16;
+constexpr uint32_t kPcapMagicMicros = 0xA1B2C3D4;
+constexpr uint32_t kPcapMagicNanos = 0xA1B23C4D;
+constexpr uint32_t kLinkTypeEthernet = 1;
+
+constexpr uint16_t kEtherTypeIPv4 = 0x0800;
+constexpr uint16_t kEtherTypeVlan = 0x8100;
+constexpr uint8_t kIpProtocolUdp = 17;
+
+uint32_t loadLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// 从以太网帧中取出UDP负载，失败返回false
+bool extractUdpPayload(const uint8_t* frame, size_t size, uint16_t udpPort,
+                       const uint8_t*& payload, size_t& payloadSize) {
+    size_t offset = 12;
+    if (size < offset + 2) {
+        return false;
+    }
+    uint16_t etherType = wire::loadBE16(frame + offset);
+    offset += 2;
+    while (etherType == kEtherTypeVlan) {
+        if (size < offset + 4) {
+            return false;
+        }
+        etherType = wire::loadBE16(frame + offset + 2);
+        offset += 4;
+    }
+    if (etherType != kEtherTypeIPv4 || size < offset + 20) {
+        return false;
+    }
+
+    const uint8_t* ip = frame + offset;
+    const size_t ipHeaderSize = static_cast<size_t>(ip[0] & 0x0F) * 4;
+    const size_t ipTotal = wire::loadBE16(ip + 2);
+    // 分片报文不重组
+    const uint16_t fragment = wire::loadBE16(ip + 6);
+    if ((ip[0] >> 4) != 4 || ip[9] != kIpProtocolUdp || ipHeaderSize < 20 ||
+        (fragment & 0x3FFF) != 0 || offset + ipTotal > size || ipTotal < ipHeaderSize + 8) {
+        return false;
+    }
+
+    const uint8_t* udp = ip + ipHeaderSize;
+    const uint16_t dstPort = wire::loadBE16(udp + 2);
+    const size_t udpLength = wire::loadBE16(udp + 4);
+    if ((udpPort != 0 && dstPort != udpPort) || udpLength < 8 ||
+        udpLength > ipTotal - ipHeaderSize) {
+        return false;
+    }
+
+    payload = udp + 8;
+    payloadSize = udpLength - 8;
+    return true;
+}
+
+} // namespace
+
+bool FeedReplay::replayPcap(const std::string& path, FeedDecoder& decoder,
+                            FeedReplayStats* stats, uint16_t udpPort) {
+    utils::MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Failed to map pcap file: " << path << std::endl;
+        return false;
+    }
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+    if (size < kPcapGlobalHeaderSize) {
+        std::cerr << "Truncated pcap header: " << path << std::endl;
+        return false;
+    }
+
+    // 只支持小端写出的pcap（x86抓包的常见情况）
+    const uint32_t magic = loadLE32(data);
+    if (magic != kPcapMagicMicros && magic != kPcapMagicNanos) {
+        std::cerr << "Unsupported pcap format: " << path << std::endl;
+        return false;
+    }
+    if (loadLE32(data + 20) != kLinkTypeEthernet) {
+        std::cerr << "Unsupported pcap link type: " << path << std::endl;
+        return false;
+    }
+
+    FeedReplayStats local;
+    size_t offset = kPcapGlobalHeaderSize;
+    while (offset + kPcapRecordHeaderSize <= size) {
+        const size_t captured = loadLE32(data + offset + 8);
+        offset += kPcapRecordHeaderSize;
+        if (offset + captured > size) {
+            ++local.skipped;
+            break;
+        }
+        ++local.records;
+        local.bytes += captured;
+
+        const uint8_t* payload = nullptr;
+        size_t payloadSize = 0;
+        if (extractUdpPayload(data + offset, captured, udpPort, payload, payloadSize)) {
+            ++local.packets;
+            local.messages += decoder.decodePacket(payload, payloadSize);
+        } else {
+            ++local.skipped;
+        }
+        offset += captured;
+    }
+
+    if (stats) {
+        *stats = local;
+    }
+    return true;
+}
+
+bool FeedReplay::replayRaw(const std::string& path, FeedDecoder& decoder, FeedReplayStats* stats) {
+    utils::MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Failed to map feed file: " << path << std::endl;
+        return false;
+    }
+
+    FeedReplayStats local;
+    local.bytes = file.size();
+    local.packets = 1;
+    local.messages = decoder.decodeStream(file.data(), file.size());
+    local.records = local.messages;
+
+    if (stats) {
+        *stats = local;
+    }
+    return true;
+}
+
+} // namespace network
+} // namespace hft
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "ItchDecoder.h"
+
+namespace hft {
+namespace network {
+
+// 回放统计
+struct FeedReplayStats {
+    uint64_t records = 0;            // pcap记录数或原始消息数
+    uint64_t packets = 0;            // 交给解码器的包数
+    uint64_t messages = 0;           // 解码出的消息数
+    uint64_t skipped = 0;            // 非IPv4/UDP、端口不匹配或截断的记录
+    uint64_t bytes = 0;
+};
+
+// 行情抓包/文件回放
+// 文件整体mmap，记录直接以映射内存的指针交给解码器，不拷贝。
+class FeedReplay {
+public:
+    // pcap文件（以太网链路，可带802.1Q标签）：UDP负载按MoldUDP64包解码
+    // udpPort为0时不过滤目的端口
+    static bool replayPcap(const std::string& path, FeedDecoder& decoder,
+                           FeedReplayStats* stats = nullptr, uint16_t udpPort = 0);
+
+    // 原始消息文件：u16大端长度 + 消息，依次排列（NASDAQ ITCH文件格式）
+    static bool replayRaw(const std::string& path, FeedDecoder& decoder,
+                          FeedReplayStats* stats = nullptr);
+};
+
+} // namespace network
+} // namespace hft
@@ -0,0 +1,297 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace hft {
+namespace network {
+
+// 大端字段读取（线路格式为网络字节序）
+namespace wire {
+
+inline uint16_t loadBE16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+inline uint32_t loadBE32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(_MSC_VER)
+    return _byteswap_ulong(v);
+#else
+    return __builtin_bswap32(v);
+#endif
+}
+
+inline uint64_t loadBE64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(_MSC_VER)
+    return _byteswap_uint64(v);
+#else
+    return __builtin_bswap64(v);
+#endif
+}
+
+inline uint64_t loadBE48(const uint8_t* p) {
+    return (static_cast<uint64_t>(loadBE16(p)) << 32) | loadBE32(p + 2);
+}
+
+// 去掉右侧空格填充
+inline std::string_view trimAlpha(const uint8_t* p, size_t n) {
+    while (n > 0 && p[n - 1] == ' ') {
+        --n;
+    }
+    return std::string_view(reinterpret_cast<const char*>(p), n);
+}
+
+} // namespace wire
+
+// ITCH 5.0风格的定长消息
+// 所有视图直接指向收包缓冲区，访问时才按偏移读取字段，不拷贝、不分配。
+// 价格为4位隐含小数的整数，与types::Price的放大倍数一致。
+namespace itch {
+
+constexpr uint8_t kStockDirectory = 'R';
+constexpr uint8_t kAddOrder = 'A';
+constexpr uint8_t kAddOrderMpid = 'F';
+constexpr uint8_t kOrderExecuted = 'E';
+constexpr uint8_t kOrderExecutedWithPrice = 'C';
+constexpr uint8_t kOrderCancel = 'X';
+constexpr uint8_t kOrderDelete = 'D';
+constexpr uint8_t kOrderReplace = 'U';
+constexpr uint8_t kTrade = 'P';
+constexpr uint8_t kBookSnapshot = 'b';       // 扩展：按档位的全量快照
+
+// 公共头：type(1) locate(2) tracking(2) timestamp(6)
+constexpr size_t kHeaderSize = 11;
+
+struct MessageView {
+    const uint8_t* p;
+    uint8_t type() const { return p[0]; }
+    uint16_t locate() const { return wire::loadBE16(p + 1); }
+    uint64_t timestamp() const { return wire::loadBE48(p + 5); }   // 当日零点起的纳秒
+};
+
+struct StockDirectoryView : MessageView {
+    static constexpr size_t kSize = 39;
+    std::string_view stock() const { return wire::trimAlpha(p + 11, 8); }
+};
+
+struct AddOrderView : MessageView {
+    static constexpr size_t kSize = 36;
+    uint64_t orderRef() const { return wire::loadBE64(p + 11); }
+    bool isBuy() const { return p[19] == 'B'; }
+    uint32_t shares() const { return wire::loadBE32(p + 20); }
+    std::string_view stock() const { return wire::trimAlpha(p + 24, 8); }
+    uint32_t price() const { return wire::loadBE32(p + 32); }
+};
+
+struct OrderExecutedView : MessageView {
+    static constexpr size_t kSize = 31;
+    uint64_t orderRef() const { return wire::loadBE64(p + 11); }
+    uint32_t executedShares() const { return wire::loadBE32(p + 19); }
+    uint64_t matchNumber() const { return wire::loadBE64(p + 23); }
+};
+
+struct OrderExecutedWithPriceView : OrderExecutedView {
+    static constexpr size_t kSize = 36;
+    bool printable() const { return p[31] == 'Y'; }
+    uint32_t executionPrice() const { return wire::loadBE32(p + 32); }
+};
+
+struct OrderCancelView : MessageView {
+    static constexpr size_t kSize = 23;
+    uint64_t orderRef() const { return wire::loadBE64(p + 11); }
+    uint32_t cancelledShares() const { return wire::loadBE32(p + 19); }
+};
+
+struct OrderDeleteView : MessageView {
+    static constexpr size_t kSize = 19;
+    uint64_t orderRef() const { return wire::loadBE64(p + 11); }
+};
+
+struct OrderReplaceView : MessageView {
+    static constexpr size_t kSize = 35;
+    uint64_t originalOrderRef() const { return wire::loadBE64(p + 11); }
+    uint64_t newOrderRef() const { return wire::loadBE64(p + 19); }
+    uint32_t shares() const { return wire::loadBE32(p + 27); }
+    uint32_t price() const { return wire::loadBE32(p + 31); }
+};
+
+struct TradeView : MessageView {
+    static constexpr size_t kSize = 44;
+    uint64_t orderRef() const { return wire::loadBE64(p + 11); }
+    bool isBuy() const { return p[19] == 'B'; }
+    uint32_t shares() const { return wire::loadBE32(p + 20); }
+    std::string_view stock() const { return wire::trimAlpha(p + 24, 8); }
+    uint32_t price() const { return wire::loadBE32(p + 32); }
+    uint64_t matchNumber() const { return wire::loadBE64(p + 36); }
+};
+
+// 快照：头(11) bidCount(1) askCount(1)，随后bidCount个买档、askCount个卖档，
+// 每档 price(4) shares(4)，买档由高到低、卖档由低到高
+struct BookSnapshotView : MessageView {
+    static constexpr size_t kFixedSize = 13;
+    static constexpr size_t kLevelSize = 8;
+    uint8_t bidCount() const { return p[11]; }
+    uint8_t askCount() const { return p[12]; }
+    uint32_t bidPrice(size_t i) const { return wire::loadBE32(p + kFixedSize + i * kLevelSize); }
+    uint32_t bidShares(size_t i) const { return wire::loadBE32(p + kFixedSize + i * kLevelSize + 4); }
+    uint32_t askPrice(size_t i) const { return wire::loadBE32(p + kFixedSize + (bidCount() + i) * kLevelSize); }
+    uint32_t askShares(size_t i) const { return wire::loadBE32(p + kFixedSize + (bidCount() + i) * kLevelSize + 4); }
+    size_t size() const { return kFixedSize + (static_cast<size_t>(bidCount()) + askCount()) * kLevelSize; }
+};
+
+// MoldUDP64包头：session(10) sequence(8) messageCount(2)
+constexpr size_t kMoldHeaderSize = 20;
+constexpr uint16_t kMoldEndOfSession = 0xFFFF;
+
+} // namespace itch
+
+// 解码统计
+struct FeedDecoderStats {
+    uint64_t packets = 0;
+    uint64_t messages = 0;
+    uint64_t unknown_messages = 0;   // 不关心的消息类型
+    uint64_t malformed = 0;          // 长度不足或截断
+    uint64_t last_sequence = 0;      // 最近一个MoldUDP64包的起始序号
+};
+
+// 可插拔解码器接口（每包一次虚调用，消息级分发在具体解码器内静态完成）
+class FeedDecoder {
+public:
+    virtual ~FeedDecoder() = default;
+
+    // 解码一个网络包（如MoldUDP64），返回解出的消息数
+    virtual size_t decodePacket(const uint8_t* data, size_t size) = 0;
+    // 解码长度前缀的消息流（u16大端长度 + 消息，文件回放使用）
+    virtual size_t decodeStream(const uint8_t* data, size_t size) = 0;
+
+    const FeedDecoderStats& stats() const { return m_stats; }
+
+protected:
+    FeedDecoderStats m_stats;
+};
+
+// ITCH风格解码器
+// Handler需提供与消息视图对应的onXxx(const XxxView&)成员，调用在编译期绑定可被内联。
+template<typename Handler>
+class ItchDecoder final : public FeedDecoder {
+public:
+    explicit ItchDecoder(Handler& handler) : m_handler(handler) {}
+
+    size_t decodePacket(const uint8_t* data, size_t size) override {
+        ++m_stats.packets;
+        if (size < itch::kMoldHeaderSize) {
+            ++m_stats.malformed;
+            return 0;
+        }
+        m_stats.last_sequence = wire::loadBE64(data + 10);
+        const uint16_t count = wire::loadBE16(data + 18);
+        if (count == itch::kMoldEndOfSession) {
+            return 0;
+        }
+
+        size_t offset = itch::kMoldHeaderSize;
+        size_t decoded = 0;
+        for (uint16_t i = 0; i < count; ++i) {
+            if (offset + 2 > size) {
+                ++m_stats.malformed;
+                break;
+            }
+            const uint16_t length = wire::loadBE16(data + offset);
+            offset += 2;
+            if (offset + length > size) {
+                ++m_stats.malformed;
+                break;
+            }
+            decoded += decodeMessage(data + offset, length);
+            offset += length;
+        }
+        return decoded;
+    }
+
+    size_t decodeStream(const uint8_t* data, size_t size) override {
+        size_t offset = 0;
+        size_t decoded = 0;
+        while (offset + 2 <= size) {
+            const uint16_t length = wire::loadBE16(data + offset);
+            if (offset + 2 + length > size) {
+                ++m_stats.malformed;
+                break;
+            }
+            decoded += decodeMessage(data + offset + 2, length);
+            offset += 2 + length;
+        }
+        return decoded;
+    }
+
+    // 解码单条消息，成功返回1
+    size_t decodeMessage(const uint8_t* msg, size_t length) {
+        if (length < itch::kHeaderSize) {
+            ++m_stats.malformed;
+            return 0;
+        }
+        switch (msg[0]) {
+            case itch::kAddOrder:
+            case itch::kAddOrderMpid:
+                return dispatch<itch::AddOrderView>(msg, length);
+            case itch::kOrderExecuted:
+                return dispatch<itch::OrderExecutedView>(msg, length);
+            case itch::kOrderExecutedWithPrice:
+                return dispatch<itch::OrderExecutedWithPriceView>(msg, length);
+            case itch::kOrderCancel:
+                return dispatch<itch::OrderCancelView>(msg, length);
+            case itch::kOrderDelete:
+                return dispatch<itch::OrderDeleteView>(msg, length);
+            case itch::kOrderReplace:
+                return dispatch<itch::OrderReplaceView>(msg, length);
+            case itch::kTrade:
+                return dispatch<itch::TradeView>(msg, length);
+            case itch::kStockDirectory:
+                return dispatch<itch::StockDirectoryView>(msg, length);
+            case itch::kBookSnapshot: {
+                itch::BookSnapshotView view{{msg}};
+                if (length < itch::BookSnapshotView::kFixedSize || length < view.size()) {
+                    ++m_stats.malformed;
+                    return 0;
+                }
+                ++m_stats.messages;
+                m_handler.onBookSnapshot(view);
+                return 1;
+            }
+            default:
+                ++m_stats.unknown_messages;
+                return 0;
+        }
+    }
+
+private:
+    template<typename View>
+    size_t dispatch(const uint8_t* msg, size_t length) {
+        if (length < View::kSize) {
+            ++m_stats.malformed;
+            return 0;
+        }
+        ++m_stats.messages;
+        View view;
+        view.p = msg;
+        handle(view);
+        return 1;
+    }
+
+    void handle(const itch::AddOrderView& v) { m_handler.onAddOrder(v); }
+    void handle(const itch::OrderExecutedWithPriceView& v) { m_handler.onOrderExecutedWithPrice(v); }
+    void handle(const itch::OrderExecutedView& v) { m_handler.onOrderExecuted(v); }
+    void handle(const itch::OrderCancelView& v) { m_handler.onOrderCancel(v); }
+    void handle(const itch::OrderDeleteView& v) { m_handler.onOrderDelete(v); }
+    void handle(const itch::OrderReplaceView& v) { m_handler.onOrderReplace(v); }
+    void handle(const itch::TradeView& v) { m_handler.onTrade(v); }
+    void handle(const itch::StockDirectoryView& v) { m_handler.onStockDirectory(v); }
+
+    Handler& m_handler;
+};
+
+} // namespace network
+} // namespace hft
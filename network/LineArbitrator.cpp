@@ -0,0 +1,189 @@
+#include "LineArbitrator.h"
+#include <algorithm>
+#include <cstring>
+
+namespace hft {
+namespace network {
+
+LineArbitrator::LineArbitrator(FeedDecoder& decoder, const LineArbitratorConfig& config)
+    : m_decoder(decoder), m_config(config), m_bufferedCount(0),
+      m_expected(config.initial_sequence), m_highest(config.initial_sequence),
+      m_inGap(false), m_gapSince(0), m_requested(false), m_lastRequest(0) {
+    size_t capacity = 1;
+    while (capacity < m_config.reorder_capacity) {
+        capacity <<= 1;
+    }
+    m_config.reorder_capacity = capacity;
+    m_mask = capacity - 1;
+    m_slots.assign(capacity, Slot{0, 0, 0});
+    m_storage.reset(new uint8_t[capacity * m_config.max_packet_size]);
+}
+
+void LineArbitrator::onPacket(FeedLine line, const uint8_t* data, size_t size, uint64_t now) {
+    const size_t lineIndex = static_cast<size_t>(line);
+    ++m_stats.packets[lineIndex];
+    if (size < itch::kMoldHeaderSize) {
+        // 交给解码器记录畸形包
+        m_decoder.decodePacket(data, size);
+        return;
+    }
+
+    const uint64_t sequence = wire::loadBE64(data + 10);
+    uint16_t count = wire::loadBE16(data + 18);
+    if (count == itch::kMoldEndOfSession) {
+        count = 0;
+    }
+    const uint64_t end = sequence + count;
+
+    if (m_expected == 0) {
+        m_expected = sequence;
+        m_highest = sequence;
+    }
+    m_highest = std::max(m_highest, end);
+
+    if (count == 0) {
+        // 心跳：序号即发送方的下一条消息序号，超前说明有丢包
+    } else if (end <= m_expected) {
+        ++m_stats.duplicates;
+    } else if (sequence <= m_expected) {
+        ++m_stats.first_arrivals[lineIndex];
+        const uint64_t from = m_expected;
+        deliver(data, size, sequence, end);
+        if (m_bufferedCount > 0) {
+            drain(from);
+        }
+    } else {
+        buffer(data, size, sequence, end, now);
+    }
+
+    updateGap(now);
+    poll(now);
+}
+
+void LineArbitrator::deliver(const uint8_t* data, size_t size, uint64_t sequence, uint64_t end) {
+    if (sequence == m_expected) {
+        m_decoder.decodePacket(data, size);
+    } else {
+        // 包的前半部分已由其他包交付，跳过这些消息后按长度前缀流解码其余部分
+        size_t offset = itch::kMoldHeaderSize;
+        for (uint64_t skip = m_expected - sequence; skip > 0 && offset + 2 <= size; --skip) {
+            offset += 2 + wire::loadBE16(data + offset);
+        }
+        if (offset < size) {
+            m_decoder.decodeStream(data + offset, size - offset);
+        }
+    }
+    m_expected = end;
+}
+
+void LineArbitrator::buffer(const uint8_t* data, size_t size, uint64_t sequence, uint64_t end, uint64_t now) {
+    // 窗口内不同序号映射到不同槽位
+    if (sequence - m_expected >= m_config.reorder_capacity || size > m_config.max_packet_size) {
+        ++m_stats.overflows;
+        requestRecovery(now);
+        return;
+    }
+    Slot& slot = slotOf(sequence);
+    if (slot.sequence == sequence) {
+        ++m_stats.duplicates;
+        return;
+    }
+    if (slot.sequence == 0) {
+        ++m_bufferedCount;
+    }
+    // 槽内若是已落后于窗口的旧包，直接覆盖
+    slot.sequence = sequence;
+    slot.end = end;
+    slot.size = static_cast<uint32_t>(size);
+    std::memcpy(storageOf(slot), data, size);
+    ++m_stats.buffered;
+}
+
+void LineArbitrator::release(Slot& slot) {
+    const uint64_t sequence = slot.sequence;
+    const uint64_t end = slot.end;
+    slot.sequence = 0;
+    --m_bufferedCount;
+    if (end > m_expected) {
+        deliver(storageOf(slot), slot.size, sequence, end);
+    }
+}
+
+void LineArbitrator::drain(uint64_t from) {
+    while (m_bufferedCount > 0) {
+        const uint64_t before = m_expected;
+        // 起点落在[from, 期望序号)内的缓存包已被全部或部分覆盖
+        const uint64_t limit = std::min(m_expected, from + m_config.reorder_capacity);
+        for (uint64_t s = from; s < limit && m_bufferedCount > 0; ++s) {
+            Slot& slot = slotOf(s);
+            if (slot.sequence == s) {
+                release(slot);
+            }
+        }
+        Slot& next = slotOf(m_expected);
+        if (m_bufferedCount > 0 && next.sequence == m_expected) {
+            release(next);
+        }
+        if (m_expected == before) {
+            break;
+        }
+        from = before;
+    }
+}
+
+void LineArbitrator::updateGap(uint64_t now) {
+    if (m_bufferedCount == 0 && m_highest <= m_expected) {
+        m_inGap = false;
+        m_requested = false;
+    } else if (!m_inGap) {
+        m_inGap = true;
+        m_gapSince = now;
+        ++m_stats.gaps;
+    }
+    m_stats.next_sequence = m_expected;
+}
+
+void LineArbitrator::poll(uint64_t now) {
+    if (m_inGap && now - m_gapSince >= m_config.gap_timeout_ns) {
+        requestRecovery(now);
+    }
+}
+
+void LineArbitrator::requestRecovery(uint64_t now) {
+    if (m_requested && now - m_lastRequest < m_config.gap_timeout_ns) {
+        return;
+    }
+    m_requested = true;
+    m_lastRequest = now;
+    ++m_stats.recovery_requests;
+    if (m_recoveryHandler) {
+        m_recoveryHandler(m_expected, m_highest);
+    }
+}
+
+void LineArbitrator::resetSequence(uint64_t nextSequence, uint64_t now) {
+    if (nextSequence > m_expected) {
+        m_stats.skipped_messages += m_expected == 0 ? 0 : nextSequence - m_expected;
+    }
+    const uint64_t from = m_expected;
+    m_expected = nextSequence;
+    m_highest = std::max(m_highest, nextSequence);
+
+    // 丢弃已被快照覆盖的缓存包，其余的继续按序释放
+    for (Slot& slot : m_slots) {
+        if (slot.sequence != 0 && slot.end <= nextSequence) {
+            slot.sequence = 0;
+            --m_bufferedCount;
+        }
+    }
+    if (m_bufferedCount > 0) {
+        const uint64_t window = m_config.reorder_capacity;
+        drain(nextSequence > from + window ? nextSequence - window : from);
+    }
+    m_inGap = false;
+    m_requested = false;
+    updateGap(now);
+}
+
+} // namespace network
+} // namespace hft
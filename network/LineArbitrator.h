@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "ItchDecoder.h"
+
+namespace hft {
+namespace network {
+
+// 冗余线路
+enum class FeedLine : uint8_t {
+    A = 0,
+    B = 1,
+    RECOVERY = 2      // 重传/补包通道，与A/B同样参与去重
+};
+
+// 仲裁配置
+struct LineArbitratorConfig {
+    size_t reorder_capacity = 1024;       // 乱序缓存的包数（向上取2的幂）
+    size_t max_packet_size = 1500;        // 单个缓存槽的字节数
+    uint64_t gap_timeout_ns = 500000;     // 缺口在此时间内未被另一线路补上时请求恢复
+    uint64_t initial_sequence = 0;        // 期望的首个序号，0表示以收到的第一个包同步
+};
+
+// 仲裁统计
+struct LineArbitratorStats {
+    uint64_t packets[3] = {0, 0, 0};      // 各线路收到的包数
+    uint64_t first_arrivals[3] = {0, 0, 0};   // 各线路率先到达并被采用的包数
+    uint64_t duplicates = 0;
+    uint64_t gaps = 0;                    // 检测到的缺口数
+    uint64_t buffered = 0;                // 进入乱序缓存的包数
+    uint64_t overflows = 0;               // 超出缓存窗口的包数
+    uint64_t recovery_requests = 0;
+    uint64_t skipped_messages = 0;        // 快照恢复跳过的消息数
+    uint64_t next_sequence = 0;
+};
+
+// MoldUDP64 A/B线路仲裁与缺口恢复
+//
+//  - 两条线路的包按到达先后送入onPacket，按序号去重，先到者被采用：
+//    序号落后于期望值的包直接丢弃，每包O(1)
+//  - 序号超前时出现缺口，超前的包拷入以序号取模定位的定长乱序缓存，
+//    缺口补齐后按序释放
+//  - 缺口超过gap_timeout_ns未补齐，或超前包超出缓存窗口时，调用恢复回调；
+//    恢复方可通过RECOVERY线路补发，或在应用快照后调用resetSequence()跳过缺口
+//
+// 非线程安全：所有线路需在同一线程上送入（如同一个SocketPoller轮询线程）。
+class LineArbitrator {
+public:
+    // 请求恢复[from, to)区间的消息
+    using RecoveryHandler = std::function<void(uint64_t from, uint64_t to)>;
+
+    LineArbitrator(FeedDecoder& decoder, const LineArbitratorConfig& config = LineArbitratorConfig());
+
+    void setRecoveryHandler(RecoveryHandler handler) { m_recoveryHandler = std::move(handler); }
+
+    // 处理一条线路上收到的MoldUDP64包，now为单调时钟纳秒
+    void onPacket(FeedLine line, const uint8_t* data, size_t size, uint64_t now);
+    // 无新包时检查缺口超时（收到包时会自动检查）
+    void poll(uint64_t now);
+
+    // 快照恢复完成：之后从nextSequence开始继续，丢弃之前的缓存
+    void resetSequence(uint64_t nextSequence, uint64_t now);
+
+    uint64_t nextSequence() const { return m_expected; }
+    bool hasGap() const { return m_inGap; }
+    const LineArbitratorStats& stats() const { return m_stats; }
+
+private:
+    struct Slot {
+        uint64_t sequence;      // 包首条消息序号，0表示空
+        uint64_t end;           // 序号 + 消息数
+        uint32_t size;
+    };
+
+    // 交付序号为sequence的包，跳过其中已交付过的消息
+    void deliver(const uint8_t* data, size_t size, uint64_t sequence, uint64_t end);
+    void buffer(const uint8_t* data, size_t size, uint64_t sequence, uint64_t end, uint64_t now);
+    // 期望序号从from前进后，释放已可交付或已过期的缓存包
+    void drain(uint64_t from);
+    void release(Slot& slot);
+    void updateGap(uint64_t now);
+    void requestRecovery(uint64_t now);
+    Slot& slotOf(uint64_t sequence) { return m_slots[sequence & m_mask]; }
+    uint8_t* storageOf(const Slot& slot) { return m_storage.get() + (&slot - m_slots.data()) * m_config.max_packet_size; }
+
+    FeedDecoder& m_decoder;
+    LineArbitratorConfig m_config;
+    size_t m_mask;
+    std::vector<Slot> m_slots;
+    std::unique_ptr<uint8_t[]> m_storage;
+    size_t m_bufferedCount;
+    uint64_t m_expected;          // 期望的下一个消息序号，0表示尚未同步
+    uint64_t m_highest;           // 已见到的最大结束序号
+    bool m_inGap;
+    uint64_t m_gapSince;          // 当前缺口出现的时间
+    bool m_requested;
+    uint64_t m_lastRequest;       // 上次请求恢复的时间，同一缺口每个超时周期最多请求一次
+    RecoveryHandler m_recoveryHandler;
+    LineArbitratorStats m_stats;
+};
+
+} // namespace network
+} // namespace hft
@@ -0,0 +1,236 @@
+#include "LoopbackExchange.h"
+#include <algorithm>
+#include <iostream>
+
+namespace hft {
+namespace network {
+
+LoopbackExchange::LoopbackExchange(size_t maxOrders, size_t outputBytes)
+    : m_session(nullptr), m_orders(maxOrders), m_expectedInbound(1), m_nextExchangeId(1),
+      m_nextExecutionId(1), m_received(0), m_duplicates(0), m_fillOnAccept(false),
+      m_rejectNext(0), m_dropInbound(0), m_dropOutbound(0), m_connected(true),
+      m_resendRequestedTo(0) {
+    m_pending.reserve(outputBytes);
+    m_delivering.reserve(outputBytes);
+    m_outbound.reserve(outputBytes);
+    m_outboundOffsets.reserve(outputBytes / sizeof(oe::Header));
+}
+
+template<typename Message>
+Message* LoopbackExchange::stage() {
+    Message* message = oe::encode<Message>(m_buffer);
+    message->header.sequence = nextOutbound();
+    message->header.send_time = OrderEntrySession::nowNs();
+    return message;
+}
+
+void LoopbackExchange::commitReply(size_t size) {
+    m_outboundOffsets.push_back(m_outbound.size());
+    m_outbound.insert(m_outbound.end(), m_buffer, m_buffer + size);
+    if (m_dropOutbound > 0) {
+        --m_dropOutbound;
+        return;
+    }
+    m_pending.insert(m_pending.end(), m_buffer, m_buffer + size);
+}
+
+void LoopbackExchange::commitSession(size_t size) {
+    m_pending.insert(m_pending.end(), m_buffer, m_buffer + size);
+}
+
+bool LoopbackExchange::send(const void* data, size_t size) {
+    if (!m_connected) {
+        return false;
+    }
+    if (m_dropInbound > 0) {
+        --m_dropInbound;
+        return true;
+    }
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    size_t offset = 0;
+    while (offset < size) {
+        const size_t length = oe::frameLength(bytes + offset, size - offset);
+        if (length == 0) {
+            std::cerr << "Loopback exchange received malformed message" << std::endl;
+            break;
+        }
+        handle(bytes + offset, length);
+        offset += length;
+    }
+    return true;
+}
+
+size_t LoopbackExchange::pump() {
+    if (!m_session || m_pending.empty()) {
+        return 0;
+    }
+    // 会话处理回报时可能再次调用send()，新回报写入m_pending，下次pump()交付
+    m_delivering.swap(m_pending);
+    const size_t count = m_session->onData(m_delivering.data(), m_delivering.size());
+    m_delivering.clear();
+    return count;
+}
+
+void LoopbackExchange::replay(uint64_t from, uint64_t to) {
+    to = to == 0 ? nextOutbound() : std::min(to, nextOutbound());
+    for (uint64_t seq = std::max<uint64_t>(from, 1); seq < to; ++seq) {
+        const size_t offset = m_outboundOffsets[seq - 1];
+        const size_t end = seq < m_outboundOffsets.size() ? m_outboundOffsets[seq] : m_outbound.size();
+        const size_t start = m_pending.size();
+        m_pending.insert(m_pending.end(), m_outbound.begin() + offset, m_outbound.begin() + end);
+        reinterpret_cast<oe::Header*>(m_pending.data() + start)->flags |= oe::kPossDup;
+    }
+}
+
+void LoopbackExchange::handle(const uint8_t* data, size_t size) {
+    const auto* header = reinterpret_cast<const oe::Header*>(data);
+    ++m_received;
+
+    if (header->type == oe::Logon::kType) {
+        if (!oe::view<oe::Logon>(data, size)) {
+            return;
+        }
+        // 回复本方期望的序号与下一个出站序号，双方各自按对方的报告请求或补发缺口
+        auto* reply = stage<oe::Logon>();
+        reply->next_expected = m_expectedInbound;
+        commitSession(sizeof(*reply));
+        if (header->sequence > m_expectedInbound) {
+            m_resendRequestedTo = header->sequence;
+        }
+        return;
+    }
+    if (header->type == oe::ResendRequest::kType) {
+        if (const auto* request = oe::view<oe::ResendRequest>(data, size)) {
+            replay(request->from, request->to);
+        }
+        return;
+    }
+
+    if (header->sequence < m_expectedInbound) {
+        ++m_duplicates;
+        return;
+    }
+    if (header->sequence > m_expectedInbound) {
+        // 与会话相同：上一次重发补齐前不再请求，请求不设上限
+        if (m_expectedInbound >= m_resendRequestedTo) {
+            auto* request = stage<oe::ResendRequest>();
+            request->from = m_expectedInbound;
+            request->to = 0;
+            m_resendRequestedTo = header->sequence + 1;
+            commitSession(sizeof(*request));
+        }
+        return;
+    }
+    ++m_expectedInbound;
+
+    if (header->type == oe::NewOrder::kType) {
+        const auto* msg = oe::view<oe::NewOrder>(data, size);
+        if (!msg) {
+            return;
+        }
+        uint32_t reason = m_rejectNext;
+        m_rejectNext = 0;
+        if (reason == 0) {
+            if (msg->quantity == 0) {
+                reason = oe::kRejectInvalidQuantity;
+            } else if (msg->order_type != static_cast<uint8_t>(OrderType::MARKET) && msg->price <= 0) {
+                reason = oe::kRejectInvalidPrice;
+            } else if (m_orders.find(msg->client_order_id)) {
+                reason = oe::kRejectDuplicateId;
+            }
+        }
+        OpenOrder order{};
+        order.client_order_id = msg->client_order_id;
+        order.exchange_order_id = m_nextExchangeId;
+        order.symbol = msg->symbol;
+        order.side = static_cast<OrderSide>(msg->side);
+        order.type = static_cast<OrderType>(msg->order_type);
+        order.status = OrderStatus::NEW;
+        order.price = msg->price;
+        order.quantity = msg->quantity;
+        if (reason == 0 && !m_orders.insert(order)) {
+            reason = oe::kRejectExchange;
+        }
+        if (reason != 0) {
+            auto* reject = stage<oe::OrderRejected>();
+            reject->client_order_id = msg->client_order_id;
+            reject->reason = reason;
+            commitReply(sizeof(*reject));
+            return;
+        }
+        ++m_nextExchangeId;
+        auto* accepted = stage<oe::OrderAccepted>();
+        accepted->client_order_id = msg->client_order_id;
+        accepted->exchange_order_id = order.exchange_order_id;
+        commitReply(sizeof(*accepted));
+        if (m_fillOnAccept) {
+            execute(msg->client_order_id, msg->quantity);
+        }
+    } else if (header->type == oe::CancelOrder::kType) {
+        const auto* msg = oe::view<oe::CancelOrder>(data, size);
+        if (!msg) {
+            return;
+        }
+        const OpenOrder* order = m_orders.find(msg->client_order_id);
+        if (!order) {
+            auto* reject = stage<oe::OrderRejected>();
+            reject->client_order_id = msg->client_order_id;
+            reject->reason = oe::kRejectUnknownOrder;
+            commitReply(sizeof(*reject));
+            return;
+        }
+        auto* canceled = stage<oe::OrderCanceled>();
+        canceled->client_order_id = msg->client_order_id;
+        canceled->canceled_quantity = order->remaining();
+        commitReply(sizeof(*canceled));
+        m_orders.erase(msg->client_order_id);
+    } else if (header->type == oe::ReplaceOrder::kType) {
+        const auto* msg = oe::view<oe::ReplaceOrder>(data, size);
+        if (!msg) {
+            return;
+        }
+        const OpenOrder* orig = m_orders.find(msg->orig_client_order_id);
+        if (!orig || msg->quantity <= orig->filled || m_orders.find(msg->client_order_id)) {
+            auto* reject = stage<oe::OrderRejected>();
+            reject->client_order_id = msg->client_order_id;
+            reject->reason = !orig ? oe::kRejectUnknownOrder
+                           : msg->quantity <= orig->filled ? oe::kRejectInvalidQuantity : oe::kRejectDuplicateId;
+            commitReply(sizeof(*reject));
+            return;
+        }
+        OpenOrder order = *orig;
+        order.client_order_id = msg->client_order_id;
+        order.price = msg->price;
+        order.quantity = msg->quantity;
+        m_orders.erase(msg->orig_client_order_id);
+        m_orders.insert(order);
+        auto* replaced = stage<oe::OrderReplaced>();
+        replaced->orig_client_order_id = msg->orig_client_order_id;
+        replaced->client_order_id = msg->client_order_id;
+        replaced->price = msg->price;
+        replaced->quantity = msg->quantity;
+        commitReply(sizeof(*replaced));
+    }
+}
+
+bool LoopbackExchange::execute(uint64_t clientOrderId, uint64_t quantity) {
+    OpenOrder* order = m_orders.find(clientOrderId);
+    if (!order || quantity == 0) {
+        return false;
+    }
+    quantity = std::min(quantity, order->remaining());
+    order->filled += quantity;
+    auto* executed = stage<oe::OrderExecuted>();
+    executed->client_order_id = clientOrderId;
+    executed->execution_id = m_nextExecutionId++;
+    executed->price = order->price;
+    executed->quantity = quantity;
+    commitReply(sizeof(*executed));
+    if (order->remaining() == 0) {
+        m_orders.erase(clientOrderId);
+    }
+    return true;
+}
+
+} // namespace network
+} // namespace hft
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "OrderEntrySession.h"
+
+namespace hft {
+namespace network {
+
+// 环回交易所模拟器（测试与延迟测量用）
+//
+// 作为OrderEntrySession的发送通道：收到的消息按会话序号检查，缺口时请求重发，
+// 按协议回复确认/拒绝/撤单/改单/成交。回报先写入预分配的输出缓冲区，
+// 调用pump()时一次性交给会话处理，避免在会话发送过程中重入。
+// 挂单表与回报历史均预先分配，测量端到端分配次数时不引入额外分配。
+class LoopbackExchange : public OrderTransport {
+public:
+    explicit LoopbackExchange(size_t maxOrders = 1 << 16, size_t outputBytes = 1 << 20);
+
+    // 回报接收方
+    void connect(OrderEntrySession* session) { m_session = session; }
+
+    bool send(const void* data, size_t size) override;
+    // 把积压的回报交给会话，返回交付的消息数
+    size_t pump();
+
+    // 行为控制
+    void setFillOnAccept(bool fill) { m_fillOnAccept = fill; }       // 新单确认后立即全部成交
+    void rejectNext(uint32_t reason = oe::kRejectExchange) { m_rejectNext = reason; }
+    void dropInbound(size_t count) { m_dropInbound = count; }          // 模拟客户端消息丢失
+    void dropOutbound(size_t count) { m_dropOutbound = count; }        // 模拟回报丢失
+    void setConnected(bool connected) { m_connected = connected; }    // 断开时send返回false
+
+    // 模拟成交
+    bool execute(uint64_t clientOrderId, uint64_t quantity);
+
+    uint64_t expectedInbound() const { return m_expectedInbound; }
+    uint64_t nextOutbound() const { return m_outboundOffsets.size() + 1; }
+    size_t liveOrders() const { return m_orders.size(); }
+    uint64_t received() const { return m_received; }
+    uint64_t duplicates() const { return m_duplicates; }
+
+private:
+    void handle(const uint8_t* data, size_t size);
+    // 在暂存缓冲区中编码一条出站消息
+    template<typename Message>
+    Message* stage();
+    // 记录并交付暂存的回报（占用序号）
+    void commitReply(size_t size);
+    // 交付暂存的会话消息（不占用序号）
+    void commitSession(size_t size);
+    void replay(uint64_t from, uint64_t to);
+
+    OrderEntrySession* m_session;
+    std::vector<uint8_t> m_pending;                     // 待交付的回报字节流
+    std::vector<uint8_t> m_delivering;                  // pump()正在交付的回报
+    std::vector<uint8_t> m_outbound;                    // 已发送回报，用于重发
+    std::vector<size_t> m_outboundOffsets;              // 第i项为序号i+1的回报偏移
+    OpenOrderTable m_orders;                            // 挂单，以客户端订单ID为键
+    uint64_t m_expectedInbound;
+    uint64_t m_nextExchangeId;
+    uint64_t m_nextExecutionId;
+    uint64_t m_received;
+    uint64_t m_duplicates;
+    bool m_fillOnAccept;
+    uint32_t m_rejectNext;
+    size_t m_dropInbound;
+    size_t m_dropOutbound;
+    bool m_connected;
+    uint64_t m_resendRequestedTo;
+    uint8_t m_buffer[oe::kMaxMessageSize];
+};
+
+} // namespace network
+} // namespace hft
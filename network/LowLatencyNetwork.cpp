@@ -1,30 +1,63 @@
 #include "LowLatencyNetwork.h"
 #include <iostream>
 #include <chrono>
+#include <thread>
+#ifdef _WIN32
 #include <WinSock2.h>
 #include <WS2tcpip.h>
 #pragma comment(lib, "ws2_32.lib")
+#endif
 
 namespace hft {
 namespace network {
 
+namespace {
+
+// 224.0.0.0/4
+bool isMulticastAddress(const std::string& host) {
+    size_t dot = host.find('.');
+    if (dot == std::string::npos || dot == 0 || dot > 3) {
+        return false;
+    }
+    int first = 0;
+    for (size_t i = 0; i < dot; ++i) {
+        if (host[i] < '0' || host[i] > '9') {
+            return false;
+        }
+        first = first * 10 + (host[i] - '0');
+    }
+    return first >= 224 && first <= 239;
+}
+
+} // namespace
+
 LowLatencyNetwork::LowLatencyNetwork(const core::Configuration& config, std::shared_ptr<core::EventLoop> eventLoop)
     : m_config(config), m_logger("LowLatencyNetwork"), m_running(false), m_eventLoop(eventLoop) {
+#ifdef _WIN32
     // 初始化Winsock
     WSADATA wsaData;
     if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
         m_logger.error("WSAStartup failed: " + std::to_string(WSAGetLastError()));
     }
+#endif
 }
 
 LowLatencyNetwork::~LowLatencyNetwork() {
     stop();
+    m_poller.reset();
+#ifdef _WIN32
     WSACleanup();
+#endif
 }
 
 bool LowLatencyNetwork::initialize() {
     m_logger.info("Initializing low latency network...");
 
+    if (!ensurePoller()) {
+        m_logger.error("Failed to initialize socket poller");
+        return false;
+    }
+
     // 从配置中读取预定义的连接
     std::vector<std::string> connections = m_config.getStringList("network_connections");
     for (const auto& connStr : connections) {
@@ -46,6 +79,28 @@ bool LowLatencyNetwork::initialize() {
     return true;
 }
 
+bool LowLatencyNetwork::ensurePoller() {
+    if (m_poller) {
+        return true;
+    }
+
+    SocketPollerConfig config;
+    config.batch_size = static_cast<size_t>(m_config.getInt("network.poller.batch_size", 32));
+    config.buffer_size = static_cast<size_t>(m_config.getInt("network.poller.buffer_size", 2048));
+    config.busy_poll_us = m_config.getInt("network.poller.busy_poll_us", 50);
+    config.kernel_timestamps = m_config.getBool("network.poller.kernel_timestamps", true);
+    config.receive_buffer_bytes = m_config.getInt("network.poller.receive_buffer_bytes", 4 << 20);
+    config.epoll_timeout_ms = m_config.getInt("network.poller.epoll_timeout_ms", 1);
+    config.max_sockets = static_cast<size_t>(m_config.getInt("network.poller.max_sockets", 256));
+
+    auto poller = std::make_unique<SocketPoller>(config);
+    if (!poller->initialize()) {
+        return false;
+    }
+    m_poller = std::move(poller);
+    return true;
+}
+
 void LowLatencyNetwork::start() {
     if (m_running) {
         m_logger.warning("Low latency network is already running");
@@ -53,14 +108,17 @@ void LowLatencyNetwork::start() {
     }
 
     m_logger.info("Starting low latency network...");
+    if (!ensurePoller() || !m_poller->start()) {
+        m_logger.error("Failed to start socket poller");
+        return;
+    }
     m_running = true;
 
     // 启动所有预定义连接
     std::lock_guard<std::mutex> lock(m_mutex);
     for (auto& conn : m_connections) {
         if (conn->state == ConnectionState::DISCONNECTED) {
-            std::thread connectThread(&LowLatencyNetwork::connectThreadFunc, this, conn.get());
-            connectThread.detach();
+            openConnection(conn.get());
         }
     }
 
@@ -76,36 +134,41 @@ void LowLatencyNetwork::stop() {
     m_logger.info("Stopping low latency network...");
     m_running = false;
 
-    // 断开所有连接
+    // 先停轮询线程，之后不会再有回调
+    m_poller->stop();
+
     std::lock_guard<std::mutex> lock(m_mutex);
     for (auto& conn : m_connections) {
-        if (conn->state != ConnectionState::DISCONNECTED) {
-            conn->state = ConnectionState::DISCONNECTING;
-        }
+        closeConnection(conn.get());
     }
 
-    // 等待所有连接断开
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
-
     m_logger.info("Low latency network stopped successfully");
 }
 
 bool LowLatencyNetwork::connect(const std::string& host, uint16_t port) {
+    return open(host, port, false);
+}
+
+bool LowLatencyNetwork::listen(const std::string& host, uint16_t port) {
+    return open(host, port, true);
+}
+
+bool LowLatencyNetwork::open(const std::string& host, uint16_t port, bool listener) {
     std::lock_guard<std::mutex> lock(m_mutex);
 
     Connection* conn = findConnection(host, port);
     if (!conn) {
         // 创建新连接
-        m_connections.push_back(std::make_unique<Connection>(host, port));
+        m_connections.push_back(std::make_unique<Connection>(host, port, listener));
         conn = m_connections.back().get();
-        m_logger.info("Created new connection: " + host + ":" + std::to_string(port));
+        m_logger.info(std::string(listener ? "Created new listener: " : "Created new connection: ") +
+                      host + ":" + std::to_string(port));
+    } else if (conn->state == ConnectionState::DISCONNECTED) {
+        conn->listener = listener;
     }
 
     if (conn->state == ConnectionState::DISCONNECTED) {
-        conn->state = ConnectionState::CONNECTING;
-        std::thread connectThread(&LowLatencyNetwork::connectThreadFunc, this, conn);
-        connectThread.detach();
-        return true;
+        return openConnection(conn);
     }
 
     return false;
@@ -116,39 +179,116 @@ void LowLatencyNetwork::disconnect(const std::string& host, uint16_t port) {
 
     Connection* conn = findConnection(host, port);
     if (conn && conn->state != ConnectionState::DISCONNECTED && conn->state != ConnectionState::DISCONNECTING) {
-        conn->state = ConnectionState::DISCONNECTING;
         m_logger.info("Disconnecting from: " + host + ":" + std::to_string(port));
+        closeConnection(conn);
     }
 }
 
-bool LowLatencyNetwork::send(const std::string& host, uint16_t port, const void* data, size_t size) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-
-    Connection* conn = findConnection(host, port);
-    if (!conn || conn->state != ConnectionState::CONNECTED) {
-        m_logger.error("Cannot send data to " + host + ":" + std::to_string(port) + ", not connected");
+bool LowLatencyNetwork::openConnection(Connection* conn) {
+    if (!ensurePoller()) {
         return false;
     }
 
-    // 实际发送逻辑将在这里实现
-    // 注意：这只是一个框架，实际实现需要使用套接字API发送数据
-    m_logger.debug("Sending " + std::to_string(size) + " bytes to " + host + ":" + std::to_string(port));
+    conn->state = ConnectionState::CONNECTING;
+    m_logger.info("Connecting to " + conn->host + ":" + std::to_string(conn->port) + "...");
+
+    // 组播地址加入组接收，入站端点绑定本地地址接收，
+    // 其余地址建立已连接的UDP套接字（可发送，也接收对端回包）
+    if (isMulticastAddress(conn->host)) {
+        std::string iface = m_config.getString("network.multicast_interface", "");
+        conn->socketId = m_poller->addReceiver(conn->host, conn->port, conn, iface);
+    } else if (conn->listener) {
+        conn->socketId = m_poller->addReceiver(conn->host, conn->port, conn);
+    } else {
+        conn->socketId = m_poller->addSender(conn->host, conn->port, conn);
+    }
+
+    if (conn->socketId < 0) {
+        conn->state = ConnectionState::DISCONNECTED;
+        m_logger.error("Failed to connect to " + conn->host + ":" + std::to_string(conn->port));
+        return false;
+    }
 
+    conn->state = ConnectionState::CONNECTED;
+    m_logger.info("Connected to " + conn->host + ":" + std::to_string(conn->port) +
+                  (m_poller->busyPollEnabled(conn->socketId) ? " (busy poll)" : ""));
     return true;
 }
 
+void LowLatencyNetwork::closeConnection(Connection* conn) {
+    if (conn->state == ConnectionState::DISCONNECTED) {
+        return;
+    }
+    conn->state = ConnectionState::DISCONNECTING;
+    // 新的发送看到DISCONNECTING后不会再取socketId，等已取得的发送返回，
+    // 避免套接字ID被释放后分配给其他连接时报文发错对端
+    while (conn->sending.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+    if (conn->socketId >= 0) {
+        m_poller->remove(conn->socketId);
+        conn->socketId = -1;
+    }
+    conn->state = ConnectionState::DISCONNECTED;
+    m_logger.info("Disconnected from " + conn->host + ":" + std::to_string(conn->port));
+}
+
+bool LowLatencyNetwork::send(const std::string& host, uint16_t port, const void* data, size_t size) {
+    SendBuffer buffer{data, size};
+    return sendBatch(host, port, &buffer, 1) == 1;
+}
+
+size_t LowLatencyNetwork::sendBatch(const std::string& host, uint16_t port, const SendBuffer* buffers, size_t count) {
+    Connection* conn = nullptr;
+    int socketId = -1;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        conn = findConnection(host, port);
+        if (!conn || conn->state != ConnectionState::CONNECTED) {
+            m_logger.error("Cannot send data to " + host + ":" + std::to_string(port) + ", not connected");
+            return 0;
+        }
+        if (conn->listener) {
+            m_logger.error("Cannot send data to " + host + ":" + std::to_string(port) + ", receive-only endpoint");
+            return 0;
+        }
+        socketId = conn->socketId;
+        conn->sending.fetch_add(1, std::memory_order_relaxed);
+    }
+    // 连接对象只追加不删除，锁外访问安全
+    const size_t sent = m_poller->sendBatch(socketId, buffers, count);
+    conn->sending.fetch_sub(1, std::memory_order_release);
+    return sent;
+}
+
 void LowLatencyNetwork::registerDataCallback(const std::string& host, uint16_t port, DataCallback callback) {
     std::lock_guard<std::mutex> lock(m_mutex);
 
     Connection* conn = findConnection(host, port);
     if (conn) {
-        conn->callback = callback;
+        std::atomic_store(&conn->callback, std::make_shared<const DataCallback>(std::move(callback)));
         m_logger.info("Registered data callback for " + host + ":" + std::to_string(port));
     } else {
         m_logger.error("Cannot register callback for " + host + ":" + std::to_string(port) + ", connection not found");
     }
 }
 
+void LowLatencyNetwork::registerBatchHandler(const std::string& host, uint16_t port, DatagramHandler* handler) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Connection* conn = findConnection(host, port);
+    if (conn) {
+        conn->batchHandler.store(handler, std::memory_order_release);
+        m_logger.info("Registered batch handler for " + host + ":" + std::to_string(port));
+    } else {
+        m_logger.error("Cannot register batch handler for " + host + ":" + std::to_string(port) + ", connection not found");
+    }
+}
+
+SocketPollerStats LowLatencyNetwork::getStats() const {
+    return m_poller ? m_poller->getStats() : SocketPollerStats();
+}
+
 LowLatencyNetwork::Connection* LowLatencyNetwork::findConnection(const std::string& host, uint16_t port) {
     for (auto& conn : m_connections) {
         if (conn->host == host && conn->port == port) {
@@ -158,49 +298,21 @@ LowLatencyNetwork::Connection* LowLatencyNetwork::findConnection(const std::stri
     return nullptr;
 }
 
-void LowLatencyNetwork::connectThreadFunc(Connection* conn) {
-    m_logger.info("Connecting to " + conn->host + ":" + std::to_string(conn->port) + "...");
-
-    // 模拟连接过程
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-
-    // 实际连接逻辑将在这里实现
-    // 注意：这只是一个框架，实际实现需要使用套接字API建立连接
-
-    conn->state = ConnectionState::CONNECTED;
-    m_logger.info("Connected to " + conn->host + ":" + std::to_string(conn->port));
-
-    // 启动接收线程
-    std::thread receiveThread(&LowLatencyNetwork::receiveThreadFunc, this, conn);
-    receiveThread.detach();
-}
-
-void LowLatencyNetwork::receiveThreadFunc(Connection* conn) {
-    while (m_running && conn->state == ConnectionState::CONNECTED) {
-        // 实际接收逻辑将在这里实现
-        // 注意：这只是一个框架，实际实现需要使用套接字API接收数据
-
-        // 模拟接收数据
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
-
-        // 假设我们接收到了一些数据
-        // 在实际实现中，这里应该是从套接字读取数据
-        char dummyData[] = "Market data update";
-        size_t dataSize = sizeof(dummyData) - 1;
-
-        if (conn->callback) {
-            // 在事件循环中执行回调
-            m_eventLoop->postTask([conn, dummyData, dataSize]() {
-                conn->callback(conn->host, conn->port, dummyData, dataSize);
-            });
-        }
+void LowLatencyNetwork::Connection::onDatagrams(int socketId, const Datagram* datagrams, size_t count) {
+    DatagramHandler* handler = batchHandler.load(std::memory_order_acquire);
+    if (handler) {
+        handler->onDatagrams(socketId, datagrams, count);
+        return;
     }
 
-    if (conn->state == ConnectionState::DISCONNECTING) {
-        conn->state = ConnectionState::DISCONNECTED;
-        m_logger.info("Disconnected from " + conn->host + ":" + std::to_string(conn->port));
+    std::shared_ptr<const DataCallback> cb = std::atomic_load(&callback);
+    if (!cb || !*cb) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        (*cb)(host, port, datagrams[i].data, datagrams[i].size);
     }
 }
 
 } // namespace network
-} // namespace hft
\ No newline at end of file
+} // namespace hft
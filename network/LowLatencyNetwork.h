@@ -5,6 +5,7 @@
 #include <atomic>
 #include <mutex>
 #include <thread>
+#include "SocketPoller.h"
 #include "../core/Configuration.h"
 #include "../core/EventLoop.h"
 #include "../core/Logger.h"
@@ -21,6 +22,10 @@ enum class ConnectionState {
 };
 
 // 低延迟网络接口
+// 所有连接共用一个SocketPoller轮询线程：epoll + recvmmsg批量收包，sendmmsg批量发包。
+// listen()用于行情等入站端点：绑定本地地址接收（组播地址按组订阅）；
+// connect()用于下单等出站对端：组播地址按组订阅接收，其余地址建立已连接的UDP套接字。
+// 回调在轮询线程上同步执行，data指向轮询器的接收缓冲区，只在回调内有效。
 class LowLatencyNetwork {
 public:
     LowLatencyNetwork(const core::Configuration& config, std::shared_ptr<core::EventLoop> eventLoop);
@@ -37,24 +42,39 @@ public:
 
     // 连接到目标服务器
     bool connect(const std::string& host, uint16_t port);
+    // 在本地地址host:port上接收数据（只收不发）
+    bool listen(const std::string& host, uint16_t port);
     // 断开连接
     void disconnect(const std::string& host, uint16_t port);
     // 发送数据
     bool send(const std::string& host, uint16_t port, const void* data, size_t size);
-    // 注册数据接收回调
+    // 批量发送（一次sendmmsg），返回成功发送的报文数
+    size_t sendBatch(const std::string& host, uint16_t port, const SendBuffer* buffers, size_t count);
+    // 注册数据接收回调（逐个数据报调用）
     using DataCallback = std::function<void(const std::string& host, uint16_t port, const void* data, size_t size)>;
     void registerDataCallback(const std::string& host, uint16_t port, DataCallback callback);
+    // 注册批量处理器，设置后取代逐个数据报的回调，每批recvmmsg结果调用一次
+    void registerBatchHandler(const std::string& host, uint16_t port, DatagramHandler* handler);
+
+    // 轮询统计
+    SocketPollerStats getStats() const;
 
 private:
-    struct Connection {
+    struct Connection : public DatagramHandler {
         std::string host;
         uint16_t port;
-        ConnectionState state;
-        DataCallback callback;
-        // 这里可以添加套接字等网络相关成员
+        std::atomic<ConnectionState> state;
+        std::shared_ptr<const DataCallback> callback;     // 原子替换，轮询线程无锁读取
+        std::atomic<DatagramHandler*> batchHandler;
+        int socketId;
+        bool listener;                   // 入站端点，绑定本地地址只接收
+        std::atomic<uint32_t> sending;   // 已取得socketId、尚未返回的发送数，关闭连接前等待归零
+
+        Connection(const std::string& h, uint16_t p, bool listen = false)
+            : host(h), port(p), state(ConnectionState::DISCONNECTED), batchHandler(nullptr), socketId(-1),
+              listener(listen), sending(0) {}
 
-        Connection(const std::string& h, uint16_t p)
-            : host(h), port(p), state(ConnectionState::DISCONNECTED) {}
+        void onDatagrams(int socketId, const Datagram* datagrams, size_t count) override;
     };
 
     core::Configuration m_config;
@@ -63,13 +83,15 @@ private:
     std::shared_ptr<core::EventLoop> m_eventLoop;
     std::vector<std::unique_ptr<Connection>> m_connections;
     std::mutex m_mutex;
+    std::unique_ptr<SocketPoller> m_poller;
 
     // 查找连接
     Connection* findConnection(const std::string& host, uint16_t port);
-    // 连接线程函数
-    void connectThreadFunc(Connection* conn);
-    // 接收线程函数
-    void receiveThreadFunc(Connection* conn);
+    bool open(const std::string& host, uint16_t port, bool listener);
+    // 创建套接字并加入轮询器（调用方持有m_mutex）
+    bool openConnection(Connection* conn);
+    void closeConnection(Connection* conn);
+    bool ensurePoller();
 };
 
 } // namespace network
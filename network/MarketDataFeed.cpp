@@ -9,7 +9,8 @@ MarketDataFeed::MarketDataFeed(const std::string& name, const core::Configuratio
                                std::shared_ptr<LowLatencyNetwork> network,
                                std::shared_ptr<core::EventLoop> eventLoop)
     : m_name(name), m_config(config), m_network(network), m_eventLoop(eventLoop),
-      m_logger("MarketDataFeed[" + name + "]"), m_running(false) {
+      m_logger("MarketDataFeed[" + name + "]"), m_running(false),
+      m_callbacks(std::make_shared<CallbackMap>()), m_bridge(*this), m_bookListener(nullptr), m_port(0), m_portB(0) {
 }
 
 MarketDataFeed::~MarketDataFeed() {
@@ -23,6 +24,39 @@ bool MarketDataFeed::initialize() {
     m_host = m_config.getString("market_data_feed." + m_name + ".host", "127.0.0.1");
     m_port = static_cast<uint16_t>(m_config.getInt("market_data_feed." + m_name + ".port", 5555));
 
+    // 解码器与订单簿
+    std::string protocol = m_config.getString("market_data_feed." + m_name + ".protocol", "itch");
+    if (protocol != "itch") {
+        m_logger.error("Unsupported market data protocol: " + protocol);
+        return false;
+    }
+    size_t maxOrders = static_cast<size_t>(m_config.getInt("market_data_feed." + m_name + ".max_orders", 1 << 20));
+    types::Price tickSize = static_cast<types::Price>(m_config.getInt("market_data_feed." + m_name + ".tick_size", 100));
+    m_books = std::make_unique<BookBuilder>(maxOrders, tickSize);
+    m_books->setListener(&m_bridge);
+    m_decoder = std::make_unique<ItchDecoder<BookBuilder>>(*m_books);
+
+    // 冗余B线路：两条线路的包经仲裁去重后按序解码
+    m_hostB = m_config.getString("market_data_feed." + m_name + ".line_b.host", "");
+    m_portB = static_cast<uint16_t>(m_config.getInt("market_data_feed." + m_name + ".line_b.port", 0));
+    if (!m_hostB.empty() && m_portB != 0) {
+        LineArbitratorConfig arbitration;
+        arbitration.reorder_capacity = static_cast<size_t>(
+            m_config.getInt("market_data_feed." + m_name + ".reorder_capacity", 1024));
+        arbitration.gap_timeout_ns = static_cast<uint64_t>(
+            m_config.getInt("market_data_feed." + m_name + ".gap_timeout_us", 500)) * 1000;
+        arbitration.initial_sequence = static_cast<uint64_t>(
+            m_config.getInt("market_data_feed." + m_name + ".initial_sequence", 0));
+        m_arbitrator = std::make_unique<LineArbitrator>(*m_decoder, arbitration);
+        m_arbitrator->setRecoveryHandler([this](uint64_t from, uint64_t to) {
+            m_logger.warning("Sequence gap [" + std::to_string(from) + ", " + std::to_string(to) + ") on feed " + m_name);
+            if (m_recoveryHandler) {
+                m_recoveryHandler(from, to);
+            }
+        });
+        m_logger.info("A/B line arbitration enabled with line B " + m_hostB + ":" + std::to_string(m_portB));
+    }
+
     // 从配置中获取默认订阅
     std::vector<std::string> symbols = m_config.getStringList("market_data_feed." + m_name + ".symbols");
     if (!symbols.empty()) {
@@ -46,14 +80,21 @@ void MarketDataFeed::start() {
     m_logger.info("Starting market data feed...");
     m_running = true;
 
-    // 连接到市场数据服务器
-    m_network->connect(m_host, m_port);
+    // 绑定行情端点接收数据
+    m_network->listen(m_host, m_port);
 
     // 注册数据回调
-    m_network->registerDataCallback(m_host, m_port, [this](const std::string& host, uint16_t port, const void* data, size_t size) {
-        handleData(host, port, data, size);
+    m_network->registerDataCallback(m_host, m_port, [this](const std::string&, uint16_t, const void* data, size_t size) {
+        handleData(FeedLine::A, data, size);
     });
 
+    if (m_arbitrator) {
+        m_network->listen(m_hostB, m_portB);
+        m_network->registerDataCallback(m_hostB, m_portB, [this](const std::string&, uint16_t, const void* data, size_t size) {
+            handleData(FeedLine::B, data, size);
+        });
+    }
+
     // 发送订阅请求
     std::lock_guard<std::mutex> lock(m_subscriptionMutex);
     for (const auto& sub : m_subscriptions) {
@@ -82,6 +123,9 @@ void MarketDataFeed::stop() {
 
     // 断开连接
     m_network->disconnect(m_host, m_port);
+    if (m_arbitrator) {
+        m_network->disconnect(m_hostB, m_portB);
+    }
 
     m_logger.info("Market data feed stopped successfully");
 }
@@ -133,38 +177,97 @@ bool MarketDataFeed::unsubscribe(const std::string& symbol, MarketDataType dataT
 
 void MarketDataFeed::registerCallback(MarketDataType dataType, MarketDataCallback callback) {
     std::lock_guard<std::mutex> lock(m_callbackMutex);
-    m_callbacks[dataType].push_back(callback);
+    auto callbacks = std::make_shared<CallbackMap>(*std::atomic_load(&m_callbacks));
+    (*callbacks)[dataType].push_back(callback);
+    std::atomic_store(&m_callbacks, std::shared_ptr<const CallbackMap>(std::move(callbacks)));
     m_logger.info("Registered callback for data type: " + std::to_string(static_cast<int>(dataType)));
 }
 
-void MarketDataFeed::handleData(const std::string& host, uint16_t port, const void* data, size_t size) {
-    // 在事件循环中处理数据
-    m_eventLoop->postTask([this, data, size]() {
-        parseMarketData(data, size);
-    });
+FeedDecoderStats MarketDataFeed::getDecoderStats() const {
+    return m_decoder ? m_decoder->stats() : FeedDecoderStats();
+}
+
+LineArbitratorStats MarketDataFeed::getArbitratorStats() const {
+    return m_arbitrator ? m_arbitrator->stats() : LineArbitratorStats();
 }
 
-void MarketDataFeed::parseMarketData(const void* data, size_t size) {
-    // 解析市场数据
-    // 注意：这只是一个框架，实际实现需要根据具体的市场数据协议进行解析
+void MarketDataFeed::setRecoveryHandler(LineArbitrator::RecoveryHandler handler) {
+    m_recoveryHandler = std::move(handler);
+}
 
-    // 假设我们解析出了symbol和dataType
-    std::string symbol = "AAPL";
-    MarketDataType dataType = MarketDataType::ORDER_BOOK;
+void MarketDataFeed::applySnapshot(const void* data, size_t size, uint64_t nextSequence) {
+    if (!m_decoder) {
+        return;
+    }
+    m_decoder->decodeStream(static_cast<const uint8_t*>(data), size);
+    if (m_arbitrator) {
+        const uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        m_arbitrator->resetSequence(nextSequence, now);
+    }
+    m_logger.info("Applied snapshot, resuming at sequence " + std::to_string(nextSequence));
+}
 
-    // 调用相应的回调
-    std::lock_guard<std::mutex> lock(m_callbackMutex);
-    auto it = m_callbacks.find(dataType);
-    if (it != m_callbacks.end()) {
-        for (auto& callback : it->second) {
-            try {
-                callback(symbol, dataType, data, size);
-            } catch (const std::exception& e) {
-                m_logger.error("Exception in market data callback: " + std::string(e.what()));
-            }
+void MarketDataFeed::handleData(FeedLine line, const void* data, size_t size) {
+    // 在接收线程上直接解码：data只在本次回调内有效，
+    // 解码器按偏移读取原始缓冲区，不拷贝也不经过事件循环。
+    // 两条线路由同一个轮询线程回调，仲裁器无需加锁
+    if (!m_decoder) {
+        return;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    if (m_arbitrator) {
+        const uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        m_arbitrator->onPacket(line, bytes, size, now);
+    } else {
+        m_decoder->decodePacket(bytes, size);
+    }
+}
+
+void MarketDataFeed::dispatch(MarketDataType dataType, const FeedEvent& event) {
+    std::shared_ptr<const CallbackMap> callbacks = std::atomic_load(&m_callbacks);
+    auto it = callbacks->find(dataType);
+    if (it == callbacks->end() || it->second.empty()) {
+        return;
+    }
+
+    const std::string& symbol = symbolString(event.symbol);
+    for (auto& callback : it->second) {
+        try {
+            callback(symbol, dataType, &event, sizeof(event));
+        } catch (const std::exception& e) {
+            m_logger.error("Exception in market data callback: " + std::string(e.what()));
         }
     }
 }
 
+const std::string& MarketDataFeed::symbolString(core::SymbolId symbol) {
+    if (symbol >= m_symbolNames.size()) {
+        m_symbolNames.resize(static_cast<size_t>(symbol) + 1);
+    }
+    std::string& name = m_symbolNames[symbol];
+    if (name.empty() && symbol != core::kInvalidSymbol) {
+        name.assign(core::symbolName(symbol));
+    }
+    return name;
+}
+
+void MarketDataFeed::CallbackBridge::onBookUpdate(core::SymbolId symbol, types::Side side, types::Price price,
+                                                  types::Volume volume, const market::PriceLevelBook& book) {
+    m_feed.dispatch(MarketDataType::ORDER_BOOK, FeedEvent{symbol, side, price, volume, 0});
+    if (m_feed.m_bookListener) {
+        m_feed.m_bookListener->onBookUpdate(symbol, side, price, volume, book);
+    }
+}
+
+void MarketDataFeed::CallbackBridge::onTrade(core::SymbolId symbol, types::Side side, types::Price price,
+                                             types::Volume volume, uint64_t timestamp) {
+    m_feed.dispatch(MarketDataType::TRADE, FeedEvent{symbol, side, price, volume, timestamp});
+    if (m_feed.m_bookListener) {
+        m_feed.m_bookListener->onTrade(symbol, side, price, volume, timestamp);
+    }
+}
+
 } // namespace network
-} // namespace hft
\ No newline at end of file
+} // namespace hft
@@ -5,6 +5,10 @@
 #include <mutex>
 #include <unordered_map>
 #include <functional>
+#include <vector>
+#include "BookBuilder.h"
+#include "ItchDecoder.h"
+#include "LineArbitrator.h"
 #include "LowLatencyNetwork.h"
 #include "../core/Configuration.h"
 #include "../core/EventLoop.h"
@@ -22,6 +26,15 @@ enum class MarketDataType {
     NEWS
 };
 
+// 解码后的行情事件，registerCallback注册的回调收到的data指向该结构
+struct FeedEvent {
+    core::SymbolId symbol;
+    types::Side side;
+    types::Price price;
+    types::Volume volume;         // 订单簿事件为该档变化后的总量，成交事件为成交量
+    uint64_t timestamp;           // 成交时间（当日纳秒），订单簿事件为0
+};
+
 // 市场数据feed
 class MarketDataFeed {
 public:
@@ -51,7 +64,37 @@ public:
     using MarketDataCallback = std::function<void(const std::string& symbol, MarketDataType dataType, const void* data, size_t size)>;
     void registerCallback(MarketDataType dataType, MarketDataCallback callback);
 
+    // 订单簿监听（在接收线程上同步调用，start()之前设置）
+    void setBookListener(BookListener* listener) { m_bookListener = listener; }
+    // 重建的订单簿，仅可在接收线程或feed停止后访问
+    const BookBuilder* getBookBuilder() const { return m_books.get(); }
+    // 解码统计
+    FeedDecoderStats getDecoderStats() const;
+
+    // A/B线路仲裁统计（未启用仲裁时为空）
+    LineArbitratorStats getArbitratorStats() const;
+    // 缺口恢复回调（在接收线程上调用，start()之前设置），参数为需要恢复的[from, to)序号区间
+    void setRecoveryHandler(LineArbitrator::RecoveryHandler handler);
+    // 快照恢复：解码长度前缀的快照消息流，之后从nextSequence继续。
+    // 需在接收线程上（如恢复回调内）或feed停止时调用
+    void applySnapshot(const void* data, size_t size, uint64_t nextSequence);
+
 private:
+    using CallbackMap = std::unordered_map<MarketDataType, std::vector<MarketDataCallback>>;
+
+    // 把订单簿事件转交给旧式回调与外部监听者
+    class CallbackBridge : public BookListener {
+    public:
+        explicit CallbackBridge(MarketDataFeed& feed) : m_feed(feed) {}
+        void onBookUpdate(core::SymbolId symbol, types::Side side, types::Price price,
+                          types::Volume volume, const market::PriceLevelBook& book) override;
+        void onTrade(core::SymbolId symbol, types::Side side, types::Price price,
+                     types::Volume volume, uint64_t timestamp) override;
+
+    private:
+        MarketDataFeed& m_feed;
+    };
+
     std::string m_name;
     core::Configuration m_config;
     std::shared_ptr<LowLatencyNetwork> m_network;
@@ -72,18 +115,34 @@ private:
     std::vector<Subscription> m_subscriptions;
     std::mutex m_subscriptionMutex;
 
-    // 回调映射
-    std::unordered_map<MarketDataType, std::vector<MarketDataCallback>> m_callbacks;
+    // 回调映射：注册时复制并整体替换，接收线程原子读取快照，不加锁
+    std::shared_ptr<const CallbackMap> m_callbacks;
     std::mutex m_callbackMutex;
 
+    // 解码与订单簿重建
+    std::unique_ptr<BookBuilder> m_books;
+    std::unique_ptr<FeedDecoder> m_decoder;
+    CallbackBridge m_bridge;
+    BookListener* m_bookListener;
+    // 以SymbolId为下标的标的名称，首次分发该标的时缓存，只在接收线程访问
+    std::vector<std::string> m_symbolNames;
+
+    // 线路仲裁（配置了B线路时启用）
+    std::unique_ptr<LineArbitrator> m_arbitrator;
+    LineArbitrator::RecoveryHandler m_recoveryHandler;
+
     // 连接信息
     std::string m_host;
     uint16_t m_port;
+    std::string m_hostB;
+    uint16_t m_portB;
 
     // 处理接收到的数据
-    void handleData(const std::string& host, uint16_t port, const void* data, size_t size);
-    // 解析市场数据
-    void parseMarketData(const void* data, size_t size);
+    void handleData(FeedLine line, const void* data, size_t size);
+    // 分发旧式回调
+    void dispatch(MarketDataType dataType, const FeedEvent& event);
+    // 标的名称，同一标的每次返回同一个字符串
+    const std::string& symbolString(core::SymbolId symbol);
 };
 
 } // namespace network
@@ -0,0 +1,163 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace hft {
+namespace network {
+
+// 二进制下单协议
+// 定长、按1字节打包、本机字节序（小端）的消息结构，编码即在定长缓冲区中就地构造，
+// 解码即按类型解释收到的字节，不做逐字段序列化。价格为放大10000倍的定点数（types::Price），
+// 标的为驻留后的SymbolId。
+namespace oe {
+
+constexpr uint8_t kPossDup = 0x01;          // 重发的消息
+constexpr size_t kMaxMessageSize = 64;
+
+#pragma pack(push, 1)
+
+struct Header {
+    uint16_t length;        // 含头部的消息总长
+    char type;
+    uint8_t flags;
+    uint32_t session;
+    uint64_t sequence;      // 会话层序号，从1开始，每个方向独立编号
+    uint64_t send_time;     // 发送方单调时钟纳秒
+};
+
+// --- 会话消息（双向） ---
+
+struct Logon {
+    static constexpr char kType = 'L';
+    Header header;
+    uint64_t next_expected;     // 期望收到的对方下一个序号
+};
+
+struct ResendRequest {
+    static constexpr char kType = 'S';
+    Header header;
+    uint64_t from;              // 请求重发[from, to)
+    uint64_t to;                // 0表示到对方处理请求时的最新序号
+};
+
+// --- 客户端 -> 交易所 ---
+
+struct NewOrder {
+    static constexpr char kType = 'O';
+    Header header;
+    uint64_t client_order_id;
+    uint32_t symbol;
+    uint8_t side;               // hft::OrderSide
+    uint8_t order_type;         // hft::OrderType
+    uint16_t reserved;
+    int64_t price;
+    uint64_t quantity;
+    uint32_t strategy;
+    uint32_t reserved1;
+};
+
+struct CancelOrder {
+    static constexpr char kType = 'X';
+    Header header;
+    uint64_t client_order_id;
+};
+
+struct ReplaceOrder {
+    static constexpr char kType = 'U';
+    Header header;
+    uint64_t orig_client_order_id;
+    uint64_t client_order_id;   // 改单后的新ID
+    int64_t price;
+    uint64_t quantity;
+};
+
+// --- 交易所 -> 客户端 ---
+
+struct OrderAccepted {
+    static constexpr char kType = 'A';
+    Header header;
+    uint64_t client_order_id;
+    uint64_t exchange_order_id;
+};
+
+struct OrderRejected {
+    static constexpr char kType = 'J';
+    Header header;
+    uint64_t client_order_id;
+    uint32_t reason;
+    uint32_t reserved;
+};
+
+struct OrderCanceled {
+    static constexpr char kType = 'C';
+    Header header;
+    uint64_t client_order_id;
+    uint64_t canceled_quantity;
+};
+
+struct OrderReplaced {
+    static constexpr char kType = 'R';
+    Header header;
+    uint64_t orig_client_order_id;
+    uint64_t client_order_id;
+    int64_t price;
+    uint64_t quantity;
+};
+
+struct OrderExecuted {
+    static constexpr char kType = 'E';
+    Header header;
+    uint64_t client_order_id;
+    uint64_t execution_id;
+    int64_t price;
+    uint64_t quantity;
+};
+
+#pragma pack(pop)
+
+// 拒单原因
+enum RejectReason : uint32_t {
+    kRejectUnknownOrder = 1,
+    kRejectInvalidQuantity = 2,
+    kRejectInvalidPrice = 3,
+    kRejectDuplicateId = 4,
+    kRejectExchange = 5
+};
+
+// 在定长缓冲区中就地构造消息并填好长度与类型，其余字段清零
+template<typename Message>
+inline Message* encode(uint8_t* buffer) {
+    static_assert(std::is_trivially_copyable<Message>::value, "order entry messages must be trivially copyable");
+    static_assert(sizeof(Message) <= kMaxMessageSize, "order entry message exceeds kMaxMessageSize");
+    std::memset(buffer, 0, sizeof(Message));
+    Message* message = ::new (buffer) Message;
+    message->header.length = static_cast<uint16_t>(sizeof(Message));
+    message->header.type = Message::kType;
+    return message;
+}
+
+// 按类型解释收到的消息，长度不足时返回nullptr
+template<typename Message>
+inline const Message* view(const uint8_t* data, size_t size) {
+    if (size < sizeof(Message)) {
+        return nullptr;
+    }
+    return reinterpret_cast<const Message*>(data);
+}
+
+// 流中下一条消息的长度，不完整时返回0
+inline size_t frameLength(const uint8_t* data, size_t size) {
+    if (size < sizeof(Header)) {
+        return 0;
+    }
+    const size_t length = reinterpret_cast<const Header*>(data)->length;
+    return length >= sizeof(Header) && length <= size ? length : 0;
+}
+
+} // namespace oe
+
+} // namespace network
+} // namespace hft
@@ -0,0 +1,539 @@
+#include "OrderEntrySession.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace hft {
+namespace network {
+
+// ---------------- OpenOrderTable ----------------
+
+OpenOrderTable::OpenOrderTable(size_t maxOrders)
+    : m_mask(0), m_count(0), m_maxOrders(maxOrders) {
+    // 负载不超过1/2，线性探测的平均探测长度保持在常数
+    size_t capacity = 2;
+    while (capacity < maxOrders * 2) {
+        capacity <<= 1;
+    }
+    m_slots.assign(capacity, OpenOrder{});
+    m_mask = capacity - 1;
+}
+
+OpenOrder* OpenOrderTable::find(uint64_t clientOrderId) {
+    return const_cast<OpenOrder*>(static_cast<const OpenOrderTable*>(this)->find(clientOrderId));
+}
+
+const OpenOrder* OpenOrderTable::find(uint64_t clientOrderId) const {
+    if (clientOrderId == 0) {
+        return nullptr;
+    }
+    size_t slot = hashId(clientOrderId) & m_mask;
+    while (m_slots[slot].client_order_id != 0) {
+        if (m_slots[slot].client_order_id == clientOrderId) {
+            return &m_slots[slot];
+        }
+        slot = (slot + 1) & m_mask;
+    }
+    return nullptr;
+}
+
+OpenOrder* OpenOrderTable::insert(const OpenOrder& order) {
+    if (order.client_order_id == 0 || m_count >= m_maxOrders) {
+        return nullptr;
+    }
+    size_t slot = hashId(order.client_order_id) & m_mask;
+    while (m_slots[slot].client_order_id != 0) {
+        if (m_slots[slot].client_order_id == order.client_order_id) {
+            return nullptr;
+        }
+        slot = (slot + 1) & m_mask;
+    }
+    m_slots[slot] = order;
+    ++m_count;
+    return &m_slots[slot];
+}
+
+void OpenOrderTable::erase(uint64_t clientOrderId) {
+    OpenOrder* order = find(clientOrderId);
+    if (!order) {
+        return;
+    }
+    // 反向移位删除，不留墓碑
+    size_t hole = static_cast<size_t>(order - m_slots.data());
+    size_t slot = (hole + 1) & m_mask;
+    while (m_slots[slot].client_order_id != 0) {
+        const size_t home = hashId(m_slots[slot].client_order_id) & m_mask;
+        if (((slot - home) & m_mask) >= ((slot - hole) & m_mask)) {
+            m_slots[hole] = m_slots[slot];
+            hole = slot;
+        }
+        slot = (slot + 1) & m_mask;
+    }
+    m_slots[hole].client_order_id = 0;
+    --m_count;
+}
+
+void OpenOrderTable::clear() {
+    for (auto& slot : m_slots) {
+        slot.client_order_id = 0;
+    }
+    m_count = 0;
+}
+
+// ---------------- OrderEntrySession ----------------
+
+OrderEntrySession::OrderEntrySession(OrderTransport& transport, const OrderEntryConfig& config)
+    : m_transport(transport), m_config(config),
+      m_logger("OrderEntrySession[" + std::to_string(config.session_id) + "]"), m_listener(nullptr),
+      m_orders(config.max_open_orders), m_nextSequence(1), m_expectedInbound(1),
+      m_nextClientOrderId(1), m_resendRequestedTo(0), m_resendRequestedAt(0) {
+}
+
+uint64_t OrderEntrySession::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool OrderEntrySession::open() {
+    if (!m_journal.open(m_config.journal_path, m_config.journal_bytes)) {
+        return false;
+    }
+
+    m_orders.clear();
+    m_nextSequence = 1;
+    m_expectedInbound = 1;
+    m_nextClientOrderId = 1;
+    m_resendRequestedTo = 0;
+    m_resendRequestedAt = 0;
+    if (m_journal.nextSequence() == 0) {
+        return true;
+    }
+
+    // 按日志重放出站消息：恢复序号与订单ID，未确认的订单以待确认状态放回订单表，
+    // 登录后交易所重发的回报会把它们推进到最新状态
+    for (uint64_t seq = m_journal.firstSequence(); seq < m_journal.nextSequence(); ++seq) {
+        const uint8_t* data;
+        size_t size;
+        m_journal.read(seq, data, size);
+        const auto* header = oe::view<oe::Header>(data, size);
+        if (!header) {
+            continue;
+        }
+        if (header->type == oe::NewOrder::kType) {
+            if (const auto* msg = oe::view<oe::NewOrder>(data, size)) {
+                OpenOrder order{};
+                order.client_order_id = msg->client_order_id;
+                order.symbol = msg->symbol;
+                order.side = static_cast<OrderSide>(msg->side);
+                order.type = static_cast<OrderType>(msg->order_type);
+                order.status = OrderStatus::PENDING_NEW;
+                order.price = msg->price;
+                order.quantity = msg->quantity;
+                m_orders.insert(order);
+                m_nextClientOrderId = std::max(m_nextClientOrderId, msg->client_order_id + 1);
+            }
+        } else if (header->type == oe::CancelOrder::kType) {
+            if (const auto* msg = oe::view<oe::CancelOrder>(data, size)) {
+                if (OpenOrder* order = m_orders.find(msg->client_order_id)) {
+                    order->cancel_pending = true;
+                }
+            }
+        } else if (header->type == oe::ReplaceOrder::kType) {
+            if (const auto* msg = oe::view<oe::ReplaceOrder>(data, size)) {
+                if (OpenOrder* orig = m_orders.find(msg->orig_client_order_id)) {
+                    OpenOrder placeholder = *orig;
+                    orig->replaced_by = msg->client_order_id;
+                    placeholder.client_order_id = msg->client_order_id;
+                    placeholder.replaces = msg->orig_client_order_id;
+                    placeholder.replaced_by = 0;
+                    placeholder.status = OrderStatus::PENDING_NEW;
+                    placeholder.price = msg->price;
+                    placeholder.quantity = msg->quantity;
+                    m_orders.insert(placeholder);
+                }
+                m_nextClientOrderId = std::max(m_nextClientOrderId, msg->client_order_id + 1);
+            }
+        }
+    }
+    m_nextSequence = m_journal.nextSequence();
+    m_logger.info("Recovered " + std::to_string(m_nextSequence - m_journal.firstSequence()) +
+                  " messages from journal");
+    return true;
+}
+
+bool OrderEntrySession::logon() {
+    // 会话消息不占用序号，也不写入日志；序号字段为本方下一个出站序号
+    auto* msg = stage<oe::Logon>();
+    msg->header.send_time = nowNs();
+    msg->next_expected = m_expectedInbound;
+    return m_transport.send(msg, sizeof(*msg));
+}
+
+bool OrderEntrySession::commit(size_t size, uint64_t start) {
+    if (!m_journal.append(m_nextSequence, m_sendBuffer, size)) {
+        m_logger.error("Order entry journal is full or closed");
+        ++m_stats.rejected_locally;
+        return false;
+    }
+    ++m_nextSequence;
+    // 日志中已有该消息：通道发送失败时等对方请求重发，不回滚序号
+    if (!m_transport.send(m_sendBuffer, size)) {
+        ++m_stats.send_failures;
+    }
+    recordSendLatency(start);
+    return true;
+}
+
+void OrderEntrySession::recordSendLatency(uint64_t start) {
+    const uint64_t latency = nowNs() - start;
+    if (m_stats.send_latency_min_ns == 0 || latency < m_stats.send_latency_min_ns) {
+        m_stats.send_latency_min_ns = latency;
+    }
+    if (latency > m_stats.send_latency_max_ns) {
+        m_stats.send_latency_max_ns = latency;
+    }
+    m_stats.send_latency_total_ns += latency;
+}
+
+uint64_t OrderEntrySession::sendNew(core::SymbolId symbol, OrderSide side, OrderType type,
+                                    types::Price price, uint64_t quantity, uint32_t strategyId) {
+    const uint64_t start = nowNs();
+    const uint64_t id = m_nextClientOrderId;
+
+    OpenOrder order{};
+    order.client_order_id = id;
+    order.symbol = symbol;
+    order.side = side;
+    order.type = type;
+    order.status = OrderStatus::PENDING_NEW;
+    order.price = price;
+    order.quantity = quantity;
+    order.sent_time = start;
+    if (!m_orders.insert(order)) {
+        ++m_stats.rejected_locally;
+        return 0;
+    }
+
+    auto* msg = stage<oe::NewOrder>();
+    msg->header.send_time = start;
+    msg->client_order_id = id;
+    msg->symbol = symbol;
+    msg->side = static_cast<uint8_t>(side);
+    msg->order_type = static_cast<uint8_t>(type);
+    msg->price = price;
+    msg->quantity = quantity;
+    msg->strategy = strategyId;
+    if (!commit(sizeof(*msg), start)) {
+        m_orders.erase(id);
+        return 0;
+    }
+
+    ++m_nextClientOrderId;
+    ++m_stats.orders_sent;
+    return id;
+}
+
+uint64_t OrderEntrySession::sendNew(const OrderRecord& record) {
+    const auto price = static_cast<types::Price>(std::llround(record.price * 10000.0));
+    return sendNew(record.symbolId, record.side, record.type, price, record.quantity, record.strategyId);
+}
+
+bool OrderEntrySession::sendCancel(uint64_t clientOrderId) {
+    const uint64_t start = nowNs();
+    OpenOrder* order = m_orders.find(clientOrderId);
+    if (!order || order->replaces != 0) {
+        // 改单确认前只能撤原订单
+        ++m_stats.rejected_locally;
+        return false;
+    }
+
+    auto* msg = stage<oe::CancelOrder>();
+    msg->header.send_time = start;
+    msg->client_order_id = clientOrderId;
+    if (!commit(sizeof(*msg), start)) {
+        return false;
+    }
+    order->cancel_pending = true;
+    ++m_stats.cancels_sent;
+    return true;
+}
+
+uint64_t OrderEntrySession::sendReplace(uint64_t clientOrderId, types::Price price, uint64_t quantity) {
+    const uint64_t start = nowNs();
+    OpenOrder* orig = m_orders.find(clientOrderId);
+    if (!orig || orig->replaced_by != 0 || orig->replaces != 0 || orig->cancel_pending) {
+        ++m_stats.rejected_locally;
+        return 0;
+    }
+
+    // 新ID先以占位订单进入订单表，确认或拒绝时再处理原订单
+    const uint64_t id = m_nextClientOrderId;
+    OpenOrder placeholder = *orig;
+    placeholder.client_order_id = id;
+    placeholder.replaces = clientOrderId;
+    placeholder.status = OrderStatus::PENDING_NEW;
+    placeholder.price = price;
+    placeholder.quantity = quantity;
+    placeholder.sent_time = start;
+    if (!m_orders.insert(placeholder)) {
+        ++m_stats.rejected_locally;
+        return 0;
+    }
+
+    auto* msg = stage<oe::ReplaceOrder>();
+    msg->header.send_time = start;
+    msg->orig_client_order_id = clientOrderId;
+    msg->client_order_id = id;
+    msg->price = price;
+    msg->quantity = quantity;
+    if (!commit(sizeof(*msg), start)) {
+        m_orders.erase(id);
+        return 0;
+    }
+
+    // 插入不移动已有表项，orig仍然有效
+    orig->replaced_by = id;
+    ++m_nextClientOrderId;
+    ++m_stats.replaces_sent;
+    return id;
+}
+
+size_t OrderEntrySession::resend(uint64_t from, uint64_t to) {
+    to = to == 0 ? m_nextSequence : std::min(to, m_nextSequence);
+    size_t count = 0;
+    for (uint64_t seq = from; seq < to; ++seq) {
+        const uint8_t* data;
+        size_t size;
+        if (!m_journal.read(seq, data, size) || size > sizeof(m_resendBuffer)) {
+            continue;
+        }
+        std::memcpy(m_resendBuffer, data, size);
+        auto* header = reinterpret_cast<oe::Header*>(m_resendBuffer);
+        header->flags |= oe::kPossDup;
+        header->send_time = nowNs();
+        if (m_transport.send(m_resendBuffer, size)) {
+            ++count;
+        }
+    }
+    m_stats.messages_resent += count;
+    return count;
+}
+
+void OrderEntrySession::requestResend(uint64_t from, uint64_t to) {
+    auto* request = stage<oe::ResendRequest>();
+    request->header.send_time = nowNs();
+    request->from = from;
+    request->to = to;
+    m_transport.send(request, sizeof(*request));
+}
+
+void OrderEntrySession::requestGapFill(uint64_t seenTo, uint64_t now) {
+    // 不设上限：对方重发到处理请求时的最新序号，在此之前发出的后续消息都包含在重发中
+    requestResend(m_expectedInbound, 0);
+    m_resendRequestedTo = std::max(m_resendRequestedTo, seenTo);
+    m_resendRequestedAt = now;
+}
+
+bool OrderEntrySession::poll(uint64_t now) {
+    if (m_expectedInbound >= m_resendRequestedTo || now - m_resendRequestedAt < m_config.resend_timeout_ns) {
+        return false;
+    }
+    ++m_stats.resend_retries;
+    requestGapFill(m_resendRequestedTo, now);
+    return true;
+}
+
+size_t OrderEntrySession::onData(const uint8_t* data, size_t size) {
+    size_t offset = 0;
+    size_t count = 0;
+    while (offset < size) {
+        const size_t length = oe::frameLength(data + offset, size - offset);
+        if (length == 0) {
+            m_logger.error("Malformed order entry message, dropping " + std::to_string(size - offset) + " bytes");
+            break;
+        }
+        handleMessage(data + offset, length);
+        offset += length;
+        ++count;
+    }
+    return count;
+}
+
+void OrderEntrySession::handleMessage(const uint8_t* data, size_t size) {
+    const auto* header = reinterpret_cast<const oe::Header*>(data);
+    ++m_stats.messages_received;
+
+    // 会话消息
+    if (header->type == oe::Logon::kType) {
+        if (const auto* msg = oe::view<oe::Logon>(data, size)) {
+            // 对方报告的期望序号落后于本方，重发缺失部分
+            if (msg->next_expected < m_nextSequence) {
+                resend(msg->next_expected, m_nextSequence);
+            }
+            if (header->sequence > m_expectedInbound) {
+                ++m_stats.inbound_gaps;
+                requestGapFill(header->sequence, nowNs());
+            }
+        }
+        return;
+    }
+    if (header->type == oe::ResendRequest::kType) {
+        if (const auto* msg = oe::view<oe::ResendRequest>(data, size)) {
+            resend(msg->from, msg->to);
+        }
+        return;
+    }
+
+    // 应用消息按序号处理：重复的忽略，超前的丢弃并请求重发
+    if (header->sequence < m_expectedInbound) {
+        ++m_stats.duplicates_received;
+        return;
+    }
+    if (header->sequence > m_expectedInbound) {
+        // 超前的消息会包含在重发中，直接丢弃。上一次请求补齐之前不再请求；
+        // 请求或重发在UDP上可能丢失，缺口超时仍未补齐时由后续消息或poll()重新请求
+        if (m_expectedInbound >= m_resendRequestedTo) {
+            ++m_stats.inbound_gaps;
+            requestGapFill(header->sequence + 1, nowNs());
+        } else {
+            const uint64_t now = nowNs();
+            if (now - m_resendRequestedAt >= m_config.resend_timeout_ns) {
+                ++m_stats.resend_retries;
+                requestGapFill(header->sequence + 1, now);
+            }
+        }
+        return;
+    }
+    ++m_expectedInbound;
+
+    switch (header->type) {
+        case oe::OrderAccepted::kType:
+            if (const auto* msg = oe::view<oe::OrderAccepted>(data, size)) handleAccepted(*msg);
+            break;
+        case oe::OrderRejected::kType:
+            if (const auto* msg = oe::view<oe::OrderRejected>(data, size)) handleRejected(*msg);
+            break;
+        case oe::OrderCanceled::kType:
+            if (const auto* msg = oe::view<oe::OrderCanceled>(data, size)) handleCanceled(*msg);
+            break;
+        case oe::OrderReplaced::kType:
+            if (const auto* msg = oe::view<oe::OrderReplaced>(data, size)) handleReplaced(*msg);
+            break;
+        case oe::OrderExecuted::kType:
+            if (const auto* msg = oe::view<oe::OrderExecuted>(data, size)) handleExecuted(*msg);
+            break;
+        default:
+            m_logger.warning(std::string("Unknown order entry message type: ") + header->type);
+            break;
+    }
+}
+
+void OrderEntrySession::handleAccepted(const oe::OrderAccepted& msg) {
+    OpenOrder* order = m_orders.find(msg.client_order_id);
+    if (!order) {
+        ++m_stats.unknown_orders;
+        return;
+    }
+    order->exchange_order_id = msg.exchange_order_id;
+    if (order->status == OrderStatus::PENDING_NEW) {
+        order->status = OrderStatus::NEW;
+    }
+    if (order->sent_time != 0) {
+        const uint64_t latency = nowNs() - order->sent_time;
+        if (m_stats.ack_latency_min_ns == 0 || latency < m_stats.ack_latency_min_ns) {
+            m_stats.ack_latency_min_ns = latency;
+        }
+        if (latency > m_stats.ack_latency_max_ns) {
+            m_stats.ack_latency_max_ns = latency;
+        }
+        m_stats.ack_latency_total_ns += latency;
+        ++m_stats.acks;
+    }
+    if (m_listener) {
+        m_listener->onOrderAccepted(*order);
+    }
+}
+
+void OrderEntrySession::handleRejected(const oe::OrderRejected& msg) {
+    OpenOrder* order = m_orders.find(msg.client_order_id);
+    if (!order) {
+        ++m_stats.unknown_orders;
+        return;
+    }
+    order->status = OrderStatus::REJECTED;
+    const OpenOrder rejected = *order;
+    if (rejected.replaces != 0) {
+        // 改单被拒：原订单保持不变
+        if (OpenOrder* orig = m_orders.find(rejected.replaces)) {
+            orig->replaced_by = 0;
+        }
+    }
+    m_orders.erase(msg.client_order_id);
+    if (m_listener) {
+        m_listener->onOrderRejected(rejected, msg.reason);
+    }
+}
+
+void OrderEntrySession::handleCanceled(const oe::OrderCanceled& msg) {
+    OpenOrder* order = m_orders.find(msg.client_order_id);
+    if (!order) {
+        ++m_stats.unknown_orders;
+        return;
+    }
+    order->status = OrderStatus::CANCELLED;
+    order->cancel_pending = false;
+    const OpenOrder canceled = *order;
+    if (canceled.replaced_by != 0) {
+        // 撤单先于改单生效，改单占位作废
+        m_orders.erase(canceled.replaced_by);
+    }
+    m_orders.erase(msg.client_order_id);
+    if (m_listener) {
+        m_listener->onOrderCanceled(canceled);
+    }
+}
+
+void OrderEntrySession::handleReplaced(const oe::OrderReplaced& msg) {
+    OpenOrder* orig = m_orders.find(msg.orig_client_order_id);
+    OpenOrder* order = m_orders.find(msg.client_order_id);
+    if (!order) {
+        ++m_stats.unknown_orders;
+        return;
+    }
+    order->status = OrderStatus::NEW;
+    order->replaces = 0;
+    order->price = msg.price;
+    order->quantity = msg.quantity;
+    if (orig) {
+        order->exchange_order_id = orig->exchange_order_id;
+        order->filled = orig->filled;
+    }
+    const OpenOrder replaced = *order;
+    m_orders.erase(msg.orig_client_order_id);
+    if (m_listener) {
+        m_listener->onOrderReplaced(replaced, msg.orig_client_order_id);
+    }
+}
+
+void OrderEntrySession::handleExecuted(const oe::OrderExecuted& msg) {
+    OpenOrder* order = m_orders.find(msg.client_order_id);
+    if (!order) {
+        ++m_stats.unknown_orders;
+        return;
+    }
+    order->filled += msg.quantity;
+    order->status = order->filled >= order->quantity ? OrderStatus::FILLED : OrderStatus::PARTIALLY_FILLED;
+    const OpenOrder executed = *order;
+    if (executed.status == OrderStatus::FILLED) {
+        if (executed.replaced_by != 0) {
+            m_orders.erase(executed.replaced_by);
+        }
+        m_orders.erase(msg.client_order_id);
+    }
+    if (m_listener) {
+        m_listener->onExecution(executed, msg.price, msg.quantity);
+    }
+}
+
+} // namespace network
+} // namespace hft
@@ -0,0 +1,206 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "OrderEntryProtocol.h"
+#include "SessionJournal.h"
+#include "../core/Logger.h"
+#include "../core/SymbolRegistry.h"
+#include "../core/Types.h"
+#include "../execution/Order.h"
+
+namespace hft {
+namespace network {
+
+// 下单会话的底层发送通道（TCP连接、LowLatencyNetwork或LoopbackExchange）
+class OrderTransport {
+public:
+    virtual ~OrderTransport() = default;
+    virtual bool send(const void* data, size_t size) = 0;
+};
+
+// 会话配置
+struct OrderEntryConfig {
+    uint32_t session_id = 1;
+    size_t max_open_orders = 1 << 16;
+    std::string journal_path;               // 为空时重发日志只保存在内存中
+    size_t journal_bytes = 64 << 20;
+    uint64_t resend_timeout_ns = 100000000; // 重发请求在此时间内未补齐缺口时重新请求（请求或重发可能丢失）
+};
+
+// 未完成订单
+struct OpenOrder {
+    uint64_t client_order_id;               // 0表示空槽
+    uint64_t exchange_order_id;
+    uint64_t replaces;                      // 改单占位：被替换的原订单ID
+    uint64_t replaced_by;                   // 改单进行中：新订单ID
+    core::SymbolId symbol;
+    OrderSide side;
+    OrderType type;
+    OrderStatus status;
+    bool cancel_pending;
+    types::Price price;
+    uint64_t quantity;
+    uint64_t filled;
+    uint64_t sent_time;                     // 发出时间（单调时钟纳秒）
+
+    uint64_t remaining() const { return quantity > filled ? quantity - filled : 0; }
+};
+
+// 会话回报通知（在调用onData的线程上同步调用）
+class OrderSessionListener {
+public:
+    virtual ~OrderSessionListener() = default;
+    virtual void onOrderAccepted(const OpenOrder& order) { (void)order; }
+    virtual void onOrderRejected(const OpenOrder& order, uint32_t reason) { (void)order; (void)reason; }
+    virtual void onOrderCanceled(const OpenOrder& order) { (void)order; }
+    // order为改单后的订单，origClientOrderId为原订单ID
+    virtual void onOrderReplaced(const OpenOrder& order, uint64_t origClientOrderId) { (void)order; (void)origClientOrderId; }
+    virtual void onExecution(const OpenOrder& order, types::Price price, uint64_t quantity) {
+        (void)order; (void)price; (void)quantity;
+    }
+};
+
+// 会话统计
+struct OrderEntryStats {
+    uint64_t orders_sent = 0;
+    uint64_t cancels_sent = 0;
+    uint64_t replaces_sent = 0;
+    uint64_t send_failures = 0;             // 通道发送失败（已写入日志，可重发）
+    uint64_t rejected_locally = 0;          // 订单表或日志已满、订单不存在
+    uint64_t messages_received = 0;
+    uint64_t unknown_orders = 0;            // 回报对应的订单不在订单表中
+    uint64_t inbound_gaps = 0;              // 每个缺口请求一次重发
+    uint64_t resend_retries = 0;            // 超时未补齐而重新发出的重发请求
+    uint64_t duplicates_received = 0;       // 序号已处理过的消息（重发重叠或对方重复发送）
+    uint64_t messages_resent = 0;
+    uint64_t send_latency_min_ns = 0;       // 编码到通道返回
+    uint64_t send_latency_max_ns = 0;
+    uint64_t send_latency_total_ns = 0;
+    uint64_t ack_latency_min_ns = 0;        // 新单发出到收到确认
+    uint64_t ack_latency_max_ns = 0;
+    uint64_t ack_latency_total_ns = 0;
+    uint64_t acks = 0;
+};
+
+// 开放寻址的未完成订单表，以客户端订单ID为键，容量固定
+class OpenOrderTable {
+public:
+    explicit OpenOrderTable(size_t maxOrders);
+
+    OpenOrder* find(uint64_t clientOrderId);
+    const OpenOrder* find(uint64_t clientOrderId) const;
+    // 表满或ID已存在时返回nullptr
+    OpenOrder* insert(const OpenOrder& order);
+    // 删除后其他表项可能移动，之前取得的指针失效
+    void erase(uint64_t clientOrderId);
+    size_t size() const { return m_count; }
+    void clear();
+
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& slot : m_slots) {
+            if (slot.client_order_id != 0) {
+                fn(slot);
+            }
+        }
+    }
+
+private:
+    static size_t hashId(uint64_t id) { return static_cast<size_t>((id * 0x9E3779B97F4A7C15ULL) >> 20); }
+
+    std::vector<OpenOrder> m_slots;
+    size_t m_mask;
+    size_t m_count;
+    size_t m_maxOrders;
+};
+
+// 二进制下单会话
+//
+//  - 新单/撤单/改单在预分配的发送缓冲区中就地编码，客户端订单ID为递增整数
+//  - 每条发出的消息带会话序号并先写入重发日志；对方请求重发或登录时报告的
+//    期望序号落后时，从日志中按原样重发（置PossDup）
+//  - 未完成订单保存在开放寻址表中，回报按ID O(1)更新，终态时删除
+//  - 稳态下发单与处理回报都不分配内存
+//
+// 非线程安全：发单与onData需在同一线程调用，或由调用方加锁。
+class OrderEntrySession {
+public:
+    OrderEntrySession(OrderTransport& transport, const OrderEntryConfig& config = OrderEntryConfig());
+
+    OrderEntrySession(const OrderEntrySession&) = delete;
+    OrderEntrySession& operator=(const OrderEntrySession&) = delete;
+
+    // 打开重发日志并从中恢复出站序号与订单ID
+    bool open();
+    // 发送登录消息，报告期望收到的交易所序号
+    bool logon();
+
+    void setListener(OrderSessionListener* listener) { m_listener = listener; }
+
+    // 发送新单，返回客户端订单ID，失败返回0
+    uint64_t sendNew(core::SymbolId symbol, OrderSide side, OrderType type,
+                     types::Price price, uint64_t quantity, uint32_t strategyId = 0);
+    uint64_t sendNew(const OrderRecord& record);
+    bool sendCancel(uint64_t clientOrderId);
+    // 改单，返回改单后的新客户端订单ID，失败返回0
+    uint64_t sendReplace(uint64_t clientOrderId, types::Price price, uint64_t quantity);
+
+    // 处理交易所发来的字节流（可含多条完整消息），返回处理的消息数
+    size_t onData(const uint8_t* data, size_t size);
+    // 从日志重发[from, to)，to为0时重发到最新
+    size_t resend(uint64_t from, uint64_t to);
+    // 由定时器周期调用：重发请求超过resend_timeout_ns仍未补齐缺口时重新请求，返回是否发出请求
+    bool poll(uint64_t now);
+
+    const OpenOrder* findOrder(uint64_t clientOrderId) const { return m_orders.find(clientOrderId); }
+    const OpenOrderTable& orders() const { return m_orders; }
+    size_t openOrders() const { return m_orders.size(); }
+    uint64_t nextSequence() const { return m_nextSequence; }
+    uint64_t expectedInbound() const { return m_expectedInbound; }
+    uint64_t nextClientOrderId() const { return m_nextClientOrderId; }
+    const OrderEntryStats& stats() const { return m_stats; }
+
+    static uint64_t nowNs();
+
+private:
+    template<typename Message>
+    Message* stage() {
+        Message* message = oe::encode<Message>(m_sendBuffer);
+        message->header.session = m_config.session_id;
+        message->header.sequence = m_nextSequence;
+        return message;
+    }
+    // 写入日志并发送暂存的消息，成功写入日志即占用序号
+    bool commit(size_t size, uint64_t start);
+    void recordSendLatency(uint64_t start);
+    void requestResend(uint64_t from, uint64_t to);
+    // 请求补齐缺口，seenTo为已知缺口之后收到的最大序号+1
+    void requestGapFill(uint64_t seenTo, uint64_t now);
+
+    void handleMessage(const uint8_t* data, size_t size);
+    void handleAccepted(const oe::OrderAccepted& msg);
+    void handleRejected(const oe::OrderRejected& msg);
+    void handleCanceled(const oe::OrderCanceled& msg);
+    void handleReplaced(const oe::OrderReplaced& msg);
+    void handleExecuted(const oe::OrderExecuted& msg);
+
+    OrderTransport& m_transport;
+    OrderEntryConfig m_config;
+    core::Logger m_logger;
+    OrderSessionListener* m_listener;
+    SessionJournal m_journal;
+    OpenOrderTable m_orders;
+    alignas(64) uint8_t m_sendBuffer[oe::kMaxMessageSize];
+    uint8_t m_resendBuffer[oe::kMaxMessageSize];
+    uint64_t m_nextSequence;
+    uint64_t m_expectedInbound;
+    uint64_t m_nextClientOrderId;
+    uint64_t m_resendRequestedTo;           // 未补齐的重发请求至少覆盖到的序号（不含），补齐或超时前不再请求
+    uint64_t m_resendRequestedAt;           // 最近一次重发请求的时间
+    OrderEntryStats m_stats;
+};
+
+} // namespace network
+} // namespace hft
@@ -1,17 +1,77 @@
 #include "OrderRouting.h"
+#include <algorithm>
 #include <iostream>
-#include <chrono>
-#include <random>
-#include <sstream>
+#include <cmath>
+#include <cstdlib>
 
 namespace hft {
 namespace network {
 
+namespace {
+
+OrderType toRoutingType(hft::OrderType type) {
+    switch (type) {
+        case hft::OrderType::MARKET: return OrderType::MARKET;
+        case hft::OrderType::LIMIT: return OrderType::LIMIT;
+        case hft::OrderType::STOP: return OrderType::STOP;
+        case hft::OrderType::STOP_LIMIT: return OrderType::STOP_LIMIT;
+        case hft::OrderType::ICEBERG: return OrderType::ICEBERG;
+        default: return OrderType::LIMIT;
+    }
+}
+
+hft::OrderType toRecordType(OrderType type) {
+    switch (type) {
+        case OrderType::MARKET: return hft::OrderType::MARKET;
+        case OrderType::LIMIT: return hft::OrderType::LIMIT;
+        case OrderType::STOP: return hft::OrderType::STOP;
+        case OrderType::STOP_LIMIT: return hft::OrderType::STOP_LIMIT;
+        case OrderType::ICEBERG: return hft::OrderType::ICEBERG;
+        default: return hft::OrderType::LIMIT;
+    }
+}
+
+OrderStatus toRoutingStatus(hft::OrderStatus status) {
+    switch (status) {
+        case hft::OrderStatus::PENDING_NEW: return OrderStatus::PENDING_NEW;
+        case hft::OrderStatus::NEW: return OrderStatus::NEW;
+        case hft::OrderStatus::PARTIALLY_FILLED: return OrderStatus::PARTIALLY_FILLED;
+        case hft::OrderStatus::FILLED: return OrderStatus::FILLED;
+        case hft::OrderStatus::CANCELLED: return OrderStatus::CANCELED;
+        case hft::OrderStatus::EXPIRED: return OrderStatus::CANCELED;
+        default: return OrderStatus::REJECTED;
+    }
+}
+
+types::Price toPrice(double price) {
+    return static_cast<types::Price>(std::llround(price * 10000.0));
+}
+
+// 数量必须是正整数手数：小数、非正数、非有限值或超出整数精度的数量返回false，不做舍入
+bool toLots(double quantity, uint64_t& lots) {
+    if (!std::isfinite(quantity) || quantity < 1.0 || quantity > 9007199254740992.0 ||
+        std::floor(quantity) != quantity) {
+        return false;
+    }
+    lots = static_cast<uint64_t>(quantity);
+    return true;
+}
+
+// 解析十进制订单ID，非法返回0
+uint64_t parseOrderId(const std::string& orderId) {
+    char* end = nullptr;
+    const unsigned long long id = std::strtoull(orderId.c_str(), &end, 10);
+    return end && *end == '\0' ? static_cast<uint64_t>(id) : 0;
+}
+
+} // namespace
+
 OrderRouting::OrderRouting(const std::string& name, const core::Configuration& config,
                            std::shared_ptr<LowLatencyNetwork> network,
                            std::shared_ptr<core::EventLoop> eventLoop)
     : m_name(name), m_config(config), m_network(network), m_eventLoop(eventLoop),
-      m_logger("OrderRouting[" + name + "]"), m_running(false) {
+      m_logger("OrderRouting[" + name + "]"), m_running(false),
+      m_transport(*this), m_listener(*this) {
 }
 
 OrderRouting::~OrderRouting() {
@@ -22,8 +82,26 @@ bool OrderRouting::initialize() {
     m_logger.info("Initializing order routing...");
 
     // 从配置中获取连接信息
-    m_host = m_config.getString("order_routing." + m_name + ".host", "127.0.0.1");
-    m_port = static_cast<uint16_t>(m_config.getInt("order_routing." + m_name + ".port", 5556));
+    const std::string prefix = "order_routing." + m_name + ".";
+    m_host = m_config.getString(prefix + "host", "127.0.0.1");
+    m_port = static_cast<uint16_t>(m_config.getInt(prefix + "port", 5556));
+
+    OrderEntryConfig sessionConfig;
+    sessionConfig.session_id = static_cast<uint32_t>(m_config.getInt(prefix + "session_id", 1));
+    sessionConfig.max_open_orders = static_cast<size_t>(m_config.getInt(prefix + "max_open_orders", 1 << 16));
+    sessionConfig.journal_path = m_config.getString(prefix + "journal", "");
+    sessionConfig.journal_bytes = static_cast<size_t>(m_config.getInt(prefix + "journal_mb", 64)) << 20;
+    m_resendTimeoutMs = std::max(1, m_config.getInt(prefix + "resend_timeout_ms", 100));
+    sessionConfig.resend_timeout_ns = static_cast<uint64_t>(m_resendTimeoutMs) * 1000000;
+
+    std::lock_guard<std::mutex> lock(m_orderMutex);
+    m_session = std::make_unique<OrderEntrySession>(m_transport, sessionConfig);
+    m_session->setListener(&m_listener);
+    if (!m_session->open()) {
+        m_logger.error("Failed to open order entry session journal: " + sessionConfig.journal_path);
+        m_session.reset();
+        return false;
+    }
 
     m_logger.info("Order routing initialized successfully");
     return true;
@@ -34,6 +112,10 @@ void OrderRouting::start() {
         m_logger.warning("Order routing is already running");
         return;
     }
+    if (!m_session) {
+        m_logger.error("Cannot start order routing, not initialized");
+        return;
+    }
 
     m_logger.info("Starting order routing...");
     m_running = true;
@@ -46,6 +128,22 @@ void OrderRouting::start() {
         handleOrderResponse(host, port, data, size);
     });
 
+    // 登录：双方交换期望序号，补发断线期间的缺口
+    {
+        std::lock_guard<std::mutex> lock(m_orderMutex);
+        m_session->logon();
+    }
+
+    // 重发请求或重发本身丢失时，缺口超时后重新请求
+    if (m_eventLoop) {
+        m_resendTimer = m_eventLoop->addPeriodicTimer([this]() {
+            std::lock_guard<std::mutex> lock(m_orderMutex);
+            if (m_session && m_session->poll(OrderEntrySession::nowNs())) {
+                m_logger.warning("Inbound gap still open, resend requested again");
+            }
+        }, std::chrono::milliseconds(m_resendTimeoutMs));
+    }
+
     m_logger.info("Order routing started successfully");
 }
 
@@ -56,15 +154,25 @@ void OrderRouting::stop() {
     }
 
     m_logger.info("Stopping order routing...");
-    m_running = false;
 
     // 取消所有未完成的订单
-    std::lock_guard<std::mutex> lock(m_orderMutex);
-    for (const auto& order : m_orders) {
-        if (order.status != OrderStatus::FILLED && order.status != OrderStatus::CANCELED && order.status != OrderStatus::REJECTED) {
-            cancelOrder(order.orderId);
+    {
+        std::lock_guard<std::mutex> lock(m_orderMutex);
+        std::vector<uint64_t> open;
+        m_session->orders().forEach([&open](const OpenOrder& order) {
+            if (!order.cancel_pending && order.replaces == 0) {
+                open.push_back(order.client_order_id);
+            }
+        });
+        for (uint64_t id : open) {
+            m_session->sendCancel(id);
         }
     }
+    m_running = false;
+    if (m_eventLoop && m_resendTimer != 0) {
+        m_eventLoop->cancelTimer(m_resendTimer);
+        m_resendTimer = 0;
+    }
 
     // 断开连接
     m_network->disconnect(m_host, m_port);
@@ -72,118 +180,111 @@ void OrderRouting::stop() {
     m_logger.info("Order routing stopped successfully");
 }
 
-std::string OrderRouting::sendOrder(const std::string& symbol, OrderType type, OrderSide side, double quantity, double price) {
+uint64_t OrderRouting::submitOrder(const hft::OrderRecord& record) {
     if (!m_running) {
         m_logger.error("Cannot send order, routing is not running");
-        return "";
+        return 0;
     }
-
-    // 生成订单ID
-    std::string orderId = generateOrderId();
-
-    // 创建订单
-    Order order(orderId, symbol, type, side, quantity, price);
-
-    // 添加到订单集合
+    uint64_t id;
     {
         std::lock_guard<std::mutex> lock(m_orderMutex);
-        m_orders.push_back(order);
+        id = m_session->sendNew(record);
     }
-
-    // 构建订单消息并发送
-    // 注意：这只是一个框架，实际实现需要根据具体的订单协议进行序列化
-    std::stringstream ss;
-    ss << "NEW_ORDER," << orderId << "," << symbol << "," << static_cast<int>(type) << "," << static_cast<int>(side) << "," << quantity << "," << price;
-    std::string message = ss.str();
-
-    if (m_network->send(m_host, m_port, message.c_str(), message.size())) {
-        m_logger.info("Sent order: " + orderId + " " + symbol + " " + (side == OrderSide::BUY ? "BUY" : "SELL") + " " + std::to_string(quantity) + " @ " + std::to_string(price));
-        return orderId;
-    } else {
-        m_logger.error("Failed to send order: " + orderId);
-        // 从订单集合中移除
-        std::lock_guard<std::mutex> lock(m_orderMutex);
-        for (auto it = m_orders.begin(); it != m_orders.end(); ++it) {
-            if (it->orderId == orderId) {
-                m_orders.erase(it);
-                break;
-            }
-        }
-        return "";
+    if (id == 0) {
+        m_logger.error("Failed to send order for symbol id " + std::to_string(record.symbolId));
     }
+    return id;
 }
 
-bool OrderRouting::cancelOrder(const std::string& orderId) {
+bool OrderRouting::cancelOrder(uint64_t clientOrderId) {
     if (!m_running) {
         m_logger.error("Cannot cancel order, routing is not running");
         return false;
     }
-
-    // 检查订单是否存在
-    bool orderExists = false;
+    bool sent;
     {
         std::lock_guard<std::mutex> lock(m_orderMutex);
-        for (const auto& order : m_orders) {
-            if (order.orderId == orderId) {
-                orderExists = true;
-                break;
-            }
-        }
+        sent = m_session->sendCancel(clientOrderId);
     }
-
-    if (!orderExists) {
-        m_logger.error("Order not found: " + orderId);
-        return false;
-    }
-
-    // 构建取消订单消息并发送
-    std::string message = "CANCEL_ORDER," + orderId;
-    if (m_network->send(m_host, m_port, message.c_str(), message.size())) {
-        m_logger.info("Sent cancel request for order: " + orderId);
-        // 更新订单状态为PENDING_CANCEL
-        updateOrderStatus(orderId, OrderStatus::PENDING_CANCEL);
-        return true;
-    } else {
-        m_logger.error("Failed to send cancel request for order: " + orderId);
-        return false;
+    if (!sent) {
+        m_logger.error("Order not found or cannot be canceled: " + std::to_string(clientOrderId));
     }
+    return sent;
 }
 
-bool OrderRouting::modifyOrder(const std::string& orderId, double quantity, double price) {
+uint64_t OrderRouting::replaceOrder(uint64_t clientOrderId, types::Price price, uint64_t quantity) {
     if (!m_running) {
         m_logger.error("Cannot modify order, routing is not running");
-        return false;
+        return 0;
     }
-
-    // 检查订单是否存在
-    bool orderExists = false;
+    uint64_t id;
     {
         std::lock_guard<std::mutex> lock(m_orderMutex);
-        for (const auto& order : m_orders) {
-            if (order.orderId == orderId) {
-                orderExists = true;
-                break;
-            }
-        }
+        id = m_session->sendReplace(clientOrderId, price, quantity);
+    }
+    if (id == 0) {
+        m_logger.error("Order not found or cannot be modified: " + std::to_string(clientOrderId));
+    }
+    return id;
+}
+
+OrderEntryStats OrderRouting::getSessionStats() {
+    std::lock_guard<std::mutex> lock(m_orderMutex);
+    return m_session ? m_session->stats() : OrderEntryStats();
+}
+
+std::string OrderRouting::sendOrder(const std::string& symbol, OrderType type, OrderSide side, double quantity, double price) {
+    hft::OrderRecord record{};
+    record.symbolId = core::internSymbol(symbol);
+    if (record.symbolId == core::kInvalidSymbol) {
+        m_logger.error("Order rejected, invalid symbol: " + symbol);
+        return "";
+    }
+    record.type = toRecordType(type);
+    record.side = side == OrderSide::BUY ? hft::OrderSide::BUY : hft::OrderSide::SELL;
+    if (!toLots(quantity, record.quantity)) {
+        m_logger.error("Order rejected, quantity must be a positive whole number: " + std::to_string(quantity));
+        return "";
+    }
+    record.price = price;
+    const uint64_t id = submitOrder(record);
+    if (id == 0) {
+        return "";
     }
+    m_logger.info("Sent order: " + std::to_string(id) + " " + symbol + " " + (side == OrderSide::BUY ? "BUY" : "SELL") + " " + std::to_string(quantity) + " @ " + std::to_string(price));
+    return std::to_string(id);
+}
 
-    if (!orderExists) {
+std::string OrderRouting::sendOrder(const hft::OrderRecord& record) {
+    if (core::symbolName(record.symbolId).empty()) {
+        m_logger.error("Cannot send order, unknown symbol id: " + std::to_string(record.symbolId));
+        return "";
+    }
+    const uint64_t id = submitOrder(record);
+    return id == 0 ? "" : std::to_string(id);
+}
+
+bool OrderRouting::cancelOrder(const std::string& orderId) {
+    const uint64_t id = parseOrderId(orderId);
+    if (id == 0) {
         m_logger.error("Order not found: " + orderId);
         return false;
     }
+    return cancelOrder(id);
+}
 
-    // 构建修改订单消息并发送
-    std::stringstream ss;
-    ss << "MODIFY_ORDER," << orderId << "," << quantity << "," << price;
-    std::string message = ss.str();
-
-    if (m_network->send(m_host, m_port, message.c_str(), message.size())) {
-        m_logger.info("Sent modify request for order: " + orderId);
-        return true;
-    } else {
-        m_logger.error("Failed to send modify request for order: " + orderId);
+bool OrderRouting::modifyOrder(const std::string& orderId, double quantity, double price) {
+    const uint64_t id = parseOrderId(orderId);
+    if (id == 0) {
+        m_logger.error("Order not found: " + orderId);
         return false;
     }
+    uint64_t lots = 0;
+    if (!toLots(quantity, lots)) {
+        m_logger.error("Modify rejected, quantity must be a positive whole number: " + std::to_string(quantity));
+        return false;
+    }
+    return replaceOrder(id, toPrice(price), lots) != 0;
 }
 
 void OrderRouting::registerStatusCallback(OrderStatusCallback callback) {
@@ -192,87 +293,62 @@ void OrderRouting::registerStatusCallback(OrderStatusCallback callback) {
     m_logger.info("Registered order status callback");
 }
 
-std::string OrderRouting::generateOrderId() {
-    // 生成唯一订单ID
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> distrib(0, 99999999);
-
-    auto now = std::chrono::system_clock::now();
-    auto duration = now.time_since_epoch();
-    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-
-    std::stringstream ss;
-    ss << "ORD" << millis << "-" << distrib(gen);
-    return ss.str();
+bool OrderRouting::NetworkTransport::send(const void* data, size_t size) {
+    return m_owner.m_network->send(m_owner.m_host, m_owner.m_port, data, size);
 }
 
 void OrderRouting::handleOrderResponse(const std::string& host, uint16_t port, const void* data, size_t size) {
-    // 在事件循环中处理订单响应
-    m_eventLoop->postTask([this, data, size]() {
-        // 解析订单响应
-        // 注意：这只是一个框架，实际实现需要根据具体的订单协议进行解析
-        std::string response(static_cast<const char*>(data), size);
-        m_logger.debug("Received order response: " + response);
-
-        // 假设响应格式: ORDER_STATUS,orderId,status
-        size_t pos1 = response.find(',');
-        if (pos1 == std::string::npos) {
-            m_logger.error("Invalid order response format: " + response);
-            return;
-        }
-
-        std::string type = response.substr(0, pos1);
-        if (type != "ORDER_STATUS") {
-            m_logger.warning("Unknown response type: " + type);
-            return;
-        }
-
-        size_t pos2 = response.find(',', pos1 + 1);
-        if (pos2 == std::string::npos) {
-            m_logger.error("Invalid order response format: " + response);
-            return;
-        }
+    (void)host;
+    (void)port;
+    // 回报在网络线程上直接解码：数据缓冲区只在回调期间有效，不能转交给事件循环
+    std::lock_guard<std::mutex> lock(m_orderMutex);
+    if (m_session) {
+        m_session->onData(static_cast<const uint8_t*>(data), size);
+    }
+}
 
-        std::string orderId = response.substr(pos1 + 1, pos2 - pos1 - 1);
-        std::string statusStr = response.substr(pos2 + 1);
+void OrderRouting::notifyStatus(const OpenOrder& order, OrderStatus status) {
+    std::lock_guard<std::mutex> callbackLock(m_callbackMutex);
+    if (m_callbacks.empty()) {
+        return;
+    }
 
+    // 只在有订阅者时构造字符串形式的订单
+    Order snapshot(std::to_string(order.client_order_id), std::string(core::symbolName(order.symbol)),
+                   toRoutingType(order.type), order.side == hft::OrderSide::BUY ? OrderSide::BUY : OrderSide::SELL,
+                   static_cast<double>(order.quantity), static_cast<double>(order.price) / 10000.0);
+    snapshot.status = status;
+    for (auto& callback : m_callbacks) {
         try {
-            int statusInt = std::stoi(statusStr);
-            OrderStatus status = static_cast<OrderStatus>(statusInt);
-            updateOrderStatus(orderId, status);
+            callback(snapshot);
         } catch (const std::exception& e) {
-            m_logger.error("Failed to parse order status: " + statusStr + ", error: " + e.what());
+            m_logger.error("Exception in order status callback: " + std::string(e.what()));
         }
-    });
+    }
 }
 
-void OrderRouting::updateOrderStatus(const std::string& orderId, OrderStatus status) {
-    std::lock_guard<std::mutex> orderLock(m_orderMutex);
-
-    // 查找订单并更新状态
-    for (auto& order : m_orders) {
-        if (order.orderId == orderId) {
-            OrderStatus oldStatus = order.status;
-            order.status = status;
-
-            m_logger.info("Order status updated: " + orderId + " from " + std::to_string(static_cast<int>(oldStatus)) + " to " + std::to_string(static_cast<int>(status)));
-
-            // 通知回调
-            std::lock_guard<std::mutex> callbackLock(m_callbackMutex);
-            for (auto& callback : m_callbacks) {
-                try {
-                    callback(order);
-                } catch (const std::exception& e) {
-                    m_logger.error("Exception in order status callback: " + std::string(e.what()));
-                }
-            }
+void OrderRouting::SessionListener::onOrderAccepted(const OpenOrder& order) {
+    m_owner.notifyStatus(order, toRoutingStatus(order.status));
+}
 
-            return;
-        }
-    }
+void OrderRouting::SessionListener::onOrderRejected(const OpenOrder& order, uint32_t reason) {
+    m_owner.m_logger.warning("Order rejected: " + std::to_string(order.client_order_id) + " reason " + std::to_string(reason));
+    m_owner.notifyStatus(order, OrderStatus::REJECTED);
+}
+
+void OrderRouting::SessionListener::onOrderCanceled(const OpenOrder& order) {
+    m_owner.notifyStatus(order, OrderStatus::CANCELED);
+}
+
+void OrderRouting::SessionListener::onOrderReplaced(const OpenOrder& order, uint64_t origClientOrderId) {
+    (void)origClientOrderId;
+    m_owner.notifyStatus(order, toRoutingStatus(order.status));
+}
 
-    m_logger.warning("Order not found when updating status: " + orderId);
+void OrderRouting::SessionListener::onExecution(const OpenOrder& order, types::Price price, uint64_t quantity) {
+    (void)price;
+    (void)quantity;
+    m_owner.notifyStatus(order, toRoutingStatus(order.status));
 }
 
 } // namespace network
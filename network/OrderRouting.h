@@ -6,9 +6,11 @@
 #include <vector>
 #include <functional>
 #include "LowLatencyNetwork.h"
+#include "OrderEntrySession.h"
 #include "../core/Configuration.h"
 #include "../core/EventLoop.h"
 #include "../core/Logger.h"
+#include "../execution/Order.h"
 
 namespace hft {
 namespace network {
@@ -75,18 +77,49 @@ public:
     // 路由状态
     bool isRunning() const { return m_running; }
 
-    // 发送订单
+    // 发送订单，返回十进制的客户端订单ID，失败返回空串；quantity须为正整数手数，不做舍入
     std::string sendOrder(const std::string& symbol, OrderType type, OrderSide side, double quantity, double price);
+    // 发送定长订单记录（标的名称由符号注册表解析）
+    std::string sendOrder(const hft::OrderRecord& record);
     // 取消订单
     bool cancelOrder(const std::string& orderId);
-    // 修改订单
+    // 修改订单，quantity要求同sendOrder
     bool modifyOrder(const std::string& orderId, double quantity, double price);
 
+    // 整数ID接口（热路径）：返回客户端订单ID，失败返回0
+    uint64_t submitOrder(const hft::OrderRecord& record);
+    bool cancelOrder(uint64_t clientOrderId);
+    // 改单，返回改单后的新客户端订单ID
+    uint64_t replaceOrder(uint64_t clientOrderId, types::Price price, uint64_t quantity);
+    OrderEntryStats getSessionStats();
+
     // 注册订单状态回调
     using OrderStatusCallback = std::function<void(const Order& order)>;
     void registerStatusCallback(OrderStatusCallback callback);
 
 private:
+    // 通过LowLatencyNetwork发送会话消息
+    class NetworkTransport : public OrderTransport {
+    public:
+        NetworkTransport(OrderRouting& owner) : m_owner(owner) {}
+        bool send(const void* data, size_t size) override;
+    private:
+        OrderRouting& m_owner;
+    };
+
+    // 会话回报转为订单状态回调
+    class SessionListener : public OrderSessionListener {
+    public:
+        SessionListener(OrderRouting& owner) : m_owner(owner) {}
+        void onOrderAccepted(const OpenOrder& order) override;
+        void onOrderRejected(const OpenOrder& order, uint32_t reason) override;
+        void onOrderCanceled(const OpenOrder& order) override;
+        void onOrderReplaced(const OpenOrder& order, uint64_t origClientOrderId) override;
+        void onExecution(const OpenOrder& order, types::Price price, uint64_t quantity) override;
+    private:
+        OrderRouting& m_owner;
+    };
+
     std::string m_name;
     core::Configuration m_config;
     std::shared_ptr<LowLatencyNetwork> m_network;
@@ -94,9 +127,13 @@ private:
     core::Logger m_logger;
     std::atomic<bool> m_running;
 
-    // 订单集合
-    std::vector<Order> m_orders;
+    // 下单会话（未完成订单保存在会话的订单表中），发单与回报处理都在m_orderMutex下进行
+    NetworkTransport m_transport;
+    SessionListener m_listener;
+    std::unique_ptr<OrderEntrySession> m_session;
     std::mutex m_orderMutex;
+    int m_resendTimeoutMs = 100;
+    core::EventLoop::TimerId m_resendTimer = 0;     // 周期调用m_session->poll()
 
     // 回调集合
     std::vector<OrderStatusCallback> m_callbacks;
@@ -106,12 +143,10 @@ private:
     std::string m_host;
     uint16_t m_port;
 
-    // 生成订单ID
-    std::string generateOrderId();
     // 处理订单响应
     void handleOrderResponse(const std::string& host, uint16_t port, const void* data, size_t size);
-    // 更新订单状态
-    void updateOrderStatus(const std::string& orderId, OrderStatus status);
+    // 通知订单状态回调
+    void notifyStatus(const OpenOrder& order, OrderStatus status);
 };
 
 } // namespace network
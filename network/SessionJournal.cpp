@@ -0,0 +1,157 @@
+#include "SessionJournal.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hft {
+namespace network {
+
+namespace {
+
+constexpr size_t kMinRecordSize = 16 + 8;
+
+size_t alignRecord(size_t size) {
+    return (size + 7) & ~size_t{7};
+}
+
+} // namespace
+
+SessionJournal::~SessionJournal() {
+    close();
+}
+
+bool SessionJournal::open(const std::string& path, size_t capacity) {
+    close();
+    capacity = alignRecord(capacity);
+
+    void* base = MAP_FAILED;
+    if (path.empty()) {
+        base = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    } else {
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (m_fd < 0) {
+            std::cerr << "Failed to open session journal " << path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        struct stat st;
+        if (::fstat(m_fd, &st) != 0) {
+            std::cerr << "fstat failed: " << std::strerror(errno) << std::endl;
+            close();
+            return false;
+        }
+        // 已有日志比请求的容量大时沿用原大小
+        if (static_cast<size_t>(st.st_size) > capacity) {
+            capacity = static_cast<size_t>(st.st_size) & ~size_t{7};
+        } else if (::ftruncate(m_fd, static_cast<off_t>(capacity)) != 0) {
+            std::cerr << "ftruncate failed: " << std::strerror(errno) << std::endl;
+            close();
+            return false;
+        }
+        base = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    }
+    if (base == MAP_FAILED) {
+        std::cerr << "Failed to map session journal: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    m_base = static_cast<uint8_t*>(base);
+    m_capacity = capacity;
+    // 预留索引，稳态追加不再扩容
+    m_offsets.reserve(capacity / (sizeof(Record) + kMinRecordSize));
+    recover();
+    return true;
+}
+
+void SessionJournal::recover() {
+    m_used = 0;
+    m_first = 0;
+    m_offsets.clear();
+    while (m_used + sizeof(Record) <= m_capacity) {
+        const auto* record = reinterpret_cast<const Record*>(m_base + m_used);
+        const size_t length = alignRecord(sizeof(Record) + record->size);
+        if (record->size == 0 || m_used + length > m_capacity) {
+            break;
+        }
+        if (!m_offsets.empty() && record->sequence != m_first + m_offsets.size()) {
+            std::cerr << "Session journal sequence break at " << record->sequence << std::endl;
+            break;
+        }
+        if (m_offsets.empty()) {
+            m_first = record->sequence;
+        }
+        m_offsets.push_back(m_used);
+        m_used += length;
+    }
+}
+
+void SessionJournal::close() {
+    if (m_base) {
+        if (m_fd >= 0) {
+            ::msync(m_base, m_used, MS_SYNC);
+        }
+        ::munmap(m_base, m_capacity);
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+    m_fd = -1;
+    m_base = nullptr;
+    m_capacity = 0;
+    m_used = 0;
+    m_first = 0;
+    m_offsets.clear();
+}
+
+bool SessionJournal::append(uint64_t sequence, const void* data, size_t size) {
+    if (!m_base || size == 0 || size > UINT32_MAX) {
+        return false;
+    }
+    if (!m_offsets.empty() && sequence != nextSequence()) {
+        return false;
+    }
+    const size_t length = alignRecord(sizeof(Record) + size);
+    if (m_used + length > m_capacity) {
+        return false;
+    }
+
+    auto* record = reinterpret_cast<Record*>(m_base + m_used);
+    record->reserved = 0;
+    record->sequence = sequence;
+    std::memcpy(m_base + m_used + sizeof(Record), data, size);
+    // 长度最后写入：进程中途退出时未完成的记录在恢复时被忽略
+    std::atomic_thread_fence(std::memory_order_release);
+    record->size = static_cast<uint32_t>(size);
+
+    if (m_offsets.empty()) {
+        m_first = sequence;
+    }
+    m_offsets.push_back(m_used);
+    m_used += length;
+    return true;
+}
+
+bool SessionJournal::read(uint64_t sequence, const uint8_t*& data, size_t& size) const {
+    if (m_offsets.empty() || sequence < m_first || sequence - m_first >= m_offsets.size()) {
+        return false;
+    }
+    const size_t offset = m_offsets[sequence - m_first];
+    const auto* record = reinterpret_cast<const Record*>(m_base + offset);
+    data = m_base + offset + sizeof(Record);
+    size = record->size;
+    return true;
+}
+
+void SessionJournal::sync() {
+    if (m_base && m_fd >= 0) {
+        ::msync(m_base, m_used, MS_ASYNC);
+    }
+}
+
+} // namespace network
+} // namespace hft
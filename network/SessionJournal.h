@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hft {
+namespace network {
+
+// 会话重发日志
+// 按序号顺序追加已发送的消息，用于断线重连或对方请求时重发。
+// 日志为预先扩展到固定容量的内存映射文件，追加只是一次memcpy；
+// 路径为空时使用匿名映射，仅在进程内保留。重新打开已有文件时按记录恢复序号索引。
+class SessionJournal {
+public:
+    SessionJournal() = default;
+    ~SessionJournal();
+
+    SessionJournal(const SessionJournal&) = delete;
+    SessionJournal& operator=(const SessionJournal&) = delete;
+
+    bool open(const std::string& path, size_t capacity);
+    void close();
+
+    // 追加序号为sequence的消息，序号必须连续；日志已满返回false
+    bool append(uint64_t sequence, const void* data, size_t size);
+    // 取出序号为sequence的消息，不在日志中返回false
+    bool read(uint64_t sequence, const uint8_t*& data, size_t& size) const;
+    // 将已写入部分刷到磁盘
+    void sync();
+
+    bool isOpen() const { return m_base != nullptr; }
+    uint64_t firstSequence() const { return m_first; }
+    // 日志中最后一条消息的下一个序号，空日志返回0
+    uint64_t nextSequence() const { return m_offsets.empty() ? 0 : m_first + m_offsets.size(); }
+    size_t bytesUsed() const { return m_used; }
+    size_t capacity() const { return m_capacity; }
+
+private:
+    // 记录头，其后为消息本体，整条记录按8字节对齐
+    struct Record {
+        uint32_t size;          // 消息字节数，0表示日志结束（最后写入）
+        uint32_t reserved;
+        uint64_t sequence;
+    };
+
+    void recover();
+
+    int m_fd = -1;
+    uint8_t* m_base = nullptr;
+    size_t m_capacity = 0;
+    size_t m_used = 0;
+    uint64_t m_first = 0;
+    std::vector<size_t> m_offsets;      // 第i项为序号m_first + i的记录偏移
+};
+
+} // namespace network
+} // namespace hft
@@ -0,0 +1,335 @@
+#include "SharedMemoryBus.h"
+#include <iostream>
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hft {
+namespace network {
+
+namespace {
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+bool processAlive(uint64_t pid) {
+    if (pid == 0 || pid > static_cast<uint64_t>(INT32_MAX)) {
+        return false;
+    }
+    return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+}
+
+// 段的现状：不存在/无效、发布方存活、发布方已退出且几何参数相同、几何参数不同
+enum class SegmentState { FRESH, OWNED, STALE, MISMATCH };
+
+SegmentState inspectSegment(int fd, size_t slotCount, size_t slotSize, size_t size) {
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < shm::kHeaderSize) {
+        return SegmentState::FRESH;
+    }
+    void* base = ::mmap(nullptr, shm::kHeaderSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return SegmentState::MISMATCH;
+    }
+    const auto* header = static_cast<const shm::Header*>(base);
+    SegmentState state = SegmentState::MISMATCH;
+    if (header->magic == shm::kMagic && header->version == shm::kVersion) {
+        if (processAlive(header->publisher_pid.load(std::memory_order_acquire))) {
+            state = SegmentState::OWNED;
+        } else if (header->slot_count == slotCount && header->slot_size == slotSize &&
+                   static_cast<size_t>(st.st_size) == size) {
+            state = SegmentState::STALE;
+        }
+    }
+    ::munmap(base, shm::kHeaderSize);
+    return state;
+}
+
+} // namespace
+
+ShmBusPublisher::~ShmBusPublisher() {
+    close();
+}
+
+bool ShmBusPublisher::create(const std::string& name, const ShmBusConfig& config) {
+    close();
+
+    const size_t slotCount = roundUpPowerOfTwo(config.slot_count < 2 ? 2 : config.slot_count);
+    const size_t slotSize = (config.slot_size + 7) & ~size_t{7};
+    if (slotSize == 0 || slotCount > UINT32_MAX || shm::slotStride(slotSize) > UINT32_MAX) {
+        std::cerr << "Invalid shared memory bus geometry" << std::endl;
+        return false;
+    }
+    const size_t size = shm::kHeaderSize + slotCount * shm::slotStride(slotSize);
+
+    if (name.empty()) {
+#ifdef __linux__
+        m_fd = ::memfd_create("hft_shm_bus", 0);
+#else
+        errno = ENOTSUP;
+#endif
+        if (m_fd < 0) {
+            std::cerr << "Failed to create shared memory bus: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    } else {
+        // 不截断已有的段：已连接的订阅方仍映射着它，直接截断会让它们读到SIGBUS
+        m_fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+        if (m_fd < 0) {
+            std::cerr << "Failed to create shared memory bus " << name << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        switch (inspectSegment(m_fd, slotCount, slotSize, size)) {
+            case SegmentState::OWNED:
+                std::cerr << "Shared memory bus " << name << " already has a live publisher" << std::endl;
+                ::close(m_fd);
+                m_fd = -1;
+                return false;
+            case SegmentState::STALE:
+                // 发布方已退出：原地重置，已连接的订阅方通过generation发现并从头接收
+                m_name = name;
+                if (!mapSegment(size)) {
+                    return false;
+                }
+                m_mask = slotCount - 1;
+                reinitialize();
+                return true;
+            case SegmentState::MISMATCH:
+                // 几何参数不同或内容无效：删除旧名字另建，旧映射由各订阅方自行释放
+                ::close(m_fd);
+                ::shm_unlink(name.c_str());
+                m_fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+                if (m_fd < 0) {
+                    std::cerr << "Failed to recreate shared memory bus " << name << ": " << std::strerror(errno) << std::endl;
+                    return false;
+                }
+                break;
+            case SegmentState::FRESH:
+                break;
+        }
+        m_name = name;
+    }
+
+    // 新建的段（或长度不足一个段头的残段）清零后扩展到所需长度
+    if (::ftruncate(m_fd, 0) != 0 || ::ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "ftruncate failed: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    if (!mapSegment(size)) {
+        return false;
+    }
+    m_mask = slotCount - 1;
+    initialize(slotCount, slotSize);
+    return true;
+}
+
+bool ShmBusPublisher::mapSegment(size_t size) {
+    void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "mmap failed: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    m_base = static_cast<uint8_t*>(base);
+    m_size = size;
+    m_header = reinterpret_cast<shm::Header*>(m_base);
+    m_next = 0;
+    return true;
+}
+
+void ShmBusPublisher::initialize(size_t slotCount, size_t slotSize) {
+    // 新扩展的段全部为0，槽位seq=0表示从未写入
+    auto* header = new (m_base) shm::Header();
+    header->slot_count = static_cast<uint32_t>(slotCount);
+    header->slot_size = static_cast<uint32_t>(slotSize);
+    header->slot_stride = static_cast<uint32_t>(shm::slotStride(slotSize));
+    header->version = shm::kVersion;
+    header->generation.store(0, std::memory_order_relaxed);
+    header->write_sequence.store(0, std::memory_order_relaxed);
+    header->publisher_pid.store(static_cast<uint64_t>(::getpid()), std::memory_order_relaxed);
+    // magic最后写入，订阅方以此判断段已初始化完成
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = shm::kMagic;
+    m_header = header;
+}
+
+void ShmBusPublisher::reinitialize() {
+    // generation先置为奇数再改动槽位：订阅方读到的任何新内容都伴随着generation的变化
+    const uint64_t generation = m_header->generation.load(std::memory_order_relaxed) | 1;
+    m_header->generation.store(generation, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->publisher_pid.store(static_cast<uint64_t>(::getpid()), std::memory_order_relaxed);
+    m_header->write_sequence.store(0, std::memory_order_relaxed);
+    for (uint64_t i = 0; i <= m_mask; ++i) {
+        slotAt(i)->seq.store(0, std::memory_order_relaxed);
+    }
+    m_header->generation.store(generation + 1, std::memory_order_release);
+}
+
+void ShmBusPublisher::close() {
+    if (m_header) {
+        m_header->publisher_pid.store(0, std::memory_order_release);
+    }
+    if (m_base) {
+        ::munmap(m_base, m_size);
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        if (!m_name.empty()) {
+            // 已打开的订阅方保留各自的映射
+            ::shm_unlink(m_name.c_str());
+        }
+    }
+    m_fd = -1;
+    m_name.clear();
+    m_base = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_mask = 0;
+    m_next = 0;
+}
+
+bool ShmBusPublisher::publish(const void* data, size_t size) {
+    if (!m_header || size > m_header->slot_size) {
+        return false;
+    }
+
+    const uint64_t sequence = m_next;
+    shm::Slot* slot = slotAt(sequence);
+    slot->seq.store(2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->size.store(size, std::memory_order_relaxed);
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const size_t fullWords = size / 8;
+    for (size_t i = 0; i < fullWords; ++i) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i * 8, 8);
+        slot->words[i].store(word, std::memory_order_relaxed);
+    }
+    if (size % 8 != 0) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + fullWords * 8, size % 8);
+        slot->words[fullWords].store(word, std::memory_order_relaxed);
+    }
+
+    slot->seq.store(2 * (sequence + 1), std::memory_order_release);
+    m_next = sequence + 1;
+    m_header->write_sequence.store(m_next, std::memory_order_release);
+    return true;
+}
+
+ShmBusSubscriber::~ShmBusSubscriber() {
+    close();
+}
+
+bool ShmBusSubscriber::open(const std::string& name, ShmBusStart start) {
+    close();
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "Failed to open shared memory bus " << name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    const bool ok = map(fd, start);
+    ::close(fd);
+    return ok;
+}
+
+bool ShmBusSubscriber::attach(int fd, ShmBusStart start) {
+    close();
+    return map(fd, start);
+}
+
+bool ShmBusSubscriber::map(int fd, ShmBusStart start) {
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < shm::kHeaderSize) {
+        std::cerr << "Shared memory bus segment is too small" << std::endl;
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    // 只读映射：订阅进程崩溃或出错不会破坏总线
+    void* base = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "mmap failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    const auto* header = static_cast<const shm::Header*>(base);
+    const uint64_t magic = header->magic;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t generation = header->generation.load(std::memory_order_acquire);
+    const size_t slotCount = header->slot_count;
+    const size_t slotSize = header->slot_size;
+    const size_t stride = header->slot_stride;
+    if (magic != shm::kMagic || header->version != shm::kVersion || (generation & 1) != 0 ||
+        slotCount == 0 || (slotCount & (slotCount - 1)) != 0 ||
+        stride != shm::slotStride(slotSize) ||
+        shm::kHeaderSize + slotCount * stride > size) {
+        std::cerr << "Invalid shared memory bus segment" << std::endl;
+        ::munmap(base, size);
+        return false;
+    }
+    if (!processAlive(header->publisher_pid.load(std::memory_order_acquire))) {
+        std::cerr << "Shared memory bus has no live publisher, reading retained messages only" << std::endl;
+    }
+
+    m_base = static_cast<const uint8_t*>(base);
+    m_size = size;
+    m_header = header;
+    m_mask = slotCount - 1;
+    m_stride = stride;
+    m_slotSize = slotSize;
+    m_generation = generation;
+    m_buffer.assign(slotSize / 8 + 1, 0);
+    m_stats = ShmBusStats();
+
+    const uint64_t writeSequence = header->write_sequence.load(std::memory_order_acquire);
+    if (start == ShmBusStart::LATEST) {
+        m_cursor = writeSequence;
+    } else {
+        m_cursor = writeSequence > slotCount ? writeSequence - slotCount : 0;
+    }
+    return true;
+}
+
+bool ShmBusSubscriber::restart() {
+    const uint64_t generation = m_header->generation.load(std::memory_order_acquire);
+    if ((generation & 1) != 0) {
+        return false;
+    }
+    m_generation = generation;
+    m_cursor = 0;
+    ++m_stats.restarts;
+    return true;
+}
+
+bool ShmBusSubscriber::publisherAlive() const {
+    return m_header && processAlive(m_header->publisher_pid.load(std::memory_order_acquire));
+}
+
+void ShmBusSubscriber::close() {
+    if (m_base) {
+        ::munmap(const_cast<uint8_t*>(m_base), m_size);
+    }
+    m_base = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_mask = 0;
+    m_stride = 0;
+    m_slotSize = 0;
+    m_generation = 0;
+    m_cursor = 0;
+    m_buffer.clear();
+}
+
+} // namespace network
+} // namespace hft
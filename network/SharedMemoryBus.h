@@ -0,0 +1,238 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace hft {
+namespace network {
+
+// 共享内存总线配置
+struct ShmBusConfig {
+    size_t slot_count = 4096;     // 环形槽位数（向上取2的幂）
+    size_t slot_size = 256;       // 单条消息最大字节数（向上取8的倍数）
+};
+
+// 订阅者加入时的起始位置
+enum class ShmBusStart {
+    LATEST,       // 只接收加入之后发布的消息
+    OLDEST        // 从环中仍保留的最早一条开始
+};
+
+// 订阅者统计
+struct ShmBusStats {
+    uint64_t received = 0;
+    uint64_t overruns = 0;        // 被发布方套圈的次数
+    uint64_t lost = 0;            // 因套圈丢失的消息数
+    uint64_t restarts = 0;        // 发布方重新初始化段、从头接收的次数
+};
+
+namespace shm {
+
+constexpr uint64_t kMagic = 0x4846544255534D31ULL;    // "HFTBUSM1"
+constexpr uint32_t kVersion = 2;
+
+// 段头，位于共享内存起始处
+struct Header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;           // 载荷字节数
+    uint32_t slot_stride;         // 槽位间距（缓存行对齐）
+    // 奇数表示发布方正在（重新）初始化；变化说明序号从0重新开始
+    std::atomic<uint64_t> generation;
+    alignas(64) std::atomic<uint64_t> write_sequence;     // 下一条待发布消息序号
+    alignas(64) std::atomic<uint64_t> publisher_pid;      // 0表示发布方已关闭
+};
+
+// 槽位：seq为奇数表示写入中，2*(n+1)表示已写入序号n；载荷按64位原子字存放
+struct Slot {
+    std::atomic<uint64_t> seq;
+    std::atomic<uint64_t> size;
+    std::atomic<uint64_t> words[1];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory bus requires lock-free 64-bit atomics");
+
+constexpr size_t kHeaderSize = (sizeof(Header) + 63) & ~size_t{63};
+
+inline size_t slotStride(size_t slotSize) {
+    return (2 * sizeof(uint64_t) + slotSize + 63) & ~size_t{63};
+}
+
+} // namespace shm
+
+// 单生产者、多消费者的共享内存广播环
+//
+//  - 发布方从不等待订阅方：每条消息写入序号取模定位的槽位，按SeqLock方式发布
+//  - 每个订阅方只读映射同一段内存，自己维护读游标；被套圈时跳到仍有效的
+//    最早消息继续，并记录丢失数量
+//  - 段可以是具名POSIX共享内存（shm_open），也可以是匿名memfd（fork继承
+//    或通过SCM_RIGHTS传递文件描述符）
+//
+// 一个行情处理进程解码后发布，同机的多个策略进程各自订阅，不再重复解码。
+class ShmBusPublisher {
+public:
+    ShmBusPublisher() = default;
+    ~ShmBusPublisher();
+
+    ShmBusPublisher(const ShmBusPublisher&) = delete;
+    ShmBusPublisher& operator=(const ShmBusPublisher&) = delete;
+
+    // 创建总线：name为空时使用匿名memfd，否则创建具名共享内存（如"/hft_md"）。
+    // 同名段已有存活的发布方时失败；发布方已退出时接管：几何参数相同则递增generation
+    // 原地重置（已连接的订阅方从头接收），不同则删除旧段另建
+    bool create(const std::string& name, const ShmBusConfig& config = ShmBusConfig());
+    void close();
+
+    // 发布一条消息，超过slot_size返回false
+    bool publish(const void* data, size_t size);
+
+    bool isOpen() const { return m_header != nullptr; }
+    // 段的文件描述符，供子进程继承或传递给其他进程
+    int fd() const { return m_fd; }
+    const std::string& name() const { return m_name; }
+    size_t slotSize() const { return m_header ? m_header->slot_size : 0; }
+    uint64_t published() const { return m_next; }
+
+private:
+    bool mapSegment(size_t size);
+    // 初始化新建的段；接管已退出发布方的段时递增generation原地重置
+    void initialize(size_t slotCount, size_t slotSize);
+    void reinitialize();
+
+    shm::Slot* slotAt(uint64_t sequence) {
+        return reinterpret_cast<shm::Slot*>(m_base + shm::kHeaderSize + (sequence & m_mask) * m_header->slot_stride);
+    }
+
+    int m_fd = -1;
+    std::string m_name;
+    uint8_t* m_base = nullptr;
+    size_t m_size = 0;
+    shm::Header* m_header = nullptr;
+    uint64_t m_mask = 0;
+    uint64_t m_next = 0;
+};
+
+class ShmBusSubscriber {
+public:
+    ShmBusSubscriber() = default;
+    ~ShmBusSubscriber();
+
+    ShmBusSubscriber(const ShmBusSubscriber&) = delete;
+    ShmBusSubscriber& operator=(const ShmBusSubscriber&) = delete;
+
+    // 按名称打开总线
+    bool open(const std::string& name, ShmBusStart start = ShmBusStart::LATEST);
+    // 通过已有的文件描述符打开（描述符被复制，调用方仍持有原描述符）
+    bool attach(int fd, ShmBusStart start = ShmBusStart::LATEST);
+    void close();
+
+    // 读取最多maxMessages条消息，每条调用handler(const uint8_t* data, size_t size)，
+    // data仅在回调内有效。返回读取条数
+    template<typename Handler>
+    size_t poll(Handler&& handler, size_t maxMessages = 64);
+
+    bool isOpen() const { return m_header != nullptr; }
+    // 发布方已发布但本订阅方尚未读取的消息数
+    uint64_t backlog() const {
+        return m_header ? m_header->write_sequence.load(std::memory_order_acquire) - m_cursor : 0;
+    }
+    uint64_t cursor() const { return m_cursor; }
+    const ShmBusStats& stats() const { return m_stats; }
+    // 发布进程是否仍然存在（发布方关闭或进程退出后为false）
+    bool publisherAlive() const;
+
+private:
+    bool map(int fd, ShmBusStart start);
+    // 段被重新初始化后从序号0继续，初始化未完成时返回false
+    bool restart();
+    // 几何参数在映射时校验并缓存，不再信任共享内存中可被改写的段头
+    const shm::Slot* slotAt(uint64_t sequence) const {
+        return reinterpret_cast<const shm::Slot*>(m_base + shm::kHeaderSize + (sequence & m_mask) * m_stride);
+    }
+    // 被套圈：游标跳到oldest继续
+    void resync(uint64_t oldest) {
+        if (m_cursor < oldest) {
+            m_stats.lost += oldest - m_cursor;
+            m_cursor = oldest;
+        }
+        ++m_stats.overruns;
+    }
+    // 当前槽位已被序号不小于writeSequence的消息覆盖
+    void skipOverwritten(uint64_t writeSequence) {
+        const uint64_t slots = m_mask + 1;
+        resync(std::max(m_cursor + 1, writeSequence + 1 > slots ? writeSequence + 1 - slots : 0));
+    }
+
+    const uint8_t* m_base = nullptr;
+    size_t m_size = 0;
+    const shm::Header* m_header = nullptr;
+    uint64_t m_mask = 0;
+    size_t m_stride = 0;
+    size_t m_slotSize = 0;
+    uint64_t m_generation = 0;
+    uint64_t m_cursor = 0;
+    std::vector<uint64_t> m_buffer;
+    ShmBusStats m_stats;
+};
+
+template<typename Handler>
+size_t ShmBusSubscriber::poll(Handler&& handler, size_t maxMessages) {
+    if (!m_header) {
+        return 0;
+    }
+    const uint64_t slots = m_mask + 1;
+    size_t count = 0;
+    uint64_t writeSequence = m_header->write_sequence.load(std::memory_order_acquire);
+    while (count < maxMessages) {
+        if (m_header->generation.load(std::memory_order_acquire) != m_generation) {
+            if (!restart()) {
+                break;
+            }
+            writeSequence = m_header->write_sequence.load(std::memory_order_acquire);
+        }
+        if (m_cursor >= writeSequence) {
+            break;
+        }
+        if (writeSequence - m_cursor > slots) {
+            resync(writeSequence - slots);
+        }
+        const shm::Slot* slot = slotAt(m_cursor);
+        const uint64_t expected = 2 * (m_cursor + 1);
+        const uint64_t before = slot->seq.load(std::memory_order_acquire);
+        if (before != expected) {
+            // 槽位已被后续消息覆盖或正在覆盖
+            writeSequence = m_header->write_sequence.load(std::memory_order_acquire);
+            skipOverwritten(writeSequence);
+            continue;
+        }
+        // 长度不超过槽位载荷，段内容异常时也不会越界
+        const size_t size = static_cast<size_t>(std::min<uint64_t>(slot->size.load(std::memory_order_relaxed), m_slotSize));
+        const size_t words = (size + 7) / 8;
+        for (size_t i = 0; i < words; ++i) {
+            m_buffer[i] = slot->words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->seq.load(std::memory_order_relaxed) != before) {
+            writeSequence = m_header->write_sequence.load(std::memory_order_acquire);
+            skipOverwritten(writeSequence);
+            continue;
+        }
+        // 读取期间段被重新初始化，读到的可能是新一代的消息
+        if (m_header->generation.load(std::memory_order_relaxed) != m_generation) {
+            continue;
+        }
+        ++m_cursor;
+        ++m_stats.received;
+        ++count;
+        handler(reinterpret_cast<const uint8_t*>(m_buffer.data()), size);
+    }
+    return count;
+}
+
+} // namespace network
+} // namespace hft
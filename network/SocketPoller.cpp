@@ -0,0 +1,521 @@
+#include "SocketPoller.h"
+#include <cstring>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace hft {
+namespace network {
+
+#ifdef __linux__
+
+namespace {
+
+constexpr size_t kMaxSendBatch = 64;
+constexpr size_t kControlSize = CMSG_SPACE(sizeof(struct timespec));
+
+bool parseAddress(const std::string& host, in_addr& out) {
+    if (host.empty() || host == "0.0.0.0" || host == "*") {
+        out.s_addr = htonl(INADDR_ANY);
+        return true;
+    }
+    if (host == "localhost") {
+        out.s_addr = htonl(INADDR_LOOPBACK);
+        return true;
+    }
+    return inet_pton(AF_INET, host.c_str(), &out) == 1;
+}
+
+bool setNonBlocking(int fd) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+} // namespace
+
+// 套接字及其预分配的接收资源
+struct SocketPoller::Socket {
+    int fd = -1;
+    int id = -1;
+    DatagramHandler* handler = nullptr;
+    std::atomic<bool> closing{false};
+    bool busyPoll = false;
+    bool timestamps = false;
+
+    std::unique_ptr<uint8_t[]> buffers;          // batch_size * buffer_size
+    std::unique_ptr<uint8_t[]> control;          // batch_size * kControlSize
+    std::vector<mmsghdr> messages;
+    std::vector<iovec> iovecs;
+    std::vector<sockaddr_in> sources;
+    std::vector<Datagram> datagrams;
+
+    void prepare(size_t batch, size_t bufferSize) {
+        buffers.reset(new uint8_t[batch * bufferSize]);
+        control.reset(new uint8_t[batch * kControlSize]);
+        messages.assign(batch, mmsghdr());
+        iovecs.resize(batch);
+        sources.resize(batch);
+        datagrams.resize(batch);
+        for (size_t i = 0; i < batch; ++i) {
+            iovecs[i].iov_base = buffers.get() + i * bufferSize;
+            iovecs[i].iov_len = bufferSize;
+        }
+    }
+
+    // recvmmsg会改写msg_controllen与msg_flags，每次调用前重置
+    void reset(size_t batch) {
+        for (size_t i = 0; i < batch; ++i) {
+            msghdr& hdr = messages[i].msg_hdr;
+            hdr.msg_name = &sources[i];
+            hdr.msg_namelen = sizeof(sockaddr_in);
+            hdr.msg_iov = &iovecs[i];
+            hdr.msg_iovlen = 1;
+            hdr.msg_control = timestamps ? control.get() + i * kControlSize : nullptr;
+            hdr.msg_controllen = timestamps ? kControlSize : 0;
+            hdr.msg_flags = 0;
+            messages[i].msg_len = 0;
+        }
+    }
+
+    ~Socket() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+};
+
+SocketPoller::SocketPoller(const SocketPollerConfig& config)
+    : m_config(config), m_logger("SocketPoller"), m_epollFd(-1), m_running(false),
+      m_receiveCalls(0), m_datagramsReceived(0), m_bytesReceived(0), m_truncated(0),
+      m_sendCalls(0), m_datagramsSent(0), m_sendErrors(0), m_retiredPending(false) {
+    if (m_config.batch_size == 0) {
+        m_config.batch_size = 1;
+    }
+    if (m_config.buffer_size < 64) {
+        m_config.buffer_size = 64;
+    }
+    m_sockets.resize(m_config.max_sockets);
+    m_active.reset(new std::atomic<Socket*>[m_config.max_sockets]);
+    m_inFlight.reset(new std::atomic<uint32_t>[m_config.max_sockets]);
+    for (size_t i = 0; i < m_config.max_sockets; ++i) {
+        m_active[i].store(nullptr, std::memory_order_relaxed);
+        m_inFlight[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+SocketPoller::~SocketPoller() {
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sockets.clear();
+        m_retired.clear();
+    }
+    if (m_epollFd >= 0) {
+        ::close(m_epollFd);
+    }
+}
+
+bool SocketPoller::initialize() {
+    if (m_epollFd >= 0) {
+        return true;
+    }
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0) {
+        m_logger.error("epoll_create1 failed: " + std::string(std::strerror(errno)));
+        return false;
+    }
+    return true;
+}
+
+bool SocketPoller::start() {
+    if (m_running || !initialize()) {
+        return m_running;
+    }
+    m_running = true;
+    m_thread = std::thread(&SocketPoller::pollerLoop, this);
+    return true;
+}
+
+void SocketPoller::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    reapRetired();
+}
+
+void SocketPoller::configureSocket(Socket& socket) {
+    const int fd = socket.fd;
+    if (m_config.receive_buffer_bytes > 0) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &m_config.receive_buffer_bytes, sizeof(int));
+    }
+#ifdef SO_BUSY_POLL
+    if (m_config.busy_poll_us > 0) {
+        // 超过net.core.busy_read时需要CAP_NET_ADMIN，失败时退化为普通中断收包
+        socket.busyPoll = setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &m_config.busy_poll_us, sizeof(int)) == 0;
+    }
+#endif
+    if (m_config.kernel_timestamps) {
+        const int on = 1;
+        socket.timestamps = setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) == 0;
+    }
+}
+
+int SocketPoller::registerSocket(int fd, DatagramHandler* handler) {
+    if (!setNonBlocking(fd) || !initialize()) {
+        ::close(fd);
+        return -1;
+    }
+
+    auto socket = std::make_unique<Socket>();
+    socket->fd = fd;
+    socket->handler = handler;
+    configureSocket(*socket);
+    socket->prepare(m_config.batch_size, m_config.buffer_size);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int id = -1;
+    for (size_t i = 0; i < m_sockets.size(); ++i) {
+        if (!m_sockets[i]) {
+            id = static_cast<int>(i);
+            break;
+        }
+    }
+    if (id < 0) {
+        m_logger.error("Socket poller is full (" + std::to_string(m_sockets.size()) + " sockets)");
+        return -1;
+    }
+    socket->id = id;
+    Socket* raw = socket.get();
+    m_sockets[id] = std::move(socket);
+    // 先发布再加入epoll，轮询线程收到事件时一定能看到该套接字
+    m_active[id].store(raw, std::memory_order_release);
+
+    if (handler) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = static_cast<uint32_t>(id);
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            m_logger.error("epoll_ctl failed: " + std::string(std::strerror(errno)));
+            m_active[id].store(nullptr, std::memory_order_release);
+            m_sockets[id].reset();
+            return -1;
+        }
+    }
+    return id;
+}
+
+int SocketPoller::addReceiver(const std::string& address, uint16_t port, DatagramHandler* handler,
+                              const std::string& interfaceAddress) {
+    in_addr group{};
+    in_addr iface{};
+    if (!parseAddress(address, group) || !parseAddress(interfaceAddress, iface)) {
+        m_logger.error("Invalid receiver address: " + address);
+        return -1;
+    }
+
+    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        m_logger.error("socket failed: " + std::string(std::strerror(errno)));
+        return -1;
+    }
+    const int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    const bool multicast = IN_MULTICAST(ntohl(group.s_addr));
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(port);
+    // 组播套接字绑定到组地址，避免收到同端口其他组的报文
+    local.sin_addr = multicast || group.s_addr != htonl(INADDR_ANY) ? group : iface;
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+        m_logger.error("bind " + address + ":" + std::to_string(port) + " failed: " + std::strerror(errno));
+        ::close(fd);
+        return -1;
+    }
+
+    if (multicast) {
+        ip_mreq request{};
+        request.imr_multiaddr = group;
+        request.imr_interface = iface;
+        if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &request, sizeof(request)) != 0) {
+            m_logger.error("Join multicast group " + address + " failed: " + std::strerror(errno));
+            ::close(fd);
+            return -1;
+        }
+    }
+
+    return registerSocket(fd, handler);
+}
+
+int SocketPoller::addSender(const std::string& host, uint16_t port, DatagramHandler* handler) {
+    in_addr remote{};
+    if (!parseAddress(host, remote)) {
+        m_logger.error("Invalid sender address: " + host);
+        return -1;
+    }
+
+    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        m_logger.error("socket failed: " + std::string(std::strerror(errno)));
+        return -1;
+    }
+    if (IN_MULTICAST(ntohl(remote.s_addr))) {
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &m_config.multicast_ttl, sizeof(int));
+    }
+
+    sockaddr_in peer{};
+    peer.sin_family = AF_INET;
+    peer.sin_port = htons(port);
+    peer.sin_addr = remote;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&peer), sizeof(peer)) != 0) {
+        m_logger.error("connect " + host + ":" + std::to_string(port) + " failed: " + std::strerror(errno));
+        ::close(fd);
+        return -1;
+    }
+
+    return registerSocket(fd, handler);
+}
+
+void SocketPoller::remove(int socketId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (socketId < 0 || static_cast<size_t>(socketId) >= m_sockets.size() || !m_sockets[socketId]) {
+        return;
+    }
+    Socket& socket = *m_sockets[socketId];
+    if (socket.closing.exchange(true)) {
+        return;
+    }
+    if (socket.handler) {
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, socket.fd, nullptr);
+    }
+    m_active[socketId].store(nullptr, std::memory_order_seq_cst);
+    // 轮询线程可能正在处理或其他线程正在发送该套接字，推迟到本轮轮询结束后释放
+    m_retired.push_back(socketId);
+    m_retiredPending.store(true, std::memory_order_release);
+}
+
+void SocketPoller::reapRetired() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int id : m_retired) {
+        // remove()已将槽位置空，之后进入的发送都会放弃；只需等已持有指针的发送退出
+        while (m_inFlight[id].load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+        m_sockets[id].reset();
+    }
+    m_retired.clear();
+    m_retiredPending.store(false, std::memory_order_relaxed);
+}
+
+size_t SocketPoller::send(int socketId, const void* data, size_t size) {
+    SendBuffer buffer{data, size};
+    return sendBatch(socketId, &buffer, 1);
+}
+
+size_t SocketPoller::sendBatch(int socketId, const SendBuffer* buffers, size_t count) {
+    if (socketId < 0 || static_cast<size_t>(socketId) >= m_sockets.size()) {
+        return 0;
+    }
+    // 先登记再读取槽位：reapRetired看到计数为0时，后续发送必然读到remove()置空后的槽位
+    std::atomic<uint32_t>& inFlight = m_inFlight[socketId];
+    inFlight.fetch_add(1, std::memory_order_seq_cst);
+    Socket* socket = m_active[socketId].load(std::memory_order_seq_cst);
+    if (!socket) {
+        inFlight.fetch_sub(1, std::memory_order_release);
+        return 0;
+    }
+
+    // 发送描述符放在栈上，多个线程可同时向不同套接字发送
+    mmsghdr messages[kMaxSendBatch];
+    iovec iovecs[kMaxSendBatch];
+    size_t sent = 0;
+    while (sent < count) {
+        const size_t chunk = count - sent < kMaxSendBatch ? count - sent : kMaxSendBatch;
+        for (size_t i = 0; i < chunk; ++i) {
+            iovecs[i].iov_base = const_cast<void*>(buffers[sent + i].data);
+            iovecs[i].iov_len = buffers[sent + i].size;
+            std::memset(&messages[i], 0, sizeof(mmsghdr));
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        const int n = sendmmsg(socket->fd, messages, static_cast<unsigned int>(chunk), MSG_DONTWAIT);
+        m_sendCalls.fetch_add(1, std::memory_order_relaxed);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            m_sendErrors.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    inFlight.fetch_sub(1, std::memory_order_release);
+    m_datagramsSent.fetch_add(sent, std::memory_order_relaxed);
+    return sent;
+}
+
+size_t SocketPoller::drain(Socket& socket) {
+    const size_t batch = m_config.batch_size;
+    size_t total = 0;
+    while (!socket.closing.load(std::memory_order_relaxed)) {
+        socket.reset(batch);
+        const int n = recvmmsg(socket.fd, socket.messages.data(), static_cast<unsigned int>(batch),
+                               MSG_DONTWAIT, nullptr);
+        m_receiveCalls.fetch_add(1, std::memory_order_relaxed);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        uint64_t bytes = 0;
+        uint64_t truncated = 0;
+        for (int i = 0; i < n; ++i) {
+            const msghdr& hdr = socket.messages[i].msg_hdr;
+            Datagram& datagram = socket.datagrams[i];
+            datagram.data = static_cast<const uint8_t*>(socket.iovecs[i].iov_base);
+            datagram.size = socket.messages[i].msg_len;
+            datagram.source_address = socket.sources[i].sin_addr.s_addr;
+            datagram.source_port = ntohs(socket.sources[i].sin_port);
+            datagram.truncated = (hdr.msg_flags & MSG_TRUNC) != 0;
+            datagram.kernel_timestamp = 0;
+            if (socket.timestamps) {
+                for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&hdr), cmsg)) {
+                    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                        timespec ts;
+                        std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                        datagram.kernel_timestamp = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+                                                    static_cast<uint64_t>(ts.tv_nsec);
+                    }
+                }
+            }
+            bytes += datagram.size;
+            truncated += datagram.truncated ? 1 : 0;
+        }
+        m_datagramsReceived.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+        m_bytesReceived.fetch_add(bytes, std::memory_order_relaxed);
+        if (truncated) {
+            m_truncated.fetch_add(truncated, std::memory_order_relaxed);
+        }
+
+        socket.handler->onDatagrams(socket.id, socket.datagrams.data(), static_cast<size_t>(n));
+        total += static_cast<size_t>(n);
+
+        // 不满一批说明队列已空，省掉一次必然返回EAGAIN的调用
+        if (static_cast<size_t>(n) < batch) {
+            break;
+        }
+    }
+    return total;
+}
+
+size_t SocketPoller::pollOnce(int timeoutMs) {
+    if (m_epollFd < 0) {
+        return 0;
+    }
+    epoll_event events[64];
+    const int ready = epoll_wait(m_epollFd, events, 64, timeoutMs);
+    size_t received = 0;
+    for (int i = 0; i < ready; ++i) {
+        const uint32_t id = events[i].data.u32;
+        Socket* socket = id < m_sockets.size() ? m_active[id].load(std::memory_order_acquire) : nullptr;
+        if (socket && socket->handler) {
+            received += drain(*socket);
+        }
+    }
+    if (m_retiredPending.load(std::memory_order_acquire)) {
+        reapRetired();
+    }
+    return received;
+}
+
+void SocketPoller::pollerLoop() {
+    while (m_running.load(std::memory_order_relaxed)) {
+        pollOnce(m_config.epoll_timeout_ms);
+    }
+}
+
+bool SocketPoller::busyPollEnabled(int socketId) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return socketId >= 0 && static_cast<size_t>(socketId) < m_sockets.size() &&
+           m_sockets[socketId] && m_sockets[socketId]->busyPoll;
+}
+
+bool SocketPoller::timestampsEnabled(int socketId) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return socketId >= 0 && static_cast<size_t>(socketId) < m_sockets.size() &&
+           m_sockets[socketId] && m_sockets[socketId]->timestamps;
+}
+
+uint16_t SocketPoller::localPort(int socketId) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (socketId < 0 || static_cast<size_t>(socketId) >= m_sockets.size() || !m_sockets[socketId]) {
+        return 0;
+    }
+    sockaddr_in local{};
+    socklen_t length = sizeof(local);
+    if (getsockname(m_sockets[socketId]->fd, reinterpret_cast<sockaddr*>(&local), &length) != 0) {
+        return 0;
+    }
+    return ntohs(local.sin_port);
+}
+
+#else // !__linux__
+
+// 非Linux平台没有recvmmsg/epoll，轮询器不可用
+struct SocketPoller::Socket {};
+
+SocketPoller::SocketPoller(const SocketPollerConfig& config)
+    : m_config(config), m_logger("SocketPoller"), m_epollFd(-1), m_running(false),
+      m_receiveCalls(0), m_datagramsReceived(0), m_bytesReceived(0), m_truncated(0),
+      m_sendCalls(0), m_datagramsSent(0), m_sendErrors(0), m_retiredPending(false) {}
+SocketPoller::~SocketPoller() = default;
+bool SocketPoller::initialize() {
+    m_logger.error("SocketPoller requires Linux (epoll/recvmmsg)");
+    return false;
+}
+bool SocketPoller::start() { return initialize(); }
+void SocketPoller::stop() {}
+int SocketPoller::addReceiver(const std::string&, uint16_t, DatagramHandler*, const std::string&) { return -1; }
+int SocketPoller::addSender(const std::string&, uint16_t, DatagramHandler*) { return -1; }
+void SocketPoller::remove(int) {}
+size_t SocketPoller::send(int, const void*, size_t) { return 0; }
+size_t SocketPoller::sendBatch(int, const SendBuffer*, size_t) { return 0; }
+size_t SocketPoller::pollOnce(int) { return 0; }
+bool SocketPoller::busyPollEnabled(int) const { return false; }
+bool SocketPoller::timestampsEnabled(int) const { return false; }
+uint16_t SocketPoller::localPort(int) const { return 0; }
+int SocketPoller::registerSocket(int, DatagramHandler*) { return -1; }
+void SocketPoller::configureSocket(Socket&) {}
+size_t SocketPoller::drain(Socket&) { return 0; }
+void SocketPoller::reapRetired() {}
+void SocketPoller::pollerLoop() {}
+
+#endif
+
+SocketPollerStats SocketPoller::getStats() const {
+    SocketPollerStats stats;
+    stats.receive_calls = m_receiveCalls.load(std::memory_order_relaxed);
+    stats.datagrams_received = m_datagramsReceived.load(std::memory_order_relaxed);
+    stats.bytes_received = m_bytesReceived.load(std::memory_order_relaxed);
+    stats.truncated = m_truncated.load(std::memory_order_relaxed);
+    stats.send_calls = m_sendCalls.load(std::memory_order_relaxed);
+    stats.datagrams_sent = m_datagramsSent.load(std::memory_order_relaxed);
+    stats.send_errors = m_sendErrors.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace network
+} // namespace hft
@@ -0,0 +1,143 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../core/Logger.h"
+
+namespace hft {
+namespace network {
+
+// 接收到的数据报（指向轮询器预分配的接收缓冲区，仅在回调内有效）
+struct Datagram {
+    const uint8_t* data;
+    size_t size;
+    uint64_t kernel_timestamp;    // 内核收包时间（SO_TIMESTAMPNS，Unix纪元纳秒），未开启时为0
+    uint32_t source_address;      // 来源IPv4地址（网络字节序）
+    uint16_t source_port;         // 来源端口（主机字节序）
+    bool truncated;               // 超过接收缓冲区长度被截断
+};
+
+// 批量数据报处理接口，每次recvmmsg返回的一批数据调用一次
+class DatagramHandler {
+public:
+    virtual ~DatagramHandler() = default;
+    virtual void onDatagrams(int socketId, const Datagram* datagrams, size_t count) = 0;
+};
+
+// 待发送缓冲区
+struct SendBuffer {
+    const void* data;
+    size_t size;
+};
+
+// 轮询器配置
+struct SocketPollerConfig {
+    size_t batch_size = 32;           // 每次recvmmsg/sendmmsg的最大报文数
+    size_t buffer_size = 2048;        // 单个接收缓冲区字节数（不小于MTU）
+    int busy_poll_us = 50;            // SO_BUSY_POLL，0表示不开启
+    bool kernel_timestamps = true;    // SO_TIMESTAMPNS
+    int receive_buffer_bytes = 4 << 20;
+    int epoll_timeout_ms = 1;         // 轮询线程每次等待的最长时间，0表示纯自旋
+    size_t max_sockets = 256;
+    int multicast_ttl = 1;
+};
+
+// 轮询统计
+struct SocketPollerStats {
+    uint64_t receive_calls = 0;       // recvmmsg调用次数（含返回EAGAIN的）
+    uint64_t datagrams_received = 0;
+    uint64_t bytes_received = 0;
+    uint64_t truncated = 0;
+    uint64_t send_calls = 0;          // sendmmsg调用次数
+    uint64_t datagrams_sent = 0;
+    uint64_t send_errors = 0;
+};
+
+// 基于epoll的UDP批量收发轮询器（Linux）
+//
+//  - 一个轮询线程服务全部套接字：epoll通知可读后以recvmmsg一次取回一批数据报，
+//    直到EAGAIN为止，批量交给处理器
+//  - 每个套接字的接收缓冲区、iovec与控制消息缓冲在创建时一次性分配并反复使用
+//  - 可选SO_BUSY_POLL（驱动层忙轮询）与SO_TIMESTAMPNS（内核收包时间戳）
+//  - 发送走sendmmsg，一次系统调用发出多个报文
+//
+// 同一时刻只能有一个线程轮询（start()启动的线程，或调用pollOnce()的线程）；
+// 添加/移除套接字可在任意线程进行，被移除的套接字在下一轮轮询结束时（或stop()时）才释放，
+// 释放前等待该套接字上正在进行的发送完成，因此发送可以与remove()并发。
+class SocketPoller {
+public:
+    explicit SocketPoller(const SocketPollerConfig& config = SocketPollerConfig());
+    ~SocketPoller();
+
+    SocketPoller(const SocketPoller&) = delete;
+    SocketPoller& operator=(const SocketPoller&) = delete;
+
+    // 创建epoll实例；不支持的平台返回false
+    bool initialize();
+    // 启动/停止轮询线程
+    bool start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // 绑定本地端口接收UDP；address为组播地址时加入该组，为空或"0.0.0.0"时接收单播
+    // interfaceAddress指定加入组播使用的本地接口。返回套接字ID，失败返回-1
+    int addReceiver(const std::string& address, uint16_t port, DatagramHandler* handler,
+                    const std::string& interfaceAddress = "");
+    // 创建连接到host:port的UDP套接字，可发送，也接收对端回包（handler可为空）
+    int addSender(const std::string& host, uint16_t port, DatagramHandler* handler = nullptr);
+    void remove(int socketId);
+
+    // 发送单个/一批报文，返回成功发送的报文数（可在任意线程调用）
+    size_t send(int socketId, const void* data, size_t size);
+    size_t sendBatch(int socketId, const SendBuffer* buffers, size_t count);
+
+    // 轮询一次：等待至多timeoutMs毫秒，处理所有就绪套接字，返回收到的数据报数
+    size_t pollOnce(int timeoutMs);
+
+    // 套接字实际生效的选项（用于确认忙轮询/时间戳是否被内核接受）
+    bool busyPollEnabled(int socketId) const;
+    bool timestampsEnabled(int socketId) const;
+    // 本地绑定端口（addReceiver传入端口0时由内核分配）
+    uint16_t localPort(int socketId) const;
+
+    SocketPollerStats getStats() const;
+
+private:
+    struct Socket;
+
+    int registerSocket(int fd, DatagramHandler* handler);
+    void configureSocket(Socket& socket);
+    size_t drain(Socket& socket);
+    void reapRetired();
+    void pollerLoop();
+
+    SocketPollerConfig m_config;
+    core::Logger m_logger;
+    int m_epollFd;
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Socket>> m_sockets;     // 所有权，以套接字ID为下标，容量固定
+    std::unique_ptr<std::atomic<Socket*>[]> m_active;   // 轮询/发送路径无锁查找，移除时先置空
+    std::unique_ptr<std::atomic<uint32_t>[]> m_inFlight; // 各槽位上正在进行的发送数，释放套接字前等待归零
+    std::vector<int> m_retired;
+
+    // 统计只由轮询线程/发送线程更新
+    std::atomic<uint64_t> m_receiveCalls;
+    std::atomic<uint64_t> m_datagramsReceived;
+    std::atomic<uint64_t> m_bytesReceived;
+    std::atomic<uint64_t> m_truncated;
+    std::atomic<uint64_t> m_sendCalls;
+    std::atomic<uint64_t> m_datagramsSent;
+    std::atomic<uint64_t> m_sendErrors;
+    std::atomic<bool> m_retiredPending;
+};
+
+} // namespace network
+} // namespace hft
@@ -1,11 +1,21 @@
 #include "DnnModel.h"
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <stdexcept>
-#include <fstream>
 
 namespace hft {
 namespace pattern {
 
+namespace {
+
+uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 DnnModel::DnnModel() : m_modelLoaded(false), m_inputFeatureCount(0), m_outputClassCount(0) {
 }
 
@@ -13,25 +23,27 @@ DnnModel::~DnnModel() {
 }
 
 bool DnnModel::loadModel(const std::string& modelPath) {
-    // 模拟加载模型
     std::cout << "Loading DNN model from: " << modelPath << std::endl;
 
-    // 检查文件是否存在
-    std::ifstream file(modelPath);
-    if (!file.good()) {
-        std::cerr << "Model file not found: " << modelPath << std::endl;
+    // 模型文件为离线导出的.hftm映像，直接mmap
+    m_modelLoaded = false;
+    if (!m_runtime.load(modelPath)) {
+        return false;
+    }
+    // 输出类别按PatternType的顺序排列
+    if (m_runtime.outputCount() > static_cast<size_t>(PatternType::CONSOLIDATION) + 1) {
+        std::cerr << "Model has too many output classes: " << m_runtime.outputCount() << std::endl;
+        m_runtime.unload();
         return false;
     }
-    file.close();
 
-    // 在实际应用中，这里会使用深度学习框架加载模型
-    // 例如TensorFlow Lite、ONNX Runtime或自定义的深度学习库
     m_modelLoaded = true;
-    m_inputFeatureCount = 64; // 示例值
-    m_outputClassCount = 9;   // 对应PatternType的数量
+    m_inputFeatureCount = static_cast<int>(m_runtime.inputCount());
+    m_outputClassCount = static_cast<int>(m_runtime.outputCount());
 
     std::cout << "Model loaded successfully. Input features: " << m_inputFeatureCount
-              << ", Output classes: " << m_outputClassCount << std::endl;
+              << ", Output classes: " << m_outputClassCount
+              << ", SIMD: " << utils::simdLevelName(m_runtime.simdLevel()) << std::endl;
     return true;
 }
 
@@ -41,11 +53,21 @@ bool DnnModel::saveModel(const std::string& modelPath) const {
         return false;
     }
 
-    // 模拟保存模型
     std::cout << "Saving DNN model to: " << modelPath << std::endl;
+    std::vector<uint8_t> image(m_runtime.image(), m_runtime.image() + m_runtime.imageSize());
+    return writeModelFile(modelPath, image);
+}
 
-    // 在实际应用中，这里会使用深度学习框架保存模型
-    return true;
+void DnnModel::predictScores(const float* features, size_t batch, float* scores) {
+    if (!m_modelLoaded) {
+        throw std::runtime_error("No model loaded");
+    }
+    m_runtime.predict(features, batch, scores);
+}
+
+MarketPattern DnnModel::toPattern(const float* scores, uint64_t timestamp) const {
+    const float* best = std::max_element(scores, scores + m_outputClassCount);
+    return MarketPattern(static_cast<PatternType>(best - scores), *best, timestamp);
 }
 
 std::vector<MarketPattern> DnnModel::predict(const std::vector<double>& inputFeatures) {
@@ -53,32 +75,42 @@ std::vector<MarketPattern> DnnModel::predict(const std::vector<double>& inputFea
         throw std::runtime_error("No model loaded");
     }
 
-    if (inputFeatures.size() != m_inputFeatureCount) {
+    if (inputFeatures.size() != static_cast<size_t>(m_inputFeatureCount)) {
         throw std::runtime_error("Input feature count mismatch");
     }
 
-    // 模拟推理过程
-    std::vector<MarketPattern> patterns;
-
-    // 在实际应用中，这里会使用深度学习框架进行推理
-    // 这里只是示例，返回随机生成的模式
-    srand(static_cast<unsigned int>(time(nullptr)));
-    int typeIdx = rand() % static_cast<int>(PatternType::CONSOLIDATION) + 1;
-    double confidence = 0.7 + (rand() % 30) / 100.0; // 0.7-1.0
-    uint64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    m_inputBuffer.assign(inputFeatures.begin(), inputFeatures.end());
+    m_outputBuffer.resize(m_outputClassCount);
+    m_runtime.predict(m_inputBuffer.data(), 1, m_outputBuffer.data());
 
-    patterns.emplace_back(static_cast<PatternType>(typeIdx), confidence, timestamp);
+    std::vector<MarketPattern> patterns;
+    patterns.push_back(toPattern(m_outputBuffer.data(), nowNs()));
     return patterns;
 }
 
 std::vector<std::vector<MarketPattern>> DnnModel::batchPredict(const std::vector<std::vector<double>>& inputFeaturesBatch) {
-    std::vector<std::vector<MarketPattern>> results;
+    if (!m_modelLoaded) {
+        throw std::runtime_error("No model loaded");
+    }
 
-    for (const auto& inputFeatures : inputFeaturesBatch) {
-        results.push_back(predict(inputFeatures));
+    // 展平成一个批次，整批一次推理
+    const size_t batch = inputFeaturesBatch.size();
+    m_inputBuffer.resize(batch * m_inputFeatureCount);
+    for (size_t i = 0; i < batch; ++i) {
+        if (inputFeaturesBatch[i].size() != static_cast<size_t>(m_inputFeatureCount)) {
+            throw std::runtime_error("Input feature count mismatch");
+        }
+        std::copy(inputFeaturesBatch[i].begin(), inputFeaturesBatch[i].end(),
+                  m_inputBuffer.begin() + i * m_inputFeatureCount);
     }
+    m_outputBuffer.resize(batch * m_outputClassCount);
+    m_runtime.predict(m_inputBuffer.data(), batch, m_outputBuffer.data());
 
+    const uint64_t timestamp = nowNs();
+    std::vector<std::vector<MarketPattern>> results(batch);
+    for (size_t i = 0; i < batch; ++i) {
+        results[i].push_back(toPattern(m_outputBuffer.data() + i * m_outputClassCount, timestamp));
+    }
     return results;
 }
 
@@ -102,7 +134,7 @@ bool DnnModel::train(const std::vector<std::vector<double>>& trainingData,
     std::cout << "Batch size: " << batchSize << std::endl;
     std::cout << "Learning rate: " << learningRate << std::endl;
 
-    // 在实际应用中，这里会使用深度学习框架进行训练
+    // 训练在离线环境完成，导出的权重用packMlpModel()打包成.hftm后由loadModel()加载
 
     std::cout << "Model training completed" << std::endl;
     return true;
@@ -3,6 +3,7 @@
 #include <vector>
 #include <memory>
 #include "MarketPattern.h"
+#include "InferenceRuntime.h"
 
 namespace hft {
 namespace pattern {
@@ -23,6 +24,8 @@ public:
     std::vector<MarketPattern> predict(const std::vector<double>& inputFeatures);
     // 批量推理
     std::vector<std::vector<MarketPattern>> batchPredict(const std::vector<std::vector<double>>& inputFeaturesBatch);
+    // 零分配推理：features为batch×输入特征数，scores为batch×输出类别数
+    void predictScores(const float* features, size_t batch, float* scores);
 
     // 训练模型
     bool train(const std::vector<std::vector<double>>& trainingData,
@@ -35,10 +38,16 @@ public:
     int getOutputClassCount() const { return m_outputClassCount; }
 
 private:
+    // 取得分最高的类别
+    MarketPattern toPattern(const float* scores, uint64_t timestamp) const;
+
     bool m_modelLoaded;
     int m_inputFeatureCount;
     int m_outputClassCount;
-    // 实际应用中，这里会包含深度学习框架的模型对象
+    InferenceModel m_runtime;
+    // 批量推理复用的输入/输出缓冲区
+    std::vector<float> m_inputBuffer;
+    std::vector<float> m_outputBuffer;
 };
 
 } // namespace pattern
@@ -0,0 +1,135 @@
+// 全连接层内核
+// 由InferenceRuntime.cpp在不同的目标指令集下各包含一次（放在各自的命名空间中），
+// 包含前定义HFT_KERNEL_LANES为该指令集一个寄存器的float个数（SSE 4、AVX2 8、AVX-512 16）。
+// 使用GCC向量扩展编写，16列的权重块拆成16/HFT_KERNEL_LANES个寄存器。
+// 本文件不包含任何头文件。
+
+constexpr size_t kLanes = HFT_KERNEL_LANES;
+constexpr size_t kSub = 16 / kLanes;
+// int8权重每次展开的输入个数：256×16个float = 16KB，留在L1中
+constexpr size_t kWidenChunk = 256;
+
+typedef float VF __attribute__((vector_size(kLanes * sizeof(float)), aligned(4), may_alias));
+
+inline VF loadVec(const float* p) {
+    return *reinterpret_cast<const VF*>(p);
+}
+
+inline void storeVec(float* p, VF v) {
+    *reinterpret_cast<VF*>(p) = v;
+}
+
+// 激活函数作用于已写回的16个输出
+inline void activate(float* p, Activation activation) {
+    switch (activation) {
+        case Activation::RELU: {
+            const VF zero = {};
+            for (size_t s = 0; s < kSub; ++s) {
+                const VF v = loadVec(p + s * kLanes);
+                storeVec(p + s * kLanes, v > zero ? v : zero);
+            }
+            break;
+        }
+        case Activation::SIGMOID:
+            for (int j = 0; j < 16; ++j) {
+                p[j] = 1.0f / (1.0f + std::exp(-p[j]));
+            }
+            break;
+        case Activation::TANH:
+            for (int j = 0; j < 16; ++j) {
+                p[j] = std::tanh(p[j]);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// R行 × 一个16列的权重块；每个权重向量只加载一次，供R行共用。
+// 累加器初值为bias（首段）或output中已有的部分和（后续段）。
+// 循环全部展开，累加器（R × kSub个寄存器）不落到栈上
+template <size_t R>
+inline void panelRows(const float* input, size_t inputStride, size_t inputs, const float* panel,
+                      const float* bias, bool accumulate, float* output, size_t outputStride) {
+    VF acc[R][kSub];
+#pragma GCC unroll 16
+    for (size_t r = 0; r < R; ++r) {
+#pragma GCC unroll 4
+        for (size_t s = 0; s < kSub; ++s) {
+            acc[r][s] = accumulate ? loadVec(output + r * outputStride + s * kLanes) : loadVec(bias + s * kLanes);
+        }
+    }
+    for (size_t k = 0; k < inputs; ++k) {
+        VF w[kSub];
+#pragma GCC unroll 4
+        for (size_t s = 0; s < kSub; ++s) {
+            w[s] = loadVec(panel + k * 16 + s * kLanes);
+        }
+#pragma GCC unroll 16
+        for (size_t r = 0; r < R; ++r) {
+            const float x = input[r * inputStride + k];
+#pragma GCC unroll 4
+            for (size_t s = 0; s < kSub; ++s) {
+                acc[r][s] += x * w[s];
+            }
+        }
+    }
+#pragma GCC unroll 16
+    for (size_t r = 0; r < R; ++r) {
+#pragma GCC unroll 4
+        for (size_t s = 0; s < kSub; ++s) {
+            storeVec(output + r * outputStride + s * kLanes, acc[r][s]);
+        }
+    }
+}
+
+// 整批rows行乘一个权重块（inputs×16），权重块在处理整批输入期间留在L1中
+inline void panelBatch(const float* input, size_t inputStride, size_t rows, size_t inputs, const float* panel,
+                       const float* bias, bool accumulate, float* output, size_t outputStride) {
+    // 每次处理的行数：累加器占约一半寄存器，其余留给权重
+    constexpr size_t kRows = kLanes == 4 ? 2 : 4;
+    size_t r = 0;
+    for (; r + kRows <= rows; r += kRows) {
+        panelRows<kRows>(input + r * inputStride, inputStride, inputs, panel, bias, accumulate,
+                         output + r * outputStride, outputStride);
+    }
+    for (; r < rows; ++r) {
+        panelRows<1>(input + r * inputStride, inputStride, inputs, panel, bias, accumulate,
+                     output + r * outputStride, outputStride);
+    }
+}
+
+void dense(const detail::DenseLayerView& layer, const float* input, size_t inputStride, size_t rows,
+           float* output, size_t outputStride) {
+    alignas(64) float widened[kWidenChunk * 16];
+
+    for (size_t p = 0; p < layer.panels; ++p) {
+        const float* bias = layer.bias + p * 16;
+        float* out = output + p * 16;
+
+        if (!layer.int8) {
+            const float* panel = static_cast<const float*>(layer.weights) + p * layer.inputs * 16;
+            panelBatch(input, inputStride, rows, layer.inputs, panel, bias, false, out, outputStride);
+        } else {
+            // int8权重按段展开成float（乘上每列的缩放），展开开销由整批输入分摊
+            const int8_t* panel = static_cast<const int8_t*>(layer.weights) + p * layer.inputs * 16;
+            const float* scale = layer.scale + p * 16;
+            for (size_t k0 = 0; k0 < layer.inputs; k0 += kWidenChunk) {
+                const size_t count = layer.inputs - k0 < kWidenChunk ? layer.inputs - k0 : kWidenChunk;
+                const int8_t* source = panel + k0 * 16;
+                for (size_t k = 0; k < count; ++k) {
+                    for (size_t j = 0; j < 16; ++j) {
+                        widened[k * 16 + j] = source[k * 16 + j] * scale[j];
+                    }
+                }
+                panelBatch(input + k0, inputStride, rows, count, widened, bias, k0 > 0, out, outputStride);
+            }
+        }
+
+        if (layer.activation != Activation::NONE) {
+            for (size_t r = 0; r < rows; ++r) {
+                activate(out + r * outputStride, layer.activation);
+            }
+        }
+    }
+}
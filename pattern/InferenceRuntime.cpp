@@ -0,0 +1,540 @@
+#include "InferenceRuntime.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace hft {
+namespace pattern {
+
+namespace {
+
+// 内核都在匿名命名空间内，向量参数的ABI差异不影响外部调用（该警告在编译单元末尾才报告，不能只包住这一段）
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+// 通用实现（基线指令集）
+#define HFT_KERNEL_LANES 4
+namespace kernel_generic {
+#include "InferenceKernels.inl"
+}
+#undef HFT_KERNEL_LANES
+
+// GCC按目标指令集各编译一份；clang只用通用实现
+#if HFT_SIMD_DISPATCH && !defined(__clang__)
+#define HFT_INFERENCE_DISPATCH 1
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#define HFT_KERNEL_LANES 8
+namespace kernel_avx2 {
+#include "InferenceKernels.inl"
+}
+#undef HFT_KERNEL_LANES
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512dq,avx2,fma")
+#define HFT_KERNEL_LANES 16
+namespace kernel_avx512 {
+#include "InferenceKernels.inl"
+}
+#undef HFT_KERNEL_LANES
+#pragma GCC pop_options
+#else
+#define HFT_INFERENCE_DISPATCH 0
+#endif
+
+constexpr char kMagic[4] = {'H', 'F', 'T', 'M'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kAlign = 64;
+constexpr size_t kPanel = 16;
+constexpr int32_t kLeaf = -1;
+constexpr int32_t kDefaultLeft = 0x40000000;
+constexpr int32_t kFeatureMask = 0x3fffffff;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t kind;
+    uint32_t inputCount;
+    uint32_t outputCount;
+    uint32_t sectionCount;      // MLP为层数，GBDT为树数
+    uint32_t transform;
+    float baseScore;
+    uint64_t sectionOffset;     // LayerRecord[] 或 PackedTree[]
+    uint64_t nodeOffset;        // GBDT的PackedNode[]
+    uint32_t nodeCount;
+    uint32_t reserved[3];
+};
+
+// GBDT节点：feature为-1表示叶子；否则低30位为特征下标，kDefaultLeft位表示NaN走左子树
+struct PackedNode {
+    int32_t feature;
+    float value;
+    uint32_t left;
+    uint32_t right;
+};
+
+struct PackedTree {
+    uint32_t firstNode;
+    uint32_t nodeCount;
+    uint32_t output;
+    uint32_t reserved;
+};
+
+struct LayerRecord {
+    uint32_t inputs;
+    uint32_t outputs;
+    uint32_t panels;
+    uint32_t activation;
+    uint32_t int8;
+    uint32_t reserved0;
+    uint64_t weightOffset;
+    uint64_t biasOffset;
+    uint64_t scaleOffset;       // 0表示无
+    uint64_t reserved1[2];
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader must be 64 bytes");
+static_assert(sizeof(LayerRecord) == 64, "LayerRecord must be 64 bytes");
+static_assert(sizeof(PackedNode) == 16, "PackedNode must be 16 bytes");
+
+// 按64字节对齐追加数据段
+class ImageWriter {
+public:
+    ImageWriter() : m_image(sizeof(FileHeader), 0) {}
+
+    uint64_t append(const void* data, size_t bytes) {
+        m_image.resize((m_image.size() + kAlign - 1) / kAlign * kAlign, 0);
+        const uint64_t offset = m_image.size();
+        m_image.resize(m_image.size() + bytes);
+        if (bytes) {
+            std::memcpy(m_image.data() + offset, data, bytes);
+        }
+        return offset;
+    }
+
+    std::vector<uint8_t> finish(FileHeader header) {
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        std::memcpy(m_image.data(), &header, sizeof(header));
+        m_image.resize((m_image.size() + kAlign - 1) / kAlign * kAlign, 0);
+        return std::move(m_image);
+    }
+
+private:
+    std::vector<uint8_t> m_image;
+};
+
+bool inRange(uint64_t offset, uint64_t bytes, size_t size) {
+    return offset % kAlign == 0 && offset <= size && bytes <= size - offset;
+}
+
+bool readHeader(const uint8_t* data, size_t size, FileHeader& header) {
+    if (!data || size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    return std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion &&
+           header.inputCount != 0 && header.outputCount != 0 && header.sectionCount != 0 &&
+           header.transform <= static_cast<uint32_t>(OutputTransform::SOFTMAX);
+}
+
+detail::DenseKernel selectDenseKernel(utils::SimdLevel level) {
+#if HFT_INFERENCE_DISPATCH
+    switch (level) {
+        case utils::SimdLevel::AVX512: return &kernel_avx512::dense;
+        case utils::SimdLevel::AVX2: return &kernel_avx2::dense;
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    return &kernel_generic::dense;
+}
+
+} // namespace
+
+std::vector<uint8_t> packMlpModel(const std::vector<DenseLayerSpec>& layers, OutputTransform transform,
+                                  bool quantizeInt8) {
+    if (layers.empty()) {
+        return {};
+    }
+    for (size_t l = 0; l < layers.size(); ++l) {
+        const DenseLayerSpec& layer = layers[l];
+        if (layer.inputs == 0 || layer.outputs == 0 ||
+            layer.weights.size() != static_cast<size_t>(layer.inputs) * layer.outputs ||
+            layer.bias.size() != layer.outputs || (l > 0 && layer.inputs != layers[l - 1].outputs)) {
+            std::cerr << "Invalid dense layer " << l << std::endl;
+            return {};
+        }
+    }
+
+    ImageWriter writer;
+    std::vector<LayerRecord> records(layers.size());
+    for (size_t l = 0; l < layers.size(); ++l) {
+        const DenseLayerSpec& layer = layers[l];
+        LayerRecord& record = records[l];
+        std::memset(&record, 0, sizeof(record));
+        record.inputs = layer.inputs;
+        record.outputs = layer.outputs;
+        record.panels = static_cast<uint32_t>((layer.outputs + kPanel - 1) / kPanel);
+        record.activation = static_cast<uint32_t>(layer.activation);
+        record.int8 = quantizeInt8 ? 1 : 0;
+
+        const size_t padded = record.panels * kPanel;
+        std::vector<float> bias(padded, 0.0f);
+        std::copy(layer.bias.begin(), layer.bias.end(), bias.begin());
+        record.biasOffset = writer.append(bias.data(), bias.size() * sizeof(float));
+
+        // 打包：panel[p][k][j] = W[p×16 + j][k]，多出的输出补零
+        auto weightAt = [&layer](size_t output, size_t input) {
+            return output < layer.outputs ? layer.weights[output * layer.inputs + input] : 0.0f;
+        };
+        if (quantizeInt8) {
+            // 按输出通道对称量化
+            std::vector<float> scale(padded, 1.0f);
+            for (size_t o = 0; o < layer.outputs; ++o) {
+                float maxAbs = 0.0f;
+                for (size_t k = 0; k < layer.inputs; ++k) {
+                    maxAbs = std::max(maxAbs, std::abs(weightAt(o, k)));
+                }
+                scale[o] = maxAbs > 0.0f ? maxAbs / 127.0f : 1.0f;
+            }
+            std::vector<int8_t> packed(padded * layer.inputs);
+            for (size_t p = 0; p < record.panels; ++p) {
+                for (size_t k = 0; k < layer.inputs; ++k) {
+                    for (size_t j = 0; j < kPanel; ++j) {
+                        const size_t o = p * kPanel + j;
+                        packed[(p * layer.inputs + k) * kPanel + j] =
+                            static_cast<int8_t>(std::lround(weightAt(o, k) / scale[o]));
+                    }
+                }
+            }
+            record.weightOffset = writer.append(packed.data(), packed.size());
+            record.scaleOffset = writer.append(scale.data(), scale.size() * sizeof(float));
+        } else {
+            std::vector<float> packed(padded * layer.inputs);
+            for (size_t p = 0; p < record.panels; ++p) {
+                for (size_t k = 0; k < layer.inputs; ++k) {
+                    for (size_t j = 0; j < kPanel; ++j) {
+                        packed[(p * layer.inputs + k) * kPanel + j] = weightAt(p * kPanel + j, k);
+                    }
+                }
+            }
+            record.weightOffset = writer.append(packed.data(), packed.size() * sizeof(float));
+        }
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.kind = static_cast<uint32_t>(ModelKind::MLP);
+    header.inputCount = layers.front().inputs;
+    header.outputCount = layers.back().outputs;
+    header.sectionCount = static_cast<uint32_t>(layers.size());
+    header.transform = static_cast<uint32_t>(transform);
+    header.sectionOffset = writer.append(records.data(), records.size() * sizeof(LayerRecord));
+    return writer.finish(header);
+}
+
+std::vector<uint8_t> packGbdtModel(uint32_t inputs, uint32_t outputs, float baseScore,
+                                   const std::vector<TreeSpec>& trees, OutputTransform transform) {
+    if (inputs == 0 || outputs == 0 || trees.empty()) {
+        return {};
+    }
+
+    std::vector<PackedTree> packedTrees;
+    std::vector<PackedNode> nodes;
+    for (size_t t = 0; t < trees.size(); ++t) {
+        const TreeSpec& tree = trees[t];
+        if (tree.nodes.empty() || tree.output >= outputs) {
+            std::cerr << "Invalid tree " << t << std::endl;
+            return {};
+        }
+        PackedTree packedTree;
+        packedTree.firstNode = static_cast<uint32_t>(nodes.size());
+        packedTree.nodeCount = static_cast<uint32_t>(tree.nodes.size());
+        packedTree.output = tree.output;
+        packedTree.reserved = 0;
+        packedTrees.push_back(packedTree);
+
+        for (size_t i = 0; i < tree.nodes.size(); ++i) {
+            const TreeNodeSpec& spec = tree.nodes[i];
+            PackedNode node;
+            node.value = spec.value;
+            node.left = node.right = 0;
+            if (spec.feature < 0) {
+                node.feature = kLeaf;
+            } else {
+                // 子节点必须在父节点之后，保证遍历终止
+                if (static_cast<uint32_t>(spec.feature) >= inputs || spec.left <= i || spec.right <= i ||
+                    spec.left >= tree.nodes.size() || spec.right >= tree.nodes.size()) {
+                    std::cerr << "Invalid node " << i << " in tree " << t << std::endl;
+                    return {};
+                }
+                node.feature = spec.feature | (spec.defaultLeft ? kDefaultLeft : 0);
+                node.left = spec.left;
+                node.right = spec.right;
+            }
+            nodes.push_back(node);
+        }
+    }
+
+    ImageWriter writer;
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.kind = static_cast<uint32_t>(ModelKind::GBDT);
+    header.inputCount = inputs;
+    header.outputCount = outputs;
+    header.sectionCount = static_cast<uint32_t>(packedTrees.size());
+    header.transform = static_cast<uint32_t>(transform);
+    header.baseScore = baseScore;
+    header.sectionOffset = writer.append(packedTrees.data(), packedTrees.size() * sizeof(PackedTree));
+    header.nodeOffset = writer.append(nodes.data(), nodes.size() * sizeof(PackedNode));
+    header.nodeCount = static_cast<uint32_t>(nodes.size());
+    return writer.finish(header);
+}
+
+bool writeModelFile(const std::string& path, const std::vector<uint8_t>& image) {
+    if (image.empty()) {
+        return false;
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to open model file for writing: " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    return file.good();
+}
+
+bool readModelKind(const uint8_t* data, size_t size, ModelKind& kind) {
+    FileHeader header;
+    if (!readHeader(data, size, header)) {
+        return false;
+    }
+    kind = static_cast<ModelKind>(header.kind);
+    return true;
+}
+
+bool unpackGbdtModel(const uint8_t* data, size_t size, GbdtModelSpec& model) {
+    FileHeader header;
+    if (!readHeader(data, size, header) || header.kind != static_cast<uint32_t>(ModelKind::GBDT) ||
+        !inRange(header.sectionOffset, uint64_t{header.sectionCount} * sizeof(PackedTree), size) ||
+        !inRange(header.nodeOffset, uint64_t{header.nodeCount} * sizeof(PackedNode), size)) {
+        return false;
+    }
+    // 映像可能未按4字节对齐（拷贝来源任意），逐条memcpy读出
+    model.inputs = header.inputCount;
+    model.outputs = header.outputCount;
+    model.baseScore = header.baseScore;
+    model.transform = static_cast<OutputTransform>(header.transform);
+    model.trees.assign(header.sectionCount, TreeSpec());
+    for (uint32_t t = 0; t < header.sectionCount; ++t) {
+        PackedTree tree;
+        std::memcpy(&tree, data + header.sectionOffset + t * sizeof(PackedTree), sizeof(tree));
+        if (tree.output >= header.outputCount || tree.nodeCount == 0 ||
+            uint64_t{tree.firstNode} + tree.nodeCount > header.nodeCount) {
+            return false;
+        }
+        TreeSpec& spec = model.trees[t];
+        spec.output = tree.output;
+        spec.nodes.resize(tree.nodeCount);
+        for (uint32_t i = 0; i < tree.nodeCount; ++i) {
+            PackedNode node;
+            std::memcpy(&node, data + header.nodeOffset + (uint64_t{tree.firstNode} + i) * sizeof(PackedNode),
+                        sizeof(node));
+            TreeNodeSpec& out = spec.nodes[i];
+            out.value = node.value;
+            if (node.feature == kLeaf) {
+                continue;
+            }
+            // 子节点必须在父节点之后
+            if (node.feature < 0 || static_cast<uint32_t>(node.feature & kFeatureMask) >= header.inputCount ||
+                node.left <= i || node.right <= i || node.left >= tree.nodeCount || node.right >= tree.nodeCount) {
+                return false;
+            }
+            out.feature = node.feature & kFeatureMask;
+            out.left = node.left;
+            out.right = node.right;
+            out.defaultLeft = (node.feature & kDefaultLeft) != 0;
+        }
+    }
+    return true;
+}
+
+InferenceModel::InferenceModel() : InferenceModel(utils::detectSimdLevel()) {
+}
+
+InferenceModel::InferenceModel(utils::SimdLevel level)
+    : m_level(level > utils::detectSimdLevel() ? utils::detectSimdLevel() : level),
+      m_kernel(selectDenseKernel(m_level)),
+      m_data(nullptr),
+      m_size(0),
+      m_kind(ModelKind::MLP),
+      m_inputCount(0),
+      m_outputCount(0),
+      m_transform(OutputTransform::NONE),
+      m_maxWidth(0),
+      m_scratchSize(0) {
+#if !HFT_INFERENCE_DISPATCH
+    m_level = utils::SimdLevel::SCALAR;
+#endif
+}
+
+bool InferenceModel::load(const std::string& path) {
+    unload();
+    if (!m_file.open(path)) {
+        std::cerr << "Failed to map model file: " << path << std::endl;
+        return false;
+    }
+    if (!bind(m_file.data(), m_file.size())) {
+        std::cerr << "Invalid model file: " << path << std::endl;
+        unload();
+        return false;
+    }
+    return true;
+}
+
+bool InferenceModel::loadImage(const std::vector<uint8_t>& image) {
+    unload();
+    m_owned.resize(image.size());
+    if (!image.empty()) {
+        std::memcpy(m_owned.data(), image.data(), image.size());
+    }
+    if (!bind(m_owned.data(), m_owned.size())) {
+        std::cerr << "Invalid model image" << std::endl;
+        unload();
+        return false;
+    }
+    return true;
+}
+
+void InferenceModel::unload() {
+    m_file.close();
+    m_owned.resize(0);
+    m_data = nullptr;
+    m_size = 0;
+    m_layers.clear();
+    m_inputCount = m_outputCount = 0;
+    m_scratchSize = 0;
+}
+
+bool InferenceModel::bind(const uint8_t* data, size_t size) {
+    FileHeader header;
+    if (!readHeader(data, size, header)) {
+        return false;
+    }
+    if (header.kind == static_cast<uint32_t>(ModelKind::GBDT)) {
+        std::cerr << "GBDT models are scored by ai::TreeEnsemble, not InferenceModel" << std::endl;
+        return false;
+    }
+    if (header.kind != static_cast<uint32_t>(ModelKind::MLP)) {
+        return false;
+    }
+
+    m_kind = ModelKind::MLP;
+    m_inputCount = header.inputCount;
+    m_outputCount = header.outputCount;
+    m_transform = static_cast<OutputTransform>(header.transform);
+
+    if (!inRange(header.sectionOffset, uint64_t{header.sectionCount} * sizeof(LayerRecord), size)) {
+        return false;
+    }
+    const auto* records = reinterpret_cast<const LayerRecord*>(data + header.sectionOffset);
+    m_layers.clear();
+    m_maxWidth = 0;
+    uint32_t expectedInputs = header.inputCount;
+    for (uint32_t l = 0; l < header.sectionCount; ++l) {
+        const LayerRecord& record = records[l];
+        const uint64_t padded = uint64_t{record.panels} * kPanel;
+        const uint64_t weightBytes = padded * record.inputs * (record.int8 ? 1 : sizeof(float));
+        if (record.inputs != expectedInputs || record.outputs == 0 ||
+            record.panels != (record.outputs + kPanel - 1) / kPanel ||
+            record.activation > static_cast<uint32_t>(Activation::TANH) ||
+            !inRange(record.weightOffset, weightBytes, size) ||
+            !inRange(record.biasOffset, padded * sizeof(float), size) ||
+            (record.int8 && !inRange(record.scaleOffset, padded * sizeof(float), size))) {
+            return false;
+        }
+        detail::DenseLayerView view;
+        view.inputs = record.inputs;
+        view.outputs = record.outputs;
+        view.panels = record.panels;
+        view.activation = static_cast<Activation>(record.activation);
+        view.int8 = record.int8 != 0;
+        view.weights = data + record.weightOffset;
+        view.bias = reinterpret_cast<const float*>(data + record.biasOffset);
+        view.scale = record.int8 ? reinterpret_cast<const float*>(data + record.scaleOffset) : nullptr;
+        m_layers.push_back(view);
+        m_maxWidth = std::max<size_t>(m_maxWidth, padded);
+        expectedInputs = record.outputs;
+    }
+    if (expectedInputs != header.outputCount) {
+        return false;
+    }
+    // 两个乒乓缓冲区，各kMaxBatch行
+    m_scratchSize = 2 * kMaxBatch * m_maxWidth;
+    m_scratch.resize(m_scratchSize);
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+void InferenceModel::predict(const float* inputs, size_t batch, float* outputs) {
+    predict(inputs, batch, outputs, m_scratch.data());
+}
+
+void InferenceModel::predict(const float* inputs, size_t batch, float* outputs, float* scratch) const {
+    if (!m_data) {
+        return;
+    }
+    for (size_t offset = 0; offset < batch; offset += kMaxBatch) {
+        const size_t rows = std::min(kMaxBatch, batch - offset);
+        const float* in = inputs + offset * m_inputCount;
+        float* out = outputs + offset * m_outputCount;
+        predictMlp(in, rows, out, scratch);
+        applyTransform(out, rows);
+    }
+}
+
+void InferenceModel::predictMlp(const float* inputs, size_t rows, float* outputs, float* scratch) const {
+    float* buffers[2] = {scratch, scratch + kMaxBatch * m_maxWidth};
+    const float* in = inputs;
+    size_t inStride = m_inputCount;
+    for (size_t l = 0; l < m_layers.size(); ++l) {
+        const detail::DenseLayerView& layer = m_layers[l];
+        float* out = buffers[l % 2];
+        const size_t outStride = layer.panels * kPanel;
+        m_kernel(layer, in, inStride, rows, out, outStride);
+        in = out;
+        inStride = outStride;
+    }
+    for (size_t r = 0; r < rows; ++r) {
+        std::memcpy(outputs + r * m_outputCount, in + r * inStride, m_outputCount * sizeof(float));
+    }
+}
+
+void InferenceModel::applyTransform(float* outputs, size_t rows) const {
+    if (m_transform == OutputTransform::SIGMOID) {
+        for (size_t i = 0; i < rows * m_outputCount; ++i) {
+            outputs[i] = 1.0f / (1.0f + std::exp(-outputs[i]));
+        }
+    } else if (m_transform == OutputTransform::SOFTMAX) {
+        for (size_t r = 0; r < rows; ++r) {
+            float* row = outputs + r * m_outputCount;
+            const float maxValue = *std::max_element(row, row + m_outputCount);
+            float sum = 0.0f;
+            for (size_t i = 0; i < m_outputCount; ++i) {
+                row[i] = std::exp(row[i] - maxValue);
+                sum += row[i];
+            }
+            for (size_t i = 0; i < m_outputCount; ++i) {
+                row[i] /= sum;
+            }
+        }
+    }
+}
+
+} // namespace pattern
+} // namespace hft
@@ -0,0 +1,170 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../utils/MappedFile.h"
+#include "../utils/SimdSupport.h"
+
+namespace hft {
+namespace pattern {
+
+// 本地CPU推理运行时：小型MLP；GBDT模型共用.hftm文件格式，由ai::TreeEnsemble编译打分
+//
+// 模型文件（.hftm）是一块连续的二进制映像，load()直接mmap，不解析、不拷贝：
+//   - 文件头64字节，各数据段按64字节对齐
+//   - MLP全连接层的权重在写出时已按16个输出一组打包成列块（panel[k][16]），
+//     推理内核每次广播一个输入、与16个权重做乘加；可选int8权重（按输出通道缩放），
+//     推理时每个列块按段展开成float，展开开销由整批输入分摊
+//   - 激活函数在写回前融合到累加结果上
+//   - 批量推理时外层按列块、内层按4行一组遍历，同一块权重在L1中被整批输入复用
+//   - GBDT段保存展平的节点数组（子节点下标总大于父节点），只作为交换格式：
+//     unpackGbdtModel()读出后交给ai::TreeEnsemble::compile()，InferenceModel不加载GBDT模型
+// 内核按CPU特性选择AVX-512/AVX2/通用实现。
+
+enum class ModelKind : uint32_t {
+    MLP = 1,
+    GBDT = 2
+};
+
+enum class Activation : uint32_t {
+    NONE = 0,
+    RELU = 1,
+    SIGMOID = 2,
+    TANH = 3
+};
+
+// 输出层变换
+enum class OutputTransform : uint32_t {
+    NONE = 0,
+    SIGMOID = 1,
+    SOFTMAX = 2
+};
+
+// ---------------- 模型构建（离线转换、测试） ----------------
+
+// 全连接层，weights按[输出][输入]行优先
+struct DenseLayerSpec {
+    uint32_t inputs = 0;
+    uint32_t outputs = 0;
+    Activation activation = Activation::NONE;
+    std::vector<float> weights;
+    std::vector<float> bias;
+};
+
+// 树节点：feature < 0为叶子，value为叶子值；否则 x[feature] < value 走left，否则走right，
+// 特征为NaN时按defaultLeft选择
+struct TreeNodeSpec {
+    int32_t feature = -1;
+    float value = 0.0f;
+    uint32_t left = 0;
+    uint32_t right = 0;
+    bool defaultLeft = true;
+};
+
+// 一棵树，nodes[0]为根，叶子值累加到第output个输出
+struct TreeSpec {
+    uint32_t output = 0;
+    std::vector<TreeNodeSpec> nodes;
+};
+
+// GBDT模型：树节点的比较为 x < value
+struct GbdtModelSpec {
+    uint32_t inputs = 0;
+    uint32_t outputs = 0;
+    float baseScore = 0.0f;
+    OutputTransform transform = OutputTransform::NONE;
+    std::vector<TreeSpec> trees;
+};
+
+// 生成模型映像，参数无效时返回空
+std::vector<uint8_t> packMlpModel(const std::vector<DenseLayerSpec>& layers, OutputTransform transform,
+                                  bool quantizeInt8);
+std::vector<uint8_t> packGbdtModel(uint32_t inputs, uint32_t outputs, float baseScore,
+                                   const std::vector<TreeSpec>& trees, OutputTransform transform);
+bool writeModelFile(const std::string& path, const std::vector<uint8_t>& image);
+
+// 读取模型映像的类型，文件头无效时返回false
+bool readModelKind(const uint8_t* data, size_t size, ModelKind& kind);
+// 读出GBDT模型映像，结构校验失败时返回false
+bool unpackGbdtModel(const uint8_t* data, size_t size, GbdtModelSpec& model);
+
+namespace detail {
+
+// 已打包的全连接层视图（指向模型映像）
+struct DenseLayerView {
+    uint32_t inputs;
+    uint32_t outputs;
+    uint32_t panels;            // 输出按16个一组的块数
+    Activation activation;
+    bool int8;
+    const void* weights;        // panels × inputs × 16
+    const float* bias;          // panels × 16
+    const float* scale;         // int8时每个输出的缩放，panels × 16
+};
+
+// 计算rows行：output[r][0..panels×16) = act(input[r] · W + b)
+using DenseKernel = void (*)(const DenseLayerView& layer, const float* input, size_t inputStride, size_t rows,
+                             float* output, size_t outputStride);
+
+} // namespace detail
+
+// MLP推理模型
+class InferenceModel {
+public:
+    // 单次内核调用处理的最大行数，更大的批自动分块
+    static constexpr size_t kMaxBatch = 64;
+
+    InferenceModel();
+    explicit InferenceModel(utils::SimdLevel level);
+
+    InferenceModel(const InferenceModel&) = delete;
+    InferenceModel& operator=(const InferenceModel&) = delete;
+
+    // mmap加载模型文件（GBDT模型返回false，改用ai::TreeEnsemble）
+    bool load(const std::string& path);
+    // 从内存映像加载（拷贝一份）
+    bool loadImage(const std::vector<uint8_t>& image);
+    void unload();
+
+    bool isLoaded() const { return m_data != nullptr; }
+    ModelKind kind() const { return m_kind; }
+    size_t inputCount() const { return m_inputCount; }
+    size_t outputCount() const { return m_outputCount; }
+    utils::SimdLevel simdLevel() const { return m_level; }
+
+    // 零分配推理：inputs为batch×inputCount()行优先，outputs为batch×outputCount()。
+    // 使用模型内部的工作区，同一模型不能并发调用。
+    void predict(const float* inputs, size_t batch, float* outputs);
+    // 同上，工作区由调用方提供（至少scratchSize()个float），多个线程可共用一个模型
+    void predict(const float* inputs, size_t batch, float* outputs, float* scratch) const;
+    size_t scratchSize() const { return m_scratchSize; }
+
+    // 模型映像（用于保存）
+    const uint8_t* image() const { return m_data; }
+    size_t imageSize() const { return m_size; }
+
+private:
+    bool bind(const uint8_t* data, size_t size);
+    void predictMlp(const float* inputs, size_t rows, float* outputs, float* scratch) const;
+    void applyTransform(float* outputs, size_t rows) const;
+
+    utils::SimdLevel m_level;
+    detail::DenseKernel m_kernel;
+    utils::MappedFile m_file;
+    utils::AlignedArray<uint8_t> m_owned;
+    const uint8_t* m_data;
+    size_t m_size;
+
+    ModelKind m_kind;
+    size_t m_inputCount;
+    size_t m_outputCount;
+    OutputTransform m_transform;
+    std::vector<detail::DenseLayerView> m_layers;
+    size_t m_maxWidth;                      // 各层打包后输出宽度的最大值
+    size_t m_scratchSize;
+    utils::AlignedArray<float> m_scratch;
+};
+
+} // namespace pattern
+} // namespace hft
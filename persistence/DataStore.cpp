@@ -1,12 +1,53 @@
 #include "DataStore.h"
 #include <iostream>
 #include <sstream>
+#include <cmath>
 #include <sqlite3.h>
 #include "core/Logger.h"
 
 namespace hft {
 namespace persistence {
 
+namespace {
+
+constexpr double kFixedPointScale = 10000.0;   // 与types::Price/Volume一致
+
+inline int64_t toFixed(double value) {
+    return static_cast<int64_t>(std::llround(value * kFixedPointScale));
+}
+
+inline double fromFixed(int64_t value) {
+    return static_cast<double>(value) / kFixedPointScale;
+}
+
+Tick toTick(const market::MarketData& data) {
+    Tick tick;
+    tick.timestamp = data.timestamp;
+    tick.last_price = toFixed(data.last_price);
+    tick.volume = toFixed(data.volume);
+    tick.bid_price = toFixed(data.bid_price);
+    tick.ask_price = toFixed(data.ask_price);
+    tick.bid_volume = toFixed(data.bid_volume);
+    tick.ask_volume = toFixed(data.ask_volume);
+    return tick;
+}
+
+market::MarketData fromTick(const std::string& symbol, const Tick& tick) {
+    market::MarketData data;
+    data.symbol = symbol;
+    data.timestamp = tick.timestamp;
+    data.last_price = fromFixed(tick.last_price);
+    data.close_price = data.last_price;
+    data.volume = fromFixed(tick.volume);
+    data.bid_price = fromFixed(tick.bid_price);
+    data.ask_price = fromFixed(tick.ask_price);
+    data.bid_volume = fromFixed(tick.bid_volume);
+    data.ask_volume = fromFixed(tick.ask_volume);
+    return data;
+}
+
+} // namespace
+
 // SQLite数据库连接句柄
 struct SQLiteConnection {
     sqlite3* db;
@@ -23,6 +64,11 @@ DataStore::DataStore(const core::Configuration& config)
     : m_config(config),
       m_initialized(false) {
     m_connection_string = m_config.get<std::string>("persistence.connection_string", "hft_system.db");
+    m_tick_store_path = m_config.getString("persistence.tick_store_path", "tick_data");
+    const int rowsPerBlock =
+        m_config.getInt("persistence.tick_rows_per_block", static_cast<int>(TickStore::kDefaultRowsPerBlock));
+    // 非正数在initialize()中拒绝，不能转换成size_t后当作巨大的块
+    m_tick_rows_per_block = rowsPerBlock > 0 ? static_cast<size_t>(rowsPerBlock) : 0;
 }
 
 DataStore::~DataStore() {
@@ -35,6 +81,11 @@ bool DataStore::initialize() {
     if (m_initialized) {
         return true;
     }
+
+    if (m_tick_rows_per_block == 0) {
+        std::cerr << "persistence.tick_rows_per_block must be positive" << std::endl;
+        return false;
+    }
     
     if (!connect()) {
         return false;
@@ -43,7 +94,9 @@ bool DataStore::initialize() {
     if (!createTables()) {
         return false;
     }
-    
+
+    m_tick_store = std::make_unique<TickStore>(m_tick_store_path, m_tick_rows_per_block);
+
     m_initialized = true;
     return true;
 }
@@ -68,9 +121,7 @@ bool DataStore::saveMarketData(const market::MarketData& data) {
         return false;
     }
 
-    // 在实际实现中，这里会将市场数据插入到数据库
-    std::cout << "Saving market data for: " << data.symbol << " at " << data.timestamp << std::endl;
-    return true;
+    return m_tick_store->append(data.symbol, toTick(data));
 }
 
 bool DataStore::saveMarketDataBatch(const std::vector<market::MarketData>& data) {
@@ -80,9 +131,11 @@ bool DataStore::saveMarketDataBatch(const std::vector<market::MarketData>& data)
         return false;
     }
 
-    // 在实际实现中，这里会批量插入市场数据
-    std::cout << "Saving batch of " << data.size() << " market data entries" << std::endl;
-    return true;
+    bool ok = true;
+    for (const auto& entry : data) {
+        ok = m_tick_store->append(entry.symbol, toTick(entry)) && ok;
+    }
+    return ok;
 }
 
 std::vector<market::MarketData> DataStore::queryMarketData(const std::string& symbol,
@@ -96,11 +149,27 @@ std::vector<market::MarketData> DataStore::queryMarketData(const std::string& sy
         return result;
     }
 
-    // 在实际实现中，这里会查询数据库并返回结果
-    std::cout << "Querying market data for: " << symbol << " from " << start_time << " to " << end_time << std::endl;
+    // 查询直接读取未落盘的内存块，不需要先flush
+    auto query = m_tick_store->query(symbol, start_time, end_time);
+    Tick tick;
+    while (query->next(tick)) {
+        result.push_back(fromTick(symbol, tick));
+    }
     return result;
 }
 
+std::unique_ptr<TickQuery> DataStore::queryTicks(const std::string& symbol,
+                                                 uint64_t start_time,
+                                                 uint64_t end_time) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_initialized) {
+        std::cerr << "DataStore not initialized" << std::endl;
+        return std::make_unique<TickQuery>(start_time, end_time);
+    }
+
+    return m_tick_store->query(symbol, start_time, end_time);
+}
+
 bool DataStore::saveOrder(const execution::Order& order) {
     std::lock_guard<std::mutex> lock(m_mutex);
     if (!m_initialized) {
@@ -172,6 +241,10 @@ void DataStore::close() {
     std::lock_guard<std::mutex> lock(m_mutex);
     if (m_initialized) {
         std::cout << "Closing data store..." << std::endl;
+        if (m_tick_store) {
+            m_tick_store->close();
+            m_tick_store.reset();
+        }
         m_initialized = false;
     }
 }
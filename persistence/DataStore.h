@@ -8,6 +8,7 @@
 #include "market/MarketData.h"
 #include "execution/Order.h"
 #include "risk/RiskMetrics.h"
+#include "TickStore.h"
 
 namespace hft {
 namespace persistence {
@@ -30,6 +31,11 @@ public:
     std::vector<market::MarketData> queryMarketData(const std::string& symbol,
                                                   uint64_t start_time,
                                                   uint64_t end_time);
+
+    // 查询逐笔数据（零拷贝，直接访问映射的列文件，供回测回放使用）
+    std::unique_ptr<TickQuery> queryTicks(const std::string& symbol,
+                                          uint64_t start_time,
+                                          uint64_t end_time);
     
     // 保存订单
     bool saveOrder(const execution::Order& order);
@@ -58,6 +64,11 @@ private:
     bool m_initialized;
     std::mutex m_mutex;
 
+    // 行情数据的列式存储
+    std::string m_tick_store_path;
+    size_t m_tick_rows_per_block;
+    std::unique_ptr<TickStore> m_tick_store;
+
     // 实现具体存储逻辑的内部方法
     bool connect();
     bool createTables();
@@ -0,0 +1,546 @@
+#include "TickStore.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace hft {
+namespace persistence {
+
+namespace {
+
+constexpr uint64_t kNanosPerDay = 86400ULL * 1000000000ULL;
+constexpr size_t kMaxVarintBytes = 10;
+
+const char* const kColumnFiles[kTickColumnCount] = {
+    "timestamp.col",
+    "last_price.col",
+    "volume.col",
+    "bid_price.col",
+    "ask_price.col",
+    "bid_volume.col",
+    "ask_volume.col"
+};
+
+const char* const kIndexFile = "index.idx";
+
+inline uint64_t zigzagEncode(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+inline void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    uint8_t buf[kMaxVarintBytes];
+    size_t n = 0;
+    while (v >= 0x80) {
+        buf[n++] = static_cast<uint8_t>(v) | 0x80;
+        v >>= 7;
+    }
+    buf[n++] = static_cast<uint8_t>(v);
+    out.insert(out.end(), buf, buf + n);
+}
+
+inline const uint8_t* getVarint(const uint8_t* p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (unsigned shift = 0; p < end && shift < 64; shift += 7) {
+        const uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+inline int64_t* columnsOf(Tick& tick) {
+    return reinterpret_cast<int64_t*>(&tick);
+}
+
+inline const int64_t* columnsOf(const Tick& tick) {
+    return reinterpret_cast<const int64_t*>(&tick);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// TickBlockView
+
+TickBlockView::TickBlockView(const TickBlockIndex* index, const uint8_t* const* columns)
+    : m_index(index) {
+    for (size_t c = 0; c < kTickColumnCount; ++c) {
+        m_columns[c] = columns[c];
+    }
+}
+
+ColumnSpan TickBlockView::column(TickColumn column) const {
+    const size_t c = static_cast<size_t>(column);
+    return ColumnSpan{m_columns[c], m_index->sizes[c]};
+}
+
+size_t TickBlockView::decode(Tick* out) const {
+    const size_t rows = m_index->row_count;
+    size_t decoded = rows;
+    for (size_t c = 0; c < kTickColumnCount; ++c) {
+        const uint8_t* p = m_columns[c];
+        const uint8_t* end = p + m_index->sizes[c];
+        int64_t value = 0;
+        size_t r = 0;
+        for (; r < rows; ++r) {
+            uint64_t raw;
+            p = getVarint(p, end, raw);
+            if (!p) {
+                break;
+            }
+            value += zigzagDecode(raw);
+            columnsOf(out[r])[c] = value;
+        }
+        // 列损坏时只返回各列都完整的前缀
+        decoded = std::min(decoded, r);
+    }
+    return decoded;
+}
+
+// ---------------------------------------------------------------------------
+// TickPartitionReader
+
+bool TickPartitionReader::open(const std::string& directory) {
+    if (!m_index.open(directory + "/" + kIndexFile)) {
+        return false;
+    }
+    for (size_t c = 0; c < kTickColumnCount; ++c) {
+        if (!m_columns[c].open(directory + "/" + kColumnFiles[c])) {
+            std::cerr << "TickStore: missing column file in " << directory << std::endl;
+            return false;
+        }
+    }
+
+    m_entries = reinterpret_cast<const TickBlockIndex*>(m_index.data());
+    m_blockCount = m_index.size() / sizeof(TickBlockIndex);
+
+    // 写入中途崩溃时，丢弃列数据不完整的尾部块
+    while (m_blockCount > 0) {
+        const TickBlockIndex& last = m_entries[m_blockCount - 1];
+        bool complete = true;
+        for (size_t c = 0; c < kTickColumnCount; ++c) {
+            if (last.offsets[c] + last.sizes[c] > m_columns[c].size()) {
+                complete = false;
+                break;
+            }
+        }
+        if (complete) {
+            break;
+        }
+        --m_blockCount;
+    }
+    return true;
+}
+
+TickBlockView TickPartitionReader::block(size_t i) const {
+    const TickBlockIndex& entry = m_entries[i];
+    const uint8_t* columns[kTickColumnCount];
+    for (size_t c = 0; c < kTickColumnCount; ++c) {
+        columns[c] = m_columns[c].data() + entry.offsets[c];
+    }
+    return TickBlockView(&entry, columns);
+}
+
+size_t TickPartitionReader::lowerBound(uint64_t timestamp) const {
+    size_t lo = 0;
+    size_t hi = m_blockCount;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (m_entries[mid].last_timestamp < timestamp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// ---------------------------------------------------------------------------
+// TickPartitionWriter
+
+TickPartitionWriter::TickPartitionWriter(size_t rowsPerBlock)
+    : m_rowsPerBlock(rowsPerBlock > 0 ? rowsPerBlock : 1) {
+    for (auto& buffer : m_buffers) {
+        buffer.reserve(m_rowsPerBlock * 4);
+    }
+}
+
+TickPartitionWriter::~TickPartitionWriter() {
+    close();
+}
+
+bool TickPartitionWriter::open(const std::string& directory) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        std::cerr << "TickStore: failed to create " << directory << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    // 上次写入中途崩溃时，索引尾部可能只有半个条目，列文件可能有未登记到索引的数据。
+    // 追加前把索引截断到整条目边界、各列截断到最后一个条目登记的末尾，新块才能与索引对齐
+    const std::string indexPath = directory + "/" + kIndexFile;
+    uint64_t columnEnds[kTickColumnCount] = {};
+    m_hasTimestamp = false;
+    const uint64_t indexSize = std::filesystem::exists(indexPath, ec) ? std::filesystem::file_size(indexPath, ec) : 0;
+    const uint64_t wholeSize = indexSize - indexSize % sizeof(TickBlockIndex);
+    if (!ec && wholeSize != indexSize) {
+        std::cerr << "TickStore: dropping torn index entry in " << directory << std::endl;
+        std::filesystem::resize_file(indexPath, wholeSize, ec);
+    }
+    if (ec) {
+        std::cerr << "TickStore: failed to recover " << indexPath << ": " << ec.message() << std::endl;
+        return false;
+    }
+    if (wholeSize > 0) {
+        std::FILE* in = std::fopen(indexPath.c_str(), "rb");
+        TickBlockIndex last{};
+        const bool ok = in && std::fseek(in, static_cast<long>(wholeSize - sizeof(TickBlockIndex)), SEEK_SET) == 0 &&
+                        std::fread(&last, sizeof(last), 1, in) == 1;
+        if (in) {
+            std::fclose(in);
+        }
+        if (!ok) {
+            std::cerr << "TickStore: failed to read " << indexPath << std::endl;
+            return false;
+        }
+        for (size_t c = 0; c < kTickColumnCount; ++c) {
+            columnEnds[c] = last.offsets[c] + last.sizes[c];
+        }
+        // 重新打开已有分区时，从最后一个索引条目恢复时间下限
+        m_lastTimestamp = last.last_timestamp;
+        m_hasTimestamp = true;
+    }
+    for (size_t c = 0; c < kTickColumnCount; ++c) {
+        const std::string path = directory + "/" + kColumnFiles[c];
+        const uint64_t size = std::filesystem::exists(path, ec) ? std::filesystem::file_size(path, ec) : 0;
+        if (!ec && size < columnEnds[c]) {
+            std::cerr << "TickStore: " << path << " is shorter than its index" << std::endl;
+            return false;
+        }
+        if (!ec && size > columnEnds[c]) {
+            std::filesystem::resize_file(path, columnEnds[c], ec);
+        }
+        if (ec) {
+            std::cerr << "TickStore: failed to recover " << path << ": " << ec.message() << std::endl;
+            return false;
+        }
+    }
+
+    for (size_t c = 0; c < kTickColumnCount; ++c) {
+        const std::string path = directory + "/" + kColumnFiles[c];
+        m_files[c] = std::fopen(path.c_str(), "ab");
+        if (!m_files[c]) {
+            std::cerr << "TickStore: failed to open " << path << std::endl;
+            close();
+            return false;
+        }
+        // 追加模式下定位到文件末尾以获得已有数据长度
+        std::fseek(m_files[c], 0, SEEK_END);
+        m_fileSizes[c] = static_cast<uint64_t>(std::ftell(m_files[c]));
+        std::setvbuf(m_files[c], nullptr, _IOFBF, 1 << 16);
+    }
+
+    m_indexFile = std::fopen(indexPath.c_str(), "ab");
+    if (!m_indexFile) {
+        std::cerr << "TickStore: failed to open " << indexPath << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool TickPartitionWriter::append(const Tick& tick) {
+    if (m_hasTimestamp && tick.timestamp < m_lastTimestamp) {
+        // 块内差分编码与按块二分查找都依赖时间单调
+        return false;
+    }
+    const int64_t* values = columnsOf(tick);
+    if (m_rows == 0) {
+        m_firstTimestamp = tick.timestamp;
+        std::fill(std::begin(m_previous), std::end(m_previous), 0);
+    }
+    for (size_t c = 0; c < kTickColumnCount; ++c) {
+        putVarint(m_buffers[c], zigzagEncode(values[c] - m_previous[c]));
+        m_previous[c] = values[c];
+    }
+    m_lastTimestamp = tick.timestamp;
+    m_hasTimestamp = true;
+    ++m_rows;
+
+    if (m_rows >= m_rowsPerBlock) {
+        return writeBlock();
+    }
+    return true;
+}
+
+bool TickPartitionWriter::writeBlock() {
+    if (m_rows == 0) {
+        return true;
+    }
+    if (!m_indexFile) {
+        return false;
+    }
+
+    TickBlockIndex entry{};
+    entry.first_timestamp = m_firstTimestamp;
+    entry.last_timestamp = m_lastTimestamp;
+    entry.row_count = m_rows;
+
+    bool ok = true;
+    for (size_t c = 0; c < kTickColumnCount; ++c) {
+        const std::vector<uint8_t>& buffer = m_buffers[c];
+        entry.offsets[c] = m_fileSizes[c];
+        entry.sizes[c] = static_cast<uint32_t>(buffer.size());
+        if (std::fwrite(buffer.data(), 1, buffer.size(), m_files[c]) != buffer.size()) {
+            ok = false;
+        }
+        m_fileSizes[c] += buffer.size();
+    }
+
+    // 列数据先于索引写出：读者只通过索引访问块，看不到半写的块；
+    // 索引随块一起刷新，写满的块立即对查询可见
+    for (size_t c = 0; c < kTickColumnCount; ++c) {
+        std::fflush(m_files[c]);
+    }
+    if (std::fwrite(&entry, sizeof(entry), 1, m_indexFile) != 1) {
+        ok = false;
+    }
+    std::fflush(m_indexFile);
+
+    for (auto& buffer : m_buffers) {
+        buffer.clear();
+    }
+    m_rows = 0;
+    if (!ok) {
+        std::cerr << "TickStore: failed to write block" << std::endl;
+    }
+    return ok;
+}
+
+bool TickPartitionWriter::flush() {
+    const bool ok = writeBlock();
+    if (m_indexFile) {
+        std::fflush(m_indexFile);
+    }
+    return ok;
+}
+
+void TickPartitionWriter::readPending(uint64_t start, uint64_t end, std::vector<Tick>& out) const {
+    if (m_rows == 0 || m_firstTimestamp > end || m_lastTimestamp < start) {
+        return;
+    }
+    // 内存块与落盘块编码相同，借用块视图解码
+    TickBlockIndex entry{};
+    entry.first_timestamp = m_firstTimestamp;
+    entry.last_timestamp = m_lastTimestamp;
+    entry.row_count = m_rows;
+    const uint8_t* columns[kTickColumnCount];
+    for (size_t c = 0; c < kTickColumnCount; ++c) {
+        columns[c] = m_buffers[c].data();
+        entry.sizes[c] = static_cast<uint32_t>(m_buffers[c].size());
+    }
+    const size_t base = out.size();
+    out.resize(base + m_rows);
+    const size_t rows = TickBlockView(&entry, columns).decode(out.data() + base);
+    size_t kept = base;
+    for (size_t r = base; r < base + rows; ++r) {
+        if (out[r].timestamp >= start && out[r].timestamp <= end) {
+            out[kept++] = out[r];
+        }
+    }
+    out.resize(kept);
+}
+
+void TickPartitionWriter::close() {
+    flush();
+    for (auto& file : m_files) {
+        if (file) {
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+    if (m_indexFile) {
+        std::fclose(m_indexFile);
+        m_indexFile = nullptr;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// TickQuery
+
+TickQuery::TickQuery(uint64_t start, uint64_t end)
+    : m_start(start), m_end(end), m_pendingAt(0), m_pendingServed(false), m_rows(nullptr),
+      m_blockPos(0), m_rowPos(0), m_rowCount(0) {
+}
+
+bool TickQuery::next(Tick& tick) {
+    while (true) {
+        while (m_rowPos < m_rowCount) {
+            const Tick& candidate = m_rows[m_rowPos++];
+            if (candidate.timestamp > m_end) {
+                // 分区内时间单调，后续行都在区间之外
+                m_rowPos = m_rowCount;
+                break;
+            }
+            if (candidate.timestamp >= m_start) {
+                tick = candidate;
+                return true;
+            }
+        }
+        if (!m_pendingServed && m_blockPos == m_pendingAt) {
+            // 未落盘的行紧跟在所属分区的最后一个块之后
+            m_pendingServed = true;
+            m_rows = m_pending.data();
+            m_rowCount = m_pending.size();
+            m_rowPos = 0;
+            continue;
+        }
+        if (m_blockPos >= m_blocks.size()) {
+            return false;
+        }
+        const TickBlockView& block = m_blocks[m_blockPos++];
+        if (m_decoded.size() < block.rowCount()) {
+            m_decoded.resize(block.rowCount());
+        }
+        m_rows = m_decoded.data();
+        m_rowCount = block.decode(m_decoded.data());
+        m_rowPos = 0;
+    }
+}
+
+void TickQuery::reset() {
+    m_pendingServed = false;
+    m_blockPos = 0;
+    m_rowPos = 0;
+    m_rowCount = 0;
+}
+
+// ---------------------------------------------------------------------------
+// TickStore
+
+TickStore::TickStore(const std::string& rootDirectory, size_t rowsPerBlock)
+    : m_root(rootDirectory), m_rowsPerBlock(rowsPerBlock), m_appended(0), m_rejected(0) {
+}
+
+TickStore::~TickStore() {
+    close();
+}
+
+uint32_t TickStore::dateOf(uint64_t timestamp) {
+    // 纪元日数转公历日期（proleptic Gregorian）
+    const int64_t z = static_cast<int64_t>(timestamp / kNanosPerDay) + 719468;
+    const int64_t era = z / 146097;
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    const int64_t day = doy - (153 * mp + 2) / 5 + 1;
+    const int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+    return static_cast<uint32_t>(year * 10000 + month * 100 + day);
+}
+
+std::string TickStore::partitionPath(const std::string& symbol, uint32_t date) const {
+    return m_root + "/" + symbol + "/" + std::to_string(date);
+}
+
+bool TickStore::append(const std::string& symbol, const Tick& tick) {
+    SymbolState& state = m_symbols[symbol];
+    const uint32_t date = dateOf(tick.timestamp);
+    if (!state.writer || state.date != date) {
+        // 跨日时关闭旧分区，开始新分区
+        if (state.writer) {
+            state.writer->close();
+        }
+        state.writer = std::make_unique<TickPartitionWriter>(m_rowsPerBlock);
+        state.date = date;
+        if (!state.writer->open(partitionPath(symbol, date))) {
+            state.writer.reset();
+            return false;
+        }
+    }
+    if (!state.writer->append(tick)) {
+        ++m_rejected;
+        return false;
+    }
+    ++m_appended;
+    return true;
+}
+
+bool TickStore::flush() {
+    bool ok = true;
+    for (auto& entry : m_symbols) {
+        if (entry.second.writer && !entry.second.writer->flush()) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void TickStore::close() {
+    for (auto& entry : m_symbols) {
+        if (entry.second.writer) {
+            entry.second.writer->close();
+        }
+    }
+    m_symbols.clear();
+}
+
+std::unique_ptr<TickQuery> TickStore::query(const std::string& symbol, uint64_t start, uint64_t end) const {
+    auto result = std::make_unique<TickQuery>(start, end);
+    if (start > end) {
+        return result;
+    }
+    auto writerIt = m_symbols.find(symbol);
+    const SymbolState* open = writerIt != m_symbols.end() && writerIt->second.writer ? &writerIt->second : nullptr;
+
+    // 列出该标的下落在日期区间内的分区
+    const uint32_t firstDate = dateOf(start);
+    const uint32_t lastDate = dateOf(end);
+    std::vector<uint32_t> dates;
+    std::error_code ec;
+    for (const auto& dir : std::filesystem::directory_iterator(m_root + "/" + symbol, ec)) {
+        const std::string name = dir.path().filename().string();
+        if (name.size() != 8 || name.find_first_not_of("0123456789") != std::string::npos) {
+            continue;
+        }
+        const uint32_t date = static_cast<uint32_t>(std::stoul(name));
+        if (date >= firstDate && date <= lastDate) {
+            dates.push_back(date);
+        }
+    }
+    std::sort(dates.begin(), dates.end());
+
+    result->m_pendingAt = 0;
+    for (uint32_t date : dates) {
+        auto reader = std::make_unique<TickPartitionReader>();
+        if (!reader->open(partitionPath(symbol, date))) {
+            continue;
+        }
+        for (size_t i = reader->lowerBound(start); i < reader->blockCount(); ++i) {
+            TickBlockView block = reader->block(i);
+            if (block.firstTimestamp() > end) {
+                break;
+            }
+            result->m_blocks.push_back(block);
+        }
+        result->m_partitions.push_back(std::move(reader));
+        if (open && date <= open->date) {
+            result->m_pendingAt = result->m_blocks.size();
+        }
+    }
+    if (open && open->date >= firstDate && open->date <= lastDate) {
+        open->writer->readPending(start, end, result->m_pending);
+    }
+    return result;
+}
+
+} // namespace persistence
+} // namespace hft
@@ -0,0 +1,210 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "core/Types.h"
+#include "utils/MappedFile.h"
+
+namespace hft {
+namespace persistence {
+
+// 列式逐笔存储
+//
+// 目录布局：<root>/<symbol>/<YYYYMMDD>/
+//     <column>.col   每列一个只追加文件
+//     index.idx      稀疏时间索引，每个数据块一条
+//
+// 每列按块（默认4096行）编码：块内首值为绝对值，其余为与前值之差，
+// 差值经zigzag后以varint写出，块之间相互独立，可单独解码。
+// 读取时mmap列文件与索引，按时间二分定位块，返回指向映射内存的视图，不拷贝数据；
+// 尚未写满的内存块由查询直接解码一份拷贝，无需为了可见性而提前落盘。
+// 时间戳为Unix纪元起的纳秒数，按UTC日期分区；同一分区内时间戳必须单调不减，
+// 回退的记录被拒绝并计数。
+
+// 列定义
+enum class TickColumn : uint8_t {
+    TIMESTAMP,
+    LAST_PRICE,
+    VOLUME,
+    BID_PRICE,
+    ASK_PRICE,
+    BID_VOLUME,
+    ASK_VOLUME
+};
+
+constexpr size_t kTickColumnCount = 7;
+
+// 定点数逐笔记录（价格、数量放大10000倍，与types::Price/Volume一致）
+struct Tick {
+    uint64_t timestamp;
+    types::Price last_price;
+    types::Volume volume;
+    types::Price bid_price;
+    types::Price ask_price;
+    types::Volume bid_volume;
+    types::Volume ask_volume;
+};
+
+static_assert(sizeof(Tick) == kTickColumnCount * sizeof(int64_t), "Tick must be a flat array of 64-bit columns");
+
+// 索引条目（磁盘格式）
+struct TickBlockIndex {
+    uint64_t first_timestamp;
+    uint64_t last_timestamp;
+    uint32_t row_count;
+    uint32_t reserved;
+    uint64_t offsets[kTickColumnCount];   // 各列文件内的起始偏移
+    uint32_t sizes[kTickColumnCount];     // 各列编码后的字节数
+    uint32_t padding;
+};
+
+// 指向映射内存的只读字节区间
+struct ColumnSpan {
+    const uint8_t* data;
+    size_t size;
+};
+
+// 单个数据块的零拷贝视图
+class TickBlockView {
+public:
+    TickBlockView(const TickBlockIndex* index, const uint8_t* const* columns);
+
+    uint32_t rowCount() const { return m_index->row_count; }
+    uint64_t firstTimestamp() const { return m_index->first_timestamp; }
+    uint64_t lastTimestamp() const { return m_index->last_timestamp; }
+
+    // 某列的编码字节（指向映射内存）
+    ColumnSpan column(TickColumn column) const;
+    // 解码整块到调用方缓冲区，out至少容纳rowCount()条，返回解码行数
+    size_t decode(Tick* out) const;
+
+private:
+    const TickBlockIndex* m_index;
+    const uint8_t* m_columns[kTickColumnCount];
+};
+
+// 单日分区读取器
+class TickPartitionReader {
+public:
+    bool open(const std::string& directory);
+
+    size_t blockCount() const { return m_blockCount; }
+    TickBlockView block(size_t i) const;
+    // 第一个last_timestamp >= timestamp的块
+    size_t lowerBound(uint64_t timestamp) const;
+
+private:
+    utils::MappedFile m_index;
+    utils::MappedFile m_columns[kTickColumnCount];
+    const TickBlockIndex* m_entries = nullptr;
+    size_t m_blockCount = 0;
+};
+
+// 单日分区写入器（只追加）
+class TickPartitionWriter {
+public:
+    explicit TickPartitionWriter(size_t rowsPerBlock);
+    ~TickPartitionWriter();
+
+    TickPartitionWriter(const TickPartitionWriter&) = delete;
+    TickPartitionWriter& operator=(const TickPartitionWriter&) = delete;
+
+    bool open(const std::string& directory);
+    // 时间戳早于分区内最后一条记录时拒绝并返回false
+    bool append(const Tick& tick);
+    // 把当前未满的块写出并刷新文件
+    bool flush();
+    void close();
+
+    // 解码当前未满内存块中时间落在[start, end]内的行，追加到out
+    void readPending(uint64_t start, uint64_t end, std::vector<Tick>& out) const;
+
+private:
+    bool writeBlock();
+
+    size_t m_rowsPerBlock;
+    std::FILE* m_files[kTickColumnCount] = {};
+    std::FILE* m_indexFile = nullptr;
+    uint64_t m_fileSizes[kTickColumnCount] = {};
+    std::vector<uint8_t> m_buffers[kTickColumnCount];
+    int64_t m_previous[kTickColumnCount] = {};
+    uint32_t m_rows = 0;
+    uint64_t m_firstTimestamp = 0;
+    uint64_t m_lastTimestamp = 0;
+    bool m_hasTimestamp = false;     // 分区内（含已落盘的块）已有记录，m_lastTimestamp有效
+};
+
+// 区间查询结果
+// 持有所涉及分区的映射，blocks()给出与区间相交的已落盘块视图；
+// next()逐行解码并过滤到[start, end]，只占用一个块大小的解码缓冲，
+// 并在对应分区之后返回查询时尚未落盘的行
+class TickQuery {
+public:
+    TickQuery(uint64_t start, uint64_t end);
+
+    const std::vector<TickBlockView>& blocks() const { return m_blocks; }
+    bool next(Tick& tick);
+    void reset();
+
+private:
+    friend class TickStore;
+
+    uint64_t m_start;
+    uint64_t m_end;
+    std::vector<std::unique_ptr<TickPartitionReader>> m_partitions;
+    std::vector<TickBlockView> m_blocks;
+    std::vector<Tick> m_decoded;
+    std::vector<Tick> m_pending;      // 查询时未落盘的行（已按区间过滤）
+    size_t m_pendingAt;               // m_pending排在第m_pendingAt个块之前
+    bool m_pendingServed;
+    const Tick* m_rows;
+    size_t m_blockPos;
+    size_t m_rowPos;
+    size_t m_rowCount;
+};
+
+// 逐笔存储
+class TickStore {
+public:
+    static constexpr size_t kDefaultRowsPerBlock = 4096;
+
+    explicit TickStore(const std::string& rootDirectory, size_t rowsPerBlock = kDefaultRowsPerBlock);
+    ~TickStore();
+
+    // 追加一条逐笔记录（先写入内存块，块满时落盘）；时间戳在分区内回退时拒绝
+    bool append(const std::string& symbol, const Tick& tick);
+    // 把所有未满块写出并刷新文件（持久化，查询不依赖此调用）
+    bool flush();
+    void close();
+
+    // 查询[start, end]区间（含端点），包含尚未落盘的内存块
+    std::unique_ptr<TickQuery> query(const std::string& symbol, uint64_t start, uint64_t end) const;
+
+    // 纳秒时间戳所在的UTC日期，格式YYYYMMDD
+    static uint32_t dateOf(uint64_t timestamp);
+
+    uint64_t getAppendedCount() const { return m_appended; }
+    // 因时间戳回退而被拒绝的记录数
+    uint64_t getRejectedCount() const { return m_rejected; }
+
+private:
+    struct SymbolState {
+        std::unique_ptr<TickPartitionWriter> writer;
+        uint32_t date = 0;
+    };
+
+    std::string partitionPath(const std::string& symbol, uint32_t date) const;
+
+    std::string m_root;
+    size_t m_rowsPerBlock;
+    std::unordered_map<std::string, SymbolState> m_symbols;
+    uint64_t m_appended;
+    uint64_t m_rejected;
+};
+
+} // namespace persistence
+} // namespace hft
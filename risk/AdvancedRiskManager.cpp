@@ -214,9 +214,10 @@ void AdvancedRiskManager::updateRiskMetrics(const RiskMetrics& metrics) {
         m_alerts.push_back("Warning: Approaching daily loss limit");
     }
 
-    // VAR预警
+    // VAR预警（结果缓存，评分时不再重复计算）
+    m_currentVar95 = metrics.recentReturns.empty() ? 0.0 : calculateVAR(metrics.recentReturns, 0.95);
     if (!metrics.recentReturns.empty()) {
-        double var = calculateVAR(metrics.recentReturns, 0.95);
+        double var = m_currentVar95;
         if (var > 0.8 * m_var95Threshold) {
             m_alerts.push_back("Warning: Approaching VAR threshold");
         }
@@ -267,23 +268,10 @@ double AdvancedRiskManager::calculateCVaR(const std::vector<double>& returns, do
         throw std::invalid_argument("Returns vector cannot be empty");
     }
 
-    // 历史模拟法CVaR
-    std::vector<double> sortedReturns = returns;
-    std::sort(sortedReturns.begin(), sortedReturns.end());
-
-    int index = static_cast<int>((1.0 - confidenceLevel) * sortedReturns.size());
-    if (index < 0) index = 0;
-    if (index >= sortedReturns.size()) index = sortedReturns.size() - 1;
-
-    // 计算尾部预期损失
-    double cvar = 0.0;
-    int tailCount = sortedReturns.size() - index;
-    for (int i = 0; i < tailCount; ++i) {
-        cvar += sortedReturns[index + i];
-    }
-    cvar = -cvar / tailCount; // CVaR通常表示为正数
-
-    return cvar;
+    // 历史模拟法CVaR：VAR分位点及其左侧尾部的平均损失，部分排序即可
+    thread_local std::vector<double> scratch;
+    scratch.assign(returns.begin(), returns.end());
+    return tailRisk(scratch.data(), scratch.size(), confidenceLevel).cvar;
 }
 
 // 参数化VAR计算
@@ -334,25 +322,26 @@ double AdvancedRiskManager::calculateMonteCarloVAR(const std::vector<double>& re
     variance /= returns.size();
     double stdDev = std::sqrt(variance);
 
-    // 生成随机数引擎
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::normal_distribution<double> dist(mean, stdDev);
-
-    // 执行Monte Carlo模拟
-    std::vector<double> simulatedReturns;
-    simulatedReturns.reserve(numSimulations);
-    for (int i = 0; i < numSimulations; ++i) {
-        simulatedReturns.push_back(dist(gen));
+    // 单资产组合，敞口为1即收益率口径
+    std::lock_guard<std::mutex> lock(m_varMutex);
+    if (!m_monteCarlo.setPortfolio({1.0}, {mean}, {stdDev}, {1.0}) || numSimulations <= 0) {
+        return 0.0;
     }
+    return m_monteCarlo.simulate(static_cast<size_t>(numSimulations), confidenceLevel, ++m_simulationSeed).var;
+}
 
-    // 对模拟结果排序并计算VAR
-    std::sort(simulatedReturns.begin(), simulatedReturns.end());
-    int index = static_cast<int>((1.0 - confidenceLevel) * simulatedReturns.size());
-    if (index < 0) index = 0;
-    if (index >= simulatedReturns.size()) index = simulatedReturns.size() - 1;
-
-    return -simulatedReturns[index];
+// 多资产组合蒙特卡洛VAR
+VaRResult AdvancedRiskManager::calculatePortfolioVAR(const std::vector<double>& exposures, const std::vector<double>& means,
+                                                     const std::vector<double>& volatilities, const std::vector<double>& correlation,
+                                                     double confidenceLevel, size_t numSimulations) {
+    {
+        std::lock_guard<std::mutex> lock(m_varMutex);
+        if (m_monteCarlo.setPortfolio(exposures, means, volatilities, correlation)) {
+            return m_monteCarlo.simulate(numSimulations, confidenceLevel, ++m_simulationSeed);
+        }
+    }
+    log(LogLevel::WARNING, "Invalid portfolio for Monte Carlo VAR (size mismatch or correlation not positive definite)");
+    return VaRResult();
 }
 
 // 历史模拟法VAR计算
@@ -361,15 +350,25 @@ double AdvancedRiskManager::calculateVAR(const std::vector<double>& returns, dou
         throw std::invalid_argument("Returns vector cannot be empty");
     }
 
-    // 历史模拟法VAR
-    std::vector<double> sortedReturns = returns;
-    std::sort(sortedReturns.begin(), sortedReturns.end());
+    // 历史模拟法VAR：nth_element定位分位点，不做全排序
+    thread_local std::vector<double> scratch;
+    scratch.assign(returns.begin(), returns.end());
+    return tailRisk(scratch.data(), scratch.size(), confidenceLevel).var;
+}
+
+void AdvancedRiskManager::recordReturn(double portfolioReturn) {
+    std::lock_guard<std::mutex> lock(m_varMutex);
+    m_rollingVar.add(portfolioReturn);
+}
 
-    int index = static_cast<int>((1.0 - confidenceLevel) * sortedReturns.size());
-    if (index < 0) index = 0;
-    if (index >= sortedReturns.size()) index = sortedReturns.size() - 1;
+double AdvancedRiskManager::getRollingVAR() const {
+    std::lock_guard<std::mutex> lock(m_varMutex);
+    return m_rollingVar.var();
+}
 
-    return -sortedReturns[index]; // VAR通常表示为正数
+double AdvancedRiskManager::getRollingCVaR() const {
+    std::lock_guard<std::mutex> lock(m_varMutex);
+    return m_rollingVar.cvar();
 }
 
 // 获取风险评分
@@ -388,7 +387,7 @@ double AdvancedRiskManager::getRiskScore() const {
     // 3. VAR风险 (0-20)
     double varRisk = 0.0;
     if (!m_currentMetrics.recentReturns.empty()) {
-        double var = calculateVAR(m_currentMetrics.recentReturns, 0.95);
+        double var = m_currentVar95;
         varRisk = std::min(20.0, 20.0 * var / m_var95Threshold);
     }
 
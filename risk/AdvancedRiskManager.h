@@ -6,6 +6,7 @@
 #include <mutex>
 #include <optional>
 #include "RiskMetrics.h"
+#include "VaREngine.h"
 #include "core/Configuration.h"
 #include "execution/Order.h"
 #include "LowLatencyLogger.h"
@@ -79,6 +80,16 @@ public:
     double calculateMonteCarloVAR(const std::vector<double>& returns, double confidenceLevel, int numSimulations = 10000);
     double calculateCVaR(const std::vector<double>& returns, double confidenceLevel);
 
+    // 多资产组合蒙特卡洛VaR/CVaR：敞口、收益均值、波动率、相关系数矩阵（n×n行优先）
+    VaRResult calculatePortfolioVAR(const std::vector<double>& exposures, const std::vector<double>& means,
+                                    const std::vector<double>& volatilities, const std::vector<double>& correlation,
+                                    double confidenceLevel, size_t numSimulations = 100000);
+
+    // 滚动窗口历史VaR：逐笔追加组合收益，VaR增量维护
+    void recordReturn(double portfolioReturn);
+    double getRollingVAR() const;
+    double getRollingCVaR() const;
+
     // 风险分散化分析
     double calculateDiversificationScore() const;
     std::unordered_map<std::string, double> getSectorExposure() const;
@@ -103,6 +114,11 @@ private:
     double m_maxDailyLoss;        // 最大日亏损限额
     double m_var95Threshold;      // 95% VAR限额
     RiskMetrics m_currentMetrics; // 当前风险指标
+    double m_currentVar95 = 0.0;  // 当前指标的95%历史VAR，随updateRiskMetrics更新
+    RollingHistoricalVaR m_rollingVar{1000, 0.95};
+    MonteCarloVaREngine m_monteCarlo;
+    uint64_t m_simulationSeed = 0; // 每次模拟递增，计数器随机数只需不同的密钥
+    mutable std::mutex m_varMutex; // 保护m_rollingVar、m_monteCarlo与m_simulationSeed
     std::vector<std::string> m_alerts; // 风险预警
     std::unordered_map<std::string, double> m_positionLimits; // 品种持仓限额
 
@@ -0,0 +1,142 @@
+#include "PositionBook.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace hft {
+namespace risk {
+
+PositionBook::PositionBook(size_t maxSymbols)
+    : m_capacity(maxSymbols),
+      m_slots(new utils::SeqLock<PositionSnapshot>[maxSymbols]),
+      m_working(maxSymbols),
+      m_active(new core::SymbolId[maxSymbols]),
+      m_activeCount(0) {
+}
+
+PositionSnapshot* PositionBook::workingSlot(core::SymbolId symbol) {
+    if (symbol == core::kInvalidSymbol || symbol >= m_capacity) {
+        return nullptr;
+    }
+    PositionSnapshot& slot = m_working[symbol];
+    if (slot.symbolId == core::kInvalidSymbol) {
+        // 首次出现：先写入ID再发布计数，读者看到计数时ID已可见
+        slot.symbolId = symbol;
+        const size_t count = m_activeCount.load(std::memory_order_relaxed);
+        m_active[count] = symbol;
+        m_slots[symbol].store(slot);
+        m_activeCount.store(count + 1, std::memory_order_release);
+    }
+    return &slot;
+}
+
+bool PositionBook::onFill(core::SymbolId symbol, int64_t quantity, double price) {
+    PositionSnapshot* slot = workingSlot(symbol);
+    if (!slot || quantity == 0) {
+        return false;
+    }
+    const PositionSnapshot before = *slot;
+    const int64_t position = slot->quantity;
+    const int64_t next = position + quantity;
+
+    if (position == 0 || (position > 0) == (quantity > 0)) {
+        // 开仓或加仓
+        slot->avgPrice = (slot->avgPrice * static_cast<double>(std::llabs(position)) +
+                          price * static_cast<double>(std::llabs(quantity))) /
+                         static_cast<double>(std::llabs(next));
+    } else {
+        // 减仓、平仓或反手
+        const int64_t closed = std::min(std::llabs(quantity), std::llabs(position));
+        const double direction = position > 0 ? 1.0 : -1.0;
+        slot->realizedPnl += static_cast<double>(closed) * (price - slot->avgPrice) * direction;
+        if (next == 0) {
+            slot->avgPrice = 0.0;
+        } else if ((next > 0) != (position > 0)) {
+            slot->avgPrice = price;
+        }
+    }
+    slot->quantity = next;
+    slot->markPrice = price;
+    ++slot->fillCount;
+    publish(*slot, before);
+    return true;
+}
+
+bool PositionBook::updateMarkPrice(core::SymbolId symbol, double price) {
+    if (symbol == core::kInvalidSymbol || symbol >= m_capacity) {
+        return false;
+    }
+    PositionSnapshot& slot = m_working[symbol];
+    // 从未持仓的品种不占槽位
+    if (slot.symbolId == core::kInvalidSymbol || slot.markPrice == price) {
+        return false;
+    }
+    const PositionSnapshot before = slot;
+    slot.markPrice = price;
+    publish(slot, before);
+    return true;
+}
+
+bool PositionBook::setPosition(core::SymbolId symbol, int64_t quantity, double avgPrice) {
+    PositionSnapshot* slot = workingSlot(symbol);
+    if (!slot) {
+        return false;
+    }
+    const PositionSnapshot before = *slot;
+    slot->quantity = quantity;
+    slot->avgPrice = quantity != 0 ? avgPrice : 0.0;
+    if (slot->markPrice == 0.0) {
+        slot->markPrice = avgPrice;
+    }
+    publish(*slot, before);
+    return true;
+}
+
+void PositionBook::publish(PositionSnapshot& slot, const PositionSnapshot& before) {
+    slot.unrealizedPnl = static_cast<double>(slot.quantity) * (slot.markPrice - slot.avgPrice);
+    slot.exposure = std::fabs(static_cast<double>(slot.quantity) * slot.markPrice);
+    m_slots[slot.symbolId].store(slot);
+
+    // 按差量更新组合汇总
+    PortfolioTotals& totals = m_workingTotals;
+    totals.exposure += slot.exposure - before.exposure;
+    totals.unrealizedPnl += slot.unrealizedPnl - before.unrealizedPnl;
+    totals.realizedPnl += slot.realizedPnl - before.realizedPnl;
+    totals.grossQuantity += std::llabs(slot.quantity) - std::llabs(before.quantity);
+    if (before.quantity == 0 && slot.quantity != 0) {
+        ++totals.openPositions;
+    } else if (before.quantity != 0 && slot.quantity == 0) {
+        --totals.openPositions;
+    }
+    ++totals.version;
+    m_totals.store(totals);
+}
+
+void PositionBook::rebuildTotals() {
+    PortfolioTotals totals;
+    totals.version = m_workingTotals.version + 1;
+    const size_t count = m_activeCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        const PositionSnapshot& slot = m_working[m_active[i]];
+        totals.exposure += slot.exposure;
+        totals.unrealizedPnl += slot.unrealizedPnl;
+        totals.realizedPnl += slot.realizedPnl;
+        totals.grossQuantity += std::llabs(slot.quantity);
+        if (slot.quantity != 0) {
+            ++totals.openPositions;
+        }
+    }
+    m_workingTotals = totals;
+    m_totals.store(totals);
+}
+
+bool PositionBook::snapshot(core::SymbolId symbol, PositionSnapshot& out) const {
+    if (symbol == core::kInvalidSymbol || symbol >= m_capacity) {
+        return false;
+    }
+    out = m_slots[symbol].load();
+    return out.symbolId != core::kInvalidSymbol;
+}
+
+} // namespace risk
+} // namespace hft
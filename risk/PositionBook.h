@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "core/SymbolRegistry.h"
+#include "utils/SeqLock.h"
+
+namespace hft {
+namespace risk {
+
+// 单品种持仓快照（可平凡拷贝，通过顺序锁发布）
+struct PositionSnapshot {
+    core::SymbolId symbolId = core::kInvalidSymbol;
+    int64_t quantity = 0;       // 持仓数量，可以为负数（卖空）
+    double avgPrice = 0.0;      // 平均持仓价格
+    double markPrice = 0.0;     // 最新估值价格
+    double realizedPnl = 0.0;
+    double unrealizedPnl = 0.0;
+    double exposure = 0.0;      // |数量 × 估值价格|
+    uint64_t fillCount = 0;
+};
+
+// 组合汇总
+struct PortfolioTotals {
+    double exposure = 0.0;
+    double unrealizedPnl = 0.0;
+    double realizedPnl = 0.0;
+    int64_t grossQuantity = 0;  // 各品种持仓绝对值之和
+    uint32_t openPositions = 0; // 持仓不为0的品种数
+    uint64_t version = 0;       // 每次更新加1
+};
+
+// 无锁持仓与盈亏簿
+//
+//  - 以SymbolId为下标的定长槽位，每个槽位是独立缓存行上的顺序锁，
+//    写线程更新后整体发布快照，读者不加锁、不阻塞写线程
+//  - 组合汇总随每次成交/估值变化按差量更新，读取为O(1)
+//  - 写线程私有一份工作副本，更新时不回读已发布的数据
+//
+// 写入（onFill、updateMarkPrice、setPosition）只允许单一线程调用，通常是成交回报线程；
+// 行情估值需由同一线程转发。读取接口可在任意线程调用。
+class PositionBook {
+public:
+    explicit PositionBook(size_t maxSymbols = 1 << 16);
+
+    PositionBook(const PositionBook&) = delete;
+    PositionBook& operator=(const PositionBook&) = delete;
+
+    // --- 写线程 ---
+    // 成交，quantity带方向（买为正，卖为负）
+    bool onFill(core::SymbolId symbol, int64_t quantity, double price);
+    bool updateMarkPrice(core::SymbolId symbol, double price);
+    // 直接设置持仓（日初加载、对账），已实现盈亏保留
+    bool setPosition(core::SymbolId symbol, int64_t quantity, double avgPrice);
+    // 按全部槽位重算汇总，消除长期差量累加的浮点误差
+    void rebuildTotals();
+
+    // --- 任意线程 ---
+    // 读取一致的快照；未出现过的品种返回false
+    bool snapshot(core::SymbolId symbol, PositionSnapshot& out) const;
+    PortfolioTotals totals() const { return m_totals.load(); }
+    // 遍历出现过的品种：fn(const PositionSnapshot&)
+    template<typename Fn>
+    void forEachPosition(Fn&& fn) const {
+        const size_t count = m_activeCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            fn(m_slots[m_active[i]].load());
+        }
+    }
+    size_t activeSymbols() const { return m_activeCount.load(std::memory_order_acquire); }
+    size_t capacity() const { return m_capacity; }
+
+private:
+    PositionSnapshot* workingSlot(core::SymbolId symbol);
+    void publish(PositionSnapshot& slot, const PositionSnapshot& before);
+
+    size_t m_capacity;
+    std::unique_ptr<utils::SeqLock<PositionSnapshot>[]> m_slots;   // 发布给读者的快照
+    std::vector<PositionSnapshot> m_working;                        // 写线程工作副本
+    std::unique_ptr<core::SymbolId[]> m_active;                     // 出现过的品种，只增不删
+    std::atomic<size_t> m_activeCount;
+    PortfolioTotals m_workingTotals;
+    utils::SeqLock<PortfolioTotals> m_totals;
+};
+
+} // namespace risk
+} // namespace hft
@@ -2,8 +2,8 @@
 #include <unordered_map>
 #include <string>
 #include <cstdint>
-#include <mutex>
 #include "execution/Order.h"
+#include "PositionBook.h"
 
 namespace hft {
 namespace risk {
@@ -22,13 +22,20 @@ struct Position {
 
 typedef std::shared_ptr<Position> PositionPtr;
 
+// 持仓监控
+// 持仓与盈亏保存在以SymbolId为下标的PositionBook中：成交线程写入，
+// 风控检查与周期巡检无锁读取快照，汇总值为O(1)读取。
+// updatePosition/updateMarketPrice/onFill需在同一线程调用。
 class PositionMonitor {
 public:
     PositionMonitor();
     ~PositionMonitor();
 
     // 更新仓位
-    void updatePosition(const execution::OrderPtr& order);
+    void updatePosition(const OrderPtr& order);
+
+    // 热路径成交回报：quantity为本次成交量
+    void onFill(const OrderRecord& order, uint64_t quantity, double price);
 
     // 更新市场价格
     void updateMarketPrice(const std::string& symbol, double price);
@@ -48,9 +55,14 @@ public:
     // 计算总已实现盈亏
     double calculateTotalRealizedPnl() const;
 
+    // 底层持仓簿，供高频读取快照与汇总
+    const PositionBook& book() const { return m_book; }
+    PositionBook& book() { return m_book; }
+
 private:
-    mutable std::mutex m_mutex;
-    std::unordered_map<std::string, PositionPtr> m_positions;
+    static PositionPtr toPosition(const PositionSnapshot& snapshot);
+
+    PositionBook m_book;
 };
 
 } // namespace risk
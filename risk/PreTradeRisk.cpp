@@ -0,0 +1,312 @@
+#include "PreTradeRisk.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+namespace hft {
+namespace risk {
+
+const char* riskRejectName(RiskReject reason) {
+    switch (reason) {
+        case RiskReject::NONE: return "NONE";
+        case RiskReject::ORDER_SIZE: return "ORDER_SIZE";
+        case RiskReject::PRICE_COLLAR: return "PRICE_COLLAR";
+        case RiskReject::POSITION_LIMIT: return "POSITION_LIMIT";
+        case RiskReject::NOTIONAL_LIMIT: return "NOTIONAL_LIMIT";
+        case RiskReject::ORDER_RATE: return "ORDER_RATE";
+        case RiskReject::SELF_TRADE: return "SELF_TRADE";
+        case RiskReject::UNKNOWN_SYMBOL: return "UNKNOWN_SYMBOL";
+    }
+    return "UNKNOWN";
+}
+
+PreTradeRiskChain::PreTradeRiskChain(const RiskLimits& limits, size_t maxSymbols)
+    : m_checks(), m_checkCount(0), m_symbols(maxSymbols), m_symbolLimit(0),
+      m_grossExposure(0), m_openQuantity(0), m_openNotional(0.0), m_trackLatency(true) {
+    configure(limits);
+}
+
+void PreTradeRiskChain::configure(const RiskLimits& limits) {
+    m_limits = limits;
+
+    // 单品种上限：不超过1时视为总持仓的比例，否则为绝对数量
+    if (limits.maxSinglePosition <= 0.0) {
+        m_symbolLimit = 0;
+    } else if (limits.maxSinglePosition <= 1.0) {
+        m_symbolLimit = static_cast<uint64_t>(limits.maxSinglePosition * static_cast<double>(limits.maxTotalPosition));
+    } else {
+        m_symbolLimit = static_cast<uint64_t>(limits.maxSinglePosition);
+    }
+    m_rateLimiter.configure(limits.maxOrdersPerSecond, limits.maxOrdersPerSecond);
+
+    // 先做便宜且最常拒单的检查；速率检查会消耗令牌，放在最后只对真正发出的订单计数
+    m_checkCount = 0;
+    auto add = [this](PreTradeCheck id, CheckFn fn) { m_checks[m_checkCount++] = CheckEntry{id, fn}; };
+    if (limits.maxOrderSize > 0) {
+        add(PreTradeCheck::ORDER_SIZE, &PreTradeRiskChain::checkOrderSize);
+    }
+    if (limits.maxPriceDeviation > 0.0) {
+        add(PreTradeCheck::PRICE_COLLAR, &PreTradeRiskChain::checkPriceCollar);
+    }
+    if (limits.maxTotalPosition > 0 || m_symbolLimit > 0) {
+        add(PreTradeCheck::POSITION, &PreTradeRiskChain::checkPosition);
+    }
+    if (limits.maxOrderValue > 0.0 || limits.maxTotalValue > 0.0) {
+        add(PreTradeCheck::NOTIONAL, &PreTradeRiskChain::checkNotional);
+    }
+    add(PreTradeCheck::SELF_TRADE, &PreTradeRiskChain::checkSelfTrade);
+    if (limits.maxOrdersPerSecond > 0) {
+        add(PreTradeCheck::ORDER_RATE, &PreTradeRiskChain::checkOrderRate);
+    }
+}
+
+RiskReject PreTradeRiskChain::check(const OrderRecord& order, uint64_t now) {
+    ++m_stats.checked;
+    SymbolState* state = stateOf(order.symbolId);
+    if (!state) {
+        ++m_stats.rejected[static_cast<size_t>(RiskReject::UNKNOWN_SYMBOL)];
+        return RiskReject::UNKNOWN_SYMBOL;
+    }
+
+    OrderContext ctx;
+    ctx.order = &order;
+    ctx.state = state;
+    ctx.price = toPrice(order.price);
+    // 市价单按参考价估算金额
+    const types::Price reference = state->reference.load(std::memory_order_relaxed);
+    const types::Price valuation = (order.type == OrderType::MARKET || ctx.price <= 0) ? reference : ctx.price;
+    ctx.notional = static_cast<double>(valuation) / 10000.0 * static_cast<double>(order.quantity);
+    ctx.now = now;
+
+    RiskReject result = RiskReject::NONE;
+    if (m_trackLatency) {
+        const uint64_t start = nowNs();
+        uint64_t last = start;
+        for (size_t i = 0; i < m_checkCount && result == RiskReject::NONE; ++i) {
+            result = (this->*m_checks[i].fn)(ctx);
+            const uint64_t t = nowNs();
+            m_latency[static_cast<size_t>(m_checks[i].id)].record(t - last);
+            last = t;
+        }
+        m_totalLatency.record(last - start);
+    } else {
+        for (size_t i = 0; i < m_checkCount && result == RiskReject::NONE; ++i) {
+            result = (this->*m_checks[i].fn)(ctx);
+        }
+    }
+
+    if (result != RiskReject::NONE) {
+        ++m_stats.rejected[static_cast<size_t>(result)];
+        return result;
+    }
+    reserve(ctx);
+    ++m_stats.passed;
+    return RiskReject::NONE;
+}
+
+RiskReject PreTradeRiskChain::checkOrderSize(const OrderContext& ctx) {
+    const uint64_t quantity = ctx.order->quantity;
+    return (quantity == 0 || quantity > m_limits.maxOrderSize) ? RiskReject::ORDER_SIZE : RiskReject::NONE;
+}
+
+RiskReject PreTradeRiskChain::checkPriceCollar(const OrderContext& ctx) {
+    if (ctx.order->type == OrderType::MARKET) {
+        return RiskReject::NONE;
+    }
+    const types::Price reference = ctx.state->reference.load(std::memory_order_relaxed);
+    if (reference <= 0) {
+        return RiskReject::NONE;    // 尚无参考价
+    }
+    const double band = static_cast<double>(reference) * m_limits.maxPriceDeviation;
+    const double deviation = std::fabs(static_cast<double>(ctx.price - reference));
+    return (ctx.price <= 0 || deviation > band) ? RiskReject::PRICE_COLLAR : RiskReject::NONE;
+}
+
+RiskReject PreTradeRiskChain::checkPosition(const OrderContext& ctx) {
+    const SymbolState& s = *ctx.state;
+    const int64_t quantity = static_cast<int64_t>(ctx.order->quantity);
+
+    // 假设同方向未成交单全部成交后的最坏持仓（按本单方向计，为负表示仍与本单反向）
+    const int64_t worst = ctx.order->side == OrderSide::BUY
+        ? s.position + static_cast<int64_t>(s.open_buy) + quantity
+        : -(s.position - static_cast<int64_t>(s.open_sell) - quantity);
+    if (m_symbolLimit > 0 && worst > static_cast<int64_t>(m_symbolLimit)) {
+        return RiskReject::POSITION_LIMIT;
+    }
+    // 减仓单（最坏情况下不越过零）不受总持仓限制，即使总持仓已经超限
+    if (m_limits.maxTotalPosition > 0 && worst > 0) {
+        const uint64_t before = exposure(s);
+        const uint64_t after = static_cast<uint64_t>(worst) > before ? static_cast<uint64_t>(worst) : before;
+        if (m_grossExposure - before + after > m_limits.maxTotalPosition) {
+            return RiskReject::POSITION_LIMIT;
+        }
+    }
+    return RiskReject::NONE;
+}
+
+RiskReject PreTradeRiskChain::checkNotional(const OrderContext& ctx) {
+    if (m_limits.maxOrderValue > 0.0 && ctx.notional > m_limits.maxOrderValue) {
+        return RiskReject::NOTIONAL_LIMIT;
+    }
+    if (m_limits.maxTotalValue > 0.0 && m_openNotional + ctx.notional > m_limits.maxTotalValue) {
+        return RiskReject::NOTIONAL_LIMIT;
+    }
+    return RiskReject::NONE;
+}
+
+RiskReject PreTradeRiskChain::checkOrderRate(const OrderContext& ctx) {
+    return m_rateLimiter.tryAcquire(ctx.now) ? RiskReject::NONE : RiskReject::ORDER_RATE;
+}
+
+RiskReject PreTradeRiskChain::checkSelfTrade(const OrderContext& ctx) {
+    const SymbolState& s = *ctx.state;
+    const bool market = ctx.order->type == OrderType::MARKET;
+    if (ctx.order->side == OrderSide::BUY) {
+        if (s.sell_orders > 0 && (market || ctx.price >= s.own_ask)) {
+            return RiskReject::SELF_TRADE;
+        }
+    } else {
+        if (s.buy_orders > 0 && (market || ctx.price <= s.own_bid)) {
+            return RiskReject::SELF_TRADE;
+        }
+    }
+    return RiskReject::NONE;
+}
+
+void PreTradeRiskChain::reserve(const OrderContext& ctx) {
+    SymbolState& s = *ctx.state;
+    const uint64_t quantity = ctx.order->quantity;
+    const bool market = ctx.order->type == OrderType::MARKET;
+    const uint64_t before = exposure(s);
+    if (ctx.order->side == OrderSide::BUY) {
+        s.open_buy += quantity;
+        // 市价单不挂在簿上，不影响本方最优价
+        if (!market) {
+            if (s.buy_orders == 0 || ctx.price > s.own_bid) {
+                s.own_bid = ctx.price;
+            }
+            ++s.buy_orders;
+        }
+    } else {
+        s.open_sell += quantity;
+        if (!market) {
+            if (s.sell_orders == 0 || ctx.price < s.own_ask) {
+                s.own_ask = ctx.price;
+            }
+            ++s.sell_orders;
+        }
+    }
+    m_grossExposure = m_grossExposure - before + exposure(s);
+    m_openQuantity += quantity;
+    m_openNotional += ctx.notional;
+}
+
+void PreTradeRiskChain::release(SymbolState& state, const OrderRecord& order, uint64_t quantity) {
+    uint64_t& open = order.side == OrderSide::BUY ? state.open_buy : state.open_sell;
+    if (quantity > open) {
+        quantity = open;
+    }
+    const uint64_t before = exposure(state);
+    open -= quantity;
+    m_grossExposure = m_grossExposure - before + exposure(state);
+    m_openQuantity -= quantity < m_openQuantity ? quantity : m_openQuantity;
+
+    const types::Price price = order.type == OrderType::MARKET || order.price <= 0.0
+        ? state.reference.load(std::memory_order_relaxed) : toPrice(order.price);
+    m_openNotional -= static_cast<double>(price) / 10000.0 * static_cast<double>(quantity);
+    // 市价单按参考价释放会有偏差，全部结束时归零
+    if (m_openQuantity == 0 || m_openNotional < 0.0) {
+        m_openNotional = 0.0;
+    }
+}
+
+void PreTradeRiskChain::onOrderClosed(const OrderRecord& order, uint64_t unfilledQuantity) {
+    SymbolState* state = stateOf(order.symbolId);
+    if (!state) {
+        return;
+    }
+    release(*state, order, unfilledQuantity);
+    closeOrder(*state, order);
+}
+
+void PreTradeRiskChain::closeOrder(SymbolState& state, const OrderRecord& order) {
+    if (order.type == OrderType::MARKET) {
+        return;
+    }
+    if (order.side == OrderSide::BUY) {
+        if (state.buy_orders > 0 && --state.buy_orders == 0) {
+            state.own_bid = 0;
+        }
+    } else {
+        if (state.sell_orders > 0 && --state.sell_orders == 0) {
+            state.own_ask = 0;
+        }
+    }
+}
+
+void PreTradeRiskChain::onFill(const OrderRecord& order, uint64_t quantity) {
+    SymbolState* state = stateOf(order.symbolId);
+    if (!state) {
+        return;
+    }
+    release(*state, order, quantity);
+    const int64_t delta = order.side == OrderSide::BUY ? static_cast<int64_t>(quantity) : -static_cast<int64_t>(quantity);
+    setPosition(order.symbolId, state->position + delta);
+    if (order.filledQuantity + quantity >= order.quantity) {
+        closeOrder(*state, order);
+    }
+}
+
+void PreTradeRiskChain::updateReferencePrice(core::SymbolId symbol, types::Price price) {
+    if (SymbolState* state = stateOf(symbol)) {
+        state->reference.store(price, std::memory_order_relaxed);
+    }
+}
+
+void PreTradeRiskChain::setPosition(core::SymbolId symbol, int64_t quantity) {
+    SymbolState* state = stateOf(symbol);
+    if (!state) {
+        return;
+    }
+    const uint64_t before = exposure(*state);
+    state->position = quantity;
+    m_grossExposure = m_grossExposure - before + exposure(*state);
+}
+
+int64_t PreTradeRiskChain::position(core::SymbolId symbol) const {
+    const SymbolState* state = stateOf(symbol);
+    return state ? state->position : 0;
+}
+
+uint64_t PreTradeRiskChain::openQuantity(core::SymbolId symbol, OrderSide side) const {
+    const SymbolState* state = stateOf(symbol);
+    if (!state) {
+        return 0;
+    }
+    return side == OrderSide::BUY ? state->open_buy : state->open_sell;
+}
+
+void PreTradeRiskChain::resetLatency() {
+    for (auto& histogram : m_latency) {
+        histogram.reset();
+    }
+    m_totalLatency.reset();
+}
+
+uint64_t PreTradeRiskChain::exposure(const SymbolState& state) {
+    const uint64_t longest = static_cast<uint64_t>(std::llabs(state.position + static_cast<int64_t>(state.open_buy)));
+    const uint64_t shortest = static_cast<uint64_t>(std::llabs(state.position - static_cast<int64_t>(state.open_sell)));
+    return longest > shortest ? longest : shortest;
+}
+
+types::Price PreTradeRiskChain::toPrice(double price) {
+    return static_cast<types::Price>(std::llround(price * 10000.0));
+}
+
+uint64_t PreTradeRiskChain::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace risk
+} // namespace hft
@@ -0,0 +1,188 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "RiskLimits.h"
+#include "core/Types.h"
+#include "execution/Order.h"
+#include "utils/LatencyHistogram.h"
+
+namespace hft {
+namespace risk {
+
+// 事前风控拒单原因
+enum class RiskReject : uint8_t {
+    NONE = 0,
+    ORDER_SIZE,         // 下单量为0或超过单笔上限（胖手指）
+    PRICE_COLLAR,       // 限价偏离参考价过多
+    POSITION_LIMIT,     // 成交后单品种或总持仓可能超限
+    NOTIONAL_LIMIT,     // 单笔金额或未成交总金额超限
+    ORDER_RATE,         // 下单速率超限
+    SELF_TRADE,         // 可能与本方挂单成交
+    UNKNOWN_SYMBOL      // 品种ID超出风控表范围
+};
+
+const char* riskRejectName(RiskReject reason);
+
+// 事前检查项
+enum class PreTradeCheck : uint8_t {
+    ORDER_SIZE = 0,
+    PRICE_COLLAR,
+    POSITION,
+    NOTIONAL,
+    ORDER_RATE,
+    SELF_TRADE,
+    COUNT
+};
+
+// 滑动窗口令牌桶（GCRA）
+// 以ratePerSecond持续补充、容量为burst；只保存一个理论到达时间，每次判断O(1)
+class OrderRateLimiter {
+public:
+    OrderRateLimiter() : m_interval(0), m_tolerance(0), m_tat(0) {}
+
+    void configure(uint64_t ratePerSecond, uint64_t burst) {
+        m_interval = ratePerSecond > 0 ? 1000000000ULL / ratePerSecond : 0;
+        m_tolerance = burst > 1 ? m_interval * (burst - 1) : 0;
+        m_tat = 0;
+    }
+
+    // now为单调时钟纳秒；通过时消耗一个令牌
+    bool tryAcquire(uint64_t now) {
+        if (m_interval == 0) {
+            return true;
+        }
+        const uint64_t tat = m_tat > now ? m_tat : now;
+        if (tat - now > m_tolerance) {
+            return false;
+        }
+        m_tat = tat + m_interval;
+        return true;
+    }
+
+private:
+    uint64_t m_interval;        // 相邻令牌间隔（纳秒）
+    uint64_t m_tolerance;       // 允许的突发量对应的时间
+    uint64_t m_tat;             // 理论到达时间
+};
+
+// 事前风控统计
+struct PreTradeStats {
+    uint64_t checked = 0;
+    uint64_t passed = 0;
+    uint64_t rejected[8] = {};  // 以RiskReject为下标
+};
+
+// 事前风控检查链
+//
+//  - 按RiskLimits生成检查链，限额为0的检查不进入链中
+//  - 每个品种的持仓、未成交量、参考价、本方最优挂单价预先聚合在以SymbolId为下标的数组中，
+//    每项检查都是常数时间，check()不分配内存、不加锁
+//  - 通过检查的订单立即计入未成交量与金额；撤单/拒单/成交时由调用方通知释放或转为持仓
+//  - 每项检查的耗时记入独立的延迟直方图
+//
+// 非线程安全：check()与订单生命周期通知需在同一线程调用；updateReferencePrice()可在行情线程调用。
+class PreTradeRiskChain {
+public:
+    explicit PreTradeRiskChain(const RiskLimits& limits = RiskLimits(), size_t maxSymbols = 1 << 16);
+
+    PreTradeRiskChain(const PreTradeRiskChain&) = delete;
+    PreTradeRiskChain& operator=(const PreTradeRiskChain&) = delete;
+
+    // 按新的限额重建检查链（持仓与未成交状态保留）
+    void configure(const RiskLimits& limits);
+
+    // 检查订单，now为单调时钟纳秒；通过时返回RiskReject::NONE并登记为未成交
+    RiskReject check(const OrderRecord& order, uint64_t now);
+
+    // 订单结束（撤单、拒单、过期），释放unfilledQuantity对应的未成交量
+    void onOrderClosed(const OrderRecord& order, uint64_t unfilledQuantity);
+    // 成交：未成交量转为持仓。order.filledQuantity为本次成交之前的累计成交量，
+    // 累计成交达到order.quantity时订单视为结束，调用方无需再调用onOrderClosed()
+    void onFill(const OrderRecord& order, uint64_t quantity);
+
+    // 参考价（最新价或中间价，放大10000倍），行情线程可调用
+    void updateReferencePrice(core::SymbolId symbol, types::Price price);
+    // 设置日初持仓
+    void setPosition(core::SymbolId symbol, int64_t quantity);
+
+    int64_t position(core::SymbolId symbol) const;
+    uint64_t openQuantity(core::SymbolId symbol, OrderSide side) const;
+    double openNotional() const { return m_openNotional; }
+
+    void setLatencyTracking(bool enabled) { m_trackLatency = enabled; }
+    const utils::LatencyHistogram& latency(PreTradeCheck check) const { return m_latency[static_cast<size_t>(check)]; }
+    const utils::LatencyHistogram& totalLatency() const { return m_totalLatency; }
+    const PreTradeStats& stats() const { return m_stats; }
+    void resetLatency();
+
+private:
+    struct alignas(64) SymbolState {
+        int64_t position = 0;                   // 已成交持仓（有符号）
+        uint64_t open_buy = 0;                  // 未成交买量
+        uint64_t open_sell = 0;                 // 未成交卖量
+        uint32_t buy_orders = 0;                // 未成交买单数
+        uint32_t sell_orders = 0;
+        types::Price own_bid = 0;               // 本方未成交买单最高价（保守：订单全部结束前只升不降）
+        types::Price own_ask = 0;               // 本方未成交卖单最低价（0表示无）
+        std::atomic<types::Price> reference{0};
+    };
+
+    // 检查上下文：每笔订单只换算一次
+    struct OrderContext {
+        const OrderRecord* order;
+        SymbolState* state;
+        types::Price price;
+        double notional;
+        uint64_t now;
+    };
+
+    using CheckFn = RiskReject (PreTradeRiskChain::*)(const OrderContext&);
+    struct CheckEntry {
+        PreTradeCheck id;
+        CheckFn fn;
+    };
+
+    RiskReject checkOrderSize(const OrderContext& ctx);
+    RiskReject checkPriceCollar(const OrderContext& ctx);
+    RiskReject checkPosition(const OrderContext& ctx);
+    RiskReject checkNotional(const OrderContext& ctx);
+    RiskReject checkOrderRate(const OrderContext& ctx);
+    RiskReject checkSelfTrade(const OrderContext& ctx);
+
+    void reserve(const OrderContext& ctx);
+    void release(SymbolState& state, const OrderRecord& order, uint64_t quantity);
+    // 未成交单数减一，该方向没有挂单时清除本方最优价
+    static void closeOrder(SymbolState& state, const OrderRecord& order);
+    SymbolState* stateOf(core::SymbolId symbol) {
+        return symbol < m_symbols.size() ? &m_symbols[symbol] : nullptr;
+    }
+    const SymbolState* stateOf(core::SymbolId symbol) const {
+        return symbol < m_symbols.size() ? &m_symbols[symbol] : nullptr;
+    }
+    // 同方向未成交单全部成交后持仓绝对值的较大者
+    static uint64_t exposure(const SymbolState& state);
+    static types::Price toPrice(double price);
+    static uint64_t nowNs();
+
+    RiskLimits m_limits;
+    std::array<CheckEntry, static_cast<size_t>(PreTradeCheck::COUNT)> m_checks;
+    size_t m_checkCount;
+
+    std::vector<SymbolState> m_symbols;         // 以SymbolId为下标
+    uint64_t m_symbolLimit;                     // 单品种持仓上限
+    uint64_t m_grossExposure;                   // 各品种exposure()之和，即最坏情况下的总持仓
+    uint64_t m_openQuantity;                    // 全部未成交量
+    double m_openNotional;                      // 全部未成交金额
+    OrderRateLimiter m_rateLimiter;
+
+    bool m_trackLatency;
+    std::array<utils::LatencyHistogram, static_cast<size_t>(PreTradeCheck::COUNT)> m_latency;
+    utils::LatencyHistogram m_totalLatency;
+    PreTradeStats m_stats;
+};
+
+} // namespace risk
+} // namespace hft
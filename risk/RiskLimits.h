@@ -16,11 +16,14 @@ struct RiskLimits {
     double maxDrawdown;             // 最大回撤比例
     uint64_t maxOrderSize;          // 单笔最大下单量
     uint64_t maxOrdersPerSecond;    // 每秒最大下单数量
+    double maxOrderValue;           // 单笔最大下单金额
+    double maxPriceDeviation;       // 限价偏离参考价的最大比例
 
     RiskLimits() : maxTotalPosition(1000000), maxTotalValue(10000000.0),
                   maxSinglePosition(0.2), maxDailyLoss(50000.0),
                   maxDrawdown(0.1), maxOrderSize(100000),
-                  maxOrdersPerSecond(100) {}
+                  maxOrdersPerSecond(100), maxOrderValue(1000000.0),
+                  maxPriceDeviation(0.05) {}
 };
 
 typedef std::shared_ptr<RiskLimits> RiskLimitsPtr;
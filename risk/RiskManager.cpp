@@ -42,16 +42,18 @@ bool RiskManager::evaluateOrderRisk(const execution::OrderPtr& order) {
         return false;
     }
 
-    // 检查仓位限额
-    PositionPtr position = m_positionMonitor->getPosition(order->symbol);
-    int64_t currentPosition = (position) ? position->quantity : 0;
+    // 检查仓位限额（读取持仓快照，不与成交线程竞争）
+    const PositionBook& book = m_positionMonitor->book();
+    PositionSnapshot position;
+    int64_t currentPosition = book.snapshot(core::SymbolRegistry::symbols().find(order->symbol), position) ?
+                              position.quantity : 0;
     int64_t newPosition = currentPosition + 
                          ((order->side == execution::OrderSide::BUY) ? 
                           static_cast<int64_t>(order->quantity) : 
                           -static_cast<int64_t>(order->quantity));
 
     // 检查单个品种持仓比例
-    double totalPositionValue = m_positionMonitor->calculateTotalPositionValue();
+    double totalPositionValue = book.totals().exposure;
     double newPositionValue = std::abs(static_cast<double>(newPosition) * order->price);
 
     if (totalPositionValue > 0 && newPositionValue / totalPositionValue > m_riskLimits->maxSinglePosition) {
@@ -86,8 +88,12 @@ RiskLevel RiskManager::evaluateSystemRisk() {
         return RiskLevel::LOW;
     }
 
+    // 汇总只读取一次，保证本轮检查使用同一份快照
+    const PositionBook& book = m_positionMonitor->book();
+    const PortfolioTotals totals = book.totals();
+
     // 检查总未实现亏损
-    double totalUnrealizedPnl = m_positionMonitor->calculateTotalUnrealizedPnl();
+    double totalUnrealizedPnl = totals.unrealizedPnl;
     if (totalUnrealizedPnl < -m_riskLimits->maxDailyLoss) {
         generateRiskEvent(RiskLevel::CRITICAL,
                          "Daily loss exceeds limit: " + std::to_string(totalUnrealizedPnl) + 
@@ -97,7 +103,7 @@ RiskLevel RiskManager::evaluateSystemRisk() {
     }
 
     // 检查总持仓价值
-    double totalPositionValue = m_positionMonitor->calculateTotalPositionValue();
+    double totalPositionValue = totals.exposure;
     if (totalPositionValue > m_riskLimits->maxTotalValue) {
         generateRiskEvent(RiskLevel::HIGH,
                          "Total position value exceeds limit: " + std::to_string(totalPositionValue) + 
@@ -107,16 +113,18 @@ RiskLevel RiskManager::evaluateSystemRisk() {
     }
 
     // 检查是否有单一品种持仓比例过高
-    auto allPositions = m_positionMonitor->getAllPositions();
-    for (const auto& pair : allPositions) {
-        PositionPtr position = pair.second;
-        double positionValue = std::abs(static_cast<double>(position->quantity) * position->currentPrice);
-        if (totalPositionValue > 0 && positionValue / totalPositionValue > m_riskLimits->maxSinglePosition) {
-            generateRiskEvent(RiskLevel::MEDIUM,
-                             "Position concentration exceeds limit for symbol: " + position->symbol,
-                             RiskAction::REDUCE_POSITION);
-            return RiskLevel::MEDIUM;
+    core::SymbolId concentrated = core::kInvalidSymbol;
+    book.forEachPosition([&](const PositionSnapshot& position) {
+        if (concentrated == core::kInvalidSymbol && totalPositionValue > 0 &&
+            position.exposure / totalPositionValue > m_riskLimits->maxSinglePosition) {
+            concentrated = position.symbolId;
         }
+    });
+    if (concentrated != core::kInvalidSymbol) {
+        generateRiskEvent(RiskLevel::MEDIUM,
+                         "Position concentration exceeds limit for symbol: " + std::string(core::symbolName(concentrated)),
+                         RiskAction::REDUCE_POSITION);
+        return RiskLevel::MEDIUM;
     }
 
     return RiskLevel::LOW;
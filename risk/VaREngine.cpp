@@ -0,0 +1,263 @@
+#include "VaREngine.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace hft {
+namespace risk {
+
+namespace {
+
+constexpr uint32_t kPhiloxM0 = 0xD2511F53u;
+constexpr uint32_t kPhiloxM1 = 0xCD9E8D57u;
+constexpr uint32_t kPhiloxW0 = 0x9E3779B9u;
+constexpr uint32_t kPhiloxW1 = 0xBB67AE85u;
+constexpr int kPhiloxRounds = 10;
+
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+constexpr double kInv32 = 1.0 / 4294967296.0;
+
+// 每个线程至少分到的路径数，路径太少时多线程得不偿失
+constexpr size_t kMinPathsPerThread = 4096;
+
+size_t tailIndexFor(size_t size, double confidenceLevel) {
+    double position = (1.0 - confidenceLevel) * static_cast<double>(size);
+    size_t index = position > 0.0 ? static_cast<size_t>(position) : 0;
+    return index < size ? index : size - 1;
+}
+
+} // namespace
+
+void Philox4x32::generate(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+    uint32_t x0 = counter[0], x1 = counter[1], x2 = counter[2], x3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < kPhiloxRounds; ++round) {
+        const uint64_t p0 = static_cast<uint64_t>(kPhiloxM0) * x0;
+        const uint64_t p1 = static_cast<uint64_t>(kPhiloxM1) * x2;
+        const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ x1 ^ k0;
+        const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ x3 ^ k1;
+        x1 = static_cast<uint32_t>(p1);
+        x3 = static_cast<uint32_t>(p0);
+        x0 = n0;
+        x2 = n2;
+        k0 += kPhiloxW0;
+        k1 += kPhiloxW1;
+    }
+    out[0] = x0;
+    out[1] = x1;
+    out[2] = x2;
+    out[3] = x3;
+}
+
+void Philox4x32::generateLanes(const uint32_t c0[kLanes], uint32_t c1, uint32_t c2, const uint32_t key[2],
+                               uint32_t out[4][kLanes]) {
+    uint32_t x0[kLanes], x1[kLanes], x2[kLanes], x3[kLanes];
+    for (size_t i = 0; i < kLanes; ++i) {
+        x0[i] = c0[i];
+        x1[i] = c1;
+        x2[i] = c2;
+        x3[i] = 0;
+    }
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < kPhiloxRounds; ++round) {
+        // 各通道互不依赖，内层循环可整体向量化（32x32->64位乘法）
+        for (size_t i = 0; i < kLanes; ++i) {
+            const uint64_t p0 = static_cast<uint64_t>(kPhiloxM0) * x0[i];
+            const uint64_t p1 = static_cast<uint64_t>(kPhiloxM1) * x2[i];
+            const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ x1[i] ^ k0;
+            const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ x3[i] ^ k1;
+            x1[i] = static_cast<uint32_t>(p1);
+            x3[i] = static_cast<uint32_t>(p0);
+            x0[i] = n0;
+            x2[i] = n2;
+        }
+        k0 += kPhiloxW0;
+        k1 += kPhiloxW1;
+    }
+    for (size_t i = 0; i < kLanes; ++i) {
+        out[0][i] = x0[i];
+        out[1][i] = x1[i];
+        out[2][i] = x2[i];
+        out[3][i] = x3[i];
+    }
+}
+
+VaRResult tailRisk(double* data, size_t size, double confidenceLevel) {
+    VaRResult result;
+    result.samples = size;
+    if (size == 0) {
+        return result;
+    }
+    const size_t index = tailIndexFor(size, confidenceLevel);
+    std::nth_element(data, data + index, data + size);
+    // nth_element之后[0, index)均不大于data[index]，即为尾部
+    double tail = 0.0;
+    for (size_t i = 0; i <= index; ++i) {
+        tail += data[i];
+    }
+    result.var = -data[index];
+    result.cvar = -tail / static_cast<double>(index + 1);
+    return result;
+}
+
+// --- RollingHistoricalVaR ---
+
+RollingHistoricalVaR::RollingHistoricalVaR(size_t window, double confidenceLevel)
+    : m_window(window > 0 ? window : 1), m_confidence(confidenceLevel), m_head(0) {
+    m_ring.reserve(m_window);
+    m_sorted.reserve(m_window);
+}
+
+void RollingHistoricalVaR::add(double value) {
+    if (m_ring.size() < m_window) {
+        m_ring.push_back(value);
+    } else {
+        // 淘汰最早的样本
+        const double expired = m_ring[m_head];
+        m_sorted.erase(std::lower_bound(m_sorted.begin(), m_sorted.end(), expired));
+        m_ring[m_head] = value;
+        m_head = (m_head + 1) % m_window;
+    }
+    m_sorted.insert(std::upper_bound(m_sorted.begin(), m_sorted.end(), value), value);
+}
+
+void RollingHistoricalVaR::clear() {
+    m_ring.clear();
+    m_sorted.clear();
+    m_head = 0;
+}
+
+size_t RollingHistoricalVaR::tailIndex() const {
+    return tailIndexFor(m_sorted.size(), m_confidence);
+}
+
+double RollingHistoricalVaR::var() const {
+    return m_sorted.empty() ? 0.0 : -m_sorted[tailIndex()];
+}
+
+double RollingHistoricalVaR::cvar() const {
+    if (m_sorted.empty()) {
+        return 0.0;
+    }
+    const size_t index = tailIndex();
+    double tail = 0.0;
+    for (size_t i = 0; i <= index; ++i) {
+        tail += m_sorted[i];
+    }
+    return -tail / static_cast<double>(index + 1);
+}
+
+// --- MonteCarloVaREngine ---
+
+MonteCarloVaREngine::MonteCarloVaREngine() : m_assets(0), m_drift(0.0) {
+}
+
+bool MonteCarloVaREngine::setPortfolio(const std::vector<double>& exposures, const std::vector<double>& means,
+                                       const std::vector<double>& volatilities, const std::vector<double>& correlation) {
+    const size_t n = exposures.size();
+    if (n == 0 || means.size() != n || volatilities.size() != n || correlation.size() != n * n) {
+        return false;
+    }
+
+    // 协方差矩阵的Cholesky分解（下三角，行优先）
+    std::vector<double> lower(n * n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            double sum = volatilities[i] * volatilities[j] * correlation[i * n + j];
+            for (size_t k = 0; k < j; ++k) {
+                sum -= lower[i * n + k] * lower[j * n + k];
+            }
+            if (i == j) {
+                if (sum < 0.0) {
+                    return false;
+                }
+                lower[i * n + i] = std::sqrt(sum);
+            } else {
+                lower[i * n + j] = lower[j * n + j] > 0.0 ? sum / lower[j * n + j] : 0.0;
+            }
+        }
+    }
+
+    // b_j = Σ_i L_ij × 敞口_i，补齐到4的倍数，与每次生成的4个正态数对应
+    m_assets = n;
+    m_loadings.assign((n + 3) & ~size_t{3}, 0.0);
+    m_drift = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        m_drift += exposures[i] * means[i];
+        for (size_t j = 0; j <= i; ++j) {
+            m_loadings[j] += lower[i * n + j] * exposures[i];
+        }
+    }
+    return true;
+}
+
+void MonteCarloVaREngine::simulateRange(size_t first, size_t last, uint64_t seed, double* out) const {
+    constexpr size_t kLanes = Philox4x32::kLanes;
+    const uint32_t key[2] = {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    const size_t blocks = m_loadings.size() / 4;
+
+    uint32_t counter[kLanes];
+    uint32_t bits[4][kLanes];
+    double pnl[kLanes];
+    for (size_t base = first; base < last; base += kLanes) {
+        for (size_t i = 0; i < kLanes; ++i) {
+            counter[i] = static_cast<uint32_t>(base + i);
+            pnl[i] = m_drift;
+        }
+        const uint32_t high = static_cast<uint32_t>(static_cast<uint64_t>(base) >> 32);
+
+        for (size_t block = 0; block < blocks; ++block) {
+            Philox4x32::generateLanes(counter, high, static_cast<uint32_t>(block), key, bits);
+            const double* b = &m_loadings[block * 4];
+            // Box-Muller：每4个32位随机数得到4个标准正态数
+            for (size_t i = 0; i < kLanes; ++i) {
+                const double u0 = (static_cast<double>(bits[0][i]) + 1.0) * kInv32;
+                const double u1 = static_cast<double>(bits[1][i]) * kInv32;
+                const double u2 = (static_cast<double>(bits[2][i]) + 1.0) * kInv32;
+                const double u3 = static_cast<double>(bits[3][i]) * kInv32;
+                const double r0 = std::sqrt(-2.0 * std::log(u0));
+                const double r1 = std::sqrt(-2.0 * std::log(u2));
+                pnl[i] += b[0] * r0 * std::cos(kTwoPi * u1) + b[1] * r0 * std::sin(kTwoPi * u1) +
+                          b[2] * r1 * std::cos(kTwoPi * u3) + b[3] * r1 * std::sin(kTwoPi * u3);
+            }
+        }
+
+        const size_t count = std::min(kLanes, last - base);
+        std::copy(pnl, pnl + count, out + (base - first));
+    }
+}
+
+VaRResult MonteCarloVaREngine::simulate(size_t numPaths, double confidenceLevel, uint64_t seed, unsigned threads) {
+    if (m_assets == 0 || numPaths == 0) {
+        return VaRResult();
+    }
+    m_pnl.resize(numPaths);
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t workers = std::min<size_t>(threads, std::max<size_t>(1, numPaths / kMinPathsPerThread));
+    // 每个线程的区间按通道数对齐，保证路径号与单线程时一致
+    size_t chunk = (numPaths + workers - 1) / workers;
+    chunk = (chunk + Philox4x32::kLanes - 1) / Philox4x32::kLanes * Philox4x32::kLanes;
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (size_t w = 1; w < workers; ++w) {
+        const size_t first = w * chunk;
+        if (first >= numPaths) {
+            break;
+        }
+        const size_t last = std::min(numPaths, first + chunk);
+        pool.emplace_back([this, first, last, seed] { simulateRange(first, last, seed, m_pnl.data() + first); });
+    }
+    simulateRange(0, std::min(numPaths, chunk), seed, m_pnl.data());
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    return tailRisk(m_pnl.data(), numPaths, confidenceLevel);
+}
+
+} // namespace risk
+} // namespace hft
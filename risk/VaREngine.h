@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hft {
+namespace risk {
+
+// Philox4x32-10计数器随机数发生器
+// 输出只由(计数器, 密钥)决定，不保存状态：任意路径、任意线程可直接跳到自己的计数器，
+// 结果与线程数无关且可复现。批量接口按通道展开，便于编译器向量化。
+struct Philox4x32 {
+    static constexpr size_t kLanes = 8;
+
+    // 单个计数器生成4个32位随机数
+    static void generate(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+    // kLanes个计数器并行生成：第i个通道的计数器为(c0[i], c1, c2, 0)
+    static void generateLanes(const uint32_t c0[kLanes], uint32_t c1, uint32_t c2, const uint32_t key[2],
+                              uint32_t out[4][kLanes]);
+};
+
+// VaR/CVaR结果，均以正数表示损失
+struct VaRResult {
+    double var = 0.0;
+    double cvar = 0.0;
+    size_t samples = 0;
+};
+
+// 基于部分排序的分位数：只做一次nth_element，不做全排序；会重排data
+VaRResult tailRisk(double* data, size_t size, double confidenceLevel);
+
+// 滚动窗口历史VaR
+// 窗口内收益同时保存在环形缓冲区和有序数组中，新增/淘汰一个样本只需二分定位和一次内存移动，
+// 查询VaR为O(1)，CVaR只累加尾部样本。
+class RollingHistoricalVaR {
+public:
+    RollingHistoricalVaR(size_t window, double confidenceLevel);
+
+    void add(double value);
+    void clear();
+
+    double var() const;
+    double cvar() const;
+    size_t size() const { return m_sorted.size(); }
+    size_t window() const { return m_window; }
+
+private:
+    size_t tailIndex() const;
+
+    size_t m_window;
+    double m_confidence;
+    std::vector<double> m_ring;     // 按到达顺序
+    size_t m_head;                  // 最早样本的位置
+    std::vector<double> m_sorted;   // 升序
+};
+
+// 多资产蒙特卡洛VaR
+//
+// 组合盈亏 = Σ 敞口_i × 收益_i，收益服从多元正态 μ + L·z（L为协方差的Cholesky分解）。
+// 对线性组合先算出因子载荷 b = Lᵀ·敞口，每条路径只需一次长度为n的点积，而不是n×n的矩阵乘。
+// 路径按块分给多个线程，随机数由Philox按(路径号, 资产块)生成，结果与线程数无关。
+class MonteCarloVaREngine {
+public:
+    MonteCarloVaREngine();
+
+    // 设置组合：敞口（金额）、收益均值、波动率、相关系数矩阵（n×n行优先）
+    // 相关矩阵非正定时返回false
+    bool setPortfolio(const std::vector<double>& exposures, const std::vector<double>& means,
+                      const std::vector<double>& volatilities, const std::vector<double>& correlation);
+
+    // 模拟组合盈亏并计算VaR/CVaR；threads为0时使用全部硬件线程
+    VaRResult simulate(size_t numPaths, double confidenceLevel, uint64_t seed, unsigned threads = 0);
+
+    size_t assets() const { return m_assets; }
+
+private:
+    void simulateRange(size_t first, size_t last, uint64_t seed, double* out) const;
+
+    size_t m_assets;
+    double m_drift;                 // Σ 敞口_i × μ_i
+    std::vector<double> m_loadings; // 因子载荷 b = Lᵀ·敞口，按4个对齐补零
+    std::vector<double> m_pnl;      // 复用的模拟结果缓冲区
+};
+
+} // namespace risk
+} // namespace hft
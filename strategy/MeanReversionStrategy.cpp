@@ -1,7 +1,6 @@
 #include "MeanReversionStrategy.h"
 #include <iostream>
 #include <algorithm>
-#include <numeric>
 #include <cmath>
 #include "execution/Order.h"
 #include "core/Configuration.h"
@@ -11,6 +10,8 @@ namespace strategy {
 
 MeanReversionStrategy::MeanReversionStrategy()
     : Strategy("MeanReversionStrategy", StrategyType::MEAN_REVERSION),
+      m_price_stats(20),
+      m_last_price(0.0),
       m_lookback_period(20),
       m_std_dev_threshold(2.0) {
 }
@@ -25,6 +26,7 @@ bool MeanReversionStrategy::initialize(const std::string& configPath) {
 
     m_lookback_period = config.getInt("lookback_period", 20);
     m_std_dev_threshold = config.getDouble("std_dev_threshold", 2.0);
+    m_price_stats = analysis::RollingStats<double>(m_lookback_period);
 
     std::cout << "MeanReversionStrategy initialized with lookback_period=" << m_lookback_period 
               << ", std_dev_threshold=" << m_std_dev_threshold << std::endl;
@@ -43,13 +45,8 @@ void MeanReversionStrategy::stop() {
 
 void MeanReversionStrategy::onMarketData(const network::MarketData& data) {
     if (!data.trades.empty()) {
-        double last_price = data.trades.back().price;
-        m_price_history.push_back(last_price);
-
-        // 保持历史窗口大小
-        if (m_price_history.size() > m_lookback_period) {
-            m_price_history.pop_front();
-        }
+        m_last_price = data.trades.back().price;
+        m_price_stats.update(m_last_price);
     }
 }
 
@@ -60,12 +57,12 @@ void MeanReversionStrategy::onMarketPattern(const pattern::MarketPattern& patter
 std::vector<execution::Order> MeanReversionStrategy::execute() {
     std::vector<execution::Order> orders;
 
-    if (!m_active || m_price_history.size() < m_lookback_period) {
+    if (!m_active || !m_price_stats.ready()) {
         return orders;
     }
 
     double z_score = calculateZScore();
-    double current_price = m_price_history.back();
+    double current_price = m_last_price;
 
     // 生成交易信号
     if (z_score > m_std_dev_threshold) {
@@ -96,27 +93,15 @@ std::vector<execution::Order> MeanReversionStrategy::execute() {
 }
 
 double MeanReversionStrategy::calculateMovingAverage() const {
-    double sum = std::accumulate(m_price_history.begin(), m_price_history.end(), 0.0);
-    return sum / m_price_history.size();
+    return m_price_stats.mean();
 }
 
 double MeanReversionStrategy::calculateStdDev() const {
-    double mean = calculateMovingAverage();
-    double variance = 0.0;
-
-    for (double price : m_price_history) {
-        variance += std::pow(price - mean, 2);
-    }
-
-    return std::sqrt(variance / m_price_history.size());
+    return m_price_stats.stddev();
 }
 
 double MeanReversionStrategy::calculateZScore() const {
-    double mean = calculateMovingAverage();
-    double std_dev = calculateStdDev();
-    double current_price = m_price_history.back();
-
-    return (current_price - mean) / std_dev;
+    return m_price_stats.zscore(m_last_price);
 }
 
 // 注册策略
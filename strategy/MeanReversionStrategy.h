@@ -1,7 +1,7 @@
 #pragma once
 #include "Strategy.h"
+#include "analysis/StreamingIndicators.h"
 #include <vector>
-#include <deque>
 
 namespace hft {
 namespace strategy {
@@ -30,7 +30,8 @@ public:
     std::vector<execution::Order> execute() override;
 
 private:
-    std::deque<double> m_price_history;
+    analysis::RollingStats<double> m_price_stats;   // 回溯窗口内的均值/标准差，O(1)更新
+    double m_last_price;
     uint32_t m_lookback_period;
     double m_std_dev_threshold;
 
@@ -0,0 +1,260 @@
+#include "SignalEngine.h"
+#include <cstring>
+#if HFT_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace hft {
+namespace strategy {
+
+namespace {
+
+constexpr float kBps = 10000.0f;
+
+inline size_t roundUpLanes(size_t n) {
+    return (n + TopOfBookSoA::kLaneBlock - 1) / TopOfBookSoA::kLaneBlock * TopOfBookSoA::kLaneBlock;
+}
+
+// 标量内核，也是SIMD内核的参照：各内核的运算顺序相同
+size_t signalScalar(const TopOfBookSoA& book, size_t lanes, const SignalParams& params,
+                    float* score, uint64_t* buyMask, uint64_t* sellMask) {
+    const float* bidPrice = book.bidPrice();
+    const float* askPrice = book.askPrice();
+    const float* bidSize = book.bidSize();
+    const float* askSize = book.askSize();
+    const float* reference = book.reference();
+    size_t signals = 0;
+
+    for (size_t i = 0; i < lanes; ++i) {
+        const float bid = bidPrice[i];
+        const float ask = askPrice[i];
+        const float depth = bidSize[i] + askSize[i];
+        if (!(bid > 0.0f && ask > bid && depth > 0.0f)) {
+            score[i] = 0.0f;
+            continue;
+        }
+        const float mid = (bid + ask) * 0.5f;
+        const float spreadBps = (ask - bid) * kBps / mid;
+        const float imbalance = (bidSize[i] - askSize[i]) / depth;
+        const float deviation = reference[i] > 0.0f ? (reference[i] - mid) * kBps / mid : 0.0f;
+        const float s = params.imbalanceWeight * imbalance + params.deviationWeight * deviation;
+        score[i] = s;
+
+        if (spreadBps <= params.maxSpreadBps) {
+            const uint64_t bit = uint64_t{1} << (i % 64);
+            if (s > params.buyThreshold) {
+                buyMask[i / 64] |= bit;
+                ++signals;
+            } else if (s < -params.sellThreshold) {
+                sellMask[i / 64] |= bit;
+                ++signals;
+            }
+        }
+    }
+    return signals;
+}
+
+#if HFT_SIMD_DISPATCH
+
+HFT_TARGET_AVX2 size_t signalAvx2(const TopOfBookSoA& book, size_t lanes, const SignalParams& params,
+                                  float* score, uint64_t* buyMask, uint64_t* sellMask) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 bps = _mm256_set1_ps(kBps);
+    const __m256 imbalanceWeight = _mm256_set1_ps(params.imbalanceWeight);
+    const __m256 deviationWeight = _mm256_set1_ps(params.deviationWeight);
+    const __m256 buyThreshold = _mm256_set1_ps(params.buyThreshold);
+    const __m256 sellThreshold = _mm256_set1_ps(-params.sellThreshold);
+    const __m256 maxSpread = _mm256_set1_ps(params.maxSpreadBps);
+    size_t signals = 0;
+
+    for (size_t i = 0; i < lanes; i += 8) {
+        const __m256 bid = _mm256_load_ps(book.bidPrice() + i);
+        const __m256 ask = _mm256_load_ps(book.askPrice() + i);
+        const __m256 bidSize = _mm256_load_ps(book.bidSize() + i);
+        const __m256 askSize = _mm256_load_ps(book.askSize() + i);
+        const __m256 reference = _mm256_load_ps(book.reference() + i);
+        const __m256 depth = _mm256_add_ps(bidSize, askSize);
+
+        const __m256 valid = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(bid, zero, _CMP_GT_OQ), _mm256_cmp_ps(ask, bid, _CMP_GT_OQ)),
+            _mm256_cmp_ps(depth, zero, _CMP_GT_OQ));
+        const __m256 mid = _mm256_mul_ps(_mm256_add_ps(bid, ask), half);
+        const __m256 spreadBps = _mm256_div_ps(_mm256_mul_ps(_mm256_sub_ps(ask, bid), bps), mid);
+        const __m256 imbalance = _mm256_div_ps(_mm256_sub_ps(bidSize, askSize), depth);
+        const __m256 deviation = _mm256_and_ps(
+            _mm256_div_ps(_mm256_mul_ps(_mm256_sub_ps(reference, mid), bps), mid),
+            _mm256_cmp_ps(reference, zero, _CMP_GT_OQ));
+        // 无效通道的NaN/Inf由valid掩掉
+        const __m256 s = _mm256_and_ps(
+            _mm256_add_ps(_mm256_mul_ps(imbalanceWeight, imbalance), _mm256_mul_ps(deviationWeight, deviation)),
+            valid);
+        _mm256_store_ps(score + i, s);
+
+        const __m256 eligible = _mm256_and_ps(valid, _mm256_cmp_ps(spreadBps, maxSpread, _CMP_LE_OQ));
+        const uint64_t buy = static_cast<uint64_t>(
+            _mm256_movemask_ps(_mm256_and_ps(eligible, _mm256_cmp_ps(s, buyThreshold, _CMP_GT_OQ))));
+        const uint64_t sell = static_cast<uint64_t>(
+            _mm256_movemask_ps(_mm256_and_ps(eligible, _mm256_cmp_ps(s, sellThreshold, _CMP_LT_OQ))));
+        buyMask[i / 64] |= buy << (i % 64);
+        sellMask[i / 64] |= sell << (i % 64);
+        signals += static_cast<size_t>(__builtin_popcountll(buy | sell));
+    }
+    return signals;
+}
+
+HFT_TARGET_AVX512 size_t signalAvx512(const TopOfBookSoA& book, size_t lanes, const SignalParams& params,
+                                      float* score, uint64_t* buyMask, uint64_t* sellMask) {
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 half = _mm512_set1_ps(0.5f);
+    const __m512 bps = _mm512_set1_ps(kBps);
+    const __m512 imbalanceWeight = _mm512_set1_ps(params.imbalanceWeight);
+    const __m512 deviationWeight = _mm512_set1_ps(params.deviationWeight);
+    const __m512 buyThreshold = _mm512_set1_ps(params.buyThreshold);
+    const __m512 sellThreshold = _mm512_set1_ps(-params.sellThreshold);
+    const __m512 maxSpread = _mm512_set1_ps(params.maxSpreadBps);
+    size_t signals = 0;
+
+    for (size_t i = 0; i < lanes; i += 16) {
+        const __m512 bid = _mm512_load_ps(book.bidPrice() + i);
+        const __m512 ask = _mm512_load_ps(book.askPrice() + i);
+        const __m512 bidSize = _mm512_load_ps(book.bidSize() + i);
+        const __m512 askSize = _mm512_load_ps(book.askSize() + i);
+        const __m512 reference = _mm512_load_ps(book.reference() + i);
+        const __m512 depth = _mm512_add_ps(bidSize, askSize);
+
+        const __mmask16 valid = _mm512_cmp_ps_mask(bid, zero, _CMP_GT_OQ) &
+                                _mm512_cmp_ps_mask(ask, bid, _CMP_GT_OQ) &
+                                _mm512_cmp_ps_mask(depth, zero, _CMP_GT_OQ);
+        const __mmask16 hasReference = valid & _mm512_cmp_ps_mask(reference, zero, _CMP_GT_OQ);
+        const __m512 mid = _mm512_mul_ps(_mm512_add_ps(bid, ask), half);
+        const __m512 spreadBps = _mm512_maskz_div_ps(valid, _mm512_mul_ps(_mm512_sub_ps(ask, bid), bps), mid);
+        const __m512 imbalance = _mm512_maskz_div_ps(valid, _mm512_sub_ps(bidSize, askSize), depth);
+        const __m512 deviation = _mm512_maskz_div_ps(hasReference,
+                                                     _mm512_mul_ps(_mm512_sub_ps(reference, mid), bps), mid);
+        const __m512 s = _mm512_add_ps(_mm512_mul_ps(imbalanceWeight, imbalance),
+                                       _mm512_mul_ps(deviationWeight, deviation));
+        _mm512_store_ps(score + i, s);
+
+        const __mmask16 eligible = valid & _mm512_cmp_ps_mask(spreadBps, maxSpread, _CMP_LE_OQ);
+        const uint64_t buy = eligible & _mm512_cmp_ps_mask(s, buyThreshold, _CMP_GT_OQ);
+        const uint64_t sell = eligible & _mm512_cmp_ps_mask(s, sellThreshold, _CMP_LT_OQ);
+        buyMask[i / 64] |= buy << (i % 64);
+        sellMask[i / 64] |= sell << (i % 64);
+        signals += static_cast<size_t>(__builtin_popcountll(buy | sell));
+    }
+    return signals;
+}
+
+#endif // HFT_SIMD_DISPATCH
+
+} // namespace
+
+TopOfBookSoA::TopOfBookSoA(size_t maxSymbols)
+    : m_capacity(roundUpLanes(maxSymbols)),
+      m_activeLanes(0),
+      m_bidPrice(m_capacity),
+      m_askPrice(m_capacity),
+      m_bidSize(m_capacity),
+      m_askSize(m_capacity),
+      m_reference(m_capacity) {
+}
+
+bool TopOfBookSoA::update(core::SymbolId symbol, float bidPrice, float bidSize, float askPrice, float askSize) {
+    if (symbol >= m_capacity) {
+        return false;
+    }
+    m_bidPrice[symbol] = bidPrice;
+    m_bidSize[symbol] = bidSize;
+    m_askPrice[symbol] = askPrice;
+    m_askSize[symbol] = askSize;
+    if (symbol >= m_activeLanes) {
+        m_activeLanes = roundUpLanes(symbol + 1);
+    }
+    return true;
+}
+
+bool TopOfBookSoA::setReference(core::SymbolId symbol, float reference) {
+    if (symbol >= m_capacity) {
+        return false;
+    }
+    m_reference[symbol] = reference;
+    return true;
+}
+
+void TopOfBookSoA::clear(core::SymbolId symbol) {
+    if (symbol < m_capacity) {
+        m_bidPrice[symbol] = m_askPrice[symbol] = 0.0f;
+        m_bidSize[symbol] = m_askSize[symbol] = 0.0f;
+        m_reference[symbol] = 0.0f;
+    }
+}
+
+SignalKernel selectSignalKernel(utils::SimdLevel level) {
+#if HFT_SIMD_DISPATCH
+    switch (level) {
+        case utils::SimdLevel::AVX512: return &signalAvx512;
+        case utils::SimdLevel::AVX2: return &signalAvx2;
+        default: break;
+    }
+#else
+    (void)level;
+#endif
+    return &signalScalar;
+}
+
+CrossSectionalSignalEngine::CrossSectionalSignalEngine(size_t maxSymbols, utils::SimdLevel level)
+    : m_book(maxSymbols),
+      m_level(level > utils::detectSimdLevel() ? utils::detectSimdLevel() : level),
+      m_kernel(selectSignalKernel(m_level)),
+      m_score(m_book.capacity()),
+      m_buyMask(m_book.capacity() / 64),
+      m_sellMask(m_book.capacity() / 64),
+      m_nextOrderId(1) {
+}
+
+size_t CrossSectionalSignalEngine::evaluate() {
+    const size_t lanes = m_book.activeLanes();
+    if (lanes == 0) {
+        return 0;
+    }
+    std::memset(m_buyMask.data(), 0, lanes / 64 * sizeof(uint64_t));
+    std::memset(m_sellMask.data(), 0, lanes / 64 * sizeof(uint64_t));
+    return m_kernel(m_book, lanes, m_params, m_score.data(), m_buyMask.data(), m_sellMask.data());
+}
+
+size_t CrossSectionalSignalEngine::generateOrders(uint64_t quantity, uint32_t strategyId,
+                                                  std::vector<OrderRecord>& orders) {
+    const size_t signals = evaluate();
+    if (signals == 0) {
+        return 0;
+    }
+
+    const size_t words = m_book.activeLanes() / 64;
+    for (size_t w = 0; w < words; ++w) {
+        for (int pass = 0; pass < 2; ++pass) {
+            const bool buy = pass == 0;
+            uint64_t bits = buy ? m_buyMask[w] : m_sellMask[w];
+            while (bits) {
+                const core::SymbolId symbol = static_cast<core::SymbolId>(w * 64 + __builtin_ctzll(bits));
+                bits &= bits - 1;
+
+                OrderRecord order;
+                std::memset(&order, 0, sizeof(order));
+                order.orderId = m_nextOrderId++;
+                order.symbolId = symbol;
+                order.type = OrderType::LIMIT;
+                order.side = buy ? OrderSide::BUY : OrderSide::SELL;
+                order.status = OrderStatus::PENDING_NEW;
+                order.strategyId = strategyId;
+                order.quantity = quantity;
+                order.price = buy ? m_book.askPrice()[symbol] : m_book.bidPrice()[symbol];
+                orders.push_back(order);
+            }
+        }
+    }
+    return signals;
+}
+
+} // namespace strategy
+} // namespace hft
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "core/SymbolRegistry.h"
+#include "execution/Order.h"
+#include "utils/SimdSupport.h"
+
+namespace hft {
+namespace strategy {
+
+// 横截面信号参数
+//   score = imbalanceWeight × 一档挂单失衡 + deviationWeight × 参考价偏离(bp)
+//   一档挂单失衡 = (买一量 - 卖一量) / (买一量 + 卖一量)，取值[-1, 1]
+//   参考价偏离 = (参考价 - 中间价) / 中间价 × 10000，未设置参考价时为0
+struct SignalParams {
+    float imbalanceWeight = 1.0f;
+    float deviationWeight = 0.0f;
+    float buyThreshold = 0.5f;      // score > buyThreshold 买入
+    float sellThreshold = 0.5f;     // score < -sellThreshold 卖出
+    float maxSpreadBps = 50.0f;     // 价差超过此值的品种不出信号
+};
+
+// 一档行情的列式存储，按SymbolId下标，每列64字节对齐，长度补齐到kLaneBlock的倍数。
+// 未更新过行情的品种价格为0，在内核中视为无效。
+class TopOfBookSoA {
+public:
+    static constexpr size_t kLaneBlock = 64;
+
+    explicit TopOfBookSoA(size_t maxSymbols);
+
+    // 品种ID超出容量返回false
+    bool update(core::SymbolId symbol, float bidPrice, float bidSize, float askPrice, float askSize);
+    bool setReference(core::SymbolId symbol, float reference);
+    void clear(core::SymbolId symbol);
+
+    const float* bidPrice() const { return m_bidPrice.data(); }
+    const float* askPrice() const { return m_askPrice.data(); }
+    const float* bidSize() const { return m_bidSize.data(); }
+    const float* askSize() const { return m_askSize.data(); }
+    const float* reference() const { return m_reference.data(); }
+
+    size_t capacity() const { return m_capacity; }
+    // 需要扫描的长度：最大已用品种ID+1，补齐到kLaneBlock
+    size_t activeLanes() const { return m_activeLanes; }
+
+private:
+    size_t m_capacity;
+    size_t m_activeLanes;
+    utils::AlignedArray<float> m_bidPrice;
+    utils::AlignedArray<float> m_askPrice;
+    utils::AlignedArray<float> m_bidSize;
+    utils::AlignedArray<float> m_askSize;
+    utils::AlignedArray<float> m_reference;
+};
+
+// 信号内核：处理lanes个通道（kLaneBlock的倍数），写出每个通道的score与买/卖位图，返回信号数
+using SignalKernel = size_t (*)(const TopOfBookSoA& book, size_t lanes, const SignalParams& params,
+                                float* score, uint64_t* buyMask, uint64_t* sellMask);
+
+// 返回指定指令集的内核；该指令集未编译进来时退回标量
+SignalKernel selectSignalKernel(utils::SimdLevel level);
+
+// 横截面信号引擎
+//
+// 每个tick对全部订阅品种做一次向量化扫描（AVX-512一次16个品种，AVX2一次8个），
+// 结果以位图表示，只对越过阈值的品种按位遍历生成订单，没有逐品种的虚函数调用。
+// 指令集在构造时按CPU检测结果选择。单线程使用。
+class CrossSectionalSignalEngine {
+public:
+    explicit CrossSectionalSignalEngine(size_t maxSymbols, utils::SimdLevel level = utils::detectSimdLevel());
+
+    TopOfBookSoA& book() { return m_book; }
+    const TopOfBookSoA& book() const { return m_book; }
+
+    SignalParams& params() { return m_params; }
+    const SignalParams& params() const { return m_params; }
+
+    // 计算全部品种的信号，返回信号数
+    size_t evaluate();
+
+    // 计算信号并为越过阈值的品种生成限价单（买单挂卖一价，卖单挂买一价），追加到orders
+    size_t generateOrders(uint64_t quantity, uint32_t strategyId, std::vector<OrderRecord>& orders);
+
+    // 上次evaluate的结果
+    float score(core::SymbolId symbol) const { return symbol < m_score.size() ? m_score[symbol] : 0.0f; }
+    bool isBuy(core::SymbolId symbol) const { return testBit(m_buyMask, symbol); }
+    bool isSell(core::SymbolId symbol) const { return testBit(m_sellMask, symbol); }
+
+    utils::SimdLevel simdLevel() const { return m_level; }
+
+private:
+    static bool testBit(const utils::AlignedArray<uint64_t>& mask, core::SymbolId symbol) {
+        return symbol / 64 < mask.size() && (mask[symbol / 64] >> (symbol % 64) & 1);
+    }
+
+    TopOfBookSoA m_book;
+    SignalParams m_params;
+    utils::SimdLevel m_level;
+    SignalKernel m_kernel;
+    utils::AlignedArray<float> m_score;
+    utils::AlignedArray<uint64_t> m_buyMask;
+    utils::AlignedArray<uint64_t> m_sellMask;
+    uint64_t m_nextOrderId;
+};
+
+} // namespace strategy
+} // namespace hft
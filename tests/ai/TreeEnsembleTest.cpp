@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+#include "ai/TreeEnsemble.h"
+
+using namespace hft;
+using namespace hft::ai;
+
+namespace {
+
+struct Lcg {
+    uint32_t state;
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+    double uniform(double low, double high) { return low + (high - low) * (next() / 16777216.0); }
+};
+
+int32_t randomNode(TreeEnsembleTree& tree, Lcg& rng, uint32_t featureCount, int depth) {
+    const int32_t index = static_cast<int32_t>(tree.nodes.size());
+    tree.nodes.emplace_back();
+    if (depth == 0 || rng.next() % 5 == 0) {
+        tree.nodes[index].leafValue = rng.uniform(-1.0, 1.0);
+        return index;
+    }
+    TreeEnsembleNode node;
+    node.feature = static_cast<int32_t>(rng.next() % featureCount);
+    // 阈值取0.25的整数倍，输入会精确落在阈值上；另有一部分不是float可表示的值
+    node.threshold = rng.next() % 2 ? std::floor(rng.uniform(-8.0, 8.0)) * 0.25 : rng.uniform(-2.0, 2.0);
+    node.defaultLeft = rng.next() % 2 == 0;
+    // 先建右子树，节点顺序与广度优先不同
+    node.right = randomNode(tree, rng, featureCount, depth - 1);
+    node.left = randomNode(tree, rng, featureCount, depth - 1);
+    tree.nodes[index] = node;
+    return index;
+}
+
+TreeEnsembleSpec randomSpec(SplitCompare compare, uint32_t seed) {
+    Lcg rng{seed};
+    TreeEnsembleSpec spec;
+    spec.featureCount = 24;
+    spec.outputCount = 3;
+    spec.compare = compare;
+    spec.baseScore = 0.5;
+    spec.transform = pattern::OutputTransform::NONE;
+    for (int t = 0; t < 60; ++t) {
+        TreeEnsembleTree tree;
+        tree.output = t % 3;
+        tree.root = randomNode(tree, rng, spec.featureCount, 1 + t % 8);
+        spec.trees.push_back(tree);
+    }
+    return spec;
+}
+
+// 直接在解析结果上按原始阈值逐行求值
+std::vector<float> referenceScore(const TreeEnsembleSpec& spec, const float* x) {
+    std::vector<float> sum(spec.outputCount, static_cast<float>(spec.baseScore));
+    for (const TreeEnsembleTree& tree : spec.trees) {
+        const TreeEnsembleNode* node = &tree.nodes[tree.root];
+        while (node->feature >= 0) {
+            const double value = x[node->feature];
+            bool left;
+            if (std::isnan(value)) {
+                left = node->defaultLeft;
+            } else {
+                left = spec.compare == SplitCompare::LESS ? value < node->threshold : value <= node->threshold;
+            }
+            node = &tree.nodes[left ? node->left : node->right];
+        }
+        sum[tree.output] += static_cast<float>(node->leafValue);
+    }
+    return sum;
+}
+
+std::vector<float> randomRows(size_t rows, size_t featureCount, uint32_t seed) {
+    Lcg rng{seed};
+    std::vector<float> values(rows * featureCount);
+    for (float& value : values) {
+        const uint32_t kind = rng.next() % 8;
+        if (kind == 0) {
+            value = std::numeric_limits<float>::quiet_NaN();
+        } else if (kind < 4) {
+            value = static_cast<float>(std::floor(rng.uniform(-8.0, 8.0)) * 0.25);
+        } else {
+            value = static_cast<float>(rng.uniform(-2.5, 2.5));
+        }
+    }
+    return values;
+}
+
+} // namespace
+
+TEST(TreeEnsembleTest, FlattenedScoringMatchesReferenceOnEverySimdLevel) {
+    // 行数超过kMaxBatch且不是16的倍数，覆盖分块和SIMD尾部
+    const size_t rows = TreeEnsemble::kMaxBatch + 37;
+    for (SplitCompare compare : {SplitCompare::LESS, SplitCompare::LESS_EQUAL}) {
+        const TreeEnsembleSpec spec = randomSpec(compare, compare == SplitCompare::LESS ? 3 : 5);
+        const std::vector<float> features = randomRows(rows, spec.featureCount, 11);
+        std::vector<float> outputs(rows * spec.outputCount);
+
+        for (utils::SimdLevel level : {utils::SimdLevel::SCALAR, utils::SimdLevel::AVX2, utils::SimdLevel::AVX512}) {
+            TreeEnsemble ensemble(level);
+            if (ensemble.simdLevel() != level) {
+                continue;
+            }
+            SCOPED_TRACE(utils::simdLevelName(level));
+            ASSERT_TRUE(ensemble.compile(spec));
+            ensemble.predict(features.data(), rows, outputs.data());
+            for (size_t r = 0; r < rows; ++r) {
+                const std::vector<float> expected = referenceScore(spec, features.data() + r * spec.featureCount);
+                for (size_t o = 0; o < spec.outputCount; ++o) {
+                    ASSERT_EQ(outputs[r * spec.outputCount + o], expected[o]) << "row " << r << " output " << o;
+                }
+            }
+        }
+    }
+}
+
+TEST(TreeEnsembleTest, ParsesXgboostDumpAndRoutesMissingValues) {
+    const std::string dump = R"([
+      { "nodeid": 0, "depth": 0, "split": "f1", "split_condition": 0.5, "yes": 1, "no": 2, "missing": 2,
+        "children": [
+          { "nodeid": 2, "leaf": -0.25 },
+          { "nodeid": 1, "depth": 1, "split": "f0", "split_condition": 2, "yes": 3, "no": 4, "missing": 3,
+            "children": [ { "nodeid": 3, "leaf": 1.0 }, { "nodeid": 4, "leaf": 2.0 } ] }
+        ] },
+      { "nodeid": 0, "leaf": 0.125 }
+    ])";
+    TreeEnsembleSpec spec;
+    spec.baseScore = 0.5;
+    ASSERT_TRUE(parseTreeEnsembleJson(dump, spec));
+    EXPECT_EQ(spec.featureCount, 2u);
+    EXPECT_EQ(spec.trees.size(), 2u);
+
+    TreeEnsemble ensemble;
+    ASSERT_TRUE(ensemble.compile(spec));
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const std::vector<float> features = {1.0f, 0.0f,  2.0f, 0.0f,  nan, 0.0f,  1.0f, 0.5f,  1.0f, nan};
+    std::vector<float> outputs(5);
+    ensemble.predict(features.data(), 5, outputs.data());
+    EXPECT_FLOAT_EQ(outputs[0], 1.625f);    // x1 < 0.5, x0 < 2
+    EXPECT_FLOAT_EQ(outputs[1], 2.625f);    // x0 == 2 走右
+    EXPECT_FLOAT_EQ(outputs[2], 1.625f);    // x0缺失走yes
+    EXPECT_FLOAT_EQ(outputs[3], 0.375f);    // x1 == 0.5 走右
+    EXPECT_FLOAT_EQ(outputs[4], 0.375f);    // x1缺失走no
+
+    // 生成的代码使用同样的阈值和缺失值方向
+    const std::string code = ensemble.generateCpp("scoreModel");
+    EXPECT_NE(code.find("void scoreModel(const float* features, float* outputs)"), std::string::npos);
+    EXPECT_NE(code.find("!(features[0] >= 0x1p+1f)"), std::string::npos);
+    EXPECT_NE(code.find("features[1] < 0x1p-1f"), std::string::npos);
+}
+
+TEST(TreeEnsembleTest, XgboostDumpUsesCallerSuppliedObjective) {
+    // 两类softmax：第i棵树属于第 i % 2 类
+    const std::string dump = R"([
+      { "nodeid": 0, "depth": 0, "split": "f0", "split_condition": 0, "yes": 1, "no": 2, "missing": 1,
+        "children": [ { "nodeid": 1, "leaf": 1.0 }, { "nodeid": 2, "leaf": -1.0 } ] },
+      { "nodeid": 0, "leaf": 0.0 }
+    ])";
+    TreeEnsembleSpec spec;
+    spec.outputCount = 2;
+    applyXgboostObjective(spec, "multi:softprob", 0.5);
+    ASSERT_TRUE(parseTreeEnsembleJson(dump, spec));
+    TreeEnsemble softmax;
+    ASSERT_TRUE(softmax.compile(spec));
+    EXPECT_EQ(softmax.outputCount(), 2u);
+    const std::vector<float> rows = {-1.0f, 1.0f};
+    std::vector<float> outputs(4);
+    softmax.predict(rows.data(), 2, outputs.data());
+    EXPECT_NEAR(outputs[0], 1.0 / (1.0 + std::exp(-1.0)), 1e-6);
+    EXPECT_NEAR(outputs[1] + outputs[0], 1.0, 1e-6);
+    EXPECT_NEAR(outputs[2], 1.0 / (1.0 + std::exp(1.0)), 1e-6);
+
+    // logistic目标：base_score 0.8为概率，换算成margin后再加叶子值
+    TreeEnsembleSpec binary;
+    applyXgboostObjective(binary, "binary:logistic", 0.8);
+    EXPECT_NEAR(binary.baseScore, std::log(4.0), 1e-12);
+    ASSERT_TRUE(parseTreeEnsembleJson(dump, binary));
+    TreeEnsemble logistic;
+    ASSERT_TRUE(logistic.compile(binary));
+    std::vector<float> probabilities(2);
+    logistic.predict(rows.data(), 2, probabilities.data());
+    EXPECT_NEAR(probabilities[0], 1.0 / (1.0 + std::exp(-(std::log(4.0) + 1.0))), 1e-6);
+    EXPECT_NEAR(probabilities[1], 1.0 / (1.0 + std::exp(-(std::log(4.0) - 1.0))), 1e-6);
+}
+
+TEST(TreeEnsembleTest, CompilesHftmGbdtModels) {
+    // 树0：x0 < 1 ? (x1 < 0 ? 1 : 2) : 3，x0缺失走右
+    pattern::TreeSpec first;
+    first.output = 0;
+    first.nodes.resize(5);
+    first.nodes[0] = {0, 1.0f, 1, 2, false};
+    first.nodes[1] = {1, 0.0f, 3, 4, true};
+    first.nodes[2] = {-1, 3.0f, 0, 0, true};
+    first.nodes[3] = {-1, 1.0f, 0, 0, true};
+    first.nodes[4] = {-1, 2.0f, 0, 0, true};
+    // 树1：x1 < 5 ? 0.5 : -0.5，作用于第二个输出
+    pattern::TreeSpec second;
+    second.output = 1;
+    second.nodes.resize(3);
+    second.nodes[0] = {1, 5.0f, 1, 2, true};
+    second.nodes[1] = {-1, 0.5f, 0, 0, true};
+    second.nodes[2] = {-1, -0.5f, 0, 0, true};
+    const std::vector<uint8_t> image =
+        pattern::packGbdtModel(2, 2, 0.25f, {first, second}, pattern::OutputTransform::NONE);
+    const std::string path = ::testing::TempDir() + "tree_ensemble_test.hftm";
+    ASSERT_TRUE(pattern::writeModelFile(path, image));
+
+    TreeEnsemble ensemble;
+    ASSERT_TRUE(ensemble.loadModel(path));
+    EXPECT_EQ(ensemble.featureCount(), 2u);
+    EXPECT_EQ(ensemble.outputCount(), 2u);
+    EXPECT_EQ(ensemble.treeCount(), 2u);
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const std::vector<float> features = {0.0f, -1.0f,  0.0f, 7.0f,  2.0f, 0.0f,  nan, 0.0f,  0.0f, nan,  1.0f, 5.0f};
+    std::vector<float> outputs(12);
+    ensemble.predict(features.data(), 6, outputs.data());
+    const std::vector<float> expected = {1.25f, 0.75f,  2.25f, -0.25f,  3.25f, 0.75f,
+                                         3.25f, 0.75f,  1.25f, 0.75f,  3.25f, -0.25f};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_FLOAT_EQ(outputs[i], expected[i]) << "index " << i;
+    }
+
+    // 截断的文件被拒绝
+    ASSERT_TRUE(pattern::writeModelFile(path, std::vector<uint8_t>(image.begin(), image.begin() + 64)));
+    EXPECT_FALSE(ensemble.loadModel(path));
+    std::remove(path.c_str());
+}
+
+TEST(TreeEnsembleTest, ParsesXgboostModelAndLightgbmObjectives) {
+    const std::string xgboost = R"({
+      "learner": {
+        "learner_model_param": { "base_score": "[5E-1]", "num_class": "0", "num_feature": "3" },
+        "objective": { "name": "binary:logistic" },
+        "gradient_booster": { "name": "gbtree", "model": {
+          "tree_info": [0],
+          "trees": [ { "left_children": [1, -1, -1], "right_children": [2, -1, -1],
+                       "split_indices": [2, 0, 0], "split_conditions": [1.5, -1.0, 1.0],
+                       "default_left": [1, 0, 0] } ] } }
+      }
+    })";
+    TreeEnsemble xgbModel;
+    TreeEnsembleSpec spec;
+    ASSERT_TRUE(parseTreeEnsembleJson(xgboost, spec));
+    ASSERT_TRUE(xgbModel.compile(spec));
+    EXPECT_EQ(xgbModel.featureCount(), 3u);
+    const std::vector<float> rows = {0.0f, 0.0f, 1.0f,  0.0f, 0.0f, 2.0f};
+    std::vector<float> probabilities(2);
+    xgbModel.predict(rows.data(), 2, probabilities.data());
+    // base_score 0.5对应margin 0
+    EXPECT_NEAR(probabilities[0], 1.0 / (1.0 + std::exp(1.0)), 1e-6);
+    EXPECT_NEAR(probabilities[1], 1.0 / (1.0 + std::exp(-1.0)), 1e-6);
+
+    const std::string lightgbm = R"({
+      "name": "tree", "num_class": 1, "num_tree_per_iteration": 1, "max_feature_idx": 1,
+      "objective": "binary sigmoid:2",
+      "tree_info": [ { "tree_index": 0, "tree_structure": {
+        "split_feature": 1, "threshold": -0.5, "decision_type": "<=", "default_left": true,
+        "missing_type": "None", "left_child": { "leaf_value": -0.5 }, "right_child": { "leaf_value": 0.25 } } } ]
+    })";
+    TreeEnsemble lgbModel;
+    ASSERT_TRUE(parseTreeEnsembleJson(lightgbm, spec));
+    ASSERT_TRUE(lgbModel.compile(spec));
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const std::vector<float> lgbRows = {0.0f, -0.5f,  0.0f, nan};
+    lgbModel.predict(lgbRows.data(), 2, probabilities.data());
+    // x <= -0.5走左；"None"时NaN按0处理，走右；叶子值乘sigmoid系数2
+    EXPECT_NEAR(probabilities[0], 1.0 / (1.0 + std::exp(1.0)), 1e-6);
+    EXPECT_NEAR(probabilities[1], 1.0 / (1.0 + std::exp(-0.5)), 1e-6);
+
+    EXPECT_FALSE(parseTreeEnsembleJson("{\"unknown\": 1}", spec));
+}
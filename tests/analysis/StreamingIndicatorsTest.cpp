@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "analysis/TechnicalIndicators.h"
+
+using namespace hft::analysis;
+
+namespace {
+
+std::vector<double> randomWalk(size_t size, double start, uint32_t seed) {
+    std::vector<double> prices(size);
+    uint32_t state = seed;
+    double price = start;
+    for (size_t i = 0; i < size; ++i) {
+        state = state * 1664525u + 1013904223u;
+        price += (static_cast<double>(state >> 8) / 16777216.0 - 0.5) * 0.2;
+        prices[i] = price;
+    }
+    return prices;
+}
+
+} // namespace
+
+TEST(StreamingIndicatorsTest, MatchesBatchIndicators) {
+    const std::vector<double> prices = randomWalk(2000, 100.0, 1);
+    const auto sma = TechnicalIndicators::SMA(prices, 20);
+    const auto ema = TechnicalIndicators::EMA(prices, 20);
+    const auto bands = TechnicalIndicators::BBANDS(prices, 20, 2.0);
+    const auto macd = TechnicalIndicators::calculateMACD(prices);
+
+    StreamingSMA<double> streamSma(20);
+    StreamingEMA<double> streamEma(20);
+    StreamingBollinger<double> streamBands(20, 2.0);
+    StreamingMACD<double> streamMacd;
+    for (size_t i = 0; i < prices.size(); ++i) {
+        EXPECT_NEAR(streamSma.update(prices[i]), sma[i], 1e-9);
+        EXPECT_DOUBLE_EQ(streamEma.update(prices[i]), ema[i]);
+        streamBands.update(prices[i]);
+        streamMacd.update(prices[i]);
+        if (i >= 19) {
+            EXPECT_NEAR(streamBands.upper(), bands.upper[i], 1e-9);
+            EXPECT_NEAR(streamBands.lower(), bands.lower[i], 1e-9);
+        }
+        EXPECT_NEAR(streamMacd.histogram(), macd.histogram[i], 1e-12);
+    }
+
+    // Z分数与直接计算一致
+    RollingStats<double> stats(50);
+    for (double price : prices) {
+        stats.update(price);
+    }
+    double mean = 0.0;
+    double m2 = 0.0;
+    for (size_t i = prices.size() - 50; i < prices.size(); ++i) {
+        mean += prices[i];
+    }
+    mean /= 50;
+    for (size_t i = prices.size() - 50; i < prices.size(); ++i) {
+        m2 += (prices[i] - mean) * (prices[i] - mean);
+    }
+    EXPECT_NEAR(stats.mean(), mean, 1e-9);
+    EXPECT_NEAR(stats.stddev(), std::sqrt(m2 / 50), 1e-9);
+    EXPECT_NEAR(stats.zscore(prices.back()), (prices.back() - mean) / std::sqrt(m2 / 50), 1e-7);
+}
+
+TEST(StreamingIndicatorsTest, WilderRsiAtrAndVwap) {
+    // 单边上涨：RSI为100；涨跌交替且幅度相同：RSI为50
+    StreamingRSI<double> rsi(14);
+    for (int i = 0; i < 20; ++i) {
+        rsi.update(100.0 + i);
+    }
+    EXPECT_TRUE(rsi.ready());
+    EXPECT_DOUBLE_EQ(rsi.value(), 100.0);
+    rsi.reset();
+    for (int i = 0; i < 29; ++i) {
+        rsi.update(i % 2 ? 101.0 : 100.0);
+    }
+    EXPECT_NEAR(rsi.value(), 50.0, 2.0);
+
+    StreamingATR<double> atr(3);
+    atr.update(11.0, 9.0, 10.0);    // TR = 2
+    atr.update(12.0, 10.0, 11.0);   // TR = max(2, 2, 0) = 2
+    atr.update(15.0, 11.0, 14.0);   // TR = 4
+    EXPECT_DOUBLE_EQ(atr.value(), 8.0 / 3.0);
+    atr.update(14.0, 13.0, 13.5);   // TR = 1，Wilder: (8/3×2 + 1)/3
+    EXPECT_DOUBLE_EQ(atr.value(), (8.0 / 3.0 * 2.0 + 1.0) / 3.0);
+
+    auto pipeline = makePipeline(StreamingVWAP<double>(), StreamingEMA<double>(3));
+    pipeline.update(10.0, 100.0);
+    pipeline.update(20.0, 300.0);
+    EXPECT_DOUBLE_EQ(pipeline.get<0>().value(), 17.5);
+    EXPECT_DOUBLE_EQ(pipeline.get<1>().value(), 15.0);
+}
+
+TEST(StreamingIndicatorsTest, BatchBankMatchesScalarBitForBit) {
+    constexpr size_t kSymbols = 37;
+    constexpr size_t kTicks = 500;
+    std::vector<std::vector<float>> series;
+    for (size_t s = 0; s < kSymbols; ++s) {
+        const std::vector<double> walk = randomWalk(kTicks, 50.0 + s, static_cast<uint32_t>(s + 7));
+        series.emplace_back(walk.begin(), walk.end());
+    }
+
+    RollingStatsBank<float> bank(kSymbols, 30);
+    EmaBank<float> emaBank(kSymbols, 10);
+    std::vector<RollingStats<float>> scalar(kSymbols, RollingStats<float>(30));
+    std::vector<StreamingEMA<float>> scalarEma(kSymbols, StreamingEMA<float>(10));
+    std::vector<float> row(kSymbols);
+    std::vector<float> zscores(kSymbols);
+
+    for (size_t t = 0; t < kTicks; ++t) {
+        for (size_t s = 0; s < kSymbols; ++s) {
+            row[s] = series[s][t];
+        }
+        bank.update(row.data(), zscores.data());
+        emaBank.update(row.data());
+        for (size_t s = 0; s < kSymbols; ++s) {
+            EXPECT_EQ(scalar[s].update(row[s]), zscores[s]);
+            EXPECT_EQ(scalar[s].mean(), bank.mean(s));
+            EXPECT_EQ(scalarEma[s].update(row[s]), emaBank.values()[s]);
+        }
+    }
+
+    SymbolIndicators<IndicatorPipeline<float, RollingStats<float>>> table(
+        IndicatorPipeline<float, RollingStats<float>>(RollingStats<float>(30)));
+    table[5].update(1.0f);
+    EXPECT_EQ(table.size(), 6u);
+    EXPECT_EQ(table.find(9), nullptr);
+}
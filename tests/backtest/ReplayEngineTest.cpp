@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "backtest/ReplayEngine.h"
+
+using namespace hft;
+using namespace hft::backtest;
+
+namespace {
+
+constexpr types::Price kBid = 1000000;      // 100.00
+constexpr types::Price kAsk = 1001000;      // 100.10
+
+persistence::Tick makeTick(uint64_t timestamp, types::Price last, types::Volume volume,
+                           types::Volume bidVolume = 500, types::Volume askVolume = 500) {
+    return persistence::Tick{timestamp, last, volume, kBid, kAsk, bidVolume, askVolume};
+}
+
+types::Volume filledQuantity(const std::vector<SimulatedFill>& fills, uint64_t orderId) {
+    types::Volume total = 0;
+    for (const auto& fill : fills) {
+        if (fill.order_id == orderId) {
+            total += fill.quantity;
+        }
+    }
+    return total;
+}
+
+// 交替下市价单与挂买一限价单，记录每笔收到的成交
+class RecordingStrategy : public ReplayStrategy {
+public:
+    explicit RecordingStrategy(std::vector<SimulatedFill>& fills) : m_fills(fills) {}
+
+    void onTick(ReplayContext& context, const persistence::Tick& tick) override {
+        ++m_ticks;
+        if (m_ticks % 7 == 0) {
+            const types::Side side = context.position() > 0 ? types::Side::SELL : types::Side::BUY;
+            context.submitOrder(side, 0, 10000);
+        } else if (m_ticks % 5 == 0) {
+            m_resting = context.submitOrder(types::Side::BUY, tick.bid_price, 20000);
+        } else if (m_ticks % 11 == 0 && m_resting != 0) {
+            context.cancelOrder(m_resting);
+            m_resting = 0;
+        }
+    }
+
+    void onFill(ReplayContext&, const SimulatedFill& fill) override {
+        m_fills.push_back(fill);
+    }
+
+private:
+    std::vector<SimulatedFill>& m_fills;
+    uint64_t m_ticks = 0;
+    uint64_t m_resting = 0;
+};
+
+struct ReplayRun {
+    ReplayResult result;
+    std::map<std::string, std::vector<SimulatedFill>> fills;
+};
+
+ReplayRun replay(const std::string& path, size_t workers) {
+    ReplayConfig config;
+    config.worker_threads = workers;
+    config.commission_rate = 0.0001;
+    ReplayEngine engine(config);
+    EXPECT_TRUE(engine.addCsvSource(path));
+
+    ReplayRun run;
+    std::mutex mutex;
+    run.result = engine.run([&](const std::string& symbol) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::make_unique<RecordingStrategy>(run.fills[symbol]);
+    });
+    return run;
+}
+
+void expectSameFills(const ReplayRun& a, const ReplayRun& b) {
+    ASSERT_EQ(a.fills.size(), b.fills.size());
+    for (const auto& entry : a.fills) {
+        const auto it = b.fills.find(entry.first);
+        ASSERT_NE(it, b.fills.end()) << entry.first;
+        const std::vector<SimulatedFill>& x = entry.second;
+        const std::vector<SimulatedFill>& y = it->second;
+        ASSERT_EQ(x.size(), y.size()) << entry.first;
+        for (size_t i = 0; i < x.size(); ++i) {
+            EXPECT_EQ(x[i].order_id, y[i].order_id);
+            EXPECT_EQ(x[i].timestamp, y[i].timestamp);
+            EXPECT_EQ(x[i].side, y[i].side);
+            EXPECT_EQ(x[i].price, y[i].price);
+            EXPECT_EQ(x[i].quantity, y[i].quantity);
+            EXPECT_EQ(x[i].passive, y[i].passive);
+        }
+    }
+
+    ASSERT_EQ(a.result.symbols.size(), b.result.symbols.size());
+    EXPECT_EQ(a.result.events, b.result.events);
+    EXPECT_DOUBLE_EQ(a.result.pnl, b.result.pnl);
+    for (size_t i = 0; i < a.result.symbols.size(); ++i) {
+        EXPECT_EQ(a.result.symbols[i].symbol, b.result.symbols[i].symbol);
+        EXPECT_EQ(a.result.symbols[i].fills, b.result.symbols[i].fills);
+        EXPECT_EQ(a.result.symbols[i].position, b.result.symbols[i].position);
+        EXPECT_DOUBLE_EQ(a.result.symbols[i].cash, b.result.symbols[i].cash);
+    }
+}
+
+} // namespace
+
+TEST(ReplayEngineTest, OrdersReachTheExchangeAfterLatency) {
+    ReplayConfig config;
+    config.order_latency_ns = 50000;
+    SimulatedExchange exchange(config);
+    std::vector<SimulatedFill> fills;
+    exchange.onTick(makeTick(1000000, 0, 0), fills);
+
+    // 延迟内成交价已打到挂单价，但订单尚未到达交易所，不成交
+    const uint64_t id = exchange.submit(1000000, types::Side::BUY, kBid, 100);
+    exchange.onTick(makeTick(1040000, kBid, 1000), fills);
+    EXPECT_TRUE(fills.empty());
+
+    // 到达后排在当时的买一挂单之后
+    exchange.onTick(makeTick(1050000, 0, 0), fills);
+    ASSERT_EQ(exchange.orders().size(), 1u);
+    EXPECT_TRUE(exchange.orders()[0].active);
+    EXPECT_EQ(exchange.orders()[0].queue_ahead, 500);
+
+    // 撤单同样在延迟后生效，期间仍可能成交
+    EXPECT_TRUE(exchange.cancel(1050000, id));
+    exchange.onTick(makeTick(1060000, kBid, 520), fills);
+    EXPECT_EQ(filledQuantity(fills, id), 20);
+    exchange.onTick(makeTick(1100000, kBid, 1000), fills);
+    EXPECT_EQ(filledQuantity(fills, id), 20);
+    EXPECT_TRUE(exchange.orders().empty());
+}
+
+TEST(ReplayEngineTest, QueueAheadIsConsumedBeforeOurOrderFills) {
+    ReplayConfig config;
+    SimulatedExchange exchange(config);
+    std::vector<SimulatedFill> fills;
+    exchange.onTick(makeTick(1000000, 0, 0, 200), fills);
+
+    // 两笔同价买单：第一笔前方200，第二笔前方300（之间又有100行情挂单）
+    const uint64_t first = exchange.submit(1000000, types::Side::BUY, kBid, 100);
+    exchange.onTick(makeTick(1050000, 0, 0, 300), fills);
+    const uint64_t second = exchange.submit(1050000, types::Side::BUY, kBid, 100);
+    exchange.onTick(makeTick(1100000, 0, 0, 300), fills);
+    ASSERT_EQ(exchange.orders().size(), 2u);
+    EXPECT_EQ(exchange.orders()[1].queue_ahead, 300);
+
+    // 150只消耗前方队列
+    exchange.onTick(makeTick(1200000, kBid, 150, 150), fills);
+    EXPECT_TRUE(fills.empty());
+
+    // 再成交100：前方剩余50，第一笔成交50；行情队列已被计入，第二笔只剩前方100
+    exchange.onTick(makeTick(1300000, kBid, 100, 100), fills);
+    EXPECT_EQ(filledQuantity(fills, first), 50);
+    EXPECT_EQ(filledQuantity(fills, second), 0);
+
+    // 成交200：第一笔剩余50，第二笔前方100消耗完后成交50
+    exchange.onTick(makeTick(1400000, kBid, 200, 50), fills);
+    EXPECT_EQ(filledQuantity(fills, first), 100);
+    EXPECT_EQ(filledQuantity(fills, second), 50);
+}
+
+TEST(ReplayEngineTest, ThroughPriceFillsAreLimitedByTradedVolume) {
+    ReplayConfig config;
+    SimulatedExchange exchange(config);
+    std::vector<SimulatedFill> fills;
+    exchange.onTick(makeTick(1000000, 0, 0), fills);
+
+    const uint64_t high = exchange.submit(1000000, types::Side::BUY, kBid, 100);
+    const uint64_t low = exchange.submit(1000000, types::Side::BUY, kBid - 1000, 100);
+    exchange.onTick(makeTick(1050000, 0, 0), fills);
+
+    // 成交价低于两笔挂单价，但只成交了120：价高者先全部成交，另一笔只得到剩余20
+    exchange.onTick(makeTick(1100000, kBid - 2000, 120), fills);
+    EXPECT_EQ(filledQuantity(fills, high), 100);
+    EXPECT_EQ(filledQuantity(fills, low), 20);
+    for (const auto& fill : fills) {
+        EXPECT_TRUE(fill.passive);
+        EXPECT_EQ(fill.price, fill.order_id == high ? kBid : kBid - 1000);
+    }
+}
+
+TEST(ReplayEngineTest, ReplayingTheSameDataTwiceProducesIdenticalFills) {
+    // 4个标的交错的行情，同一时间戳上有多条记录
+    const std::string path = ::testing::TempDir() + "replay_determinism.csv";
+    {
+        std::ofstream out(path);
+        out << "timestamp,symbol,open,high,low,close,volume,bid,ask,bid_volume,ask_volume\n";
+        const char* symbols[] = {"AAA", "BBB", "CCC", "DDD"};
+        uint64_t seed = 12345;
+        for (int row = 0; row < 2000; ++row) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            const int s = static_cast<int>((seed >> 33) % 4);
+            const double mid = 100.0 + static_cast<double>((seed >> 40) % 50) * 0.01;
+            const double bidVolume = 1.0 + static_cast<double>((seed >> 20) % 5);
+            const uint64_t timestamp = 1000000000ULL + static_cast<uint64_t>(row / 3) * 100000ULL;
+            out << timestamp << ',' << symbols[s] << ','
+                << mid << ',' << mid << ',' << mid << ',' << mid << ",3,"
+                << mid - 0.01 << ',' << mid + 0.01 << ',' << bidVolume << ",4\n";
+        }
+    }
+
+    const ReplayRun first = replay(path, 4);
+    const ReplayRun second = replay(path, 4);
+    const ReplayRun single = replay(path, 1);
+
+    size_t totalFills = 0;
+    for (const auto& entry : first.fills) {
+        totalFills += entry.second.size();
+    }
+    ASSERT_GT(totalFills, 0u);
+    EXPECT_EQ(first.result.events, 2000u);
+
+    expectSameFills(first, second);
+    // 每个标的的结果与工作线程数无关
+    expectSameFills(first, single);
+    std::remove(path.c_str());
+}
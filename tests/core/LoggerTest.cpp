@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/Logger.h"
+
+using namespace hft::core;
+
+namespace {
+
+// 所有模块共用一个后端：每个用例切换到自己的日志文件
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = ::testing::TempDir() + "logger_test_" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".log";
+        std::remove(path_.c_str());
+        Logger::enableConsoleOutput(false);
+        Logger::setLogLevel(LogLevel::INFO);
+        Logger::setOverflowPolicy(Logger::OverflowPolicy::DROP);
+        Logger::flush();
+        Logger::setLogFile(path_);
+    }
+
+    void TearDown() override {
+        Logger::flush();
+        Logger::setLogFile("");
+        Logger::setOverflowPolicy(Logger::OverflowPolicy::DROP);
+        std::remove(path_.c_str());
+    }
+
+    std::vector<std::string> lines() {
+        Logger::flush();
+        std::ifstream in(path_);
+        std::vector<std::string> result;
+        std::string line;
+        while (std::getline(in, line)) {
+            result.push_back(line);
+        }
+        return result;
+    }
+
+    std::string path_;
+};
+
+bool contains(const std::string& line, const std::string& text) {
+    return line.find(text) != std::string::npos;
+}
+
+} // namespace
+
+TEST_F(LoggerTest, PreservesOrderWithinAThreadAcrossModules) {
+    Logger orders("Orders");
+    Logger risk("Risk");
+    for (int i = 0; i < 500; ++i) {
+        (i % 2 == 0 ? orders : risk).info("seq " + std::to_string(i));
+    }
+
+    const std::vector<std::string> out = lines();
+    ASSERT_EQ(out.size(), 500u);
+    for (int i = 0; i < 500; ++i) {
+        EXPECT_TRUE(contains(out[i], i % 2 == 0 ? "[INFO] [Orders]: " : "[INFO] [Risk]: ")) << out[i];
+        const std::string suffix = ": seq " + std::to_string(i);
+        EXPECT_EQ(out[i].compare(out[i].size() - suffix.size(), suffix.size(), suffix), 0) << out[i];
+    }
+}
+
+TEST_F(LoggerTest, FiltersByGlobalAndModuleLevel) {
+    Logger quiet("QuietModule");
+    Logger normal("NormalModule");
+    Logger::setModuleLogLevel("QuietModule", LogLevel::ERROR);
+
+    quiet.info("quiet info");
+    quiet.warning("quiet warning");
+    quiet.error("quiet error");
+    normal.debug("normal debug");
+    normal.info("normal info");
+
+    // 全局级别不覆盖单独设置过的模块
+    Logger::setLogLevel(LogLevel::DEBUG);
+    quiet.info("quiet info again");
+    normal.debug("normal debug again");
+
+    // 关闭的级别不求值消息表达式
+    int evaluated = 0;
+    auto message = [&evaluated] { ++evaluated; return std::string("lazy"); };
+    HFT_LOG(quiet, LogLevel::WARNING, message());
+    HFT_LOG(normal, LogLevel::DEBUG, message());
+    EXPECT_EQ(evaluated, 1);
+
+    const std::vector<std::string> out = lines();
+    ASSERT_EQ(out.size(), 4u);
+    EXPECT_TRUE(contains(out[0], "[ERROR] [QuietModule]: quiet error"));
+    EXPECT_TRUE(contains(out[1], "[INFO] [NormalModule]: normal info"));
+    EXPECT_TRUE(contains(out[2], "[DEBUG] [NormalModule]: normal debug again"));
+    EXPECT_TRUE(contains(out[3], "[DEBUG] [NormalModule]: lazy"));
+
+    Logger::setModuleLogLevel("QuietModule", LogLevel::INFO);
+}
+
+TEST_F(LoggerTest, DroppedCountAccountsForEveryLostInfoMessage) {
+    Logger flood("Flood");
+    // 大消息快速写入，超过线程环容量时按DROP策略丢弃
+    const std::string payload(2000, 'x');
+    constexpr int kMessages = 2000;
+    const uint64_t droppedBefore = Logger::getDroppedCount();
+    for (int i = 0; i < kMessages; ++i) {
+        flood.info(payload);
+    }
+
+    const size_t written = lines().size();
+    const uint64_t dropped = Logger::getDroppedCount() - droppedBefore;
+    EXPECT_EQ(written + dropped, static_cast<size_t>(kMessages));
+}
+
+TEST_F(LoggerTest, ErrorsAreNeverDroppedUnderDropPolicy) {
+    Logger flood("ErrorFlood");
+    const std::string payload(2000, 'e');
+    constexpr int kMessages = 2000;
+    const uint64_t droppedBefore = Logger::getDroppedCount();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&flood, &payload] {
+            for (int i = 0; i < kMessages / 4; ++i) {
+                flood.error(payload);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // 超过环容量一半的记录无法入环，改为同步写出
+    flood.fatal(std::string(200 << 10, 'f'));
+
+    const std::vector<std::string> out = lines();
+    EXPECT_EQ(Logger::getDroppedCount(), droppedBefore);
+    ASSERT_EQ(out.size(), static_cast<size_t>(kMessages) + 1);
+    EXPECT_TRUE(contains(out.back(), "[CRITICAL] [ErrorFlood]: fff"));
+}
+
+TEST_F(LoggerTest, BlockPolicyDeliversEveryMessage) {
+    Logger::setOverflowPolicy(Logger::OverflowPolicy::BLOCK);
+    Logger flood("BlockFlood");
+    const std::string payload(2000, 'b');
+    constexpr int kMessages = 2000;
+    const uint64_t droppedBefore = Logger::getDroppedCount();
+    for (int i = 0; i < kMessages; ++i) {
+        flood.info(payload);
+    }
+
+    EXPECT_EQ(lines().size(), static_cast<size_t>(kMessages));
+    EXPECT_EQ(Logger::getDroppedCount(), droppedBefore);
+}
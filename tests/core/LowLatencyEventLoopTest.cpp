@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "core/LowLatencyEventLoop.h"
+
+using namespace hft::core;
+
+TEST(LowLatencyEventLoopTest, RunsTasksAndTimersOnLoopThread) {
+    LowLatencyEventLoop loop;
+    std::atomic<int> tasks{0};
+    std::atomic<bool> inLoop{false};
+    std::atomic<bool> fired{false};
+    loop.start();
+
+    loop.postTask([&] {
+        inLoop = loop.isInLoopThread();
+        // 定时器只能在循环线程内注册
+        loop.addTimer([&] { fired = true; }, std::chrono::milliseconds(1));
+        ++tasks;
+    });
+    EXPECT_EQ(loop.addTimer([] {}, std::chrono::milliseconds(1)), TimerWheel::kInvalidTimer);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((tasks.load() == 0 || !fired.load()) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    loop.stop();
+    EXPECT_EQ(tasks.load(), 1);
+    EXPECT_TRUE(inLoop.load());
+    EXPECT_TRUE(fired.load());
+    EXPECT_FALSE(loop.isInLoopThread());
+}
+
+TEST(LowLatencyEventLoopTest, StopDrainsEveryPostedTask) {
+    LowLatencyEventLoop::Config config;
+    config.max_tasks_per_poll = 4;
+    LowLatencyEventLoop loop(config);
+    std::atomic<bool> blocked{false};
+    std::atomic<bool> release{false};
+    std::atomic<int> executed{0};
+    loop.start();
+
+    // 第一个任务占住循环线程，其余任务在stop()开始时仍留在收件箱中
+    loop.postTask([&] {
+        blocked = true;
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    for (int i = 0; i < 100; ++i) {
+        loop.postTask([&] { ++executed; });
+    }
+    while (!blocked.load()) {
+        std::this_thread::yield();
+    }
+
+    std::thread stopper([&] { loop.stop(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    release = true;
+    stopper.join();
+
+    // 超过单轮上限的任务也在退出前执行完
+    EXPECT_EQ(executed.load(), 100);
+}
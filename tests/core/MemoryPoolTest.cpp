@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <set>
+#include <thread>
+#include <vector>
+#include "core/MemoryPool.h"
+
+using namespace hft::core;
+
+namespace {
+
+struct Item {
+    uint64_t id;
+    uint64_t check;
+};
+
+// 64字节槽位，最小chunk为一批（64块，4KB），便于触发扩展与耗尽
+using SmallPool = MemoryPool<Item, 64>;
+
+} // namespace
+
+TEST(MemoryPoolTest, AllocateOnOneThreadFreeOnAnother) {
+    SmallPool pool;
+    ASSERT_TRUE(pool.initialize(4096));
+
+    constexpr size_t kCount = 5000;
+    std::vector<Item*> items;
+    std::thread producer([&] {
+        for (size_t i = 0; i < kCount; ++i) {
+            items.push_back(pool.create(Item{i, ~i}));
+        }
+    });
+    producer.join();
+
+    std::thread consumer([&] {
+        for (size_t i = 0; i < kCount; ++i) {
+            EXPECT_EQ(items[i]->id, i);
+            EXPECT_EQ(items[i]->check, ~i);
+            pool.destroy(items[i]);
+        }
+    });
+    consumer.join();
+
+    // 两个线程都已退出，缓存全部归还中心表
+    SmallPool::Stats stats = pool.getStats();
+    EXPECT_EQ(stats.allocated_blocks, 0u);
+    EXPECT_EQ(stats.thread_caches, 0u);
+    EXPECT_EQ(stats.free_blocks, stats.total_size / 64);
+
+    // 归还的块可以再次分配
+    Item* again = pool.create(Item{1, 2});
+    EXPECT_EQ(again->id, 1u);
+    pool.destroy(again);
+}
+
+TEST(MemoryPoolTest, ConcurrentThreadsNeverShareBlocks) {
+    SmallPool pool;
+    ASSERT_TRUE(pool.initialize(4096));
+
+    constexpr size_t kThreads = 4;
+    constexpr size_t kRounds = 200;
+    constexpr size_t kLive = 300;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&pool, t] {
+            std::vector<Item*> live;
+            for (size_t round = 0; round < kRounds; ++round) {
+                for (size_t i = 0; i < kLive; ++i) {
+                    const uint64_t id = (t << 32) | (round * kLive + i);
+                    live.push_back(pool.create(Item{id, ~id}));
+                }
+                // 释放前检查内容未被其他线程改写
+                for (Item* item : live) {
+                    ASSERT_EQ(item->check, ~item->id);
+                    ASSERT_EQ(item->id >> 32, t);
+                    pool.destroy(item);
+                }
+                live.clear();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(pool.getStats().allocated_blocks, 0u);
+}
+
+TEST(MemoryPoolTest, GrowthAppendsChunksWithoutMovingObjects) {
+    SmallPool pool;
+    ASSERT_TRUE(pool.initialize(4096));
+    EXPECT_EQ(pool.getStats().chunk_count, 1u);
+
+    std::vector<Item*> items;
+    std::set<Item*> unique;
+    for (uint64_t i = 0; i < 2000; ++i) {
+        Item* item = pool.create(Item{i, ~i});
+        items.push_back(item);
+        unique.insert(item);
+    }
+    EXPECT_EQ(unique.size(), items.size());
+
+    SmallPool::Stats stats = pool.getStats();
+    EXPECT_GT(stats.chunk_count, 1u);
+    EXPECT_EQ(stats.allocated_blocks, items.size());
+    EXPECT_GE(stats.total_size / 64, items.size());
+
+    // 扩展后早期分配的对象仍在原地且内容完好
+    for (uint64_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(items[i]->id, i);
+        EXPECT_EQ(items[i]->check, ~i);
+    }
+    for (Item* item : items) {
+        pool.destroy(item);
+    }
+}
+
+TEST(MemoryPoolTest, ExhaustionThrowsAndRecoversAfterFree) {
+    SmallPool pool;
+    ASSERT_TRUE(pool.initialize(4096, 16384));
+
+    std::vector<Item*> items;
+    bool exhausted = false;
+    for (size_t i = 0; i < 1000; ++i) {
+        try {
+            items.push_back(pool.allocate());
+        } catch (const std::bad_alloc&) {
+            exhausted = true;
+            break;
+        }
+    }
+    ASSERT_TRUE(exhausted);
+
+    SmallPool::Stats stats = pool.getStats();
+    EXPECT_LE(stats.total_size, 16384u);
+    EXPECT_EQ(items.size(), stats.total_size / 64);
+    EXPECT_EQ(stats.free_blocks, 0u);
+    EXPECT_THROW(pool.allocate(), std::bad_alloc);
+
+    // 释放一个块后可以再次分配
+    pool.deallocate(items.back());
+    items.back() = pool.allocate();
+    EXPECT_NE(items.back(), nullptr);
+    for (Item* item : items) {
+        pool.deallocate(item);
+    }
+    EXPECT_EQ(pool.getStats().allocated_blocks, 0u);
+}
+
+TEST(MemoryPoolTest, ThreadBindingsOfDestroyedPoolsAreReclaimed) {
+    // 同一线程先后使用远多于绑定表容量（16）的池，每个新池仍能拿到线程缓存
+    for (int i = 0; i < 40; ++i) {
+        auto pool = std::make_unique<SmallPool>();
+        ASSERT_TRUE(pool->initialize(4096));
+        pool->destroy(pool->create(Item{1, 2}));
+        EXPECT_EQ(pool->getStats().thread_caches, 1u) << "pool " << i;
+    }
+}
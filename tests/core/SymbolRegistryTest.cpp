@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/SymbolRegistry.h"
+#include "execution/Order.h"
+
+using namespace hft::core;
+
+TEST(SymbolRegistryTest, ConcurrentInternAndFindAgreeOnIds) {
+    SymbolRegistry registry(4096);
+    constexpr int kThreads = 8;
+    constexpr int kNames = 2000;
+    auto nameOf = [](int i) { return "SYM" + std::to_string(i); };
+
+    // 所有线程以不同顺序驻留同一批名称，同时有读线程查找
+    std::vector<std::vector<uint32_t>> ids(kThreads, std::vector<uint32_t>(kNames));
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistent{0};
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            for (int i = 0; i < kNames; ++i) {
+                const uint32_t id = registry.find(nameOf(i));
+                if (id != 0 && registry.name(id) != nameOf(i)) {
+                    inconsistent.fetch_add(1);
+                }
+            }
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([&, t] {
+            for (int n = 0; n < kNames; ++n) {
+                const int i = (t % 2 == 0) ? n : kNames - 1 - n;
+                ids[t][i] = registry.intern(nameOf(i));
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_EQ(inconsistent.load(), 0);
+    EXPECT_EQ(registry.size(), static_cast<size_t>(kNames));
+    for (int i = 0; i < kNames; ++i) {
+        ASSERT_NE(ids[0][i], 0u);
+        for (int t = 1; t < kThreads; ++t) {
+            EXPECT_EQ(ids[t][i], ids[0][i]);
+        }
+        EXPECT_EQ(registry.find(nameOf(i)), ids[0][i]);
+        EXPECT_EQ(registry.name(ids[0][i]), nameOf(i));
+    }
+}
+
+TEST(SymbolRegistryTest, OverlongAndEmptyNamesAreRejected) {
+    SymbolRegistry registry(16);
+    const std::string longest(SymbolRegistry::kMaxNameLength, 'A');
+    const std::string overlong(SymbolRegistry::kMaxNameLength + 1, 'A');
+
+    const uint32_t id = registry.intern(longest);
+    EXPECT_NE(id, 0u);
+    EXPECT_EQ(registry.name(id), longest);
+    EXPECT_EQ(registry.intern(overlong), 0u);
+    EXPECT_EQ(registry.find(overlong), 0u);
+    EXPECT_EQ(registry.intern(""), 0u);
+    EXPECT_EQ(registry.size(), 1u);
+}
+
+TEST(SymbolRegistryTest, CapacityExhaustionRejectsNewNamesOnly) {
+    SymbolRegistry registry(3);
+    const uint32_t a = registry.intern("A");
+    const uint32_t b = registry.intern("B");
+    const uint32_t c = registry.intern("C");
+    EXPECT_EQ(a, 1u);
+    EXPECT_EQ(b, 2u);
+    EXPECT_EQ(c, 3u);
+
+    // 表满后新名称失败，已有名称仍可命中
+    EXPECT_EQ(registry.intern("D"), 0u);
+    EXPECT_EQ(registry.find("D"), 0u);
+    EXPECT_EQ(registry.intern("B"), b);
+    EXPECT_EQ(registry.size(), 3u);
+    EXPECT_TRUE(registry.name(4).empty());
+}
+
+TEST(SymbolRegistryTest, OrderWithUninternableSymbolIsRejectedAtTheBoundary) {
+    hft::Order order;
+    order.orderId = 42;
+    order.symbol = "REG.TEST";
+    order.exchange = "XNAS";
+    order.quantity = 100;
+    order.price = 10.5;
+
+    hft::OrderRecord record{};
+    ASSERT_TRUE(hft::toOrderRecord(order, record));
+    EXPECT_EQ(symbolName(record.symbolId), "REG.TEST");
+    EXPECT_EQ(venueName(record.venueId), "XNAS");
+    EXPECT_EQ(record.quantity, 100u);
+
+    order.symbol = std::string(SymbolRegistry::kMaxNameLength + 5, 'Z');
+    EXPECT_FALSE(hft::toOrderRecord(order, record));
+
+    order.symbol.clear();
+    EXPECT_FALSE(hft::toOrderRecord(order, record));
+}
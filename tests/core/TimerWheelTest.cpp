@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include "core/TimerWheel.h"
+
+using namespace hft::core;
+
+TEST(TimerWheelTest, TimersCascadeAcrossLevelsAndFireOnTheirTick) {
+    TimerWheel wheel(64, 10);
+    // 分别落在第0、1、2、3层
+    const uint64_t expiries[] = {10 + 200, 10 + 300, 10 + 70000, 10 + 20000000};
+    std::vector<uint64_t> fired;
+    for (uint64_t expiry : expiries) {
+        ASSERT_NE(wheel.schedule([&fired, &wheel] { fired.push_back(wheel.currentTick()); }, expiry),
+                  TimerWheel::kInvalidTimer);
+    }
+    EXPECT_EQ(wheel.activeTimers(), 4u);
+
+    // 分段推进，跨越各层的下沉边界
+    uint64_t now = 10;
+    for (uint64_t step : {150ull, 1000ull, 69000ull, 5000000ull, 15000000ull}) {
+        now += step;
+        wheel.advance(now);
+    }
+    ASSERT_EQ(fired.size(), 4u);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(fired[i], expiries[i]);
+    }
+    EXPECT_EQ(wheel.activeTimers(), 0u);
+}
+
+TEST(TimerWheelTest, PeriodicTimerReschedulesUntilCancelledFromItsOwnCallback) {
+    TimerWheel wheel(8);
+    std::vector<uint64_t> ticks;
+    TimerWheel::TimerId id = TimerWheel::kInvalidTimer;
+    id = wheel.schedule([&] {
+        ticks.push_back(wheel.currentTick());
+        if (ticks.size() == 3) {
+            EXPECT_TRUE(wheel.cancel(id));
+        }
+    }, 5, 5);
+    ASSERT_NE(id, TimerWheel::kInvalidTimer);
+
+    EXPECT_EQ(wheel.advance(100), 3u);
+    EXPECT_EQ(ticks, (std::vector<uint64_t>{5, 10, 15}));
+    EXPECT_EQ(wheel.activeTimers(), 0u);
+    EXPECT_FALSE(wheel.cancel(id));
+}
+
+TEST(TimerWheelTest, OneShotCancelInsideCallbackAndStaleIds) {
+    TimerWheel wheel(8);
+    TimerWheel::TimerId self = TimerWheel::kInvalidTimer;
+    bool cancelledSelf = true;
+    int victimRuns = 0;
+    // 同一tick的另一个定时器在回调中被取消，不应触发
+    const TimerWheel::TimerId victim = wheel.schedule([&] { ++victimRuns; }, 3);
+    self = wheel.schedule([&] {
+        cancelledSelf = wheel.cancel(self);
+        wheel.cancel(victim);
+    }, 3);
+
+    wheel.advance(3);
+    // 一次性定时器已在触发中，取消自身返回false
+    EXPECT_FALSE(cancelledSelf);
+    // 同槽位后插入的先触发：self取消了尚未触发的victim
+    EXPECT_EQ(victimRuns, 0);
+    EXPECT_EQ(wheel.activeTimers(), 0u);
+    EXPECT_FALSE(wheel.cancel(self));
+
+    // 节点复用后，旧ID不能取消新定时器
+    const TimerWheel::TimerId reused = wheel.schedule([] {}, 10);
+    EXPECT_FALSE(wheel.cancel(self));
+    EXPECT_TRUE(wheel.cancel(reused));
+}
+
+TEST(TimerWheelTest, PoolExhaustionRejectsAndRecoversAfterRelease) {
+    TimerWheel wheel(4);
+    std::vector<TimerWheel::TimerId> ids;
+    for (int i = 0; i < 4; ++i) {
+        ids.push_back(wheel.schedule([] {}, 100 + i));
+        ASSERT_NE(ids.back(), TimerWheel::kInvalidTimer);
+    }
+    EXPECT_EQ(wheel.schedule([] {}, 200), TimerWheel::kInvalidTimer);
+    EXPECT_EQ(wheel.activeTimers(), 4u);
+
+    EXPECT_TRUE(wheel.cancel(ids[1]));
+    EXPECT_NE(wheel.schedule([] {}, 200), TimerWheel::kInvalidTimer);
+
+    EXPECT_EQ(wheel.advance(300), 4u);
+    EXPECT_EQ(wheel.activeTimers(), 0u);
+    EXPECT_EQ(wheel.capacity(), 4u);
+}
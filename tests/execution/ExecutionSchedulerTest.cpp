@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "execution/ExecutionScheduler.h"
+
+using namespace hft;
+using namespace hft::execution;
+
+namespace {
+
+constexpr uint64_t kMs = 1000000;
+constexpr uint64_t kStart = 1000000000000ULL;
+
+struct Recorder {
+    std::vector<OrderRecord> children;
+    std::vector<ParentOrderView> done;
+
+    void attach(ExecutionScheduler& scheduler) {
+        scheduler.setChildOrderHandler([this](const OrderRecord& child) { children.push_back(child); });
+        scheduler.setParentDoneHandler([this](const ParentOrderView& view) { done.push_back(view); });
+    }
+};
+
+ExecutionSchedulerConfig smallConfig() {
+    ExecutionSchedulerConfig config;
+    config.maxParents = 64;
+    config.maxSymbols = 16;
+    return config;
+}
+
+} // namespace
+
+TEST(ExecutionSchedulerTest, TwapSlicesOnTimerWheel) {
+    ExecutionScheduler scheduler(smallConfig(), kStart);
+    Recorder recorder;
+    recorder.attach(scheduler);
+    scheduler.onQuote(1, 99.0, 1000, 101.0, 1000);
+
+    ParentOrderSpec spec;
+    spec.symbolId = 1;
+    spec.side = OrderSide::BUY;
+    spec.algo = ExecAlgo::TWAP;
+    spec.quantity = 1000;
+    spec.endNs = kStart + 1000 * kMs;
+    spec.sliceIntervalMs = 100;
+    const uint64_t parent = scheduler.submit(spec);
+    ASSERT_NE(parent, 0u);
+
+    // 首片立即发出，按对手价
+    ASSERT_EQ(recorder.children.size(), 1u);
+    EXPECT_EQ(recorder.children[0].quantity, 100u);
+    EXPECT_DOUBLE_EQ(recorder.children[0].price, 101.0);
+    EXPECT_EQ(recorder.children[0].parentOrderId, parent);
+
+    for (uint64_t t = 1; t <= 10; ++t) {
+        scheduler.onChildFill(parent, recorder.children.back().quantity, 101.0);
+        scheduler.advance(kStart + t * 100 * kMs);
+    }
+    ASSERT_EQ(recorder.done.size(), 1u);
+    EXPECT_EQ(recorder.done[0].status, ParentStatus::COMPLETED);
+    EXPECT_EQ(recorder.done[0].filled, 1000u);
+    EXPECT_EQ(recorder.done[0].childOrders, 10u);
+    EXPECT_DOUBLE_EQ(recorder.done[0].avgFillPrice, 101.0);
+    EXPECT_EQ(scheduler.activeParents(), 0u);
+    EXPECT_FALSE(scheduler.cancel(parent));
+}
+
+TEST(ExecutionSchedulerTest, DepthLimitedSliceWaitsForQuoteOnItsSymbol) {
+    ExecutionScheduler scheduler(smallConfig(), kStart);
+    Recorder recorder;
+    recorder.attach(scheduler);
+    scheduler.onQuote(2, 49.0, 500, 50.0, 30);
+
+    ParentOrderSpec spec;
+    spec.symbolId = 2;
+    spec.side = OrderSide::BUY;
+    spec.quantity = 400;
+    spec.endNs = kStart + 400 * kMs;
+    spec.sliceIntervalMs = 100;
+    spec.depthFraction = 1.0;
+    const uint64_t parent = scheduler.submit(spec);
+
+    // 目标100，但卖一只有30
+    ASSERT_EQ(recorder.children.size(), 1u);
+    EXPECT_EQ(recorder.children[0].quantity, 30u);
+    scheduler.onChildFill(parent, 30, 50.0);
+
+    // 其他品种的行情不触发该母单
+    scheduler.onQuote(3, 10.0, 1000, 10.1, 1000);
+    EXPECT_EQ(recorder.children.size(), 1u);
+
+    // 本品种深度恢复后补足缺口
+    scheduler.onQuote(2, 49.0, 500, 50.0, 1000);
+    ASSERT_EQ(recorder.children.size(), 2u);
+    EXPECT_EQ(recorder.children[1].quantity, 70u);
+    EXPECT_EQ(scheduler.activeParents(2), 1u);
+
+    EXPECT_TRUE(scheduler.cancel(parent));
+    ASSERT_EQ(recorder.done.size(), 1u);
+    EXPECT_EQ(recorder.done[0].status, ParentStatus::CANCELLED);
+    EXPECT_EQ(scheduler.activeParents(2), 0u);
+}
+
+TEST(ExecutionSchedulerTest, WorkingChildrenCountAgainstTouchDepth) {
+    ExecutionScheduler scheduler(smallConfig(), kStart);
+    Recorder recorder;
+    recorder.attach(scheduler);
+    scheduler.onQuote(2, 49.0, 500, 50.0, 30);
+
+    ParentOrderSpec spec;
+    spec.symbolId = 2;
+    spec.side = OrderSide::BUY;
+    spec.quantity = 400;
+    spec.endNs = kStart + 400 * kMs;
+    spec.sliceIntervalMs = 100;
+    spec.depthFraction = 1.0;
+    const uint64_t parent = scheduler.submit(spec);
+    ASSERT_EQ(recorder.children.size(), 1u);
+    EXPECT_EQ(recorder.children[0].quantity, 30u);
+
+    // 子单未成交，同样的盘口反复到来不再追加子单
+    for (int i = 0; i < 5; ++i) {
+        scheduler.onQuote(2, 49.0, 500, 50.0, 30);
+    }
+    EXPECT_EQ(recorder.children.size(), 1u);
+
+    // 卖一增加到50，只补上在途之外的20
+    scheduler.onQuote(2, 49.0, 500, 50.0, 50);
+    ASSERT_EQ(recorder.children.size(), 2u);
+    EXPECT_EQ(recorder.children[1].quantity, 20u);
+    scheduler.onQuote(2, 49.0, 500, 50.0, 50);
+    EXPECT_EQ(recorder.children.size(), 2u);
+
+    // 一笔子单结束后腾出对应深度
+    scheduler.onChildClosed(parent, 30);
+    ASSERT_EQ(recorder.children.size(), 2u);
+    scheduler.onQuote(2, 49.0, 500, 50.0, 50);
+    ASSERT_EQ(recorder.children.size(), 3u);
+    EXPECT_EQ(recorder.children[2].quantity, 30u);
+
+    // 对手价变化后按新价位的深度发单
+    scheduler.onQuote(2, 49.5, 500, 50.5, 40);
+    ASSERT_EQ(recorder.children.size(), 4u);
+    EXPECT_EQ(recorder.children[3].quantity, 40u);
+    EXPECT_DOUBLE_EQ(recorder.children[3].price, 50.5);
+    ParentOrderView view;
+    ASSERT_TRUE(scheduler.view(parent, view));
+    EXPECT_EQ(view.working, 90u);
+}
+
+TEST(ExecutionSchedulerTest, IcebergRefillsAfterClipFills) {
+    ExecutionScheduler scheduler(smallConfig(), kStart);
+    Recorder recorder;
+    recorder.attach(scheduler);
+
+    ParentOrderSpec spec;
+    spec.symbolId = 4;
+    spec.side = OrderSide::SELL;
+    spec.algo = ExecAlgo::ICEBERG;
+    spec.quantity = 250;
+    spec.limitPrice = 20.5;
+    spec.displayQuantity = 100;
+    const uint64_t parent = scheduler.submit(spec);
+
+    ASSERT_EQ(recorder.children.size(), 1u);
+    scheduler.onChildFill(parent, 60, 20.5);
+    EXPECT_EQ(recorder.children.size(), 1u);    // 当前显示部分未成交完，不补单
+    scheduler.onChildFill(parent, 40, 20.5);
+    ASSERT_EQ(recorder.children.size(), 2u);
+    EXPECT_EQ(recorder.children[1].quantity, 100u);
+    scheduler.onChildFill(parent, 100, 20.5);
+    ASSERT_EQ(recorder.children.size(), 3u);
+    EXPECT_EQ(recorder.children[2].quantity, 50u);
+    EXPECT_DOUBLE_EQ(recorder.children[2].price, 20.5);
+    scheduler.onChildFill(parent, 50, 20.5);
+    ASSERT_EQ(recorder.done.size(), 1u);
+    EXPECT_EQ(recorder.done[0].status, ParentStatus::COMPLETED);
+}
+
+TEST(ExecutionSchedulerTest, VwapFollowsVolumeCurve) {
+    ExecutionScheduler scheduler(smallConfig(), kStart);
+    Recorder recorder;
+    recorder.attach(scheduler);
+    scheduler.onQuote(5, 9.9, 100000, 10.0, 100000);
+
+    // 4个桶，成交集中在第一个桶
+    VolumeCurve* curve = scheduler.volumeCurve(5);
+    ASSERT_NE(curve, nullptr);
+    curve->configure(kStart, kStart + 400 * kMs, 4);
+    curve->setProfile({70.0, 10.0, 10.0, 10.0});
+    EXPECT_DOUBLE_EQ(curve->cumulative(kStart + 100 * kMs), 0.7);
+    EXPECT_DOUBLE_EQ(curve->cumulative(kStart + 50 * kMs), 0.35);
+
+    ParentOrderSpec spec;
+    spec.symbolId = 5;
+    spec.algo = ExecAlgo::VWAP;
+    spec.quantity = 1000;
+    spec.endNs = kStart + 400 * kMs;
+    spec.sliceIntervalMs = 100;
+    const uint64_t parent = scheduler.submit(spec);
+    ASSERT_NE(parent, 0u);
+    ASSERT_EQ(recorder.children.size(), 1u);
+    EXPECT_EQ(recorder.children[0].quantity, 700u);
+
+    scheduler.onChildFill(parent, 700, 10.0);
+    scheduler.advance(kStart + 100 * kMs);
+    ASSERT_EQ(recorder.children.size(), 2u);
+    EXPECT_EQ(recorder.children[1].quantity, 100u);
+
+    // 当日成交量并入历史分布
+    curve->addVolume(kStart + 350 * kMs, 1000.0);
+    curve->rollover(0.5);
+    EXPECT_NEAR(curve->cumulative(kStart + 300 * kMs), 0.45, 1e-12);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "hardware/VectorKernels.h"
+
+using namespace hft;
+using namespace hft::hardware;
+
+namespace {
+
+std::vector<float> uniform(size_t size, float low, float high, uint32_t seed) {
+    std::vector<float> values(size);
+    uint32_t state = seed;
+    for (float& value : values) {
+        state = state * 1664525u + 1013904223u;
+        value = low + (high - low) * (static_cast<float>(state >> 8) / 16777216.0f);
+    }
+    return values;
+}
+
+// 本机支持的全部SIMD级别
+std::vector<const VectorKernels*> simdVariants() {
+    std::vector<const VectorKernels*> variants;
+    for (utils::SimdLevel level : {utils::SimdLevel::AVX2, utils::SimdLevel::AVX512}) {
+        const VectorKernels& kernels = vectorKernels(level);
+        if (kernels.level == level) {
+            variants.push_back(&kernels);
+        }
+    }
+    return variants;
+}
+
+float relativeError(float value, float reference) {
+    return std::abs(value - reference) / std::max(std::abs(reference), 1e-30f);
+}
+
+} // namespace
+
+TEST(VectorKernelsTest, SimdVariantsMatchScalarReference) {
+    const VectorKernels& scalar = vectorKernels(utils::SimdLevel::SCALAR);
+    // 长度不是向量宽度的倍数，覆盖尾部处理
+    const size_t size = 1003;
+    const std::vector<float> exponents = uniform(size, -80.0f, 80.0f, 1);
+    const std::vector<float> prices = uniform(size, 1e-3f, 5000.0f, 2);
+    const std::vector<float> volumes = uniform(size, 0.0f, 1000.0f, 3);
+    const std::vector<float> returns = uniform(size, -0.01f, 0.012f, 4);
+    std::vector<float> expected(size);
+    std::vector<float> actual(size);
+
+    for (const VectorKernels* kernels : simdVariants()) {
+        SCOPED_TRACE(utils::simdLevelName(kernels->level));
+
+        scalar.exp(exponents.data(), expected.data(), size);
+        kernels->exp(exponents.data(), actual.data(), size);
+        for (size_t i = 0; i < size; ++i) {
+            ASSERT_LT(relativeError(actual[i], expected[i]), 4e-7f) << "exp(" << exponents[i] << ")";
+        }
+
+        scalar.log(prices.data(), expected.data(), size);
+        kernels->log(prices.data(), actual.data(), size);
+        for (size_t i = 0; i < size; ++i) {
+            ASSERT_NEAR(actual[i], expected[i], 4e-7f * std::max(1.0f, std::abs(expected[i])))
+                << "log(" << prices[i] << ")";
+        }
+
+        scalar.features(prices.data(), expected.data(), size);
+        kernels->features(prices.data(), actual.data(), size);
+        for (size_t i = 0; i < size; ++i) {
+            ASSERT_NEAR(actual[i], expected[i], 1e-6f * std::max(1.0f, std::abs(expected[i])));
+        }
+
+        EXPECT_LT(relativeError(kernels->vwap(prices.data(), volumes.data(), size),
+                                scalar.vwap(prices.data(), volumes.data(), size)), 1e-5f);
+        EXPECT_LT(relativeError(kernels->volatility(returns.data(), size),
+                                scalar.volatility(returns.data(), size)), 1e-4f);
+        EXPECT_LT(relativeError(kernels->momentum(prices.data(), size, 5),
+                                scalar.momentum(prices.data(), size, 5)), 1e-4f);
+        EXPECT_NEAR(kernels->orderImbalance(volumes.data(), prices.data(), size),
+                    scalar.orderImbalance(volumes.data(), prices.data(), size), 1e-6f);
+    }
+
+    // 特殊值
+    const float special[] = {0.0f, -1.0f, INFINITY, 1.0f};
+    float out[4];
+    for (const VectorKernels* kernels : simdVariants()) {
+        kernels->log(special, out, 4);
+        EXPECT_EQ(out[0], -INFINITY);
+        EXPECT_TRUE(std::isnan(out[1]));
+        EXPECT_EQ(out[2], INFINITY);
+        EXPECT_EQ(out[3], 0.0f);
+    }
+    EXPECT_EQ(vectorKernels().level, utils::detectSimdLevel());
+}
+
+TEST(VectorKernelsTest, ThroughputByVariant) {
+    const size_t size = 1 << 16;
+    const int rounds = 50;
+    const std::vector<float> prices = uniform(size, 1.0f, 500.0f, 5);
+    const std::vector<float> volumes = uniform(size, 0.0f, 1000.0f, 6);
+    std::vector<float> output(size);
+
+    std::vector<const VectorKernels*> variants = {&vectorKernels(utils::SimdLevel::SCALAR)};
+    for (const VectorKernels* kernels : simdVariants()) {
+        variants.push_back(kernels);
+    }
+
+    double scalarNs = 0.0;
+    for (const VectorKernels* kernels : variants) {
+        float sink = 0.0f;
+        const auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            kernels->features(prices.data(), output.data(), size);
+            sink += output[r] + kernels->vwap(prices.data(), volumes.data(), size);
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                          (static_cast<double>(rounds) * size);
+        if (kernels->level == utils::SimdLevel::SCALAR) {
+            scalarNs = ns;
+        }
+        std::cout << "[ VECTOR   ] " << utils::simdLevelName(kernels->level) << ": " << ns << " ns/element"
+                  << " (x" << scalarNs / ns << ")" << std::endl;
+        EXPECT_TRUE(std::isfinite(sink));
+    }
+}
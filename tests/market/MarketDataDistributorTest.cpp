@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "market/MarketDataDistributor.h"
+
+using namespace hft::market;
+
+namespace {
+
+std::shared_ptr<MarketData> tick(const std::string& symbol, double price) {
+    auto data = std::make_shared<MarketData>();
+    data->symbol = symbol;
+    data->last_price = price;
+    return data;
+}
+
+template <typename Pred>
+bool waitFor(Pred pred) {
+    for (int i = 0; i < 2000 && !pred(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return pred();
+}
+
+} // namespace
+
+TEST(MarketDataDistributorTest, InlineAndQueuedConsumersReceiveFilteredSymbols) {
+    DistributorConfig config;
+    config.dispatcher_threads = 2;
+    MarketDataDistributor distributor(config);
+    MarketDataQueue a(64);
+    MarketDataQueue b(64);
+    distributor.addDataQueue("DIST.A", &a);
+    distributor.addDataQueue("DIST.B", &b);
+
+    std::atomic<int> inlineCount{0};
+    std::atomic<int> queuedCount{0};
+    distributor.registerCallback("DIST.A", [&](const std::shared_ptr<MarketData>& data) {
+        EXPECT_EQ(data->symbol, "DIST.A");
+        ++inlineCount;
+    });
+    ConsumerConfig all;
+    all.name = "all";
+    auto id = distributor.registerConsumer(all, [&](const std::shared_ptr<MarketData>&) { ++queuedCount; });
+
+    distributor.start();
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(a.try_push(tick("DIST.A", i)));
+        ASSERT_TRUE(b.try_push(tick("DIST.B", i)));
+    }
+    EXPECT_TRUE(waitFor([&] { return inlineCount == 10 && queuedCount == 20; }));
+    distributor.stop();
+
+    auto stats = distributor.getConsumerStats(id);
+    EXPECT_EQ(stats.delivered, 20u);
+    EXPECT_EQ(stats.dropped, 0u);
+}
+
+TEST(MarketDataDistributorTest, SlowConflatedConsumerSeesLatestWithoutBlockingOthers) {
+    DistributorConfig config;
+    config.dispatcher_threads = 1;
+    MarketDataDistributor distributor(config);
+    MarketDataQueue queue(1024);
+    distributor.addDataQueue("DIST.C", &queue);
+
+    std::atomic<bool> release{false};
+    std::atomic<double> lastSeen{-1.0};
+    ConsumerConfig slow;
+    slow.name = "slow";
+    slow.mode = DeliveryMode::CONFLATED;
+    auto slowId = distributor.registerConsumer(slow, [&](const std::shared_ptr<MarketData>& data) {
+        while (!release) {
+            std::this_thread::yield();
+        }
+        lastSeen = data->last_price;
+    });
+    std::atomic<int> fastCount{0};
+    ConsumerConfig fast;
+    fast.name = "fast";
+    fast.mode = DeliveryMode::INLINE;
+    distributor.registerConsumer(fast, [&](const std::shared_ptr<MarketData>&) { ++fastCount; });
+
+    distributor.start();
+    for (int i = 0; i < 500; ++i) {
+        ASSERT_TRUE(queue.try_push(tick("DIST.C", i)));
+    }
+    // 慢消费者阻塞期间，其他消费者照常收到全部数据
+    EXPECT_TRUE(waitFor([&] { return fastCount == 500; }));
+    release = true;
+    EXPECT_TRUE(waitFor([&] { return lastSeen == 499.0; }));
+    distributor.stop();
+
+    auto stats = distributor.getConsumerStats(slowId);
+    EXPECT_LT(stats.delivered, 500u);
+    EXPECT_EQ(stats.delivered + stats.conflated, 500u);
+}
+
+TEST(MarketDataDistributorTest, FullQueueDropsInsteadOfBlocking) {
+    DistributorConfig config;
+    config.dispatcher_threads = 1;
+    MarketDataDistributor distributor(config);
+    MarketDataQueue queue(1024);
+    distributor.addDataQueue("DIST.D", &queue);
+
+    std::atomic<bool> release{false};
+    ConsumerConfig slow;
+    slow.name = "slow";
+    slow.queue_capacity = 8;
+    auto id = distributor.registerConsumer(slow, [&](const std::shared_ptr<MarketData>&) {
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+
+    distributor.start();
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(queue.try_push(tick("DIST.D", i)));
+    }
+    EXPECT_TRUE(waitFor([&] { return queue.size() == 0 && distributor.getConsumerStats(id).dropped > 0; }));
+    release = true;
+    EXPECT_TRUE(waitFor([&] {
+        auto stats = distributor.getConsumerStats(id);
+        return stats.delivered + stats.dropped == 100;
+    }));
+    distributor.stop();
+}
+
+TEST(MarketDataDistributorTest, InlineCallbacksCanUnregisterAcrossShards) {
+    DistributorConfig config;
+    config.dispatcher_threads = 2;
+    MarketDataDistributor distributor(config);
+    MarketDataQueue a(64);
+    MarketDataQueue b(64);
+    distributor.addDataQueue("DIST.X", &a);
+    distributor.addDataQueue("DIST.Y", &b);
+
+    // 两个INLINE消费者在各自的分发线程上互相注销，并移除自己的队列；
+    // 无论两个品种是否落在同一分片，回调内的注销与移除都不能等待分发线程
+    std::atomic<MarketDataDistributor::ConsumerId> xId{0};
+    std::atomic<MarketDataDistributor::ConsumerId> yId{0};
+    std::atomic<int> xReturned{0};
+    std::atomic<int> yReturned{0};
+    ConsumerConfig x;
+    x.name = "x";
+    x.mode = DeliveryMode::INLINE;
+    x.symbols = {"DIST.X"};
+    xId = distributor.registerConsumer(x, [&](const std::shared_ptr<MarketData>&) {
+        distributor.unregisterConsumer(yId);
+        distributor.removeDataQueue("DIST.X");
+        ++xReturned;
+    });
+    ConsumerConfig y = x;
+    y.name = "y";
+    y.symbols = {"DIST.Y"};
+    yId = distributor.registerConsumer(y, [&](const std::shared_ptr<MarketData>&) {
+        distributor.unregisterConsumer(xId);
+        distributor.removeDataQueue("DIST.Y");
+        ++yReturned;
+    });
+
+    distributor.start();
+    ASSERT_TRUE(a.try_push(tick("DIST.X", 1)));
+    ASSERT_TRUE(b.try_push(tick("DIST.Y", 1)));
+    EXPECT_TRUE(waitFor([&] { return xReturned + yReturned >= 1; }));
+    // 队列已移除、消费者已注销，之后写入的数据不再回调
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    a.try_push(tick("DIST.X", 2));
+    b.try_push(tick("DIST.Y", 2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    distributor.stop();
+
+    EXPECT_LE(xReturned.load(), 1);
+    EXPECT_LE(yReturned.load(), 1);
+    // 先回调的一方注销了另一方时，另一方的队列仍在
+    EXPECT_EQ(distributor.removeDataQueue("DIST.X"), xReturned == 0);
+    EXPECT_EQ(distributor.removeDataQueue("DIST.Y"), yReturned == 0);
+}
+
+TEST(MarketDataDistributorTest, UnregisteredConsumerSlotsAreReused) {
+    DistributorConfig config;
+    config.dispatcher_threads = 2;
+    MarketDataDistributor distributor(config);
+    MarketDataQueue queue(64);
+    distributor.addDataQueue("DIST.R", &queue);
+    distributor.start();
+
+    for (int i = 0; i < 200; ++i) {
+        ConsumerConfig consumer;
+        consumer.name = "churn" + std::to_string(i);
+        consumer.mode = i % 2 == 0 ? DeliveryMode::QUEUED : DeliveryMode::INLINE;
+        consumer.symbols = {"DIST.R"};
+        const auto id = distributor.registerConsumer(consumer, [](const std::shared_ptr<MarketData>&) {});
+        ASSERT_TRUE(distributor.unregisterConsumer(id));
+    }
+
+    std::atomic<int> received{0};
+    ConsumerConfig live;
+    live.name = "live";
+    live.symbols = {"DIST.R"};
+    const auto liveId = distributor.registerConsumer(live, [&](const std::shared_ptr<MarketData>&) { ++received; });
+    ASSERT_TRUE(queue.try_push(tick("DIST.R", 1)));
+    EXPECT_TRUE(waitFor([&] { return received == 1; }));
+    distributor.stop();
+
+    // 反复注册/注销不会让消费者表无限增长
+    EXPECT_LE(distributor.getAllConsumerStats().size(), 2u);
+    EXPECT_EQ(distributor.getConsumerStats(liveId).name, "live");
+}
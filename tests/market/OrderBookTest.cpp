@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "market/MarketData.h"
+#include "market/PriceLevelBook.h"
+
+using namespace hft;
+using namespace hft::market;
+
+namespace {
+
+L2Data makeSnapshot() {
+    L2Data data;
+    data.symbol = "AAPL";
+    data.bids = {{1500000, 100}, {1499900, 200}, {1499800, 300}};
+    data.asks = {{1500100, 150}, {1500200, 250}};
+    return data;
+}
+
+} // namespace
+
+TEST(PriceLevelBookTest, SnapshotSetsTopOfBook) {
+    OrderBook book;
+    book.update(makeSnapshot());
+
+    EXPECT_EQ(book.getBestBid(), 1500000);
+    EXPECT_EQ(book.getBestAsk(), 1500100);
+    EXPECT_DOUBLE_EQ(book.getMidPrice(), 1500050.0);
+    EXPECT_EQ(book.getVolumeAtPrice(1499900), 200);
+    EXPECT_EQ(book.getVolumeAtPrice(1500200), 250);
+    EXPECT_EQ(book.getVolumeAtPrice(1400000), 0);
+}
+
+TEST(PriceLevelBookTest, DeleteBestFindsNextLevel) {
+    PriceLevelBook book(100);
+    book.updateLevel(types::Side::BUY, 1500000, 10);
+    book.updateLevel(types::Side::BUY, 1490000, 20);
+    book.updateLevel(types::Side::SELL, 1500100, 5);
+    book.updateLevel(types::Side::SELL, 1510000, 7);
+
+    book.deleteLevel(types::Side::BUY, 1500000);
+    EXPECT_EQ(book.bestBid(), 1490000);
+    book.deleteLevel(types::Side::SELL, 1500100);
+    EXPECT_EQ(book.bestAsk(), 1510000);
+
+    book.deleteLevel(types::Side::BUY, 1490000);
+    EXPECT_EQ(book.bestBid(), 0);
+    EXPECT_EQ(book.levelCount(types::Side::BUY), 0u);
+}
+
+TEST(PriceLevelBookTest, VwapIsMaintainedIncrementally) {
+    PriceLevelBook book(100);
+    book.updateLevel(types::Side::BUY, 1000, 1);
+    book.updateLevel(types::Side::SELL, 2000, 3);
+    EXPECT_DOUBLE_EQ(book.vwap(), (1000.0 * 1 + 2000.0 * 3) / 4.0);
+
+    book.updateLevel(types::Side::SELL, 2000, 1);
+    EXPECT_DOUBLE_EQ(book.vwap(), 1500.0);
+
+    // 快照重置累计量
+    L2Data data = makeSnapshot();
+    book.applySnapshot(data.bids, data.asks);
+    double notional = 0.0;
+    double volume = 0.0;
+    for (const auto& l : data.bids) { notional += double(l.price) * l.volume; volume += l.volume; }
+    for (const auto& l : data.asks) { notional += double(l.price) * l.volume; volume += l.volume; }
+    EXPECT_NEAR(book.vwap(), notional / volume, 1e-6);
+}
+
+TEST(PriceLevelBookTest, WindowFollowsTouchAcrossWrap) {
+    PriceLevelBook book(1);
+    const int64_t cap = static_cast<int64_t>(PriceLevelBook::kLadderCapacity);
+
+    book.updateLevel(types::Side::BUY, 10000, 1);
+    book.updateLevel(types::Side::BUY, 10000 - cap * 3 / 4, 2);  // 接近窗口底部
+    // 价格上移超出窗口，窗口平移并淘汰最深档位
+    book.updateLevel(types::Side::BUY, 10000 + cap / 4, 3);
+    EXPECT_EQ(book.bestBid(), 10000 + cap / 4);
+    EXPECT_EQ(book.volumeAt(types::Side::BUY, 10000 - cap * 3 / 4), 0);
+    EXPECT_EQ(book.droppedLevels(), 1u);
+
+    book.deleteLevel(types::Side::BUY, 10000 + cap / 4);
+    EXPECT_EQ(book.bestBid(), 10000);
+
+    size_t seen = book.forEachLevel(types::Side::BUY, 10, [](types::Price, types::Volume) {});
+    EXPECT_EQ(seen, 1u);
+}
+
+TEST(OrderBookSeqLockTest, ReadersSeeConsistentSnapshots) {
+    OrderBook book(100, OrderBook::ConcurrencyMode::SINGLE_WRITER);
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            BookSnapshot snapshot = book.getSnapshot();
+            if (snapshot.bid_levels == 1 && snapshot.ask_levels == 1 &&
+                snapshot.bids[0].volume != snapshot.asks[0].volume) {
+                torn.fetch_add(1);
+            }
+        }
+    });
+
+    L2Data data = makeSnapshot();
+    data.bids.resize(1);
+    data.asks.resize(1);
+    for (int i = 1; i <= 100000; ++i) {
+        data.bids[0].volume = i;
+        data.asks[0].volume = i;
+        book.update(data);
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(book.getSnapshot().update_count, 100000u);
+    EXPECT_EQ(book.getBestBid(), 1500000);
+    EXPECT_EQ(book.getVolumeAtPrice(1500100), 100000);
+}
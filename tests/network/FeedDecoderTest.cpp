@@ -0,0 +1,311 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "network/BookBuilder.h"
+#include "network/FeedReplay.h"
+#include "network/ItchDecoder.h"
+
+using namespace hft;
+using namespace hft::network;
+
+namespace {
+
+// 线路格式构造工具
+struct MessageWriter {
+    std::vector<uint8_t> bytes;
+
+    MessageWriter& u8(uint8_t v) { bytes.push_back(v); return *this; }
+    MessageWriter& u16(uint16_t v) { return u8(static_cast<uint8_t>(v >> 8)).u8(static_cast<uint8_t>(v)); }
+    MessageWriter& u32(uint32_t v) { return u16(static_cast<uint16_t>(v >> 16)).u16(static_cast<uint16_t>(v)); }
+    MessageWriter& u48(uint64_t v) { return u16(static_cast<uint16_t>(v >> 32)).u32(static_cast<uint32_t>(v)); }
+    MessageWriter& u64(uint64_t v) { return u32(static_cast<uint32_t>(v >> 32)).u32(static_cast<uint32_t>(v)); }
+    MessageWriter& alpha(const std::string& s, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            u8(i < s.size() ? static_cast<uint8_t>(s[i]) : ' ');
+        }
+        return *this;
+    }
+    MessageWriter& header(char type, uint16_t locate, uint64_t ts) {
+        return u8(static_cast<uint8_t>(type)).u16(locate).u16(0).u48(ts);
+    }
+};
+
+std::vector<uint8_t> directory(uint16_t locate, const std::string& stock) {
+    MessageWriter w;
+    w.header('R', locate, 1).alpha(stock, 8);
+    w.bytes.resize(itch::StockDirectoryView::kSize, 0);
+    return w.bytes;
+}
+
+std::vector<uint8_t> addOrder(uint16_t locate, uint64_t ref, char side, uint32_t shares,
+                              const std::string& stock, uint32_t price) {
+    MessageWriter w;
+    w.header('A', locate, 2).u64(ref).u8(static_cast<uint8_t>(side)).u32(shares).alpha(stock, 8).u32(price);
+    return w.bytes;
+}
+
+std::vector<uint8_t> executed(uint16_t locate, uint64_t ref, uint32_t shares) {
+    MessageWriter w;
+    w.header('E', locate, 3).u64(ref).u32(shares).u64(99);
+    return w.bytes;
+}
+
+std::vector<uint8_t> cancel(uint16_t locate, uint64_t ref, uint32_t shares) {
+    MessageWriter w;
+    w.header('X', locate, 4).u64(ref).u32(shares);
+    return w.bytes;
+}
+
+std::vector<uint8_t> deleteOrder(uint16_t locate, uint64_t ref) {
+    MessageWriter w;
+    w.header('D', locate, 5).u64(ref);
+    return w.bytes;
+}
+
+std::vector<uint8_t> replace(uint16_t locate, uint64_t oldRef, uint64_t newRef, uint32_t shares, uint32_t price) {
+    MessageWriter w;
+    w.header('U', locate, 6).u64(oldRef).u64(newRef).u32(shares).u32(price);
+    return w.bytes;
+}
+
+std::vector<uint8_t> moldPacket(uint64_t sequence, const std::vector<std::vector<uint8_t>>& messages) {
+    MessageWriter w;
+    w.alpha("SESSION01", 10).u64(sequence).u16(static_cast<uint16_t>(messages.size()));
+    for (const auto& m : messages) {
+        w.u16(static_cast<uint16_t>(m.size()));
+        w.bytes.insert(w.bytes.end(), m.begin(), m.end());
+    }
+    return w.bytes;
+}
+
+class RecordingListener : public BookListener {
+public:
+    void onBookUpdate(core::SymbolId, types::Side, types::Price, types::Volume,
+                      const market::PriceLevelBook&) override {
+        ++updates;
+    }
+    void onTrade(core::SymbolId symbol, types::Side side, types::Price price,
+                 types::Volume volume, uint64_t) override {
+        lastTradeSymbol = symbol;
+        lastTradeSide = side;
+        lastTradePrice = price;
+        tradedVolume += volume;
+    }
+
+    int updates = 0;
+    core::SymbolId lastTradeSymbol = core::kInvalidSymbol;
+    types::Side lastTradeSide = types::Side::BUY;
+    types::Price lastTradePrice = 0;
+    types::Volume tradedVolume = 0;
+};
+
+} // namespace
+
+TEST(FeedDecoderTest, BuildsBookFromOrderMessages) {
+    BookBuilder books(1024);
+    RecordingListener listener;
+    books.setListener(&listener);
+    ItchDecoder<BookBuilder> decoder(books);
+
+    auto packet = moldPacket(1, {
+        directory(7, "MSFT"),
+        addOrder(7, 1, 'B', 100, "MSFT", 4000000),
+        addOrder(7, 2, 'B', 50, "MSFT", 3999900),
+        addOrder(7, 3, 'S', 80, "MSFT", 4000100),
+        executed(7, 1, 30),
+        cancel(7, 3, 20),
+        replace(7, 2, 4, 60, 4000000),
+    });
+    EXPECT_EQ(decoder.decodePacket(packet.data(), packet.size()), 7u);
+    EXPECT_EQ(decoder.stats().last_sequence, 1u);
+
+    const market::PriceLevelBook* book = books.book(7);
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(core::symbolName(books.symbolOf(7)), "MSFT");
+    EXPECT_EQ(book->bestBid(), 4000000);
+    EXPECT_EQ(book->bestBidVolume(), (70 + 60) * 10000);
+    EXPECT_EQ(book->volumeAt(types::Side::BUY, 3999900), 0);
+    EXPECT_EQ(book->bestAsk(), 4000100);
+    EXPECT_EQ(book->bestAskVolume(), 60 * 10000);
+    EXPECT_EQ(books.liveOrders(), 3u);
+
+    EXPECT_EQ(listener.lastTradeSymbol, books.symbolOf(7));
+    EXPECT_EQ(listener.lastTradeSide, types::Side::BUY);
+    EXPECT_EQ(listener.lastTradePrice, 4000000);
+    EXPECT_EQ(listener.tradedVolume, 30 * 10000);
+
+    auto removal = moldPacket(8, {deleteOrder(7, 1), deleteOrder(7, 4), executed(7, 3, 60), deleteOrder(7, 42)});
+    decoder.decodePacket(removal.data(), removal.size());
+    EXPECT_EQ(books.liveOrders(), 0u);
+    EXPECT_EQ(books.unknownOrders(), 1u);
+    EXPECT_EQ(book->levelCount(types::Side::BUY), 0u);
+    EXPECT_EQ(book->levelCount(types::Side::SELL), 0u);
+}
+
+TEST(FeedDecoderTest, DuplicateOrderRefReplacesTheOldShares) {
+    BookBuilder books(64);
+    ItchDecoder<BookBuilder> decoder(books);
+
+    auto packet = moldPacket(1, {
+        directory(5, "NVDA"),
+        addOrder(5, 9, 'B', 100, "NVDA", 2000000),
+        addOrder(5, 9, 'B', 40, "NVDA", 1999900),
+    });
+    EXPECT_EQ(decoder.decodePacket(packet.data(), packet.size()), 3u);
+
+    // 旧订单的100股从原价位移除，只保留新消息
+    const market::PriceLevelBook* book = books.book(5);
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(books.liveOrders(), 1u);
+    EXPECT_EQ(books.duplicateOrders(), 1u);
+    EXPECT_EQ(book->volumeAt(types::Side::BUY, 2000000), 0);
+    EXPECT_EQ(book->bestBid(), 1999900);
+    EXPECT_EQ(book->bestBidVolume(), 40 * 10000);
+
+    auto removal = moldPacket(4, {deleteOrder(5, 9)});
+    decoder.decodePacket(removal.data(), removal.size());
+    EXPECT_EQ(book->levelCount(types::Side::BUY), 0u);
+}
+
+TEST(FeedDecoderTest, RejectsTruncatedMessages) {
+    BookBuilder books(16);
+    ItchDecoder<BookBuilder> decoder(books);
+
+    auto add = addOrder(1, 1, 'B', 10, "IBM", 1000000);
+    add.resize(add.size() - 1);
+    EXPECT_EQ(decoder.decodeMessage(add.data(), add.size()), 0u);
+    EXPECT_EQ(decoder.stats().malformed, 1u);
+
+    // 包内声明的消息数多于实际内容
+    auto packet = moldPacket(1, {addOrder(1, 1, 'B', 10, "IBM", 1000000)});
+    packet[19] = 2;
+    EXPECT_EQ(decoder.decodePacket(packet.data(), packet.size()), 1u);
+    EXPECT_EQ(decoder.stats().malformed, 2u);
+}
+
+TEST(FeedDecoderTest, SnapshotReplacesOrderState) {
+    BookBuilder books(64);
+    ItchDecoder<BookBuilder> decoder(books);
+
+    auto add = addOrder(3, 11, 'B', 10, "AAPL", 1500000);
+    decoder.decodeMessage(add.data(), add.size());
+    EXPECT_EQ(books.liveOrders(), 1u);
+
+    MessageWriter w;
+    w.header('b', 3, 10).u8(2).u8(1);
+    w.u32(1500100).u32(5).u32(1500000).u32(7);
+    w.u32(1500200).u32(9);
+    EXPECT_EQ(decoder.decodeMessage(w.bytes.data(), w.bytes.size()), 1u);
+
+    const market::PriceLevelBook* book = books.book(3);
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(books.liveOrders(), 0u);
+    EXPECT_EQ(book->bestBid(), 1500100);
+    EXPECT_EQ(book->volumeAt(types::Side::BUY, 1500000), 7 * 10000);
+    EXPECT_EQ(book->bestAsk(), 1500200);
+}
+
+TEST(FeedDecoderTest, SnapshotLeavesOtherSymbolsOrdersIntact) {
+    BookBuilder books(64);
+    ItchDecoder<BookBuilder> decoder(books);
+
+    // 两个标的的订单交错写入，哈希表中互相穿插
+    for (uint64_t ref = 1; ref <= 40; ++ref) {
+        const uint16_t locate = ref % 2 == 0 ? 4 : 5;
+        auto add = addOrder(locate, ref, 'B', 10, locate == 4 ? "MSFT" : "AMZN",
+                            static_cast<uint32_t>(1000000 + ref * 100));
+        decoder.decodeMessage(add.data(), add.size());
+    }
+    EXPECT_EQ(books.liveOrders(), 40u);
+
+    MessageWriter w;
+    w.header('b', 4, 10).u8(1).u8(0);
+    w.u32(2000000).u32(3);
+    EXPECT_EQ(decoder.decodeMessage(w.bytes.data(), w.bytes.size()), 1u);
+    EXPECT_EQ(books.liveOrders(), 20u);
+
+    // 另一标的的订单仍可成交，快照标的的旧订单号已失效
+    for (uint64_t ref = 1; ref <= 40; ref += 2) {
+        auto exec = executed(5, ref, 10);
+        decoder.decodeMessage(exec.data(), exec.size());
+    }
+    EXPECT_EQ(books.liveOrders(), 0u);
+    auto stale = executed(4, 2, 10);
+    decoder.decodeMessage(stale.data(), stale.size());
+    EXPECT_EQ(books.unknownOrders(), 1u);
+
+    // 释放的节点可以重新使用
+    for (uint64_t ref = 100; ref < 164; ++ref) {
+        auto add = addOrder(4, ref, 'S', 1, "MSFT", 2100000);
+        decoder.decodeMessage(add.data(), add.size());
+    }
+    EXPECT_EQ(books.liveOrders(), 64u);
+    EXPECT_EQ(books.droppedOrders(), 0u);
+}
+
+TEST(FeedDecoderTest, ReplaysPcapCapture) {
+    // 构造含两个UDP包和一个非UDP帧的pcap
+    auto udpFrame = [](uint16_t port, const std::vector<uint8_t>& payload) {
+        MessageWriter w;
+        w.alpha("", 12).u16(0x0800);
+        w.u8(0x45).u8(0).u16(static_cast<uint16_t>(20 + 8 + payload.size())).u32(0).u8(64).u8(17).u16(0);
+        w.u32(0x0A000001).u32(0xE0000001);
+        w.u16(30000).u16(port).u16(static_cast<uint16_t>(8 + payload.size())).u16(0);
+        w.bytes.insert(w.bytes.end(), payload.begin(), payload.end());
+        return w.bytes;
+    };
+    auto le32 = [](std::vector<uint8_t>& out, uint32_t v) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+        }
+    };
+
+    std::vector<std::vector<uint8_t>> frames = {
+        udpFrame(26400, moldPacket(1, {addOrder(2, 1, 'S', 10, "QQQ", 3000000)})),
+        udpFrame(26401, moldPacket(1, {addOrder(2, 9, 'S', 99, "QQQ", 2000000)})),
+        udpFrame(26400, moldPacket(2, {addOrder(2, 2, 'S', 20, "QQQ", 3000000), executed(2, 1, 10)})),
+    };
+    std::vector<uint8_t> arp(42, 0);
+    arp[12] = 0x08;
+    arp[13] = 0x06;
+    frames.push_back(arp);
+
+    std::vector<uint8_t> file;
+    le32(file, 0xA1B2C3D4);
+    file.insert(file.end(), {2, 0, 4, 0});
+    le32(file, 0);
+    le32(file, 0);
+    le32(file, 65535);
+    le32(file, 1);
+    for (const auto& frame : frames) {
+        le32(file, 0);
+        le32(file, 0);
+        le32(file, static_cast<uint32_t>(frame.size()));
+        le32(file, static_cast<uint32_t>(frame.size()));
+        file.insert(file.end(), frame.begin(), frame.end());
+    }
+
+    const std::string path = ::testing::TempDir() + "feed_decoder_test.pcap";
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::fwrite(file.data(), 1, file.size(), f);
+    std::fclose(f);
+
+    BookBuilder books(64);
+    ItchDecoder<BookBuilder> decoder(books);
+    FeedReplayStats stats;
+    ASSERT_TRUE(FeedReplay::replayPcap(path, decoder, &stats, 26400));
+    std::remove(path.c_str());
+
+    EXPECT_EQ(stats.records, 4u);
+    EXPECT_EQ(stats.packets, 2u);
+    EXPECT_EQ(stats.messages, 3u);
+    EXPECT_EQ(stats.skipped, 2u);
+    EXPECT_EQ(decoder.stats().last_sequence, 2u);
+
+    const market::PriceLevelBook* book = books.book(2);
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(book->bestAsk(), 3000000);
+    EXPECT_EQ(book->bestAskVolume(), 20 * 10000);
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "network/LineArbitrator.h"
+
+using namespace hft::network;
+
+namespace {
+
+// 记录交付顺序的解码器：每条消息只含一个u64载荷
+class RecordingDecoder : public FeedDecoder {
+public:
+    size_t decodePacket(const uint8_t* data, size_t size) override {
+        ++m_stats.packets;
+        if (size < itch::kMoldHeaderSize) {
+            ++m_stats.malformed;
+            return 0;
+        }
+        return decodeStream(data + itch::kMoldHeaderSize, size - itch::kMoldHeaderSize);
+    }
+
+    size_t decodeStream(const uint8_t* data, size_t size) override {
+        size_t offset = 0;
+        size_t decoded = 0;
+        while (offset + 2 <= size) {
+            const uint16_t length = wire::loadBE16(data + offset);
+            values.push_back(wire::loadBE64(data + offset + 2));
+            offset += 2 + length;
+            ++decoded;
+        }
+        return decoded;
+    }
+
+    std::vector<uint64_t> values;
+};
+
+// 序号为sequence、含count条消息的MoldUDP64包，第i条消息载荷为sequence + i
+std::vector<uint8_t> packet(uint64_t sequence, uint16_t count) {
+    std::vector<uint8_t> out(itch::kMoldHeaderSize, ' ');
+    for (int i = 0; i < 8; ++i) {
+        out[10 + i] = static_cast<uint8_t>(sequence >> (56 - 8 * i));
+    }
+    out[18] = static_cast<uint8_t>(count >> 8);
+    out[19] = static_cast<uint8_t>(count);
+    for (uint16_t m = 0; m < count; ++m) {
+        out.push_back(0);
+        out.push_back(8);
+        const uint64_t value = sequence + m;
+        for (int i = 0; i < 8; ++i) {
+            out.push_back(static_cast<uint8_t>(value >> (56 - 8 * i)));
+        }
+    }
+    return out;
+}
+
+void send(LineArbitrator& arbitrator, FeedLine line, uint64_t sequence, uint16_t count, uint64_t now) {
+    auto p = packet(sequence, count);
+    arbitrator.onPacket(line, p.data(), p.size(), now);
+}
+
+std::vector<uint64_t> range(uint64_t from, uint64_t to) {
+    std::vector<uint64_t> out;
+    for (uint64_t v = from; v < to; ++v) {
+        out.push_back(v);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(LineArbitratorTest, TakesFirstArrivalAndDropsDuplicates) {
+    RecordingDecoder decoder;
+    LineArbitrator arbitrator(decoder);
+
+    send(arbitrator, FeedLine::A, 1, 2, 100);
+    send(arbitrator, FeedLine::B, 1, 2, 110);
+    send(arbitrator, FeedLine::B, 3, 3, 120);
+    send(arbitrator, FeedLine::A, 3, 3, 130);
+    send(arbitrator, FeedLine::A, 6, 1, 140);
+
+    EXPECT_EQ(decoder.values, range(1, 7));
+    EXPECT_EQ(arbitrator.stats().first_arrivals[0], 2u);
+    EXPECT_EQ(arbitrator.stats().first_arrivals[1], 1u);
+    EXPECT_EQ(arbitrator.stats().duplicates, 2u);
+    EXPECT_FALSE(arbitrator.hasGap());
+    EXPECT_EQ(arbitrator.nextSequence(), 7u);
+}
+
+TEST(LineArbitratorTest, OtherLineFillsGapFromReorderBuffer) {
+    RecordingDecoder decoder;
+    LineArbitrator arbitrator(decoder);
+    int recoveries = 0;
+    arbitrator.setRecoveryHandler([&](uint64_t, uint64_t) { ++recoveries; });
+
+    // A线路丢失序号3-4的包，后续包先进入缓存，B线路补上后按序释放
+    send(arbitrator, FeedLine::A, 1, 2, 0);
+    send(arbitrator, FeedLine::A, 5, 2, 10);
+    send(arbitrator, FeedLine::A, 7, 1, 20);
+    EXPECT_TRUE(arbitrator.hasGap());
+    EXPECT_EQ(decoder.values, range(1, 3));
+
+    send(arbitrator, FeedLine::B, 3, 2, 30);
+    EXPECT_FALSE(arbitrator.hasGap());
+    EXPECT_EQ(decoder.values, range(1, 8));
+    EXPECT_EQ(arbitrator.stats().gaps, 1u);
+    EXPECT_EQ(arbitrator.stats().buffered, 2u);
+    EXPECT_EQ(recoveries, 0);
+
+    // 迟到的B线路包全部是重复
+    send(arbitrator, FeedLine::B, 5, 2, 40);
+    send(arbitrator, FeedLine::B, 7, 1, 50);
+    EXPECT_EQ(decoder.values, range(1, 8));
+}
+
+TEST(LineArbitratorTest, PartiallyOverlappingPacketDeliversOnlyNewMessages) {
+    RecordingDecoder decoder;
+    LineArbitrator arbitrator(decoder);
+
+    send(arbitrator, FeedLine::A, 1, 3, 0);
+    send(arbitrator, FeedLine::RECOVERY, 2, 4, 10);
+    EXPECT_EQ(decoder.values, range(1, 6));
+}
+
+TEST(LineArbitratorTest, RequestsRecoveryAfterTimeoutAndResumesFromSnapshot) {
+    RecordingDecoder decoder;
+    LineArbitratorConfig config;
+    config.gap_timeout_ns = 1000;
+    LineArbitrator arbitrator(decoder, config);
+
+    std::vector<std::pair<uint64_t, uint64_t>> requests;
+    arbitrator.setRecoveryHandler([&](uint64_t from, uint64_t to) { requests.emplace_back(from, to); });
+
+    send(arbitrator, FeedLine::A, 1, 1, 0);
+    send(arbitrator, FeedLine::A, 4, 2, 100);
+    send(arbitrator, FeedLine::B, 4, 2, 200);
+    EXPECT_TRUE(requests.empty());
+
+    arbitrator.poll(1200);
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0], std::make_pair(uint64_t{2}, uint64_t{6}));
+    // 同一个超时周期内不重复请求
+    arbitrator.poll(1500);
+    EXPECT_EQ(requests.size(), 1u);
+
+    // 快照覆盖到序号4，缓存的[4, 6)继续交付
+    arbitrator.resetSequence(4, 1600);
+    EXPECT_FALSE(arbitrator.hasGap());
+    EXPECT_EQ(decoder.values, (std::vector<uint64_t>{1, 4, 5}));
+    EXPECT_EQ(arbitrator.stats().skipped_messages, 2u);
+}
+
+TEST(LineArbitratorTest, HeartbeatRevealsTrailingGapAndWindowOverflowRequestsRecovery) {
+    RecordingDecoder decoder;
+    LineArbitratorConfig config;
+    config.reorder_capacity = 4;
+    LineArbitrator arbitrator(decoder, config);
+    int recoveries = 0;
+    arbitrator.setRecoveryHandler([&](uint64_t, uint64_t) { ++recoveries; });
+
+    send(arbitrator, FeedLine::A, 1, 1, 0);
+    send(arbitrator, FeedLine::A, 3, 0, 10);
+    EXPECT_TRUE(arbitrator.hasGap());
+
+    send(arbitrator, FeedLine::A, 20, 1, 20);
+    EXPECT_EQ(arbitrator.stats().overflows, 1u);
+    EXPECT_EQ(recoveries, 1);
+}
@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include "network/LoopbackExchange.h"
+
+using namespace hft;
+using namespace hft::network;
+
+// 统计测量窗口内的堆分配次数
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace {
+std::atomic<bool> g_countAllocations{false};
+std::atomic<uint64_t> g_allocations{0};
+} // namespace
+
+void* operator new(size_t size) {
+    if (g_countAllocations.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+struct RecordingListener : OrderSessionListener {
+    void onOrderAccepted(const OpenOrder&) override { ++accepted; }
+    void onOrderRejected(const OpenOrder&, uint32_t reason) override { ++rejected; lastReason = reason; }
+    void onOrderCanceled(const OpenOrder&) override { ++canceled; }
+    void onOrderReplaced(const OpenOrder& order, uint64_t orig) override { ++replaced; lastReplaced = order.client_order_id; lastOrig = orig; }
+    void onExecution(const OpenOrder&, types::Price, uint64_t quantity) override { filled += quantity; }
+
+    int accepted = 0;
+    int rejected = 0;
+    int canceled = 0;
+    int replaced = 0;
+    uint64_t filled = 0;
+    uint32_t lastReason = 0;
+    uint64_t lastReplaced = 0;
+    uint64_t lastOrig = 0;
+};
+
+const core::SymbolId kSymbol = core::internSymbol("OE.TEST");
+
+} // namespace
+
+TEST(OrderEntrySessionTest, OrderLifecycleThroughLoopbackExchange) {
+    LoopbackExchange exchange;
+    OrderEntrySession session(exchange);
+    RecordingListener listener;
+    session.setListener(&listener);
+    exchange.connect(&session);
+    ASSERT_TRUE(session.open());
+
+    const uint64_t a = session.sendNew(kSymbol, OrderSide::BUY, OrderType::LIMIT, 1000000, 100);
+    const uint64_t b = session.sendNew(kSymbol, OrderSide::SELL, OrderType::LIMIT, 1010000, 50);
+    EXPECT_EQ(a, 1u);
+    EXPECT_EQ(b, 2u);
+    EXPECT_EQ(session.findOrder(a)->status, OrderStatus::PENDING_NEW);
+    exchange.pump();
+    EXPECT_EQ(listener.accepted, 2);
+    EXPECT_EQ(session.findOrder(a)->status, OrderStatus::NEW);
+
+    exchange.execute(a, 40);
+    exchange.pump();
+    EXPECT_EQ(session.findOrder(a)->filled, 40u);
+    EXPECT_EQ(session.findOrder(a)->status, OrderStatus::PARTIALLY_FILLED);
+
+    const uint64_t c = session.sendReplace(a, 1005000, 120);
+    ASSERT_NE(c, 0u);
+    EXPECT_EQ(session.sendReplace(a, 1005000, 130), 0u);
+    exchange.pump();
+    EXPECT_EQ(listener.lastReplaced, c);
+    EXPECT_EQ(listener.lastOrig, a);
+    EXPECT_EQ(session.findOrder(a), nullptr);
+    EXPECT_EQ(session.findOrder(c)->price, 1005000);
+    EXPECT_EQ(session.findOrder(c)->remaining(), 80u);
+
+    EXPECT_TRUE(session.sendCancel(b));
+    exchange.pump();
+    EXPECT_EQ(listener.canceled, 1);
+    exchange.execute(c, 80);
+    exchange.pump();
+    EXPECT_EQ(listener.filled, 120u);
+    EXPECT_EQ(session.openOrders(), 0u);
+
+    exchange.rejectNext(oe::kRejectExchange);
+    session.sendNew(kSymbol, OrderSide::BUY, OrderType::LIMIT, 1000000, 10);
+    exchange.pump();
+    EXPECT_EQ(listener.rejected, 1);
+    EXPECT_EQ(listener.lastReason, static_cast<uint32_t>(oe::kRejectExchange));
+    EXPECT_EQ(session.openOrders(), 0u);
+    EXPECT_EQ(session.stats().unknown_orders, 0u);
+}
+
+TEST(OrderEntrySessionTest, LostMessagesAreResentFromJournal) {
+    LoopbackExchange exchange;
+    OrderEntrySession session(exchange);
+    RecordingListener listener;
+    session.setListener(&listener);
+    exchange.connect(&session);
+    ASSERT_TRUE(session.open());
+
+    // 客户端第2条消息丢失：交易所在第3条到达时请求重发
+    session.sendNew(kSymbol, OrderSide::BUY, OrderType::LIMIT, 1000000, 10);
+    exchange.dropInbound(1);
+    session.sendNew(kSymbol, OrderSide::BUY, OrderType::LIMIT, 1000000, 10);
+    session.sendNew(kSymbol, OrderSide::BUY, OrderType::LIMIT, 1000000, 10);
+    EXPECT_EQ(exchange.expectedInbound(), 2u);
+    exchange.pump();
+    EXPECT_EQ(exchange.expectedInbound(), 4u);
+    EXPECT_EQ(session.stats().messages_resent, 2u);
+
+    // 交易所回报丢失：会话检测到缺口后请求重发
+    exchange.pump();
+    EXPECT_EQ(listener.accepted, 3);
+    exchange.dropOutbound(1);
+    exchange.execute(1, 10);
+    exchange.execute(2, 10);
+    exchange.pump();
+    EXPECT_EQ(session.stats().inbound_gaps, 1u);
+    exchange.pump();
+    EXPECT_EQ(listener.filled, 20u);
+    EXPECT_EQ(session.openOrders(), 1u);
+}
+
+TEST(OrderEntrySessionTest, GapIsRequestedOnceAndFilledWithoutDuplicates) {
+    LoopbackExchange exchange;
+    OrderEntrySession session(exchange);
+    RecordingListener listener;
+    session.setListener(&listener);
+    exchange.connect(&session);
+    ASSERT_TRUE(session.open());
+
+    const uint64_t id = session.sendNew(kSymbol, OrderSide::BUY, OrderType::LIMIT, 1000000, 100);
+    exchange.pump();
+    ASSERT_EQ(listener.accepted, 1);
+
+    // 丢失一条回报，随后10条成交都越过缺口：只请求一次重发
+    exchange.dropOutbound(1);
+    for (int i = 0; i < 11; ++i) {
+        ASSERT_TRUE(exchange.execute(id, 1));
+    }
+    exchange.pump();
+    EXPECT_EQ(session.stats().inbound_gaps, 1u);
+    EXPECT_EQ(listener.filled, 0u);
+    exchange.pump();
+    EXPECT_EQ(listener.filled, 11u);
+    EXPECT_EQ(session.stats().inbound_gaps, 1u);
+    EXPECT_EQ(session.stats().duplicates_received, 0u);
+    EXPECT_EQ(session.expectedInbound(), exchange.nextOutbound());
+    EXPECT_EQ(exchange.pump(), 0u);
+
+    // 反方向相同：交易所丢失一条客户端消息后只请求一次，会话只重发一遍
+    exchange.dropInbound(1);
+    for (int i = 0; i < 10; ++i) {
+        session.sendNew(kSymbol, OrderSide::SELL, OrderType::LIMIT, 1010000, 1);
+    }
+    exchange.pump();
+    EXPECT_EQ(session.stats().messages_resent, 10u);
+    EXPECT_EQ(exchange.duplicates(), 0u);
+    EXPECT_EQ(exchange.expectedInbound(), session.nextSequence());
+    exchange.pump();
+    EXPECT_EQ(listener.accepted, 11);
+}
+
+TEST(OrderEntrySessionTest, LostResendRequestIsRetriedAfterTimeout) {
+    LoopbackExchange exchange;
+    OrderEntryConfig config;
+    config.resend_timeout_ns = 50000000;
+    OrderEntrySession session(exchange, config);
+    RecordingListener listener;
+    session.setListener(&listener);
+    exchange.connect(&session);
+    ASSERT_TRUE(session.open());
+
+    const uint64_t id = session.sendNew(kSymbol, OrderSide::BUY, OrderType::LIMIT, 1000000, 100);
+    exchange.pump();
+    ASSERT_EQ(listener.accepted, 1);
+
+    // 丢失一条回报，会话发出的重发请求也丢失：缺口一直存在
+    exchange.dropOutbound(1);
+    exchange.dropInbound(1);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(exchange.execute(id, 1));
+    }
+    exchange.pump();
+    EXPECT_EQ(exchange.pump(), 0u);
+    EXPECT_EQ(listener.filled, 0u);
+    EXPECT_EQ(session.stats().inbound_gaps, 1u);
+
+    // 超时前不重新请求，超时后由定时器重新请求
+    EXPECT_FALSE(session.poll(OrderEntrySession::nowNs()));
+    EXPECT_TRUE(session.poll(OrderEntrySession::nowNs() + config.resend_timeout_ns));
+    EXPECT_EQ(session.stats().resend_retries, 1u);
+    exchange.pump();
+    EXPECT_EQ(listener.filled, 3u);
+    EXPECT_EQ(session.expectedInbound(), exchange.nextOutbound());
+    EXPECT_FALSE(session.poll(OrderEntrySession::nowNs() + config.resend_timeout_ns));
+
+    // 请求再次丢失，超时后到达的后续回报触发重新请求
+    exchange.dropOutbound(1);
+    exchange.dropInbound(1);
+    ASSERT_TRUE(exchange.execute(id, 1));
+    ASSERT_TRUE(exchange.execute(id, 1));
+    exchange.pump();
+    EXPECT_EQ(listener.filled, 3u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    ASSERT_TRUE(exchange.execute(id, 1));
+    exchange.pump();
+    EXPECT_EQ(session.stats().resend_retries, 2u);
+    exchange.pump();
+    EXPECT_EQ(listener.filled, 6u);
+    EXPECT_EQ(session.stats().inbound_gaps, 2u);
+    EXPECT_EQ(session.stats().duplicates_received, 0u);
+    EXPECT_EQ(session.expectedInbound(), exchange.nextOutbound());
+}
+
+TEST(OrderEntrySessionTest, JournalRestoresSequenceAndOrdersAfterRestart) {
+    const std::string path = "/tmp/oe_journal_test_" + std::to_string(::getpid());
+    std::remove(path.c_str());
+    OrderEntryConfig config;
+    config.journal_path = path;
+    config.journal_bytes = 1 << 16;
+
+    LoopbackExchange exchange;
+    {
+        OrderEntrySession session(exchange, config);
+        exchange.connect(&session);
+        ASSERT_TRUE(session.open());
+        session.sendNew(kSymbol, OrderSide::BUY, OrderType::LIMIT, 1000000, 10);
+        session.sendNew(kSymbol, OrderSide::SELL, OrderType::LIMIT, 1010000, 10);
+        exchange.pump();
+        // 断线期间的撤单只写入日志
+        exchange.setConnected(false);
+        EXPECT_TRUE(session.sendCancel(2));
+        EXPECT_EQ(session.stats().send_failures, 1u);
+    }
+
+    // 重启后从日志恢复序号与订单，登录后补发撤单并追上交易所的回报
+    OrderEntrySession session(exchange, config);
+    RecordingListener listener;
+    session.setListener(&listener);
+    exchange.connect(&session);
+    exchange.setConnected(true);
+    ASSERT_TRUE(session.open());
+    EXPECT_EQ(session.nextSequence(), 4u);
+    EXPECT_EQ(session.nextClientOrderId(), 3u);
+    EXPECT_EQ(session.openOrders(), 2u);
+
+    ASSERT_TRUE(session.logon());
+    for (int i = 0; i < 4; ++i) {
+        exchange.pump();
+    }
+    EXPECT_EQ(exchange.expectedInbound(), 4u);
+    EXPECT_EQ(listener.accepted, 2);
+    EXPECT_EQ(listener.canceled, 1);
+    EXPECT_EQ(session.openOrders(), 1u);
+    EXPECT_EQ(session.findOrder(1)->status, OrderStatus::NEW);
+    std::remove(path.c_str());
+}
+
+TEST(OrderEntrySessionTest, SteadyStateOrderFlowDoesNotAllocate) {
+    LoopbackExchange exchange(1 << 12, 16 << 20);
+    OrderEntrySession session(exchange);
+    exchange.connect(&session);
+    exchange.setFillOnAccept(true);
+    ASSERT_TRUE(session.open());
+
+    const int kOrders = 20000;
+    g_allocations = 0;
+    g_countAllocations = true;
+    for (int i = 0; i < kOrders; ++i) {
+        session.sendNew(kSymbol, i % 2 ? OrderSide::SELL : OrderSide::BUY, OrderType::LIMIT, 1000000 + i, 100);
+        exchange.pump();
+    }
+    g_countAllocations = false;
+
+    EXPECT_EQ(g_allocations.load(), 0u);
+    EXPECT_EQ(session.openOrders(), 0u);
+    const auto& stats = session.stats();
+    EXPECT_EQ(stats.orders_sent, static_cast<uint64_t>(kOrders));
+    EXPECT_EQ(stats.acks, static_cast<uint64_t>(kOrders));
+    // 延迟统计自洽：最小值不超过平均值，平均值不超过最大值
+    EXPECT_LE(stats.send_latency_min_ns * kOrders, stats.send_latency_total_ns);
+    EXPECT_LE(stats.send_latency_total_ns, stats.send_latency_max_ns * kOrders);
+    EXPECT_LE(stats.ack_latency_min_ns * kOrders, stats.ack_latency_total_ns);
+    EXPECT_LE(stats.ack_latency_total_ns, stats.ack_latency_max_ns * kOrders);
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "network/SharedMemoryBus.h"
+
+using namespace hft::network;
+
+namespace {
+
+std::vector<uint64_t> drain(ShmBusSubscriber& subscriber) {
+    std::vector<uint64_t> values;
+    subscriber.poll([&](const uint8_t* data, size_t size) {
+        EXPECT_EQ(size, sizeof(uint64_t));
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        values.push_back(value);
+    }, 1 << 20);
+    return values;
+}
+
+} // namespace
+
+TEST(SharedMemoryBusTest, EverySubscriberSeesEveryMessage) {
+    ShmBusConfig config;
+    config.slot_count = 16;
+    ShmBusPublisher publisher;
+    ASSERT_TRUE(publisher.create("", config));
+
+    ShmBusSubscriber early;
+    ShmBusSubscriber late;
+    ASSERT_TRUE(early.attach(publisher.fd()));
+    for (uint64_t v = 0; v < 5; ++v) {
+        ASSERT_TRUE(publisher.publish(&v, sizeof(v)));
+    }
+    ASSERT_TRUE(late.attach(publisher.fd(), ShmBusStart::OLDEST));
+
+    EXPECT_EQ(drain(early), (std::vector<uint64_t>{0, 1, 2, 3, 4}));
+    EXPECT_EQ(drain(late), (std::vector<uint64_t>{0, 1, 2, 3, 4}));
+    EXPECT_TRUE(drain(early).empty());
+
+    // 超过槽位大小的消息被拒绝，奇数长度按原长度交付
+    std::string big(publisher.slotSize() + 1, 'x');
+    EXPECT_FALSE(publisher.publish(big.data(), big.size()));
+    std::string text = "AAPL 1";
+    ASSERT_TRUE(publisher.publish(text.data(), text.size()));
+    std::string received;
+    early.poll([&](const uint8_t* data, size_t size) { received.assign(reinterpret_cast<const char*>(data), size); });
+    EXPECT_EQ(received, text);
+}
+
+TEST(SharedMemoryBusTest, LappedSubscriberSkipsToOldestAndCountsLoss) {
+    ShmBusConfig config;
+    config.slot_count = 8;
+    ShmBusPublisher publisher;
+    ASSERT_TRUE(publisher.create("", config));
+    ShmBusSubscriber subscriber;
+    ASSERT_TRUE(subscriber.attach(publisher.fd()));
+
+    for (uint64_t v = 0; v < 20; ++v) {
+        ASSERT_TRUE(publisher.publish(&v, sizeof(v)));
+    }
+    EXPECT_EQ(subscriber.backlog(), 20u);
+    EXPECT_EQ(drain(subscriber), (std::vector<uint64_t>{12, 13, 14, 15, 16, 17, 18, 19}));
+    EXPECT_EQ(subscriber.stats().lost, 12u);
+    EXPECT_EQ(subscriber.stats().overruns, 1u);
+    EXPECT_EQ(subscriber.stats().received, 8u);
+}
+
+TEST(SharedMemoryBusTest, NamedBusCrossesProcesses) {
+    const std::string name = "/hft_bus_test_" + std::to_string(::getpid());
+    ShmBusPublisher publisher;
+    ASSERT_TRUE(publisher.create(name));
+
+    int ready[2];
+    ASSERT_EQ(::pipe(ready), 0);
+    const pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        // 子进程：订阅后通知父进程，读到1000条顺序消息后退出
+        ShmBusSubscriber subscriber;
+        bool ok = subscriber.open(name);
+        char byte = ok ? 1 : 0;
+        (void)!::write(ready[1], &byte, 1);
+        uint64_t expected = 0;
+        while (ok && expected < 1000) {
+            subscriber.poll([&](const uint8_t* data, size_t) {
+                uint64_t value;
+                std::memcpy(&value, data, sizeof(value));
+                ok = ok && value == expected++;
+            });
+        }
+        ::_exit(ok && subscriber.stats().lost == 0 ? 0 : 1);
+    }
+
+    char byte = 0;
+    ASSERT_EQ(::read(ready[0], &byte, 1), 1);
+    ASSERT_EQ(byte, 1);
+    for (uint64_t v = 0; v < 1000; ++v) {
+        ASSERT_TRUE(publisher.publish(&v, sizeof(v)));
+    }
+    int status = 0;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    ::close(ready[0]);
+    ::close(ready[1]);
+}
+
+TEST(SharedMemoryBusTest, StaleSegmentIsTakenOverUnderANewGeneration) {
+    const std::string name = "/hft_bus_stale_" + std::to_string(::getpid());
+    ShmBusConfig config;
+    config.slot_count = 16;
+
+    // 子进程发布5条后直接退出，不关闭总线，留下发布方已不存在的段
+    const pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        ShmBusPublisher crashed;
+        bool ok = crashed.create(name, config);
+        for (uint64_t v = 0; ok && v < 5; ++v) {
+            ok = crashed.publish(&v, sizeof(v));
+        }
+        ::_exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    ShmBusSubscriber subscriber;
+    ASSERT_TRUE(subscriber.open(name, ShmBusStart::OLDEST));
+    EXPECT_FALSE(subscriber.publisherAlive());
+    EXPECT_EQ(drain(subscriber), (std::vector<uint64_t>{0, 1, 2, 3, 4}));
+
+    // 新发布方原地接管，已连接的订阅方从新一代的第一条开始接收
+    ShmBusPublisher publisher;
+    ASSERT_TRUE(publisher.create(name, config));
+    EXPECT_TRUE(subscriber.publisherAlive());
+    for (uint64_t v = 100; v < 103; ++v) {
+        ASSERT_TRUE(publisher.publish(&v, sizeof(v)));
+    }
+    EXPECT_EQ(drain(subscriber), (std::vector<uint64_t>{100, 101, 102}));
+    EXPECT_EQ(subscriber.stats().restarts, 1u);
+    EXPECT_EQ(subscriber.stats().lost, 0u);
+
+    // 发布方存活时不能被另一个发布方截断或重置
+    ShmBusPublisher second;
+    EXPECT_FALSE(second.create(name, config));
+    uint64_t v = 103;
+    ASSERT_TRUE(publisher.publish(&v, sizeof(v)));
+    EXPECT_EQ(drain(subscriber), (std::vector<uint64_t>{103}));
+
+    publisher.close();
+    EXPECT_FALSE(subscriber.publisherAlive());
+}
+
+TEST(SharedMemoryBusTest, CorruptedSizeIsClampedToTheSlotPayload) {
+    ShmBusConfig config;
+    config.slot_count = 4;
+    config.slot_size = 64;
+    ShmBusPublisher publisher;
+    ASSERT_TRUE(publisher.create("", config));
+    ShmBusSubscriber subscriber;
+    ASSERT_TRUE(subscriber.attach(publisher.fd()));
+    uint64_t value = 42;
+    ASSERT_TRUE(publisher.publish(&value, sizeof(value)));
+
+    // 另一个可写映射改写槽位长度
+    const size_t size = shm::kHeaderSize + 4 * shm::slotStride(64);
+    void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, publisher.fd(), 0);
+    ASSERT_NE(base, MAP_FAILED);
+    auto* slot = reinterpret_cast<shm::Slot*>(static_cast<uint8_t*>(base) + shm::kHeaderSize);
+    slot->size.store(1ULL << 40);
+
+    size_t seen = 0;
+    EXPECT_EQ(subscriber.poll([&](const uint8_t*, size_t bytes) { seen = bytes; }), 1u);
+    EXPECT_EQ(seen, publisher.slotSize());
+    ::munmap(base, size);
+}
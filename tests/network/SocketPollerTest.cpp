@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "network/SocketPoller.h"
+
+using namespace hft::network;
+
+namespace {
+
+class CollectingHandler : public DatagramHandler {
+public:
+    void onDatagrams(int, const Datagram* datagrams, size_t count) override {
+        ++batches;
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t value = 0;
+            if (datagrams[i].size == sizeof(value)) {
+                std::memcpy(&value, datagrams[i].data, sizeof(value));
+            }
+            values.push_back(value);
+            if (datagrams[i].kernel_timestamp != 0) {
+                ++timestamped;
+            }
+        }
+        received.fetch_add(count);
+    }
+
+    std::vector<uint32_t> values;
+    size_t batches = 0;
+    size_t timestamped = 0;
+    std::atomic<size_t> received{0};
+};
+
+} // namespace
+
+TEST(SocketPollerTest, BatchesLoopbackDatagrams) {
+    SocketPollerConfig config;
+    config.batch_size = 16;
+    SocketPoller poller(config);
+    ASSERT_TRUE(poller.initialize());
+
+    CollectingHandler handler;
+    const int receiver = poller.addReceiver("127.0.0.1", 0, &handler);
+    ASSERT_GE(receiver, 0);
+    const uint16_t port = poller.localPort(receiver);
+    ASSERT_NE(port, 0);
+    const int sender = poller.addSender("127.0.0.1", port);
+    ASSERT_GE(sender, 0);
+
+    std::vector<uint32_t> payload(100);
+    std::vector<SendBuffer> buffers;
+    for (uint32_t i = 0; i < payload.size(); ++i) {
+        payload[i] = i;
+        buffers.push_back({&payload[i], sizeof(uint32_t)});
+    }
+    EXPECT_EQ(poller.sendBatch(sender, buffers.data(), buffers.size()), payload.size());
+
+    for (int i = 0; i < 100 && handler.received < payload.size(); ++i) {
+        poller.pollOnce(10);
+    }
+
+    ASSERT_EQ(handler.values.size(), payload.size());
+    for (uint32_t i = 0; i < payload.size(); ++i) {
+        EXPECT_EQ(handler.values[i], i);
+    }
+    // 100个报文以16个一批取回，远少于逐个接收的系统调用次数
+    EXPECT_LE(handler.batches, 10u);
+    EXPECT_LT(poller.getStats().receive_calls, 20u);
+    EXPECT_EQ(poller.getStats().send_calls, 2u);
+    if (poller.timestampsEnabled(receiver)) {
+        EXPECT_EQ(handler.timestamped, payload.size());
+    }
+}
+
+TEST(SocketPollerTest, PollerThreadServesManySockets) {
+    SocketPoller poller;
+    ASSERT_TRUE(poller.initialize());
+
+    constexpr int kSockets = 8;
+    CollectingHandler handlers[kSockets];
+    int senders[kSockets];
+    for (int i = 0; i < kSockets; ++i) {
+        const int receiver = poller.addReceiver("127.0.0.1", 0, &handlers[i]);
+        ASSERT_GE(receiver, 0);
+        senders[i] = poller.addSender("127.0.0.1", poller.localPort(receiver));
+        ASSERT_GE(senders[i], 0);
+    }
+    ASSERT_TRUE(poller.start());
+
+    for (uint32_t n = 0; n < 10; ++n) {
+        for (int i = 0; i < kSockets; ++i) {
+            EXPECT_EQ(poller.send(senders[i], &n, sizeof(n)), 1u);
+        }
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (int i = 0; i < kSockets; ++i) {
+        while (handlers[i].received < 10 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    poller.stop();
+
+    for (int i = 0; i < kSockets; ++i) {
+        EXPECT_EQ(handlers[i].received.load(), 10u);
+    }
+    EXPECT_EQ(poller.getStats().datagrams_received, 10u * kSockets);
+}
+
+TEST(SocketPollerTest, RemovedSocketStopsReceiving) {
+    SocketPoller poller;
+    ASSERT_TRUE(poller.initialize());
+
+    CollectingHandler handler;
+    const int receiver = poller.addReceiver("127.0.0.1", 0, &handler);
+    ASSERT_GE(receiver, 0);
+    const int sender = poller.addSender("127.0.0.1", poller.localPort(receiver));
+    ASSERT_GE(sender, 0);
+
+    poller.remove(receiver);
+    uint32_t value = 7;
+    poller.send(sender, &value, sizeof(value));
+    poller.pollOnce(10);
+    EXPECT_EQ(handler.received.load(), 0u);
+
+    // ID在释放后可以被复用
+    CollectingHandler other;
+    EXPECT_EQ(poller.addReceiver("127.0.0.1", 0, &other), receiver);
+}
+
+TEST(SocketPollerTest, SendersRacingRemoveNeverTouchAFreedSocket) {
+    SocketPoller poller;
+    ASSERT_TRUE(poller.initialize());
+
+    CollectingHandler handler;
+    const int receiver = poller.addReceiver("127.0.0.1", 0, &handler);
+    ASSERT_GE(receiver, 0);
+    const uint16_t port = poller.localPort(receiver);
+
+    // 发送线程持续向同一槽位发送，主线程反复移除、释放并重建该槽位的套接字
+    for (int round = 0; round < 50; ++round) {
+        const int sender = poller.addSender("127.0.0.1", port);
+        ASSERT_GE(sender, 0);
+        std::atomic<bool> go{true};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&poller, &go, sender] {
+                uint32_t value = 1;
+                while (go.load(std::memory_order_relaxed)) {
+                    poller.send(sender, &value, sizeof(value));
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        poller.remove(sender);
+        poller.pollOnce(0);     // 在发送线程仍在运行时释放套接字
+        EXPECT_EQ(poller.send(sender, &round, sizeof(round)), 0u);
+        go.store(false);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    EXPECT_GT(poller.getStats().datagrams_sent, 0u);
+}
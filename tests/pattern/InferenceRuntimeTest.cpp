@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+#include "pattern/InferenceRuntime.h"
+
+using namespace hft;
+using namespace hft::pattern;
+
+namespace {
+
+std::vector<float> uniform(size_t size, float low, float high, uint32_t seed) {
+    std::vector<float> values(size);
+    uint32_t state = seed;
+    for (float& value : values) {
+        state = state * 1664525u + 1013904223u;
+        value = low + (high - low) * (static_cast<float>(state >> 8) / 16777216.0f);
+    }
+    return values;
+}
+
+DenseLayerSpec makeLayer(uint32_t inputs, uint32_t outputs, Activation activation, uint32_t seed) {
+    DenseLayerSpec layer;
+    layer.inputs = inputs;
+    layer.outputs = outputs;
+    layer.activation = activation;
+    layer.weights = uniform(static_cast<size_t>(inputs) * outputs, -0.5f, 0.5f, seed);
+    layer.bias = uniform(outputs, -0.1f, 0.1f, seed + 1);
+    return layer;
+}
+
+// 按定义逐项计算的参考实现（double累加）
+std::vector<float> referenceMlp(const std::vector<DenseLayerSpec>& layers, const float* input) {
+    std::vector<double> current(input, input + layers.front().inputs);
+    for (const DenseLayerSpec& layer : layers) {
+        std::vector<double> next(layer.outputs);
+        for (size_t o = 0; o < layer.outputs; ++o) {
+            double sum = layer.bias[o];
+            for (size_t k = 0; k < layer.inputs; ++k) {
+                sum += layer.weights[o * layer.inputs + k] * current[k];
+            }
+            switch (layer.activation) {
+                case Activation::RELU: sum = std::max(sum, 0.0); break;
+                case Activation::SIGMOID: sum = 1.0 / (1.0 + std::exp(-sum)); break;
+                case Activation::TANH: sum = std::tanh(sum); break;
+                default: break;
+            }
+            next[o] = sum;
+        }
+        current.swap(next);
+    }
+    double maxValue = current[0];
+    for (double value : current) {
+        maxValue = std::max(maxValue, value);
+    }
+    double total = 0.0;
+    for (double& value : current) {
+        value = std::exp(value - maxValue);
+        total += value;
+    }
+    std::vector<float> result;
+    for (double value : current) {
+        result.push_back(static_cast<float>(value / total));
+    }
+    return result;
+}
+
+std::vector<DenseLayerSpec> sampleNetwork() {
+    // 宽度不是16的倍数，覆盖补零的列块
+    return {makeLayer(37, 40, Activation::RELU, 11), makeLayer(40, 23, Activation::TANH, 13),
+            makeLayer(23, 9, Activation::NONE, 17)};
+}
+
+} // namespace
+
+TEST(InferenceRuntimeTest, MlpMatchesReferenceOnEverySimdLevel) {
+    const std::vector<DenseLayerSpec> layers = sampleNetwork();
+    const std::vector<uint8_t> image = packMlpModel(layers, OutputTransform::SOFTMAX, false);
+    ASSERT_FALSE(image.empty());
+
+    // 批大小超过kMaxBatch且不是4的倍数，覆盖分块和尾部行
+    const size_t batch = InferenceModel::kMaxBatch + 7;
+    const std::vector<float> inputs = uniform(batch * 37, -2.0f, 2.0f, 5);
+    std::vector<float> outputs(batch * 9);
+
+    for (utils::SimdLevel level : {utils::SimdLevel::SCALAR, utils::SimdLevel::AVX2, utils::SimdLevel::AVX512}) {
+        InferenceModel model(level);
+        if (model.simdLevel() != level) {
+            continue;
+        }
+        SCOPED_TRACE(utils::simdLevelName(level));
+        ASSERT_TRUE(model.loadImage(image));
+        EXPECT_EQ(model.kind(), ModelKind::MLP);
+        EXPECT_EQ(model.inputCount(), 37u);
+        EXPECT_EQ(model.outputCount(), 9u);
+
+        model.predict(inputs.data(), batch, outputs.data());
+        for (size_t r = 0; r < batch; ++r) {
+            const std::vector<float> expected = referenceMlp(layers, inputs.data() + r * 37);
+            for (size_t o = 0; o < 9; ++o) {
+                ASSERT_NEAR(outputs[r * 9 + o], expected[o], 1e-5f) << "row " << r << " output " << o;
+            }
+        }
+
+        // 单行推理与批量结果一致
+        std::vector<float> single(9);
+        model.predict(inputs.data() + 70 * 37, 1, single.data());
+        for (size_t o = 0; o < 9; ++o) {
+            EXPECT_EQ(single[o], outputs[70 * 9 + o]);
+        }
+    }
+}
+
+TEST(InferenceRuntimeTest, Int8WeightsStayCloseToFloat) {
+    // 输入超过一次展开的段长，覆盖分段累加
+    const std::vector<DenseLayerSpec> layers = {makeLayer(300, 24, Activation::SIGMOID, 19),
+                                                makeLayer(24, 9, Activation::NONE, 23)};
+    InferenceModel floatModel;
+    InferenceModel int8Model;
+    ASSERT_TRUE(floatModel.loadImage(packMlpModel(layers, OutputTransform::SOFTMAX, false)));
+    ASSERT_TRUE(int8Model.loadImage(packMlpModel(layers, OutputTransform::SOFTMAX, true)));
+
+    const size_t batch = 32;
+    const std::vector<float> inputs = uniform(batch * 300, -0.2f, 0.2f, 7);
+    std::vector<float> expected(batch * 9);
+    std::vector<float> actual(batch * 9);
+    floatModel.predict(inputs.data(), batch, expected.data());
+    int8Model.predict(inputs.data(), batch, actual.data());
+    for (size_t r = 0; r < batch; ++r) {
+        const std::vector<float> reference = referenceMlp(layers, inputs.data() + r * 300);
+        for (size_t o = 0; o < 9; ++o) {
+            ASSERT_NEAR(expected[r * 9 + o], reference[o], 1e-5f);
+            EXPECT_NEAR(actual[r * 9 + o], reference[o], 0.01f);
+        }
+    }
+}
+
+TEST(InferenceRuntimeTest, GbdtImageRoundTripsAndIsNotScoredHere) {
+    TreeSpec tree;
+    tree.output = 1;
+    tree.nodes.resize(3);
+    tree.nodes[0] = {1, 5.0f, 1, 2, false};
+    tree.nodes[1] = {-1, 0.5f, 0, 0, true};
+    tree.nodes[2] = {-1, -0.5f, 0, 0, true};
+    const std::vector<uint8_t> image = packGbdtModel(2, 2, 0.25f, {tree}, OutputTransform::SIGMOID);
+    ASSERT_FALSE(image.empty());
+
+    ModelKind kind = ModelKind::MLP;
+    ASSERT_TRUE(readModelKind(image.data(), image.size(), kind));
+    EXPECT_EQ(kind, ModelKind::GBDT);
+    GbdtModelSpec model;
+    ASSERT_TRUE(unpackGbdtModel(image.data(), image.size(), model));
+    EXPECT_EQ(model.inputs, 2u);
+    EXPECT_EQ(model.outputs, 2u);
+    EXPECT_EQ(model.baseScore, 0.25f);
+    EXPECT_EQ(model.transform, OutputTransform::SIGMOID);
+    ASSERT_EQ(model.trees.size(), 1u);
+    EXPECT_EQ(model.trees[0].output, 1u);
+    ASSERT_EQ(model.trees[0].nodes.size(), 3u);
+    EXPECT_EQ(model.trees[0].nodes[0].feature, 1);
+    EXPECT_EQ(model.trees[0].nodes[0].value, 5.0f);
+    EXPECT_FALSE(model.trees[0].nodes[0].defaultLeft);
+    EXPECT_EQ(model.trees[0].nodes[2].feature, -1);
+    EXPECT_EQ(model.trees[0].nodes[2].value, -0.5f);
+
+    // GBDT由ai::TreeEnsemble打分，MLP运行时拒绝加载
+    InferenceModel runtime;
+    EXPECT_FALSE(runtime.loadImage(image));
+    EXPECT_FALSE(unpackGbdtModel(image.data(), image.size() / 2, model));
+
+    // 子节点指向父节点之前的树被拒绝
+    TreeSpec cyclic = tree;
+    cyclic.nodes[0].left = 0;
+    EXPECT_TRUE(packGbdtModel(2, 2, 0.0f, {cyclic}, OutputTransform::NONE).empty());
+}
+
+TEST(InferenceRuntimeTest, SavedModelIsMappedFromDisk) {
+    const std::vector<DenseLayerSpec> layers = sampleNetwork();
+    const std::vector<uint8_t> image = packMlpModel(layers, OutputTransform::SOFTMAX, true);
+    const std::string path = "inference_runtime_test.hftm";
+    ASSERT_TRUE(writeModelFile(path, image));
+
+    InferenceModel mapped;
+    InferenceModel owned;
+    ASSERT_TRUE(mapped.load(path));
+    ASSERT_TRUE(owned.loadImage(image));
+    ASSERT_EQ(mapped.imageSize(), image.size());
+
+    const std::vector<float> inputs = uniform(5 * 37, -1.0f, 1.0f, 9);
+    std::vector<float> expected(5 * 9);
+    std::vector<float> actual(5 * 9);
+    std::vector<float> scratch(mapped.scratchSize());
+    owned.predict(inputs.data(), 5, expected.data());
+    mapped.predict(inputs.data(), 5, actual.data(), scratch.data());
+    EXPECT_EQ(actual, expected);
+
+    // 截断的文件被拒绝
+    std::vector<uint8_t> truncated(image.begin(), image.begin() + image.size() / 2);
+    EXPECT_FALSE(owned.loadImage(truncated));
+    EXPECT_FALSE(owned.isLoaded());
+    mapped.unload();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "persistence/TickStore.h"
+
+using namespace hft::persistence;
+
+namespace {
+
+constexpr uint64_t kDay = 86400ULL * 1000000000ULL;
+// 2024-01-02 00:00:00 UTC
+constexpr uint64_t kBase = 19724ULL * kDay;
+
+Tick makeTick(uint64_t timestamp, int64_t price) {
+    return Tick{timestamp, price, 100, price - 1, price + 1, 10, 20};
+}
+
+std::vector<Tick> collect(TickQuery& query) {
+    std::vector<Tick> ticks;
+    Tick tick;
+    while (query.next(tick)) {
+        ticks.push_back(tick);
+    }
+    return ticks;
+}
+
+class TickStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root_ = ::testing::TempDir() + "tick_store_test_" +
+                ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::filesystem::remove_all(root_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root_);
+    }
+
+    std::string root_;
+};
+
+} // namespace
+
+TEST_F(TickStoreTest, QueryReadsOpenBlockWithoutFlushing) {
+    TickStore store(root_, 16);
+    for (uint64_t i = 0; i < 40; ++i) {
+        ASSERT_TRUE(store.append("AAPL", makeTick(kBase + i * 1000, 1000000 + static_cast<int64_t>(i))));
+    }
+
+    // 两个写满的块已落盘，最后8行仍在内存中
+    auto query = store.query("AAPL", kBase, kBase + kDay - 1);
+    EXPECT_EQ(query->blocks().size(), 2u);
+    std::vector<Tick> ticks = collect(*query);
+    ASSERT_EQ(ticks.size(), 40u);
+    for (uint64_t i = 0; i < 40; ++i) {
+        EXPECT_EQ(ticks[i].timestamp, kBase + i * 1000);
+        EXPECT_EQ(ticks[i].last_price, 1000000 + static_cast<int64_t>(i));
+        EXPECT_EQ(ticks[i].ask_volume, 20);
+    }
+
+    // 查询没有把内存块写出
+    query = store.query("AAPL", kBase, kBase + kDay - 1);
+    EXPECT_EQ(query->blocks().size(), 2u);
+
+    // 区间只覆盖内存块中的一部分
+    query = store.query("AAPL", kBase + 35 * 1000, kBase + 37 * 1000);
+    ticks = collect(*query);
+    ASSERT_EQ(ticks.size(), 3u);
+    EXPECT_EQ(ticks.front().timestamp, kBase + 35 * 1000);
+
+    // reset后可重复遍历，内存行仍然只出现一次
+    query = store.query("AAPL", kBase, kBase + kDay - 1);
+    collect(*query);
+    query->reset();
+    EXPECT_EQ(collect(*query).size(), 40u);
+}
+
+TEST_F(TickStoreTest, OpenBlockIsOrderedBetweenPartitions) {
+    TickStore store(root_, 4);
+    // 第二天写满一块落盘，随后补录第一天的数据，留在内存中
+    for (uint64_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(store.append("MSFT", makeTick(kBase + kDay + i, 20)));
+    }
+    for (uint64_t i = 0; i < 3; ++i) {
+        ASSERT_TRUE(store.append("MSFT", makeTick(kBase + i, 10)));
+    }
+
+    // 内存中的第一天数据排在第二天的落盘块之前
+    auto query = store.query("MSFT", kBase, kBase + 2 * kDay);
+    EXPECT_EQ(query->blocks().size(), 1u);
+    std::vector<Tick> ticks = collect(*query);
+    ASSERT_EQ(ticks.size(), 7u);
+    for (size_t i = 1; i < ticks.size(); ++i) {
+        EXPECT_LT(ticks[i - 1].timestamp, ticks[i].timestamp);
+    }
+    EXPECT_EQ(ticks.front().last_price, 10);
+    EXPECT_EQ(ticks.back().last_price, 20);
+}
+
+TEST_F(TickStoreTest, ReopenDropsTornIndexEntryAndUnindexedColumnData) {
+    {
+        TickStore store(root_, 4);
+        for (uint64_t i = 0; i < 4; ++i) {
+            ASSERT_TRUE(store.append("TSLA", makeTick(kBase + i, 100 + static_cast<int64_t>(i))));
+        }
+    }
+
+    // 模拟写块时崩溃：列数据已写出一部分，索引只写了半个条目
+    size_t damaged = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(root_)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        std::ofstream out(entry.path(), std::ios::binary | std::ios::app);
+        const size_t bytes = entry.path().filename() == "index.idx" ? sizeof(TickBlockIndex) / 2 : 3;
+        out << std::string(bytes, '\x7f');
+        ++damaged;
+    }
+    ASSERT_EQ(damaged, kTickColumnCount + 1);
+
+    {
+        TickStore store(root_, 4);
+        for (uint64_t i = 4; i < 8; ++i) {
+            ASSERT_TRUE(store.append("TSLA", makeTick(kBase + i, 100 + static_cast<int64_t>(i))));
+        }
+    }
+
+    TickStore store(root_, 4);
+    auto query = store.query("TSLA", kBase, kBase + kDay - 1);
+    EXPECT_EQ(query->blocks().size(), 2u);
+    std::vector<Tick> ticks = collect(*query);
+    ASSERT_EQ(ticks.size(), 8u);
+    for (uint64_t i = 0; i < 8; ++i) {
+        EXPECT_EQ(ticks[i].timestamp, kBase + i);
+        EXPECT_EQ(ticks[i].last_price, 100 + static_cast<int64_t>(i));
+        EXPECT_EQ(ticks[i].bid_volume, 10);
+    }
+}
+
+TEST_F(TickStoreTest, RejectsTimestampsGoingBackwardsWithinAPartition) {
+    {
+        TickStore store(root_, 4);
+        ASSERT_TRUE(store.append("IBM", makeTick(kBase + 100, 1)));
+        ASSERT_TRUE(store.append("IBM", makeTick(kBase + 100, 2)));   // 相等允许
+        EXPECT_FALSE(store.append("IBM", makeTick(kBase + 99, 3)));
+        ASSERT_TRUE(store.append("IBM", makeTick(kBase + 200, 4)));
+        ASSERT_TRUE(store.append("IBM", makeTick(kBase + 300, 5)));   // 写满第一块
+        // 跨块仍然检查
+        EXPECT_FALSE(store.append("IBM", makeTick(kBase + 250, 6)));
+        EXPECT_EQ(store.getAppendedCount(), 4u);
+        EXPECT_EQ(store.getRejectedCount(), 2u);
+    }
+
+    // 重新打开已有分区，时间下限从索引恢复
+    TickStore store(root_, 4);
+    EXPECT_FALSE(store.append("IBM", makeTick(kBase + 150, 7)));
+    EXPECT_TRUE(store.append("IBM", makeTick(kBase + 300, 8)));
+    // 其他分区不受影响
+    EXPECT_TRUE(store.append("IBM", makeTick(kBase + kDay + 1, 9)));
+
+    auto query = store.query("IBM", kBase, kBase + kDay - 1);
+    std::vector<Tick> ticks = collect(*query);
+    ASSERT_EQ(ticks.size(), 5u);
+    for (size_t i = 1; i < ticks.size(); ++i) {
+        EXPECT_LE(ticks[i - 1].timestamp, ticks[i].timestamp);
+    }
+    EXPECT_EQ(ticks.back().last_price, 8);
+}
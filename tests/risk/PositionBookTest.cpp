@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "risk/PositionBook.h"
+
+using namespace hft;
+using namespace hft::risk;
+
+TEST(PositionBookTest, TracksAveragePriceAndPnl) {
+    PositionBook book(16);
+
+    EXPECT_TRUE(book.onFill(1, 100, 10.0));
+    EXPECT_TRUE(book.onFill(1, 100, 12.0));
+    PositionSnapshot position;
+    ASSERT_TRUE(book.snapshot(1, position));
+    EXPECT_EQ(position.quantity, 200);
+    EXPECT_DOUBLE_EQ(position.avgPrice, 11.0);
+
+    // 减仓实现盈亏，均价不变
+    book.onFill(1, -50, 13.0);
+    ASSERT_TRUE(book.snapshot(1, position));
+    EXPECT_EQ(position.quantity, 150);
+    EXPECT_DOUBLE_EQ(position.avgPrice, 11.0);
+    EXPECT_DOUBLE_EQ(position.realizedPnl, 100.0);
+
+    // 反手：平掉150，剩余按成交价开空
+    book.onFill(1, -200, 10.0);
+    ASSERT_TRUE(book.snapshot(1, position));
+    EXPECT_EQ(position.quantity, -50);
+    EXPECT_DOUBLE_EQ(position.avgPrice, 10.0);
+    EXPECT_DOUBLE_EQ(position.realizedPnl, -50.0);
+
+    book.updateMarkPrice(1, 9.0);
+    book.setPosition(2, 10, 100.0);
+    const PortfolioTotals totals = book.totals();
+    EXPECT_DOUBLE_EQ(totals.exposure, 450.0 + 1000.0);
+    EXPECT_DOUBLE_EQ(totals.unrealizedPnl, 50.0);
+    EXPECT_DOUBLE_EQ(totals.realizedPnl, -50.0);
+    EXPECT_EQ(totals.grossQuantity, 60);
+    EXPECT_EQ(totals.openPositions, 2u);
+
+    EXPECT_FALSE(book.snapshot(3, position));
+    EXPECT_FALSE(book.onFill(99, 1, 1.0));
+    EXPECT_EQ(book.activeSymbols(), 2u);
+}
+
+TEST(PositionBookTest, ReadersSeeConsistentTotals) {
+    PositionBook book(8);
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+
+    // 每次成交一买一卖，持仓在0和100之间切换，汇总必须与之一致
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            const PortfolioTotals totals = book.totals();
+            if (totals.grossQuantity != 0 && totals.grossQuantity != 100) {
+                torn.fetch_add(1);
+            }
+            if (totals.grossQuantity == 0 && totals.exposure != 0.0) {
+                torn.fetch_add(1);
+            }
+        }
+    });
+
+    for (int i = 0; i < 100000; ++i) {
+        book.onFill(1, 100, 5.0);
+        book.onFill(1, -100, 5.0);
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(book.totals().version, 200000u);
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include "risk/PreTradeRisk.h"
+
+using namespace hft;
+using namespace hft::risk;
+
+namespace {
+
+OrderRecord makeOrder(core::SymbolId symbol, OrderSide side, double price, uint64_t quantity,
+                      OrderType type = OrderType::LIMIT) {
+    OrderRecord order;
+    std::memset(&order, 0, sizeof(order));
+    order.symbolId = symbol;
+    order.side = side;
+    order.type = type;
+    order.price = price;
+    order.quantity = quantity;
+    return order;
+}
+
+RiskLimits testLimits() {
+    RiskLimits limits;
+    limits.maxTotalPosition = 10000;
+    limits.maxSinglePosition = 0.5;     // 单品种5000
+    limits.maxOrderSize = 1000;
+    limits.maxOrderValue = 50000.0;
+    limits.maxTotalValue = 200000.0;
+    limits.maxOrdersPerSecond = 1000;
+    limits.maxPriceDeviation = 0.05;
+    return limits;
+}
+
+} // namespace
+
+TEST(PreTradeRiskTest, RejectsEachLimit) {
+    PreTradeRiskChain chain(testLimits(), 16);
+    chain.updateReferencePrice(1, 100 * 10000);
+    uint64_t now = 1000000000ULL;
+
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::BUY, 100.0, 0), now), RiskReject::ORDER_SIZE);
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::BUY, 100.0, 1001), now), RiskReject::ORDER_SIZE);
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::BUY, 106.0, 10), now), RiskReject::PRICE_COLLAR);
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::SELL, 94.0, 10), now), RiskReject::PRICE_COLLAR);
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::BUY, 100.0, 600), now), RiskReject::NOTIONAL_LIMIT);
+    EXPECT_EQ(chain.check(makeOrder(99, OrderSide::BUY, 100.0, 10), now), RiskReject::UNKNOWN_SYMBOL);
+
+    // 单品种上限按未成交量预占
+    chain.setPosition(1, 4500);
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::BUY, 100.0, 400), now), RiskReject::NONE);
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::BUY, 100.0, 200), now), RiskReject::POSITION_LIMIT);
+    EXPECT_EQ(chain.openQuantity(1, OrderSide::BUY), 400u);
+
+    // 本方卖单价格不高于本方买单时视为自成交
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::SELL, 99.0, 10), now), RiskReject::SELF_TRADE);
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::SELL, 101.0, 10), now), RiskReject::NONE);
+
+    const PreTradeStats& stats = chain.stats();
+    EXPECT_EQ(stats.passed, 2u);
+    EXPECT_EQ(stats.rejected[static_cast<size_t>(RiskReject::SELF_TRADE)], 1u);
+    EXPECT_STREQ(riskRejectName(RiskReject::PRICE_COLLAR), "PRICE_COLLAR");
+}
+
+TEST(PreTradeRiskTest, FillsAndCancelsReleaseOpenQuantity) {
+    PreTradeRiskChain chain(testLimits(), 16);
+    chain.updateReferencePrice(2, 50 * 10000);
+    const uint64_t now = 1000000000ULL;
+
+    const OrderRecord buy = makeOrder(2, OrderSide::BUY, 50.0, 800);
+    ASSERT_EQ(chain.check(buy, now), RiskReject::NONE);
+    EXPECT_DOUBLE_EQ(chain.openNotional(), 40000.0);
+
+    chain.onFill(buy, 300);
+    EXPECT_EQ(chain.position(2), 300);
+    EXPECT_EQ(chain.openQuantity(2, OrderSide::BUY), 500u);
+    EXPECT_DOUBLE_EQ(chain.openNotional(), 25000.0);
+
+    // 撤单后卖单不再触发自成交检查
+    EXPECT_EQ(chain.check(makeOrder(2, OrderSide::SELL, 49.0, 100), now), RiskReject::SELF_TRADE);
+    chain.onOrderClosed(buy, 500);
+    EXPECT_EQ(chain.openQuantity(2, OrderSide::BUY), 0u);
+    EXPECT_DOUBLE_EQ(chain.openNotional(), 0.0);
+    EXPECT_EQ(chain.check(makeOrder(2, OrderSide::SELL, 49.0, 100), now), RiskReject::NONE);
+}
+
+TEST(PreTradeRiskTest, FullFillClosesTheOrder) {
+    PreTradeRiskChain chain(testLimits(), 16);
+    chain.updateReferencePrice(2, 50 * 10000);
+    const uint64_t now = 1000000000ULL;
+
+    OrderRecord buy = makeOrder(2, OrderSide::BUY, 50.0, 400);
+    ASSERT_EQ(chain.check(buy, now), RiskReject::NONE);
+
+    // 分两次全部成交，第二次回报时filledQuantity为此前的累计成交
+    chain.onFill(buy, 150);
+    EXPECT_EQ(chain.check(makeOrder(2, OrderSide::SELL, 49.0, 100), now), RiskReject::SELF_TRADE);
+    buy.filledQuantity = 150;
+    chain.onFill(buy, 250);
+    EXPECT_EQ(chain.position(2), 400);
+    EXPECT_EQ(chain.openQuantity(2, OrderSide::BUY), 0u);
+
+    // 买单已结束，反向卖单不再视为自成交
+    EXPECT_EQ(chain.check(makeOrder(2, OrderSide::SELL, 49.0, 100), now), RiskReject::NONE);
+}
+
+TEST(PreTradeRiskTest, ReducingOrdersPassTheGrossPositionLimit) {
+    PreTradeRiskChain chain(testLimits(), 16);
+    const uint64_t now = 1000000000ULL;
+    chain.setPosition(1, 4800);
+    chain.setPosition(2, -4800);
+
+    // 总持仓9600，新开500超过10000
+    EXPECT_EQ(chain.check(makeOrder(3, OrderSide::BUY, 50.0, 500), now), RiskReject::POSITION_LIMIT);
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::BUY, 50.0, 500), now), RiskReject::POSITION_LIMIT);
+
+    // 平多、平空都能通过，连同已挂的减仓单也不越过零
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::SELL, 50.0, 1000), now), RiskReject::NONE);
+    EXPECT_EQ(chain.check(makeOrder(1, OrderSide::SELL, 50.0, 1000), now), RiskReject::NONE);
+    EXPECT_EQ(chain.check(makeOrder(2, OrderSide::BUY, 50.0, 1000), now), RiskReject::NONE);
+
+    // 挂着的减仓单不占额度，成交后腾出的额度可以用于其他品种
+    chain.onFill(makeOrder(1, OrderSide::SELL, 50.0, 1000), 1000);
+    EXPECT_EQ(chain.check(makeOrder(3, OrderSide::BUY, 50.0, 300), now), RiskReject::NONE);
+    EXPECT_EQ(chain.check(makeOrder(4, OrderSide::BUY, 50.0, 1000), now), RiskReject::NONE);
+    EXPECT_EQ(chain.check(makeOrder(4, OrderSide::BUY, 50.0, 200), now), RiskReject::POSITION_LIMIT);
+}
+
+TEST(PreTradeRiskTest, TokenBucketLimitsOrderRate) {
+    RiskLimits limits = testLimits();
+    limits.maxOrdersPerSecond = 10;
+    limits.maxTotalPosition = 0;
+    limits.maxTotalValue = 0.0;
+    PreTradeRiskChain chain(limits, 16);
+    uint64_t now = 5000000000ULL;
+
+    // 允许一次突发10笔
+    int passed = 0;
+    for (int i = 0; i < 20; ++i) {
+        if (chain.check(makeOrder(3, OrderSide::BUY, 10.0, 1), now) == RiskReject::NONE) {
+            ++passed;
+        }
+    }
+    EXPECT_EQ(passed, 10);
+    EXPECT_EQ(chain.check(makeOrder(3, OrderSide::BUY, 10.0, 1), now), RiskReject::ORDER_RATE);
+
+    // 100ms后补充一个令牌
+    now += 100000000ULL;
+    EXPECT_EQ(chain.check(makeOrder(3, OrderSide::BUY, 10.0, 1), now), RiskReject::NONE);
+    EXPECT_EQ(chain.check(makeOrder(3, OrderSide::BUY, 10.0, 1), now), RiskReject::ORDER_RATE);
+
+    // 每项检查都有延迟记录
+    EXPECT_EQ(chain.latency(PreTradeCheck::ORDER_RATE).count(), 23u);
+    EXPECT_EQ(chain.totalLatency().count(), 23u);
+    EXPECT_GE(chain.totalLatency().percentile(99), chain.totalLatency().percentile(50));
+}
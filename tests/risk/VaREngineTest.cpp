@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "risk/VaREngine.h"
+
+using namespace hft::risk;
+
+TEST(VaREngineTest, MonteCarloMatchesNormalQuantiles) {
+    MonteCarloVaREngine engine;
+    // 两个资产，波动率1%/2%，相关系数0.5
+    ASSERT_TRUE(engine.setPortfolio({1000000.0, 500000.0}, {0.0, 0.0}, {0.01, 0.02},
+                                    {1.0, 0.5, 0.5, 1.0}));
+    const VaRResult result = engine.simulate(200000, 0.99, 42, 4);
+
+    // σ_p = sqrt(10000² + 10000² + 2×0.5×10000×10000)
+    const double sigma = std::sqrt(3.0) * 10000.0;
+    EXPECT_NEAR(result.var, 2.3263 * sigma, 0.02 * 2.3263 * sigma);
+    EXPECT_NEAR(result.cvar, 2.6652 * sigma, 0.03 * 2.6652 * sigma);
+    EXPECT_EQ(result.samples, 200000u);
+
+    // 计数器随机数：结果与线程数无关
+    const VaRResult single = engine.simulate(200000, 0.99, 42, 1);
+    EXPECT_DOUBLE_EQ(single.var, result.var);
+    EXPECT_DOUBLE_EQ(single.cvar, result.cvar);
+
+    EXPECT_FALSE(engine.setPortfolio({1.0, 1.0}, {0.0, 0.0}, {0.01, 0.01}, {1.0, 2.0, 2.0, 1.0}));
+}
+
+TEST(VaREngineTest, RollingWindowMatchesFullRecompute) {
+    RollingHistoricalVaR rolling(250, 0.95);
+    std::vector<double> history;
+    uint32_t key[2] = {7, 0};
+    for (uint32_t i = 0; i < 1000; ++i) {
+        uint32_t counter[4] = {i, 0, 0, 0};
+        uint32_t bits[4];
+        Philox4x32::generate(counter, key, bits);
+        const double value = (static_cast<double>(bits[0]) / 4294967296.0 - 0.5) * 0.04;
+        rolling.add(value);
+        history.push_back(value);
+
+        if (i % 97 == 0 || i == 999) {
+            const size_t count = std::min<size_t>(history.size(), 250);
+            std::vector<double> window(history.end() - count, history.end());
+            const VaRResult expected = tailRisk(window.data(), window.size(), 0.95);
+            EXPECT_DOUBLE_EQ(rolling.var(), expected.var);
+            EXPECT_NEAR(rolling.cvar(), expected.cvar, 1e-12);
+        }
+    }
+    EXPECT_EQ(rolling.size(), 250u);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "strategy/SignalEngine.h"
+
+using namespace hft;
+using namespace hft::strategy;
+
+namespace {
+
+void fillBook(TopOfBookSoA& book, size_t symbols) {
+    uint32_t state = 12345;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / 16777216.0f;
+    };
+    for (core::SymbolId s = 1; s < symbols; ++s) {
+        if (s % 29 == 0) {
+            continue;   // 无行情的品种
+        }
+        const float bid = 10.0f + 100.0f * next();
+        const float spread = bid * 0.0001f * (1.0f + 20.0f * next());
+        book.update(s, bid, 100.0f + 900.0f * next(), bid + spread, 100.0f + 900.0f * next());
+        if (s % 3 == 0) {
+            book.setReference(s, bid * (0.999f + 0.002f * next()));
+        }
+    }
+}
+
+} // namespace
+
+TEST(SignalEngineTest, SimdKernelsMatchScalar) {
+    constexpr size_t kSymbols = 3000;
+    CrossSectionalSignalEngine scalar(kSymbols, utils::SimdLevel::SCALAR);
+    fillBook(scalar.book(), kSymbols);
+    scalar.params().deviationWeight = 0.05f;
+    const size_t expected = scalar.evaluate();
+    EXPECT_GT(expected, 0u);
+
+    for (utils::SimdLevel level : {utils::SimdLevel::AVX2, utils::SimdLevel::AVX512}) {
+        CrossSectionalSignalEngine engine(kSymbols, level);
+        if (engine.simdLevel() != level) {
+            continue;   // 本机不支持
+        }
+        fillBook(engine.book(), kSymbols);
+        engine.params().deviationWeight = 0.05f;
+        EXPECT_EQ(engine.evaluate(), expected) << utils::simdLevelName(level);
+        for (core::SymbolId s = 0; s < kSymbols; ++s) {
+            EXPECT_NEAR(engine.score(s), scalar.score(s), 1e-5f);
+            EXPECT_EQ(engine.isBuy(s), scalar.isBuy(s));
+            EXPECT_EQ(engine.isSell(s), scalar.isSell(s));
+        }
+    }
+}
+
+TEST(SignalEngineTest, GeneratesOrdersOnlyForCrossingLanes) {
+    CrossSectionalSignalEngine engine(256);
+    TopOfBookSoA& book = engine.book();
+    book.update(3, 99.99f, 900.0f, 100.01f, 100.0f);    // 失衡0.8，买入
+    book.update(70, 49.99f, 100.0f, 50.01f, 700.0f);    // 失衡-0.75，卖出
+    book.update(71, 49.99f, 500.0f, 50.01f, 500.0f);    // 平衡
+    book.update(200, 10.0f, 900.0f, 10.5f, 100.0f);     // 价差过大
+    book.update(201, 10.0f, 900.0f, 9.9f, 100.0f);      // 价格倒挂，无效
+
+    std::vector<OrderRecord> orders;
+    EXPECT_EQ(engine.generateOrders(5, 7, orders), 2u);
+    ASSERT_EQ(orders.size(), 2u);
+    EXPECT_EQ(orders[0].symbolId, 3u);
+    EXPECT_EQ(orders[0].side, OrderSide::BUY);
+    EXPECT_DOUBLE_EQ(orders[0].price, 100.01f);
+    EXPECT_EQ(orders[0].strategyId, 7u);
+    EXPECT_EQ(orders[1].symbolId, 70u);
+    EXPECT_EQ(orders[1].side, OrderSide::SELL);
+    EXPECT_DOUBLE_EQ(orders[1].price, 49.99f);
+    EXPECT_NEAR(engine.score(3), 0.8f, 1e-6f);
+    EXPECT_FLOAT_EQ(engine.score(201), 0.0f);
+    EXPECT_EQ(book.activeLanes(), 256u);
+    EXPECT_FALSE(book.update(5000, 1.0f, 1.0f, 1.1f, 1.0f));
+}
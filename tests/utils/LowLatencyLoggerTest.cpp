@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/LowLatencyLogger.h"
+
+namespace {
+
+std::vector<std::string> readLines(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+std::string tempLog(const std::string& name) {
+    const std::string path = ::testing::TempDir() + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+} // namespace
+
+TEST(LowLatencyLoggerTest, MoreLiveThreadsThanRingsFallBackToSharedRing) {
+    const std::string path = tempLog("llog_shared_ring.log");
+    LowLatencyLogger logger(path, LogLevel::INFO);
+
+    // 同时存活的线程数超过独占环数量，多出的线程写入共享环
+    constexpr int kThreads = static_cast<int>(LowLatencyLogger::kMaxThreadRings) + 36;
+    std::mutex mutex;
+    std::condition_variable cv;
+    int logged = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            LLOG(logger, LogLevel::ERROR, "thread {} reporting", t);
+            std::unique_lock<std::mutex> lock(mutex);
+            ++logged;
+            cv.notify_all();
+            cv.wait(lock, [&] { return logged == kThreads; });
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+
+    EXPECT_EQ(logger.getDroppedCount(), 0u);
+    std::set<std::string> seen;
+    for (const std::string& line : readLines(path)) {
+        seen.insert(line.substr(line.find("thread ")));
+    }
+    EXPECT_EQ(seen.size(), static_cast<size_t>(kThreads));
+    std::remove(path.c_str());
+}
+
+TEST(LowLatencyLoggerTest, ExitedThreadsReturnTheirRingsForReuse) {
+    const std::string path = tempLog("llog_ring_reuse.log");
+    LowLatencyLogger logger(path, LogLevel::INFO);
+
+    // 远多于环数量的短生命周期线程，分批创建退出
+    constexpr int kWaves = 10;
+    constexpr int kPerWave = 40;
+    for (int wave = 0; wave < kWaves; ++wave) {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < kPerWave; ++i) {
+            threads.emplace_back([&logger, wave, i] {
+                for (int n = 0; n < 5; ++n) {
+                    LLOG(logger, LogLevel::INFO, "wave {} thread {} line {}", wave, i, n);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        // 等后台线程排空，已退出线程的环才会回到空闲状态
+        logger.flush();
+    }
+
+    EXPECT_EQ(logger.getDroppedCount(), 0u);
+    // 每批线程复用上一批交还的环：独占环数量不超过一批的线程数
+    EXPECT_LE(logger.getRingCount(), static_cast<size_t>(kPerWave) + 1);
+    EXPECT_EQ(readLines(path).size(), static_cast<size_t>(kWaves * kPerWave * 5));
+    std::remove(path.c_str());
+}
+
+TEST(LowLatencyLoggerTest, CallSiteLevelIsCheckedOnEveryCall) {
+    const std::string path = tempLog("llog_runtime_level.log");
+    LowLatencyLogger logger(path, LogLevel::INFO);
+
+    const LogLevel levels[] = {LogLevel::WARNING, LogLevel::DEBUG, LogLevel::ERROR, LogLevel::INFO};
+    for (int i = 0; i < 4; ++i) {
+        // 同一调用点，级别随调用变化
+        LLOG(logger, levels[i], "message {}", i);
+    }
+    logger.flush();
+
+    const std::vector<std::string> lines = readLines(path);
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_NE(lines[0].find("[WARNING] message 0"), std::string::npos);
+    EXPECT_NE(lines[1].find("[ERROR] message 2"), std::string::npos);
+    EXPECT_NE(lines[2].find("[INFO] message 3"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(LowLatencyLoggerTest, BinaryLogDecodesRecordLevels) {
+    const std::string path = tempLog("llog_binary.bin");
+    {
+        LowLatencyLogger logger(path, LogLevel::DEBUG, LogOutputMode::BINARY);
+        for (LogLevel level : {LogLevel::DEBUG, LogLevel::CRITICAL}) {
+            LLOG(logger, level, "px {} qty {} side {}", 101.25, 7, 'B');
+        }
+    }
+
+    std::ostringstream out;
+    ASSERT_TRUE(LowLatencyLogger::decodeBinaryLog(path, out));
+    std::istringstream in(out.str());
+    std::string first, second, extra;
+    ASSERT_TRUE(std::getline(in, first));
+    ASSERT_TRUE(std::getline(in, second));
+    EXPECT_FALSE(std::getline(in, extra));
+    EXPECT_NE(first.find("[DEBUG] px 101.25 qty 7 side B"), std::string::npos);
+    EXPECT_NE(second.find("[CRITICAL] px 101.25 qty 7 side B"), std::string::npos);
+    std::remove(path.c_str());
+}
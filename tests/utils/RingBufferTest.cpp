@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/RingBuffer.h"
+
+using namespace hft::utils;
+
+TEST(RingBufferTest, CapacityRoundsUpToPowerOfTwo) {
+    SPSCRingBuffer<int> spsc(1000);
+    MPMCRingBuffer<int> mpmc(3);
+    EXPECT_EQ(spsc.capacity(), 1024u);
+    EXPECT_EQ(mpmc.capacity(), 4u);
+}
+
+TEST(RingBufferTest, SpscRejectsWhenFullAndPreservesOrder) {
+    SPSCRingBuffer<int> queue(4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_FALSE(queue.try_push(99));
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(RingBufferTest, BatchPushPopAndInPlaceConstruction) {
+    SPSCRingBuffer<std::string> queue(8);
+    EXPECT_TRUE(queue.try_emplace(3, 'x'));
+
+    const std::string items[] = {"a", "b", "c", "d", "e", "f", "g", "h"};
+    EXPECT_EQ(queue.push_n(items, 8), 7u);
+
+    std::string out[16];
+    EXPECT_EQ(queue.pop_n(out, 16), 8u);
+    EXPECT_EQ(out[0], "xxx");
+    EXPECT_EQ(out[7], "g");
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(RingBufferTest, DestructorReleasesQueuedElements) {
+    auto tracked = std::make_shared<int>(7);
+    {
+        SPSCRingBuffer<std::shared_ptr<int>> spsc(4);
+        MPSCRingBuffer<std::shared_ptr<int>> mpsc(4);
+        spsc.push(tracked);
+        mpsc.push(tracked);
+        EXPECT_EQ(tracked.use_count(), 3);
+    }
+    EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST(RingBufferTest, SpscBlockingTransfersEverything) {
+    SPSCRingBuffer<uint64_t, BlockingWait> queue(64);
+    constexpr uint64_t kCount = 200000;
+
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < kCount; ++i) {
+            queue.push(i);
+        }
+    });
+
+    uint64_t expected = 0;
+    for (uint64_t i = 0; i < kCount; ++i) {
+        uint64_t value;
+        queue.pop(value);
+        ASSERT_EQ(value, expected++);
+    }
+    producer.join();
+}
+
+TEST(RingBufferTest, MpscAndMpmcDeliverEachItemOnce) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 50000;
+
+    MPMCRingBuffer<int, YieldWait> queue(256);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                queue.push(p * kPerProducer + i);
+            }
+        });
+    }
+
+    std::vector<int> seen(kProducers * kPerProducer, 0);
+    std::atomic<int> remaining{kProducers * kPerProducer};
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 2; ++c) {
+        consumers.emplace_back([&] {
+            int batch[32];
+            while (remaining.load() > 0) {
+                size_t n = queue.pop_n(batch, 32);
+                for (size_t i = 0; i < n; ++i) {
+                    ++seen[batch[i]];
+                }
+                remaining.fetch_sub(static_cast<int>(n));
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    for (auto& t : consumers) t.join();
+
+    for (int count : seen) {
+        ASSERT_EQ(count, 1);
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace hft {
+namespace utils {
+
+// 定长对数分桶的延迟直方图
+// 每个2的幂区间再均分16个子桶（相对误差不超过1/16），record()只做一次计数，
+// 不分配内存、不加锁。单写线程使用；其他线程通过拷贝快照读取（读到的计数可能略旧）。
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    static constexpr size_t kBuckets = 64 * kSubBuckets;
+
+    LatencyHistogram() { reset(); }
+
+    void record(uint64_t value) {
+        ++m_counts[bucketOf(value)];
+        ++m_count;
+        m_sum += value;
+        if (value < m_min) {
+            m_min = value;
+        }
+        if (value > m_max) {
+            m_max = value;
+        }
+    }
+
+    void reset() {
+        std::memset(m_counts, 0, sizeof(m_counts));
+        m_count = 0;
+        m_sum = 0;
+        m_min = UINT64_MAX;
+        m_max = 0;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < kBuckets; ++i) {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_count += other.m_count;
+        m_sum += other.m_sum;
+        if (other.m_min < m_min) {
+            m_min = other.m_min;
+        }
+        if (other.m_max > m_max) {
+            m_max = other.m_max;
+        }
+    }
+
+    uint64_t count() const { return m_count; }
+    uint64_t min() const { return m_count ? m_min : 0; }
+    uint64_t max() const { return m_max; }
+    double mean() const { return m_count ? static_cast<double>(m_sum) / static_cast<double>(m_count) : 0.0; }
+
+    // 分位数（0-100），返回所在桶的上界
+    uint64_t percentile(double p) const {
+        if (m_count == 0) {
+            return 0;
+        }
+        uint64_t target = static_cast<uint64_t>(p / 100.0 * static_cast<double>(m_count) + 0.5);
+        if (target == 0) {
+            target = 1;
+        }
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += m_counts[i];
+            if (seen >= target) {
+                const uint64_t upper = i + 1 < kBuckets ? lowerBound(i + 1) - 1 : UINT64_MAX;
+                return upper < m_max ? upper : m_max;
+            }
+        }
+        return m_max;
+    }
+
+    // 遍历非空桶：fn(桶下界, 计数)
+    template<typename Fn>
+    void forEachBucket(Fn&& fn) const {
+        for (size_t i = 0; i < kBuckets; ++i) {
+            if (m_counts[i] != 0) {
+                fn(lowerBound(i), m_counts[i]);
+            }
+        }
+    }
+
+    static size_t bucketOf(uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+#if defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanReverse64(&idx, value);
+        const int msb = static_cast<int>(idx);
+#else
+        const int msb = 63 - __builtin_clzll(value);
+#endif
+        const int shift = msb - kSubBucketBits;
+        return static_cast<size_t>(shift + 1) * kSubBuckets + static_cast<size_t>((value >> shift) & (kSubBuckets - 1));
+    }
+
+    static uint64_t lowerBound(size_t bucket) {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        const size_t shift = bucket / kSubBuckets - 1;
+        return (kSubBuckets + bucket % kSubBuckets) << shift;
+    }
+
+private:
+    uint64_t m_counts[kBuckets];
+    uint64_t m_count;
+    uint64_t m_sum;
+    uint64_t m_min;
+    uint64_t m_max;
+};
+
+} // namespace utils
+} // namespace hft
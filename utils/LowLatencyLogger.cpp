@@ -1,13 +1,161 @@
 #include "LowLatencyLogger.h"
 #include <iostream>
 #include <sstream>
+#include <fstream>
+#include <ctime>
+#include <cstdio>
+#include <unordered_map>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+constexpr uint32_t kPaddingRecord = 0;               // 环尾部填充记录
+constexpr size_t kRecordAlign = 16;
+constexpr char kBinaryMagic[8] = {'H', 'F', 'T', 'B', 'L', 'O', 'G', '2'};
+
+// 二进制文件中的记录类型
+enum class BinaryRecordKind : uint8_t {
+    FORMAT = 1,
+    CALIBRATION = 2,
+    ENTRY = 3
+};
+
+// 环中每条记录的头部
+struct RecordHeader {
+    uint32_t formatId;
+    uint32_t size;      // 含头部、按16字节对齐后的总长度
+    uint64_t tsc;
+};
+static_assert(sizeof(RecordHeader) == kRecordAlign, "record header must be 16 bytes");
+
+// 全局格式串表
+struct FormatRegistry {
+    std::mutex mutex;
+    std::vector<LogFormatSite> sites;
+};
+
+FormatRegistry& formatRegistry() {
+    static FormatRegistry registry;
+    return registry;
+}
+
+bool lookupFormat(uint32_t id, LogFormatSite& site) {
+    auto& registry = formatRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (id == 0 || id > registry.sites.size()) {
+        return false;
+    }
+    site = registry.sites[id - 1];
+    return true;
+}
+
+// log(level, string)兼容接口使用的格式串
+uint32_t plainMessageFormat(LogLevel level) {
+    static const uint32_t ids[] = {
+        LowLatencyLogger::registerFormat({"{}", "", 0, LogLevel::DEBUG}),
+        LowLatencyLogger::registerFormat({"{}", "", 0, LogLevel::INFO}),
+        LowLatencyLogger::registerFormat({"{}", "", 0, LogLevel::WARNING}),
+        LowLatencyLogger::registerFormat({"{}", "", 0, LogLevel::ERROR}),
+        LowLatencyLogger::registerFormat({"{}", "", 0, LogLevel::CRITICAL}),
+    };
+    return ids[static_cast<int>(level)];
+}
+
+int64_t wallClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint64_t nextInstanceId() {
+    static std::atomic<uint64_t> id{1};
+    return id.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename T>
+void writePod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readPod(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+// 单线程写、后台线程读的字节环
+struct LowLatencyLogger::ThreadRing {
+    // 环的归属：写线程退出后由后台线程排空，再标记为空闲供其他线程复用
+    enum State : uint8_t {
+        FREE,       // 空闲，可被新线程取用
+        OWNED,      // 被某个写线程独占
+        RELEASED,   // 写线程已退出，等待后台线程排空
+        SHARED      // 共享环，写入方持有sharedRingMutex，永不回收
+    };
+
+    ThreadRing(size_t bytes, State initial)
+        : buffer(bytes), mask(bytes - 1), state(initial) {}
+
+    std::vector<uint8_t> buffer;
+    size_t mask;
+    alignas(64) std::atomic<uint64_t> head{0};   // 后台线程推进
+    alignas(64) std::atomic<uint64_t> tail{0};   // 写线程推进
+    uint64_t cachedHead{0};
+    uint64_t pendingTail{0};
+    std::atomic<uint8_t> state;
+    std::atomic<bool> orphaned{false};           // 所属日志器已析构
+};
+
+LowLatencyLogger::LowLatencyLogger(const std::string& fileName, LogLevel level,
+                                   LogOutputMode mode, size_t ringSize)
+    : logFileName(fileName),
+      minLevel(level),
+      outputMode(mode),
+      ringBytes(1),
+      running(true),
+      ringCount(0),
+      sharedRing(nullptr),
+      instanceId(nextInstanceId()),
+      dropped(0),
+      consoleOutput(false),
+      overflowPolicy(LogOverflowPolicy::DROP),
+      rotationEnabled(false),
+      maxFileBytes(0),
+      rotateInterval(0),
+      fileBytes(0),
+      fileOpenedAt(std::chrono::steady_clock::now()),
+      rotationSequence(0),
+      formatsWritten(0) {
+    // 环大小取2的幂，至少64KB
+    while (ringBytes < ringSize || ringBytes < (64u << 10)) {
+        ringBytes <<= 1;
+    }
+    rings.reserve(kMaxThreadRings + 1);
+    rings.push_back(std::make_shared<ThreadRing>(ringBytes, ThreadRing::SHARED));
+    sharedRing = rings.back().get();
+    ringCount.store(rings.size(), std::memory_order_release);
+
+    // 粗略校准TSC频率，后台线程会持续修正
+    baseCalibration.tsc = readTimestampCounter();
+    baseCalibration.wallNs = wallClockNs();
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t startTsc = readTimestampCounter();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(2)) {
+    }
+    const uint64_t endTsc = readTimestampCounter();
+    const double elapsedNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    baseCalibration.nsPerTick = endTsc > startTsc ? elapsedNs / static_cast<double>(endTsc - startTsc) : 1.0;
+    currentCalibration = baseCalibration;
+    lastCalibration = std::chrono::steady_clock::now();
 
-LowLatencyLogger::LowLatencyLogger(const std::string& fileName, LogLevel level) 
-    : logFileName(fileName), minLevel(level), running(true) {
     // 打开日志文件
-    logFile.open(fileName, std::ios::out | std::ios::app);
-    if (!logFile.is_open()) {
-        std::cerr << "Failed to open log file: " << fileName << std::endl;
+    if (!logFileName.empty()) {
+        openLogFile(std::ios::app);
     }
 
     // 启动后台写入线程
@@ -15,53 +163,644 @@ LowLatencyLogger::LowLatencyLogger(const std::string& fileName, LogLevel level)
 }
 
 LowLatencyLogger::~LowLatencyLogger() {
-    // 停止后台线程
+    // 停止后台线程（退出前会排空所有环）
     running = false;
     if (writerThread.joinable()) {
         writerThread.join();
     }
 
-    // 刷新剩余日志
-    flush();
+    // 写线程的绑定可能仍持有环，标记后在其退出时一并释放
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (auto& ring : rings) {
+            ring->orphaned.store(true, std::memory_order_release);
+        }
+    }
 
-    // 关闭日志文件
+    std::lock_guard<std::mutex> lock(fileMutex);
     if (logFile.is_open()) {
+        logFile.flush();
         logFile.close();
     }
 }
 
+uint64_t LowLatencyLogger::readTimestampCounter() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+uint32_t LowLatencyLogger::registerFormat(const LogFormatSite& site) {
+    auto& registry = formatRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.sites.push_back(site);
+    return static_cast<uint32_t>(registry.sites.size());
+}
+
+void LowLatencyLogger::log(LogLevel level, const std::string& message) {
+    // 检查日志级别
+    if (level < minLevel.load(std::memory_order_relaxed)) {
+        return;
+    }
+    logFormat(plainMessageFormat(level), level, message);
+}
+
+void LowLatencyLogger::setLogLevel(LogLevel level) {
+    minLevel.store(level, std::memory_order_relaxed);
+}
+
+void LowLatencyLogger::flush() {
+    // 记录当前各环的写入位置，等待后台线程追上
+    std::vector<std::pair<ThreadRing*, uint64_t>> targets;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (auto& ring : rings) {
+            targets.emplace_back(ring.get(), ring->tail.load(std::memory_order_acquire));
+        }
+    }
+    for (auto& target : targets) {
+        while (running && target.first->head.load(std::memory_order_acquire) < target.second) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (logFile.is_open()) {
+        logFile.flush();
+    }
+}
+
+bool LowLatencyLogger::setOutputFile(const std::string& fileName) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (logFile.is_open()) {
+        logFile.flush();
+        logFile.close();
+    }
+    logFileName = fileName;
+    return logFileName.empty() || openLogFile(std::ios::app);
+}
+
+void LowLatencyLogger::setRotation(uint64_t maxBytes, std::chrono::seconds interval) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    maxFileBytes = maxBytes;
+    rotateInterval = interval;
+    rotationEnabled.store(maxBytes > 0 || interval.count() > 0, std::memory_order_release);
+}
+
+bool LowLatencyLogger::openLogFile(std::ios::openmode extraMode) {
+    // 调用方持有fileMutex（或处于构造阶段）
+    // 二进制文件自描述：每个文件都重新写入魔数、格式串与校准点
+    const auto openMode = outputMode == LogOutputMode::BINARY
+        ? std::ios::out | std::ios::binary | std::ios::trunc
+        : std::ios::out | extraMode;
+    logFile.open(logFileName, openMode);
+    fileBytes = 0;
+    fileOpenedAt = std::chrono::steady_clock::now();
+    if (!logFile.is_open()) {
+        std::cerr << "Failed to open log file: " << logFileName << std::endl;
+        return false;
+    }
+    if (outputMode == LogOutputMode::BINARY) {
+        logFile.write(kBinaryMagic, sizeof(kBinaryMagic));
+        formatsWritten = 0;
+        writeCalibration(currentCalibration);
+    } else {
+        logFile.seekp(0, std::ios::end);
+        const auto pos = logFile.tellp();
+        fileBytes = pos > 0 ? static_cast<uint64_t>(pos) : 0;
+    }
+    return true;
+}
+
+void LowLatencyLogger::rotateIfNeeded() {
+    // 调用方持有fileMutex
+    if (!logFile.is_open()) {
+        return;
+    }
+    const bool sizeExceeded = maxFileBytes > 0 && fileBytes >= maxFileBytes;
+    const bool intervalElapsed = rotateInterval.count() > 0 &&
+        std::chrono::steady_clock::now() - fileOpenedAt >= rotateInterval;
+    if (!sizeExceeded && !intervalElapsed) {
+        return;
+    }
+    if (fileBytes == 0) {
+        fileOpenedAt = std::chrono::steady_clock::now();
+        return;
+    }
+
+    logFile.flush();
+    logFile.close();
+
+    // 归档文件名：<原文件名>.<YYYYMMDD-HHMMSS>.<序号>
+    const std::time_t now = std::time(nullptr);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &now);
+#else
+    localtime_r(&now, &tm);
+#endif
+    char suffix[48];
+    std::snprintf(suffix, sizeof(suffix), ".%04d%02d%02d-%02d%02d%02d.%u",
+                  tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                  tm.tm_hour, tm.tm_min, tm.tm_sec, ++rotationSequence);
+    const std::string archived = logFileName + suffix;
+    if (std::rename(logFileName.c_str(), archived.c_str()) != 0) {
+        std::cerr << "Failed to rotate log file: " << logFileName << std::endl;
+    }
+    openLogFile(std::ios::trunc);
+}
+
+void LowLatencyLogger::writeConsole(LogLevel level, const std::string& line) {
+    // 根据日志级别设置控制台颜色
+    const char* color = "\033[0m";
+    switch (level) {
+        case LogLevel::DEBUG: color = "\033[37m"; break;
+        case LogLevel::INFO: color = "\033[32m"; break;
+        case LogLevel::WARNING: color = "\033[33m"; break;
+        case LogLevel::ERROR: color = "\033[31m"; break;
+        case LogLevel::CRITICAL: color = "\033[41;37m"; break;
+    }
+    std::cout << color << line << "\033[0m";
+}
+
+std::shared_ptr<LowLatencyLogger::ThreadRing> LowLatencyLogger::acquireRingLocked() {
+    // 优先复用已排空的环，避免线程频繁创建退出时无限增长
+    for (auto& ring : rings) {
+        uint8_t expected = ThreadRing::FREE;
+        if (ring->state.compare_exchange_strong(expected, ThreadRing::OWNED, std::memory_order_acq_rel)) {
+            ring->cachedHead = ring->head.load(std::memory_order_acquire);
+            ring->pendingTail = ring->tail.load(std::memory_order_relaxed);
+            return ring;
+        }
+    }
+    if (rings.size() >= kMaxThreadRings + 1) {
+        return nullptr;
+    }
+    rings.push_back(std::make_shared<ThreadRing>(ringBytes, ThreadRing::OWNED));
+    ringCount.store(rings.size(), std::memory_order_release);
+    return rings.back();
+}
+
+LowLatencyLogger::ThreadRing* LowLatencyLogger::localRing() {
+    // 线程本地的 日志器 -> 环 绑定，线程退出时把环交还给后台线程
+    constexpr size_t kMaxBindings = 8;
+    struct Bindings {
+        struct Entry {
+            uint64_t instance;
+            std::shared_ptr<ThreadRing> ring;
+        };
+        Entry entries[kMaxBindings];
+        size_t count = 0;
+
+        static void release(Entry& entry) {
+            entry.ring->state.store(ThreadRing::RELEASED, std::memory_order_release);
+            entry.ring.reset();
+        }
+
+        ~Bindings() {
+            for (size_t i = 0; i < count; ++i) {
+                release(entries[i]);
+            }
+        }
+    };
+    thread_local Bindings bindings;
+
+    for (size_t i = 0; i < bindings.count; ++i) {
+        if (bindings.entries[i].instance == instanceId) {
+            return bindings.entries[i].ring.get();
+        }
+    }
+
+    // 首次在本线程记录日志：取一个空闲环或新建一个
+    std::shared_ptr<ThreadRing> ring;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        ring = acquireRingLocked();
+    }
+    if (!ring) {
+        return nullptr;
+    }
+
+    size_t slot = bindings.count;
+    if (slot == kMaxBindings) {
+        // 绑定表已满：优先替换已析构日志器的条目，否则轮换覆盖（被换下的环交还复用）
+        slot = instanceId % kMaxBindings;
+        for (size_t i = 0; i < kMaxBindings; ++i) {
+            if (bindings.entries[i].ring->orphaned.load(std::memory_order_acquire)) {
+                slot = i;
+                break;
+            }
+        }
+        Bindings::release(bindings.entries[slot]);
+    } else {
+        ++bindings.count;
+    }
+    bindings.entries[slot] = {instanceId, std::move(ring)};
+    return bindings.entries[slot].ring.get();
+}
+
+uint8_t* LowLatencyLogger::beginRecord(ThreadRing*& ring, uint32_t formatId, LogLevel level, size_t payloadBytes) {
+    const size_t total = (sizeof(RecordHeader) + payloadBytes + kRecordAlign - 1) & ~(kRecordAlign - 1);
+    if (total > ringBytes / 2) {
+        return nullptr;
+    }
+
+    ring = localRing();
+    if (!ring) {
+        // 独占环用尽：退回到共享环，持锁直到commitRecord
+        ring = sharedRing;
+        sharedRingMutex.lock();
+    }
+    uint8_t* dst = reserveRecord(ring, formatId, total, level >= LogLevel::ERROR);
+    if (!dst && ring == sharedRing) {
+        sharedRingMutex.unlock();
+    }
+    return dst;
+}
+
+uint8_t* LowLatencyLogger::reserveRecord(ThreadRing* ring, uint32_t formatId, size_t total, bool mustDeliver) {
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    const size_t pos = static_cast<size_t>(tail) & ring->mask;
+    const size_t contiguous = ringBytes - pos;
+    const size_t needed = total <= contiguous ? total : total + contiguous;
+
+    if (ringBytes - (tail - ring->cachedHead) < needed) {
+        ring->cachedHead = ring->head.load(std::memory_order_acquire);
+        while (ringBytes - (tail - ring->cachedHead) < needed) {
+            // 环满：默认丢弃而不是阻塞交易线程，错误日志则等待后台线程腾出空间
+            if (!running.load(std::memory_order_relaxed) ||
+                (!mustDeliver && overflowPolicy.load(std::memory_order_relaxed) == LogOverflowPolicy::DROP)) {
+                return nullptr;
+            }
+            std::this_thread::yield();
+            ring->cachedHead = ring->head.load(std::memory_order_acquire);
+        }
+    }
+
+    if (total > contiguous) {
+        // 尾部空间不足，写入填充记录后回绕到环首
+        RecordHeader padding{kPaddingRecord, static_cast<uint32_t>(contiguous), 0};
+        std::memcpy(&ring->buffer[pos], &padding, sizeof(padding));
+        tail += contiguous;
+    }
+
+    RecordHeader header{formatId, static_cast<uint32_t>(total), readTimestampCounter()};
+    uint8_t* dst = &ring->buffer[static_cast<size_t>(tail) & ring->mask];
+    std::memcpy(dst, &header, sizeof(header));
+    ring->pendingTail = tail + total;
+    return dst + sizeof(RecordHeader);
+}
+
+void LowLatencyLogger::commitRecord(ThreadRing* ring) {
+    ring->tail.store(ring->pendingTail, std::memory_order_release);
+    if (ring == sharedRing) {
+        sharedRingMutex.unlock();
+    }
+}
+
+void LowLatencyLogger::writeSynchronous(uint32_t formatId, const uint8_t* payload, size_t len) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    // 先写出环中已提交的记录，保持本线程日志的先后顺序
+    drainRingsLocked();
+    handleRecord(formatId, readTimestampCounter(), payload, len);
+    if (logFile.is_open()) {
+        logFile.flush();
+    }
+    if (consoleOutput.load(std::memory_order_relaxed)) {
+        std::cout.flush();
+    }
+}
+
 void LowLatencyLogger::writerThreadFunc() {
-    while (running || !logQueue.empty()) {
-        if (!logQueue.empty()) {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            if (!logQueue.empty()) {
-                LogEntry entry = logQueue.front();
-                logQueue.pop();
-
-                // 格式化日志条目
-                std::string levelStr = logLevelToString(entry.level);
-                auto timePoint = std::chrono::system_clock::from_time_t(entry.timestamp / 1000000000);
-                auto time = std::chrono::system_clock::to_time_t(timePoint);
-                std::string timeStr = std::ctime(&time);
-                timeStr.pop_back(); // 移除换行符
-
-                // 写入日志文件
-                if (logFile.is_open()) {
-                    logFile << "[" << timeStr << "." << (entry.timestamp % 1000000000) << "] [" 
-                           << levelStr << "] " << entry.message << std::endl;
-                } else {
-                    std::cerr << "[" << timeStr << "." << (entry.timestamp % 1000000000) << "] [" 
-                              << levelStr << "] " << entry.message << std::endl;
-                }
+    while (running.load(std::memory_order_acquire)) {
+        const size_t processed = drainRings();
+        if (std::chrono::steady_clock::now() - lastCalibration > std::chrono::seconds(1)) {
+            updateCalibration();
+        }
+        if (rotationEnabled.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(fileMutex);
+            rotateIfNeeded();
+        }
+        if (processed == 0) {
+            // 后台线程空闲时休眠，不影响写线程
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    // 退出前排空剩余记录
+    while (drainRings() > 0) {
+    }
+}
+
+size_t LowLatencyLogger::drainRings() {
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    return drainRingsLocked();
+}
+
+size_t LowLatencyLogger::drainRingsLocked() {
+    // 调用方持有fileMutex，因此同步写出路径与后台线程不会同时消费同一个环
+    const size_t count = ringCount.load(std::memory_order_acquire);
+    if (outputMode == LogOutputMode::BINARY && logFile.is_open()) {
+        writeFormatDefinitions();
+    }
+
+    size_t processed = 0;
+    for (size_t i = 0; i < count; ++i) {
+        ThreadRing* ring;
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            ring = rings[i].get();
+        }
+
+        // 先读归属再读tail：写线程交还环之前的全部写入此时都可见
+        const uint8_t state = ring->state.load(std::memory_order_acquire);
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        const uint64_t tail = ring->tail.load(std::memory_order_acquire);
+        while (head < tail) {
+            RecordHeader header;
+            const uint8_t* src = &ring->buffer[static_cast<size_t>(head) & ring->mask];
+            std::memcpy(&header, src, sizeof(header));
+            if (header.formatId != kPaddingRecord) {
+                handleRecord(header.formatId, header.tsc, src + sizeof(RecordHeader),
+                             header.size - sizeof(RecordHeader));
+                ++processed;
             }
-        } else {
-            // 短暂休眠以避免CPU占用过高
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
+            head += header.size;
+        }
+        ring->head.store(head, std::memory_order_release);
+        if (state == ThreadRing::RELEASED) {
+            // 已排空，交给下一个线程复用
+            ring->state.store(ThreadRing::FREE, std::memory_order_release);
         }
     }
+    if (processed > 0 && consoleOutput.load(std::memory_order_relaxed)) {
+        std::cout.flush();
+    }
+    return processed;
+}
+
+void LowLatencyLogger::handleRecord(uint32_t formatId, uint64_t tsc, const uint8_t* payload, size_t len) {
+    const bool toConsole = consoleOutput.load(std::memory_order_relaxed);
+    const bool binaryFile = outputMode == LogOutputMode::BINARY && logFile.is_open();
+
+    if (binaryFile) {
+        writePod(logFile, BinaryRecordKind::ENTRY);
+        writePod(logFile, formatId);
+        writePod(logFile, tsc);
+        const uint32_t n = static_cast<uint32_t>(len);
+        writePod(logFile, n);
+        logFile.write(reinterpret_cast<const char*>(payload), n);
+        fileBytes += sizeof(BinaryRecordKind) + sizeof(formatId) + sizeof(tsc) + sizeof(n) + n;
+    }
+    if (!toConsole && (binaryFile || !logFile.is_open())) {
+        return;
+    }
+
+    LogFormatSite site;
+    if (len == 0 || !lookupFormat(formatId, site)) {
+        return;
+    }
+    // 级别取自记录本身，而不是调用点首次注册时的级别
+    const LogLevel level = static_cast<LogLevel>(payload[0]);
+    formatMessage(site.format, payload + 1, len - 1, messageBuffer);
+    formatLine(level, tscToWallNs(currentCalibration, tsc), messageBuffer, lineBuffer);
+    if (!binaryFile && logFile.is_open()) {
+        logFile.write(lineBuffer.data(), static_cast<std::streamsize>(lineBuffer.size()));
+        fileBytes += lineBuffer.size();
+    }
+    if (toConsole) {
+        writeConsole(level, lineBuffer);
+    }
+}
+
+void LowLatencyLogger::writeFormatDefinitions() {
+    auto& registry = formatRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    while (formatsWritten < registry.sites.size()) {
+        const LogFormatSite& site = registry.sites[formatsWritten];
+        ++formatsWritten;
+        const uint32_t fmtLen = static_cast<uint32_t>(std::strlen(site.format));
+        const uint32_t fileLen = static_cast<uint32_t>(std::strlen(site.file));
+        writePod(logFile, BinaryRecordKind::FORMAT);
+        writePod(logFile, formatsWritten);
+        writePod(logFile, static_cast<uint8_t>(site.level));
+        writePod(logFile, static_cast<int32_t>(site.line));
+        writePod(logFile, fmtLen);
+        logFile.write(site.format, fmtLen);
+        writePod(logFile, fileLen);
+        logFile.write(site.file, fileLen);
+    }
+}
+
+void LowLatencyLogger::writeCalibration(const Calibration& cal) {
+    if (!logFile.is_open()) {
+        return;
+    }
+    writePod(logFile, BinaryRecordKind::CALIBRATION);
+    writePod(logFile, cal.tsc);
+    writePod(logFile, cal.wallNs);
+    writePod(logFile, cal.nsPerTick);
+}
+
+void LowLatencyLogger::updateCalibration() {
+    const uint64_t tsc = readTimestampCounter();
+    const int64_t wall = wallClockNs();
+    lastCalibration = std::chrono::steady_clock::now();
+    if (tsc <= baseCalibration.tsc) {
+        return;
+    }
+
+    Calibration cal;
+    cal.tsc = tsc;
+    cal.wallNs = wall;
+    cal.nsPerTick = static_cast<double>(wall - baseCalibration.wallNs) /
+                    static_cast<double>(tsc - baseCalibration.tsc);
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    currentCalibration = cal;
+    if (outputMode == LogOutputMode::BINARY) {
+        writeCalibration(cal);
+    }
 }
 
-std::string LowLatencyLogger::logLevelToString(LogLevel level) const {
+int64_t LowLatencyLogger::tscToWallNs(const Calibration& cal, uint64_t tsc) {
+    const double delta = tsc >= cal.tsc
+        ? static_cast<double>(tsc - cal.tsc)
+        : -static_cast<double>(cal.tsc - tsc);
+    return cal.wallNs + static_cast<int64_t>(delta * cal.nsPerTick);
+}
+
+void LowLatencyLogger::formatMessage(const char* format, const uint8_t* payload, size_t len, std::string& out) {
+    out.clear();
+    if (len == 0) {
+        out.append(format);
+        return;
+    }
+
+    const size_t argc = payload[0];
+    const uint8_t* tags = payload + 1;
+    const uint8_t* values = tags + argc;
+    const uint8_t* end = payload + len;
+    size_t next = 0;
+    char number[32];
+
+    for (const char* p = format; *p; ++p) {
+        if (p[0] != '{' || p[1] != '}' || next >= argc) {
+            out.push_back(*p);
+            continue;
+        }
+        ++p;
+
+        const ArgType type = static_cast<ArgType>(tags[next++]);
+        if (type == ArgType::STRING) {
+            uint32_t n = 0;
+            std::memcpy(&n, values, sizeof(n));
+            values += sizeof(n);
+            if (values + n > end) {
+                break;
+            }
+            out.append(reinterpret_cast<const char*>(values), n);
+            values += n;
+            continue;
+        }
+
+        uint64_t raw = 0;
+        if (values + sizeof(raw) > end) {
+            break;
+        }
+        std::memcpy(&raw, values, sizeof(raw));
+        values += sizeof(raw);
+
+        int written = 0;
+        switch (type) {
+        case ArgType::INT64:
+            written = std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(raw));
+            break;
+        case ArgType::UINT64:
+            written = std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(raw));
+            break;
+        case ArgType::DOUBLE: {
+            double d;
+            std::memcpy(&d, &raw, sizeof(d));
+            written = std::snprintf(number, sizeof(number), "%.10g", d);
+            break;
+        }
+        case ArgType::CHAR:
+            number[0] = static_cast<char>(raw);
+            written = 1;
+            break;
+        case ArgType::BOOL:
+            written = std::snprintf(number, sizeof(number), "%s", raw ? "true" : "false");
+            break;
+        case ArgType::POINTER:
+            written = std::snprintf(number, sizeof(number), "0x%llx", static_cast<unsigned long long>(raw));
+            break;
+        default:
+            break;
+        }
+        if (written > 0) {
+            out.append(number, static_cast<size_t>(written));
+        }
+    }
+}
+
+void LowLatencyLogger::formatLine(LogLevel level, int64_t wallNs, const std::string& message, std::string& out) {
+    const std::time_t seconds = static_cast<std::time_t>(wallNs / 1000000000);
+    const long nanos = static_cast<long>(wallNs % 1000000000);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &seconds);
+#else
+    localtime_r(&seconds, &tm);
+#endif
+    char prefix[64];
+    const int n = std::snprintf(prefix, sizeof(prefix), "[%04d-%02d-%02d %02d:%02d:%02d.%09ld] [",
+                                tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                                tm.tm_hour, tm.tm_min, tm.tm_sec, nanos);
+    out.assign(prefix, n > 0 ? static_cast<size_t>(n) : 0);
+    out.append(logLevelToString(level));
+    out.append("] ");
+    out.append(message);
+    out.push_back('\n');
+}
+
+bool LowLatencyLogger::decodeBinaryLog(const std::string& binaryFile, std::ostream& out) {
+    std::ifstream in(binaryFile, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open binary log: " << binaryFile << std::endl;
+        return false;
+    }
+
+    char magic[sizeof(kBinaryMagic)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kBinaryMagic, sizeof(magic)) != 0) {
+        std::cerr << "Not a binary log file: " << binaryFile << std::endl;
+        return false;
+    }
+
+    struct Format {
+        std::string format;
+        LogLevel level;
+    };
+    std::unordered_map<uint32_t, Format> formats;
+    Calibration cal{0, 0, 1.0};
+    std::vector<uint8_t> payload;
+    std::string message;
+    std::string line;
+
+    BinaryRecordKind kind;
+    while (readPod(in, kind)) {
+        switch (kind) {
+        case BinaryRecordKind::FORMAT: {
+            uint32_t id, fmtLen, fileLen;
+            uint8_t level;
+            int32_t lineNo;
+            if (!readPod(in, id) || !readPod(in, level) || !readPod(in, lineNo) || !readPod(in, fmtLen)) {
+                return false;
+            }
+            std::string fmt(fmtLen, '\0');
+            in.read(&fmt[0], fmtLen);
+            if (!readPod(in, fileLen)) {
+                return false;
+            }
+            in.ignore(fileLen);
+            formats[id] = {fmt, static_cast<LogLevel>(level)};
+            break;
+        }
+        case BinaryRecordKind::CALIBRATION:
+            if (!readPod(in, cal.tsc) || !readPod(in, cal.wallNs) || !readPod(in, cal.nsPerTick)) {
+                return false;
+            }
+            break;
+        case BinaryRecordKind::ENTRY: {
+            uint32_t id, n;
+            uint64_t tsc;
+            if (!readPod(in, id) || !readPod(in, tsc) || !readPod(in, n)) {
+                return false;
+            }
+            payload.resize(n);
+            if (n > 0 && !in.read(reinterpret_cast<char*>(payload.data()), n)) {
+                return false;
+            }
+            auto it = formats.find(id);
+            if (n == 0 || it == formats.end()) {
+                continue;
+            }
+            formatMessage(it->second.format.c_str(), payload.data() + 1, payload.size() - 1, message);
+            formatLine(static_cast<LogLevel>(payload[0]), tscToWallNs(cal, tsc), message, line);
+            out << line;
+            break;
+        }
+        default:
+            std::cerr << "Corrupted binary log: unknown record kind " << static_cast<int>(kind) << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* LowLatencyLogger::logLevelToString(LogLevel level) {
     switch (level) {
         case LogLevel::DEBUG:
             return "DEBUG";
@@ -77,32 +816,3 @@ std::string LowLatencyLogger::logLevelToString(LogLevel level) const {
             return "UNKNOWN";
     }
 }
-
-void LowLatencyLogger::log(LogLevel level, const std::string& message) {
-    // 检查日志级别
-    if (level < minLevel) {
-        return;
-    }
-
-    // 创建日志条目
-    LogEntry entry;
-    entry.level = level;
-    entry.message = message;
-    entry.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
-
-    // 添加到队列
-    std::lock_guard<std::mutex> lock(queueMutex);
-    logQueue.push(entry);
-}
-
-void LowLatencyLogger::setLogLevel(LogLevel level) {
-    minLevel = level;
-}
-
-void LowLatencyLogger::flush() {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    if (logFile.is_open()) {
-        logFile.flush();
-    }
-}
\ No newline at end of file
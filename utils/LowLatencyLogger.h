@@ -3,9 +3,14 @@
 #include <fstream>
 #include <mutex>
 #include <atomic>
-#include <queue>
 #include <thread>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+#include <vector>
 
 // 日志级别枚举
 enum class LogLevel {
@@ -16,46 +21,300 @@ enum class LogLevel {
     CRITICAL
 };
 
-// 日志条目结构体
-struct LogEntry {
+// 输出模式
+enum class LogOutputMode {
+    TEXT,    // 后台线程解码并格式化为文本
+    BINARY   // 后台线程直接落盘二进制记录，由decodeBinaryLog离线转换
+};
+
+// 线程环写满时的处理策略（只作用于ERROR以下级别，ERROR/CRITICAL总是等待，从不丢弃）
+enum class LogOverflowPolicy {
+    DROP,    // 丢弃并计数（默认，交易线程永不阻塞）
+    BLOCK    // 等待后台线程腾出空间
+};
+
+// 格式串描述（每个调用点注册一次）
+struct LogFormatSite {
+    const char* format;
+    const char* file;
+    int line;
     LogLevel level;
-    std::string message;
-    uint64_t timestamp;
 };
 
 // 低延迟日志器类
+//
+// 热路径只写入一条紧凑的二进制记录：格式串ID + TSC时间戳 + 级别 + 原始参数，
+// 写入调用线程独占的SPSC字节环，不加锁、不分配内存、不格式化字符串。
+// 后台线程负责按格式串替换"{}"占位符并写出文本，或直接写出二进制记录。
+//
+// 线程环最多kMaxThreadRings个：线程退出时交还自己的环，后台线程排空后供新线程复用；
+// 所有环都被占用时退回到一个加锁的共享环，日志不会因线程数过多而丢失。
+//
+// 用法：
+//     LLOG(logger, LogLevel::INFO, "order {} filled {}@{}", order_id, qty, px);
 class LowLatencyLogger {
+public:
+    // 参数类型标签
+    enum class ArgType : uint8_t {
+        INT64,
+        UINT64,
+        DOUBLE,
+        CHAR,
+        BOOL,
+        STRING,
+        POINTER
+    };
+
+    static constexpr size_t kDefaultRingBytes = 1 << 20;   // 每线程环大小
+    static constexpr size_t kMaxThreadRings = 64;          // 线程独占环数量（另有一个共享环）
+
+    // 构造函数（fileName为空时只输出到控制台）
+    LowLatencyLogger(const std::string& fileName, LogLevel level = LogLevel::INFO,
+                     LogOutputMode mode = LogOutputMode::TEXT, size_t ringBytes = kDefaultRingBytes);
+    // 析构函数
+    ~LowLatencyLogger();
+
+    LowLatencyLogger(const LowLatencyLogger&) = delete;
+    LowLatencyLogger& operator=(const LowLatencyLogger&) = delete;
+
+    // 记录日志（兼容接口，消息按字节拷贝进环，不做格式化）
+    void log(LogLevel level, const std::string& message);
+
+    // 记录延迟格式化的日志，通常通过LLOG宏调用
+    template<typename... Args>
+    void logFormat(uint32_t formatId, LogLevel level, const Args&... args) {
+        if (level < minLevel.load(std::memory_order_relaxed)) {
+            return;
+        }
+        // 负载布局：级别(1字节) + 参数个数(1字节) + 类型标签(每参数1字节) + 参数值
+        const size_t payload = 2 + sizeof...(Args) + argsSize(args...);
+        ThreadRing* ring = nullptr;
+        uint8_t* dst = beginRecord(ring, formatId, level, payload);
+        if (dst) {
+            encodePayload(dst, level, args...);
+            commitRecord(ring);
+        } else if (level >= LogLevel::ERROR) {
+            // 记录超过环容量或后台线程已停止：错误日志在调用线程同步写出
+            std::vector<uint8_t> buffer(payload);
+            encodePayload(buffer.data(), level, args...);
+            writeSynchronous(formatId, buffer.data(), buffer.size());
+        } else {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // 设置日志级别
+    void setLogLevel(LogLevel level);
+    bool isEnabled(LogLevel level) const { return level >= minLevel.load(std::memory_order_relaxed); }
+    // 等待已写入的记录全部落盘
+    void flush();
+
+    // 切换输出文件
+    bool setOutputFile(const std::string& fileName);
+    // 同时输出到控制台（由后台线程写出）
+    void setConsoleOutput(bool enable) { consoleOutput.store(enable, std::memory_order_relaxed); }
+    // 设置环满时的处理策略
+    void setOverflowPolicy(LogOverflowPolicy policy) { overflowPolicy.store(policy, std::memory_order_relaxed); }
+    // 按大小/时间滚动日志文件，0表示不限制；滚动在后台线程完成
+    void setRotation(uint64_t maxFileBytes, std::chrono::seconds interval);
+
+    // 因环满而丢弃的记录数（只会是ERROR以下级别）
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+    // 已创建的环数量（含共享环），线程退出后环被复用，不随线程数增长
+    size_t getRingCount() const { return ringCount.load(std::memory_order_relaxed); }
+
+    // 注册格式串，返回全局唯一ID（非热路径，每个调用点只调用一次）
+    static uint32_t registerFormat(const LogFormatSite& site);
+
+    // 读取二进制日志并输出文本
+    static bool decodeBinaryLog(const std::string& binaryFile, std::ostream& out);
+
+    // 读取时间戳计数器
+    static uint64_t readTimestampCounter();
+
 private:
+    struct ThreadRing;
+    struct Calibration {
+        uint64_t tsc;
+        int64_t wallNs;
+        double nsPerTick;
+    };
+
+    // 参数编码
+    static size_t argsSize() { return 0; }
+    template<typename T, typename... Rest>
+    static size_t argsSize(const T& v, const Rest&... rest) {
+        return argSize(v) + argsSize(rest...);
+    }
+
+    template<typename T>
+    static size_t argSize(const T&) {
+        static_assert(std::is_arithmetic<T>::value || std::is_pointer<T>::value || std::is_enum<T>::value,
+                      "unsupported log argument type");
+        return 8;
+    }
+    static size_t argSize(const std::string& s) { return sizeof(uint32_t) + s.size(); }
+    static size_t argSize(const char* s) { return sizeof(uint32_t) + (s ? std::strlen(s) : 0); }
+    static size_t argSize(char* s) { return argSize(static_cast<const char*>(s)); }
+    template<size_t N>
+    static size_t argSize(const char (&s)[N]) { return argSize(static_cast<const char*>(s)); }
+
+    template<typename... Args>
+    static void encodePayload(uint8_t* dst, LogLevel level, const Args&... args) {
+        dst[0] = static_cast<uint8_t>(level);
+        dst[1] = static_cast<uint8_t>(sizeof...(Args));
+        uint8_t* tags = dst + 2;
+        uint8_t* values = tags + sizeof...(Args);
+        encodeArgs(tags, values, args...);
+    }
+
+    static void encodeArgs(uint8_t*&, uint8_t*&) {}
+    template<typename T, typename... Rest>
+    static void encodeArgs(uint8_t*& tags, uint8_t*& values, const T& v, const Rest&... rest) {
+        encodeArg(tags, values, v);
+        encodeArgs(tags, values, rest...);
+    }
+
+    template<typename T>
+    static void encodeArg(uint8_t*& tags, uint8_t*& values, const T& v) {
+        ArgType type;
+        uint64_t raw = 0;
+        if constexpr (std::is_same<T, bool>::value) {
+            type = ArgType::BOOL;
+            raw = v ? 1 : 0;
+        } else if constexpr (std::is_same<T, char>::value) {
+            type = ArgType::CHAR;
+            raw = static_cast<uint64_t>(static_cast<unsigned char>(v));
+        } else if constexpr (std::is_floating_point<T>::value) {
+            type = ArgType::DOUBLE;
+            const double d = static_cast<double>(v);
+            std::memcpy(&raw, &d, sizeof(d));
+        } else if constexpr (std::is_pointer<T>::value) {
+            type = ArgType::POINTER;
+            raw = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(v));
+        } else if constexpr (std::is_enum<T>::value || std::is_signed<T>::value) {
+            type = ArgType::INT64;
+            raw = static_cast<uint64_t>(static_cast<int64_t>(v));
+        } else {
+            type = ArgType::UINT64;
+            raw = static_cast<uint64_t>(v);
+        }
+        *tags++ = static_cast<uint8_t>(type);
+        std::memcpy(values, &raw, sizeof(raw));
+        values += sizeof(raw);
+    }
+
+    static void encodeString(uint8_t*& tags, uint8_t*& values, const char* s, size_t len) {
+        *tags++ = static_cast<uint8_t>(ArgType::STRING);
+        const uint32_t n = static_cast<uint32_t>(len);
+        std::memcpy(values, &n, sizeof(n));
+        if (n > 0) {
+            std::memcpy(values + sizeof(n), s, n);
+        }
+        values += sizeof(n) + n;
+    }
+    static void encodeArg(uint8_t*& tags, uint8_t*& values, const std::string& s) {
+        encodeString(tags, values, s.data(), s.size());
+    }
+    static void encodeArg(uint8_t*& tags, uint8_t*& values, const char* s) {
+        encodeString(tags, values, s ? s : "", s ? std::strlen(s) : 0);
+    }
+    static void encodeArg(uint8_t*& tags, uint8_t*& values, char* s) {
+        encodeArg(tags, values, static_cast<const char*>(s));
+    }
+    template<size_t N>
+    static void encodeArg(uint8_t*& tags, uint8_t*& values, const char (&s)[N]) {
+        encodeArg(tags, values, static_cast<const char*>(s));
+    }
+
+    // 在当前线程的环（或共享环）中预留一条记录，返回负载区指针；无法写入时返回nullptr。
+    // ring返回实际使用的环，成功时必须以commitRecord(ring)提交（共享环在提交时解锁）。
+    // ERROR及以上级别环满时总是等待后台线程，不受溢出策略影响
+    uint8_t* beginRecord(ThreadRing*& ring, uint32_t formatId, LogLevel level, size_t payloadBytes);
+    void commitRecord(ThreadRing* ring);
+    uint8_t* reserveRecord(ThreadRing* ring, uint32_t formatId, size_t total, bool mustDeliver);
+    // 绕过环直接格式化写出（持有fileMutex，与后台线程串行）
+    void writeSynchronous(uint32_t formatId, const uint8_t* payload, size_t len);
+    // 本线程绑定的环；没有可用的独占环时返回nullptr
+    ThreadRing* localRing();
+    // 取一个空闲环或新建一个（调用方持有ringsMutex）
+    std::shared_ptr<ThreadRing> acquireRingLocked();
+
+    // 后台写入函数
+    void writerThreadFunc();
+    size_t drainRings();
+    size_t drainRingsLocked();
+    void writeFormatDefinitions();
+    void writeCalibration(const Calibration& cal);
+    void handleRecord(uint32_t formatId, uint64_t tsc, const uint8_t* payload, size_t len);
+    void updateCalibration();
+    bool openLogFile(std::ios::openmode extraMode);
+    void rotateIfNeeded();
+    void writeConsole(LogLevel level, const std::string& line);
+
+    static void formatMessage(const char* format, const uint8_t* payload, size_t len, std::string& out);
+    static void formatLine(LogLevel level, int64_t wallNs, const std::string& message, std::string& out);
+    static int64_t tscToWallNs(const Calibration& cal, uint64_t tsc);
+
+    // 将日志级别转换为字符串
+    static const char* logLevelToString(LogLevel level);
+
     // 日志文件名
     std::string logFileName;
     // 日志级别
-    LogLevel minLevel;
-    // 日志队列
-    std::queue<LogEntry> logQueue;
-    // 互斥锁保护队列
-    std::mutex queueMutex;
+    std::atomic<LogLevel> minLevel;
+    // 输出模式
+    LogOutputMode outputMode;
+    // 每线程环大小
+    size_t ringBytes;
     // 原子标志控制后台线程
     std::atomic<bool> running;
     // 后台写入线程
     std::thread writerThread;
     // 日志文件流
     std::ofstream logFile;
+    // 保护线程环注册与文件写入
+    std::mutex ringsMutex;
+    std::mutex fileMutex;
+    // 环由日志器与写线程的绑定共同持有，任一方先销毁都不会悬空
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    std::atomic<size_t> ringCount;
+    // 独占环用尽时的共享环（rings[0]），写入时持有sharedRingMutex
+    ThreadRing* sharedRing;
+    std::mutex sharedRingMutex;
+    // 日志器实例标识（线程环绑定用）
+    uint64_t instanceId;
+    // 丢弃计数
+    std::atomic<uint64_t> dropped;
+    // 控制台输出与溢出策略
+    std::atomic<bool> consoleOutput;
+    std::atomic<LogOverflowPolicy> overflowPolicy;
+    // 文件滚动（受fileMutex保护）
+    std::atomic<bool> rotationEnabled;
+    uint64_t maxFileBytes;
+    std::chrono::seconds rotateInterval;
+    uint64_t fileBytes;
+    std::chrono::steady_clock::time_point fileOpenedAt;
+    uint32_t rotationSequence;
+    // 已写入二进制文件的格式串数量
+    uint32_t formatsWritten;
+    // TSC到墙钟的换算
+    Calibration baseCalibration;
+    Calibration currentCalibration;
+    std::chrono::steady_clock::time_point lastCalibration;
+    // 后台线程复用的格式化缓冲区
+    std::string messageBuffer;
+    std::string lineBuffer;
+};
 
-    // 后台写入函数
-    void writerThreadFunc();
-    // 将日志级别转换为字符串
-    std::string logLevelToString(LogLevel level) const;
-
-public:
-    // 构造函数
-    LowLatencyLogger(const std::string& fileName, LogLevel level = LogLevel::INFO);
-    // 析构函数
-    ~LowLatencyLogger();
-
-    // 记录日志
-    void log(LogLevel level, const std::string& message);
-    // 设置日志级别
-    void setLogLevel(LogLevel level);
-    // 刷新日志到文件
-    void flush();
-};
\ No newline at end of file
+// 每个调用点只注册一次格式串，热路径仅做级别判断与参数拷贝。
+// 级别每次调用都重新判断并随记录写入，调用点的level可以是运行时变量
+#define LLOG(logger, level, fmt, ...)                                                        \
+    do {                                                                                     \
+        const ::LogLevel llogLevel_ = (level);                                               \
+        if ((logger).isEnabled(llogLevel_)) {                                                \
+            static const uint32_t llogFormatId_ =                                            \
+                ::LowLatencyLogger::registerFormat({fmt, __FILE__, __LINE__, llogLevel_});   \
+            (logger).logFormat(llogFormatId_, llogLevel_, ##__VA_ARGS__);                     \
+        }                                                                                    \
+    } while (0)
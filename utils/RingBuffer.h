@@ -0,0 +1,403 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace hft {
+namespace utils {
+
+constexpr size_t kCacheLineSize = 64;
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+inline size_t roundUpPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+// 等待策略：队列满（生产者）或空（消费者）时如何等待
+// waitUntil(ready) 在ready()为真前阻塞，notify() 在状态变化后唤醒等待者
+
+// 忙等：最低延迟，独占CPU核心
+struct SpinWait {
+    template<typename Pred>
+    void waitUntil(Pred&& ready) {
+        while (!ready()) {
+            cpuRelax();
+        }
+    }
+    void notify() {}
+};
+
+// 让出CPU：适合与其他线程共享核心
+struct YieldWait {
+    template<typename Pred>
+    void waitUntil(Pred&& ready) {
+        while (!ready()) {
+            std::this_thread::yield();
+        }
+    }
+    void notify() {}
+};
+
+// 阻塞：短暂自旋后挂起在条件变量上，仅在存在等待者时才由notify加锁
+class BlockingWait {
+public:
+    template<typename Pred>
+    void waitUntil(Pred&& ready) {
+        for (int i = 0; i < kSpinIterations; ++i) {
+            if (ready()) {
+                return;
+            }
+            cpuRelax();
+        }
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] { return ready(); });
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_all();
+        }
+    }
+
+private:
+    static constexpr int kSpinIterations = 256;
+
+    std::atomic<int> waiters_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+// 有界单生产者单消费者环形队列
+// 容量向上取整为2的幂；头尾索引各占一个缓存行，并缓存对端索引以减少跨核读取
+template<typename T, typename WaitPolicy = SpinWait>
+class SPSCRingBuffer {
+public:
+    explicit SPSCRingBuffer(size_t capacity)
+        : capacity_(roundUpPowerOfTwo(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1),
+          slots_(static_cast<Slot*>(::operator new(sizeof(Slot) * capacity_))) {}
+
+    ~SPSCRingBuffer() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        for (size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+            ptr(i)->~T();
+        }
+        ::operator delete(slots_);
+    }
+
+    SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+    SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+
+    // 原地构造，队列满时返回false
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ >= capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ >= capacity_) {
+                return false;
+            }
+        }
+        new (ptr(tail)) T(std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        consumer_wait_.notify();
+        return true;
+    }
+
+    bool try_push(const T& value) { return try_emplace(value); }
+    bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+    // 队列满时按等待策略等待
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        while (!try_emplace(std::forward<Args>(args)...)) {
+            producer_wait_.waitUntil([this] {
+                return tail_.load(std::memory_order_relaxed) -
+                       head_.load(std::memory_order_acquire) < capacity_;
+            });
+        }
+    }
+
+    void push(const T& value) { emplace(value); }
+    void push(T&& value) { emplace(std::move(value)); }
+
+    bool try_pop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        T* item = ptr(head);
+        out = std::move(*item);
+        item->~T();
+        head_.store(head + 1, std::memory_order_release);
+        producer_wait_.notify();
+        return true;
+    }
+
+    void pop(T& out) {
+        while (!try_pop(out)) {
+            consumer_wait_.waitUntil([this] {
+                return head_.load(std::memory_order_relaxed) !=
+                       tail_.load(std::memory_order_acquire);
+            });
+        }
+    }
+
+    // 批量入队，单次发布尾索引，返回实际写入数量
+    size_t push_n(const T* items, size_t count) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t free_slots = capacity_ - (tail - cached_head_);
+        if (free_slots < count) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            free_slots = capacity_ - (tail - cached_head_);
+        }
+        const size_t n = count < free_slots ? count : free_slots;
+        for (size_t i = 0; i < n; ++i) {
+            new (ptr(tail + i)) T(items[i]);
+        }
+        if (n > 0) {
+            tail_.store(tail + n, std::memory_order_release);
+            consumer_wait_.notify();
+        }
+        return n;
+    }
+
+    // 批量出队，单次发布头索引，返回实际读取数量
+    size_t pop_n(T* out, size_t max_count) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        size_t available = cached_tail_ - head;
+        if (available < max_count) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            available = cached_tail_ - head;
+        }
+        const size_t n = max_count < available ? max_count : available;
+        for (size_t i = 0; i < n; ++i) {
+            T* item = ptr(head + i);
+            out[i] = std::move(*item);
+            item->~T();
+        }
+        if (n > 0) {
+            head_.store(head + n, std::memory_order_release);
+            producer_wait_.notify();
+        }
+        return n;
+    }
+
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    using Slot = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    T* ptr(size_t index) { return reinterpret_cast<T*>(&slots_[index & mask_]); }
+
+    const size_t capacity_;
+    const size_t mask_;
+    Slot* const slots_;
+
+    // 消费者独占
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+    size_t cached_tail_{0};
+    // 生产者独占
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+    size_t cached_head_{0};
+
+    alignas(kCacheLineSize) WaitPolicy producer_wait_;
+    WaitPolicy consumer_wait_;
+};
+
+// 有界多生产者环形队列（Vyukov序号槽位算法）
+// 每个槽位携带序号，生产者通过CAS领取入队位置；
+// SingleConsumer为true时消费者省去CAS，即MPSC变体
+template<typename T, typename WaitPolicy, bool SingleConsumer>
+class SequencedRingBuffer {
+public:
+    explicit SequencedRingBuffer(size_t capacity)
+        : capacity_(roundUpPowerOfTwo(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1),
+          cells_(static_cast<Cell*>(::operator new(sizeof(Cell) * capacity_,
+                                                   std::align_val_t(kCacheLineSize)))) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            new (&cells_[i]) Cell();
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~SequencedRingBuffer() {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (cells_[pos & mask_].sequence.load(std::memory_order_relaxed) == pos + 1) {
+            cells_[pos & mask_].ptr()->~T();
+            ++pos;
+        }
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].~Cell();
+        }
+        ::operator delete(cells_, std::align_val_t(kCacheLineSize));
+    }
+
+    SequencedRingBuffer(const SequencedRingBuffer&) = delete;
+    SequencedRingBuffer& operator=(const SequencedRingBuffer&) = delete;
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        new (cell->ptr()) T(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        consumer_wait_.notify();
+        return true;
+    }
+
+    bool try_push(const T& value) { return try_emplace(value); }
+    bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        while (!try_emplace(std::forward<Args>(args)...)) {
+            producer_wait_.waitUntil([this] { return !full(); });
+        }
+    }
+
+    void push(const T& value) { emplace(value); }
+    void push(T&& value) { emplace(std::move(value)); }
+
+    bool try_pop(T& out) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (SingleConsumer) {
+                    dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+                    break;
+                }
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        T* item = cell->ptr();
+        out = std::move(*item);
+        item->~T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        producer_wait_.notify();
+        return true;
+    }
+
+    void pop(T& out) {
+        while (!try_pop(out)) {
+            consumer_wait_.waitUntil([this] { return !empty(); });
+        }
+    }
+
+    // 批量操作逐个领取槽位：每个元素原子可见，但批次整体不保证连续
+    size_t push_n(const T* items, size_t count) {
+        size_t n = 0;
+        while (n < count && try_emplace(items[n])) {
+            ++n;
+        }
+        return n;
+    }
+
+    size_t pop_n(T* out, size_t max_count) {
+        size_t n = 0;
+        while (n < max_count && try_pop(out[n])) {
+            ++n;
+        }
+        return n;
+    }
+
+    size_t size() const {
+        const size_t enq = enqueue_pos_.load(std::memory_order_acquire);
+        const size_t deq = dequeue_pos_.load(std::memory_order_acquire);
+        return enq > deq ? enq - deq : 0;
+    }
+    bool empty() const {
+        const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+    bool full() const {
+        const size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].sequence.load(std::memory_order_acquire) != pos;
+    }
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T* ptr() { return reinterpret_cast<T*>(&storage); }
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    Cell* const cells_;
+
+    alignas(kCacheLineSize) std::atomic<size_t> enqueue_pos_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> dequeue_pos_{0};
+    alignas(kCacheLineSize) WaitPolicy producer_wait_;
+    WaitPolicy consumer_wait_;
+};
+
+template<typename T, typename WaitPolicy = SpinWait>
+using MPSCRingBuffer = SequencedRingBuffer<T, WaitPolicy, true>;
+
+template<typename T, typename WaitPolicy = SpinWait>
+using MPMCRingBuffer = SequencedRingBuffer<T, WaitPolicy, false>;
+
+} // namespace utils
+} // namespace hft
@@ -0,0 +1,84 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace hft {
+namespace utils {
+
+// 单写多读顺序锁
+// 写者从不等待读者；读者在写入期间重试，读取过程不获取任何锁
+// 负载按64位原子字存放，避免读写竞争时的未定义行为
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock() {
+        T initial{};
+        store(initial);
+        sequence_.store(0, std::memory_order_relaxed);
+    }
+
+    // 发布新值（仅允许单一写线程调用）
+    void store(const T& value) {
+        uint64_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        const uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            data_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    // 单次尝试读取，写入进行中或读取期间被覆盖时返回false
+    bool tryLoad(T& out) const {
+        const uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            words[i] = data_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(&out, words, sizeof(T));
+        return true;
+    }
+
+    // 读取一致的副本，直到成功为止
+    T load() const {
+        T out;
+        while (!tryLoad(out)) {
+#if defined(__x86_64__) || defined(_M_X64)
+            _mm_pause();
+#endif
+        }
+        return out;
+    }
+
+    // 已发布的版本号（每次发布加2）
+    uint64_t sequence() const {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> sequence_{0};
+    alignas(64) std::atomic<uint64_t> data_[kWords];
+};
+
+} // namespace utils
+} // namespace hft
@@ -0,0 +1,54 @@
+#include "SimdSupport.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace hft {
+namespace utils {
+
+namespace {
+
+SimdLevel probeSimdLevel() {
+    SimdLevel level = SimdLevel::SCALAR;
+#if HFT_SIMD_DISPATCH
+    // __builtin_cpu_supports同时检查操作系统是否保存了相应的寄存器状态(XCR0)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        level = SimdLevel::AVX2;
+    }
+    if (level == SimdLevel::AVX2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        level = SimdLevel::AVX512;
+    }
+#endif
+
+    const char* limit = std::getenv("HFT_SIMD");
+    if (limit) {
+        SimdLevel cap = level;
+        if (std::strcmp(limit, "scalar") == 0) {
+            cap = SimdLevel::SCALAR;
+        } else if (std::strcmp(limit, "avx2") == 0) {
+            cap = SimdLevel::AVX2;
+        }
+        if (cap < level) {
+            level = cap;
+        }
+    }
+    return level;
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+    static const SimdLevel level = probeSimdLevel();
+    return level;
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX512: return "avx512";
+        case SimdLevel::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+} // namespace utils
+} // namespace hft
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// 运行时SIMD分派：内核用__attribute__((target(...)))单独编译，不要求整个工程开启-mavx2/-mavx512f
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define HFT_SIMD_DISPATCH 1
+#define HFT_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define HFT_TARGET_AVX512 __attribute__((target("avx512f,avx512dq,avx2,fma")))
+#else
+#define HFT_SIMD_DISPATCH 0
+#endif
+
+namespace hft {
+namespace utils {
+
+enum class SimdLevel : uint8_t {
+    SCALAR = 0,
+    AVX2 = 1,
+    AVX512 = 2
+};
+
+// 当前CPU（及操作系统）支持的最高指令集，首次调用时检测并缓存。
+// 环境变量HFT_SIMD=scalar/avx2/avx512可把级别向下限制，便于对比测试。
+SimdLevel detectSimdLevel();
+const char* simdLevelName(SimdLevel level);
+
+// 64字节对齐的定长数组，元素须可平凡复制；初始全零
+template <typename T>
+class AlignedArray {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    AlignedArray() : m_data(nullptr), m_size(0) {}
+    explicit AlignedArray(size_t size) : m_data(nullptr), m_size(0) { resize(size); }
+    ~AlignedArray() { std::free(m_data); }
+
+    AlignedArray(const AlignedArray&) = delete;
+    AlignedArray& operator=(const AlignedArray&) = delete;
+    AlignedArray(AlignedArray&& other) noexcept : m_data(other.m_data), m_size(other.m_size) {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    AlignedArray& operator=(AlignedArray&& other) noexcept {
+        if (this != &other) {
+            std::free(m_data);
+            m_data = other.m_data;
+            m_size = other.m_size;
+            other.m_data = nullptr;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    // 重新分配并清零，原有内容不保留
+    void resize(size_t size) {
+        std::free(m_data);
+        m_data = nullptr;
+        m_size = size;
+        if (size == 0) {
+            return;
+        }
+        const size_t bytes = (size * sizeof(T) + kAlignment - 1) / kAlignment * kAlignment;
+        m_data = static_cast<T*>(std::aligned_alloc(kAlignment, bytes));
+        if (!m_data) {
+            throw std::bad_alloc();
+        }
+        std::memset(static_cast<void*>(m_data), 0, bytes);
+    }
+
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    T& operator[](size_t i) { return m_data[i]; }
+    const T& operator[](size_t i) const { return m_data[i]; }
+
+private:
+    T* m_data;
+    size_t m_size;
+};
+
+} // namespace utils
+} // namespace hft